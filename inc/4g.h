@@ -93,17 +93,19 @@ extern "C"
      */
     typedef enum
     {
-        G4_SUCCESS = 0,           // 成功
-        G4_ERROR_INVALID_PARAM,   // 无效参数
-        G4_ERROR_NOT_INITIALIZED, // 未初始化
-        G4_ERROR_TIMEOUT,         // 超时
-        G4_ERROR_NETWORK,         // 网络错误
-        G4_ERROR_SIM_NOT_READY,   // SIM卡未就绪
-        G4_ERROR_NO_SIGNAL,       // 无信号
-        G4_ERROR_AT_COMMAND,      // AT命令错误
-        G4_ERROR_HTTP,            // HTTP错误
-        G4_ERROR_MEMORY,          // 内存错误
-        G4_ERROR_UNKNOWN          // 未知错误
+        G4_SUCCESS = 0,             // 成功
+        G4_ERROR_INVALID_PARAM,     // 无效参数
+        G4_ERROR_NOT_INITIALIZED,   // 未初始化
+        G4_ERROR_TIMEOUT,           // 超时
+        G4_ERROR_NETWORK,           // 网络错误
+        G4_ERROR_SIM_NOT_READY,     // SIM卡未就绪
+        G4_ERROR_NO_SIGNAL,         // 无信号
+        G4_ERROR_AT_COMMAND,        // AT命令错误
+        G4_ERROR_HTTP,              // HTTP错误
+        G4_ERROR_MEMORY,            // 内存错误
+        G4_ERROR_NOT_CONNECTED,     // 连接未建立
+        G4_ERROR_CONNECTION_FAILED, // 建立连接失败
+        G4_ERROR_UNKNOWN            // 未知错误
     } g4_error_t;
 
     //==============================================================================
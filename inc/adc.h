@@ -78,6 +78,69 @@ typedef enum
 // ADC转换完成回调函数类型
 typedef void (*adc_callback_t)(adc_channel_t channel, uint16_t value);
 
+// ============================================================================
+// 扫描组定义 (一次转换序列采集多个通道)
+// ============================================================================
+
+#define ADC_SCAN_MASK_ALL 0xFF    // 全部8个通道
+#define ADC_OVERSAMPLE_MAX_BITS 4 // 最大过采样扩展位数 (累加4^4=256次，输出16位)
+#define ADC_SIM_DEFAULT 0xFFFF    // 模拟输入: 使用默认模拟值
+
+// 时序模型参数 (用于主机端评估，实测值以目标板为准)
+#define ADC_CLOCK_HZ 12000000UL      // ADC时钟 (HIRC 12MHz)
+#define ADC_CONVERSION_CLOCKS 14     // 每通道逐次逼近转换时钟数 (不含采样时间)
+#define ADC_SW_READ_OVERHEAD_NS 5000 // 软件逐通道读取的额外开销 (触发+轮询+调用)
+
+// 扫描定时器 (TMR0，HIRC 12MHz 12分频，1us计数)
+#define ADC_TIMER_CMPR_MAX 0xFFFFFFUL // 24位比较值上限 (超过时按整数分频多次中断)
+#if defined(__arm__) && !defined(__linux__)
+#define ADC_TIMER_SIMULATOR 0
+#else
+#define ADC_TIMER_SIMULATOR 1 // 主机环境: 由测试调用adc_timer_trigger_handler()模拟TMR0中断
+#endif
+
+// 过采样累加器 (累加4^n次转换，右移n位得到12+n位结果)
+typedef struct
+{
+    uint32_t accumulator; // 累加和
+    uint16_t count;       // 已累加次数
+    uint8_t extra_bits;   // 扩展位数n
+} adc_oversample_t;
+
+// 扫描帧 (按通道号索引，PDMA直接写入)
+typedef struct
+{
+    uint16_t values[ADC_CHANNEL_COUNT]; // 各通道转换结果 (12+过采样扩展位)
+    uint8_t channel_mask;               // 本帧包含的通道
+    uint32_t sequence;                  // 帧序号
+    uint32_t timestamp;                 // 帧完成时间 (ms)
+    uint32_t timestamp_us;              // 触发时刻 (us，定时器触发时为比较匹配时刻 + 中断入口读出的TMR0计数)
+} adc_scan_frame_t;
+
+// 扫描帧完成回调函数类型 (整帧一次回调)
+typedef void (*adc_scan_callback_t)(const adc_scan_frame_t *frame);
+
+// 扫描组配置
+typedef struct
+{
+    uint8_t channel_mask;                       // 扫描通道掩码 (bit n = 通道n)
+    adc_sample_time_t sample_time;              // 每通道采样时间
+    bool use_pdma;                              // 使用PDMA搬运结果 (否则在ADC中断中读取)
+    adc_scan_callback_t callback;               // 整帧完成回调
+    uint8_t oversample_bits[ADC_CHANNEL_COUNT]; // 各通道过采样扩展位数 (0~ADC_OVERSAMPLE_MAX_BITS)
+} adc_scan_config_t;
+
+// 扫描时序 (主机端模型)
+typedef struct
+{
+    uint8_t channel_count;       // 通道数
+    uint32_t slot_ns;            // 相邻通道采样间隔
+    uint32_t frame_ns;           // 整帧采集时间
+    uint32_t skew_ns;            // 首末通道采样时刻差
+    uint16_t conversions;        // 每帧转换次数 (含过采样)
+    uint16_t cpu_register_reads; // 每帧CPU读取数据寄存器次数
+} adc_scan_timing_t;
+
 // ============================================================================
 // 传感器通道映射 (为应用层提供语义化接口)
 // ============================================================================
@@ -165,6 +228,79 @@ uint32_t adc_raw_to_voltage(uint16_t raw_value, uint32_t vref_mv);
  */
 bool adc_calibrate(adc_channel_t channel);
 
+// ============================================================================
+// 扫描组接口
+// ============================================================================
+
+/**
+ * @brief 配置扫描组 (所有通道组成一个硬件扫描序列)
+ * @param config 扫描组配置
+ * @return true: 成功, false: 失败 (参数无效或扫描进行中)
+ */
+bool adc_scan_config(const adc_scan_config_t *config);
+
+/**
+ * @brief 启动一次扫描 (非阻塞，整帧完成后调用回调)
+ * @return true: 成功, false: 未配置或上一帧未完成
+ */
+bool adc_scan_start(void);
+
+/**
+ * @brief 启动定时器触发扫描 (TMR0周期触发，转换与主循环无关)
+ * @param period_us 触发周期 (微秒)
+ * @return true: 成功, false: 未配置或参数无效
+ */
+bool adc_scan_start_timer(uint32_t period_us);
+
+/**
+ * @brief 定时器触发事件 (由TMR0_IRQHandler调用)
+ */
+void adc_timer_trigger_handler(void);
+
+/**
+ * @brief 停止扫描并清除扫描组配置
+ * @return true: 成功, false: 失败
+ */
+bool adc_scan_stop(void);
+
+/**
+ * @brief 查询扫描是否进行中
+ * @return true: 进行中, false: 空闲
+ */
+bool adc_scan_is_busy(void);
+
+/**
+ * @brief 阻塞方式采集一帧
+ * @param frame 帧数据输出
+ * @param timeout_ms 超时时间(毫秒)
+ * @return true: 成功, false: 失败/超时
+ */
+bool adc_scan_read_frame(adc_scan_frame_t *frame, uint32_t timeout_ms);
+
+/**
+ * @brief 初始化过采样累加器
+ * @param oversample 累加器
+ * @param extra_bits 扩展位数n (超过ADC_OVERSAMPLE_MAX_BITS时限幅)
+ */
+void adc_oversample_init(adc_oversample_t *oversample, uint8_t extra_bits);
+
+/**
+ * @brief 累加一次转换结果 (在转换完成路径中调用)
+ * @param oversample 累加器
+ * @param raw 12位转换结果
+ * @param result 满4^n次时输出12+n位抽取结果
+ * @return true: 输出就绪, false: 继续累加
+ */
+bool adc_oversample_add(adc_oversample_t *oversample, uint16_t raw, uint16_t *result);
+
+/**
+ * @brief 计算采集时序 (主机端模型)
+ * @param config 扫描组配置 (通道掩码、采样时间、是否使用PDMA)
+ * @param burst true: 扫描组连续转换, false: 软件逐通道读取
+ * @param timing 时序输出
+ */
+void adc_scan_get_timing(const adc_scan_config_t *config, bool burst, adc_scan_timing_t *timing);
+
 // ============================================================================
 // 传感器专用接口 (高级功能)
 // ============================================================================
@@ -298,4 +434,19 @@ void adc_print_all_status(void);
  */
 bool adc_self_test(void);
 
+/**
+ * @brief 设置模拟转换输入 (简化实现/主机回放用)
+ * @param channel ADC通道
+ * @param value 12位转换值，ADC_SIM_DEFAULT恢复默认模拟值
+ */
+void adc_sim_set_value(adc_channel_t channel, uint16_t value);
+
+#if ADC_TIMER_SIMULATOR
+/**
+ * @brief 设置模拟的定时器中断响应延迟 (替代中断入口读出的TMR0计数)
+ * @param latency_us 比较匹配到进入中断的时间 (微秒)
+ */
+void adc_sim_set_trigger_latency(uint32_t latency_us);
+#endif
+
 #endif // ADC_H
\ No newline at end of file
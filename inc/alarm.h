@@ -23,9 +23,28 @@ extern "C"
     // 宏定义
     // ============================================================================
 
-#define ALARM_MAX_RULES 16          // 最大报警规则数
-#define ALARM_MAX_OUTPUTS 8         // 最大报警输出数
-#define ALARM_MAX_HISTORY 50        // 最大报警历史记录数
+#ifndef ALARM_MAX_RULES
+#define ALARM_MAX_RULES 16 // 最大报警规则数 (规则ID为8位，上限255)
+#endif
+
+#if ALARM_MAX_RULES > 255
+#error "ALARM_MAX_RULES must not exceed 255"
+#endif
+
+#define ALARM_MAX_OUTPUTS 8 // 最大报警输出数 (输出掩码每位对应一个输出)
+
+#ifndef ALARM_MAX_HISTORY
+#define ALARM_MAX_HISTORY 64 // RAM中的报警历史记录数 (2的幂)
+#endif
+
+#if (ALARM_MAX_HISTORY & (ALARM_MAX_HISTORY - 1)) != 0
+#error "ALARM_MAX_HISTORY must be a power of two"
+#endif
+
+#ifndef ALARM_HISTORY_SPILL_THRESHOLD
+#define ALARM_HISTORY_SPILL_THRESHOLD (ALARM_MAX_HISTORY / 2) // 未转存记录超过该数时，alarm_process()将最旧的转存到Flash
+#endif
+
 #define ALARM_DEBOUNCE_TIME 3000    // 去抖时间 (ms)
 #define ALARM_AUTO_RESET_TIME 30000 // 自动复位时间 (ms)
 
@@ -38,6 +57,17 @@ extern "C"
 #define ALARM_TYPE_SYSTEM 0x06        // 系统故障
 #define ALARM_TYPE_CUSTOM 0xFF        // 自定义报警
 
+// 报警历史消息ID (文本见alarm_get_message()，常量表位于Flash)
+#define ALARM_MSG_NONE 0               // 无
+#define ALARM_MSG_CONDITION_MET 1      // 条件满足 (描述见规则配置)
+#define ALARM_MSG_MANUAL_TRIGGER 2     // 手动触发
+#define ALARM_MSG_CONDITION_CLEARED 3  // 条件解除
+#define ALARM_MSG_AUTO_RESOLVED 4      // 自动复位
+#define ALARM_MSG_AUTO_ACKNOWLEDGED 5  // 自动确认
+#define ALARM_MSG_MANUAL_ACKNOWLEDGE 6 // 手动确认
+#define ALARM_MSG_MANUAL_RESOLVE 7     // 手动解决
+#define ALARM_MSG_COUNT 8
+
 // 报警级别定义
 #define ALARM_LEVEL_INFO 0     // 信息级
 #define ALARM_LEVEL_WARNING 1  // 警告级
@@ -54,6 +84,7 @@ extern "C"
 #define ALARM_CONDITION_NE 6        // 不等于
 #define ALARM_CONDITION_RANGE 7     // 范围内
 #define ALARM_CONDITION_OUT_RANGE 8 // 范围外
+#define ALARM_CONDITION_EXPR 9      // 表达式 (见alarm_expr.h)
 
 // 报警输出类型
 #define ALARM_OUTPUT_LED 0x01    // LED指示
@@ -61,6 +92,7 @@ extern "C"
 #define ALARM_OUTPUT_RELAY 0x04  // 继电器
 #define ALARM_OUTPUT_MODBUS 0x08 // Modbus通知
 #define ALARM_OUTPUT_UART 0x10   // 串口输出
+#define ALARM_OUTPUT_UPLINK 0x20 // 上行通知 (MQTT/LoRa/4G，经alarm_notify合并限速)
 
     // 报警状态
     typedef enum
@@ -97,12 +129,15 @@ extern "C"
         uint8_t id;        // 规则ID
         uint8_t type;      // 报警类型
         uint8_t level;     // 报警级别
-        uint8_t condition; // 报警条件
-        bool enabled;      // 是否启用
+        uint8_t condition;  // 报警条件
+        uint8_t expression; // 表达式槽位 (ALARM_CONDITION_EXPR时有效)
+        bool enabled;       // 是否启用
 
         int32_t threshold_low;    // 下阈值
         int32_t threshold_high;   // 上阈值
-        uint32_t debounce_time;   // 去抖时间 (ms)
+        int32_t hysteresis;       // 回差 (解除阈值 = 报警阈值向正常侧偏移回差)
+        uint32_t debounce_time;   // 报警延时 (ms，条件持续满足该时长后激活)
+        uint32_t clear_delay;     // 解除延时 (ms，解除条件持续满足该时长后解决)
         uint32_t auto_reset_time; // 自动复位时间 (ms)
 
         uint8_t output_mask; // 输出掩码
@@ -121,11 +156,15 @@ extern "C"
         uint8_t level;       // 报警级别
         uint8_t type;        // 报警类型
 
-        uint32_t trigger_time;     // 触发时间
+        uint32_t trigger_time;     // 触发时间 (进入待定)
         uint32_t acknowledge_time; // 确认时间
         uint32_t resolve_time;     // 解决时间
+        uint32_t clear_time;       // 开始满足解除条件的时间
         uint32_t duration;         // 持续时间
 
+        bool clearing; // 解除延时中
+        bool latched;  // 手动/自动复位时条件仍在: 回到正常前不再触发
+
         int32_t trigger_value; // 触发值
         uint8_t trigger_count; // 触发次数
 
@@ -140,6 +179,7 @@ extern "C"
     {
         uint8_t type;          // 输出类型
         uint8_t gpio_pin;      // GPIO引脚
+        uint8_t gpio_port;     // GPIO端口
         bool active_high;      // 高电平有效
         uint32_t pulse_period; // 脉冲周期 (ms)
         uint32_t pulse_duty;   // 脉冲占空比 (%)
@@ -151,15 +191,14 @@ extern "C"
      */
     typedef struct
     {
-        uint32_t timestamp;  // 时间戳
-        uint8_t rule_id;     // 规则ID
-        uint8_t type;        // 报警类型
-        uint8_t level;       // 报警级别
-        alarm_state_t state; // 状态变化
-
-        int32_t value;        // 相关值
-        uint32_t duration;    // 持续时间
-        char description[32]; // 描述
+        uint32_t timestamp; // 时间戳
+        int32_t value;      // 相关值
+        uint32_t duration;  // 持续时间
+        uint8_t rule_id;    // 规则ID (规则描述见规则配置)
+        uint8_t type;       // 报警类型
+        uint8_t level;      // 报警级别
+        uint8_t state;      // 状态变化 (alarm_state_t)
+        uint8_t message;    // 消息ID (ALARM_MSG_*)
     } alarm_history_t;
 
     /**
@@ -181,6 +220,9 @@ extern "C"
 
         uint32_t false_alarms;       // 误报次数
         uint32_t output_activations; // 输出激活次数
+
+        uint32_t history_spilled; // 转存到Flash的历史记录数
+        uint32_t history_dropped; // 转存失败被覆盖的历史记录数
     } alarm_stats_t;
 
     /**
@@ -295,7 +337,12 @@ extern "C"
      * @brief 检查报警条件 (传感器数据检查)
      * @param type 数据类型
      * @param value 当前值
-     * @return true: 有报警触发, false: 无报警
+     * @return true: 有报警立即激活 (无报警延时), false: 无
+     * @note 每条规则的状态机:
+     *       空闲 --条件满足--> 待定 --持续debounce_time--> 激活 (待定期间条件消失则回到空闲，计为误报)
+     *       激活/已确认 --解除条件 (含回差) 持续clear_delay--> 已解决 (期间再次越限则重新计时)
+     *       已解决 --> 空闲 (重新布防；手动/自动复位的须先满足解除条件，条件仍在时不会反复报警)
+     *       延时在alarm_process()中推进
      */
     bool alarm_check_condition(uint8_t type, int32_t value);
 
@@ -428,13 +475,27 @@ extern "C"
     // ============================================================================
 
     /**
-     * @brief 获取报警历史记录
+     * @brief 获取报警历史记录 (RAM环，无锁，可在中断中调用)
      * @param history 历史记录数组指针
      * @param max_count 最大数量
-     * @return 实际获取的记录数量
+     * @return 实际获取的记录数量 (最近的max_count条，按时间从旧到新)
+     * @note 更早的记录已转存到Flash，通过storage_read_alarm_history()读取
      */
     uint16_t alarm_get_history(alarm_history_t *history, uint16_t max_count);
 
+    /**
+     * @brief 将全部未转存的历史记录转存到Flash (掉电/休眠前调用)
+     * @return 本次转存的记录数
+     */
+    uint16_t alarm_flush_history(void);
+
+    /**
+     * @brief 获取历史消息文本
+     * @param message 消息ID (ALARM_MSG_*)
+     * @return 消息文本 (未知ID返回空字符串)
+     */
+    const char *alarm_get_message(uint8_t message);
+
     /**
      * @brief 清除报警历史记录
      * @param type 报警类型 (0xFF: 清除所有)
@@ -579,7 +640,9 @@ alarm_rule_t temp_rule = {
     .condition = ALARM_CONDITION_GT,
     .enabled = true,
     .threshold_high = 600,  // 60.0°C
+    .hysteresis = 20,       // 低于58.0°C才解除
     .debounce_time = 5000,  // 5秒
+    .clear_delay = 10000,   // 10秒
     .output_mask = ALARM_OUTPUT_LED | ALARM_OUTPUT_BUZZER,
     .priority = 3,
     .description = "High Temperature"
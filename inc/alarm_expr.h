@@ -0,0 +1,167 @@
+/**
+ * @file alarm_expr.h
+ * @brief 憨云DTU报警表达式编译与解释执行接口
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 复合报警条件在配置时编译为紧凑的栈式字节码，采样时由解释器执行:
+ * - 多输入: temp/humi/volt/aux 四个输入，取最新值
+ * - 运算: + -，比较 > < >= <= == !=，逻辑 && || !
+ * - 窗口聚合: avg(x, s) / min(x, s) / max(x, s) 最近s秒
+ * - 变化率: rate(x, s) 最近s秒的平均变化率 (每分钟)
+ * - 持续: for(条件, s) 条件连续成立s秒
+ * 例: "temp > 600 && rate(temp, 60) > 20"    温度高于60.0°C且每分钟上升超过2.0°C
+ *     "for(volt < 2800, 300)"                  电压低于2.8V持续5分钟
+ * 数值为整数 (与报警阈值相同的缩放)，窗口聚合使用按固定间隔抽取的输入历史环
+ *
+ * 字节码: [操作码][操作数...]，多字节操作数为小端；装载时校验一次，解释器执行时不再做边界检查
+ */
+
+#ifndef __ALARM_EXPR_H__
+#define __ALARM_EXPR_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#define ALARM_EXPR_INPUTS 4 // 输入数
+
+#ifndef ALARM_EXPR_HISTORY
+#define ALARM_EXPR_HISTORY 16 // 每个输入的历史环长度
+#endif
+
+#ifndef ALARM_EXPR_HISTORY_INTERVAL
+#define ALARM_EXPR_HISTORY_INTERVAL 15000 // 历史环抽取间隔 (ms，16 x 15s覆盖4分钟)
+#endif
+
+#ifndef ALARM_EXPR_MAX_PROGRAMS
+#define ALARM_EXPR_MAX_PROGRAMS 4 // 表达式槽位数
+#endif
+
+#define ALARM_EXPR_MAX_CODE 48 // 单个表达式的最大字节码长度
+#define ALARM_EXPR_STACK 8     // 解释器栈深度
+#define ALARM_EXPR_MAX_HOLDS 4 // 单个表达式中for()的最大个数
+
+// 输入编号
+#define ALARM_EXPR_INPUT_TEMPERATURE 0 // temp
+#define ALARM_EXPR_INPUT_HUMIDITY 1    // humi
+#define ALARM_EXPR_INPUT_VOLTAGE 2     // volt
+#define ALARM_EXPR_INPUT_AUX 3         // aux (其他报警类型)
+
+// 操作码
+#define ALARM_EXPR_OP_END 0x00   // 结束，栈顶为结果
+#define ALARM_EXPR_OP_CONST 0x01 // [值 4B] 压入常数
+#define ALARM_EXPR_OP_INPUT 0x02 // [输入] 压入最新值
+#define ALARM_EXPR_OP_AVG 0x03   // [输入][秒 2B] 窗口均值
+#define ALARM_EXPR_OP_MIN 0x04   // [输入][秒 2B] 窗口最小值
+#define ALARM_EXPR_OP_MAX 0x05   // [输入][秒 2B] 窗口最大值
+#define ALARM_EXPR_OP_RATE 0x06  // [输入][秒 2B] 窗口变化率 (每分钟)
+#define ALARM_EXPR_OP_ADD 0x07   // a + b
+#define ALARM_EXPR_OP_SUB 0x08   // a - b
+#define ALARM_EXPR_OP_GT 0x09    // a > b
+#define ALARM_EXPR_OP_LT 0x0A    // a < b
+#define ALARM_EXPR_OP_GE 0x0B    // a >= b
+#define ALARM_EXPR_OP_LE 0x0C    // a <= b
+#define ALARM_EXPR_OP_EQ 0x0D    // a == b
+#define ALARM_EXPR_OP_NE 0x0E    // a != b
+#define ALARM_EXPR_OP_AND 0x0F   // a && b
+#define ALARM_EXPR_OP_OR 0x10    // a || b
+#define ALARM_EXPR_OP_NOT 0x11   // !a
+#define ALARM_EXPR_OP_HOLD 0x12  // [持续槽][秒 2B] 栈顶条件连续成立指定秒数
+#define ALARM_EXPR_OP_COUNT 0x13
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief 已装载的表达式
+     */
+    typedef struct
+    {
+        uint8_t code[ALARM_EXPR_MAX_CODE];           // 字节码
+        uint8_t length;                              // 字节码长度 (0: 槽位空闲)
+        uint8_t hold_active;                         // 持续计时中的for() (位掩码)
+        uint32_t hold_since[ALARM_EXPR_MAX_HOLDS];   // 条件开始成立的时刻
+    } alarm_expr_t;
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief 清空输入历史与全部表达式
+     */
+    void alarm_expr_init(void);
+
+    /**
+     * @brief 更新输入 (每个采样调用)
+     * @param input 输入编号
+     * @param value 采样值
+     * @param now 当前时刻 (ms)
+     */
+    void alarm_expr_update(uint8_t input, int32_t value, uint32_t now);
+
+    /**
+     * @brief 编译表达式
+     * @param source 表达式文本
+     * @param code 字节码输出缓冲区
+     * @param size 缓冲区大小
+     * @param error_pos 出错位置 (可为NULL)
+     * @return 字节码长度, 0: 语法错误/超出栈深度/字节码过长
+     */
+    uint8_t alarm_expr_compile(const char *source, uint8_t *code, uint8_t size, uint8_t *error_pos);
+
+    /**
+     * @brief 校验字节码 (操作码/操作数/栈深度/持续槽)
+     * @param code 字节码
+     * @param length 长度
+     * @return true: 可安全执行
+     */
+    bool alarm_expr_verify(const uint8_t *code, uint8_t length);
+
+    /**
+     * @brief 装载字节码到表达式槽位 (配置下发或构建时生成的字节码)
+     * @param slot 槽位
+     * @param code 字节码
+     * @param length 长度
+     * @return true: 成功, false: 槽位无效或校验失败
+     */
+    bool alarm_expr_load(uint8_t slot, const uint8_t *code, uint8_t length);
+
+    /**
+     * @brief 编译并装载表达式
+     * @param slot 槽位
+     * @param source 表达式文本
+     * @return true: 成功
+     */
+    bool alarm_expr_set(uint8_t slot, const char *source);
+
+    /**
+     * @brief 求值表达式
+     * @param slot 槽位
+     * @param now 当前时刻 (ms)
+     * @return true: 条件成立 (槽位空闲时为false)
+     */
+    bool alarm_expr_evaluate(uint8_t slot, uint32_t now);
+
+    /**
+     * @brief 报警类型对应的输入编号
+     * @param type 报警类型 (ALARM_TYPE_*)
+     * @return 输入编号
+     */
+    uint8_t alarm_expr_input_for_type(uint8_t type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __ALARM_EXPR_H__
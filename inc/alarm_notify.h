@@ -0,0 +1,140 @@
+/**
+ * @file alarm_notify.h
+ * @brief 憨云DTU报警通知合并与限速接口
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 报警状态变化先进入通知批次，而不是逐条上报:
+ * - 合并: 第一条变化打开ALARM_NOTIFY_WINDOW_MS的窗口，窗口内同一规则的多次变化合并为一条
+ *   (保留最新状态与值，累计变化次数)，窗口到期或批次满时整批发出
+ * - 限速: 每个级别一个令牌桶，新条目 (非合并) 消耗一个令牌，无令牌时丢弃并计入下一批的抑制计数
+ * - 严重级别: 不限速，立即连同当前批次发出
+ * 同一批次送往全部已注册的上行通道 (MQTT/LoRa/4G，见alarm_notify_adapter.h)，按各通道MTU分帧
+ *
+ * 帧格式 (小端): [版本 1B][批次序号 1B][条目数 1B][抑制数 1B][基准时刻 4B]
+ *               + 条目数 x [规则ID 1B][类型 1B][级别<<4|状态 1B][变化次数 1B][值 2B][时刻偏移 2B (ms)]
+ */
+
+#ifndef __ALARM_NOTIFY_H__
+#define __ALARM_NOTIFY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "alarm.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#ifndef ALARM_NOTIFY_WINDOW_MS
+#define ALARM_NOTIFY_WINDOW_MS 2000 // 合并窗口 (ms)
+#endif
+
+#ifndef ALARM_NOTIFY_BATCH_MAX
+#define ALARM_NOTIFY_BATCH_MAX 16 // 单批最大条目数 (满则立即发出)
+#endif
+
+#define ALARM_NOTIFY_MAX_SINKS 4    // 最大上行通道数
+#define ALARM_NOTIFY_VERSION 1      // 帧格式版本
+#define ALARM_NOTIFY_HEADER_SIZE 8  // 帧头长度
+#define ALARM_NOTIFY_ENTRY_SIZE 8   // 条目长度
+#define ALARM_NOTIFY_MIN_MTU (ALARM_NOTIFY_HEADER_SIZE + ALARM_NOTIFY_ENTRY_SIZE) // 通道MTU下限
+#define ALARM_NOTIFY_MAX_FRAME (ALARM_NOTIFY_HEADER_SIZE + ALARM_NOTIFY_BATCH_MAX * ALARM_NOTIFY_ENTRY_SIZE)
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief 上行通道发送函数
+     * @param frame 帧数据
+     * @param length 帧长度 (不超过通道MTU)
+     * @param context 通道上下文
+     * @return true: 已发出/已交给下层队列
+     */
+    typedef bool (*alarm_notify_send_t)(const uint8_t *frame, uint16_t length, void *context);
+
+    /**
+     * @brief 上行通道
+     */
+    typedef struct
+    {
+        alarm_notify_send_t send; // 发送函数
+        void *context;            // 通道上下文
+        uint16_t mtu;             // 单帧长度上限 (不小于ALARM_NOTIFY_MIN_MTU)
+    } alarm_notify_sink_t;
+
+    /**
+     * @brief 通知统计
+     */
+    typedef struct
+    {
+        uint32_t posted;      // 收到的状态变化数
+        uint32_t coalesced;   // 合并到已有条目的变化数
+        uint32_t suppressed;  // 限速丢弃的变化数
+        uint32_t immediate;   // 严重级别立即发出的批次数
+        uint32_t batches;     // 发出的批次数
+        uint32_t frames;      // 发出的帧数 (各通道合计)
+        uint32_t bytes;       // 发出的字节数 (各通道合计)
+        uint32_t send_errors; // 通道发送失败次数
+    } alarm_notify_stats_t;
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief 初始化 (清空批次、通道与统计，限速恢复默认)
+     * @note alarm_init()会调用本函数，通道须在其后注册
+     */
+    void alarm_notify_init(void);
+
+    /**
+     * @brief 注册上行通道
+     * @param sink 通道描述 (发送函数与上下文均相同时视为同一通道，更新其MTU)
+     * @return true: 成功, false: 参数无效或通道已满
+     */
+    bool alarm_notify_add_sink(const alarm_notify_sink_t *sink);
+
+    /**
+     * @brief 设置某级别的令牌桶
+     * @param level 报警级别 (ALARM_LEVEL_INFO~ALARM_LEVEL_ERROR，严重级别不限速)
+     * @param capacity 桶容量 (突发条目数)
+     * @param refill_ms 每补充一个令牌的间隔 (ms)
+     * @return true: 成功
+     */
+    bool alarm_notify_set_limit(uint8_t level, uint8_t capacity, uint32_t refill_ms);
+
+    /**
+     * @brief 提交一次报警状态变化 (报警模块在记录历史时调用)
+     * @param event 历史记录
+     */
+    void alarm_notify_post(const alarm_history_t *event);
+
+    /**
+     * @brief 后台任务: 窗口到期时发出批次
+     */
+    void alarm_notify_task(void);
+
+    /**
+     * @brief 立即发出当前批次
+     */
+    void alarm_notify_flush(void);
+
+    /**
+     * @brief 获取通知统计
+     * @param stats 统计信息
+     * @return true: 成功
+     */
+    bool alarm_notify_get_stats(alarm_notify_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __ALARM_NOTIFY_H__
@@ -0,0 +1,47 @@
+/**
+ * @file alarm_notify_adapter.h
+ * @brief 憨云DTU报警通知的上行通道适配 (MQTT发布)
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 报警批次的二进制帧 (格式见alarm_notify.h) 经MQTT发布，QoS1由MQTT层负责重发。
+ * MQTT默认经4G套接字传输，4G上行即由此覆盖；连接建立 (收到CONNACK) 时MQTT层调用
+ * alarm_notify_attach_mqtt()注册通道，重连时重复注册只更新参数。
+ * LoRa射频驱动尚无发送路径，待其实现后再按ALARM_NOTIFY_LORA_MTU分帧接入。
+ */
+#ifndef __ALARM_NOTIFY_ADAPTER_H__
+#define __ALARM_NOTIFY_ADAPTER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "alarm_notify.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#define ALARM_NOTIFY_MQTT_MTU ALARM_NOTIFY_MAX_FRAME // MQTT单帧上限 (整批一帧)
+#define ALARM_NOTIFY_LORA_MTU 51                     // LoRa单帧上限 (SF10/125kHz最大负载)
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief 注册MQTT通道
+     * @param topic 发布主题
+     * @return true: 成功
+     * @note 由MQTT层在连接建立时调用，须在alarm_init()之后
+     */
+    bool alarm_notify_attach_mqtt(const char *topic);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __ALARM_NOTIFY_ADAPTER_H__
@@ -0,0 +1,145 @@
+/**
+ * @file config_journal.h
+ * @brief 憨云DTU A/B双bank日志式配置存储接口
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 配置区分为两个bank，任一时刻只有一个为当前bank:
+ * - bank头带提交序号与CRC16，挂载时选择序号最大的有效bank，无需额外元数据
+ * - 小改动以键值差分记录 (字段偏移/长度/新值) 追加在当前bank快照之后，不擦除
+ * - 当前bank写满或改动较大时，完整快照写入另一bank (序号+1)，bank头最后写入作为提交点；
+ *   写入过程中掉电，原bank仍完整有效
+ * - 差分记录带CRC16，撕裂的记录及其后内容在挂载时丢弃，下一次提交改写快照
+ * - 备用bank可由后台调用config_journal_maintain()逐页预擦除，改写快照时只剩编程操作
+ *
+ * bank布局: [bank头 16B][快照 (按4字节补齐)][差分记录头 4B][段...][差分记录头]...[0xFF...]
+ * 差分段: [偏移 1B][长度 1B][新值]，一条差分记录内的各段同时生效
+ */
+
+#ifndef __CONFIG_JOURNAL_H__
+#define __CONFIG_JOURNAL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#define CONFIG_JOURNAL_MAGIC 0x47464348UL // "HCFG"
+#define CONFIG_JOURNAL_BANKS 2            // bank数
+#define CONFIG_JOURNAL_MAX_SIZE 255       // 配置数据最大长度 (差分段偏移为8位)
+#define CONFIG_JOURNAL_MAX_DELTA 64       // 单条差分记录最大段数据长度 (超出时改写快照)
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief bank头 (Flash格式)
+     */
+    typedef struct
+    {
+        uint32_t magic;    // bank标识
+        uint32_t sequence; // 提交序号 (每写入一次快照+1)
+        uint16_t size;     // 快照长度
+        uint16_t crc16;    // 序号/长度/快照校验
+        uint32_t reserved; // 保留 (0xFFFFFFFF)
+    } config_journal_bank_t;
+
+    /**
+     * @brief 差分记录头 (Flash格式)
+     */
+    typedef struct
+    {
+        uint16_t length; // 段数据总长度 (0xFFFF: 空闲)
+        uint16_t crc16;  // 长度/段数据校验
+    } config_journal_delta_t;
+
+    /**
+     * @brief 配置存储统计
+     */
+    typedef struct
+    {
+        uint32_t commits;      // 提交次数 (内容有变化)
+        uint32_t deltas;       // 以差分记录提交的次数
+        uint32_t snapshots;    // 改写快照的次数
+        uint32_t erases;       // 页擦除次数
+        uint32_t crc_errors;   // 挂载时发现的损坏bank/差分记录
+        uint32_t write_errors; // 编程/校验失败次数
+    } config_journal_stats_t;
+
+    /**
+     * @brief 配置存储实例 (RAM)
+     */
+    typedef struct
+    {
+        uint32_t base;                 // bank 0起始地址 (页对齐)，bank 1紧随其后
+        uint16_t bank_size;            // bank大小 (Flash页的整数倍)
+        uint16_t size;                 // 配置数据长度
+        uint8_t active;                // 当前bank
+        bool valid;                    // 当前bank有效 (已有提交的配置)
+        uint16_t offset;               // 当前bank追加偏移 (bank_size表示已满)
+        uint32_t sequence;             // 当前bank提交序号
+        uint8_t spare_erased;          // 备用bank已擦除的页数 (从bank起始连续)
+        config_journal_stats_t stats;  // 统计信息
+    } config_journal_t;
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief 挂载配置存储并恢复最新配置
+     * @param journal 配置存储实例
+     * @param base 起始地址 (须按Flash页对齐)
+     * @param bank_size bank大小 (Flash页的整数倍)
+     * @param data 输出最新配置 (快照叠加全部有效差分记录)
+     * @param size 配置数据长度 (1~CONFIG_JOURNAL_MAX_SIZE)
+     * @return true: 已恢复, false: 无有效配置或参数无效 (data不变)
+     * @note 无有效配置时首次提交写入bank 1，bank 0中的旧格式数据在此之前保持不变
+     */
+    bool config_journal_mount(config_journal_t *journal, uint32_t base, uint16_t bank_size, void *data,
+                              uint16_t size);
+
+    /**
+     * @brief 提交新配置
+     * @param journal 配置存储实例
+     * @param current 当前已提交的配置 (用于计算差分；NULL或无有效配置时写入完整快照)
+     * @param data 新配置
+     * @return true: 已持久化 (含内容无变化), false: Flash操作失败
+     * @note 改动可放入当前bank剩余空间时追加差分记录，否则将完整快照写入另一bank
+     */
+    bool config_journal_commit(config_journal_t *journal, const void *current, const void *data);
+
+    /**
+     * @brief 执行一步后台维护 (预擦除备用bank的一页)
+     * @param journal 配置存储实例
+     * @return true: 本次执行了擦除, false: 备用bank已全部擦除或擦除失败
+     */
+    bool config_journal_maintain(config_journal_t *journal);
+
+    /**
+     * @brief 擦除两个bank
+     * @param journal 配置存储实例 (须已挂载)
+     * @return true: 成功, false: 失败
+     */
+    bool config_journal_format(config_journal_t *journal);
+
+    /**
+     * @brief 获取当前bank剩余可追加字节数
+     * @param journal 配置存储实例
+     * @return 字节数
+     */
+    uint16_t config_journal_get_free_space(const config_journal_t *journal);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __CONFIG_JOURNAL_H__
@@ -0,0 +1,158 @@
+/**
+ * @file filter.h
+ * @brief 憨云DTU数字滤波器库接口
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 统一的整数滤波器实现，供传感器通道和ADC驱动共用:
+ * - 滑动平均 (运行和，O(1))
+ * - 中值滤波 (增量有序窗口，O(log N)查找 + O(N)移位)
+ * - 一阶IIR (alpha = 1/2^n)
+ * - 一维卡尔曼 (恒值模型)
+ * 全部为整数/定点运算，无浮点
+ */
+
+#ifndef __FILTER_H__
+#define __FILTER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#ifndef FILTER_MAX_WINDOW
+#define FILTER_MAX_WINDOW 8 // 最大窗口长度 (滑动平均/中值)
+#endif
+
+#define FILTER_IIR_SHIFT_DEFAULT 3     // IIR默认系数 alpha = 1/8
+#define FILTER_IIR_SHIFT_MAX 15        // IIR最大移位
+#define FILTER_KALMAN_RATIO_DEFAULT 16 // 卡尔曼默认测量/过程噪声比 R/Q
+#define FILTER_KALMAN_RATIO_MAX 32766  // 卡尔曼最大R/Q (Q16下R + Q仍在int32范围内)
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief 滤波器类型枚举
+     */
+    typedef enum
+    {
+        FILTER_TYPE_MOVING_AVERAGE = 0, // 滑动平均 (默认，兼容原有行为)
+        FILTER_TYPE_MEDIAN = 1,         // 中值滤波
+        FILTER_TYPE_IIR = 2,            // 一阶IIR低通
+        FILTER_TYPE_KALMAN = 3,         // 一维卡尔曼
+        FILTER_TYPE_NONE = 4,           // 不滤波
+        FILTER_TYPE_COUNT
+    } filter_type_t;
+
+    /**
+     * @brief 滤波器配置结构体
+     */
+    typedef struct
+    {
+        filter_type_t type; // 滤波器类型
+        uint8_t window;     // 窗口长度 (滑动平均/中值，1~FILTER_MAX_WINDOW)
+        uint16_t param;     // 类型参数: IIR为移位n (alpha=1/2^n)，卡尔曼为R/Q比值
+    } filter_config_t;
+
+    /**
+     * @brief 滑动平均状态 (运行和)
+     */
+    typedef struct
+    {
+        uint16_t buffer[FILTER_MAX_WINDOW]; // 环形缓冲区
+        uint32_t sum;                       // 窗口运行和
+    } filter_ma_state_t;
+
+    /**
+     * @brief 中值滤波状态 (环形缓冲 + 有序窗口)
+     */
+    typedef struct
+    {
+        uint16_t buffer[FILTER_MAX_WINDOW]; // 按到达顺序
+        uint16_t sorted[FILTER_MAX_WINDOW]; // 升序排列
+    } filter_median_state_t;
+
+    /**
+     * @brief IIR状态
+     */
+    typedef struct
+    {
+        uint32_t state_q16; // 输出 (无符号Q16.16，支持16位过采样输入)
+    } filter_iir_state_t;
+
+    /**
+     * @brief 卡尔曼状态
+     */
+    typedef struct
+    {
+        uint32_t x_q16; // 估计值 (无符号Q16.16)
+        int32_t p_q16;  // 估计误差协方差 (Q16.16，以Q为单位)
+        int32_t r_q16;  // 测量噪声 (Q16.16，以Q为单位)
+    } filter_kalman_state_t;
+
+    /**
+     * @brief 滤波器实例
+     */
+    typedef struct
+    {
+        filter_type_t type; // 滤波器类型
+        uint8_t window;     // 窗口长度
+        uint8_t index;      // 环形缓冲区写索引
+        uint8_t count;      // 有效样本数
+        uint16_t param;     // 类型参数
+        union
+        {
+            filter_ma_state_t ma;
+            filter_median_state_t median;
+            filter_iir_state_t iir;
+            filter_kalman_state_t kalman;
+        } state;
+    } filter_t;
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief 初始化滤波器
+     * @param filter 滤波器实例
+     * @param config 配置参数 (窗口长度超限时自动限幅)
+     * @return true: 成功, false: 参数无效
+     */
+    bool filter_init(filter_t *filter, const filter_config_t *config);
+
+    /**
+     * @brief 复位滤波器状态 (保留配置)
+     * @param filter 滤波器实例
+     */
+    void filter_reset(filter_t *filter);
+
+    /**
+     * @brief 输入一个样本并返回滤波结果
+     * @param filter 滤波器实例
+     * @param sample 输入样本
+     * @return 滤波后的值
+     */
+    uint16_t filter_update(filter_t *filter, uint16_t sample);
+
+    /**
+     * @brief 获取滤波器类型名称
+     * @param type 滤波器类型
+     * @return 名称字符串
+     */
+    const char *filter_get_type_name(filter_type_t type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FILTER_H__
@@ -0,0 +1,216 @@
+/**
+ * @file fixed_point.h
+ * @brief 憨云DTU定点数运算工具
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * Cortex-M0 无硬件浮点 (-mfloat-abi=soft)，采样路径统一使用定点数:
+ * - 物理量使用 Q16.16 (q16_t)，范围 ±32767，分辨率 1/65536
+ * - 比例因子使用 Q8.24 (q24_t)，保证 0.01 这类小系数的精度
+ * 浮点仅允许出现在配置和显示边界 (q16_from_float / q16_to_float)
+ */
+
+#ifndef __FIXED_POINT_H__
+#define __FIXED_POINT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#define Q16_SHIFT 16
+#define Q24_SHIFT 24
+#define Q16_ONE ((int32_t)1 << Q16_SHIFT) // 1.0 (Q16.16)
+#define Q16_MAX INT32_MAX                 // Q16.16 最大值
+#define Q16_MIN INT32_MIN                 // Q16.16 最小值
+#define Q24_LIMIT 128.0f                  // Q8.24 可表示范围 (-128 ~ 128，不含端点)
+
+// 编译期常量转换 (仅用于常量表达式，不会生成浮点运算)
+#define Q16_CONST(x) ((int32_t)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+#define Q24_CONST(x) ((int32_t)((x) * 16777216.0 + ((x) >= 0 ? 0.5 : -0.5)))
+#define Q16_FROM_INT(x) ((int32_t)(x) * Q16_ONE)
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    typedef int32_t q16_t; // Q16.16 定点数
+    typedef int32_t q24_t; // Q8.24 定点数
+
+    // ============================================================================
+    // 内联函数
+    // ============================================================================
+
+    /**
+     * @brief 浮点数转换为Q16.16 (仅限配置边界调用)
+     * @param value 浮点值
+     * @return Q16.16值 (饱和)
+     */
+    static inline q16_t q16_from_float(float value)
+    {
+        if (value >= 32767.0f)
+        {
+            return Q16_MAX;
+        }
+        if (value <= -32768.0f)
+        {
+            return Q16_MIN;
+        }
+        return (q16_t)(value * 65536.0f + (value >= 0.0f ? 0.5f : -0.5f));
+    }
+
+    /**
+     * @brief Q16.16转换为浮点数 (仅限显示边界调用)
+     * @param value Q16.16值
+     * @return 浮点值
+     */
+    static inline float q16_to_float(q16_t value)
+    {
+        return (float)value / 65536.0f;
+    }
+
+    /**
+     * @brief 判断浮点数能否无饱和地转换为Q8.24
+     * @param value 浮点值
+     * @return true: 位于(-128, 128)内 (NaN返回false)
+     */
+    static inline bool q24_in_range(float value)
+    {
+        return value > -Q24_LIMIT && value < Q24_LIMIT;
+    }
+
+    /**
+     * @brief 浮点数转换为Q8.24 (仅限配置边界调用)
+     * @param value 浮点值 (-128 ~ 128，调用者可先用q24_in_range()检查)
+     * @return Q8.24值 (饱和)
+     */
+    static inline q24_t q24_from_float(float value)
+    {
+        if (value >= Q24_LIMIT)
+        {
+            return INT32_MAX;
+        }
+        if (value <= -Q24_LIMIT)
+        {
+            return INT32_MIN;
+        }
+        return (q24_t)(value * 16777216.0f + (value >= 0.0f ? 0.5f : -0.5f));
+    }
+
+    /**
+     * @brief Q8.24转换为浮点数 (仅限显示边界调用)
+     */
+    static inline float q24_to_float(q24_t value)
+    {
+        return (float)value / 16777216.0f;
+    }
+
+    /**
+     * @brief 64位结果饱和到Q16.16
+     */
+    static inline q16_t q16_saturate(int64_t value)
+    {
+        if (value > (int64_t)Q16_MAX)
+        {
+            return Q16_MAX;
+        }
+        if (value < (int64_t)Q16_MIN)
+        {
+            return Q16_MIN;
+        }
+        return (q16_t)value;
+    }
+
+    /**
+     * @brief Q16.16乘法 (饱和)
+     */
+    static inline q16_t q16_mul(q16_t a, q16_t b)
+    {
+        return q16_saturate(((int64_t)a * b) >> Q16_SHIFT);
+    }
+
+    /**
+     * @brief Q16.16乘以Q8.24系数 (饱和)，用于小系数换算 (如 3.3/4095)
+     */
+    static inline q16_t q16_mul_q24(q16_t a, q24_t k)
+    {
+        return q16_saturate(((int64_t)a * k) >> Q24_SHIFT);
+    }
+
+    /**
+     * @brief Q16.16加法 (饱和)
+     */
+    static inline q16_t q16_add(q16_t a, q16_t b)
+    {
+        return q16_saturate((int64_t)a + b);
+    }
+
+    /**
+     * @brief 线性变换: raw * scale + offset
+     * @param raw 原始整数值 (ADC码值)
+     * @param scale_q24 比例因子 (Q8.24)
+     * @param offset_q16 偏移量 (Q16.16)
+     * @return 物理量 (Q16.16, 饱和)
+     */
+    static inline q16_t q16_linear(int32_t raw, q24_t scale_q24, q16_t offset_q16)
+    {
+        int64_t scaled = ((int64_t)raw * scale_q24) >> (Q24_SHIFT - Q16_SHIFT);
+        return q16_saturate(scaled + offset_q16);
+    }
+
+    /**
+     * @brief 扩展精度线性变换: (raw / 2^extra_bits) * scale + offset
+     * @param raw 过采样后的原始值 (12 + extra_bits 位)
+     * @param extra_bits 过采样扩展位数 (比例因子仍按12位码值定义)
+     * @param scale_q24 比例因子 (Q8.24)
+     * @param offset_q16 偏移量 (Q16.16)
+     * @return 物理量 (Q16.16, 饱和)
+     */
+    static inline q16_t q16_linear_ext(int32_t raw, uint8_t extra_bits, q24_t scale_q24, q16_t offset_q16)
+    {
+        int64_t scaled = ((int64_t)raw * scale_q24) >> (Q24_SHIFT - Q16_SHIFT + extra_bits);
+        return q16_saturate(scaled + offset_q16);
+    }
+
+    /**
+     * @brief 指数移动平均 (alpha = 1/10)
+     * @param average 当前平均值 (Q16.16)
+     * @param value 新值 (Q16.16)
+     * @return 更新后的平均值
+     * @note 6554/65536 ≈ 0.1，使用乘移位代替除法和浮点运算
+     */
+    static inline q16_t q16_ema_tenth(q16_t average, q16_t value)
+    {
+        int64_t delta = (int64_t)value - average;
+        return q16_saturate(average + ((delta * 6554) >> Q16_SHIFT));
+    }
+
+    /**
+     * @brief Q16.16转换为指定倍率的整数 (如温度0.1°C -> scale=10)
+     */
+    static inline int32_t q16_to_scaled_int(q16_t value, int32_t scale)
+    {
+        int64_t v = (int64_t)value * scale;
+        return (int32_t)((v + (v >= 0 ? 32768 : -32768)) / 65536);
+    }
+
+    /**
+     * @brief Q16.16转换为千分单位整数 (用于整数打印)
+     */
+    static inline int32_t q16_to_milli(q16_t value)
+    {
+        return q16_to_scaled_int(value, 1000);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FIXED_POINT_H__
@@ -0,0 +1,153 @@
+/**
+ * @file flash.h
+ * @brief 憨云DTU内部Flash驱动接口
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * NANO100B内部Flash (APROM) 页擦除/字编程，NOR语义:
+ * - 擦除以页为单位，擦除后全为0xFF
+ * - 编程只能把1写成0，同一字在擦除前只应编程一次
+ * 目标板使用FMC ISP；主机环境使用RAM镜像模拟，可映射到文件并注入掉电
+ */
+
+#ifndef __FLASH_H__
+#define __FLASH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#define FLASH_BASE_ADDR 0x00000000UL // APROM起始地址
+#define FLASH_SIZE (64UL * 1024UL)   // APROM大小
+#define FLASH_PAGE_SIZE 512          // 擦除页大小
+#define FLASH_PROGRAM_UNIT 4         // 编程单位 (字)
+
+#if defined(__arm__) && !defined(__linux__)
+#define FLASH_SIMULATOR 0
+#else
+#define FLASH_SIMULATOR 1 // 主机环境: RAM/文件模拟NOR Flash
+#endif
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief Flash操作统计
+     */
+    typedef struct
+    {
+        uint32_t erase_count;   // 页擦除次数
+        uint32_t program_count; // 编程操作次数
+        uint32_t program_bytes; // 编程字节数
+        uint32_t read_count;    // 读取操作次数
+        uint32_t error_count;   // 失败次数 (参数/地址/掉电)
+    } flash_stats_t;
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief Flash驱动初始化 (使能ISP)
+     * @return true: 成功, false: 失败
+     */
+    bool flash_init(void);
+
+    /**
+     * @brief 擦除一页
+     * @param address 页起始地址 (须按FLASH_PAGE_SIZE对齐)
+     * @return true: 成功, false: 失败
+     */
+    bool flash_erase_page(uint32_t address);
+
+    /**
+     * @brief 编程数据
+     * @param address 起始地址 (须按FLASH_PROGRAM_UNIT对齐)
+     * @param data 数据指针
+     * @param length 数据长度 (末尾不足一字时以0xFF补齐)
+     * @return true: 成功, false: 失败
+     */
+    bool flash_program(uint32_t address, const uint8_t *data, uint16_t length);
+
+    /**
+     * @brief 读取数据
+     * @param address 起始地址
+     * @param data 数据指针
+     * @param length 数据长度
+     * @return true: 成功, false: 失败
+     */
+    bool flash_read(uint32_t address, uint8_t *data, uint16_t length);
+
+    /**
+     * @brief 比较Flash内容与预期数据
+     * @param address 起始地址
+     * @param data 预期数据
+     * @param length 数据长度
+     * @return true: 一致, false: 不一致或读取失败
+     */
+    bool flash_verify(uint32_t address, const uint8_t *data, uint16_t length);
+
+    /**
+     * @brief 获取操作统计
+     * @param stats 统计信息结构体指针
+     */
+    void flash_get_stats(flash_stats_t *stats);
+
+    /**
+     * @brief 清零操作统计
+     */
+    void flash_reset_stats(void);
+
+#if FLASH_SIMULATOR
+    /**
+     * @brief 模拟器映射到镜像文件 (文件不存在时按全擦除状态创建)
+     * @param path 文件路径
+     * @return true: 成功, false: 失败
+     * @note 之后的擦除/编程直接写透到文件，重新映射即模拟断电重启
+     */
+    bool flash_sim_attach_file(const char *path);
+
+    /**
+     * @brief 解除文件映射 (镜像保留在RAM中)
+     */
+    void flash_sim_detach_file(void);
+
+    /**
+     * @brief 整片恢复为擦除状态 (不计入统计)
+     */
+    void flash_sim_reset(void);
+
+    /**
+     * @brief 注入掉电: 再编程budget字节 (擦除一页计FLASH_PAGE_SIZE) 后断电
+     * @param budget 剩余字节预算，0关闭注入
+     * @note 断电时进行中的操作只完成预算内的部分并返回失败，此后所有写操作失败直到flash_sim_power_on()
+     */
+    void flash_sim_set_power_cut(uint32_t budget);
+
+    /**
+     * @brief 恢复供电 (清除掉电状态与注入)
+     */
+    void flash_sim_power_on(void);
+
+    /**
+     * @brief 获取某页累计擦除次数
+     * @param address 页内任意地址
+     * @return 擦除次数
+     */
+    uint32_t flash_sim_get_page_erase_count(uint32_t address);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FLASH_H__
@@ -0,0 +1,386 @@
+/**
+ * @file flash_log.h
+ * @brief 憨云DTU日志结构Flash记录存储接口
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 多扇区只追加记录日志:
+ * - 扇区按环形顺序轮转使用 (天然磨损均衡)，写入头之前始终保留一个已擦除扇区
+ * - 每条记录带序号与CRC16，掉电撕裂的记录在挂载时被识别并跳过
+ * - 挂载时根据扇区头序号找到写入头，无需额外元数据
+ * - 可选RAM写回缓存: 记录按Flash格式在RAM中拼接，缓存满/超时/刷新时一次编程写入
+ * - 扇区写满时在扇区头写入摘要 (首末时间戳/记录数/类型掩码)，按时间区间查询时
+ *   先对扇区摘要二分，再在扇区内按记录二分，无需逐条扫描整个日志
+ * - 可选延后预擦除: 启用新扇区时不立即回收其后的最旧扇区，由后台调用flash_log_maintain()
+ *   逐扇区完成，追加路径只有编程操作 (后台未及时完成时追加路径仍会同步擦除)
+ * - 可选检查点区: 启用新扇区后及定期写入写入头/序号/写入扇区摘要，挂载时读取最新检查点，
+ *   只校验少数扇区头并扫描检查点之后写入的记录，挂载耗时与扇区数无关；
+ *   检查点无效或与扇区头不符时退回全扇区扫描
+ *
+ * 扇区布局: [扇区头 40B][记录头 12B][数据 (按4字节补齐)][记录头]...[0xFF...]
+ * 检查点区: 多页轮转，检查点按槽位顺序写入，写到新页时先擦除该页 (其余页保留上一检查点)
+ * 记录时间戳须单调不减 (由调用者保证)
+ */
+
+#ifndef __FLASH_LOG_H__
+#define __FLASH_LOG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#define FLASH_LOG_MAGIC 0x474F4C48UL         // "HLOG"
+#define FLASH_LOG_MIN_SECTORS 2              // 至少一个数据扇区 + 一个预擦除扇区
+#define FLASH_LOG_MAX_LENGTH 255             // 单条记录最大数据长度
+#define FLASH_LOG_TYPE_ANY 0x00              // 读取/计数时匹配所有类型
+#define FLASH_LOG_SEQUENCE_FREE 0xFFFFFFFFUL // 扇区已擦除未启用
+#define FLASH_LOG_CHECKPOINT_MAGIC 0x4B434C48UL // "HLCK"
+#define FLASH_LOG_CHECKPOINT_MIN_PAGES 2     // 检查点区最少页数 (擦除一页时另一页保留检查点)
+#define FLASH_LOG_CHECKPOINT_INTERVAL 4      // 每启用N个新扇区写一次检查点 (挂载时沿扇区序号前滚，不超过扇区数-2)
+
+#ifndef FLASH_LOG_QUERY_DATA
+#define FLASH_LOG_QUERY_DATA 144 // 区间查询回调可见的数据长度 (超出部分截断，不小于传感器数据块)
+#endif
+
+// 类型掩码位 (扇区摘要中按类型号低5位置位)
+#define FLASH_LOG_TYPE_BIT(type) (1UL << ((type) & 0x1F))
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief 扇区摘要 (Flash格式)
+     */
+    typedef struct
+    {
+        uint32_t first_timestamp; // 首条记录时间戳
+        uint32_t last_timestamp;  // 末条记录时间戳
+        uint16_t record_count;    // 记录数
+        uint16_t record_size;     // 记录占用字节数 (记录头+补齐数据，长度不一时为0)
+        uint32_t type_mask;       // 记录类型掩码 (FLASH_LOG_TYPE_BIT)
+        uint16_t crc16;           // 摘要校验
+        uint16_t reserved;        // 保留 (0xFFFF)
+    } flash_log_summary_t;
+
+    /**
+     * @brief 扇区头 (Flash格式)
+     * @note magic/erase_count在擦除后立即写入，序号字段在扇区启用时写入，摘要在扇区写满时写入
+     */
+    typedef struct
+    {
+        uint32_t magic;              // 扇区标识
+        uint32_t erase_count;        // 擦除次数
+        uint32_t sector_sequence;    // 扇区序号 (每启用一个扇区+1)
+        uint32_t first_sequence;     // 本扇区首条记录序号
+        uint16_t crc16;              // 扇区序号/首记录序号校验
+        uint16_t reserved;           // 保留 (0xFFFF)
+        flash_log_summary_t summary; // 扇区摘要 (写满前为0xFF)
+    } flash_log_sector_t;
+
+    /**
+     * @brief 记录头 (Flash格式)
+     */
+    typedef struct
+    {
+        uint32_t sequence;  // 记录序号
+        uint32_t timestamp; // 记录时间戳
+        uint8_t type;       // 记录类型 (0x00/0xFF保留)
+        uint8_t length;     // 数据长度
+        uint16_t crc16;     // 序号/时间戳/类型/长度/数据校验
+    } flash_log_entry_t;
+
+    /**
+     * @brief 检查点 (Flash格式，按槽位顺序写入检查点区)
+     */
+    typedef struct
+    {
+        uint32_t magic;              // 检查点标识
+        uint32_t sequence;           // 检查点序号
+        uint32_t head_sequence;      // 写入扇区序号
+        uint32_t next_sequence;      // 下一条记录序号 (不含写回缓存中的记录)
+        uint32_t max_erase_count;    // 已知最大擦除次数
+        uint16_t head;               // 写入扇区
+        uint16_t head_offset;        // 写入扇区内偏移
+        uint16_t used;               // 有效扇区数
+        uint16_t crc16;              // 检查点校验 (其余全部字段)
+        flash_log_summary_t summary; // 写入扇区摘要 (已写入Flash的记录)
+    } flash_log_checkpoint_t;
+
+    /**
+     * @brief 日志统计
+     */
+    typedef struct
+    {
+        uint32_t appends;      // 追加记录数
+        uint32_t erases;       // 扇区擦除次数
+        uint32_t crc_errors;   // 读取/挂载时发现的损坏记录
+        uint32_t write_errors; // 编程/校验失败次数
+        uint32_t flushes;      // 写回缓存编程次数
+        uint32_t dropped;      // 写回失败丢弃的缓存记录数
+        uint32_t checkpoints;  // 写入检查点次数
+    } flash_log_stats_t;
+
+    /**
+     * @brief 日志实例 (RAM)
+     */
+    typedef struct
+    {
+        uint32_t base;                    // 起始地址 (扇区对齐)
+        uint16_t sector_size;             // 扇区大小
+        uint16_t sector_count;            // 扇区数
+        uint16_t head;                    // 写入扇区
+        uint16_t head_offset;             // 写入扇区内偏移
+        uint16_t used;                    // 有效扇区数 (含写入扇区)
+        bool mounted;                     // 已挂载
+        uint32_t head_sequence;           // 写入扇区序号
+        uint32_t next_sequence;           // 下一条记录序号
+        uint32_t max_erase_count;         // 已知最大擦除次数 (扇区头缺失时使用)
+        uint8_t *cache;                   // 写回缓存 (NULL: 直接写入)
+        uint16_t cache_size;              // 写回缓存大小
+        uint16_t cache_used;              // 缓存中待写入字节数 (紧接head_offset之后)
+        uint16_t cache_records;           // 缓存中待写入记录数
+        uint32_t cache_time;              // 缓存中最早记录的写入时刻 (ms)
+        flash_log_summary_t head_summary; // 写入扇区摘要 (已写入Flash的记录)
+        bool defer_erase;                 // 预擦除延后到flash_log_maintain()
+        bool erase_pending;               // 有待完成的预擦除
+        uint32_t checkpoint_base;         // 检查点区起始地址 (页对齐)
+        uint16_t checkpoint_pages;        // 检查点区页数 (0: 不使用检查点)
+        uint16_t checkpoint_slot;         // 下一个检查点槽位 (区内序号)
+        uint32_t checkpoint_sequence;     // 下一个检查点序号
+        uint32_t checkpoint_records;      // 最近检查点的next_sequence (未变化时不再写入)
+        uint16_t checkpoint_sectors;      // 最近检查点之后启用的扇区数
+        bool checkpoint_due;              // 启用新扇区后尚未写入检查点
+        bool checkpoint_mounted;          // 本次挂载使用了检查点
+        flash_log_stats_t stats;          // 统计信息
+    } flash_log_t;
+
+    /**
+     * @brief 顺序读取游标 (按扇区序号定位，读取期间旧扇区被回收时自动跳到最旧记录)
+     */
+    typedef struct
+    {
+        uint32_t sector_sequence; // 当前扇区序号
+        uint16_t offset;          // 扇区内偏移
+    } flash_log_cursor_t;
+
+    /**
+     * @brief 区间查询回调
+     * @param entry 记录头
+     * @param data 记录数据 (最多FLASH_LOG_QUERY_DATA字节)
+     * @param context 调用者上下文
+     * @return true: 继续, false: 停止查询
+     */
+    typedef bool (*flash_log_visitor_t)(const flash_log_entry_t *entry, const void *data, void *context);
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief 挂载日志 (读取检查点或扫描扇区头找到写入头，必要时完成被打断的预擦除)
+     * @param log 日志实例
+     * @param base 起始地址 (须按sector_size对齐)
+     * @param sector_size 扇区大小 (Flash擦除页的整数倍)
+     * @param sector_count 扇区数 (>= FLASH_LOG_MIN_SECTORS)
+     * @return true: 成功, false: 参数无效或Flash操作失败
+     * @note 区域内无有效扇区时自动格式化；已设置的写回缓存与检查点区保留，缓存中未写入的记录丢弃
+     */
+    bool flash_log_mount(flash_log_t *log, uint32_t base, uint16_t sector_size, uint16_t sector_count);
+
+    /**
+     * @brief 格式化日志 (擦除全部扇区，保留擦除计数)
+     * @param log 日志实例 (须已设置区域参数)
+     * @return true: 成功, false: 失败
+     */
+    bool flash_log_format(flash_log_t *log);
+
+    /**
+     * @brief 追加一条记录
+     * @param log 日志实例
+     * @param type 记录类型 (0x01~0xFE)
+     * @param timestamp 记录时间戳 (不小于上一条记录)
+     * @param data 数据指针
+     * @param length 数据长度 (1~FLASH_LOG_MAX_LENGTH)
+     * @return true: 成功, false: 失败
+     * @note 写入扇区满时写入其摘要，启用下一个预擦除扇区，并擦除其后的最旧扇区；
+     *       设置了写回缓存时记录先进入缓存，缓存满或写入扇区满时一次编程写入
+     */
+    bool flash_log_append(flash_log_t *log, uint8_t type, uint32_t timestamp, const void *data, uint8_t length);
+
+    /**
+     * @brief 设置写回缓存
+     * @param log 日志实例
+     * @param buffer 缓存 (NULL: 关闭缓存)
+     * @param size 缓存大小 (按4字节向下对齐；超过缓存大小的记录直接写入)
+     * @note 更换或关闭前先写回已缓存的记录
+     */
+    void flash_log_set_cache(flash_log_t *log, uint8_t *buffer, uint16_t size);
+
+    /**
+     * @brief 将缓存中的记录一次编程写入Flash
+     * @param log 日志实例
+     * @return true: 成功或无待写入记录, false: 编程/校验失败 (缓存记录丢弃)
+     * @note 掉电告警/关机前调用；读取接口会先自动写回
+     */
+    bool flash_log_flush(flash_log_t *log);
+
+    /**
+     * @brief 缓存中最早记录超过时限时写回
+     * @param log 日志实例
+     * @param max_age_ms 最大缓存时间 (ms)
+     * @return true: 未到时限或写回成功, false: 写回失败
+     */
+    bool flash_log_flush_expired(flash_log_t *log, uint32_t max_age_ms);
+
+    /**
+     * @brief 缓存中待写入的记录数
+     * @param log 日志实例
+     * @return 记录数
+     */
+    uint16_t flash_log_get_pending(const flash_log_t *log);
+
+    /**
+     * @brief 设置延后预擦除
+     * @param log 日志实例
+     * @param defer true: 启用新扇区时不擦除其后的扇区, false: 立即擦除 (默认)
+     * @note 挂载时保留该设置
+     */
+    void flash_log_set_deferred_erase(flash_log_t *log, bool defer);
+
+    /**
+     * @brief 执行一步后台维护 (完成延后的预擦除或检查点，最多擦除一个扇区)
+     * @param log 日志实例
+     * @return true: 本次执行了Flash操作, false: 无待完成的维护
+     */
+    bool flash_log_maintain(flash_log_t *log);
+
+    /**
+     * @brief 设置检查点区
+     * @param log 日志实例
+     * @param base 检查点区起始地址 (须按Flash页对齐，不与日志区重叠)
+     * @param page_count 页数 (>= FLASH_LOG_CHECKPOINT_MIN_PAGES；0: 不使用检查点)
+     * @note 挂载前设置，挂载时保留该设置；每启用FLASH_LOG_CHECKPOINT_INTERVAL个新扇区写入一次检查点，
+     *       未延后预擦除时立即写入，否则由flash_log_maintain()写入
+     */
+    void flash_log_set_checkpoint(flash_log_t *log, uint32_t base, uint16_t page_count);
+
+    /**
+     * @brief 写入检查点 (定期调用，缩短挂载时需要扫描的记录)
+     * @param log 日志实例
+     * @return true: 已写入或自上一检查点后无新记录, false: 未设置检查点区或写入失败
+     * @note 写到新的一页时先擦除该页
+     */
+    bool flash_log_checkpoint(flash_log_t *log);
+
+    /**
+     * @brief 游标定位到最旧记录
+     * @param log 日志实例
+     * @param cursor 游标
+     */
+    void flash_log_rewind(const flash_log_t *log, flash_log_cursor_t *cursor);
+
+    /**
+     * @brief 读取下一条有效记录 (从旧到新)
+     * @param log 日志实例
+     * @param cursor 游标
+     * @param entry 输出记录头 (可为NULL)
+     * @param data 输出数据 (可为NULL)
+     * @param max_length 数据缓冲区大小 (超出部分截断，entry->length为实际长度)
+     * @return true: 读到记录, false: 已到末尾
+     */
+    bool flash_log_next(flash_log_t *log, flash_log_cursor_t *cursor, flash_log_entry_t *entry,
+                        void *data, uint8_t max_length);
+
+    /**
+     * @brief 游标定位到序号不小于sequence的第一条记录
+     * @param log 日志实例
+     * @param cursor 游标
+     * @param sequence 记录序号 (早于最旧记录时定位到最旧记录)
+     * @note 先按扇区头首记录序号二分定位扇区，再在扇区内逐条跳过
+     */
+    void flash_log_seek(flash_log_t *log, flash_log_cursor_t *cursor, uint32_t sequence);
+
+    /**
+     * @brief 读取flash_log_next刚读到的记录的一段数据 (不经RAM暂存整条记录)
+     * @param log 日志实例
+     * @param cursor flash_log_next返回后的游标
+     * @param entry flash_log_next返回的记录头
+     * @param offset 数据内偏移
+     * @param data 输出缓冲区
+     * @param length 读取长度 (超出记录数据的部分截断)
+     * @return 实际读取字节数，记录所在扇区已被回收时返回0
+     */
+    uint16_t flash_log_read_data(flash_log_t *log, const flash_log_cursor_t *cursor, const flash_log_entry_t *entry,
+                                 uint16_t offset, void *data, uint16_t length);
+
+    /**
+     * @brief 读取某类型最新的若干条定长记录 (从新到旧)
+     * @param log 日志实例
+     * @param type 记录类型 (FLASH_LOG_TYPE_ANY匹配所有)
+     * @param records 输出数组
+     * @param record_size 单条记录大小 (长度不符的记录跳过)
+     * @param count 最多读取条数
+     * @return 实际读取条数
+     */
+    uint16_t flash_log_read_latest(flash_log_t *log, uint8_t type, void *records, uint8_t record_size,
+                                   uint16_t count);
+
+    /**
+     * @brief 按时间区间查询记录 (从旧到新回调)
+     * @param log 日志实例
+     * @param type 记录类型 (FLASH_LOG_TYPE_ANY匹配所有)
+     * @param start_time 起始时间戳 (含)
+     * @param end_time 结束时间戳 (含)
+     * @param visitor 回调函数
+     * @param context 回调上下文
+     * @return 回调的记录数
+     * @note 先二分扇区摘要定位起始扇区，定长记录扇区内再二分定位起始记录
+     */
+    uint32_t flash_log_query(flash_log_t *log, uint8_t type, uint32_t start_time, uint32_t end_time,
+                             flash_log_visitor_t visitor, void *context);
+
+    /**
+     * @brief 读取最新记录的时间戳
+     * @param log 日志实例
+     * @param timestamp 输出时间戳
+     * @return true: 成功, false: 日志为空
+     */
+    bool flash_log_get_last_timestamp(flash_log_t *log, uint32_t *timestamp);
+
+    /**
+     * @brief 统计某类型有效记录数
+     * @param log 日志实例
+     * @param type 记录类型 (FLASH_LOG_TYPE_ANY匹配所有)
+     * @return 记录数
+     */
+    uint32_t flash_log_count(flash_log_t *log, uint8_t type);
+
+    /**
+     * @brief 获取回收最旧扇区前还可写入的字节数
+     * @param log 日志实例
+     * @return 字节数
+     */
+    uint32_t flash_log_get_free_space(const flash_log_t *log);
+
+    /**
+     * @brief 读取扇区擦除次数 (来自扇区头)
+     * @param log 日志实例
+     * @param sector 扇区号 (0 ~ sector_count-1)
+     * @return 擦除次数，扇区头无效时返回0
+     */
+    uint32_t flash_log_get_erase_count(const flash_log_t *log, uint16_t sector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FLASH_LOG_H__
@@ -0,0 +1,137 @@
+/**
+ * @file history_codec.h
+ * @brief 憨云DTU传感器历史数据块压缩编码接口
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 一个数据块保存一段连续采样:
+ * - 块头: 版本、采样数、首个采样原值
+ * - 后续采样: 时间戳二阶差分 + 各通道一阶差分，均为zigzag变长整数
+ * - 固定周期、缓变信号下每个采样约4字节 (原始记录加日志记录头为36字节)
+ * 解码为流式迭代，不需要整块展开的缓冲区
+ *
+ * 块布局: [版本 1B][采样数 1B][时间戳 4B][温度 2B][湿度 2B][电压 2B][状态 1B]
+ *         [控制(二阶差分<<1|状态变化)][温度差][湿度差][电压差]([状态])...
+ */
+
+#ifndef __HISTORY_CODEC_H__
+#define __HISTORY_CODEC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#define HISTORY_CODEC_VERSION 1        // 块格式版本
+#define HISTORY_CODEC_HEADER_SIZE 13   // 块头大小 (含首个采样)
+#define HISTORY_CODEC_SAMPLE_MAX 15    // 单个差分采样最大编码长度
+#define HISTORY_CODEC_MAX_SAMPLES 255  // 单块最大采样数
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief 传感器采样
+     */
+    typedef struct
+    {
+        uint32_t timestamp;  // 时间戳 (ms)
+        int16_t temperature; // 温度 (0.1°C)
+        uint16_t humidity;   // 湿度 (0.1%RH)
+        uint16_t voltage;    // 电压 (mV)
+        uint8_t status;      // 传感器状态
+    } history_sample_t;
+
+    /**
+     * @brief 块编码器 (编码到调用者提供的缓冲区)
+     */
+    typedef struct
+    {
+        uint8_t *buffer;         // 块缓冲区
+        uint16_t capacity;       // 缓冲区大小
+        uint16_t length;         // 已编码字节数
+        uint8_t count;           // 已编码采样数
+        history_sample_t last;   // 上一采样
+        int32_t last_delta;      // 上一时间间隔
+    } history_encoder_t;
+
+    /**
+     * @brief 块解码器 (流式)
+     */
+    typedef struct
+    {
+        const uint8_t *data;     // 块数据
+        uint16_t length;         // 块长度
+        uint16_t offset;         // 解码位置
+        uint8_t remaining;       // 剩余采样数
+        bool started;            // 已输出首个采样
+        history_sample_t last;   // 上一采样
+        int32_t last_delta;      // 上一时间间隔
+    } history_decoder_t;
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief 初始化编码器 (开始新块)
+     * @param encoder 编码器
+     * @param buffer 块缓冲区
+     * @param capacity 缓冲区大小 (>= HISTORY_CODEC_HEADER_SIZE)
+     * @return true: 成功, false: 参数无效
+     */
+    bool history_encoder_init(history_encoder_t *encoder, uint8_t *buffer, uint16_t capacity);
+
+    /**
+     * @brief 追加一个采样
+     * @param encoder 编码器
+     * @param sample 采样 (时间戳不小于上一采样)
+     * @return true: 已编码, false: 块已满或时间戳回退 (块内容不变)
+     */
+    bool history_encoder_add(history_encoder_t *encoder, const history_sample_t *sample);
+
+    /**
+     * @brief 获取已编码块长度
+     * @param encoder 编码器
+     * @return 字节数 (无采样时为0)
+     */
+    uint16_t history_encoder_length(const history_encoder_t *encoder);
+
+    /**
+     * @brief 初始化解码器
+     * @param decoder 解码器
+     * @param data 块数据
+     * @param length 块长度
+     * @return true: 块头有效, false: 版本或长度无效
+     */
+    bool history_decoder_init(history_decoder_t *decoder, const uint8_t *data, uint16_t length);
+
+    /**
+     * @brief 解码下一个采样
+     * @param decoder 解码器
+     * @param sample 输出采样
+     * @return true: 成功, false: 已结束或数据损坏
+     */
+    bool history_decoder_next(history_decoder_t *decoder, history_sample_t *sample);
+
+    /**
+     * @brief 读取块内采样数 (不解码)
+     * @param data 块数据
+     * @param length 块长度
+     * @return 采样数，块无效时为0
+     */
+    uint8_t history_block_count(const uint8_t *data, uint16_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HISTORY_CODEC_H__
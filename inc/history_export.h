@@ -0,0 +1,224 @@
+/**
+ * @file history_export.h
+ * @brief 憨云DTU历史数据批量导出接口 (与传输方式无关)
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 将记录日志中的一段历史记录按传输MTU切块导出:
+ * - 记录按导出格式串接为字节流，块在任意字节处切分，记录可跨块
+ * - 每块带起始位置 (块首字节所属记录序号 + 记录内偏移) 与CRC16，接收方可校验并拼接
+ * - 续传位置 = 最后一个正确接收块的 (序号, 偏移 + 长度)，断线/重启后从该位置继续导出
+ * - 流量控制为go-back-N: 最多window个块未确认，确认按块编号累计，超时后从最早未确认块重发
+ * - 直接从Flash读取: 只保存每个未确认块的起始位置，重发时重新定位读取，不暂存导出范围
+ * - 推送式传输 (BLE通知/MQTT发布) 由history_export_task()按窗口发送；
+ *   拉取式传输 (Modbus文件记录) 由主站按块编号读取，读取下一块即确认上一块
+ *
+ * 块格式: [会话 1B][标志 1B][块编号 2B][记录序号 4B][记录内偏移 2B][负载长度 2B][CRC16 2B][负载]
+ * 记录格式: [记录序号 4B][时间戳 4B][类型 1B][数据长度 1B][数据]
+ * 多字节字段均为小端
+ */
+
+#ifndef __HISTORY_EXPORT_H__
+#define __HISTORY_EXPORT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "flash_log.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#define HISTORY_EXPORT_HEADER_SIZE 14        // 块头大小
+#define HISTORY_EXPORT_RECORD_HEADER 10      // 导出记录头大小
+#define HISTORY_EXPORT_MIN_CHUNK 20          // 最小块大小 (含块头，BLE默认ATT MTU的通知负载)
+#define HISTORY_EXPORT_MAX_CHUNK 256         // 最大块大小 (含块头)
+#define HISTORY_EXPORT_MAX_WINDOW 8          // 最大未确认块数
+#define HISTORY_EXPORT_TIMEOUT_MS 2000       // 默认确认超时
+#define HISTORY_EXPORT_FLAG_LAST 0x01        // 导出范围的最后一块
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief 导出位置 (续传令牌)
+     */
+    typedef struct
+    {
+        uint32_t sequence; // 记录序号 (不存在时从其后第一条符合条件的记录开始)
+        uint16_t offset;   // 从该记录起始处计算的字节偏移 (可超过该记录长度)
+    } history_export_position_t;
+
+    /**
+     * @brief 导出请求
+     */
+    typedef struct
+    {
+        uint8_t type;                     // 记录类型 (FLASH_LOG_TYPE_ANY导出全部类型)
+        uint32_t start_time;              // 起始时间戳 (含)
+        uint32_t end_time;                // 结束时间戳 (含)
+        bool resume;                      // true: 从position续传 (忽略start_time)
+        history_export_position_t position; // 续传位置 (type/end_time须与原会话相同)
+    } history_export_request_t;
+
+    /**
+     * @brief 块发送函数 (推送式传输)
+     * @param chunk 块数据
+     * @param length 块长度
+     * @param context 传输上下文
+     * @return true: 已交给链路, false: 链路忙 (稍后重试本块)
+     */
+    typedef bool (*history_export_send_t)(const uint8_t *chunk, uint16_t length, void *context);
+
+    /**
+     * @brief 传输描述
+     */
+    typedef struct
+    {
+        history_export_send_t send; // 发送函数 (NULL: 拉取式传输)
+        void *context;              // 传输上下文
+        uint16_t mtu;               // 块大小上限 (含块头，HISTORY_EXPORT_MIN_CHUNK~MAX_CHUNK)
+        uint8_t window;             // 未确认块上限 (1~HISTORY_EXPORT_MAX_WINDOW)
+        uint32_t timeout_ms;        // 确认超时 (0: HISTORY_EXPORT_TIMEOUT_MS)
+    } history_export_transport_t;
+
+    /**
+     * @brief 解析后的块头
+     */
+    typedef struct
+    {
+        uint8_t session;                    // 会话号
+        uint8_t flags;                      // 标志 (HISTORY_EXPORT_FLAG_LAST)
+        uint16_t index;                     // 块编号 (会话内从0递增)
+        history_export_position_t position; // 块首字节位置
+        uint16_t length;                    // 负载长度
+    } history_export_chunk_t;
+
+    /**
+     * @brief 导出统计
+     */
+    typedef struct
+    {
+        uint32_t chunks;      // 发送块数 (含重发)
+        uint32_t bytes;       // 发送字节数 (含块头)
+        uint32_t records;     // 读取的记录数 (含重发时重读)
+        uint32_t retransmits; // 回退重发次数 (超时/重复请求)
+        uint32_t gaps;        // 起始位置的记录已被回收、跳到其后最旧记录的次数
+    } history_export_stats_t;
+
+    /**
+     * @brief 导出会话 (RAM，不含数据缓冲区)
+     */
+    typedef struct
+    {
+        flash_log_t *log;                    // 数据来源
+        history_export_transport_t transport; // 传输描述
+        uint8_t type;                        // 记录类型
+        uint32_t start_time;                 // 起始时间戳
+        uint32_t end_time;                   // 结束时间戳
+        uint32_t end_sequence;               // 导出截止序号 (开始导出时的下一条记录序号)
+        uint8_t session;                     // 会话号
+        bool active;                         // 会话有效
+        flash_log_cursor_t cursor;           // 读取游标 (当前记录之后)
+        flash_log_entry_t entry;             // 当前记录
+        bool eof;                            // 已读完导出范围
+        uint16_t record_offset;              // 当前记录已输出的字节数
+        history_export_position_t inflight[HISTORY_EXPORT_MAX_WINDOW]; // 未确认块的起始位置
+        uint16_t base_index;                 // 最早未确认块
+        uint16_t next_index;                 // 下一个发送块
+        uint16_t last_index;                 // 最后一块的编号
+        bool last_built;                     // 最后一块已生成
+        uint32_t ack_time;                   // 最近确认 (或开始) 时刻
+        history_export_stats_t stats;        // 统计信息
+    } history_export_t;
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief 开始导出会话
+     * @param exporter 导出会话
+     * @param log 数据来源 (须已挂载)
+     * @param request 导出请求
+     * @param transport 传输描述 (复制保存)
+     * @return true: 成功, false: 参数无效
+     * @note 导出范围截止到开始时已写入的记录，导出期间追加的记录不包含在内
+     */
+    bool history_export_start(history_export_t *exporter, flash_log_t *log, const history_export_request_t *request,
+                              const history_export_transport_t *transport);
+
+    /**
+     * @brief 生成下一个待发送的块 (窗口未满时)
+     * @param exporter 导出会话
+     * @param buffer 块缓冲区 (不小于transport.mtu)
+     * @return 块长度, 0: 窗口已满/已全部发送/会话无效
+     */
+    uint16_t history_export_poll(history_export_t *exporter, uint8_t *buffer);
+
+    /**
+     * @brief 确认块 (累计确认该编号及之前的全部块)
+     * @param exporter 导出会话
+     * @param index 块编号
+     * @return true: 确认有效, false: 编号不在未确认范围内
+     */
+    bool history_export_ack(history_export_t *exporter, uint16_t index);
+
+    /**
+     * @brief 从最早未确认块开始重发 (go-back-N)
+     * @param exporter 导出会话
+     */
+    void history_export_retransmit(history_export_t *exporter);
+
+    /**
+     * @brief 拉取指定编号的块 (拉取式传输)
+     * @param exporter 导出会话
+     * @param index 块编号 (下一块: 同时确认上一块; 上一块: 重新生成)
+     * @param buffer 块缓冲区 (不小于transport.mtu)
+     * @return 块长度, 0: 编号无效或已全部导出
+     */
+    uint16_t history_export_pull(history_export_t *exporter, uint16_t index, uint8_t *buffer);
+
+    /**
+     * @brief 推送式传输的发送任务 (主循环中调用)
+     * @param exporter 导出会话
+     * @param buffer 块缓冲区 (不小于transport.mtu)
+     * @return 本次发送的块数
+     * @note 确认超时时先回退重发；发送函数返回false时本块留到下次调用
+     */
+    uint8_t history_export_task(history_export_t *exporter, uint8_t *buffer);
+
+    /**
+     * @brief 检查导出是否完成 (最后一块已确认)
+     * @param exporter 导出会话
+     * @return true: 已完成
+     */
+    bool history_export_is_done(const history_export_t *exporter);
+
+    /**
+     * @brief 获取续传位置 (最早未确认块的起始位置)
+     * @param exporter 导出会话
+     * @param position 输出位置
+     */
+    void history_export_get_resume(const history_export_t *exporter, history_export_position_t *position);
+
+    /**
+     * @brief 解析并校验块 (接收端)
+     * @param data 块数据
+     * @param length 块长度
+     * @param chunk 输出块头 (负载位于data + HISTORY_EXPORT_HEADER_SIZE)
+     * @return true: 块完整且CRC正确
+     */
+    bool history_export_parse_chunk(const uint8_t *data, uint16_t length, history_export_chunk_t *chunk);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HISTORY_EXPORT_H__
@@ -0,0 +1,107 @@
+/**
+ * @file history_export_adapter.h
+ * @brief 憨云DTU历史数据导出的传输适配 (Modbus文件记录/BLE通知/MQTT发布)
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 同一时刻只有一个导出会话，任一传输发起新导出时替换当前会话:
+ * - Modbus: 主站写文件记录 (文件号HISTORY_EXPORT_MODBUS_FILE，记录号0) 发起导出，
+ *   再按块编号读文件记录 (记录号 = 块编号) 逐块拉取，块按大端寄存器打包，不足部分补0
+ * - BLE: 通过通知推送，客户端写特征值确认
+ * - MQTT: 发布到指定主题 (QoS1)，服务端在确认主题上回复确认
+ * 确认格式: [会话 1B][块编号 2B 小端]
+ *
+ * Modbus导出请求寄存器: [数据类型][起始时间 高/低][结束时间 高/低][续传标志][续传序号 高/低][续传偏移]
+ */
+
+#ifndef __HISTORY_EXPORT_ADAPTER_H__
+#define __HISTORY_EXPORT_ADAPTER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "history_export.h"
+#include "modbus.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#define HISTORY_EXPORT_MODBUS_FILE 1         // Modbus导出文件号
+#define HISTORY_EXPORT_MODBUS_REQUEST_REGS 9 // Modbus导出请求寄存器数
+#define HISTORY_EXPORT_MODBUS_CHUNK (MODBUS_FILE_RECORD_MAX_READ * 2) // Modbus块大小 (248B)
+#define HISTORY_EXPORT_BLE_WINDOW 4          // BLE未确认块上限
+#define HISTORY_EXPORT_MQTT_CHUNK 256        // MQTT块大小
+#define HISTORY_EXPORT_MQTT_WINDOW 4         // MQTT未确认块上限
+#define HISTORY_EXPORT_ACK_SIZE 3            // 确认消息长度
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief Modbus写文件记录回调: 发起导出
+     * @note 注册到modbus_slave_callbacks_t.write_file_record
+     */
+    modbus_status_t history_export_modbus_write_file(uint16_t file, uint16_t record, uint16_t length,
+                                                     const uint16_t *values);
+
+    /**
+     * @brief Modbus读文件记录回调: 拉取块
+     * @note 注册到modbus_slave_callbacks_t.read_file_record；length须能容纳整块
+     */
+    modbus_status_t history_export_modbus_read_file(uint16_t file, uint16_t record, uint16_t length,
+                                                    uint16_t *values);
+
+    /**
+     * @brief 通过BLE通知开始导出
+     * @param conn_handle 连接句柄
+     * @param char_handle 导出特征句柄
+     * @param att_mtu 协商的ATT MTU (通知负载为att_mtu-3)
+     * @param request 导出请求 (request->type为存储数据类型STORAGE_TYPE_*)
+     * @return true: 成功, false: 参数无效或存储未就绪
+     */
+    bool history_export_ble_start(uint16_t conn_handle, uint16_t char_handle, uint16_t att_mtu,
+                                  const history_export_request_t *request);
+
+    /**
+     * @brief 通过MQTT发布开始导出
+     * @param topic 发布主题
+     * @param request 导出请求 (request->type为存储数据类型STORAGE_TYPE_*)
+     * @return true: 成功, false: 参数无效或存储未就绪
+     */
+    bool history_export_mqtt_start(const char *topic, const history_export_request_t *request);
+
+    /**
+     * @brief 处理推送式传输收到的确认
+     * @param data 确认消息 ([会话][块编号])
+     * @param length 消息长度
+     * @return true: 确认有效
+     */
+    bool history_export_on_ack(const uint8_t *data, uint16_t length);
+
+    /**
+     * @brief 导出后台任务 (主循环中调用，推送窗口内的块并处理超时)
+     */
+    void history_export_adapter_task(void);
+
+    /**
+     * @brief 结束当前导出会话
+     */
+    void history_export_stop(void);
+
+    /**
+     * @brief 获取当前导出会话 (状态/统计查询)
+     * @return 导出会话
+     */
+    const history_export_t *history_export_get_session(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HISTORY_EXPORT_ADAPTER_H__
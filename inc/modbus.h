@@ -34,6 +34,12 @@
 #define MODBUS_FC_WRITE_SINGLE_REGISTER 0x06    // 写单个寄存器
 #define MODBUS_FC_WRITE_MULTIPLE_COILS 0x0F     // 写多个线圈
 #define MODBUS_FC_WRITE_MULTIPLE_REGISTERS 0x10 // 写多个寄存器
+#define MODBUS_FC_READ_FILE_RECORD 0x14         // 读文件记录
+#define MODBUS_FC_WRITE_FILE_RECORD 0x15        // 写文件记录
+
+#define MODBUS_FILE_REFERENCE_TYPE 6     // 文件记录引用类型
+#define MODBUS_FILE_RECORD_MAX_READ 124  // 单次读文件记录最大寄存器数 (单个子请求)
+#define MODBUS_FILE_RECORD_MAX_WRITE 122 // 单次写文件记录最大寄存器数 (单个子请求)
 
 // Modbus异常码定义
 #define MODBUS_EXCEPTION_ILLEGAL_FUNCTION 0x01
@@ -110,6 +116,9 @@ typedef modbus_status_t (*modbus_read_registers_cb_t)(uint16_t addr, uint16_t qu
 typedef modbus_status_t (*modbus_write_registers_cb_t)(uint16_t addr, uint16_t quantity, const uint16_t *values);
 typedef modbus_status_t (*modbus_read_coils_cb_t)(uint16_t addr, uint16_t quantity, uint8_t *values);
 typedef modbus_status_t (*modbus_write_coils_cb_t)(uint16_t addr, uint16_t quantity, const uint8_t *values);
+typedef modbus_status_t (*modbus_read_file_cb_t)(uint16_t file, uint16_t record, uint16_t length, uint16_t *values);
+typedef modbus_status_t (*modbus_write_file_cb_t)(uint16_t file, uint16_t record, uint16_t length,
+                                                  const uint16_t *values);
 
 /**
  * @brief Modbus从站回调函数结构体
@@ -122,6 +131,8 @@ typedef struct
     modbus_read_coils_cb_t read_coils;
     modbus_write_coils_cb_t write_coils;
     modbus_read_coils_cb_t read_discrete_inputs;
+    modbus_read_file_cb_t read_file_record;   // 读文件记录 (NULL: 不支持)
+    modbus_write_file_cb_t write_file_record; // 写文件记录 (NULL: 不支持)
 } modbus_slave_callbacks_t;
 
 // ============================================================================
@@ -153,6 +164,15 @@ modbus_status_t modbus_set_slave_callbacks(const modbus_slave_callbacks_t *callb
  */
 void modbus_task(void);
 
+/**
+ * @brief 判断总线能否容忍一段阻塞 (从站模式)
+ * @param duration_ms 阻塞时长 (ms)
+ * @param context 未使用 (storage_idle_check_t签名)
+ * @return true: 无待处理请求且预计下一个轮询请求前可完成, false: 请推迟
+ * @note 从站初始化时注册为存储模块的空闲检查，Flash擦除只在轮询间隙执行
+ */
+bool modbus_is_idle(uint32_t duration_ms, void *context);
+
 // ============================================================================
 // Modbus主站接口
 // ============================================================================
@@ -82,6 +82,17 @@ extern "C"
 #define MQTT_MESSAGE_POOL_SIZE 5
 #define MQTT_SUBSCRIPTION_MAX 10
 
+// 客户端收发缓冲区 (静态分配，8KB RAM下按需调整)
+#ifndef MQTT_TX_BUFFER_SIZE
+#define MQTT_TX_BUFFER_SIZE 400 // 发送缓冲区 (单个报文上限: 256B载荷 + 主题 + 报文头)
+#endif
+#ifndef MQTT_RX_BUFFER_SIZE
+#define MQTT_RX_BUFFER_SIZE 256 // 接收报文体缓冲区 (更长的报文被跳过)
+#endif
+#define MQTT_RX_CHUNK 64 // 单次从传输层读取的字节数
+
+#define MQTT_ALARM_TOPIC_FORMAT "dtu/%s/alarm" // 报警通知发布主题 (%s为客户端ID)
+
     /* ================================ 数据结构 ================================ */
 
     /**
@@ -110,6 +121,15 @@ extern "C"
         MQTT_EVENT_ERROR                ///< 错误事件
     } mqtt_event_type_t;
 
+    /**
+     * @brief 遥测载荷格式枚举
+     */
+    typedef enum
+    {
+        MQTT_PAYLOAD_JSON = 0, ///< JSON文本 (snprintf)
+        MQTT_PAYLOAD_PACKED    ///< 紧凑二进制 (见telemetry_codec.h)
+    } mqtt_payload_format_t;
+
     /**
      * @brief MQTT连接配置结构
      */
@@ -127,6 +147,7 @@ extern "C"
         uint8_t protocol_version;               ///< 协议版本
         uint32_t connect_timeout;               ///< 连接超时(ms)
         uint32_t message_timeout;               ///< 消息超时(ms)
+        uint8_t payload_format;                 ///< 遥测载荷格式 (mqtt_payload_format_t)
     } mqtt_config_t;
 
     /**
@@ -218,6 +239,18 @@ extern "C"
      */
     typedef void (*mqtt_log_callback_t)(int level, const char *message);
 
+    /**
+     * @brief MQTT传输层 (默认为4G模块TCP Socket)
+     */
+    typedef struct
+    {
+        int (*open)(const char *host, uint16_t port, void *context);      ///< 建立连接, 0:成功
+        int (*send)(const uint8_t *data, uint16_t length, void *context); ///< 发送, 0:成功
+        int (*receive)(uint8_t *buffer, uint16_t size, void *context);    ///< 非阻塞接收, >=0:字节数, <0:失败
+        void (*close)(void *context);                                     ///< 关闭连接
+        void *context;                                                    ///< 上下文
+    } mqtt_transport_t;
+
     /* ================================ API接口 ================================ */
 
     /**
@@ -247,9 +280,17 @@ extern "C"
      */
     int mqtt_set_log_callback(mqtt_log_callback_t callback);
 
+    /**
+     * @brief 设置传输层
+     * @param transport 传输层, NULL:恢复默认的4G Socket
+     * @return 0:成功, <0:失败 (连接未断开)
+     */
+    int mqtt_set_transport(const mqtt_transport_t *transport);
+
     /**
      * @brief 连接到MQTT服务器
-     * @return 0:成功, <0:失败
+     * @return 0:CONNECT已发出, <0:失败
+     * @note 收到CONNACK后 (mqtt_task中) 进入已连接状态并触发MQTT_EVENT_CONNECTED
      */
     int mqtt_connect(void);
 
@@ -283,6 +324,35 @@ extern "C"
     int mqtt_publish(const char *topic, const void *payload, uint16_t len,
                      uint8_t qos, bool retain);
 
+    /**
+     * @brief 开始零拷贝发布: 返回发送缓冲区中的载荷位置，调用方直接把载荷编码到该位置
+     * @param topic 主题
+     * @param qos QoS等级 (0或1)
+     * @param retain 保留标志
+     * @param capacity 输出载荷可用长度
+     * @return 载荷写入位置, NULL:失败
+     * @note 与mqtt_publish_commit()之间不得调用其他MQTT接口
+     */
+    uint8_t *mqtt_publish_begin(const char *topic, uint8_t qos, bool retain, uint16_t *capacity);
+
+    /**
+     * @brief 完成零拷贝发布并发送
+     * @param len 已写入的载荷长度
+     * @return >=0:报文ID (QoS0为0), <0:失败
+     * @note QoS1报文收到PUBACK时触发MQTT_EVENT_MESSAGE_SENT (data指向报文ID)
+     */
+    int mqtt_publish_commit(uint16_t len);
+
+    /**
+     * @brief 重发未确认的QoS1消息 (置DUP标志，沿用原报文ID)
+     * @param topic 主题
+     * @param payload 消息内容
+     * @param len 消息长度
+     * @param packet_id 首次发布时mqtt_publish_commit()返回的报文ID
+     * @return 0:成功, <0:失败
+     */
+    int mqtt_publish_retry(const char *topic, const void *payload, uint16_t len, uint16_t packet_id);
+
     /**
      * @brief 发布JSON格式消息
      * @param topic 主题
@@ -591,6 +661,25 @@ extern "C"
      */
     int mqtt_encode_alarm_info(char *buffer, uint16_t size, const mqtt_alarm_info_t *alarm);
 
+    /**
+     * @brief 按配置的载荷格式编码传感器数据
+     * @param buffer 输出缓冲区 (可为mqtt_publish_begin()返回的载荷位置)
+     * @param size 缓冲区大小
+     * @param data 传感器数据
+     * @return 载荷长度, <0:失败
+     * @note MQTT_PAYLOAD_PACKED时物理量按JSON相同精度 (温湿度0.1，电压/电流/功率0.01) 转为整数后打包
+     */
+    int mqtt_encode_sensor_payload(uint8_t *buffer, uint16_t size, const mqtt_sensor_data_t *data);
+
+    /**
+     * @brief 按配置的载荷格式编码设备状态
+     * @param buffer 输出缓冲区
+     * @param size 缓冲区大小
+     * @param status 设备状态
+     * @return 载荷长度, <0:失败
+     */
+    int mqtt_encode_status_payload(uint8_t *buffer, uint16_t size, const device_status_t *status);
+
     /**
      * @brief 解析配置JSON
      * @param json JSON字符串
@@ -0,0 +1,181 @@
+/**
+ * @file mqtt_codec.h
+ * @brief 憨云DTU MQTT 3.1.1报文编解码接口
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 与连接管理无关的纯编解码，客户端 (mqtt.c) 与测试中的服务器替身共用:
+ * - 编码: 直接写入调用方的发送缓冲区 (即Socket发送缓冲区)，不经中间缓冲
+ * - PUBLISH两段式编码: begin写入主题与报文ID并返回载荷位置，调用方把载荷直接编码到该位置，
+ *   end回填固定头。固定头预留MQTT_CODEC_PUBLISH_RESERVE字节，按实际剩余长度右对齐，无需搬移数据
+ * - 流式解析: 输入可在任意字节处分段，报文体收集到解析器缓冲区，收齐后解码为mqtt_codec_packet_t
+ *   (主题与载荷指向解析器缓冲区，下一次输入前有效)；超过缓冲区的报文整体跳过
+ */
+
+#ifndef __MQTT_CODEC_H__
+#define __MQTT_CODEC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "mqtt.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#define MQTT_CODEC_PUBLISH_RESERVE 4          // PUBLISH固定头预留 (首字节 + 至多3字节剩余长度)
+#define MQTT_CODEC_MAX_REMAINING 0x0FFFFFFFUL // 剩余长度上限 (4字节变长编码)
+
+// PUBLISH固定头标志
+#define MQTT_CODEC_FLAG_DUP 0x08
+#define MQTT_CODEC_FLAG_RETAIN 0x01
+
+// SUBACK失败返回码
+#define MQTT_CODEC_SUBACK_FAILURE 0x80
+
+// 解析结果
+#define MQTT_CODEC_NEED_MORE 0 // 报文未收齐
+#define MQTT_CODEC_PACKET 1    // 收齐一个报文
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief PUBLISH两段式编码上下文
+     */
+    typedef struct
+    {
+        uint8_t *buffer;     // 发送缓冲区
+        uint8_t *payload;    // 载荷写入位置
+        uint16_t capacity;   // 载荷可用长度
+        uint16_t header_len; // 可变头长度 (主题 + 报文ID)
+        uint8_t first_byte;  // 固定头首字节
+    } mqtt_publish_frame_t;
+
+    /**
+     * @brief 解码后的报文
+     */
+    typedef struct
+    {
+        uint8_t type;           // 报文类型 (MQTT_CONNECT~MQTT_DISCONNECT)
+        uint8_t flags;          // 固定头低4位
+        uint16_t packet_id;     // 报文ID (无则为0)
+        uint8_t return_code;    // CONNACK返回码 / SUBACK首个返回码
+        bool session_present;   // CONNACK会话存在标志
+        const char *topic;      // PUBLISH主题 (不以'\0'结尾)
+        uint16_t topic_len;     // 主题长度
+        const uint8_t *payload; // 载荷 (PUBLISH载荷，或报文ID之后的报文体)
+        uint16_t payload_len;   // 载荷长度
+    } mqtt_codec_packet_t;
+
+    /**
+     * @brief 流式解析器
+     */
+    typedef struct
+    {
+        uint8_t *buffer;      // 报文体缓冲区
+        uint16_t size;        // 缓冲区大小
+        uint8_t state;        // 解析状态
+        uint8_t header;       // 固定头首字节
+        uint8_t length_bytes; // 已读剩余长度字节数
+        uint32_t remaining;   // 剩余长度
+        uint32_t received;    // 已收报文体长度
+        uint32_t dropped;     // 因超长跳过的报文数
+    } mqtt_parser_t;
+
+    // ============================================================================
+    // 编码
+    // ============================================================================
+
+    /**
+     * @brief 编码CONNECT (MQTT 3.1.1，无遗嘱)
+     * @param buffer 发送缓冲区
+     * @param size 缓冲区大小
+     * @param config 连接配置 (客户端ID、用户名/密码为空串时省略)
+     * @return 报文长度, 0: 缓冲区不足或参数无效
+     */
+    uint16_t mqtt_codec_connect(uint8_t *buffer, uint16_t size, const mqtt_config_t *config);
+
+    /**
+     * @brief 开始编码PUBLISH (写入主题与报文ID)
+     * @param frame 编码上下文
+     * @param buffer 发送缓冲区
+     * @param size 缓冲区大小
+     * @param topic 主题
+     * @param qos QoS等级 (0或1)
+     * @param retain 保留标志
+     * @param packet_id 报文ID (QoS1时非0)
+     * @return true: 成功, frame->payload/capacity给出载荷位置与可用长度
+     */
+    bool mqtt_codec_publish_begin(mqtt_publish_frame_t *frame, uint8_t *buffer, uint16_t size, const char *topic,
+                                  uint8_t qos, bool retain, uint16_t packet_id);
+
+    /**
+     * @brief 完成PUBLISH编码 (回填固定头)
+     * @param frame 编码上下文
+     * @param payload_len 已写入的载荷长度 (不超过frame->capacity)
+     * @param packet 输出报文起始位置 (位于buffer前MQTT_CODEC_PUBLISH_RESERVE字节内)
+     * @return 报文长度, 0: 载荷过长
+     */
+    uint16_t mqtt_codec_publish_end(mqtt_publish_frame_t *frame, uint16_t payload_len, uint8_t **packet);
+
+    /**
+     * @brief 编码SUBSCRIBE (单个主题过滤器)
+     * @return 报文长度, 0: 缓冲区不足或参数无效
+     */
+    uint16_t mqtt_codec_subscribe(uint8_t *buffer, uint16_t size, uint16_t packet_id, const char *topic, uint8_t qos);
+
+    /**
+     * @brief 编码UNSUBSCRIBE (单个主题过滤器)
+     * @return 报文长度, 0: 缓冲区不足或参数无效
+     */
+    uint16_t mqtt_codec_unsubscribe(uint8_t *buffer, uint16_t size, uint16_t packet_id, const char *topic);
+
+    /**
+     * @brief 编码只含报文ID的报文 (PUBACK/PUBREC/PUBCOMP/UNSUBACK等)
+     * @return 报文长度 (4), 0: 缓冲区不足
+     */
+    uint16_t mqtt_codec_ack(uint8_t *buffer, uint16_t size, uint8_t type, uint16_t packet_id);
+
+    /**
+     * @brief 编码无报文体的报文 (PINGREQ/PINGRESP/DISCONNECT)
+     * @return 报文长度 (2), 0: 缓冲区不足
+     */
+    uint16_t mqtt_codec_empty(uint8_t *buffer, uint16_t size, uint8_t type);
+
+    // ============================================================================
+    // 解析
+    // ============================================================================
+
+    /**
+     * @brief 初始化解析器
+     * @param parser 解析器
+     * @param buffer 报文体缓冲区 (决定可接收的最大报文)
+     * @param size 缓冲区大小
+     */
+    void mqtt_parser_init(mqtt_parser_t *parser, uint8_t *buffer, uint16_t size);
+
+    /**
+     * @brief 输入数据
+     * @param parser 解析器
+     * @param data 数据
+     * @param length 数据长度
+     * @param consumed 本次消耗的字节数 (返回MQTT_CODEC_PACKET时可能小于length，剩余数据须再次输入)
+     * @param packet 收齐时输出的报文
+     * @return MQTT_CODEC_PACKET: 收齐一个报文, MQTT_CODEC_NEED_MORE: 数据已全部消耗,
+     *         MQTT_ERROR_PROTOCOL: 报文格式错误 (解析器已复位，连接应断开)
+     */
+    int mqtt_parser_feed(mqtt_parser_t *parser, const uint8_t *data, uint16_t length, uint16_t *consumed,
+                         mqtt_codec_packet_t *packet);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __MQTT_CODEC_H__
@@ -0,0 +1,170 @@
+/**
+ * @file mqtt_queue.h
+ * @brief 憨云DTU MQTT QoS1离线发布队列 (存储转发) 接口
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 链路断开时mqtt_publish()直接失败，需要可靠送达的数据改经本队列发布:
+ * - 消息先进入RAM环 (变长条目)，RAM环放不下时最旧的条目溢出到Flash记录日志 (队列区)，
+ *   Flash中的消息总是早于RAM中的，排放时先Flash后RAM，积压保持原顺序
+ * - 在途窗口: 已发出未确认的QoS1消息最多window条，每条在窗口槽位中保留一份副本，
+ *   收到PUBACK释放，超时或重连后以DUP标志、原报文ID重发 (至少一次语义)
+ * - 分速排放: 重连后积压每个排放周期最多发出drain_burst条，且窗口中保留live_reserve个
+ *   槽位给实时消息；在线且窗口有空位时新消息直接发出，不排在积压之后
+ * - 打包溢出: 连续的多条消息打包成一条Flash记录 (不超过MQTT_QUEUE_FLASH_BATCH字节)，
+ *   分摊记录头，同样大小的溢出区可保留更多消息
+ * - 持久化: Flash中的消息按顺序取出，每确认MQTT_QUEUE_COMMIT_EVERY条或积压排空时写入提交记录
+ *   (首条未确认消息的位置)，重启后从提交点继续排放；提交前掉电的消息会重发一次
+ * - Flash写满时记录日志回收最旧扇区，被回收的积压计入dropped
+ * 主题按编号登记 (Flash记录只存1字节主题编号)，重启后须按相同顺序重新登记
+ * RAM环与窗口中的消息掉电丢失，掉电预警时调用mqtt_queue_flush()把RAM环转存到Flash
+ *
+ * 使用: MQTT事件回调中转发给mqtt_queue_on_event()，主循环中mqtt_task()之后调用mqtt_queue_task()
+ * Flash记录格式: 消息 ([载荷长度 1B][主题编号 1B][载荷])...，
+ *               提交 [首条未确认消息所在记录序号 4B][记录内消息序号 2B][保留 2B] (小端)
+ */
+
+#ifndef __MQTT_QUEUE_H__
+#define __MQTT_QUEUE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "mqtt.h"
+#include "storage.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#ifndef MQTT_QUEUE_RAM_SIZE
+#define MQTT_QUEUE_RAM_SIZE 512 // RAM环字节数 (2的幂)
+#endif
+
+#ifndef MQTT_QUEUE_MAX_PAYLOAD
+#define MQTT_QUEUE_MAX_PAYLOAD 128 // 单条消息最大载荷 (窗口槽位大小)
+#endif
+
+#ifndef MQTT_QUEUE_WINDOW
+#define MQTT_QUEUE_WINDOW 4 // 在途窗口槽位数 (运行时窗口不超过此值)
+#endif
+
+#ifndef MQTT_QUEUE_FLASH_ADDR
+#define MQTT_QUEUE_FLASH_ADDR STORAGE_QUEUE_ADDR // Flash溢出区起始地址
+#endif
+
+#ifndef MQTT_QUEUE_FLASH_SIZE
+#define MQTT_QUEUE_FLASH_SIZE STORAGE_REGION_SIZE // Flash溢出区大小
+#endif
+
+#define MQTT_QUEUE_MAX_TOPICS 8         // 最大主题数
+#define MQTT_QUEUE_COMMIT_EVERY 16      // 每确认多少条Flash消息写一次提交记录
+#define MQTT_QUEUE_FLASH_BATCH 224      // 每条Flash记录打包的消息字节数上限 (512B扇区恰好容纳两条记录)
+#define MQTT_QUEUE_TYPE_MESSAGE 0x10    // Flash记录类型: 消息
+#define MQTT_QUEUE_TYPE_COMMIT 0x11     // Flash记录类型: 提交点
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief 队列配置
+     */
+    typedef struct
+    {
+        uint8_t window;             // 在途窗口 (1~MQTT_QUEUE_WINDOW)
+        uint8_t live_reserve;       // 积压排放不占用的槽位数 (小于window)
+        uint8_t drain_burst;        // 每个排放周期最多发出的积压消息数
+        uint16_t drain_interval_ms; // 排放周期 (ms)
+        uint32_t retry_ms;          // PUBACK超时重发间隔 (ms)
+    } mqtt_queue_config_t;
+
+    /**
+     * @brief 队列统计
+     */
+    typedef struct
+    {
+        uint32_t enqueued;      // 提交的消息数
+        uint32_t sent_live;     // 未排队直接发出的消息数
+        uint32_t drained;       // 从积压中发出的消息数
+        uint32_t acked;         // 收到PUBACK的消息数
+        uint32_t retransmits;   // DUP重发次数
+        uint32_t spilled;       // RAM溢出到Flash的消息数
+        uint32_t dropped;       // 丢弃的消息数 (Flash回收/不可用)
+        uint32_t commits;       // 写入的提交记录数
+        uint16_t ram_messages;  // RAM环中的消息数
+        uint16_t ram_used;      // RAM环已用字节数
+        uint16_t ram_peak;      // RAM环已用字节峰值
+        uint16_t ram_footprint; // 队列占用RAM (控制块+RAM环+窗口)
+        uint32_t flash_pending; // Flash中待发出的消息数
+        uint32_t flash_used;    // Flash溢出区已用字节数 (含已确认待回收的记录)
+        uint8_t in_flight;      // 在途消息数
+    } mqtt_queue_stats_t;
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief 初始化队列 (清空RAM环与窗口，挂载Flash溢出区并恢复提交点之后的积压)
+     * @param config 队列配置 (NULL使用默认值)
+     * @return true: 成功, false: 配置无效 (Flash挂载失败时仍返回true，只使用RAM环)
+     */
+    bool mqtt_queue_init(const mqtt_queue_config_t *config);
+
+    /**
+     * @brief 登记主题
+     * @param topic 主题 (须长期有效，队列只保存指针)
+     * @return >=0:主题编号, <0:失败
+     */
+    int mqtt_queue_add_topic(const char *topic);
+
+    /**
+     * @brief 以QoS1发布消息 (在线且窗口有空位时直接发出，否则进入积压)
+     * @param topic 主题编号
+     * @param payload 载荷
+     * @param length 载荷长度 (1~MQTT_QUEUE_MAX_PAYLOAD)
+     * @return true: 已发出或已入队, false: 参数无效
+     */
+    bool mqtt_queue_publish(uint8_t topic, const void *payload, uint8_t length);
+
+    /**
+     * @brief MQTT事件处理 (由应用的MQTT事件回调转发)
+     * @param event MQTT事件
+     * @note 使用MQTT_EVENT_CONNECTED (窗口内消息标记重发) 与MQTT_EVENT_MESSAGE_SENT (释放槽位)
+     */
+    void mqtt_queue_on_event(const mqtt_event_t *event);
+
+    /**
+     * @brief 后台任务: 超时重发，按排放节奏发出积压
+     */
+    void mqtt_queue_task(void);
+
+    /**
+     * @brief 把RAM环中的全部消息转存到Flash (掉电预警时调用)
+     * @return true: 成功, false: Flash不可用
+     */
+    bool mqtt_queue_flush(void);
+
+    /**
+     * @brief 获取待发出与在途的消息总数
+     * @return 消息数
+     */
+    uint32_t mqtt_queue_pending(void);
+
+    /**
+     * @brief 获取队列统计
+     * @param stats 统计信息
+     * @return true: 成功
+     */
+    bool mqtt_queue_get_stats(mqtt_queue_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __MQTT_QUEUE_H__
@@ -0,0 +1,82 @@
+/**
+ * @file poll_window.h
+ * @brief 憨云DTU总线轮询空闲窗口预测接口
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 上位机 (Modbus主站) 通常按固定周期轮询。从站记录请求到达时刻并估计轮询周期，
+ * 据此判断一段阻塞操作 (如Flash页擦除) 能否在下一个请求到达前完成:
+ * - 周期估计: 更短的间隔立即采用，更长的间隔缓慢跟随 (偏保守)
+ * - 上电后先观察主站轮询，未学到周期时只在总线静默POLL_WINDOW_LEARN_MS后视为空闲
+ * - 主站长时间无请求 (超过两个周期) 时视为总线空闲
+ */
+
+#ifndef __POLL_WINDOW_H__
+#define __POLL_WINDOW_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#define POLL_WINDOW_MARGIN_MS 5     // 预测余量 (主站轮询抖动与请求处理时间)
+#define POLL_WINDOW_MIN_SAMPLES 2   // 采用周期估计前至少统计的请求间隔数
+#define POLL_WINDOW_FOLLOW_SHIFT 3  // 间隔变长时每次跟随差值的1/2^n
+#define POLL_WINDOW_LEARN_MS 1000   // 未学到周期时视为空闲所需的静默时间 (ms)
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief 轮询窗口状态
+     */
+    typedef struct
+    {
+        uint32_t last_request; // 最近一次请求到达时刻 (未收到请求时为初始化时刻，ms)
+        uint32_t interval;     // 估计的轮询周期 (ms)
+        uint8_t samples;       // 已统计的请求间隔数 (饱和计数)
+        bool seen;             // 已收到过请求
+    } poll_window_t;
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief 初始化
+     * @param window 窗口状态
+     * @param now 当前时刻 (ms)
+     */
+    void poll_window_init(poll_window_t *window, uint32_t now);
+
+    /**
+     * @brief 记录一次请求到达
+     * @param window 窗口状态
+     * @param now 当前时刻 (ms)
+     */
+    void poll_window_request(poll_window_t *window, uint32_t now);
+
+    /**
+     * @brief 判断[now, now + duration_ms)内是否预计没有请求到达
+     * @param window 窗口状态
+     * @param now 当前时刻 (ms)
+     * @param duration_ms 阻塞时长 (ms)
+     * @return true: 可以阻塞, false: 请等待下一个空闲窗口
+     * @note 未学到周期时距上次请求超过POLL_WINDOW_LEARN_MS、学到周期后距上次请求
+     *       超过两个周期 (主站停止轮询) 时返回true
+     */
+    bool poll_window_idle(const poll_window_t *window, uint32_t now, uint32_t duration_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __POLL_WINDOW_H__
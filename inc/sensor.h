@@ -13,6 +13,10 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "fixed_point.h"
+#include "filter.h"
+#include "sensor_lut.h"
+#include "stream_stats.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -26,6 +30,8 @@ extern "C"
 #define SENSOR_MAX_CHANNELS 8       // 最大传感器通道数
 #define SENSOR_FILTER_SIZE 8        // 滤波缓冲区大小
 #define SENSOR_INVALID_VALUE 0xFFFF // 无效数据值
+#define SENSOR_SCAN_USE_PDMA true   // 扫描帧由PDMA搬运
+#define SENSOR_FRAME_QUEUE_SIZE 4   // 采样帧队列深度 (2的幂)
 
 // ADC通道定义
 #define SENSOR_TEMP_CHANNEL 0     // 温度传感器通道
@@ -73,18 +79,28 @@ extern "C"
 
     /**
      * @brief 传感器配置结构体
+     * @note 浮点字段仅作为配置输入，sensor_config()时预先换算为定点数，
+     *       采样路径不再进行浮点运算
+     *       非线性传感器 (NTC等) 通过lut_id选择构建时生成的查找表
      */
     typedef struct
     {
-        uint8_t channel;        // ADC通道号
-        sensor_type_t type;     // 传感器类型
-        bool enabled;           // 使能状态
-        uint16_t sample_period; // 采样周期 (ms)
-        float scale_factor;     // 比例因子
-        float offset;           // 偏移量
-        float min_value;        // 最小值
-        float max_value;        // 最大值
-        uint8_t filter_size;    // 滤波器大小
+        uint8_t channel;           // ADC通道号
+        sensor_type_t type;        // 传感器类型
+        bool enabled;              // 使能状态
+        uint16_t sample_period;    // 采样周期 (ms)
+        float scale_factor;        // 比例因子 (-128 ~ 128，不含端点)
+        float offset;              // 偏移量
+        float min_value;           // 最小值
+        float max_value;           // 最大值
+        uint8_t filter_size;       // 滤波器大小 (滑动平均/中值窗口)
+        filter_type_t filter_type; // 滤波器类型 (默认滑动平均)
+        uint16_t filter_param;     // 滤波器参数 (IIR移位/卡尔曼R/Q比值，0为默认)
+        uint8_t oversample_bits;   // 过采样扩展位数n (0~4，累加4^n次，输出12+n位)
+        float deadband_abs;        // 绝对死区 (物理量单位，0为不启用)
+        float deadband_rel;        // 相对死区 (相对上次上报值的比例，如0.02为2%，0为不启用)
+        uint32_t max_silence_ms;   // 最长静默时间，超时强制上报 (0为不启用)
+        uint8_t lut_id;            // 线性化查找表 (sensor_lut_id_t，非NONE时忽略scale_factor，offset作零点修正)
     } sensor_config_t;
 
     /**
@@ -92,14 +108,44 @@ extern "C"
      */
     typedef struct
     {
-        uint16_t raw_value;     // 原始ADC值
-        float physical_value;   // 物理量值
+        uint16_t raw_value;     // 原始ADC值 (滤波后，12+oversample_bits位)
+        q16_t value_q16;        // 物理量值 (Q16.16，采样路径使用)
+        float physical_value;   // 物理量值 (仅在sensor_get_data()时由value_q16换算)
         sensor_status_t status; // 传感器状态
         uint32_t timestamp;     // 时间戳
         uint16_t sample_count;  // 采样计数
         bool data_valid;        // 数据有效标志
     } sensor_data_t;
 
+    /**
+     * @brief 显著变化原因枚举
+     */
+    typedef enum
+    {
+        SENSOR_CHANGE_FIRST = 0,    // 首个有效数据
+        SENSOR_CHANGE_DEADBAND = 1, // 变化超出死区
+        SENSOR_CHANGE_STATUS = 2,   // 传感器状态变化
+        SENSOR_CHANGE_SILENCE = 3   // 超过最长静默时间
+    } sensor_change_reason_t;
+
+    /**
+     * @brief 显著变化事件结构体
+     */
+    typedef struct
+    {
+        uint8_t channel;               // 传感器通道号
+        sensor_change_reason_t reason; // 触发原因
+        q16_t value_q16;               // 当前值 (Q16.16)
+        q16_t previous_q16;            // 上次上报值 (Q16.16)
+        sensor_status_t status;        // 当前状态
+        uint32_t timestamp;            // 时间戳
+    } sensor_change_event_t;
+
+    /**
+     * @brief 显著变化回调函数类型 (在sensor_task上下文中调用)
+     */
+    typedef void (*sensor_change_callback_t)(const sensor_change_event_t *event);
+
     /**
      * @brief 传感器统计信息结构体
      */
@@ -110,11 +156,23 @@ extern "C"
         uint32_t error_count;     // 错误次数
         uint32_t overflow_count;  // 溢出次数
         uint32_t underflow_count; // 欠量程次数
+        uint32_t change_count;    // 显著变化事件次数
         float min_value;          // 最小值
         float max_value;          // 最大值
         float average_value;      // 平均值
     } sensor_stats_t;
 
+    /**
+     * @brief 采样抖动统计结构体 (实际采样间隔相对配置周期的偏差)
+     */
+    typedef struct
+    {
+        uint32_t intervals;             // 统计的采样间隔数
+        int32_t min_deviation_us;       // 最小偏差 (us)
+        int32_t max_deviation_us;       // 最大偏差 (us)
+        uint32_t mean_abs_deviation_us; // 平均绝对偏差 (us)
+    } sensor_jitter_t;
+
     // ============================================================================
     // 函数声明
     // ============================================================================
@@ -134,7 +192,7 @@ extern "C"
      * @brief 传感器配置
      * @param channel 传感器通道号 (0-7)
      * @param config 配置参数
-     * @return true: 成功, false: 失败
+     * @return true: 成功, false: 失败 (含未使用查找表时|scale_factor| >= 128)
      */
     bool sensor_config(uint8_t channel, const sensor_config_t *config);
 
@@ -177,6 +235,14 @@ extern "C"
      */
     float sensor_read_value(uint8_t channel);
 
+    /**
+     * @brief 读取传感器物理量值 (定点数，无浮点运算)
+     * @param channel 传感器通道号 (0-7)
+     * @param value 输出物理量值指针 (Q16.16)
+     * @return true: 成功, false: 失败或数据无效
+     */
+    bool sensor_read_value_q16(uint8_t channel, q16_t *value);
+
     /**
      * @brief 读取温度值
      * @param channel 温度传感器通道号
@@ -242,6 +308,30 @@ extern "C"
      */
     bool sensor_clear_stats(uint8_t channel);
 
+    /**
+     * @brief 获取采样抖动统计 (随sensor_clear_stats清除)
+     * @param channel 传感器通道号 (0-7)
+     * @param jitter 输出抖动统计结构体指针
+     * @return true: 成功, false: 失败
+     */
+    bool sensor_get_jitter(uint8_t channel, sensor_jitter_t *jitter);
+
+    /**
+     * @brief 获取上报窗口统计摘要 (均值/方差/p50/p95/p99，随sensor_clear_stats清除)
+     * @param channel 传感器通道号 (0-7)
+     * @param summary 输出统计摘要
+     * @param reset_window true: 读取后开始新的统计窗口
+     * @return true: 成功, false: 失败
+     */
+    bool sensor_get_window_stats(uint8_t channel, stream_stats_summary_t *summary, bool reset_window);
+
+    /**
+     * @brief 设置显著变化回调 (报警、历史、MQTT、LoRa等下游只处理变化事件)
+     * @param callback 回调函数，NULL为取消
+     * @return true: 成功, false: 失败
+     */
+    bool sensor_set_change_callback(sensor_change_callback_t callback);
+
     /**
      * @brief 设置传感器报警阈值
      * @param channel 传感器通道号 (0-7)
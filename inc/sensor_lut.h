@@ -0,0 +1,80 @@
+/**
+ * @file sensor_lut.h
+ * @brief 憨云DTU传感器非线性线性化查找表接口
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 查找表由 scripts/gen_sensor_lut.py 根据传感器描述文件在构建时生成，
+ * 以const数组存放在Flash中，运行时仅使用整数运算:
+ * - 直接索引表: 码值等间隔 2^shift 取点 (Steinhart-Hart NTC)，raw >> shift 定位
+ * - 断点表: 非等间隔断点 + 每段预计算斜率 (数据手册曲线)，二分查找定位
+ */
+
+#ifndef __SENSOR_LUT_H__
+#define __SENSOR_LUT_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed_point.h"
+#include "sensor_lut_table.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief 查找方式枚举
+     */
+    typedef enum
+    {
+        SENSOR_LUT_KIND_DIRECT = 0, // 等间隔直接索引
+        SENSOR_LUT_KIND_BINARY = 1  // 断点二分查找
+    } sensor_lut_kind_t;
+
+    /**
+     * @brief 查找表描述 (const，存放在Flash)
+     * @note 码值均按12位定义，过采样输入在查找时按扩展位数对齐
+     */
+    typedef struct
+    {
+        uint8_t kind;          // 查找方式 (sensor_lut_kind_t)
+        uint8_t shift;         // 直接索引表码值间隔 2^shift
+        uint16_t count;        // 表项数
+        const uint16_t *codes; // 断点码值 (升序，直接索引表为NULL)
+        const q16_t *values;   // 表项物理量 (Q16.16)
+        const int32_t *slopes; // 每段斜率 (Q16.16/码，直接索引表为NULL)
+    } sensor_lut_t;
+
+    // 生成的查找表 (按sensor_lut_id_t - 1索引)
+    extern const sensor_lut_t g_sensor_lut_tables[SENSOR_LUT_COUNT - 1];
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief 按编号获取查找表
+     * @param id 查找表编号
+     * @return 查找表指针，SENSOR_LUT_NONE或无效编号返回NULL
+     */
+    const sensor_lut_t *sensor_lut_get(uint8_t id);
+
+    /**
+     * @brief 查表并线性插值
+     * @param lut 查找表
+     * @param raw 原始码值 (12 + extra_bits 位)
+     * @param extra_bits 过采样扩展位数 (0~4)
+     * @return 物理量 (Q16.16)，超出表范围时取端点值
+     */
+    q16_t sensor_lut_lookup(const sensor_lut_t *lut, uint32_t raw, uint8_t extra_bits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SENSOR_LUT_H__
@@ -0,0 +1,50 @@
+/**
+ * @file sensor_lut_table.h
+ * @brief 憨云DTU传感器线性化查找表编号 (自动生成)
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+// 由 scripts/gen_sensor_lut.py 根据 scripts/sensor_lut.json 生成，请勿手工修改
+
+#ifndef __SENSOR_LUT_TABLE_H__
+#define __SENSOR_LUT_TABLE_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define SENSOR_LUT_ADC_FULL_SCALE 4096 // 表中码值满量程 (2^12)
+
+    /**
+     * @brief 查找表编号 (SENSOR_LUT_NONE 表示使用 raw*scale+offset)
+     */
+    typedef enum
+    {
+        SENSOR_LUT_NONE = 0,
+        SENSOR_LUT_NTC_10K_3950 = 1,     // NTC 10K B3950, 10K上拉至VREF, Steinhart-Hart, 直接索引
+        SENSOR_LUT_NTC_10K_3950_PWL = 2, // NTC 10K B3950, 10K上拉至VREF, Steinhart-Hart按5°C取断点, 二分查找
+        SENSOR_LUT_HUMIDITY_PROBE = 3,   // 电压输出湿度探头数据手册曲线 (mV -> %RH), 二分查找
+        SENSOR_LUT_COUNT
+    } sensor_lut_id_t;
+
+// Steinhart-Hart 浮点参考参数 (仅供主机端精度验证，固件不使用)
+#define SENSOR_LUT_NTC_10K_3950_SH_A 1.021554311202e-03
+#define SENSOR_LUT_NTC_10K_3950_SH_B 2.532773665340e-04
+#define SENSOR_LUT_NTC_10K_3950_SH_C -3.950137826378e-10
+#define SENSOR_LUT_NTC_10K_3950_PULLUP_OHM 10000
+#define SENSOR_LUT_NTC_10K_3950_T_MIN -40
+#define SENSOR_LUT_NTC_10K_3950_T_MAX 125
+#define SENSOR_LUT_NTC_10K_3950_PWL_SH_A 1.021554311202e-03
+#define SENSOR_LUT_NTC_10K_3950_PWL_SH_B 2.532773665340e-04
+#define SENSOR_LUT_NTC_10K_3950_PWL_SH_C -3.950137826378e-10
+#define SENSOR_LUT_NTC_10K_3950_PWL_PULLUP_OHM 10000
+#define SENSOR_LUT_NTC_10K_3950_PWL_T_MIN -40
+#define SENSOR_LUT_NTC_10K_3950_PWL_T_MAX 125
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SENSOR_LUT_TABLE_H__
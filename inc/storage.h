@@ -13,6 +13,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "flash_log.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -29,11 +30,22 @@ extern "C"
 #define STORAGE_BACKUP_SIZE 512       // 备份区大小
 #define STORAGE_MAGIC_NUMBER 0x48434B // "HCK" 憨云标识
 
-// Flash分区定义 (内部Flash 64KB)
-#define STORAGE_CONFIG_ADDR 0x0000F000  // 配置区 (4KB)
-#define STORAGE_HISTORY_ADDR 0x0000E000 // 历史区 (4KB)
-#define STORAGE_BACKUP_ADDR 0x0000D000  // 备份区 (4KB)
-#define STORAGE_LOG_ADDR 0x0000C000     // 日志区 (4KB)
+// Flash分区定义 (内部Flash 64KB，0xB000以上为存储分区，链接脚本FLASH区域止于STORAGE_QUEUE_ADDR)
+#define STORAGE_CONFIG_ADDR 0x0000F000  // 配置区 (4KB，A/B双bank配置日志)
+#define STORAGE_HISTORY_ADDR 0x0000E000 // 历史区 (4KB，传感器记录日志)
+#define STORAGE_BACKUP_ADDR 0x0000D000  // 备份区 (4KB，首页为配置备份，后2KB为记录日志检查点)
+#define STORAGE_LOG_ADDR 0x0000C000     // 日志区 (4KB，报警/状态记录日志)
+#define STORAGE_QUEUE_ADDR 0x0000B000   // 队列区 (4KB，MQTT离线发布队列记录日志)
+#define STORAGE_REGION_SIZE 4096        // 分区大小
+#define STORAGE_SECTOR_SIZE 512         // 记录日志扇区大小 (Flash擦除页)
+#define STORAGE_BLOCK_SIZE 144          // 传感器压缩数据块大小 (每扇区3块)
+#define STORAGE_BLOCK_MAX_AGE 600000    // 未满数据块最长驻留RAM时间 (ms)
+#define STORAGE_CONFIG_BANK_SIZE 2048   // 配置bank大小 (配置区分为两个bank)
+#define STORAGE_JOB_QUEUE_SIZE 8        // 存储作业队列深度
+#define STORAGE_CHECKPOINT_ADDR 0x0000D800 // 记录日志检查点区 (历史区/日志区各2页)
+#define STORAGE_CHECKPOINT_PAGES 2      // 每个记录日志的检查点区页数
+#define STORAGE_ERASE_TIME_MS 20        // 后台维护 (一页擦除) 最长阻塞时间 (ms)
+#define STORAGE_JOB_TIME_MS 3           // 一个存储作业 (记录编程) 最长阻塞时间 (ms)
 
 // 数据类型定义
 #define STORAGE_TYPE_CONFIG 0x01 // 配置数据
@@ -41,6 +53,7 @@ extern "C"
 #define STORAGE_TYPE_ALARM 0x03  // 报警数据
 #define STORAGE_TYPE_STATUS 0x04 // 状态数据
 #define STORAGE_TYPE_LOG 0x05    // 日志数据
+#define STORAGE_TYPE_SENSOR_BLOCK 0x06 // 传感器压缩数据块 (历史区内部格式)
 
     // 存储状态
     typedef enum
@@ -95,8 +108,12 @@ extern "C"
         storage_header_t header; // 记录头部
         uint8_t alarm_type;      // 报警类型
         uint8_t alarm_level;     // 报警级别
-        uint16_t alarm_value;    // 报警值
+        int32_t alarm_value;     // 报警值 (与报警规则同单位，可为负)
         uint32_t alarm_duration; // 报警持续时间
+        uint8_t rule_id;         // 规则ID (0: 未关联规则)
+        uint8_t alarm_state;     // 状态变化 (alarm_state_t)
+        uint8_t message_id;      // 消息ID (ALARM_MSG_*)
+        uint8_t reserved;        // 保留字段
     } __attribute__((packed)) storage_alarm_record_t;
 
     /**
@@ -111,6 +128,30 @@ extern "C"
         uint8_t reserved[5];     // 保留字段
     } __attribute__((packed)) storage_status_record_t;
 
+    /**
+     * @brief 历史记录区间查询回调
+     * @param record 记录 (以记录头开始，按header.type转换为对应记录结构)
+     * @param context 调用者上下文
+     * @return true: 继续, false: 停止查询
+     */
+    typedef bool (*storage_history_visitor_t)(const storage_header_t *record, void *context);
+
+    /**
+     * @brief 存储作业完成回调
+     * @param type 作业数据类型 (STORAGE_TYPE_CONFIG等)
+     * @param success true: 已写入Flash, false: 写入失败
+     * @param context 调用者上下文
+     */
+    typedef void (*storage_job_callback_t)(uint8_t type, bool success, void *context);
+
+    /**
+     * @brief 总线空闲检查函数类型
+     * @param duration_ms 即将阻塞的时长 (ms)
+     * @param context 调用者上下文
+     * @return true: 可以阻塞, false: 推迟到下一次storage_task()
+     */
+    typedef bool (*storage_idle_check_t)(uint32_t duration_ms, void *context);
+
     /**
      * @brief 配置参数结构
      */
@@ -157,6 +198,8 @@ extern "C"
         uint32_t crc_errors;     // CRC错误次数
         uint32_t config_writes;  // 配置写入次数
         uint32_t history_writes; // 历史数据写入次数
+        uint32_t queued_jobs;    // 提交到作业队列的次数
+        uint32_t sync_jobs;      // 队列满时在调用者中同步执行的作业数
         uint32_t free_space;     // 剩余空间
     } storage_stats_t;
 
@@ -182,6 +225,32 @@ extern "C"
      */
     bool storage_format(bool format_all);
 
+    /**
+     * @brief 将RAM中未满的传感器数据块及全部排队作业写入Flash
+     * @return true: 成功, false: 失败
+     * @note 掉电告警、关机或复位前调用，避免丢失块中的采样
+     */
+    bool storage_flush(void);
+
+    /**
+     * @brief 存储后台任务 (主循环中周期调用)
+     * @note 每次调用最多执行一个排队作业或一页预擦除，单次阻塞不超过一次页擦除；
+     *       设置了空闲检查时只在总线空闲窗口内执行。排队作业与预擦除均完成后才空闲
+     */
+    void storage_task(void);
+
+    /**
+     * @brief 同步执行全部排队作业
+     * @return true: 全部成功, false: 有作业写入失败
+     */
+    bool storage_process_jobs(void);
+
+    /**
+     * @brief 获取排队中的作业数
+     * @return 作业数
+     */
+    uint8_t storage_get_pending_jobs(void);
+
     /**
      * @brief 获取存储状态
      * @return 存储状态
@@ -203,6 +272,7 @@ extern "C"
      * @brief 读取配置参数
      * @param config 配置结构体指针
      * @return true: 成功, false: 失败
+     * @note 有排队中的配置时返回该配置 (读己之写)
      */
     bool storage_read_config(storage_config_t *config);
 
@@ -210,9 +280,23 @@ extern "C"
      * @brief 写入配置参数
      * @param config 配置结构体指针
      * @return true: 成功, false: 失败
+     * @note 小改动追加为差分记录不擦除；写入过程中掉电时保留上一次提交的配置
+     * @note 在调用者中同步写入 (可能擦除)，取代排队中尚未写入的配置
      */
     bool storage_write_config(const storage_config_t *config);
 
+    /**
+     * @brief 提交配置参数，由storage_task()在后台写入
+     * @param config 配置结构体指针
+     * @param callback 写入完成回调 (可为NULL)
+     * @param context 回调上下文
+     * @return true: 已提交, false: 参数无效或未初始化
+     * @note 多次提交合并为一次写入最新配置，每次提交的回调都会被调用；
+     *       返回后storage_read_config()即读到新配置
+     */
+    bool storage_write_config_async(const storage_config_t *config, storage_job_callback_t callback,
+                                    void *context);
+
     /**
      * @brief 恢复默认配置
      * @return true: 成功, false: 失败
@@ -253,9 +337,29 @@ extern "C"
      * @param alarm_value 报警值
      * @param alarm_duration 报警持续时间
      * @return true: 成功, false: 失败
+     * @note 记录排队后由storage_task()写入，读取/查询接口包含排队中的记录
      */
     bool storage_write_alarm_history(uint8_t alarm_type, uint8_t alarm_level,
-                                     uint16_t alarm_value, uint32_t alarm_duration);
+                                     int32_t alarm_value, uint32_t alarm_duration);
+
+    /**
+     * @brief 写入报警事件 (保留事件发生时刻，用于报警历史环转存)
+     * @param record 报警记录 (调用者填写数据部分，头部由本函数填写)
+     * @param timestamp 事件时间戳 (与storage_get_timestamp()同一时基)
+     * @return true: 成功, false: 失败 (作业队列满时可稍后重试)
+     */
+    bool storage_write_alarm_event(storage_alarm_record_t *record, uint32_t timestamp);
+
+    /**
+     * @brief 写入报警事件，写入Flash后调用回调
+     * @param record 报警记录 (调用者填写数据部分，头部由本函数填写)
+     * @param timestamp 事件时间戳 (与storage_get_timestamp()同一时基)
+     * @param callback 写入完成回调 (可为NULL)
+     * @param context 回调上下文
+     * @return true: 已提交, false: 未初始化或参数无效
+     */
+    bool storage_write_alarm_event_async(storage_alarm_record_t *record, uint32_t timestamp,
+                                         storage_job_callback_t callback, void *context);
 
     /**
      * @brief 写入系统状态历史
@@ -263,9 +367,40 @@ extern "C"
      * @param reboot_count 重启次数
      * @param error_code 错误代码
      * @return true: 成功, false: 失败
+     * @note 记录排队后由storage_task()写入，读取/查询接口包含排队中的记录
      */
     bool storage_write_status_history(uint32_t uptime, uint16_t reboot_count, uint8_t error_code);
 
+    /**
+     * @brief 写入系统状态历史，写入Flash后调用回调
+     * @param uptime 运行时间
+     * @param reboot_count 重启次数
+     * @param error_code 错误代码
+     * @param callback 写入完成回调 (可为NULL)
+     * @param context 回调上下文
+     * @return true: 已提交, false: 未初始化
+     */
+    bool storage_write_status_history_async(uint32_t uptime, uint16_t reboot_count, uint8_t error_code,
+                                            storage_job_callback_t callback, void *context);
+
+    /**
+     * @brief 设置传感器数据块写入完成回调
+     * @param callback 回调 (type为STORAGE_TYPE_SENSOR_BLOCK，可为NULL)
+     * @param context 回调上下文
+     * @note 采样先编码进RAM中的数据块，块封闭并写入Flash后才回调；
+     *       回调成功表示该块及之前的全部采样已持久化。storage_init()清除回调
+     */
+    void storage_set_block_callback(storage_job_callback_t callback, void *context);
+
+    /**
+     * @brief 设置总线空闲检查
+     * @param check 检查函数 (NULL: 随时执行后台作业)
+     * @param context 检查函数上下文
+     * @note storage_task()只在检查通过时写入排队作业或执行预擦除，避免阻塞期间
+     *       主站请求得不到响应。由通信模块设置，storage_init()不清除
+     */
+    void storage_set_idle_check(storage_idle_check_t check, void *context);
+
     /**
      * @brief 读取最新的传感器历史数据
      * @param records 记录数组指针
@@ -304,13 +439,40 @@ extern "C"
      */
     uint16_t storage_get_history_count(uint8_t type);
 
+    /**
+     * @brief 按时间区间查询历史数据 (从旧到新回调)
+     * @param type 数据类型
+     * @param start_time 起始时间戳 (含)
+     * @param end_time 结束时间戳 (含)
+     * @param visitor 回调函数
+     * @param context 回调上下文
+     * @return 回调的记录数
+     */
+    uint16_t storage_query_history(uint8_t type, uint32_t start_time, uint32_t end_time,
+                                   storage_history_visitor_t visitor, void *context);
+
+    /**
+     * @brief 获取历史数据所在的记录日志 (供批量导出直接按Flash格式顺序读取)
+     * @param type 数据类型 (STORAGE_TYPE_SENSOR/ALARM/STATUS)
+     * @param log_type 输出日志中的记录类型 (传感器数据为STORAGE_TYPE_SENSOR_BLOCK压缩数据块)
+     * @return 记录日志，未初始化或类型无效时返回NULL
+     * @note 先调用storage_flush()写入RAM中的数据块与排队记录，导出内容与查询结果一致
+     */
+    flash_log_t *storage_get_export_log(uint8_t type, uint8_t *log_type);
+
+    /**
+     * @brief 获取当前记录时间戳 (ms，跨重启单调递增)
+     * @return 时间戳
+     */
+    uint32_t storage_get_timestamp(void);
+
     // ============================================================================
     // Flash底层操作接口
     // ============================================================================
 
     /**
-     * @brief 擦除Flash扇区
-     * @param address 地址
+     * @brief 擦除Flash分区 (STORAGE_REGION_SIZE字节)
+     * @param address 分区起始地址
      * @return true: 成功, false: 失败
      */
     bool storage_flash_erase_sector(uint32_t address);
@@ -354,6 +516,15 @@ extern "C"
      */
     uint16_t storage_calculate_crc16(const uint8_t *data, uint16_t length);
 
+    /**
+     * @brief 增量计算CRC16 (分段数据，初值0xFFFF)
+     * @param crc 上一段的CRC值
+     * @param data 数据指针
+     * @param length 数据长度
+     * @return CRC16值
+     */
+    uint16_t storage_crc16_update(uint16_t crc, const uint8_t *data, uint16_t length);
+
     /**
      * @brief 检查数据完整性
      * @param header 记录头部指针
@@ -0,0 +1,93 @@
+/**
+ * @file stream_stats.h
+ * @brief 憨云DTU流式统计接口
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 固定内存的逐样本统计，按上报窗口复位，上行只发送统计摘要:
+ * - 计数/最值/均值/方差: Welford算法 (数值稳定，无需保存样本)
+ * - p50/p95/p99: P²算法 (Jain & Chlamtac)，三个分位数共用9个标记点
+ * 全部为Q16.16定点运算，无浮点
+ */
+
+#ifndef __STREAM_STATS_H__
+#define __STREAM_STATS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed_point.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#define STREAM_STATS_MARKERS 9 // P²标记点数 (2*3个分位数 + 3)
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief 流式统计状态
+     */
+    typedef struct
+    {
+        uint32_t count;                           // 样本数
+        q16_t min;                                // 最小值
+        q16_t max;                                // 最大值
+        q16_t mean;                               // 均值 (Welford)
+        int64_t m2;                               // 离差平方和 (Q16.16)
+        q16_t heights[STREAM_STATS_MARKERS];      // P²标记点高度 (前9个样本时为有序样本)
+        uint32_t positions[STREAM_STATS_MARKERS]; // P²标记点实际位置 (1起)
+    } stream_stats_t;
+
+    /**
+     * @brief 窗口统计摘要 (上行用)
+     */
+    typedef struct
+    {
+        uint32_t count;   // 样本数
+        q16_t min;        // 最小值
+        q16_t max;        // 最大值
+        q16_t mean;       // 均值
+        q16_t variance;   // 样本方差 (n-1)
+        q16_t stddev;     // 标准差
+        q16_t p50;        // 中位数估计
+        q16_t p95;        // 95分位估计
+        q16_t p99;        // 99分位估计
+    } stream_stats_summary_t;
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief 复位统计 (开始新的上报窗口)
+     * @param stats 统计状态
+     */
+    void stream_stats_reset(stream_stats_t *stats);
+
+    /**
+     * @brief 加入一个样本
+     * @param stats 统计状态
+     * @param value 样本值 (Q16.16)
+     */
+    void stream_stats_update(stream_stats_t *stats, q16_t value);
+
+    /**
+     * @brief 获取统计摘要
+     * @param stats 统计状态
+     * @param summary 输出摘要 (无样本时全部为0)
+     */
+    void stream_stats_get_summary(const stream_stats_t *stats, stream_stats_summary_t *summary);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __STREAM_STATS_H__
@@ -0,0 +1,250 @@
+/**
+ * @file telemetry_codec.h
+ * @brief 憨云DTU紧凑二进制遥测载荷编解码接口
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * JSON载荷 (snprintf + %.1f/%.2f) 的二进制替代，按模式 (schema) 打包:
+ * - 模式定义字段顺序、类型 (有符号/无符号) 与小数位数，物理量按小数位数放大为整数
+ *   (与JSON的%.1f/%.2f精度相同)，编码全程只有整数运算
+ * - 每个字段是变长整数 (有符号字段先zigzag)，存在位图标明出现的字段，缺省字段不占字节
+ * - 编码经写入器直接写到调用者缓冲区 (可为mqtt_publish_begin()返回的发送缓冲区)
+ * - 解码器为主机侧 (云端桥接/测试) 与设备共用的C实现，按模式表还原字段
+ *
+ * 载荷布局: [模式ID 1B][模式版本 1B][存在位图 变长][字段值 变长]...
+ * 版本规则: 模式只在末尾追加字段并递增版本，删改字段须使用新的模式ID。
+ * 解码器遇到更高版本时解出已知字段并跳过其后的未知字段 (变长整数自带边界)，
+ * 遇到更低版本时其未定义的字段视为缺省
+ */
+
+#ifndef __TELEMETRY_CODEC_H__
+#define __TELEMETRY_CODEC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#define TELEMETRY_MAX_FIELDS 16     // 单个模式最大字段数 (解码时可跳过的未知字段不受此限)
+#define TELEMETRY_VARINT_MAX 5      // 32位变长整数最大长度
+#define TELEMETRY_HEADER_MAX (2 + TELEMETRY_VARINT_MAX) // 载荷头最大长度
+
+// 模式ID
+#define TELEMETRY_SCHEMA_SENSOR 0x01 // 传感器采样
+#define TELEMETRY_SCHEMA_STATUS 0x02 // 设备状态
+
+// 当前模式版本
+#define TELEMETRY_SENSOR_VERSION 1
+#define TELEMETRY_STATUS_VERSION 1
+
+// 传感器采样字段 (存在位图位序)
+#define TELEMETRY_SENSOR_TEMPERATURE 0 // 温度 (0.1°C)
+#define TELEMETRY_SENSOR_HUMIDITY 1    // 湿度 (0.1%RH)
+#define TELEMETRY_SENSOR_VOLTAGE 2     // 电压 (0.01V)
+#define TELEMETRY_SENSOR_CURRENT 3     // 电流 (0.01A)
+#define TELEMETRY_SENSOR_POWER 4       // 功率 (0.01W)
+#define TELEMETRY_SENSOR_TIMESTAMP 5   // 时间戳 (ms)
+#define TELEMETRY_SENSOR_ALL 0x3F
+
+// 设备状态字段
+#define TELEMETRY_STATUS_FLAGS 0       // 状态位 (TELEMETRY_FLAG_*)
+#define TELEMETRY_STATUS_UPTIME 1      // 运行时间
+#define TELEMETRY_STATUS_FREE_MEMORY 2 // 空闲内存 (字节)
+#define TELEMETRY_STATUS_ALL 0x07
+
+// 设备状态位
+#define TELEMETRY_FLAG_MODBUS_ONLINE 0x01
+#define TELEMETRY_FLAG_LORA_CONNECTED 0x02
+#define TELEMETRY_FLAG_STORAGE_NORMAL 0x04
+#define TELEMETRY_FLAG_ALARM_ACTIVE 0x08
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief 字段类型
+     */
+    typedef enum
+    {
+        TELEMETRY_FIELD_UINT = 0, // 无符号整数
+        TELEMETRY_FIELD_SINT      // 有符号整数 (zigzag)
+    } telemetry_field_type_t;
+
+    /**
+     * @brief 字段定义
+     */
+    typedef struct
+    {
+        const char *name; // 字段名 (与JSON键名一致)
+        uint8_t type;     // 字段类型 (telemetry_field_type_t)
+        uint8_t decimals; // 小数位数 (整数值 = 物理量 x 10^decimals)
+    } telemetry_field_t;
+
+    /**
+     * @brief 模式定义
+     */
+    typedef struct
+    {
+        uint8_t id;                      // 模式ID
+        uint8_t version;                 // 当前版本
+        uint8_t field_count;             // 字段数
+        const telemetry_field_t *fields; // 字段表 (按存在位图位序)
+    } telemetry_schema_t;
+
+    /**
+     * @brief 载荷写入器 (写到调用者缓冲区)
+     */
+    typedef struct
+    {
+        uint8_t *buffer;   // 输出缓冲区
+        uint16_t capacity; // 缓冲区大小
+        uint16_t length;   // 已写入字节数
+        bool overflow;     // 空间不足 (之后的写入被忽略)
+    } telemetry_writer_t;
+
+    /**
+     * @brief 传感器采样 (定点整数，单位见字段定义)
+     */
+    typedef struct
+    {
+        int32_t temperature; // 0.1°C
+        int32_t humidity;    // 0.1%RH
+        int32_t voltage;     // 0.01V
+        int32_t current;     // 0.01A
+        int32_t power;       // 0.01W
+        uint32_t timestamp;  // ms
+    } telemetry_sensor_t;
+
+    /**
+     * @brief 设备状态
+     */
+    typedef struct
+    {
+        uint8_t flags;        // 状态位 (TELEMETRY_FLAG_*)
+        uint32_t uptime;      // 运行时间
+        uint32_t free_memory; // 空闲内存 (字节)
+    } telemetry_status_t;
+
+    /**
+     * @brief 解码结果
+     */
+    typedef struct
+    {
+        const telemetry_schema_t *schema;     // 模式 (解码器已知)
+        uint8_t version;                      // 载荷中的模式版本
+        uint32_t mask;                        // 已解出的字段位图 (只含已知字段)
+        bool newer;                           // 载荷版本高于解码器 (跳过了未知字段)
+        int32_t values[TELEMETRY_MAX_FIELDS]; // 字段值 (无符号字段按位存放)
+    } telemetry_record_t;
+
+    // ============================================================================
+    // 全局变量
+    // ============================================================================
+
+    extern const telemetry_schema_t telemetry_schema_sensor;
+    extern const telemetry_schema_t telemetry_schema_status;
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief 初始化写入器
+     * @param writer 写入器
+     * @param buffer 输出缓冲区
+     * @param capacity 缓冲区大小
+     */
+    void telemetry_writer_init(telemetry_writer_t *writer, uint8_t *buffer, uint16_t capacity);
+
+    /**
+     * @brief 写入载荷头
+     * @param writer 写入器
+     * @param schema 模式
+     * @param mask 存在位图 (其后按位序写入各字段)
+     */
+    void telemetry_write_header(telemetry_writer_t *writer, const telemetry_schema_t *schema, uint32_t mask);
+
+    /**
+     * @brief 写入无符号字段值
+     * @param writer 写入器
+     * @param value 字段值
+     */
+    void telemetry_write_uint(telemetry_writer_t *writer, uint32_t value);
+
+    /**
+     * @brief 写入有符号字段值
+     * @param writer 写入器
+     * @param value 字段值
+     */
+    void telemetry_write_sint(telemetry_writer_t *writer, int32_t value);
+
+    /**
+     * @brief 完成写入
+     * @param writer 写入器
+     * @return 载荷长度, 0:空间不足
+     */
+    uint16_t telemetry_writer_finish(const telemetry_writer_t *writer);
+
+    /**
+     * @brief 编码传感器采样 (全部字段)
+     * @param buffer 输出缓冲区
+     * @param size 缓冲区大小
+     * @param sample 采样
+     * @return 载荷长度, 0:空间不足或参数无效
+     */
+    uint16_t telemetry_encode_sensor(uint8_t *buffer, uint16_t size, const telemetry_sensor_t *sample);
+
+    /**
+     * @brief 编码设备状态 (全部字段)
+     * @param buffer 输出缓冲区
+     * @param size 缓冲区大小
+     * @param status 设备状态
+     * @return 载荷长度, 0:空间不足或参数无效
+     */
+    uint16_t telemetry_encode_status(uint8_t *buffer, uint16_t size, const telemetry_status_t *status);
+
+    /**
+     * @brief 按模式ID查找模式
+     * @param id 模式ID
+     * @return 模式, NULL:未知
+     */
+    const telemetry_schema_t *telemetry_find_schema(uint8_t id);
+
+    /**
+     * @brief 解码载荷
+     * @param data 载荷
+     * @param length 载荷长度
+     * @param record 输出解码结果
+     * @return 消耗的字节数, 0:未知模式或格式错误
+     */
+    uint16_t telemetry_decode(const uint8_t *data, uint16_t length, telemetry_record_t *record);
+
+    /**
+     * @brief 从解码结果取出传感器采样 (缺省字段为0)
+     * @param record 解码结果
+     * @param sample 输出采样
+     * @return true: 成功, false: 不是传感器采样
+     */
+    bool telemetry_get_sensor(const telemetry_record_t *record, telemetry_sensor_t *sample);
+
+    /**
+     * @brief 从解码结果取出设备状态 (缺省字段为0)
+     * @param record 解码结果
+     * @param status 输出设备状态
+     * @return true: 成功, false: 不是设备状态
+     */
+    bool telemetry_get_status(const telemetry_record_t *record, telemetry_status_t *status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TELEMETRY_CODEC_H__
@@ -0,0 +1,142 @@
+/**
+ * @file trend.h
+ * @brief 憨云DTU多分辨率趋势数据接口
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * RAM中的分钟/小时/天三级环形桶，每个桶保存min/max/avg:
+ * - 采样到达时三级累加器同时增量更新，时间跨入新桶时封桶入环
+ * - 查询O(桶数)，不读Flash，供Modbus/蓝牙/OLED趋势显示使用
+ * - 桶值以int16保存 (Q16.16右移value_shift位)，RAM占用由下列宏配置
+ */
+
+#ifndef __TREND_H__
+#define __TREND_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed_point.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // 宏定义
+    // ============================================================================
+
+#ifndef TREND_CHANNELS
+#define TREND_CHANNELS 3 // 趋势通道数 (传感器通道0起)
+#endif
+
+#ifndef TREND_MINUTE_BUCKETS
+#define TREND_MINUTE_BUCKETS 60 // 分钟桶数 (最近1小时)
+#endif
+
+#ifndef TREND_HOUR_BUCKETS
+#define TREND_HOUR_BUCKETS 24 // 小时桶数 (最近1天)
+#endif
+
+#ifndef TREND_DAY_BUCKETS
+#define TREND_DAY_BUCKETS 7 // 天桶数 (最近1周)
+#endif
+
+#define TREND_VALUE_SHIFT_DEFAULT 8 // 默认桶值精度 1/256，范围 ±127
+
+    // ============================================================================
+    // 数据类型定义
+    // ============================================================================
+
+    /**
+     * @brief 趋势分辨率枚举
+     */
+    typedef enum
+    {
+        TREND_LEVEL_MINUTE = 0, // 分钟
+        TREND_LEVEL_HOUR = 1,   // 小时
+        TREND_LEVEL_DAY = 2,    // 天
+        TREND_LEVEL_COUNT
+    } trend_level_t;
+
+    /**
+     * @brief 环形桶存储格式 (封桶后)
+     */
+    typedef struct
+    {
+        int16_t min; // 最小值 (Q16.16 >> value_shift)
+        int16_t max; // 最大值
+        int16_t avg; // 平均值
+    } trend_bucket_t;
+
+    /**
+     * @brief 当前桶累加器
+     */
+    typedef struct
+    {
+        uint32_t index; // 桶序号 (时间 / 桶周期)
+        uint32_t count; // 样本数 (0为未开始)
+        q16_t min;      // 最小值
+        q16_t max;      // 最大值
+        int64_t sum;    // 样本和 (Q16.16)
+    } trend_accumulator_t;
+
+    /**
+     * @brief 查询结果点 (按时间从旧到新)
+     */
+    typedef struct
+    {
+        uint32_t start_time; // 桶起始时间 (s)
+        q16_t min;           // 最小值
+        q16_t max;           // 最大值
+        q16_t avg;           // 平均值
+        bool valid;          // 该时段有样本
+    } trend_point_t;
+
+    // ============================================================================
+    // 函数声明
+    // ============================================================================
+
+    /**
+     * @brief 趋势模块初始化 (清空所有桶，各通道精度恢复默认)
+     */
+    void trend_init(void);
+
+    /**
+     * @brief 设置通道桶值精度
+     * @param channel 趋势通道号
+     * @param value_shift Q16.16右移位数 (0~16)，桶值范围 ±2^(n-1)，精度 1/2^(16-n)
+     * @return true: 成功, false: 参数无效
+     * @note 会清空该通道已有的桶
+     */
+    bool trend_set_resolution(uint8_t channel, uint8_t value_shift);
+
+    /**
+     * @brief 加入一个样本 (三级同时更新)
+     * @param channel 趋势通道号 (超出TREND_CHANNELS时忽略)
+     * @param value 物理量 (Q16.16)
+     * @param time_s 样本时间 (s)
+     */
+    void trend_add_sample(uint8_t channel, q16_t value, uint32_t time_s);
+
+    /**
+     * @brief 查询趋势数据
+     * @param channel 趋势通道号
+     * @param level 分辨率
+     * @param points 输出数组 (从旧到新，最后一个为未封桶的当前桶)
+     * @param max_points 最多输出点数
+     * @return 实际输出点数
+     */
+    uint16_t trend_query(uint8_t channel, trend_level_t level, trend_point_t *points, uint16_t max_points);
+
+    /**
+     * @brief 获取模块RAM占用
+     * @return 字节数
+     */
+    uint32_t trend_get_ram_usage(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TREND_H__
@@ -0,0 +1,254 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+憨云DTU传感器线性化查找表生成脚本
+版本: 1.0
+日期: 2026-10-18
+
+读取传感器描述文件 (scripts/sensor_lut.json)，生成存放在Flash中的常量查找表:
+  - inc/sensor_lut_table.h   表编号枚举和浮点参考参数 (仅供主机端验证)
+  - src/app/sensor_lut_table.c 查找表数据
+
+查找方式:
+  - direct: 码值等间隔 (2^shift) 取点，运行时 raw >> shift 直接索引
+  - binary: 非等间隔断点 + 每段斜率，运行时二分查找
+
+用法: gen_sensor_lut.py <描述文件> <输出头文件> <输出源文件>
+"""
+
+import json
+import math
+import sys
+
+Q16_ONE = 65536
+INT32_MAX = (1 << 31) - 1
+OVERSAMPLE_MAX_BITS = 4  # 与 ADC_OVERSAMPLE_MAX_BITS 一致
+
+
+def q16(value):
+    return int(math.floor(value * Q16_ONE + 0.5))
+
+
+def steinhart_fit(points):
+    """由三组 (°C, Ω) 标定点求解 Steinhart-Hart 系数 A, B, C"""
+    if len(points) != 3:
+        raise ValueError("Steinhart-Hart标定需要3个点")
+    rows = []
+    for temp_c, ohm in points:
+        ln_r = math.log(ohm)
+        rows.append((1.0, ln_r, ln_r ** 3, 1.0 / (temp_c + 273.15)))
+
+    def det3(m):
+        return (m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+                - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+                + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]))
+
+    base = [r[:3] for r in rows]
+    d = det3(base)
+    coeffs = []
+    for col in range(3):
+        m = [list(r[:3]) for r in rows]
+        for i in range(3):
+            m[i][col] = rows[i][3]
+        coeffs.append(det3(m) / d)
+    return coeffs
+
+
+def steinhart_temp(coeffs, ohm):
+    a, b, c = coeffs
+    ln_r = math.log(ohm)
+    return 1.0 / (a + b * ln_r + c * ln_r ** 3) - 273.15
+
+
+def steinhart_ohm(coeffs, temp_c):
+    """温度反求阻值: 1/T 对 lnR 单调，二分求解 (C可能为负，不使用三次方程闭式解)"""
+    low, high = math.log(1.0), math.log(1.0e8)
+    for _ in range(100):
+        mid = (low + high) / 2.0
+        if steinhart_temp(coeffs, math.exp(mid)) > temp_c:
+            low = mid
+        else:
+            high = mid
+    return math.exp((low + high) / 2.0)
+
+
+def ntc_code_to_temp(table, coeffs, full_scale, code):
+    """NTC接地、上拉至VREF的分压: code/FS = R / (R + Rp)"""
+    t_min, t_max = table["range"]
+    if code <= 0:
+        return t_max
+    if code >= full_scale:
+        return t_min
+    ohm = table["pullup_ohm"] * code / (full_scale - code)
+    return min(max(steinhart_temp(coeffs, ohm), t_min), t_max)
+
+
+def build_direct(table, full_scale):
+    shift = table["shift"]
+    coeffs = steinhart_fit(table["calibration"])
+    values = []
+    for k in range((full_scale >> shift) + 1):
+        values.append(q16(ntc_code_to_temp(table, coeffs, full_scale, k << shift)))
+    max_delta = max(abs(values[i + 1] - values[i]) for i in range(len(values) - 1))
+    if max_delta << (shift + OVERSAMPLE_MAX_BITS) > INT32_MAX:
+        raise ValueError("%s: 相邻表项差值过大，插值会溢出32位" % table["id"])
+    return {"kind": "SENSOR_LUT_KIND_DIRECT", "shift": shift, "codes": None,
+            "values": values, "slopes": None, "coeffs": coeffs}
+
+
+def build_binary(table, full_scale, vref_mv):
+    coeffs = None
+    if table["model"] == "steinhart_hart":
+        coeffs = steinhart_fit(table["calibration"])
+        t_min, t_max = table["range"]
+        codes = set()
+        temp = t_min
+        while temp <= t_max:
+            ohm = steinhart_ohm(coeffs, temp)
+            codes.add(int(round(full_scale * ohm / (ohm + table["pullup_ohm"]))))
+            temp += table["step"]
+        codes = sorted(codes)
+        values = [q16(ntc_code_to_temp(table, coeffs, full_scale, c)) for c in codes]
+    elif table["model"] == "piecewise":
+        points = sorted((int(round(mv * full_scale / vref_mv)), v) for mv, v in table["points_mv"])
+        codes = [p[0] for p in points]
+        values = [q16(p[1]) for p in points]
+    else:
+        raise ValueError("%s: 未知模型 %s" % (table["id"], table["model"]))
+
+    if len(set(codes)) != len(codes):
+        raise ValueError("%s: 断点码值重复" % table["id"])
+
+    slopes = []
+    for i in range(len(codes) - 1):
+        slope = (values[i + 1] - values[i]) / (codes[i + 1] - codes[i])
+        slopes.append(int(math.floor(slope + 0.5)))
+        span = abs(slopes[-1]) * ((codes[i + 1] - codes[i]) << OVERSAMPLE_MAX_BITS)
+        if span > INT32_MAX:
+            raise ValueError("%s: 第%d段斜率过大，插值会溢出32位" % (table["id"], i))
+    slopes.append(0)
+    return {"kind": "SENSOR_LUT_KIND_BINARY", "shift": 0, "codes": codes,
+            "values": values, "slopes": slopes, "coeffs": coeffs}
+
+
+def format_array(ctype, name, items, per_line):
+    lines = ["static const %s %s[%d] = {" % (ctype, name, len(items))]
+    for i in range(0, len(items), per_line):
+        chunk = ", ".join(str(v) for v in items[i:i + per_line])
+        lines.append("    " + chunk + ("," if i + per_line < len(items) else ""))
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main(argv):
+    if len(argv) != 4:
+        sys.stderr.write(__doc__)
+        return 1
+
+    with open(argv[1], encoding="utf-8") as f:
+        desc = json.load(f)
+
+    full_scale = 1 << desc["adc"]["bits"]
+    vref_mv = desc["adc"]["vref_mv"]
+    built = []
+    for table in desc["tables"]:
+        if table["lookup"] == "direct":
+            built.append((table, build_direct(table, full_scale)))
+        elif table["lookup"] == "binary":
+            built.append((table, build_binary(table, full_scale, vref_mv)))
+        else:
+            raise ValueError("%s: 未知查找方式 %s" % (table["id"], table["lookup"]))
+
+    banner = "// 由 scripts/gen_sensor_lut.py 根据 scripts/sensor_lut.json 生成，请勿手工修改"
+
+    header = [
+        "/**",
+        " * @file sensor_lut_table.h",
+        " * @brief 憨云DTU传感器线性化查找表编号 (自动生成)",
+        " * @version 1.0",
+        " * @date 2026-10-18",
+        " */",
+        "",
+        banner,
+        "",
+        "#ifndef __SENSOR_LUT_TABLE_H__",
+        "#define __SENSOR_LUT_TABLE_H__",
+        "",
+        "#ifdef __cplusplus",
+        "extern \"C\"",
+        "{",
+        "#endif",
+        "",
+        "#define SENSOR_LUT_ADC_FULL_SCALE %d // 表中码值满量程 (2^%d)" % (full_scale, desc["adc"]["bits"]),
+        "",
+        "    /**",
+        "     * @brief 查找表编号 (SENSOR_LUT_NONE 表示使用 raw*scale+offset)",
+        "     */",
+        "    typedef enum",
+        "    {",
+        "        SENSOR_LUT_NONE = 0,",
+    ]
+    names = ["SENSOR_LUT_%s = %d," % (table["id"], index + 1) for index, (table, _) in enumerate(built)]
+    width = max(len(n) for n in names)
+    for name, (table, _) in zip(names, built):
+        header.append("        %s // %s" % (name.ljust(width), table["description"]))
+    header += ["        SENSOR_LUT_COUNT", "    } sensor_lut_id_t;", ""]
+
+    header.append("// Steinhart-Hart 浮点参考参数 (仅供主机端精度验证，固件不使用)")
+    for table, data in built:
+        if data["coeffs"] is not None:
+            for name, coeff in zip("ABC", data["coeffs"]):
+                header.append("#define SENSOR_LUT_%s_SH_%s %.12e" % (table["id"], name, coeff))
+            header.append("#define SENSOR_LUT_%s_PULLUP_OHM %d" % (table["id"], table["pullup_ohm"]))
+            header.append("#define SENSOR_LUT_%s_T_MIN %d" % (table["id"], table["range"][0]))
+            header.append("#define SENSOR_LUT_%s_T_MAX %d" % (table["id"], table["range"][1]))
+    header += ["", "#ifdef __cplusplus", "}", "#endif", "", "#endif // __SENSOR_LUT_TABLE_H__", ""]
+
+    source = [
+        "/**",
+        " * @file sensor_lut_table.c",
+        " * @brief 憨云DTU传感器线性化查找表数据 (自动生成)",
+        " * @version 1.0",
+        " * @date 2026-10-18",
+        " */",
+        "",
+        banner,
+        "",
+        "#include \"sensor_lut.h\"",
+        "",
+    ]
+    entries = []
+    flash_bytes = 0
+    for table, data in built:
+        lower = table["id"].lower()
+        source.append("// %s" % table["description"])
+        values_name = "lut_%s_values" % lower
+        source.append(format_array("q16_t", values_name, data["values"], 8))
+        flash_bytes += 4 * len(data["values"])
+        codes_name = slopes_name = "NULL"
+        if data["codes"] is not None:
+            codes_name = "lut_%s_codes" % lower
+            slopes_name = "lut_%s_slopes" % lower
+            source.append(format_array("uint16_t", codes_name, data["codes"], 12))
+            source.append(format_array("int32_t", slopes_name, data["slopes"], 8))
+            flash_bytes += 2 * len(data["codes"]) + 4 * len(data["slopes"])
+        source.append("")
+        entries.append("    {%s, %d, %d, %s, %s, %s}, // SENSOR_LUT_%s" % (
+            data["kind"], data["shift"], len(data["values"]), codes_name, values_name, slopes_name, table["id"]))
+
+    source.append("// 表项按 sensor_lut_id_t 顺序排列 (SENSOR_LUT_NONE 不占表项)，共 %d 字节" % flash_bytes)
+    source.append("const sensor_lut_t g_sensor_lut_tables[SENSOR_LUT_COUNT - 1] = {")
+    source += entries
+    source += ["};", ""]
+
+    with open(argv[2], "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(header))
+    with open(argv[3], "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(source))
+
+    print("[LUT] %d tables, %d bytes flash" % (len(built), flash_bytes))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
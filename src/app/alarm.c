@@ -6,9 +6,17 @@
  *
  * 报警监控系统实现，支持阈值监控、报警输出控制、多级报警管理
  * 设计目标：实时监控、快速响应、可配置报警策略
+ *
+ * 每条规则带报警延时/解除延时与回差，状态只在条件持续满足后切换，
+ * 阈值附近的波动不会产生反复的报警/解除记录；
+ * 规则按类型排序索引，采样检查只访问该类型的规则 (二分查找起点)；
+ * 待定/激活/已确认状态以位图保存，输出与级别按规则位掩码聚合，计数使用popcount，
+ * 每次采样的开销与规则总数基本无关
  */
 
 #include "alarm.h"
+#include "alarm_expr.h"
+#include "alarm_notify.h"
 #include "system.h"
 #include "gpio.h"
 #include "storage.h"
@@ -18,6 +26,14 @@
 // 内部数据结构
 // ============================================================================
 
+#define ALARM_BITSET_WORDS ((ALARM_MAX_RULES + 31) / 32) // 规则位图字数
+#define ALARM_BARRIER() __asm volatile("" ::: "memory")    // 编译器屏障 (单核，保证历史环读写顺序)
+
+/**
+ * @brief 规则位图 (位号 = 规则槽位)
+ */
+typedef uint32_t alarm_bitset_t[ALARM_BITSET_WORDS];
+
 /**
  * @brief 报警模块控制块
  */
@@ -32,10 +48,21 @@ typedef struct
     alarm_info_t infos[ALARM_MAX_RULES];        // 报警状态信息
     alarm_history_t history[ALARM_MAX_HISTORY]; // 历史记录
 
-    uint8_t rule_count;     // 规则数量
-    uint8_t active_count;   // 激活报警数量
-    uint16_t history_count; // 历史记录数量
-    uint16_t history_index; // 历史记录写入索引
+    uint8_t type_index[ALARM_MAX_RULES];           // 按类型排序的规则槽位
+    alarm_bitset_t pending_set;                    // 待定规则
+    alarm_bitset_t active_set;                     // 激活规则
+    alarm_bitset_t acked_set;                      // 已确认规则
+    alarm_bitset_t output_sets[ALARM_MAX_OUTPUTS]; // 各输出关联的规则 (输出掩码位)
+    alarm_bitset_t level_sets[ALARM_LEVEL_CRITICAL + 1]; // 各级别的规则
+
+    uint8_t rule_count;   // 规则数量
+    uint8_t active_count; // 激活报警数量
+
+    // 历史环序号自由递增，取低位为槽位 (ALARM_MAX_HISTORY为2的幂，回绕时差值仍正确)
+    // 只有报警任务写入；读者据尾序号判断复制期间被覆盖的记录，无需关中断
+    volatile uint16_t history_head; // 下一条记录的序号
+    volatile uint16_t history_tail; // 最旧有效记录的序号
+    uint16_t history_spill;         // 下一条待转存记录的序号
 
     uint32_t silence_start_time; // 静音开始时间
     uint32_t silence_duration;   // 静音持续时间
@@ -53,9 +80,23 @@ bool g_alarm_initialized = false;
 // ============================================================================
 
 static bool alarm_evaluate_condition(const alarm_rule_t *rule, int32_t value);
+static bool alarm_evaluate_clear(const alarm_rule_t *rule, int32_t value);
+static void alarm_activate(uint8_t index, int32_t value, uint8_t message);
+static void alarm_clear(uint8_t index, int32_t value);
 static void alarm_update_outputs(void);
-static void alarm_add_history(uint8_t rule_id, alarm_state_t state, int32_t value, const char *description);
+static void alarm_add_history(uint8_t index, alarm_state_t state, int32_t value, uint8_t message);
+static bool alarm_spill_history(void);
 static uint8_t alarm_find_rule_index(uint8_t rule_id);
+static uint8_t alarm_find_type_start(uint8_t type);
+static void alarm_rebuild_type_index(void);
+static void alarm_index_rule(uint8_t index);
+static void alarm_unindex_rule(uint8_t index);
+static void alarm_set_state(uint8_t index, alarm_state_t state);
+static bool alarm_acknowledge_index(uint8_t index);
+static bool alarm_resolve_index(uint8_t index);
+static void alarm_disable_index(uint8_t index);
+static uint8_t alarm_next_bit(uint32_t *bits);
+static uint8_t alarm_bitset_count(const uint32_t *set, const uint32_t *mask);
 static void alarm_setup_default_rules(void);
 static void alarm_setup_default_config(void);
 
@@ -75,6 +116,8 @@ bool alarm_init(void)
 
     // 清空控制块
     memset(&g_alarm, 0, sizeof(alarm_control_t));
+    alarm_expr_init();
+    alarm_notify_init();
 
     // 设置默认配置
     alarm_setup_default_config();
@@ -140,6 +183,9 @@ void alarm_deinit(void)
         }
     }
 
+    // 未转存的历史记录写入Flash
+    alarm_flush_history();
+
     // 清空控制块
     memset(&g_alarm, 0, sizeof(alarm_control_t));
     g_alarm_initialized = false;
@@ -167,52 +213,89 @@ void alarm_process(void)
         }
     }
 
-    // 处理每个激活的报警
-    for (uint8_t i = 0; i < g_alarm.rule_count; i++)
+    // 只处理待定/激活/已确认的报警 (按位图逐个取出)
+    for (uint8_t w = 0; w < ALARM_BITSET_WORDS; w++)
     {
-        alarm_rule_t *rule = &g_alarm.rules[i];
-        alarm_info_t *info = &g_alarm.infos[i];
+        uint32_t bits = g_alarm.pending_set[w] | g_alarm.active_set[w] | g_alarm.acked_set[w];
 
-        if (!rule->enabled || info->state == ALARM_STATE_IDLE)
+        while (bits)
         {
-            continue;
-        }
+            uint8_t i = (uint8_t)(w * 32 + alarm_next_bit(&bits));
+            alarm_rule_t *rule = &g_alarm.rules[i];
+            alarm_info_t *info = &g_alarm.infos[i];
 
-        // 检查自动复位
-        if (rule->auto_reset_time > 0 && info->state == ALARM_STATE_ACTIVE)
-        {
-            if ((current_time - info->trigger_time) >= rule->auto_reset_time)
+            if (!rule->enabled)
             {
-                info->state = ALARM_STATE_RESOLVED;
-                info->resolve_time = current_time;
-                info->output_active = false;
-                g_alarm.stats.auto_resolved++;
+                continue;
+            }
 
-                alarm_add_history(rule->id, ALARM_STATE_RESOLVED, 0, "Auto resolved");
+            // 报警延时到: 待定 -> 激活
+            if (info->state == ALARM_STATE_PENDING)
+            {
+                if ((current_time - info->trigger_time) >= rule->debounce_time)
+                {
+                    alarm_activate(i, info->trigger_value, ALARM_MSG_CONDITION_MET);
+                }
+                continue;
             }
-        }
 
-        // 检查自动确认
-        if (g_alarm.config.auto_acknowledge && info->state == ALARM_STATE_ACTIVE)
-        {
-            if ((current_time - info->trigger_time) >= ALARM_AUTO_RESET_TIME / 2)
+            // 解除延时到: 激活/已确认 -> 已解决
+            if (info->clearing && (current_time - info->clear_time) >= rule->clear_delay)
             {
-                info->state = ALARM_STATE_ACKNOWLEDGED;
-                info->acknowledge_time = current_time;
-                info->auto_acknowledged = true;
-                g_alarm.stats.auto_acknowledged++;
+                alarm_clear(i, 0);
+                continue;
+            }
 
-                alarm_add_history(rule->id, ALARM_STATE_ACKNOWLEDGED, 0, "Auto acknowledged");
+            // 检查自动复位
+            if (rule->auto_reset_time > 0 && info->state == ALARM_STATE_ACTIVE)
+            {
+                if ((current_time - info->trigger_time) >= rule->auto_reset_time)
+                {
+                    alarm_set_state(i, ALARM_STATE_RESOLVED);
+                    info->resolve_time = current_time;
+                    info->output_active = false;
+                    info->clearing = false;
+                    info->latched = true;
+                    g_alarm.stats.auto_resolved++;
+
+                    alarm_add_history(i, ALARM_STATE_RESOLVED, 0, ALARM_MSG_AUTO_RESOLVED);
+                }
+            }
+
+            // 检查自动确认
+            if (g_alarm.config.auto_acknowledge && info->state == ALARM_STATE_ACTIVE)
+            {
+                if ((current_time - info->trigger_time) >= ALARM_AUTO_RESET_TIME / 2)
+                {
+                    alarm_set_state(i, ALARM_STATE_ACKNOWLEDGED);
+                    info->acknowledge_time = current_time;
+                    info->auto_acknowledged = true;
+                    g_alarm.stats.auto_acknowledged++;
+
+                    alarm_add_history(i, ALARM_STATE_ACKNOWLEDGED, 0, ALARM_MSG_AUTO_ACKNOWLEDGED);
+                }
             }
-        }
 
-        // 更新持续时间
-        info->duration = current_time - info->trigger_time;
+            // 更新持续时间
+            info->duration = current_time - info->trigger_time;
+        }
     }
 
     // 更新输出状态
     alarm_update_outputs();
 
+    // 合并窗口到期的通知批次发往上行通道
+    alarm_notify_task();
+
+    // 未转存的历史记录过多时，将最旧的转存到Flash (批量转存，留出突发余量)
+    while ((uint16_t)(g_alarm.history_head - g_alarm.history_spill) > ALARM_HISTORY_SPILL_THRESHOLD)
+    {
+        if (!alarm_spill_history())
+        {
+            break;
+        }
+    }
+
     g_alarm.last_process_time = current_time;
 }
 
@@ -235,14 +318,7 @@ bool alarm_get_stats(alarm_stats_t *stats)
     }
 
     // 更新当前激活报警数
-    g_alarm.stats.active_alarms = 0;
-    for (uint8_t i = 0; i < g_alarm.rule_count; i++)
-    {
-        if (g_alarm.infos[i].state == ALARM_STATE_ACTIVE)
-        {
-            g_alarm.stats.active_alarms++;
-        }
-    }
+    g_alarm.stats.active_alarms = alarm_bitset_count(g_alarm.active_set, NULL);
 
     memcpy(stats, &g_alarm.stats, sizeof(alarm_stats_t));
     return true;
@@ -293,7 +369,9 @@ bool alarm_add_rule(const alarm_rule_t *rule)
     info->level = rule->level;
     info->type = rule->type;
 
+    alarm_index_rule(g_alarm.rule_count);
     g_alarm.rule_count++;
+    alarm_rebuild_type_index();
 
     return true;
 }
@@ -317,17 +395,54 @@ bool alarm_remove_rule(uint8_t rule_id)
     // 如果报警处于激活状态，先解决它
     if (g_alarm.infos[index].state == ALARM_STATE_ACTIVE)
     {
-        alarm_resolve(rule_id);
+        alarm_resolve_index(index);
     }
 
-    // 移动后续元素
-    for (uint8_t i = index; i < g_alarm.rule_count - 1; i++)
+    // 最后一条规则移入空出的槽位，位图随之迁移
+    uint8_t last = g_alarm.rule_count - 1;
+    alarm_unindex_rule(index);
+    if (index != last)
     {
-        memcpy(&g_alarm.rules[i], &g_alarm.rules[i + 1], sizeof(alarm_rule_t));
-        memcpy(&g_alarm.infos[i], &g_alarm.infos[i + 1], sizeof(alarm_info_t));
+        alarm_unindex_rule(last);
+        memcpy(&g_alarm.rules[index], &g_alarm.rules[last], sizeof(alarm_rule_t));
+        memcpy(&g_alarm.infos[index], &g_alarm.infos[last], sizeof(alarm_info_t));
+        alarm_index_rule(index);
     }
 
     g_alarm.rule_count--;
+    alarm_rebuild_type_index();
+    return true;
+}
+
+/**
+ * @brief 更新报警规则
+ */
+bool alarm_update_rule(const alarm_rule_t *rule)
+{
+    if (!g_alarm.initialized || !rule)
+    {
+        return false;
+    }
+
+    uint8_t index = alarm_find_rule_index(rule->id);
+    if (index >= ALARM_MAX_RULES)
+    {
+        return false;
+    }
+
+    // 报警状态保留，类型/级别/输出变化时重建索引
+    alarm_unindex_rule(index);
+    memcpy(&g_alarm.rules[index], rule, sizeof(alarm_rule_t));
+    g_alarm.infos[index].level = rule->level;
+    g_alarm.infos[index].type = rule->type;
+    alarm_index_rule(index);
+    alarm_rebuild_type_index();
+
+    if (!rule->enabled)
+    {
+        alarm_disable_index(index);
+    }
+
     return true;
 }
 
@@ -369,10 +484,10 @@ bool alarm_enable_rule(uint8_t rule_id, bool enabled)
 
     g_alarm.rules[index].enabled = enabled;
 
-    // 如果禁用规则且当前有激活报警，解决它
-    if (!enabled && g_alarm.infos[index].state == ALARM_STATE_ACTIVE)
+    // 禁用规则时结束其待定/激活/已确认状态
+    if (!enabled)
     {
-        alarm_resolve(rule_id);
+        alarm_disable_index(index);
     }
 
     return true;
@@ -387,75 +502,95 @@ bool alarm_enable_rule(uint8_t rule_id, bool enabled)
  */
 bool alarm_check_condition(uint8_t type, int32_t value)
 {
+    // 表达式输入历史始终更新，不受全局使能影响
+    alarm_expr_update(alarm_expr_input_for_type(type), value, system_get_tick());
+
     if (!g_alarm.initialized || !g_alarm.config.global_enable)
     {
         return false;
     }
 
     bool alarm_triggered = false;
+    uint32_t current_time = system_get_tick();
 
-    // 遍历所有规则，检查匹配的类型
-    for (uint8_t i = 0; i < g_alarm.rule_count; i++)
+    // 只遍历该类型的规则 (类型索引中连续存放)
+    for (uint8_t k = alarm_find_type_start(type); k < g_alarm.rule_count; k++)
     {
+        uint8_t i = g_alarm.type_index[k];
         alarm_rule_t *rule = &g_alarm.rules[i];
         alarm_info_t *info = &g_alarm.infos[i];
 
-        if (!rule->enabled || rule->type != type)
+        if (rule->type != type)
+        {
+            break;
+        }
+        if (!rule->enabled)
         {
             continue;
         }
 
-        // 评估报警条件
-        bool condition_met = alarm_evaluate_condition(rule, value);
-
-        if (condition_met && info->state == ALARM_STATE_IDLE)
+        switch (info->state)
         {
-            // 触发报警
-            uint32_t current_time = system_get_tick();
+        case ALARM_STATE_RESOLVED:
+            if (info->latched && !alarm_evaluate_clear(rule, value))
+            {
+                break;
+            }
+            // 重新布防后按空闲状态继续判断
+            info->latched = false;
+            alarm_set_state(i, ALARM_STATE_IDLE);
+            // fall through
+        case ALARM_STATE_IDLE:
+            if (alarm_evaluate_condition(rule, value))
+            {
+                // 进入待定，报警延时为0时立即激活
+                alarm_set_state(i, ALARM_STATE_PENDING);
+                info->trigger_time = current_time;
+                info->trigger_value = value;
+                info->trigger_count++;
 
-            info->state = ALARM_STATE_PENDING;
-            info->trigger_time = current_time;
-            info->trigger_value = value;
-            info->trigger_count++;
+                if (rule->debounce_time == 0)
+                {
+                    alarm_activate(i, value, ALARM_MSG_CONDITION_MET);
+                    alarm_triggered = true;
+                }
+            }
+            break;
 
-            // 检查去抖时间
-            if (rule->debounce_time == 0)
+        case ALARM_STATE_PENDING:
+            if (alarm_evaluate_condition(rule, value))
             {
-                // 立即激活
-                info->state = ALARM_STATE_ACTIVE;
-                info->output_active = true;
-                g_alarm.stats.total_alarms++;
+                // 记录延时期间的最新越限值
+                info->trigger_value = value;
+            }
+            else
+            {
+                // 未持续到报警延时，不产生记录
+                alarm_set_state(i, ALARM_STATE_IDLE);
+                g_alarm.stats.false_alarms++;
+            }
+            break;
 
-                // 按级别统计
-                switch (rule->level)
+        case ALARM_STATE_ACTIVE:
+        case ALARM_STATE_ACKNOWLEDGED:
+            if (!alarm_evaluate_clear(rule, value))
+            {
+                // 仍在回差带外侧，取消解除计时
+                info->clearing = false;
+            }
+            else if (!info->clearing)
+            {
+                info->clearing = true;
+                info->clear_time = current_time;
+                if (rule->clear_delay == 0)
                 {
-                case ALARM_LEVEL_INFO:
-                    g_alarm.stats.info_alarms++;
-                    break;
-                case ALARM_LEVEL_WARNING:
-                    g_alarm.stats.warning_alarms++;
-                    break;
-                case ALARM_LEVEL_ERROR:
-                    g_alarm.stats.error_alarms++;
-                    break;
-                case ALARM_LEVEL_CRITICAL:
-                    g_alarm.stats.critical_alarms++;
-                    break;
+                    alarm_clear(i, value);
                 }
-
-                alarm_add_history(rule->id, ALARM_STATE_ACTIVE, value, rule->description);
-                alarm_triggered = true;
             }
-        }
-        else if (!condition_met && (info->state == ALARM_STATE_PENDING || info->state == ALARM_STATE_ACTIVE))
-        {
-            // 条件不满足，解决报警
-            info->state = ALARM_STATE_RESOLVED;
-            info->resolve_time = system_get_tick();
-            info->output_active = false;
-            g_alarm.stats.auto_resolved++;
+            break;
 
-            alarm_add_history(rule->id, ALARM_STATE_RESOLVED, value, "Condition cleared");
+        default:
+            break;
         }
     }
 
@@ -487,34 +622,10 @@ bool alarm_trigger(uint8_t rule_id, int32_t value)
     }
 
     // 手动触发报警
-    uint32_t current_time = system_get_tick();
-
-    info->state = ALARM_STATE_ACTIVE;
-    info->trigger_time = current_time;
+    info->trigger_time = system_get_tick();
     info->trigger_value = value;
     info->trigger_count++;
-    info->output_active = true;
-
-    g_alarm.stats.total_alarms++;
-
-    // 按级别统计
-    switch (rule->level)
-    {
-    case ALARM_LEVEL_INFO:
-        g_alarm.stats.info_alarms++;
-        break;
-    case ALARM_LEVEL_WARNING:
-        g_alarm.stats.warning_alarms++;
-        break;
-    case ALARM_LEVEL_ERROR:
-        g_alarm.stats.error_alarms++;
-        break;
-    case ALARM_LEVEL_CRITICAL:
-        g_alarm.stats.critical_alarms++;
-        break;
-    }
-
-    alarm_add_history(rule->id, ALARM_STATE_ACTIVE, value, "Manual trigger");
+    alarm_activate(index, value, ALARM_MSG_MANUAL_TRIGGER);
     return true;
 }
 
@@ -534,20 +645,7 @@ bool alarm_acknowledge(uint8_t rule_id)
         return false;
     }
 
-    alarm_info_t *info = &g_alarm.infos[index];
-
-    if (info->state != ALARM_STATE_ACTIVE)
-    {
-        return false;
-    }
-
-    info->state = ALARM_STATE_ACKNOWLEDGED;
-    info->acknowledge_time = system_get_tick();
-    info->auto_acknowledged = false;
-    g_alarm.stats.manual_acknowledged++;
-
-    alarm_add_history(rule_id, ALARM_STATE_ACKNOWLEDGED, 0, "Manual acknowledge");
-    return true;
+    return alarm_acknowledge_index(index);
 }
 
 /**
@@ -566,26 +664,40 @@ bool alarm_resolve(uint8_t rule_id)
         return false;
     }
 
-    alarm_info_t *info = &g_alarm.infos[index];
+    return alarm_resolve_index(index);
+}
 
-    if (info->state == ALARM_STATE_IDLE || info->state == ALARM_STATE_RESOLVED)
+/**
+ * @brief 确认所有报警
+ */
+uint8_t alarm_acknowledge_all(void)
+{
+    if (!g_alarm.initialized)
     {
-        return false;
+        return 0;
     }
 
-    info->state = ALARM_STATE_RESOLVED;
-    info->resolve_time = system_get_tick();
-    info->output_active = false;
-    g_alarm.stats.manual_resolved++;
+    uint8_t count = 0;
+    for (uint8_t w = 0; w < ALARM_BITSET_WORDS; w++)
+    {
+        uint32_t bits = g_alarm.active_set[w];
 
-    alarm_add_history(rule_id, ALARM_STATE_RESOLVED, 0, "Manual resolve");
-    return true;
+        while (bits)
+        {
+            if (alarm_acknowledge_index((uint8_t)(w * 32 + alarm_next_bit(&bits))))
+            {
+                count++;
+            }
+        }
+    }
+
+    return count;
 }
 
 /**
- * @brief 确认所有报警
+ * @brief 解决所有报警
  */
-uint8_t alarm_acknowledge_all(void)
+uint8_t alarm_resolve_all(void)
 {
     if (!g_alarm.initialized)
     {
@@ -593,11 +705,13 @@ uint8_t alarm_acknowledge_all(void)
     }
 
     uint8_t count = 0;
-    for (uint8_t i = 0; i < g_alarm.rule_count; i++)
+    for (uint8_t w = 0; w < ALARM_BITSET_WORDS; w++)
     {
-        if (g_alarm.infos[i].state == ALARM_STATE_ACTIVE)
+        uint32_t bits = g_alarm.pending_set[w] | g_alarm.active_set[w] | g_alarm.acked_set[w];
+
+        while (bits)
         {
-            if (alarm_acknowledge(g_alarm.rules[i].id))
+            if (alarm_resolve_index((uint8_t)(w * 32 + alarm_next_bit(&bits))))
             {
                 count++;
             }
@@ -638,16 +752,7 @@ uint8_t alarm_get_active_count(void)
         return 0;
     }
 
-    uint8_t count = 0;
-    for (uint8_t i = 0; i < g_alarm.rule_count; i++)
-    {
-        if (g_alarm.infos[i].state == ALARM_STATE_ACTIVE)
-        {
-            count++;
-        }
-    }
-
-    return count;
+    return alarm_bitset_count(g_alarm.active_set, NULL);
 }
 
 /**
@@ -660,16 +765,12 @@ uint8_t alarm_get_level_count(uint8_t level)
         return 0;
     }
 
-    uint8_t count = 0;
-    for (uint8_t i = 0; i < g_alarm.rule_count; i++)
+    if (!alarm_is_valid_level(level))
     {
-        if (g_alarm.infos[i].state == ALARM_STATE_ACTIVE && g_alarm.rules[i].level == level)
-        {
-            count++;
-        }
+        return 0;
     }
 
-    return count;
+    return alarm_bitset_count(g_alarm.active_set, g_alarm.level_sets[level]);
 }
 
 /**
@@ -692,6 +793,137 @@ bool alarm_get_info(uint8_t rule_id, alarm_info_t *info)
     return true;
 }
 
+/**
+ * @brief 检查是否有指定类型的报警
+ */
+bool alarm_has_type(uint8_t type)
+{
+    if (!g_alarm.initialized)
+    {
+        return false;
+    }
+
+    for (uint8_t k = alarm_find_type_start(type); k < g_alarm.rule_count; k++)
+    {
+        uint8_t i = g_alarm.type_index[k];
+
+        if (g_alarm.rules[i].type != type)
+        {
+            break;
+        }
+        if (g_alarm.active_set[i / 32] & (1UL << (i % 32)))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief 检查是否有指定级别的报警
+ */
+bool alarm_has_level(uint8_t level)
+{
+    if (!g_alarm.initialized || !alarm_is_valid_level(level))
+    {
+        return false;
+    }
+
+    for (uint8_t w = 0; w < ALARM_BITSET_WORDS; w++)
+    {
+        if (g_alarm.active_set[w] & g_alarm.level_sets[level][w])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// ============================================================================
+// 报警历史管理接口实现
+// ============================================================================
+
+/**
+ * @brief 获取报警历史记录 (按时间从旧到新)
+ */
+uint16_t alarm_get_history(alarm_history_t *history, uint16_t max_count)
+{
+    if (!g_alarm.initialized || !history)
+    {
+        return 0;
+    }
+
+    uint16_t head = g_alarm.history_head;
+    uint16_t count = (uint16_t)(head - g_alarm.history_tail);
+    if (count > max_count)
+    {
+        count = max_count;
+    }
+    uint16_t start = (uint16_t)(head - count);
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        memcpy(&history[i], &g_alarm.history[(uint16_t)(start + i) & (ALARM_MAX_HISTORY - 1)],
+               sizeof(alarm_history_t));
+    }
+
+    // 写者覆盖槽位前先推进尾序号，复制期间被覆盖的记录 (序号落后于尾序号) 丢弃
+    ALARM_BARRIER();
+    int16_t overwritten = (int16_t)(g_alarm.history_tail - start);
+    if (overwritten > 0)
+    {
+        if (overwritten >= (int16_t)count)
+        {
+            return 0;
+        }
+        count = (uint16_t)(count - overwritten);
+        memmove(&history[0], &history[overwritten], count * sizeof(alarm_history_t));
+    }
+
+    return count;
+}
+
+/**
+ * @brief 将全部未转存的历史记录转存到Flash
+ */
+uint16_t alarm_flush_history(void)
+{
+    uint16_t spilled = 0;
+
+    if (!g_alarm.initialized)
+    {
+        return 0;
+    }
+
+    while (g_alarm.history_spill != g_alarm.history_head && alarm_spill_history())
+    {
+        spilled++;
+    }
+    return spilled;
+}
+
+/**
+ * @brief 获取历史消息文本
+ */
+const char *alarm_get_message(uint8_t message)
+{
+    // 常量表位于Flash，历史记录中只保存消息ID
+    static const char *const messages[ALARM_MSG_COUNT] = {
+        "",                   // ALARM_MSG_NONE
+        "Condition met",      // ALARM_MSG_CONDITION_MET
+        "Manual trigger",     // ALARM_MSG_MANUAL_TRIGGER
+        "Condition cleared",  // ALARM_MSG_CONDITION_CLEARED
+        "Auto resolved",      // ALARM_MSG_AUTO_RESOLVED
+        "Auto acknowledged",  // ALARM_MSG_AUTO_ACKNOWLEDGED
+        "Manual acknowledge", // ALARM_MSG_MANUAL_ACKNOWLEDGE
+        "Manual resolve",     // ALARM_MSG_MANUAL_RESOLVE
+    };
+
+    return (message < ALARM_MSG_COUNT) ? messages[message] : "";
+}
+
 // ============================================================================
 // 配置管理接口实现
 // ============================================================================
@@ -803,11 +1035,95 @@ static bool alarm_evaluate_condition(const alarm_rule_t *rule, int32_t value)
         return (value >= rule->threshold_low && value <= rule->threshold_high);
     case ALARM_CONDITION_OUT_RANGE:
         return (value < rule->threshold_low || value > rule->threshold_high);
+    case ALARM_CONDITION_EXPR:
+        return alarm_expr_evaluate(rule->expression, system_get_tick());
     default:
         return false;
     }
 }
 
+/**
+ * @brief 评估解除条件 (报警阈值向正常侧偏移回差)
+ */
+static bool alarm_evaluate_clear(const alarm_rule_t *rule, int32_t value)
+{
+    int32_t h = rule->hysteresis;
+
+    switch (rule->condition)
+    {
+    case ALARM_CONDITION_GT:
+        return (value <= rule->threshold_high - h);
+    case ALARM_CONDITION_LT:
+        return (value >= rule->threshold_low + h);
+    case ALARM_CONDITION_GE:
+        return (value < rule->threshold_high - h);
+    case ALARM_CONDITION_LE:
+        return (value > rule->threshold_low + h);
+    case ALARM_CONDITION_EQ:
+        return (value < rule->threshold_high - h || value > rule->threshold_high + h);
+    case ALARM_CONDITION_NE:
+        return (value >= rule->threshold_high - h && value <= rule->threshold_high + h);
+    case ALARM_CONDITION_RANGE:
+        return (value < rule->threshold_low - h || value > rule->threshold_high + h);
+    case ALARM_CONDITION_OUT_RANGE:
+        return (value >= rule->threshold_low + h && value <= rule->threshold_high - h);
+    case ALARM_CONDITION_EXPR:
+        // 表达式自行表达回差 (例如 for()/窗口均值)
+        return !alarm_expr_evaluate(rule->expression, system_get_tick());
+    default:
+        return true;
+    }
+}
+
+/**
+ * @brief 激活报警 (统计并记录历史)
+ */
+static void alarm_activate(uint8_t index, int32_t value, uint8_t message)
+{
+    alarm_info_t *info = &g_alarm.infos[index];
+
+    alarm_set_state(index, ALARM_STATE_ACTIVE);
+    info->output_active = true;
+    info->clearing = false;
+    g_alarm.stats.total_alarms++;
+
+    // 按级别统计
+    switch (g_alarm.rules[index].level)
+    {
+    case ALARM_LEVEL_INFO:
+        g_alarm.stats.info_alarms++;
+        break;
+    case ALARM_LEVEL_WARNING:
+        g_alarm.stats.warning_alarms++;
+        break;
+    case ALARM_LEVEL_ERROR:
+        g_alarm.stats.error_alarms++;
+        break;
+    case ALARM_LEVEL_CRITICAL:
+        g_alarm.stats.critical_alarms++;
+        break;
+    }
+
+    alarm_add_history(index, ALARM_STATE_ACTIVE, value, message);
+}
+
+/**
+ * @brief 解除条件持续满足，解决报警
+ */
+static void alarm_clear(uint8_t index, int32_t value)
+{
+    alarm_info_t *info = &g_alarm.infos[index];
+
+    alarm_set_state(index, ALARM_STATE_RESOLVED);
+    info->resolve_time = system_get_tick();
+    info->duration = info->resolve_time - info->trigger_time;
+    info->output_active = false;
+    info->clearing = false;
+    g_alarm.stats.auto_resolved++;
+
+    alarm_add_history(index, ALARM_STATE_RESOLVED, value, ALARM_MSG_CONDITION_CLEARED);
+}
+
 /**
  * @brief 更新输出状态
  */
@@ -818,27 +1134,23 @@ static void alarm_update_outputs(void)
         return; // 静音状态下不更新输出
     }
 
-    bool led_active = false;
-    bool buzzer_active = false;
-
-    // 检查是否有激活的报警需要输出
-    for (uint8_t i = 0; i < g_alarm.rule_count; i++)
+    // 激活规则与各输出的规则位图求交，得到需要驱动的输出
+    uint8_t output_mask = 0;
+    for (uint8_t o = 0; o < ALARM_MAX_OUTPUTS; o++)
     {
-        if (g_alarm.infos[i].state == ALARM_STATE_ACTIVE && g_alarm.infos[i].output_active)
+        for (uint8_t w = 0; w < ALARM_BITSET_WORDS; w++)
         {
-            uint8_t output_mask = g_alarm.rules[i].output_mask;
-
-            if (output_mask & ALARM_OUTPUT_LED)
+            if (g_alarm.active_set[w] & g_alarm.output_sets[o][w])
             {
-                led_active = true;
-            }
-            if (output_mask & ALARM_OUTPUT_BUZZER)
-            {
-                buzzer_active = true;
+                output_mask |= (uint8_t)(1U << o);
+                break;
             }
         }
     }
 
+    bool led_active = (output_mask & ALARM_OUTPUT_LED) != 0;
+    bool buzzer_active = (output_mask & ALARM_OUTPUT_BUZZER) != 0;
+
     // 更新LED输出
     if (g_alarm.config.outputs[0].enabled && g_alarm.config.outputs[0].type == ALARM_OUTPUT_LED)
     {
@@ -862,41 +1174,77 @@ static void alarm_update_outputs(void)
 /**
  * @brief 添加历史记录
  */
-static void alarm_add_history(uint8_t rule_id, alarm_state_t state, int32_t value, const char *description)
+static void alarm_add_history(uint8_t index, alarm_state_t state, int32_t value, uint8_t message)
 {
-    if (g_alarm.history_count >= ALARM_MAX_HISTORY)
+    uint16_t head = g_alarm.history_head;
+
+    if ((uint16_t)(head - g_alarm.history_tail) >= ALARM_MAX_HISTORY)
     {
-        // 循环覆盖
-        g_alarm.history_index = 0;
+        // 环满: 最旧的记录尚未转存则先转存，失败则丢弃
+        if (g_alarm.history_spill == g_alarm.history_tail && !alarm_spill_history())
+        {
+            g_alarm.history_spill++;
+            g_alarm.stats.history_dropped++;
+        }
+        // 先推进尾序号再覆盖槽位
+        g_alarm.history_tail = (uint16_t)(g_alarm.history_tail + 1);
+        ALARM_BARRIER();
     }
 
-    alarm_history_t *record = &g_alarm.history[g_alarm.history_index];
-
+    alarm_history_t *record = &g_alarm.history[head & (ALARM_MAX_HISTORY - 1)];
     record->timestamp = system_get_tick();
-    record->rule_id = rule_id;
-    record->state = state;
     record->value = value;
-
-    // 查找规则信息
-    uint8_t rule_index = alarm_find_rule_index(rule_id);
-    if (rule_index < ALARM_MAX_RULES)
+    record->duration = g_alarm.infos[index].duration;
+    record->rule_id = g_alarm.rules[index].id;
+    record->type = g_alarm.rules[index].type;
+    record->level = g_alarm.rules[index].level;
+    record->state = (uint8_t)state;
+    record->message = message;
+
+    // 记录写完后再发布
+    ALARM_BARRIER();
+    g_alarm.history_head = (uint16_t)(head + 1);
+
+    // 上行通知经合并与限速后批量发出
+    if (g_alarm.rules[index].output_mask & ALARM_OUTPUT_UPLINK)
     {
-        record->type = g_alarm.rules[rule_index].type;
-        record->level = g_alarm.rules[rule_index].level;
-        record->duration = g_alarm.infos[rule_index].duration;
+        alarm_notify_post(record);
     }
+}
 
-    if (description)
+/**
+ * @brief 转存最旧的一条未转存历史记录到Flash
+ * @return true: 成功, false: 存储不可用或作业队列满
+ */
+static bool alarm_spill_history(void)
+{
+    const alarm_history_t *entry = &g_alarm.history[g_alarm.history_spill & (ALARM_MAX_HISTORY - 1)];
+    storage_alarm_record_t record;
+
+    if (!storage_is_initialized())
     {
-        strncpy(record->description, description, sizeof(record->description) - 1);
-        record->description[sizeof(record->description) - 1] = '\0';
+        return false;
     }
 
-    g_alarm.history_index++;
-    if (g_alarm.history_count < ALARM_MAX_HISTORY)
+    memset(&record, 0, sizeof(record));
+    record.alarm_type = entry->type;
+    record.alarm_level = entry->level;
+    record.alarm_value = entry->value;
+    record.alarm_duration = entry->duration;
+    record.rule_id = entry->rule_id;
+    record.alarm_state = entry->state;
+    record.message_id = entry->message;
+
+    // 系统节拍换算为存储时基，保留事件发生时刻
+    uint32_t timestamp = storage_get_timestamp() - (system_get_tick() - entry->timestamp);
+    if (!storage_write_alarm_event(&record, timestamp))
     {
-        g_alarm.history_count++;
+        return false;
     }
+
+    g_alarm.history_spill++;
+    g_alarm.stats.history_spilled++;
+    return true;
 }
 
 /**
@@ -914,6 +1262,222 @@ static uint8_t alarm_find_rule_index(uint8_t rule_id)
     return ALARM_MAX_RULES; // 未找到
 }
 
+/**
+ * @brief 查找类型索引中第一条该类型规则的位置 (二分查找)
+ * @return 索引位置 (无该类型规则时指向第一条类型更大的规则或rule_count)
+ */
+static uint8_t alarm_find_type_start(uint8_t type)
+{
+    uint8_t low = 0;
+    uint8_t high = g_alarm.rule_count;
+
+    while (low < high)
+    {
+        uint8_t mid = (uint8_t)((low + high) / 2);
+        if (g_alarm.rules[g_alarm.type_index[mid]].type < type)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * @brief 重建类型索引 (按槽位顺序插入排序，规则增删改时调用，不在采样路径上)
+ */
+static void alarm_rebuild_type_index(void)
+{
+    for (uint8_t i = 0; i < g_alarm.rule_count; i++)
+    {
+        uint8_t slot = i;
+        uint8_t type = g_alarm.rules[slot].type;
+        uint8_t k = i;
+
+        while (k > 0 && g_alarm.rules[g_alarm.type_index[k - 1]].type > type)
+        {
+            g_alarm.type_index[k] = g_alarm.type_index[k - 1];
+            k--;
+        }
+        g_alarm.type_index[k] = slot;
+    }
+}
+
+/**
+ * @brief 按规则配置与当前状态置位各位图
+ */
+static void alarm_index_rule(uint8_t index)
+{
+    const alarm_rule_t *rule = &g_alarm.rules[index];
+    uint32_t bit = 1UL << (index % 32);
+    uint8_t w = index / 32;
+
+    for (uint8_t o = 0; o < ALARM_MAX_OUTPUTS; o++)
+    {
+        if (rule->output_mask & (1U << o))
+        {
+            g_alarm.output_sets[o][w] |= bit;
+        }
+    }
+    if (alarm_is_valid_level(rule->level))
+    {
+        g_alarm.level_sets[rule->level][w] |= bit;
+    }
+    alarm_set_state(index, g_alarm.infos[index].state);
+}
+
+/**
+ * @brief 清除规则槽位在各位图中的位
+ */
+static void alarm_unindex_rule(uint8_t index)
+{
+    uint32_t bit = 1UL << (index % 32);
+    uint8_t w = index / 32;
+
+    for (uint8_t o = 0; o < ALARM_MAX_OUTPUTS; o++)
+    {
+        g_alarm.output_sets[o][w] &= ~bit;
+    }
+    for (uint8_t l = 0; l <= ALARM_LEVEL_CRITICAL; l++)
+    {
+        g_alarm.level_sets[l][w] &= ~bit;
+    }
+    g_alarm.pending_set[w] &= ~bit;
+    g_alarm.active_set[w] &= ~bit;
+    g_alarm.acked_set[w] &= ~bit;
+}
+
+/**
+ * @brief 设置报警状态并同步状态位图
+ */
+static void alarm_set_state(uint8_t index, alarm_state_t state)
+{
+    uint32_t bit = 1UL << (index % 32);
+    uint8_t w = index / 32;
+
+    g_alarm.infos[index].state = state;
+    g_alarm.pending_set[w] &= ~bit;
+    g_alarm.active_set[w] &= ~bit;
+    g_alarm.acked_set[w] &= ~bit;
+
+    switch (state)
+    {
+    case ALARM_STATE_PENDING:
+        g_alarm.pending_set[w] |= bit;
+        break;
+    case ALARM_STATE_ACTIVE:
+        g_alarm.active_set[w] |= bit;
+        break;
+    case ALARM_STATE_ACKNOWLEDGED:
+        g_alarm.acked_set[w] |= bit;
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief 确认指定槽位的报警
+ */
+static bool alarm_acknowledge_index(uint8_t index)
+{
+    alarm_info_t *info = &g_alarm.infos[index];
+
+    if (info->state != ALARM_STATE_ACTIVE)
+    {
+        return false;
+    }
+
+    alarm_set_state(index, ALARM_STATE_ACKNOWLEDGED);
+    info->acknowledge_time = system_get_tick();
+    info->auto_acknowledged = false;
+    g_alarm.stats.manual_acknowledged++;
+
+    alarm_add_history(index, ALARM_STATE_ACKNOWLEDGED, 0, ALARM_MSG_MANUAL_ACKNOWLEDGE);
+    return true;
+}
+
+/**
+ * @brief 解决指定槽位的报警
+ */
+static bool alarm_resolve_index(uint8_t index)
+{
+    alarm_info_t *info = &g_alarm.infos[index];
+
+    if (info->state == ALARM_STATE_IDLE || info->state == ALARM_STATE_RESOLVED)
+    {
+        return false;
+    }
+
+    alarm_set_state(index, ALARM_STATE_RESOLVED);
+    info->resolve_time = system_get_tick();
+    info->output_active = false;
+    info->clearing = false;
+    info->latched = true;
+    g_alarm.stats.manual_resolved++;
+
+    alarm_add_history(index, ALARM_STATE_RESOLVED, 0, ALARM_MSG_MANUAL_RESOLVE);
+    return true;
+}
+
+/**
+ * @brief 结束被禁用规则的报警状态
+ * @note 待定状态尚未产生报警，直接回到空闲；激活/已确认状态按手动解决处理
+ */
+static void alarm_disable_index(uint8_t index)
+{
+    if (g_alarm.infos[index].state == ALARM_STATE_PENDING)
+    {
+        alarm_set_state(index, ALARM_STATE_IDLE);
+    }
+    else
+    {
+        alarm_resolve_index(index);
+    }
+}
+
+/**
+ * @brief 取出并清除最低置位位 (de Bruijn序列，Cortex-M0无CLZ/CTZ指令)
+ * @param bits 位图字
+ * @return 位号
+ */
+static uint8_t alarm_next_bit(uint32_t *bits)
+{
+    static const uint8_t debruijn_position[32] = {
+        0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+        31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9};
+    uint32_t lowest = *bits & (0U - *bits);
+
+    *bits &= *bits - 1;
+    return debruijn_position[(uint32_t)(lowest * 0x077CB531UL) >> 27];
+}
+
+/**
+ * @brief 统计位图中的置位数 (可选与掩码求交)
+ * @param set 位图
+ * @param mask 掩码位图 (NULL: 不求交)
+ * @return 置位数
+ */
+static uint8_t alarm_bitset_count(const uint32_t *set, const uint32_t *mask)
+{
+    uint8_t count = 0;
+
+    for (uint8_t w = 0; w < ALARM_BITSET_WORDS; w++)
+    {
+        uint32_t v = mask ? (set[w] & mask[w]) : set[w];
+
+        // SWAR popcount
+        v = v - ((v >> 1) & 0x55555555UL);
+        v = (v & 0x33333333UL) + ((v >> 2) & 0x33333333UL);
+        v = (v + (v >> 4)) & 0x0F0F0F0FUL;
+        count += (uint8_t)((v * 0x01010101UL) >> 24);
+    }
+    return count;
+}
+
 /**
  * @brief 设置默认报警规则
  */
@@ -927,9 +1491,11 @@ static void alarm_setup_default_rules(void)
         .condition = ALARM_CONDITION_GT,
         .enabled = true,
         .threshold_high = 600,    // 60.0°C
+        .hysteresis = 20,         // 2.0°C
         .debounce_time = 5000,    // 5秒
+        .clear_delay = 10000,     // 10秒
         .auto_reset_time = 30000, // 30秒
-        .output_mask = ALARM_OUTPUT_LED,
+        .output_mask = ALARM_OUTPUT_LED | ALARM_OUTPUT_UPLINK,
         .priority = 3,
         .description = "High Temperature"};
     strcpy(temp_high_rule.description, "High Temperature");
@@ -943,9 +1509,11 @@ static void alarm_setup_default_rules(void)
         .condition = ALARM_CONDITION_LT,
         .enabled = true,
         .threshold_low = -100,    // -10.0°C
+        .hysteresis = 20,         // 2.0°C
         .debounce_time = 5000,    // 5秒
+        .clear_delay = 10000,     // 10秒
         .auto_reset_time = 30000, // 30秒
-        .output_mask = ALARM_OUTPUT_LED,
+        .output_mask = ALARM_OUTPUT_LED | ALARM_OUTPUT_UPLINK,
         .priority = 3,
         .description = "Low Temperature"};
     strcpy(temp_low_rule.description, "Low Temperature");
@@ -959,9 +1527,11 @@ static void alarm_setup_default_rules(void)
         .condition = ALARM_CONDITION_GT,
         .enabled = true,
         .threshold_high = 900,    // 90.0%RH
+        .hysteresis = 30,         // 3.0%RH
         .debounce_time = 10000,   // 10秒
+        .clear_delay = 20000,     // 20秒
         .auto_reset_time = 60000, // 60秒
-        .output_mask = ALARM_OUTPUT_LED,
+        .output_mask = ALARM_OUTPUT_LED | ALARM_OUTPUT_UPLINK,
         .priority = 2,
         .description = "High Humidity"};
     strcpy(humidity_high_rule.description, "High Humidity");
@@ -975,9 +1545,11 @@ static void alarm_setup_default_rules(void)
         .condition = ALARM_CONDITION_LT,
         .enabled = true,
         .threshold_low = 2800,    // 2.8V
+        .hysteresis = 100,        // 0.1V
         .debounce_time = 3000,    // 3秒
+        .clear_delay = 5000,      // 5秒
         .auto_reset_time = 30000, // 30秒
-        .output_mask = ALARM_OUTPUT_LED | ALARM_OUTPUT_BUZZER,
+        .output_mask = ALARM_OUTPUT_LED | ALARM_OUTPUT_BUZZER | ALARM_OUTPUT_UPLINK,
         .priority = 5,
         .description = "Low Voltage"};
     strcpy(voltage_low_rule.description, "Low Voltage");
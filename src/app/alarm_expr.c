@@ -0,0 +1,782 @@
+/**
+ * @file alarm_expr.c
+ * @brief 憨云DTU报警表达式编译与解释执行实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 编译器为递归下降，边解析边输出字节码并跟踪栈深度；
+ * 解释器为单个switch循环，操作数直接从字节码读取，栈为局部数组
+ */
+
+#include "alarm_expr.h"
+#include "alarm.h"
+#include <string.h>
+
+// ============================================================================
+// 内部数据结构
+// ============================================================================
+
+/**
+ * @brief 输入状态 (最新值 + 按固定间隔抽取的历史环)
+ */
+typedef struct
+{
+    int32_t latest;                       // 最新值
+    uint32_t latest_time;                 // 最新值时刻
+    int32_t history[ALARM_EXPR_HISTORY];  // 历史环
+    uint32_t slot_time;                   // 最新历史槽的时刻
+    uint8_t head;                         // 下一个写入位置
+    uint8_t count;                        // 历史槽数
+    bool valid;                           // 已有采样
+} alarm_expr_input_t;
+
+/**
+ * @brief 编译器状态
+ */
+typedef struct
+{
+    const char *source; // 表达式文本
+    uint8_t pos;        // 当前位置
+    uint8_t *code;      // 输出缓冲区
+    uint8_t size;       // 缓冲区大小
+    uint8_t length;     // 已输出长度
+    uint8_t depth;      // 当前栈深度
+    uint8_t max_depth;  // 最大栈深度
+    uint8_t holds;      // 已分配的持续槽
+    bool error;         // 出错
+    uint8_t error_pos;  // 出错位置
+} alarm_expr_parser_t;
+
+/**
+ * @brief 名称表项
+ */
+typedef struct
+{
+    const char *name;
+    uint8_t value;
+} alarm_expr_name_t;
+
+static alarm_expr_input_t g_expr_inputs[ALARM_EXPR_INPUTS];
+static alarm_expr_t g_expr_programs[ALARM_EXPR_MAX_PROGRAMS];
+
+static const alarm_expr_name_t g_expr_inputs_names[] = {
+    {"temp", ALARM_EXPR_INPUT_TEMPERATURE},
+    {"humi", ALARM_EXPR_INPUT_HUMIDITY},
+    {"volt", ALARM_EXPR_INPUT_VOLTAGE},
+    {"aux", ALARM_EXPR_INPUT_AUX},
+};
+
+static const alarm_expr_name_t g_expr_window_names[] = {
+    {"avg", ALARM_EXPR_OP_AVG},
+    {"min", ALARM_EXPR_OP_MIN},
+    {"max", ALARM_EXPR_OP_MAX},
+    {"rate", ALARM_EXPR_OP_RATE},
+};
+
+// 各操作码的操作数长度与栈效果 (弹出数, 压入数)
+static const uint8_t g_expr_operand_size[ALARM_EXPR_OP_COUNT] = {0, 4, 1, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3};
+static const uint8_t g_expr_pops[ALARM_EXPR_OP_COUNT] = {1, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1};
+static const uint8_t g_expr_pushes[ALARM_EXPR_OP_COUNT] = {0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static void alarm_expr_push_history(alarm_expr_input_t *in, int32_t value);
+static int32_t alarm_expr_window(uint8_t op, uint8_t input, uint16_t seconds);
+static int32_t alarm_expr_run(alarm_expr_t *expr, uint32_t now);
+static void alarm_expr_parse_or(alarm_expr_parser_t *p);
+static void alarm_expr_parse_and(alarm_expr_parser_t *p);
+static void alarm_expr_parse_not(alarm_expr_parser_t *p);
+static void alarm_expr_parse_compare(alarm_expr_parser_t *p);
+static void alarm_expr_parse_sum(alarm_expr_parser_t *p);
+static void alarm_expr_parse_term(alarm_expr_parser_t *p);
+static void alarm_expr_emit(alarm_expr_parser_t *p, uint8_t op, const uint8_t *operand);
+static bool alarm_expr_accept(alarm_expr_parser_t *p, const char *token);
+static void alarm_expr_expect(alarm_expr_parser_t *p, const char *token);
+static bool alarm_expr_number(alarm_expr_parser_t *p, int32_t *value);
+static bool alarm_expr_name(alarm_expr_parser_t *p, const alarm_expr_name_t *names, uint8_t count, uint8_t *value);
+static void alarm_expr_fail(alarm_expr_parser_t *p);
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+/**
+ * @brief 清空输入历史与全部表达式
+ */
+void alarm_expr_init(void)
+{
+    memset(g_expr_inputs, 0, sizeof(g_expr_inputs));
+    memset(g_expr_programs, 0, sizeof(g_expr_programs));
+}
+
+/**
+ * @brief 更新输入
+ */
+void alarm_expr_update(uint8_t input, int32_t value, uint32_t now)
+{
+    if (input >= ALARM_EXPR_INPUTS)
+    {
+        return;
+    }
+
+    alarm_expr_input_t *in = &g_expr_inputs[input];
+    in->latest = value;
+    in->latest_time = now;
+
+    if (!in->valid)
+    {
+        in->valid = true;
+        in->slot_time = now;
+        alarm_expr_push_history(in, value);
+        return;
+    }
+
+    uint32_t steps = (now - in->slot_time) / ALARM_EXPR_HISTORY_INTERVAL;
+    if (steps == 0)
+    {
+        return;
+    }
+
+    // 缺失的间隔用上一个历史值补齐，保持历史槽等间隔
+    int32_t previous = in->history[(in->head + ALARM_EXPR_HISTORY - 1) % ALARM_EXPR_HISTORY];
+    for (uint32_t k = 1; k < steps && k < ALARM_EXPR_HISTORY; k++)
+    {
+        alarm_expr_push_history(in, previous);
+    }
+    alarm_expr_push_history(in, value);
+    in->slot_time += steps * ALARM_EXPR_HISTORY_INTERVAL;
+}
+
+/**
+ * @brief 编译表达式
+ */
+uint8_t alarm_expr_compile(const char *source, uint8_t *code, uint8_t size, uint8_t *error_pos)
+{
+    alarm_expr_parser_t parser;
+
+    if (!source || !code)
+    {
+        return 0;
+    }
+
+    memset(&parser, 0, sizeof(parser));
+    parser.source = source;
+    parser.code = code;
+    parser.size = size;
+
+    alarm_expr_parse_or(&parser);
+    alarm_expr_emit(&parser, ALARM_EXPR_OP_END, NULL);
+
+    // 表达式后不能有多余内容
+    while (parser.source[parser.pos] == ' ')
+    {
+        parser.pos++;
+    }
+    if (parser.source[parser.pos] != '\0')
+    {
+        alarm_expr_fail(&parser);
+    }
+
+    if (parser.error)
+    {
+        if (error_pos)
+        {
+            *error_pos = parser.error_pos;
+        }
+        return 0;
+    }
+    return parser.length;
+}
+
+/**
+ * @brief 校验字节码
+ */
+bool alarm_expr_verify(const uint8_t *code, uint8_t length)
+{
+    uint8_t pc = 0;
+    uint8_t depth = 0;
+
+    if (!code || length == 0 || length > ALARM_EXPR_MAX_CODE)
+    {
+        return false;
+    }
+
+    while (pc < length)
+    {
+        uint8_t op = code[pc];
+        if (op >= ALARM_EXPR_OP_COUNT || pc + 1 + g_expr_operand_size[op] > length)
+        {
+            return false;
+        }
+        if ((op == ALARM_EXPR_OP_INPUT || (op >= ALARM_EXPR_OP_AVG && op <= ALARM_EXPR_OP_RATE)) &&
+            code[pc + 1] >= ALARM_EXPR_INPUTS)
+        {
+            return false;
+        }
+        if (op == ALARM_EXPR_OP_HOLD && code[pc + 1] >= ALARM_EXPR_MAX_HOLDS)
+        {
+            return false;
+        }
+        if (depth < g_expr_pops[op])
+        {
+            return false;
+        }
+        depth = depth - g_expr_pops[op] + g_expr_pushes[op];
+        if (depth > ALARM_EXPR_STACK)
+        {
+            return false;
+        }
+
+        if (op == ALARM_EXPR_OP_END)
+        {
+            // 结束须是最后一条且栈上只剩结果
+            return (pc + 1 == length && depth == 0);
+        }
+        pc += 1 + g_expr_operand_size[op];
+    }
+    return false;
+}
+
+/**
+ * @brief 装载字节码到表达式槽位
+ */
+bool alarm_expr_load(uint8_t slot, const uint8_t *code, uint8_t length)
+{
+    if (slot >= ALARM_EXPR_MAX_PROGRAMS || !alarm_expr_verify(code, length))
+    {
+        return false;
+    }
+
+    alarm_expr_t *expr = &g_expr_programs[slot];
+    memset(expr, 0, sizeof(alarm_expr_t));
+    memcpy(expr->code, code, length);
+    expr->length = length;
+    return true;
+}
+
+/**
+ * @brief 编译并装载表达式
+ */
+bool alarm_expr_set(uint8_t slot, const char *source)
+{
+    uint8_t code[ALARM_EXPR_MAX_CODE];
+    uint8_t length = alarm_expr_compile(source, code, sizeof(code), NULL);
+
+    return length > 0 && alarm_expr_load(slot, code, length);
+}
+
+/**
+ * @brief 求值表达式
+ */
+bool alarm_expr_evaluate(uint8_t slot, uint32_t now)
+{
+    if (slot >= ALARM_EXPR_MAX_PROGRAMS || g_expr_programs[slot].length == 0)
+    {
+        return false;
+    }
+
+    return alarm_expr_run(&g_expr_programs[slot], now) != 0;
+}
+
+/**
+ * @brief 报警类型对应的输入编号
+ */
+uint8_t alarm_expr_input_for_type(uint8_t type)
+{
+    switch (type)
+    {
+    case ALARM_TYPE_TEMPERATURE:
+        return ALARM_EXPR_INPUT_TEMPERATURE;
+    case ALARM_TYPE_HUMIDITY:
+        return ALARM_EXPR_INPUT_HUMIDITY;
+    case ALARM_TYPE_VOLTAGE:
+        return ALARM_EXPR_INPUT_VOLTAGE;
+    default:
+        return ALARM_EXPR_INPUT_AUX;
+    }
+}
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief 写入一个历史槽
+ */
+static void alarm_expr_push_history(alarm_expr_input_t *in, int32_t value)
+{
+    in->history[in->head] = value;
+    in->head = (uint8_t)((in->head + 1) % ALARM_EXPR_HISTORY);
+    if (in->count < ALARM_EXPR_HISTORY)
+    {
+        in->count++;
+    }
+}
+
+/**
+ * @brief 窗口聚合 (最近seconds秒的历史槽 + 最新值；历史不足时使用已有部分)
+ */
+static int32_t alarm_expr_window(uint8_t op, uint8_t input, uint16_t seconds)
+{
+    const alarm_expr_input_t *in = &g_expr_inputs[input];
+    uint32_t slots = (uint32_t)seconds * 1000UL / ALARM_EXPR_HISTORY_INTERVAL + 1;
+
+    if (slots > in->count)
+    {
+        slots = in->count;
+    }
+
+    if (op == ALARM_EXPR_OP_RATE)
+    {
+        if (slots == 0)
+        {
+            return 0;
+        }
+        int32_t oldest = in->history[(in->head + ALARM_EXPR_HISTORY - slots) % ALARM_EXPR_HISTORY];
+        uint32_t elapsed = in->latest_time - (in->slot_time - (slots - 1) * ALARM_EXPR_HISTORY_INTERVAL);
+        if (elapsed == 0)
+        {
+            return 0;
+        }
+        return (int32_t)((int64_t)(in->latest - oldest) * 60000 / (int64_t)elapsed);
+    }
+
+    int64_t sum = in->latest;
+    int32_t min = in->latest;
+    int32_t max = in->latest;
+    uint8_t index = in->head;
+
+    for (uint32_t k = 0; k < slots; k++)
+    {
+        index = (uint8_t)((index + ALARM_EXPR_HISTORY - 1) % ALARM_EXPR_HISTORY);
+        int32_t value = in->history[index];
+        sum += value;
+        if (value < min)
+        {
+            min = value;
+        }
+        if (value > max)
+        {
+            max = value;
+        }
+    }
+
+    if (op == ALARM_EXPR_OP_MIN)
+    {
+        return min;
+    }
+    if (op == ALARM_EXPR_OP_MAX)
+    {
+        return max;
+    }
+    return (int32_t)(sum / (int64_t)(slots + 1));
+}
+
+/**
+ * @brief 解释执行 (字节码已校验)
+ */
+static int32_t alarm_expr_run(alarm_expr_t *expr, uint32_t now)
+{
+    int32_t stack[ALARM_EXPR_STACK];
+    int32_t *sp = stack;
+    const uint8_t *pc = expr->code;
+
+    for (;;)
+    {
+        uint8_t op = *pc++;
+
+        switch (op)
+        {
+        case ALARM_EXPR_OP_END:
+            return sp[-1];
+        case ALARM_EXPR_OP_CONST:
+            *sp++ = (int32_t)((uint32_t)pc[0] | ((uint32_t)pc[1] << 8) | ((uint32_t)pc[2] << 16) |
+                              ((uint32_t)pc[3] << 24));
+            pc += 4;
+            break;
+        case ALARM_EXPR_OP_INPUT:
+            *sp++ = g_expr_inputs[*pc++].latest;
+            break;
+        case ALARM_EXPR_OP_AVG:
+        case ALARM_EXPR_OP_MIN:
+        case ALARM_EXPR_OP_MAX:
+        case ALARM_EXPR_OP_RATE:
+            *sp++ = alarm_expr_window(op, pc[0], (uint16_t)(pc[1] | (pc[2] << 8)));
+            pc += 3;
+            break;
+        case ALARM_EXPR_OP_ADD:
+            sp--;
+            sp[-1] += sp[0];
+            break;
+        case ALARM_EXPR_OP_SUB:
+            sp--;
+            sp[-1] -= sp[0];
+            break;
+        case ALARM_EXPR_OP_GT:
+            sp--;
+            sp[-1] = sp[-1] > sp[0];
+            break;
+        case ALARM_EXPR_OP_LT:
+            sp--;
+            sp[-1] = sp[-1] < sp[0];
+            break;
+        case ALARM_EXPR_OP_GE:
+            sp--;
+            sp[-1] = sp[-1] >= sp[0];
+            break;
+        case ALARM_EXPR_OP_LE:
+            sp--;
+            sp[-1] = sp[-1] <= sp[0];
+            break;
+        case ALARM_EXPR_OP_EQ:
+            sp--;
+            sp[-1] = sp[-1] == sp[0];
+            break;
+        case ALARM_EXPR_OP_NE:
+            sp--;
+            sp[-1] = sp[-1] != sp[0];
+            break;
+        case ALARM_EXPR_OP_AND:
+            sp--;
+            sp[-1] = sp[-1] && sp[0];
+            break;
+        case ALARM_EXPR_OP_OR:
+            sp--;
+            sp[-1] = sp[-1] || sp[0];
+            break;
+        case ALARM_EXPR_OP_NOT:
+            sp[-1] = !sp[-1];
+            break;
+        case ALARM_EXPR_OP_HOLD:
+        {
+            uint8_t bit = (uint8_t)(1U << pc[0]);
+            uint32_t hold_ms = (uint32_t)(pc[1] | (pc[2] << 8)) * 1000UL;
+
+            if (!sp[-1])
+            {
+                expr->hold_active &= (uint8_t)~bit;
+            }
+            else
+            {
+                if (!(expr->hold_active & bit))
+                {
+                    expr->hold_active |= bit;
+                    expr->hold_since[pc[0]] = now;
+                }
+                sp[-1] = (now - expr->hold_since[pc[0]]) >= hold_ms;
+            }
+            pc += 3;
+            break;
+        }
+        default:
+            return 0;
+        }
+    }
+}
+
+/**
+ * @brief or := and { "||" and }
+ */
+static void alarm_expr_parse_or(alarm_expr_parser_t *p)
+{
+    alarm_expr_parse_and(p);
+    while (!p->error && alarm_expr_accept(p, "||"))
+    {
+        alarm_expr_parse_and(p);
+        alarm_expr_emit(p, ALARM_EXPR_OP_OR, NULL);
+    }
+}
+
+/**
+ * @brief and := not { "&&" not }
+ */
+static void alarm_expr_parse_and(alarm_expr_parser_t *p)
+{
+    alarm_expr_parse_not(p);
+    while (!p->error && alarm_expr_accept(p, "&&"))
+    {
+        alarm_expr_parse_not(p);
+        alarm_expr_emit(p, ALARM_EXPR_OP_AND, NULL);
+    }
+}
+
+/**
+ * @brief not := "!" not | compare
+ */
+static void alarm_expr_parse_not(alarm_expr_parser_t *p)
+{
+    if (alarm_expr_accept(p, "!"))
+    {
+        alarm_expr_parse_not(p);
+        alarm_expr_emit(p, ALARM_EXPR_OP_NOT, NULL);
+        return;
+    }
+    alarm_expr_parse_compare(p);
+}
+
+/**
+ * @brief compare := sum [ 比较运算符 sum ]
+ */
+static void alarm_expr_parse_compare(alarm_expr_parser_t *p)
+{
+    // 双字符运算符须先于单字符匹配
+    static const char *const tokens[] = {">=", "<=", "==", "!=", ">", "<"};
+    static const uint8_t ops[] = {ALARM_EXPR_OP_GE, ALARM_EXPR_OP_LE, ALARM_EXPR_OP_EQ,
+                                  ALARM_EXPR_OP_NE, ALARM_EXPR_OP_GT, ALARM_EXPR_OP_LT};
+
+    alarm_expr_parse_sum(p);
+    for (uint8_t i = 0; i < sizeof(ops) && !p->error; i++)
+    {
+        if (alarm_expr_accept(p, tokens[i]))
+        {
+            alarm_expr_parse_sum(p);
+            alarm_expr_emit(p, ops[i], NULL);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief sum := term { ("+" | "-") term }
+ */
+static void alarm_expr_parse_sum(alarm_expr_parser_t *p)
+{
+    alarm_expr_parse_term(p);
+    while (!p->error)
+    {
+        if (alarm_expr_accept(p, "+"))
+        {
+            alarm_expr_parse_term(p);
+            alarm_expr_emit(p, ALARM_EXPR_OP_ADD, NULL);
+        }
+        else if (alarm_expr_accept(p, "-"))
+        {
+            alarm_expr_parse_term(p);
+            alarm_expr_emit(p, ALARM_EXPR_OP_SUB, NULL);
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief term := 数字 | 输入 | 窗口函数(输入, 秒) | for(or, 秒) | "(" or ")"
+ */
+static void alarm_expr_parse_term(alarm_expr_parser_t *p)
+{
+    uint8_t operand[4] = {0};
+    uint8_t value;
+    int32_t number = 0;
+
+    if (p->error)
+    {
+        return;
+    }
+
+    if (alarm_expr_accept(p, "("))
+    {
+        alarm_expr_parse_or(p);
+        alarm_expr_expect(p, ")");
+        return;
+    }
+
+    if (alarm_expr_number(p, &number))
+    {
+        operand[0] = (uint8_t)number;
+        operand[1] = (uint8_t)(number >> 8);
+        operand[2] = (uint8_t)(number >> 16);
+        operand[3] = (uint8_t)(number >> 24);
+        alarm_expr_emit(p, ALARM_EXPR_OP_CONST, operand);
+        return;
+    }
+
+    if (alarm_expr_name(p, g_expr_inputs_names, sizeof(g_expr_inputs_names) / sizeof(g_expr_inputs_names[0]),
+                        &value))
+    {
+        alarm_expr_emit(p, ALARM_EXPR_OP_INPUT, &value);
+        return;
+    }
+
+    uint8_t op;
+    if (alarm_expr_name(p, g_expr_window_names, sizeof(g_expr_window_names) / sizeof(g_expr_window_names[0]), &op))
+    {
+        // 窗口函数: 第一个参数须为输入名
+        alarm_expr_expect(p, "(");
+        if (!p->error && !alarm_expr_name(p, g_expr_inputs_names,
+                                          sizeof(g_expr_inputs_names) / sizeof(g_expr_inputs_names[0]), &operand[0]))
+        {
+            alarm_expr_fail(p);
+        }
+    }
+    else if (alarm_expr_accept(p, "for"))
+    {
+        // 持续条件: 分配一个持续槽
+        op = ALARM_EXPR_OP_HOLD;
+        alarm_expr_expect(p, "(");
+        alarm_expr_parse_or(p);
+        if (p->holds >= ALARM_EXPR_MAX_HOLDS)
+        {
+            alarm_expr_fail(p);
+        }
+        operand[0] = p->holds++;
+    }
+    else
+    {
+        alarm_expr_fail(p);
+        return;
+    }
+
+    alarm_expr_expect(p, ",");
+    if (!p->error && (!alarm_expr_number(p, &number) || number < 0 || number > 0xFFFF))
+    {
+        alarm_expr_fail(p);
+    }
+    alarm_expr_expect(p, ")");
+    operand[1] = (uint8_t)number;
+    operand[2] = (uint8_t)(number >> 8);
+    alarm_expr_emit(p, op, operand);
+}
+
+/**
+ * @brief 输出一条指令并更新栈深度
+ */
+static void alarm_expr_emit(alarm_expr_parser_t *p, uint8_t op, const uint8_t *operand)
+{
+    uint8_t size = g_expr_operand_size[op];
+
+    if (p->error)
+    {
+        return;
+    }
+    if (p->length + 1 + size > p->size || p->length + 1 + size > ALARM_EXPR_MAX_CODE)
+    {
+        alarm_expr_fail(p);
+        return;
+    }
+
+    p->code[p->length++] = op;
+    for (uint8_t i = 0; i < size; i++)
+    {
+        p->code[p->length++] = operand[i];
+    }
+
+    p->depth = p->depth - g_expr_pops[op] + g_expr_pushes[op];
+    if (p->depth > p->max_depth)
+    {
+        p->max_depth = p->depth;
+    }
+    if (p->max_depth > ALARM_EXPR_STACK)
+    {
+        alarm_expr_fail(p);
+    }
+}
+
+/**
+ * @brief 跳过空格并匹配记号
+ */
+static bool alarm_expr_accept(alarm_expr_parser_t *p, const char *token)
+{
+    uint8_t len = (uint8_t)strlen(token);
+
+    while (p->source[p->pos] == ' ')
+    {
+        p->pos++;
+    }
+    if (strncmp(&p->source[p->pos], token, len) != 0)
+    {
+        return false;
+    }
+
+    // 名称记号须完整匹配 (例如"for"不匹配"form")
+    char next = p->source[p->pos + len];
+    if (token[0] >= 'a' && token[0] <= 'z' && ((next >= 'a' && next <= 'z') || (next >= '0' && next <= '9')))
+    {
+        return false;
+    }
+
+    p->pos += len;
+    return true;
+}
+
+/**
+ * @brief 匹配必需的记号，不匹配时报错
+ */
+static void alarm_expr_expect(alarm_expr_parser_t *p, const char *token)
+{
+    if (!p->error && !alarm_expr_accept(p, token))
+    {
+        alarm_expr_fail(p);
+    }
+}
+
+/**
+ * @brief 解析整数 (可带负号)
+ */
+static bool alarm_expr_number(alarm_expr_parser_t *p, int32_t *value)
+{
+    uint8_t pos = p->pos;
+    bool negative = false;
+    int64_t result = 0;
+
+    while (p->source[pos] == ' ')
+    {
+        pos++;
+    }
+    if (p->source[pos] == '-')
+    {
+        negative = true;
+        pos++;
+    }
+    if (p->source[pos] < '0' || p->source[pos] > '9')
+    {
+        return false;
+    }
+
+    while (p->source[pos] >= '0' && p->source[pos] <= '9')
+    {
+        result = result * 10 + (p->source[pos] - '0');
+        if (result > 0x7FFFFFFFLL)
+        {
+            p->pos = pos;
+            alarm_expr_fail(p);
+            return false;
+        }
+        pos++;
+    }
+
+    p->pos = pos;
+    *value = (int32_t)(negative ? -result : result);
+    return true;
+}
+
+/**
+ * @brief 匹配名称表中的名称
+ */
+static bool alarm_expr_name(alarm_expr_parser_t *p, const alarm_expr_name_t *names, uint8_t count, uint8_t *value)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (alarm_expr_accept(p, names[i].name))
+        {
+            *value = names[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 记录第一个错误的位置
+ */
+static void alarm_expr_fail(alarm_expr_parser_t *p)
+{
+    if (!p->error)
+    {
+        p->error = true;
+        p->error_pos = p->pos;
+    }
+}
@@ -0,0 +1,370 @@
+/**
+ * @file alarm_notify.c
+ * @brief 憨云DTU报警通知合并与限速实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include "alarm_notify.h"
+#include "system.h"
+#include <string.h>
+
+// ============================================================================
+// 内部数据结构
+// ============================================================================
+
+/**
+ * @brief 批次条目 (窗口内同一规则的变化合并为一条)
+ */
+typedef struct
+{
+    uint8_t rule_id;     // 规则ID
+    uint8_t type;        // 报警类型
+    uint8_t level;       // 报警级别
+    uint8_t state;       // 最新状态
+    uint8_t transitions; // 窗口内变化次数
+    int32_t value;       // 最新值
+    uint32_t timestamp;  // 最新变化时刻
+} alarm_notify_entry_t;
+
+/**
+ * @brief 令牌桶
+ */
+typedef struct
+{
+    uint8_t tokens;       // 当前令牌数
+    uint8_t capacity;     // 桶容量
+    uint32_t refill_ms;   // 补充间隔
+    uint32_t last_refill; // 上次补充时刻
+} alarm_notify_bucket_t;
+
+/**
+ * @brief 通知控制块
+ */
+typedef struct
+{
+    alarm_notify_sink_t sinks[ALARM_NOTIFY_MAX_SINKS]; // 上行通道
+    uint8_t sink_count;                                // 通道数
+
+    alarm_notify_bucket_t buckets[ALARM_LEVEL_CRITICAL]; // 各级别令牌桶 (严重级别不限速)
+
+    alarm_notify_entry_t batch[ALARM_NOTIFY_BATCH_MAX]; // 当前批次
+    uint8_t count;                                      // 批次条目数
+    bool window_open;                                   // 合并窗口已打开
+    uint32_t window_start;                              // 窗口开始时刻 (帧基准时刻)
+    uint8_t sequence;                                   // 批次序号
+    uint8_t suppressed;                                 // 上一批以来的限速丢弃数 (饱和)
+
+    uint8_t frame[ALARM_NOTIFY_MAX_FRAME]; // 帧缓冲区 (各通道共用)
+    alarm_notify_stats_t stats;            // 统计
+} alarm_notify_control_t;
+
+static alarm_notify_control_t g_notify;
+
+// 默认限速: 容量 / 补充间隔
+static const uint8_t g_notify_default_capacity[ALARM_LEVEL_CRITICAL] = {2, 4, 8};
+static const uint32_t g_notify_default_refill[ALARM_LEVEL_CRITICAL] = {60000, 30000, 10000};
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static bool alarm_notify_take_token(uint8_t level, uint32_t now);
+static uint16_t alarm_notify_encode(uint8_t first, uint8_t count);
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+/**
+ * @brief 初始化
+ */
+void alarm_notify_init(void)
+{
+    uint32_t now = system_get_tick();
+
+    memset(&g_notify, 0, sizeof(g_notify));
+    for (uint8_t level = 0; level < ALARM_LEVEL_CRITICAL; level++)
+    {
+        g_notify.buckets[level].capacity = g_notify_default_capacity[level];
+        g_notify.buckets[level].tokens = g_notify_default_capacity[level];
+        g_notify.buckets[level].refill_ms = g_notify_default_refill[level];
+        g_notify.buckets[level].last_refill = now;
+    }
+}
+
+/**
+ * @brief 注册上行通道
+ */
+bool alarm_notify_add_sink(const alarm_notify_sink_t *sink)
+{
+    if (!sink || !sink->send || sink->mtu < ALARM_NOTIFY_MIN_MTU)
+    {
+        return false;
+    }
+
+    // 同一通道重复注册 (如重连后) 只更新参数
+    for (uint8_t s = 0; s < g_notify.sink_count; s++)
+    {
+        if (g_notify.sinks[s].send == sink->send && g_notify.sinks[s].context == sink->context)
+        {
+            g_notify.sinks[s] = *sink;
+            return true;
+        }
+    }
+    if (g_notify.sink_count >= ALARM_NOTIFY_MAX_SINKS)
+    {
+        return false;
+    }
+
+    g_notify.sinks[g_notify.sink_count++] = *sink;
+    return true;
+}
+
+/**
+ * @brief 设置某级别的令牌桶
+ */
+bool alarm_notify_set_limit(uint8_t level, uint8_t capacity, uint32_t refill_ms)
+{
+    if (level >= ALARM_LEVEL_CRITICAL || capacity == 0 || refill_ms == 0)
+    {
+        return false;
+    }
+
+    alarm_notify_bucket_t *bucket = &g_notify.buckets[level];
+    bucket->capacity = capacity;
+    bucket->tokens = capacity;
+    bucket->refill_ms = refill_ms;
+    bucket->last_refill = system_get_tick();
+    return true;
+}
+
+/**
+ * @brief 提交一次报警状态变化
+ */
+void alarm_notify_post(const alarm_history_t *event)
+{
+    uint32_t now = system_get_tick();
+    alarm_notify_entry_t *entry = NULL;
+
+    if (!event)
+    {
+        return;
+    }
+    g_notify.stats.posted++;
+
+    // 窗口内同一规则的变化合并
+    for (uint8_t i = 0; i < g_notify.count; i++)
+    {
+        if (g_notify.batch[i].rule_id == event->rule_id && g_notify.batch[i].type == event->type)
+        {
+            entry = &g_notify.batch[i];
+            if (entry->transitions < 0xFF)
+            {
+                entry->transitions++;
+            }
+            g_notify.stats.coalesced++;
+            break;
+        }
+    }
+
+    if (!entry)
+    {
+        // 新条目消耗令牌，严重级别不限速
+        if (event->level < ALARM_LEVEL_CRITICAL && !alarm_notify_take_token(event->level, now))
+        {
+            g_notify.stats.suppressed++;
+            if (g_notify.suppressed < 0xFF)
+            {
+                g_notify.suppressed++;
+            }
+            return;
+        }
+
+        if (!g_notify.window_open)
+        {
+            g_notify.window_open = true;
+            g_notify.window_start = now;
+        }
+        entry = &g_notify.batch[g_notify.count++];
+        entry->rule_id = event->rule_id;
+        entry->type = event->type;
+        entry->transitions = 1;
+    }
+
+    entry->level = event->level;
+    entry->state = event->state;
+    entry->value = event->value;
+    entry->timestamp = event->timestamp;
+
+    if (event->level >= ALARM_LEVEL_CRITICAL)
+    {
+        g_notify.stats.immediate++;
+        alarm_notify_flush();
+    }
+    else if (g_notify.count >= ALARM_NOTIFY_BATCH_MAX)
+    {
+        alarm_notify_flush();
+    }
+}
+
+/**
+ * @brief 后台任务: 窗口到期时发出批次
+ */
+void alarm_notify_task(void)
+{
+    if (g_notify.window_open && (system_get_tick() - g_notify.window_start) >= ALARM_NOTIFY_WINDOW_MS)
+    {
+        alarm_notify_flush();
+    }
+}
+
+/**
+ * @brief 立即发出当前批次
+ */
+void alarm_notify_flush(void)
+{
+    if (g_notify.count == 0)
+    {
+        g_notify.window_open = false;
+        return;
+    }
+
+    // 同一批次送往全部通道，按各通道MTU分帧
+    for (uint8_t s = 0; s < g_notify.sink_count; s++)
+    {
+        const alarm_notify_sink_t *sink = &g_notify.sinks[s];
+        uint8_t per_frame = (uint8_t)((sink->mtu - ALARM_NOTIFY_HEADER_SIZE) / ALARM_NOTIFY_ENTRY_SIZE);
+
+        if (per_frame > ALARM_NOTIFY_BATCH_MAX)
+        {
+            per_frame = ALARM_NOTIFY_BATCH_MAX;
+        }
+
+        for (uint8_t first = 0; first < g_notify.count; first = (uint8_t)(first + per_frame))
+        {
+            uint8_t count = (uint8_t)(g_notify.count - first);
+            if (count > per_frame)
+            {
+                count = per_frame;
+            }
+
+            uint16_t length = alarm_notify_encode(first, count);
+            if (sink->send(g_notify.frame, length, sink->context))
+            {
+                g_notify.stats.frames++;
+                g_notify.stats.bytes += length;
+            }
+            else
+            {
+                g_notify.stats.send_errors++;
+            }
+        }
+    }
+
+    g_notify.stats.batches++;
+    g_notify.sequence++;
+    g_notify.suppressed = 0;
+    g_notify.count = 0;
+    g_notify.window_open = false;
+}
+
+/**
+ * @brief 获取通知统计
+ */
+bool alarm_notify_get_stats(alarm_notify_stats_t *stats)
+{
+    if (!stats)
+    {
+        return false;
+    }
+
+    *stats = g_notify.stats;
+    return true;
+}
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief 补充并消耗一个令牌
+ */
+static bool alarm_notify_take_token(uint8_t level, uint32_t now)
+{
+    alarm_notify_bucket_t *bucket = &g_notify.buckets[level];
+    uint32_t refills = (now - bucket->last_refill) / bucket->refill_ms;
+
+    if (refills > 0)
+    {
+        if (bucket->tokens + refills >= bucket->capacity)
+        {
+            bucket->tokens = bucket->capacity;
+            bucket->last_refill = now;
+        }
+        else
+        {
+            bucket->tokens = (uint8_t)(bucket->tokens + refills);
+            bucket->last_refill += refills * bucket->refill_ms;
+        }
+    }
+
+    if (bucket->tokens == 0)
+    {
+        return false;
+    }
+    bucket->tokens--;
+    return true;
+}
+
+/**
+ * @brief 编码一帧 (批次中从first开始的count个条目)
+ * @return 帧长度
+ */
+static uint16_t alarm_notify_encode(uint8_t first, uint8_t count)
+{
+    uint8_t *p = g_notify.frame;
+
+    p[0] = ALARM_NOTIFY_VERSION;
+    p[1] = g_notify.sequence;
+    p[2] = count;
+    p[3] = g_notify.suppressed;
+    p[4] = (uint8_t)g_notify.window_start;
+    p[5] = (uint8_t)(g_notify.window_start >> 8);
+    p[6] = (uint8_t)(g_notify.window_start >> 16);
+    p[7] = (uint8_t)(g_notify.window_start >> 24);
+    p += ALARM_NOTIFY_HEADER_SIZE;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const alarm_notify_entry_t *entry = &g_notify.batch[first + i];
+        int32_t value = entry->value;
+        uint32_t offset = entry->timestamp - g_notify.window_start;
+
+        // 值与时刻偏移按16位饱和
+        if (value > 32767)
+        {
+            value = 32767;
+        }
+        else if (value < -32768)
+        {
+            value = -32768;
+        }
+        if (offset > 0xFFFF)
+        {
+            offset = 0xFFFF;
+        }
+
+        p[0] = entry->rule_id;
+        p[1] = entry->type;
+        p[2] = (uint8_t)((entry->level << 4) | (entry->state & 0x0F));
+        p[3] = entry->transitions;
+        p[4] = (uint8_t)value;
+        p[5] = (uint8_t)((uint16_t)value >> 8);
+        p[6] = (uint8_t)offset;
+        p[7] = (uint8_t)(offset >> 8);
+        p += ALARM_NOTIFY_ENTRY_SIZE;
+    }
+
+    return (uint16_t)(ALARM_NOTIFY_HEADER_SIZE + count * ALARM_NOTIFY_ENTRY_SIZE);
+}
@@ -0,0 +1,55 @@
+/**
+ * @file alarm_notify_adapter.c
+ * @brief 憨云DTU报警通知的上行通道适配实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include "alarm_notify_adapter.h"
+#include "mqtt.h"
+#include <string.h>
+
+// ============================================================================
+// 内部数据结构
+// ============================================================================
+
+static char g_notify_mqtt_topic[MQTT_MAX_TOPIC_LEN]; // MQTT发布主题
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static bool alarm_notify_mqtt_send(const uint8_t *frame, uint16_t length, void *context);
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+/**
+ * @brief 注册MQTT通道
+ */
+bool alarm_notify_attach_mqtt(const char *topic)
+{
+    alarm_notify_sink_t sink = {alarm_notify_mqtt_send, NULL, ALARM_NOTIFY_MQTT_MTU};
+
+    if (!topic || strlen(topic) >= sizeof(g_notify_mqtt_topic))
+    {
+        return false;
+    }
+
+    strcpy(g_notify_mqtt_topic, topic);
+    return alarm_notify_add_sink(&sink);
+}
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief MQTT发布 (QoS1)
+ */
+static bool alarm_notify_mqtt_send(const uint8_t *frame, uint16_t length, void *context)
+{
+    (void)context;
+    return mqtt_publish(g_notify_mqtt_topic, frame, length, MQTT_QOS_1, false) == MQTT_SUCCESS;
+}
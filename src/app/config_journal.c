@@ -0,0 +1,504 @@
+/**
+ * @file config_journal.c
+ * @brief 憨云DTU A/B双bank日志式配置存储实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 写入顺序保证任意时刻掉电都能恢复到某次完整提交:
+ * - 改写快照: 擦除另一bank -> 编程快照 -> 编程bank头 (提交点)，旧bank直到下次改写快照才被擦除
+ * - 差分记录: 记录头与段数据一次编程，按地址递增写入，撕裂时CRC不符
+ * 挂载时差分记录回放到第一条空闲/损坏记录为止；遇到损坏记录时视当前bank已满
+ * 备用bank (无有效bank时为bank 1) 的已擦除页数只在RAM中维护，挂载时按页检查空白恢复
+ */
+
+#include "config_journal.h"
+#include "flash.h"
+#include "storage.h"
+#include "system.h"
+#include <stddef.h>
+#include <string.h>
+
+// ============================================================================
+// 内部数据结构
+// ============================================================================
+
+#define CONFIG_JOURNAL_ALIGN(n) (((n) + (FLASH_PROGRAM_UNIT - 1)) & ~(uint32_t)(FLASH_PROGRAM_UNIT - 1))
+#define CONFIG_JOURNAL_SEGMENT_GAP 2 // 两处改动间隔不超过段头长度时合并为一段
+
+/**
+ * @brief 差分记录缓冲 (记录头 + 段数据)
+ */
+typedef struct
+{
+    config_journal_delta_t header;                // 记录头
+    uint8_t segments[CONFIG_JOURNAL_MAX_DELTA];    // 段数据
+} config_journal_record_t;
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static uint32_t config_journal_bank_addr(const config_journal_t *journal, uint8_t bank);
+static bool config_journal_read_bank(const config_journal_t *journal, uint8_t bank, config_journal_bank_t *header);
+static uint16_t config_journal_data_start(const config_journal_t *journal);
+static void config_journal_replay(config_journal_t *journal, uint8_t *data);
+static uint16_t config_journal_build_delta(const config_journal_t *journal, const uint8_t *current,
+                                           const uint8_t *data, config_journal_record_t *record);
+static bool config_journal_append_delta(config_journal_t *journal, const config_journal_record_t *record,
+                                        uint16_t length);
+static bool config_journal_write_snapshot(config_journal_t *journal, const uint8_t *data);
+static bool config_journal_erase_bank(config_journal_t *journal, uint8_t bank, uint8_t first_page);
+static uint8_t config_journal_spare_bank(const config_journal_t *journal);
+static uint8_t config_journal_count_blank_pages(const config_journal_t *journal, uint8_t bank);
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+/**
+ * @brief 挂载配置存储并恢复最新配置
+ */
+bool config_journal_mount(config_journal_t *journal, uint32_t base, uint16_t bank_size, void *data,
+                          uint16_t size)
+{
+    config_journal_bank_t header;
+    bool found = false;
+
+    if (!journal || !data || size == 0 || size > CONFIG_JOURNAL_MAX_SIZE || bank_size == 0 ||
+        (bank_size % FLASH_PAGE_SIZE) != 0 || (base % FLASH_PAGE_SIZE) != 0 ||
+        CONFIG_JOURNAL_ALIGN(sizeof(config_journal_bank_t) + size) >= bank_size)
+    {
+        return false;
+    }
+
+    memset(journal, 0, sizeof(config_journal_t));
+    journal->base = base;
+    journal->bank_size = bank_size;
+    journal->size = size;
+    journal->offset = bank_size;
+
+    // 选择序号最大的有效bank (序号按回绕比较)
+    for (uint8_t bank = 0; bank < CONFIG_JOURNAL_BANKS; bank++)
+    {
+        if (config_journal_read_bank(journal, bank, &header) &&
+            (!found || (int32_t)(header.sequence - journal->sequence) > 0))
+        {
+            journal->active = bank;
+            journal->sequence = header.sequence;
+            found = true;
+        }
+    }
+
+    journal->valid = found;
+    journal->spare_erased = config_journal_count_blank_pages(journal, config_journal_spare_bank(journal));
+    if (!found)
+    {
+        debug_printf("[CFGJ] No valid bank at 0x%08lX\n", (unsigned long)base);
+        return false;
+    }
+
+    // 读取快照并回放差分记录
+    if (!flash_read(config_journal_bank_addr(journal, journal->active) + sizeof(config_journal_bank_t),
+                    (uint8_t *)data, size))
+    {
+        journal->valid = false;
+        return false;
+    }
+    config_journal_replay(journal, (uint8_t *)data);
+
+    debug_printf("[CFGJ] Mounted bank %d: seq=%lu offset=%d\n", journal->active,
+                 (unsigned long)journal->sequence, journal->offset);
+    return true;
+}
+
+/**
+ * @brief 提交新配置
+ */
+bool config_journal_commit(config_journal_t *journal, const void *current, const void *data)
+{
+    config_journal_record_t record;
+
+    if (!journal || journal->size == 0 || !data)
+    {
+        return false;
+    }
+
+    if (journal->valid && current)
+    {
+        if (memcmp(current, data, journal->size) == 0)
+        {
+            return true;
+        }
+
+        // 改动可放入当前bank时追加差分记录，编程失败时改写快照
+        uint16_t length = config_journal_build_delta(journal, (const uint8_t *)current, (const uint8_t *)data,
+                                                     &record);
+        if (length && config_journal_append_delta(journal, &record, length))
+        {
+            journal->stats.commits++;
+            journal->stats.deltas++;
+            return true;
+        }
+    }
+
+    if (!config_journal_write_snapshot(journal, (const uint8_t *)data))
+    {
+        return false;
+    }
+
+    journal->stats.commits++;
+    journal->stats.snapshots++;
+    return true;
+}
+
+/**
+ * @brief 执行一步后台维护
+ */
+bool config_journal_maintain(config_journal_t *journal)
+{
+    if (!journal || journal->size == 0 || journal->spare_erased >= journal->bank_size / FLASH_PAGE_SIZE)
+    {
+        return false;
+    }
+
+    uint32_t address = config_journal_bank_addr(journal, config_journal_spare_bank(journal)) +
+                       (uint32_t)journal->spare_erased * FLASH_PAGE_SIZE;
+    if (!flash_erase_page(address))
+    {
+        // 该页留待改写快照时同步擦除
+        journal->stats.write_errors++;
+        return false;
+    }
+
+    journal->stats.erases++;
+    journal->spare_erased++;
+    return true;
+}
+
+/**
+ * @brief 擦除两个bank
+ */
+bool config_journal_format(config_journal_t *journal)
+{
+    if (!journal || journal->size == 0)
+    {
+        return false;
+    }
+
+    journal->valid = false;
+    journal->offset = journal->bank_size;
+    journal->spare_erased = 0;
+    for (uint8_t bank = 0; bank < CONFIG_JOURNAL_BANKS; bank++)
+    {
+        if (!config_journal_erase_bank(journal, bank, 0))
+        {
+            return false;
+        }
+    }
+    journal->spare_erased = (uint8_t)(journal->bank_size / FLASH_PAGE_SIZE);
+    return true;
+}
+
+/**
+ * @brief 获取当前bank剩余可追加字节数
+ */
+uint16_t config_journal_get_free_space(const config_journal_t *journal)
+{
+    if (!journal || !journal->valid)
+    {
+        return 0;
+    }
+    return journal->bank_size - journal->offset;
+}
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief bank起始地址
+ */
+static uint32_t config_journal_bank_addr(const config_journal_t *journal, uint8_t bank)
+{
+    return journal->base + (uint32_t)bank * journal->bank_size;
+}
+
+/**
+ * @brief 读取并校验bank头与快照
+ * @return true: bank有效且快照长度与实例一致
+ */
+static bool config_journal_read_bank(const config_journal_t *journal, uint8_t bank, config_journal_bank_t *header)
+{
+    uint32_t address = config_journal_bank_addr(journal, bank);
+    uint8_t buffer[32];
+
+    if (!flash_read(address, (uint8_t *)header, sizeof(config_journal_bank_t)) ||
+        header->magic != CONFIG_JOURNAL_MAGIC || header->size != journal->size)
+    {
+        return false;
+    }
+
+    // 快照分块计算CRC，不占用整块缓冲区
+    uint16_t crc = storage_crc16_update(0xFFFF, (const uint8_t *)&header->sequence,
+                                        offsetof(config_journal_bank_t, crc16) - offsetof(config_journal_bank_t, sequence));
+    for (uint16_t offset = 0; offset < header->size; offset += sizeof(buffer))
+    {
+        uint16_t chunk = (uint16_t)(header->size - offset);
+        if (chunk > sizeof(buffer))
+        {
+            chunk = sizeof(buffer);
+        }
+        if (!flash_read(address + sizeof(config_journal_bank_t) + offset, buffer, chunk))
+        {
+            return false;
+        }
+        crc = storage_crc16_update(crc, buffer, chunk);
+    }
+
+    return crc == header->crc16;
+}
+
+/**
+ * @brief 快照之后第一条差分记录的偏移
+ */
+static uint16_t config_journal_data_start(const config_journal_t *journal)
+{
+    return (uint16_t)CONFIG_JOURNAL_ALIGN(sizeof(config_journal_bank_t) + journal->size);
+}
+
+/**
+ * @brief 回放当前bank的差分记录，恢复追加偏移
+ */
+static void config_journal_replay(config_journal_t *journal, uint8_t *data)
+{
+    uint32_t address = config_journal_bank_addr(journal, journal->active);
+    config_journal_record_t record;
+
+    journal->offset = config_journal_data_start(journal);
+    while (true)
+    {
+        // bank恰好写满
+        if (journal->offset + sizeof(config_journal_delta_t) > journal->bank_size)
+        {
+            journal->offset = journal->bank_size;
+            return;
+        }
+        if (!flash_read(address + journal->offset, (uint8_t *)&record.header, sizeof(config_journal_delta_t)))
+        {
+            break;
+        }
+        if (record.header.length == 0xFFFF && record.header.crc16 == 0xFFFF)
+        {
+            return;
+        }
+
+        uint16_t length = record.header.length;
+        uint16_t size = (uint16_t)CONFIG_JOURNAL_ALIGN(sizeof(config_journal_delta_t) + length);
+        bool valid = length > 0 && length <= CONFIG_JOURNAL_MAX_DELTA && journal->offset + size <= journal->bank_size &&
+                     flash_read(address + journal->offset + sizeof(config_journal_delta_t), record.segments, length);
+        if (valid)
+        {
+            uint16_t crc = storage_crc16_update(0xFFFF, (const uint8_t *)&record.header.length,
+                                                sizeof(record.header.length));
+            valid = storage_crc16_update(crc, record.segments, length) == record.header.crc16;
+        }
+
+        // 段越界也视为损坏 (整条记录不生效)
+        uint16_t i = 0;
+        while (valid && i < length)
+        {
+            valid = i + 2 <= length && i + 2 + record.segments[i + 1] <= length &&
+                    record.segments[i] + record.segments[i + 1] <= journal->size;
+            i += valid ? 2 + record.segments[i + 1] : 0;
+        }
+        if (!valid)
+        {
+            break;
+        }
+
+        for (i = 0; i < length; i += 2 + record.segments[i + 1])
+        {
+            memcpy(&data[record.segments[i]], &record.segments[i + 2], record.segments[i + 1]);
+        }
+        journal->offset += size;
+    }
+
+    // 撕裂/损坏的记录之后不再追加，下一次提交改写快照
+    debug_printf("[CFGJ] Torn delta at offset %d, bank %d closed\n", journal->offset, journal->active);
+    journal->stats.crc_errors++;
+    journal->offset = journal->bank_size;
+}
+
+/**
+ * @brief 生成差分记录 (相邻改动合并为一段)
+ * @return 记录段数据长度，0表示改动过大
+ */
+static uint16_t config_journal_build_delta(const config_journal_t *journal, const uint8_t *current,
+                                           const uint8_t *data, config_journal_record_t *record)
+{
+    uint16_t length = 0;
+    uint16_t i = 0;
+
+    while (i < journal->size)
+    {
+        if (current[i] == data[i])
+        {
+            i++;
+            continue;
+        }
+
+        // 段延伸到最后一处改动，间隔不超过段头长度的相同字节一并写入
+        uint16_t start = i, end = i + 1;
+        for (uint16_t j = end; j < journal->size && j <= end + CONFIG_JOURNAL_SEGMENT_GAP; j++)
+        {
+            if (current[j] != data[j])
+            {
+                end = j + 1;
+            }
+        }
+
+        uint16_t span = end - start;
+        if (length + 2 + span > CONFIG_JOURNAL_MAX_DELTA)
+        {
+            return 0;
+        }
+        record->segments[length++] = (uint8_t)start;
+        record->segments[length++] = (uint8_t)span;
+        memcpy(&record->segments[length], &data[start], span);
+        length += span;
+        i = end;
+    }
+
+    record->header.length = length;
+    uint16_t crc = storage_crc16_update(0xFFFF, (const uint8_t *)&record->header.length,
+                                        sizeof(record->header.length));
+    record->header.crc16 = storage_crc16_update(crc, record->segments, length);
+    return length;
+}
+
+/**
+ * @brief 在当前bank追加差分记录
+ */
+static bool config_journal_append_delta(config_journal_t *journal, const config_journal_record_t *record,
+                                        uint16_t length)
+{
+    uint16_t size = (uint16_t)(sizeof(config_journal_delta_t) + length);
+
+    if (journal->offset + CONFIG_JOURNAL_ALIGN(size) > journal->bank_size)
+    {
+        return false;
+    }
+
+    uint32_t address = config_journal_bank_addr(journal, journal->active) + journal->offset;
+    if (!flash_program(address, (const uint8_t *)record, size) ||
+        !flash_verify(address, (const uint8_t *)record, size))
+    {
+        // 本bank不再追加
+        journal->offset = journal->bank_size;
+        journal->stats.write_errors++;
+        return false;
+    }
+
+    journal->offset += (uint16_t)CONFIG_JOURNAL_ALIGN(size);
+    return true;
+}
+
+/**
+ * @brief 将完整快照写入另一bank并切换
+ */
+static bool config_journal_write_snapshot(config_journal_t *journal, const uint8_t *data)
+{
+    config_journal_bank_t header;
+
+    // 写入备用bank，已预擦除的页不再擦除
+    uint8_t target = config_journal_spare_bank(journal);
+    uint32_t address = config_journal_bank_addr(journal, target);
+
+    header.magic = CONFIG_JOURNAL_MAGIC;
+    header.sequence = journal->sequence + 1;
+    header.size = journal->size;
+    header.crc16 = storage_crc16_update(0xFFFF, (const uint8_t *)&header.sequence,
+                                        offsetof(config_journal_bank_t, crc16) - offsetof(config_journal_bank_t, sequence));
+    header.crc16 = storage_crc16_update(header.crc16, data, journal->size);
+    header.reserved = 0xFFFFFFFFUL;
+
+    uint8_t first_page = journal->spare_erased;
+    journal->spare_erased = 0;
+
+    // bank头最后写入: 有效的bank头即表示快照完整
+    if (!config_journal_erase_bank(journal, target, first_page) ||
+        !flash_program(address + sizeof(config_journal_bank_t), data, journal->size) ||
+        !flash_verify(address + sizeof(config_journal_bank_t), data, journal->size) ||
+        !flash_program(address, (const uint8_t *)&header, sizeof(header)) ||
+        !flash_verify(address, (const uint8_t *)&header, sizeof(header)))
+    {
+        journal->stats.write_errors++;
+        return false;
+    }
+
+    // 原bank成为备用bank，等待后台预擦除
+    journal->active = target;
+    journal->sequence = header.sequence;
+    journal->valid = true;
+    journal->offset = config_journal_data_start(journal);
+    journal->spare_erased = 0;
+    return true;
+}
+
+/**
+ * @brief 擦除一个bank (从first_page开始)
+ */
+static bool config_journal_erase_bank(config_journal_t *journal, uint8_t bank, uint8_t first_page)
+{
+    uint32_t address = config_journal_bank_addr(journal, bank);
+
+    for (uint16_t offset = (uint16_t)(first_page * FLASH_PAGE_SIZE); offset < journal->bank_size;
+         offset += FLASH_PAGE_SIZE)
+    {
+        if (!flash_erase_page(address + offset))
+        {
+            return false;
+        }
+        journal->stats.erases++;
+    }
+    return true;
+}
+
+/**
+ * @brief 备用bank: 下一次改写快照的目标
+ * @note 无有效bank时为bank 1，保留bank 0中可能存在的旧格式数据
+ */
+static uint8_t config_journal_spare_bank(const config_journal_t *journal)
+{
+    return journal->valid ? (uint8_t)(journal->active ^ 1) : 1;
+}
+
+/**
+ * @brief 统计bank起始处连续的空白页数
+ */
+static uint8_t config_journal_count_blank_pages(const config_journal_t *journal, uint8_t bank)
+{
+    uint32_t address = config_journal_bank_addr(journal, bank);
+    uint32_t buffer[8];
+    uint8_t pages = 0;
+
+    for (uint16_t offset = 0; offset < journal->bank_size; offset += sizeof(buffer))
+    {
+        if (!flash_read(address + offset, (uint8_t *)buffer, sizeof(buffer)))
+        {
+            return pages;
+        }
+        for (uint8_t i = 0; i < sizeof(buffer) / sizeof(buffer[0]); i++)
+        {
+            if (buffer[i] != 0xFFFFFFFFUL)
+            {
+                return pages;
+            }
+        }
+        if ((offset + sizeof(buffer)) % FLASH_PAGE_SIZE == 0)
+        {
+            pages++;
+        }
+    }
+    return pages;
+}
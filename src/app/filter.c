@@ -0,0 +1,276 @@
+/**
+ * @file filter.c
+ * @brief 憨云DTU数字滤波器库实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 所有滤波器每样本开销与窗口长度无关或仅为一次有序插入，
+ * 全部使用整数/定点运算，适配无FPU的Cortex-M0
+ */
+
+#include "filter.h"
+#include <string.h>
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static uint16_t filter_ma_update(filter_t *filter, uint16_t sample);
+static uint16_t filter_median_update(filter_t *filter, uint16_t sample);
+static uint16_t filter_iir_update(filter_t *filter, uint16_t sample);
+static uint16_t filter_kalman_update(filter_t *filter, uint16_t sample);
+static uint8_t filter_lower_bound(const uint16_t *sorted, uint8_t count, uint16_t value);
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+/**
+ * @brief 初始化滤波器
+ */
+bool filter_init(filter_t *filter, const filter_config_t *config)
+{
+    if (!filter || !config || config->type >= FILTER_TYPE_COUNT)
+    {
+        return false;
+    }
+
+    memset(filter, 0, sizeof(filter_t));
+
+    filter->type = config->type;
+    filter->param = config->param;
+
+    // 窗口长度限幅
+    filter->window = config->window;
+    if (filter->window == 0)
+    {
+        filter->window = 1;
+    }
+    else if (filter->window > FILTER_MAX_WINDOW)
+    {
+        filter->window = FILTER_MAX_WINDOW;
+    }
+
+    // 类型参数默认值
+    if (filter->type == FILTER_TYPE_IIR)
+    {
+        if (filter->param == 0 || filter->param > FILTER_IIR_SHIFT_MAX)
+        {
+            filter->param = FILTER_IIR_SHIFT_DEFAULT;
+        }
+    }
+    else if (filter->type == FILTER_TYPE_KALMAN)
+    {
+        if (filter->param == 0)
+        {
+            filter->param = FILTER_KALMAN_RATIO_DEFAULT;
+        }
+        else if (filter->param > FILTER_KALMAN_RATIO_MAX)
+        {
+            filter->param = FILTER_KALMAN_RATIO_MAX;
+        }
+    }
+
+    filter_reset(filter);
+    return true;
+}
+
+/**
+ * @brief 复位滤波器状态
+ */
+void filter_reset(filter_t *filter)
+{
+    if (!filter)
+    {
+        return;
+    }
+
+    filter->index = 0;
+    filter->count = 0;
+    memset(&filter->state, 0, sizeof(filter->state));
+
+    if (filter->type == FILTER_TYPE_KALMAN)
+    {
+        filter->state.kalman.r_q16 = (int32_t)filter->param << 16;
+    }
+}
+
+/**
+ * @brief 输入一个样本并返回滤波结果
+ */
+uint16_t filter_update(filter_t *filter, uint16_t sample)
+{
+    if (!filter)
+    {
+        return sample;
+    }
+
+    switch (filter->type)
+    {
+    case FILTER_TYPE_MOVING_AVERAGE:
+        return filter_ma_update(filter, sample);
+    case FILTER_TYPE_MEDIAN:
+        return filter_median_update(filter, sample);
+    case FILTER_TYPE_IIR:
+        return filter_iir_update(filter, sample);
+    case FILTER_TYPE_KALMAN:
+        return filter_kalman_update(filter, sample);
+    case FILTER_TYPE_NONE:
+    default:
+        return sample;
+    }
+}
+
+/**
+ * @brief 获取滤波器类型名称
+ */
+const char *filter_get_type_name(filter_type_t type)
+{
+    static const char *type_names[] = {"MA", "MEDIAN", "IIR", "KALMAN", "NONE"};
+    return (type < FILTER_TYPE_COUNT) ? type_names[type] : "UNKNOWN";
+}
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief 滑动平均 (运行和，每样本一次加减)
+ */
+static uint16_t filter_ma_update(filter_t *filter, uint16_t sample)
+{
+    filter_ma_state_t *ma = &filter->state.ma;
+
+    if (filter->count < filter->window)
+    {
+        filter->count++;
+    }
+    else
+    {
+        ma->sum -= ma->buffer[filter->index];
+    }
+
+    ma->buffer[filter->index] = sample;
+    ma->sum += sample;
+
+    filter->index++;
+    if (filter->index >= filter->window)
+    {
+        filter->index = 0;
+    }
+
+    return (uint16_t)(ma->sum / filter->count);
+}
+
+/**
+ * @brief 中值滤波 (增量维护有序窗口)
+ */
+static uint16_t filter_median_update(filter_t *filter, uint16_t sample)
+{
+    filter_median_state_t *med = &filter->state.median;
+    uint8_t count = filter->count;
+    uint8_t pos;
+
+    // 窗口已满: 从有序窗口中移除最旧样本
+    if (count >= filter->window)
+    {
+        uint16_t oldest = med->buffer[filter->index];
+        pos = filter_lower_bound(med->sorted, count, oldest);
+        memmove(&med->sorted[pos], &med->sorted[pos + 1], (size_t)(count - pos - 1) * sizeof(uint16_t));
+        count--;
+    }
+
+    // 插入新样本
+    pos = filter_lower_bound(med->sorted, count, sample);
+    memmove(&med->sorted[pos + 1], &med->sorted[pos], (size_t)(count - pos) * sizeof(uint16_t));
+    med->sorted[pos] = sample;
+    count++;
+
+    med->buffer[filter->index] = sample;
+    filter->index++;
+    if (filter->index >= filter->window)
+    {
+        filter->index = 0;
+    }
+    filter->count = count;
+
+    // 偶数个样本取两个中间值的平均
+    return (uint16_t)(((uint32_t)med->sorted[(count - 1) / 2] + med->sorted[count / 2]) / 2);
+}
+
+/**
+ * @brief 一阶IIR: y += (x - y) / 2^n
+ */
+static uint16_t filter_iir_update(filter_t *filter, uint16_t sample)
+{
+    filter_iir_state_t *iir = &filter->state.iir;
+    uint32_t input_q16 = (uint32_t)sample << 16;
+
+    // 无符号运算，16位输入左移16位不溢出
+    if (filter->count == 0)
+    {
+        iir->state_q16 = input_q16;
+        filter->count = 1;
+    }
+    else if (input_q16 >= iir->state_q16)
+    {
+        iir->state_q16 += (input_q16 - iir->state_q16) >> filter->param;
+    }
+    else
+    {
+        iir->state_q16 -= (iir->state_q16 - input_q16) >> filter->param;
+    }
+
+    return (uint16_t)((iir->state_q16 >> 16) + ((iir->state_q16 >> 15) & 1U));
+}
+
+/**
+ * @brief 一维卡尔曼 (恒值模型，Q = 1，R = param)
+ */
+static uint16_t filter_kalman_update(filter_t *filter, uint16_t sample)
+{
+    filter_kalman_state_t *kf = &filter->state.kalman;
+    uint32_t z_q16 = (uint32_t)sample << 16;
+
+    if (filter->count == 0)
+    {
+        kf->x_q16 = z_q16;
+        kf->p_q16 = kf->r_q16;
+        filter->count = 1;
+        return sample;
+    }
+
+    // 预测: P = P + Q
+    kf->p_q16 += (1 << 16);
+
+    // 更新: K = P / (P + R), x += K * (z - x), P = (1 - K) * P
+    int32_t k_q16 = (int32_t)(((int64_t)kf->p_q16 << 16) / ((int64_t)kf->p_q16 + kf->r_q16));
+    kf->x_q16 = (uint32_t)((int64_t)kf->x_q16 + (((int64_t)k_q16 * ((int64_t)z_q16 - kf->x_q16)) >> 16));
+    kf->p_q16 = (int32_t)(((int64_t)((1 << 16) - k_q16) * kf->p_q16) >> 16);
+
+    return (uint16_t)((kf->x_q16 >> 16) + ((kf->x_q16 >> 15) & 1U));
+}
+
+/**
+ * @brief 二分查找第一个不小于value的位置
+ */
+static uint8_t filter_lower_bound(const uint16_t *sorted, uint8_t count, uint16_t value)
+{
+    uint8_t low = 0;
+    uint8_t high = count;
+
+    while (low < high)
+    {
+        uint8_t mid = (uint8_t)((low + high) >> 1);
+        if (sorted[mid] < value)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return low;
+}
@@ -0,0 +1,1465 @@
+/**
+ * @file flash_log.c
+ * @brief 憨云DTU日志结构Flash记录存储实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 扇区状态由扇区头决定:
+ * - 空闲: magic有效、序号为0xFFFFFFFF (擦除完成后才写magic，保证数据区全为0xFF)
+ * - 启用: magic有效、序号与CRC有效
+ * - 脏: 其余情况 (被打断的擦除/启用)，使用前必须擦除
+ * 写入头为序号最大的启用扇区，向前序号连续的扇区为有效数据
+ *
+ * 扇区摘要在切换到下一个扇区前写入；掉电导致摘要缺失或损坏时，查询按记录扫描该扇区重建摘要。
+ * 写入扇区的摘要只在RAM中维护，挂载时扫描恢复
+ *
+ * 写回缓存中的记录已分配序号，紧接在写入偏移之后连续排列，写回时一次编程；
+ * 编程按地址递增进行，掉电时已写完的记录完整有效，撕裂的记录CRC不符，与逐条写入一致
+ *
+ * 检查点只是挂载加速: 挂载时核对检查点中的写入扇区、其后新启用的扇区与最旧扇区的扇区头，
+ * 任一不符即按扇区头全扫描挂载，因此检查点丢失、过期或撕裂都不影响数据
+ */
+
+#include "flash_log.h"
+#include "flash.h"
+#include "storage.h"
+#include "system.h"
+#include <stddef.h>
+#include <string.h>
+
+// ============================================================================
+// 内部数据结构
+// ============================================================================
+
+#define FLASH_LOG_ALIGN(n) (((n) + (FLASH_PROGRAM_UNIT - 1)) & ~(uint32_t)(FLASH_PROGRAM_UNIT - 1))
+#define FLASH_LOG_DATA_START ((uint16_t)sizeof(flash_log_sector_t))
+#define FLASH_LOG_CHECKPOINT_SLOTS (FLASH_PAGE_SIZE / sizeof(flash_log_checkpoint_t)) // 每页检查点槽位数
+
+/**
+ * @brief 扇区状态
+ */
+typedef enum
+{
+    FLASH_LOG_SECTOR_DIRTY = 0, // 需擦除
+    FLASH_LOG_SECTOR_FREE,      // 已擦除未启用
+    FLASH_LOG_SECTOR_ACTIVE     // 已启用
+} flash_log_sector_state_t;
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static uint32_t flash_log_sector_addr(const flash_log_t *log, uint16_t sector);
+static flash_log_sector_state_t flash_log_read_header(const flash_log_t *log, uint16_t sector,
+                                                      flash_log_sector_t *header);
+static bool flash_log_erase_sector(flash_log_t *log, uint16_t sector);
+static bool flash_log_open_sector(flash_log_t *log, uint16_t sector);
+static bool flash_log_prepare_ahead(flash_log_t *log);
+static void flash_log_scan_head(flash_log_t *log, uint16_t offset, uint32_t next_sequence);
+static bool flash_log_mount_checkpoint(flash_log_t *log);
+static bool flash_log_find_checkpoint(flash_log_t *log, flash_log_checkpoint_t *checkpoint);
+static bool flash_log_read_checkpoint(const flash_log_t *log, uint16_t slot, flash_log_checkpoint_t *checkpoint);
+static uint16_t flash_log_checkpoint_crc(const flash_log_checkpoint_t *checkpoint);
+static bool flash_log_check_oldest(flash_log_t *log);
+static bool flash_log_read_entry(flash_log_t *log, uint16_t sector, uint16_t *offset, uint16_t limit,
+                                 flash_log_entry_t *entry, void *data, uint8_t max_length);
+static uint16_t flash_log_sector_limit(const flash_log_t *log, uint16_t age);
+static bool flash_log_program(flash_log_t *log, const uint8_t *data, uint16_t length);
+static void flash_log_note_record(flash_log_summary_t *summary, const flash_log_entry_t *entry);
+static uint16_t flash_log_summary_crc(const flash_log_summary_t *summary);
+static void flash_log_close_sector(flash_log_t *log);
+static void flash_log_get_summary(flash_log_t *log, uint16_t age, flash_log_summary_t *summary);
+static uint16_t flash_log_age_sector(const flash_log_t *log, uint16_t age);
+static uint16_t flash_log_checkpoint_interval(const flash_log_t *log);
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+/**
+ * @brief 挂载日志
+ */
+bool flash_log_mount(flash_log_t *log, uint32_t base, uint16_t sector_size, uint16_t sector_count)
+{
+    flash_log_sector_t header;
+    bool found = false;
+
+    if (!log || sector_count < FLASH_LOG_MIN_SECTORS || sector_size == 0 ||
+        (sector_size % FLASH_PAGE_SIZE) != 0 || (base % FLASH_PAGE_SIZE) != 0)
+    {
+        return false;
+    }
+
+    // 写回缓存、延后擦除与检查点区设置保留 (挂载即重启，缓存内容作废)
+    uint8_t *cache = log->cache;
+    uint16_t cache_size = log->cache_size;
+    bool defer_erase = log->defer_erase;
+    uint32_t checkpoint_base = log->checkpoint_base;
+    uint16_t checkpoint_pages = log->checkpoint_pages;
+
+    memset(log, 0, sizeof(flash_log_t));
+    log->cache = cache;
+    log->cache_size = cache_size;
+    log->defer_erase = defer_erase;
+    log->checkpoint_base = checkpoint_base;
+    log->checkpoint_pages = checkpoint_pages;
+    log->base = base;
+    log->sector_size = sector_size;
+    log->sector_count = sector_count;
+
+    // 检查点与扇区头一致时只扫描检查点之后的记录
+    if (flash_log_mount_checkpoint(log))
+    {
+        log->checkpoint_mounted = true;
+        log->mounted = true;
+        debug_printf("[FLOG] Mounted 0x%08lX from checkpoint: head=%d offset=%d used=%d next_seq=%lu\n",
+                     (unsigned long)base, log->head, log->head_offset, log->used,
+                     (unsigned long)log->next_sequence);
+        return flash_log_prepare_ahead(log);
+    }
+
+    // 找序号最大的启用扇区，同时收集已知最大擦除次数
+    for (uint16_t sector = 0; sector < sector_count; sector++)
+    {
+        flash_log_sector_state_t state = flash_log_read_header(log, sector, &header);
+
+        if (header.magic == FLASH_LOG_MAGIC && header.erase_count != 0xFFFFFFFFUL &&
+            header.erase_count > log->max_erase_count)
+        {
+            log->max_erase_count = header.erase_count;
+        }
+
+        if (state == FLASH_LOG_SECTOR_ACTIVE && (!found || header.sector_sequence > log->head_sequence))
+        {
+            log->head = sector;
+            log->head_sequence = header.sector_sequence;
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        debug_printf("[FLOG] No valid sector at 0x%08lX, formatting\n", (unsigned long)base);
+        return flash_log_format(log);
+    }
+
+    // 向前回溯序号连续的扇区
+    log->used = 1;
+    while (log->used < sector_count)
+    {
+        uint16_t sector = (uint16_t)((log->head + sector_count - log->used) % sector_count);
+        if (flash_log_read_header(log, sector, &header) != FLASH_LOG_SECTOR_ACTIVE ||
+            header.sector_sequence != log->head_sequence - log->used)
+        {
+            break;
+        }
+        log->used++;
+    }
+
+    // 扫描写入扇区，恢复写入偏移与记录序号；检查点无效，下次启用新扇区时即写入
+    flash_log_read_header(log, log->head, &header);
+    flash_log_scan_head(log, FLASH_LOG_DATA_START, header.first_sequence);
+    log->checkpoint_sectors = (uint16_t)(flash_log_checkpoint_interval(log) - 1);
+    log->mounted = true;
+
+    debug_printf("[FLOG] Mounted 0x%08lX: head=%d offset=%d used=%d next_seq=%lu\n",
+                 (unsigned long)base, log->head, log->head_offset, log->used,
+                 (unsigned long)log->next_sequence);
+
+    // 完成被掉电打断的预擦除
+    return flash_log_prepare_ahead(log);
+}
+
+/**
+ * @brief 格式化日志
+ */
+bool flash_log_format(flash_log_t *log)
+{
+    if (!log || log->sector_count < FLASH_LOG_MIN_SECTORS)
+    {
+        return false;
+    }
+
+    log->mounted = false;
+    log->cache_used = 0;
+    log->cache_records = 0;
+    log->erase_pending = false;
+    for (uint16_t sector = 0; sector < log->sector_count; sector++)
+    {
+        flash_log_sector_t header;
+        if (flash_log_read_header(log, sector, &header) != FLASH_LOG_SECTOR_FREE &&
+            !flash_log_erase_sector(log, sector))
+        {
+            return false;
+        }
+    }
+
+    log->used = 0;
+    if (!flash_log_open_sector(log, 0))
+    {
+        return false;
+    }
+
+    // 立即写入检查点，使旧检查点失效
+    log->mounted = true;
+    if (log->checkpoint_pages)
+    {
+        log->checkpoint_due = true;
+        flash_log_checkpoint(log);
+    }
+    return true;
+}
+
+/**
+ * @brief 追加一条记录
+ */
+bool flash_log_append(flash_log_t *log, uint8_t type, uint32_t timestamp, const void *data, uint8_t length)
+{
+    if (!log || !log->mounted || !data || length == 0 || type == FLASH_LOG_TYPE_ANY || type == 0xFF)
+    {
+        return false;
+    }
+
+    uint16_t size = (uint16_t)(sizeof(flash_log_entry_t) + FLASH_LOG_ALIGN(length));
+    if (size > log->sector_size - FLASH_LOG_DATA_START)
+    {
+        return false;
+    }
+
+    // 缓存放不下或写入扇区放不下缓存之后的新记录: 先写回缓存
+    if (log->cache_used &&
+        (log->cache_used + size > log->cache_size || log->head_offset + log->cache_used + size > log->sector_size))
+    {
+        if (!flash_log_flush(log))
+        {
+            return false;
+        }
+    }
+
+    // 写入扇区已满: 写入其摘要，启用下一个预擦除扇区，再回收其后的最旧扇区 (或留给后台维护)
+    if (log->head_offset + size > log->sector_size)
+    {
+        flash_log_close_sector(log);
+        if (!flash_log_open_sector(log, (uint16_t)((log->head + 1) % log->sector_count)) ||
+            (!log->defer_erase && !flash_log_prepare_ahead(log)))
+        {
+            log->stats.write_errors++;
+            return false;
+        }
+        log->erase_pending = log->defer_erase;
+        log->checkpoint_sectors++;
+        log->checkpoint_due = log->checkpoint_pages != 0 && log->checkpoint_sectors >= flash_log_checkpoint_interval(log);
+        if (log->checkpoint_due && !log->defer_erase)
+        {
+            flash_log_checkpoint(log);
+        }
+    }
+
+    flash_log_entry_t entry;
+    entry.sequence = log->next_sequence;
+    entry.timestamp = timestamp;
+    entry.type = type;
+    entry.length = length;
+    entry.crc16 = storage_crc16_update(0xFFFF, (const uint8_t *)&entry, offsetof(flash_log_entry_t, crc16));
+    entry.crc16 = storage_crc16_update(entry.crc16, (const uint8_t *)data, length);
+
+    if (log->cache && size <= log->cache_size)
+    {
+        // 按Flash格式拼接到缓存，补齐部分保持0xFF
+        uint8_t *slot = &log->cache[log->cache_used];
+        memcpy(slot, &entry, sizeof(entry));
+        memcpy(slot + sizeof(entry), data, length);
+        memset(slot + sizeof(entry) + length, 0xFF, size - sizeof(entry) - length);
+
+        if (log->cache_used == 0)
+        {
+            log->cache_time = system_get_tick();
+        }
+        log->cache_used += size;
+        log->cache_records++;
+        log->next_sequence++;
+        log->stats.appends++;
+
+        // 缓存已满或写入扇区已写满时立即写回
+        if (log->cache_used + sizeof(flash_log_entry_t) + FLASH_PROGRAM_UNIT > log->cache_size ||
+            log->head_offset + log->cache_used + sizeof(flash_log_entry_t) + FLASH_PROGRAM_UNIT > log->sector_size)
+        {
+            return flash_log_flush(log);
+        }
+        return true;
+    }
+
+    // 先写记录头再写数据: 任一步掉电都会留下CRC不符的记录，挂载时可识别
+    uint32_t address = flash_log_sector_addr(log, log->head) + log->head_offset;
+    if (!flash_program(address, (const uint8_t *)&entry, sizeof(entry)) ||
+        !flash_program(address + sizeof(entry), (const uint8_t *)data, length) ||
+        !flash_verify(address, (const uint8_t *)&entry, sizeof(entry)) ||
+        !flash_verify(address + sizeof(entry), (const uint8_t *)data, length))
+    {
+        // 放弃本扇区剩余空间，下次写入换到新扇区
+        log->head_offset = log->sector_size;
+        log->stats.write_errors++;
+        return false;
+    }
+
+    log->head_offset += size;
+    log->next_sequence++;
+    log->stats.appends++;
+    flash_log_note_record(&log->head_summary, &entry);
+    return true;
+}
+
+/**
+ * @brief 设置写回缓存
+ */
+void flash_log_set_cache(flash_log_t *log, uint8_t *buffer, uint16_t size)
+{
+    if (!log)
+    {
+        return;
+    }
+
+    flash_log_flush(log);
+
+    size = (uint16_t)(size & ~(uint16_t)(FLASH_PROGRAM_UNIT - 1));
+    log->cache = (buffer && size) ? buffer : NULL;
+    log->cache_size = log->cache ? size : 0;
+    log->cache_used = 0;
+    log->cache_records = 0;
+}
+
+/**
+ * @brief 将缓存中的记录一次编程写入Flash
+ */
+bool flash_log_flush(flash_log_t *log)
+{
+    if (!log || !log->mounted || log->cache_used == 0)
+    {
+        return true;
+    }
+
+    bool result = flash_log_program(log, log->cache, log->cache_used);
+    if (result)
+    {
+        // 写入成功的记录计入写入扇区摘要
+        for (uint16_t offset = 0; offset < log->cache_used;)
+        {
+            const flash_log_entry_t *entry = (const flash_log_entry_t *)&log->cache[offset];
+            flash_log_note_record(&log->head_summary, entry);
+            offset += (uint16_t)(sizeof(flash_log_entry_t) + FLASH_LOG_ALIGN(entry->length));
+        }
+        log->stats.flushes++;
+    }
+    else
+    {
+        log->stats.dropped += log->cache_records;
+    }
+
+    log->cache_used = 0;
+    log->cache_records = 0;
+    return result;
+}
+
+/**
+ * @brief 缓存中最早记录超过时限时写回
+ */
+bool flash_log_flush_expired(flash_log_t *log, uint32_t max_age_ms)
+{
+    if (!log || log->cache_used == 0 || system_get_tick() - log->cache_time < max_age_ms)
+    {
+        return true;
+    }
+
+    return flash_log_flush(log);
+}
+
+/**
+ * @brief 缓存中待写入的记录数
+ */
+uint16_t flash_log_get_pending(const flash_log_t *log)
+{
+    return log ? log->cache_records : 0;
+}
+
+/**
+ * @brief 设置延后预擦除
+ */
+void flash_log_set_deferred_erase(flash_log_t *log, bool defer)
+{
+    if (!log)
+    {
+        return;
+    }
+
+    log->defer_erase = defer;
+    if (!defer && log->erase_pending)
+    {
+        flash_log_maintain(log);
+    }
+}
+
+/**
+ * @brief 执行一步后台维护
+ */
+bool flash_log_maintain(flash_log_t *log)
+{
+    if (!log || !log->mounted)
+    {
+        return false;
+    }
+
+    // 先完成预擦除，下一次调用再写检查点
+    if (log->erase_pending)
+    {
+        // 擦除失败时不重试，下次启用该扇区时同步擦除
+        uint32_t erases = log->stats.erases;
+        log->erase_pending = false;
+        flash_log_prepare_ahead(log);
+        if (log->stats.erases != erases)
+        {
+            return true;
+        }
+    }
+
+    if (log->checkpoint_due)
+    {
+        flash_log_checkpoint(log);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 设置检查点区
+ */
+void flash_log_set_checkpoint(flash_log_t *log, uint32_t base, uint16_t page_count)
+{
+    if (!log)
+    {
+        return;
+    }
+
+    if (page_count < FLASH_LOG_CHECKPOINT_MIN_PAGES || (base % FLASH_PAGE_SIZE) != 0)
+    {
+        page_count = 0;
+    }
+    log->checkpoint_base = base;
+    log->checkpoint_pages = page_count;
+    log->checkpoint_slot = 0;
+    log->checkpoint_due = false;
+}
+
+/**
+ * @brief 写入检查点
+ */
+bool flash_log_checkpoint(flash_log_t *log)
+{
+    flash_log_checkpoint_t checkpoint;
+
+    if (!log || !log->mounted || log->checkpoint_pages == 0)
+    {
+        return false;
+    }
+
+    // 缓存中的记录尚未写入Flash，不计入检查点
+    uint32_t next_sequence = log->next_sequence - log->cache_records;
+    if (!log->checkpoint_due && next_sequence == log->checkpoint_records)
+    {
+        return true;
+    }
+
+    uint16_t slots = (uint16_t)(log->checkpoint_pages * FLASH_LOG_CHECKPOINT_SLOTS);
+    uint16_t slot = (uint16_t)(log->checkpoint_slot % slots);
+    uint32_t page = log->checkpoint_base + (uint32_t)(slot / FLASH_LOG_CHECKPOINT_SLOTS) * FLASH_PAGE_SIZE;
+    uint32_t address = page + (uint32_t)(slot % FLASH_LOG_CHECKPOINT_SLOTS) * sizeof(flash_log_checkpoint_t);
+
+    checkpoint.magic = FLASH_LOG_CHECKPOINT_MAGIC;
+    checkpoint.sequence = log->checkpoint_sequence;
+    checkpoint.head_sequence = log->head_sequence;
+    checkpoint.next_sequence = next_sequence;
+    checkpoint.max_erase_count = log->max_erase_count;
+    checkpoint.head = log->head;
+    checkpoint.head_offset = log->head_offset;
+    checkpoint.used = log->used;
+    checkpoint.summary = log->head_summary;
+    checkpoint.crc16 = flash_log_checkpoint_crc(&checkpoint);
+
+    // 槽位失败时跳过，下次写入下一槽位
+    log->checkpoint_slot = (uint16_t)((slot + 1) % slots);
+    log->checkpoint_sequence++;
+    log->checkpoint_due = false;
+
+    // 换页时擦除整页: 轮转到的页保存的是最旧的检查点
+    if ((slot % FLASH_LOG_CHECKPOINT_SLOTS) == 0 && !flash_erase_page(page))
+    {
+        log->stats.write_errors++;
+        return false;
+    }
+    if (!flash_program(address, (const uint8_t *)&checkpoint, sizeof(checkpoint)) ||
+        !flash_verify(address, (const uint8_t *)&checkpoint, sizeof(checkpoint)))
+    {
+        log->stats.write_errors++;
+        return false;
+    }
+
+    log->checkpoint_records = next_sequence;
+    log->checkpoint_sectors = 0;
+    log->stats.checkpoints++;
+    return true;
+}
+
+/**
+ * @brief 游标定位到最旧记录
+ */
+void flash_log_rewind(const flash_log_t *log, flash_log_cursor_t *cursor)
+{
+    if (!log || !cursor)
+    {
+        return;
+    }
+
+    cursor->sector_sequence = log->head_sequence - (log->used ? log->used - 1 : 0);
+    cursor->offset = FLASH_LOG_DATA_START;
+}
+
+/**
+ * @brief 读取下一条有效记录
+ */
+bool flash_log_next(flash_log_t *log, flash_log_cursor_t *cursor, flash_log_entry_t *entry,
+                    void *data, uint8_t max_length)
+{
+    if (!log || !log->mounted || !cursor || log->used == 0)
+    {
+        return false;
+    }
+
+    // 先写回缓存，保证读到刚追加的记录
+    flash_log_flush(log);
+
+    uint32_t tail_sequence = log->head_sequence - (log->used - 1);
+
+    // 游标所在扇区已被回收
+    if (cursor->sector_sequence < tail_sequence)
+    {
+        cursor->sector_sequence = tail_sequence;
+        cursor->offset = FLASH_LOG_DATA_START;
+    }
+
+    while (cursor->sector_sequence <= log->head_sequence)
+    {
+        uint16_t age = (uint16_t)(log->head_sequence - cursor->sector_sequence);
+        uint16_t sector = flash_log_age_sector(log, age);
+
+        if (flash_log_read_entry(log, sector, &cursor->offset, flash_log_sector_limit(log, age),
+                                 entry, data, max_length))
+        {
+            return true;
+        }
+
+        // 写入扇区读完时停在原位，后续追加的记录可继续读取
+        if (age == 0)
+        {
+            break;
+        }
+        cursor->sector_sequence++;
+        cursor->offset = FLASH_LOG_DATA_START;
+    }
+
+    return false;
+}
+
+/**
+ * @brief 游标定位到序号不小于sequence的第一条记录
+ */
+void flash_log_seek(flash_log_t *log, flash_log_cursor_t *cursor, uint32_t sequence)
+{
+    flash_log_sector_t header;
+    flash_log_entry_t entry;
+
+    if (!log || !cursor)
+    {
+        return;
+    }
+
+    flash_log_rewind(log, cursor);
+    if (!log->mounted || log->used == 0)
+    {
+        return;
+    }
+
+    flash_log_flush(log);
+
+    // 扇区按从旧到新编号，二分找最后一个首记录序号 <= sequence 的扇区 (扇区头损坏时视为满足)
+    uint16_t low = 0, high = (uint16_t)(log->used - 1);
+    while (low < high)
+    {
+        uint16_t mid = (uint16_t)((low + high + 1) / 2);
+        uint16_t sector = flash_log_age_sector(log, (uint16_t)(log->used - 1 - mid));
+        if (flash_log_read_header(log, sector, &header) != FLASH_LOG_SECTOR_ACTIVE ||
+            header.first_sequence <= sequence)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = (uint16_t)(mid - 1);
+        }
+    }
+
+    uint16_t age = (uint16_t)(log->used - 1 - low);
+    uint16_t sector = flash_log_age_sector(log, age);
+    uint16_t limit = flash_log_sector_limit(log, age);
+    uint16_t offset = FLASH_LOG_DATA_START;
+
+    cursor->sector_sequence += low;
+    for (;;)
+    {
+        uint16_t start = offset;
+        if (!flash_log_read_entry(log, sector, &offset, limit, &entry, NULL, 0))
+        {
+            // 扇区内没有更晚的记录: flash_log_next从下一扇区继续
+            cursor->offset = offset;
+            break;
+        }
+        if (entry.sequence >= sequence)
+        {
+            cursor->offset = start;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 读取flash_log_next刚读到的记录的一段数据
+ */
+uint16_t flash_log_read_data(flash_log_t *log, const flash_log_cursor_t *cursor, const flash_log_entry_t *entry,
+                             uint16_t offset, void *data, uint16_t length)
+{
+    flash_log_entry_t header;
+
+    if (!log || !log->mounted || !cursor || !entry || !data || log->used == 0 || offset >= entry->length)
+    {
+        return 0;
+    }
+
+    uint32_t tail_sequence = log->head_sequence - (log->used - 1);
+    uint16_t size = (uint16_t)(sizeof(flash_log_entry_t) + FLASH_LOG_ALIGN(entry->length));
+    if (cursor->sector_sequence < tail_sequence || cursor->sector_sequence > log->head_sequence ||
+        cursor->offset < FLASH_LOG_DATA_START + size)
+    {
+        return 0;
+    }
+
+    uint16_t sector = flash_log_age_sector(log, (uint16_t)(log->head_sequence - cursor->sector_sequence));
+    uint32_t address = flash_log_sector_addr(log, sector) + cursor->offset - size;
+
+    // 两次读取之间扇区可能已被回收重写: 核对记录头
+    if (!flash_read(address, (uint8_t *)&header, sizeof(header)) || header.sequence != entry->sequence ||
+        header.crc16 != entry->crc16)
+    {
+        return 0;
+    }
+
+    if (length > entry->length - offset)
+    {
+        length = (uint16_t)(entry->length - offset);
+    }
+    return flash_read(address + sizeof(header) + offset, (uint8_t *)data, length) ? length : 0;
+}
+
+/**
+ * @brief 读取某类型最新的若干条定长记录
+ */
+uint16_t flash_log_read_latest(flash_log_t *log, uint8_t type, void *records, uint8_t record_size,
+                               uint16_t count)
+{
+    uint8_t *output = (uint8_t *)records;
+    uint16_t filled = 0;
+    flash_log_entry_t entry;
+
+    if (!log || !log->mounted || !records || record_size == 0 || count == 0)
+    {
+        return 0;
+    }
+
+    flash_log_flush(log);
+
+    // 从写入扇区向前逐扇区读取；扇区内只能正向遍历，先计数再取最后的若干条
+    for (uint16_t age = 0; age < log->used && filled < count; age++)
+    {
+        uint16_t sector = flash_log_age_sector(log, age);
+        uint16_t limit = flash_log_sector_limit(log, age);
+        uint16_t offset = FLASH_LOG_DATA_START;
+        uint16_t matches = 0;
+
+        while (flash_log_read_entry(log, sector, &offset, limit, &entry, NULL, 0))
+        {
+            if ((type == FLASH_LOG_TYPE_ANY || entry.type == type) && entry.length == record_size)
+            {
+                matches++;
+            }
+        }
+
+        uint16_t take = (uint16_t)(count - filled) < matches ? (uint16_t)(count - filled) : matches;
+        uint16_t skip = (uint16_t)(matches - take);
+        uint16_t index = 0;
+
+        offset = FLASH_LOG_DATA_START;
+        while (index < matches && flash_log_read_entry(log, sector, &offset, limit, &entry, NULL, 0))
+        {
+            if ((type != FLASH_LOG_TYPE_ANY && entry.type != type) || entry.length != record_size)
+            {
+                continue;
+            }
+            if (index >= skip)
+            {
+                // 扇区内第(index-skip)条较旧，放在本扇区输出段的末尾方向
+                uint16_t slot = (uint16_t)(filled + take - 1 - (index - skip));
+                uint16_t data_offset = (uint16_t)(offset - FLASH_LOG_ALIGN(record_size));
+                flash_read(flash_log_sector_addr(log, sector) + data_offset,
+                           &output[(uint32_t)slot * record_size], record_size);
+            }
+            index++;
+        }
+
+        filled += take;
+    }
+
+    return filled;
+}
+
+/**
+ * @brief 按时间区间查询记录
+ */
+uint32_t flash_log_query(flash_log_t *log, uint8_t type, uint32_t start_time, uint32_t end_time,
+                         flash_log_visitor_t visitor, void *context)
+{
+    flash_log_summary_t summary;
+    flash_log_entry_t entry;
+    uint8_t data[FLASH_LOG_QUERY_DATA];
+    uint32_t visited = 0;
+
+    if (!log || !log->mounted || !visitor || start_time > end_time)
+    {
+        return 0;
+    }
+
+    flash_log_flush(log);
+
+    // 扇区按从旧到新编号 (index = used-1-age)，二分找第一个末条时间戳 >= start_time 的扇区；
+    // 空扇区视为满足条件，保证不会越过其前面含目标记录的扇区
+    uint16_t low = 0, high = log->used;
+    while (low < high)
+    {
+        uint16_t mid = (uint16_t)((low + high) / 2);
+        flash_log_get_summary(log, (uint16_t)(log->used - 1 - mid), &summary);
+        if (summary.record_count == 0 || summary.last_timestamp >= start_time)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = (uint16_t)(mid + 1);
+        }
+    }
+
+    for (uint16_t index = low; index < log->used; index++)
+    {
+        uint16_t age = (uint16_t)(log->used - 1 - index);
+        uint16_t sector = flash_log_age_sector(log, age);
+        uint16_t limit = flash_log_sector_limit(log, age);
+        uint16_t offset = FLASH_LOG_DATA_START;
+
+        flash_log_get_summary(log, age, &summary);
+        if (summary.record_count == 0)
+        {
+            continue;
+        }
+        if (summary.first_timestamp > end_time)
+        {
+            break;
+        }
+        if (type != FLASH_LOG_TYPE_ANY && !(summary.type_mask & FLASH_LOG_TYPE_BIT(type)))
+        {
+            continue;
+        }
+
+        // 定长记录扇区: 二分找第一条时间戳 >= start_time 的记录
+        if (summary.first_timestamp < start_time && summary.record_size != 0)
+        {
+            uint16_t first = 0, last = summary.record_count;
+            while (first < last)
+            {
+                uint16_t mid = (uint16_t)((first + last) / 2);
+                flash_read(flash_log_sector_addr(log, sector) + FLASH_LOG_DATA_START +
+                               (uint32_t)mid * summary.record_size,
+                           (uint8_t *)&entry, sizeof(entry));
+                if (entry.timestamp >= start_time)
+                {
+                    last = mid;
+                }
+                else
+                {
+                    first = (uint16_t)(mid + 1);
+                }
+            }
+            offset = (uint16_t)(FLASH_LOG_DATA_START + first * summary.record_size);
+        }
+
+        while (flash_log_read_entry(log, sector, &offset, limit, &entry, data, sizeof(data)))
+        {
+            if (entry.timestamp < start_time)
+            {
+                continue;
+            }
+            if (entry.timestamp > end_time)
+            {
+                return visited;
+            }
+            if (type != FLASH_LOG_TYPE_ANY && entry.type != type)
+            {
+                continue;
+            }
+
+            visited++;
+            if (!visitor(&entry, data, context))
+            {
+                return visited;
+            }
+        }
+    }
+
+    return visited;
+}
+
+/**
+ * @brief 读取最新记录的时间戳
+ */
+bool flash_log_get_last_timestamp(flash_log_t *log, uint32_t *timestamp)
+{
+    flash_log_summary_t summary;
+
+    if (!log || !log->mounted || !timestamp)
+    {
+        return false;
+    }
+
+    flash_log_flush(log);
+
+    for (uint16_t age = 0; age < log->used; age++)
+    {
+        flash_log_get_summary(log, age, &summary);
+        if (summary.record_count != 0)
+        {
+            *timestamp = summary.last_timestamp;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief 统计某类型有效记录数
+ */
+uint32_t flash_log_count(flash_log_t *log, uint8_t type)
+{
+    flash_log_cursor_t cursor;
+    flash_log_entry_t entry;
+    uint32_t count = 0;
+
+    if (!log || !log->mounted)
+    {
+        return 0;
+    }
+
+    flash_log_rewind(log, &cursor);
+    while (flash_log_next(log, &cursor, &entry, NULL, 0))
+    {
+        if (type == FLASH_LOG_TYPE_ANY || entry.type == type)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief 获取回收最旧扇区前还可写入的字节数
+ */
+uint32_t flash_log_get_free_space(const flash_log_t *log)
+{
+    if (!log || !log->mounted)
+    {
+        return 0;
+    }
+
+    // 写入扇区剩余 + 尚未启用的扇区 (预擦除扇区启用后会回收最旧扇区，不计入)
+    uint32_t spare = (uint32_t)(log->sector_count - 1 - log->used);
+    return (uint32_t)(log->sector_size - log->head_offset - log->cache_used) +
+           spare * (uint32_t)(log->sector_size - FLASH_LOG_DATA_START);
+}
+
+/**
+ * @brief 读取扇区擦除次数
+ */
+uint32_t flash_log_get_erase_count(const flash_log_t *log, uint16_t sector)
+{
+    flash_log_sector_t header;
+
+    if (!log || sector >= log->sector_count)
+    {
+        return 0;
+    }
+
+    flash_log_read_header(log, sector, &header);
+    if (header.magic != FLASH_LOG_MAGIC || header.erase_count == 0xFFFFFFFFUL)
+    {
+        return 0;
+    }
+    return header.erase_count;
+}
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief 扇区起始地址
+ */
+static uint32_t flash_log_sector_addr(const flash_log_t *log, uint16_t sector)
+{
+    return log->base + (uint32_t)sector * log->sector_size;
+}
+
+/**
+ * @brief 读取并分类扇区头
+ */
+static flash_log_sector_state_t flash_log_read_header(const flash_log_t *log, uint16_t sector,
+                                                      flash_log_sector_t *header)
+{
+    if (!flash_read(flash_log_sector_addr(log, sector), (uint8_t *)header, sizeof(flash_log_sector_t)))
+    {
+        memset(header, 0, sizeof(flash_log_sector_t));
+        return FLASH_LOG_SECTOR_DIRTY;
+    }
+
+    if (header->magic != FLASH_LOG_MAGIC)
+    {
+        return FLASH_LOG_SECTOR_DIRTY;
+    }
+
+    if (header->sector_sequence == FLASH_LOG_SEQUENCE_FREE && header->first_sequence == FLASH_LOG_SEQUENCE_FREE &&
+        header->crc16 == 0xFFFF)
+    {
+        return FLASH_LOG_SECTOR_FREE;
+    }
+
+    uint16_t crc = storage_crc16_update(0xFFFF, (const uint8_t *)&header->sector_sequence,
+                                        sizeof(header->sector_sequence) + sizeof(header->first_sequence));
+    return crc == header->crc16 ? FLASH_LOG_SECTOR_ACTIVE : FLASH_LOG_SECTOR_DIRTY;
+}
+
+/**
+ * @brief 擦除扇区并写入magic与擦除次数
+ */
+static bool flash_log_erase_sector(flash_log_t *log, uint16_t sector)
+{
+    flash_log_sector_t header;
+    uint32_t address = flash_log_sector_addr(log, sector);
+
+    // 擦除次数沿用扇区头记录，丢失时取已知最大值 (偏保守)
+    flash_log_read_header(log, sector, &header);
+    bool known = header.magic == FLASH_LOG_MAGIC && header.erase_count != 0xFFFFFFFFUL;
+    uint32_t erase_count = known ? header.erase_count : log->max_erase_count;
+
+    for (uint16_t offset = 0; offset < log->sector_size; offset += FLASH_PAGE_SIZE)
+    {
+        if (!flash_erase_page(address + offset))
+        {
+            return false;
+        }
+    }
+
+    erase_count++;
+    if (known && erase_count > log->max_erase_count)
+    {
+        log->max_erase_count = erase_count;
+    }
+    log->stats.erases++;
+
+    // magic最后写入: 有magic即表示擦除已完整完成
+    header.magic = FLASH_LOG_MAGIC;
+    header.erase_count = erase_count;
+    return flash_program(address, (const uint8_t *)&header, offsetof(flash_log_sector_t, sector_sequence));
+}
+
+/**
+ * @brief 启用扇区作为新的写入扇区
+ */
+static bool flash_log_open_sector(flash_log_t *log, uint16_t sector)
+{
+    flash_log_sector_t header;
+
+    if (flash_log_read_header(log, sector, &header) != FLASH_LOG_SECTOR_FREE)
+    {
+        if (!flash_log_erase_sector(log, sector))
+        {
+            return false;
+        }
+    }
+
+    header.sector_sequence = log->head_sequence + 1;
+    header.first_sequence = log->next_sequence;
+    header.crc16 = storage_crc16_update(0xFFFF, (const uint8_t *)&header.sector_sequence,
+                                        sizeof(header.sector_sequence) + sizeof(header.first_sequence));
+    header.reserved = 0xFFFF;
+
+    // 摘要区保持0xFF，扇区写满时再写入
+    uint32_t address = flash_log_sector_addr(log, sector) + offsetof(flash_log_sector_t, sector_sequence);
+    if (!flash_program(address, (const uint8_t *)&header.sector_sequence,
+                       offsetof(flash_log_sector_t, summary) - offsetof(flash_log_sector_t, sector_sequence)))
+    {
+        return false;
+    }
+
+    memset(&log->head_summary, 0, sizeof(flash_log_summary_t));
+
+    log->head = sector;
+    log->head_sequence = header.sector_sequence;
+    log->head_offset = FLASH_LOG_DATA_START;
+    if (log->used < log->sector_count)
+    {
+        log->used++;
+    }
+    return true;
+}
+
+/**
+ * @brief 保证写入扇区之后的扇区已擦除 (必要时回收最旧扇区)
+ */
+static bool flash_log_prepare_ahead(flash_log_t *log)
+{
+    flash_log_sector_t header;
+    uint16_t ahead = (uint16_t)((log->head + 1) % log->sector_count);
+
+    if (flash_log_read_header(log, ahead, &header) == FLASH_LOG_SECTOR_FREE)
+    {
+        return true;
+    }
+
+    // 有效扇区占满整个环时，写入扇区之后就是最旧扇区
+    if (log->used >= log->sector_count)
+    {
+        log->used = (uint16_t)(log->sector_count - 1);
+    }
+
+    return flash_log_erase_sector(log, ahead);
+}
+
+/**
+ * @brief 从offset开始扫描写入扇区，找到写入偏移与下一条记录序号
+ * @note offset之前的记录须已计入head_summary (从扇区起始扫描时为空摘要)
+ */
+static void flash_log_scan_head(flash_log_t *log, uint16_t offset, uint32_t next_sequence)
+{
+    flash_log_entry_t entry;
+
+    log->next_sequence = next_sequence;
+    if (offset == FLASH_LOG_DATA_START)
+    {
+        memset(&log->head_summary, 0, sizeof(flash_log_summary_t));
+    }
+    while (flash_log_read_entry(log, log->head, &offset, log->sector_size, &entry, NULL, 0))
+    {
+        log->next_sequence = entry.sequence + 1;
+        flash_log_note_record(&log->head_summary, &entry);
+    }
+
+    // 停在非空白位置说明末尾记录被掉电撕裂: 该位置不可再编程，本扇区不再写入
+    log->head_offset = offset;
+    if (offset + sizeof(flash_log_entry_t) <= log->sector_size)
+    {
+        flash_log_entry_t blank;
+        memset(&blank, 0xFF, sizeof(blank));
+        flash_read(flash_log_sector_addr(log, log->head) + offset, (uint8_t *)&entry, sizeof(entry));
+        if (memcmp(&entry, &blank, sizeof(entry)) != 0)
+        {
+            log->head_offset = log->sector_size;
+        }
+    }
+}
+
+/**
+ * @brief 读取扇区内offset处的有效记录并前移offset
+ * @return true: 读到有效记录, false: 空白/损坏/超出limit (offset不变)
+ */
+static bool flash_log_read_entry(flash_log_t *log, uint16_t sector, uint16_t *offset, uint16_t limit,
+                                 flash_log_entry_t *entry, void *data, uint8_t max_length)
+{
+    flash_log_entry_t header;
+    uint8_t buffer[32];
+    uint32_t address = flash_log_sector_addr(log, sector) + *offset;
+
+    if (*offset + sizeof(flash_log_entry_t) > limit ||
+        !flash_read(address, (uint8_t *)&header, sizeof(header)))
+    {
+        return false;
+    }
+
+    // 空白: 扇区内记录结束
+    if (header.type == 0xFF && header.sequence == 0xFFFFFFFFUL)
+    {
+        return false;
+    }
+
+    uint16_t size = (uint16_t)(sizeof(flash_log_entry_t) + FLASH_LOG_ALIGN(header.length));
+    if (header.type == FLASH_LOG_TYPE_ANY || header.length == 0 || *offset + size > limit)
+    {
+        log->stats.crc_errors++;
+        return false;
+    }
+
+    // 分块校验数据，同时复制到调用者缓冲区
+    uint16_t crc = storage_crc16_update(0xFFFF, (const uint8_t *)&header, offsetof(flash_log_entry_t, crc16));
+    for (uint16_t done = 0; done < header.length; done += sizeof(buffer))
+    {
+        uint16_t chunk = (uint16_t)(header.length - done) < sizeof(buffer) ? (uint16_t)(header.length - done)
+                                                                           : (uint16_t)sizeof(buffer);
+        if (!flash_read(address + sizeof(header) + done, buffer, chunk))
+        {
+            return false;
+        }
+        crc = storage_crc16_update(crc, buffer, chunk);
+        if (data && done < max_length)
+        {
+            memcpy((uint8_t *)data + done, buffer, (uint16_t)(max_length - done) < chunk ? (max_length - done) : chunk);
+        }
+    }
+
+    if (crc != header.crc16)
+    {
+        log->stats.crc_errors++;
+        return false;
+    }
+
+    if (entry)
+    {
+        *entry = header;
+    }
+    *offset += size;
+    return true;
+}
+
+/**
+ * @brief 扇区可读上限 (写入扇区为当前写入偏移)
+ */
+static uint16_t flash_log_sector_limit(const flash_log_t *log, uint16_t age)
+{
+    return age == 0 ? log->head_offset : log->sector_size;
+}
+
+/**
+ * @brief 在写入偏移处编程并校验一段连续记录
+ */
+static bool flash_log_program(flash_log_t *log, const uint8_t *data, uint16_t length)
+{
+    uint32_t address = flash_log_sector_addr(log, log->head) + log->head_offset;
+
+    if (!flash_program(address, data, length) || !flash_verify(address, data, length))
+    {
+        // 放弃本扇区剩余空间，下次写入换到新扇区
+        log->head_offset = log->sector_size;
+        log->stats.write_errors++;
+        return false;
+    }
+
+    log->head_offset += length;
+    return true;
+}
+
+/**
+ * @brief 将一条已写入的记录计入扇区摘要
+ */
+static void flash_log_note_record(flash_log_summary_t *summary, const flash_log_entry_t *entry)
+{
+    uint16_t size = (uint16_t)(sizeof(flash_log_entry_t) + FLASH_LOG_ALIGN(entry->length));
+
+    if (summary->record_count == 0)
+    {
+        summary->first_timestamp = entry->timestamp;
+        summary->record_size = size;
+    }
+    else if (summary->record_size != size)
+    {
+        summary->record_size = 0;
+    }
+
+    summary->last_timestamp = entry->timestamp;
+    summary->record_count++;
+    summary->type_mask |= FLASH_LOG_TYPE_BIT(entry->type);
+}
+
+/**
+ * @brief 计算扇区摘要校验
+ */
+static uint16_t flash_log_summary_crc(const flash_log_summary_t *summary)
+{
+    return storage_crc16_update(0xFFFF, (const uint8_t *)summary, offsetof(flash_log_summary_t, crc16));
+}
+
+/**
+ * @brief 写入扇区摘要 (切换写入扇区前调用)
+ * @note 写入失败不影响数据，查询时按记录扫描该扇区
+ */
+static void flash_log_close_sector(flash_log_t *log)
+{
+    flash_log_sector_t header;
+    flash_log_summary_t *summary = &log->head_summary;
+
+    // 掉电重启后写入扇区可能已有摘要 (摘要写入后、下一扇区启用前掉电)
+    flash_log_read_header(log, log->head, &header);
+    if (header.summary.record_count != 0xFFFF && header.summary.crc16 == flash_log_summary_crc(&header.summary) &&
+        header.summary.record_count == summary->record_count)
+    {
+        return;
+    }
+
+    summary->crc16 = flash_log_summary_crc(summary);
+    summary->reserved = 0xFFFF;
+    if (!flash_program(flash_log_sector_addr(log, log->head) + offsetof(flash_log_sector_t, summary),
+                       (const uint8_t *)summary, sizeof(flash_log_summary_t)))
+    {
+        log->stats.write_errors++;
+    }
+}
+
+/**
+ * @brief 读取扇区摘要 (写入扇区取RAM摘要，摘要缺失时扫描重建)
+ */
+static void flash_log_get_summary(flash_log_t *log, uint16_t age, flash_log_summary_t *summary)
+{
+    flash_log_sector_t header;
+    flash_log_entry_t entry;
+    uint16_t sector = flash_log_age_sector(log, age);
+
+    if (age == 0)
+    {
+        *summary = log->head_summary;
+        return;
+    }
+
+    flash_log_read_header(log, sector, &header);
+    if (header.summary.record_count != 0xFFFF && header.summary.crc16 == flash_log_summary_crc(&header.summary))
+    {
+        *summary = header.summary;
+        return;
+    }
+
+    uint16_t offset = FLASH_LOG_DATA_START;
+    memset(summary, 0, sizeof(flash_log_summary_t));
+    while (flash_log_read_entry(log, sector, &offset, log->sector_size, &entry, NULL, 0))
+    {
+        flash_log_note_record(summary, &entry);
+    }
+}
+
+/**
+ * @brief 按扇区年龄 (0为写入扇区) 取扇区号
+ */
+static uint16_t flash_log_age_sector(const flash_log_t *log, uint16_t age)
+{
+    return (uint16_t)((log->head + log->sector_count - age) % log->sector_count);
+}
+
+/**
+ * @brief 由最新检查点恢复写入头
+ * @return true: 已恢复, false: 无检查点或与扇区头不符 (须全扫描)
+ */
+static bool flash_log_mount_checkpoint(flash_log_t *log)
+{
+    flash_log_checkpoint_t checkpoint = {0};
+    flash_log_sector_t header;
+
+    if (!flash_log_find_checkpoint(log, &checkpoint) || checkpoint.head >= log->sector_count ||
+        checkpoint.used == 0 || checkpoint.used > log->sector_count ||
+        checkpoint.head_offset < FLASH_LOG_DATA_START || checkpoint.head_offset > log->sector_size)
+    {
+        return false;
+    }
+
+    if (flash_log_read_header(log, checkpoint.head, &header) != FLASH_LOG_SECTOR_ACTIVE ||
+        header.sector_sequence != checkpoint.head_sequence)
+    {
+        return false;
+    }
+
+    log->head = checkpoint.head;
+    log->head_sequence = checkpoint.head_sequence;
+    log->used = checkpoint.used;
+    log->max_erase_count = checkpoint.max_erase_count;
+
+    // 检查点之后启用的扇区 (序号连续)
+    uint16_t opened = 0;
+    while (opened + 1 < log->sector_count)
+    {
+        uint16_t sector = (uint16_t)((log->head + 1) % log->sector_count);
+        if (flash_log_read_header(log, sector, &header) != FLASH_LOG_SECTOR_ACTIVE ||
+            header.sector_sequence != log->head_sequence + 1)
+        {
+            break;
+        }
+        if (header.erase_count > log->max_erase_count)
+        {
+            log->max_erase_count = header.erase_count;
+        }
+        log->head = sector;
+        log->head_sequence = header.sector_sequence;
+        if (log->used < log->sector_count)
+        {
+            log->used++;
+        }
+        opened++;
+    }
+
+    // 有效扇区占满整个环时，最旧扇区可能已被预擦除回收
+    if (!flash_log_check_oldest(log))
+    {
+        if (log->used < log->sector_count)
+        {
+            return false;
+        }
+        log->used--;
+        if (!flash_log_check_oldest(log))
+        {
+            return false;
+        }
+    }
+
+    // 写入扇区未变化时从检查点偏移继续扫描，否则扫描新的写入扇区
+    log->checkpoint_sectors = opened;
+    if (opened == 0)
+    {
+        log->head_summary = checkpoint.summary;
+        flash_log_scan_head(log, checkpoint.head_offset, checkpoint.next_sequence);
+    }
+    else
+    {
+        flash_log_read_header(log, log->head, &header);
+        flash_log_scan_head(log, FLASH_LOG_DATA_START, header.first_sequence);
+    }
+    return true;
+}
+
+/**
+ * @brief 找到最新的有效检查点，并确定下一个写入槽位
+ * @note 只读取每页首槽位与当前页内二分所需的槽位，与日志大小无关
+ */
+static bool flash_log_find_checkpoint(flash_log_t *log, flash_log_checkpoint_t *checkpoint)
+{
+    flash_log_checkpoint_t slot_data;
+    uint32_t best_sequence = 0;
+    uint16_t page = 0;
+    bool found = false;
+
+    if (log->checkpoint_pages == 0)
+    {
+        return false;
+    }
+
+    // 首槽位检查点序号最新的页为当前页
+    for (uint16_t i = 0; i < log->checkpoint_pages; i++)
+    {
+        if (flash_log_read_checkpoint(log, (uint16_t)(i * FLASH_LOG_CHECKPOINT_SLOTS), &slot_data) &&
+            (!found || (int32_t)(slot_data.sequence - best_sequence) > 0))
+        {
+            *checkpoint = slot_data;
+            best_sequence = slot_data.sequence;
+            page = i;
+            found = true;
+        }
+    }
+    if (!found)
+    {
+        log->checkpoint_slot = 0;
+        return false;
+    }
+
+    // 页内槽位顺序写入: 二分找到最后一个已写槽位
+    uint16_t first = (uint16_t)(page * FLASH_LOG_CHECKPOINT_SLOTS);
+    uint16_t low = 0, high = FLASH_LOG_CHECKPOINT_SLOTS;
+    while (high - low > 1)
+    {
+        uint16_t mid = (uint16_t)((low + high) / 2);
+        uint32_t magic;
+        flash_read(log->checkpoint_base + (uint32_t)page * FLASH_PAGE_SIZE + mid * sizeof(flash_log_checkpoint_t),
+                   (uint8_t *)&magic, sizeof(magic));
+        if (magic == 0xFFFFFFFFUL)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid;
+        }
+    }
+
+    // 末尾槽位被掉电撕裂时向前取有效的检查点
+    for (uint16_t i = low; i > 0; i--)
+    {
+        if (flash_log_read_checkpoint(log, (uint16_t)(first + i), &slot_data))
+        {
+            *checkpoint = slot_data;
+            break;
+        }
+    }
+
+    log->checkpoint_slot = (uint16_t)((first + low + 1) % (log->checkpoint_pages * FLASH_LOG_CHECKPOINT_SLOTS));
+    log->checkpoint_sequence = checkpoint->sequence + 1;
+    log->checkpoint_records = checkpoint->next_sequence;
+    return true;
+}
+
+/**
+ * @brief 读取并校验检查点槽位
+ */
+static bool flash_log_read_checkpoint(const flash_log_t *log, uint16_t slot, flash_log_checkpoint_t *checkpoint)
+{
+    uint32_t address = log->checkpoint_base + (uint32_t)(slot / FLASH_LOG_CHECKPOINT_SLOTS) * FLASH_PAGE_SIZE +
+                       (uint32_t)(slot % FLASH_LOG_CHECKPOINT_SLOTS) * sizeof(flash_log_checkpoint_t);
+
+    return flash_read(address, (uint8_t *)checkpoint, sizeof(flash_log_checkpoint_t)) &&
+           checkpoint->magic == FLASH_LOG_CHECKPOINT_MAGIC && checkpoint->crc16 == flash_log_checkpoint_crc(checkpoint);
+}
+
+/**
+ * @brief 计算检查点校验
+ */
+static uint16_t flash_log_checkpoint_crc(const flash_log_checkpoint_t *checkpoint)
+{
+    uint16_t crc = storage_crc16_update(0xFFFF, (const uint8_t *)checkpoint, offsetof(flash_log_checkpoint_t, crc16));
+    return storage_crc16_update(crc, (const uint8_t *)&checkpoint->summary, sizeof(flash_log_summary_t));
+}
+
+/**
+ * @brief 核对最旧扇区的扇区头与有效扇区数一致
+ */
+static bool flash_log_check_oldest(flash_log_t *log)
+{
+    flash_log_sector_t header;
+    uint16_t sector = flash_log_age_sector(log, (uint16_t)(log->used - 1));
+
+    return flash_log_read_header(log, sector, &header) == FLASH_LOG_SECTOR_ACTIVE &&
+           header.sector_sequence == log->head_sequence - (log->used - 1);
+}
+
+/**
+ * @brief 检查点间隔 (扇区数)
+ * @note 检查点所在的写入扇区在其后第(扇区数-1)次启用新扇区时被预擦除回收，间隔须小于此值才能前滚
+ */
+static uint16_t flash_log_checkpoint_interval(const flash_log_t *log)
+{
+    uint16_t limit = log->sector_count > 2 ? (uint16_t)(log->sector_count - 2) : 1;
+    return FLASH_LOG_CHECKPOINT_INTERVAL < limit ? FLASH_LOG_CHECKPOINT_INTERVAL : limit;
+}
@@ -0,0 +1,287 @@
+/**
+ * @file history_codec.c
+ * @brief 憨云DTU传感器历史数据块压缩编码实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 多字节字段按小端序写入，与记录存储格式一致；变长整数每字节7位，最高位为续位
+ */
+
+#include "history_codec.h"
+#include <string.h>
+
+// ============================================================================
+// 内部数据结构
+// ============================================================================
+
+#define HISTORY_CODEC_DELTA_LIMIT 0x3FFFFFFFL // 时间间隔上限 (控制字zigzag后左移1位仍在32位内)
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static uint32_t history_zigzag_encode(int32_t value);
+static int32_t history_zigzag_decode(uint32_t value);
+static uint8_t history_varint_put(uint8_t *buffer, uint32_t value);
+static bool history_varint_get(history_decoder_t *decoder, uint32_t *value);
+static void history_put_u16(uint8_t *buffer, uint16_t value);
+static uint16_t history_get_u16(const uint8_t *buffer);
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+/**
+ * @brief 初始化编码器
+ */
+bool history_encoder_init(history_encoder_t *encoder, uint8_t *buffer, uint16_t capacity)
+{
+    if (!encoder || !buffer || capacity < HISTORY_CODEC_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    memset(encoder, 0, sizeof(history_encoder_t));
+    encoder->buffer = buffer;
+    encoder->capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief 追加一个采样
+ */
+bool history_encoder_add(history_encoder_t *encoder, const history_sample_t *sample)
+{
+    if (!encoder || !encoder->buffer || !sample || encoder->count >= HISTORY_CODEC_MAX_SAMPLES)
+    {
+        return false;
+    }
+
+    // 块内首个采样: 写块头与原值
+    if (encoder->count == 0)
+    {
+        uint8_t *header = encoder->buffer;
+        header[0] = HISTORY_CODEC_VERSION;
+        header[1] = 1;
+        history_put_u16(&header[2], (uint16_t)(sample->timestamp & 0xFFFF));
+        history_put_u16(&header[4], (uint16_t)(sample->timestamp >> 16));
+        history_put_u16(&header[6], (uint16_t)sample->temperature);
+        history_put_u16(&header[8], sample->humidity);
+        history_put_u16(&header[10], sample->voltage);
+        header[12] = sample->status;
+
+        encoder->length = HISTORY_CODEC_HEADER_SIZE;
+        encoder->count = 1;
+        encoder->last = *sample;
+        encoder->last_delta = 0;
+        return true;
+    }
+
+    uint32_t delta = sample->timestamp - encoder->last.timestamp;
+    if (sample->timestamp < encoder->last.timestamp || delta > HISTORY_CODEC_DELTA_LIMIT)
+    {
+        return false;
+    }
+
+    // 先编码到临时缓冲区，放不下时块内容保持不变
+    uint8_t scratch[HISTORY_CODEC_SAMPLE_MAX];
+    uint8_t size = 0;
+    bool status_changed = sample->status != encoder->last.status;
+    int32_t dod = (int32_t)delta - encoder->last_delta;
+
+    size += history_varint_put(&scratch[size], (history_zigzag_encode(dod) << 1) | (status_changed ? 1 : 0));
+    size += history_varint_put(&scratch[size],
+                               history_zigzag_encode((int32_t)sample->temperature - encoder->last.temperature));
+    size += history_varint_put(&scratch[size],
+                               history_zigzag_encode((int32_t)sample->humidity - encoder->last.humidity));
+    size += history_varint_put(&scratch[size],
+                               history_zigzag_encode((int32_t)sample->voltage - encoder->last.voltage));
+    if (status_changed)
+    {
+        scratch[size++] = sample->status;
+    }
+
+    if (encoder->length + size > encoder->capacity)
+    {
+        return false;
+    }
+
+    memcpy(&encoder->buffer[encoder->length], scratch, size);
+    encoder->length += size;
+    encoder->count++;
+    encoder->buffer[1] = encoder->count;
+    encoder->last = *sample;
+    encoder->last_delta = (int32_t)delta;
+    return true;
+}
+
+/**
+ * @brief 获取已编码块长度
+ */
+uint16_t history_encoder_length(const history_encoder_t *encoder)
+{
+    return (encoder && encoder->count) ? encoder->length : 0;
+}
+
+/**
+ * @brief 初始化解码器
+ */
+bool history_decoder_init(history_decoder_t *decoder, const uint8_t *data, uint16_t length)
+{
+    if (!decoder || !data || length < HISTORY_CODEC_HEADER_SIZE || data[0] != HISTORY_CODEC_VERSION ||
+        data[1] == 0)
+    {
+        return false;
+    }
+
+    memset(decoder, 0, sizeof(history_decoder_t));
+    decoder->data = data;
+    decoder->length = length;
+    decoder->remaining = data[1];
+    return true;
+}
+
+/**
+ * @brief 解码下一个采样
+ */
+bool history_decoder_next(history_decoder_t *decoder, history_sample_t *sample)
+{
+    if (!decoder || !sample || decoder->remaining == 0)
+    {
+        return false;
+    }
+
+    if (!decoder->started)
+    {
+        const uint8_t *header = decoder->data;
+        decoder->last.timestamp = history_get_u16(&header[2]) | ((uint32_t)history_get_u16(&header[4]) << 16);
+        decoder->last.temperature = (int16_t)history_get_u16(&header[6]);
+        decoder->last.humidity = history_get_u16(&header[8]);
+        decoder->last.voltage = history_get_u16(&header[10]);
+        decoder->last.status = header[12];
+        decoder->offset = HISTORY_CODEC_HEADER_SIZE;
+        decoder->started = true;
+    }
+    else
+    {
+        uint32_t control, temperature, humidity, voltage;
+        if (!history_varint_get(decoder, &control) || !history_varint_get(decoder, &temperature) ||
+            !history_varint_get(decoder, &humidity) || !history_varint_get(decoder, &voltage))
+        {
+            decoder->remaining = 0;
+            return false;
+        }
+
+        decoder->last_delta += history_zigzag_decode(control >> 1);
+        decoder->last.timestamp += (uint32_t)decoder->last_delta;
+        decoder->last.temperature = (int16_t)(decoder->last.temperature + history_zigzag_decode(temperature));
+        decoder->last.humidity = (uint16_t)(decoder->last.humidity + history_zigzag_decode(humidity));
+        decoder->last.voltage = (uint16_t)(decoder->last.voltage + history_zigzag_decode(voltage));
+
+        if (control & 1)
+        {
+            if (decoder->offset >= decoder->length)
+            {
+                decoder->remaining = 0;
+                return false;
+            }
+            decoder->last.status = decoder->data[decoder->offset++];
+        }
+    }
+
+    decoder->remaining--;
+    *sample = decoder->last;
+    return true;
+}
+
+/**
+ * @brief 读取块内采样数
+ */
+uint8_t history_block_count(const uint8_t *data, uint16_t length)
+{
+    if (!data || length < HISTORY_CODEC_HEADER_SIZE || data[0] != HISTORY_CODEC_VERSION)
+    {
+        return 0;
+    }
+    return data[1];
+}
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief zigzag编码: 小绝对值的有符号数映射为小的无符号数
+ */
+static uint32_t history_zigzag_encode(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+/**
+ * @brief zigzag解码
+ */
+static int32_t history_zigzag_decode(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+/**
+ * @brief 写入变长整数
+ * @return 写入字节数
+ */
+static uint8_t history_varint_put(uint8_t *buffer, uint32_t value)
+{
+    uint8_t size = 0;
+
+    while (value >= 0x80)
+    {
+        buffer[size++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    buffer[size++] = (uint8_t)value;
+    return size;
+}
+
+/**
+ * @brief 读取变长整数 (越界或超过5字节视为损坏)
+ */
+static bool history_varint_get(history_decoder_t *decoder, uint32_t *value)
+{
+    uint32_t result = 0;
+
+    for (uint8_t shift = 0; shift < 35; shift += 7)
+    {
+        if (decoder->offset >= decoder->length)
+        {
+            return false;
+        }
+
+        uint8_t byte = decoder->data[decoder->offset++];
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            *value = result;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief 小端写入16位
+ */
+static void history_put_u16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t)(value & 0xFF);
+    buffer[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief 小端读取16位
+ */
+static uint16_t history_get_u16(const uint8_t *buffer)
+{
+    return (uint16_t)(buffer[0] | ((uint16_t)buffer[1] << 8));
+}
@@ -0,0 +1,481 @@
+/**
+ * @file history_export.c
+ * @brief 憨云DTU历史数据批量导出实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 读取端只保持一个位置: 当前记录 (flash_log游标 + 记录头) 与其已输出的字节数。
+ * 正常发送时按顺序生成块，不需要重新定位；重发/续传时由块起始位置重新定位:
+ * 先按序号定位记录，再按偏移跳过已输出的字节 (偏移可跨越多条记录)。
+ * 记录数据由flash_log_read_data()直接从Flash复制到块缓冲区。
+ */
+
+#include "history_export.h"
+#include "storage.h"
+#include "system.h"
+#include <string.h>
+
+// ============================================================================
+// 内部数据结构
+// ============================================================================
+
+/**
+ * @brief 按时间查找起始记录的上下文
+ */
+typedef struct
+{
+    uint32_t sequence; // 第一条符合条件的记录序号
+    bool found;        // 已找到
+} history_export_find_t;
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static bool history_export_load(history_export_t *exporter);
+static void history_export_seek(history_export_t *exporter, const history_export_position_t *position);
+static void history_export_position(const history_export_t *exporter, history_export_position_t *position);
+static uint16_t history_export_build(history_export_t *exporter, uint8_t *buffer);
+static bool history_export_find_visit(const flash_log_entry_t *entry, const void *data, void *context);
+static void history_export_put16(uint8_t *buffer, uint16_t value);
+static void history_export_put32(uint8_t *buffer, uint32_t value);
+static uint16_t history_export_get16(const uint8_t *buffer);
+static uint32_t history_export_get32(const uint8_t *buffer);
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+/**
+ * @brief 开始导出会话
+ */
+bool history_export_start(history_export_t *exporter, flash_log_t *log, const history_export_request_t *request,
+                          const history_export_transport_t *transport)
+{
+    if (!exporter || !log || !log->mounted || !request || !transport ||
+        transport->mtu < HISTORY_EXPORT_MIN_CHUNK || transport->mtu > HISTORY_EXPORT_MAX_CHUNK ||
+        transport->window == 0 || transport->window > HISTORY_EXPORT_MAX_WINDOW ||
+        request->start_time > request->end_time)
+    {
+        return false;
+    }
+
+    // 会话号跨会话递增，接收方据此丢弃上一会话的迟到块
+    uint8_t session = (uint8_t)(exporter->session + 1);
+    memset(exporter, 0, sizeof(history_export_t));
+    exporter->session = session;
+    exporter->log = log;
+    exporter->transport = *transport;
+    if (exporter->transport.timeout_ms == 0)
+    {
+        exporter->transport.timeout_ms = HISTORY_EXPORT_TIMEOUT_MS;
+    }
+    exporter->type = request->type;
+    exporter->start_time = request->resume ? 0 : request->start_time;
+    exporter->end_time = request->end_time;
+    exporter->end_sequence = log->next_sequence;
+    exporter->ack_time = system_get_tick();
+    exporter->active = true;
+
+    if (request->resume)
+    {
+        history_export_seek(exporter, &request->position);
+    }
+    else
+    {
+        // 按扇区摘要二分找到第一条符合条件的记录
+        history_export_find_t find = {0, false};
+        flash_log_query(log, request->type, request->start_time, request->end_time, history_export_find_visit,
+                        &find);
+        history_export_position_t position = {find.found ? find.sequence : exporter->end_sequence, 0};
+        history_export_seek(exporter, &position);
+    }
+
+    debug_printf("[EXPORT] Session %d started: type=0x%02X, mtu=%d, window=%d\n", exporter->session,
+                 exporter->type, exporter->transport.mtu, exporter->transport.window);
+    return true;
+}
+
+/**
+ * @brief 生成下一个待发送的块
+ */
+uint16_t history_export_poll(history_export_t *exporter, uint8_t *buffer)
+{
+    if (!exporter || !exporter->active || !buffer || exporter->last_built ||
+        (uint16_t)(exporter->next_index - exporter->base_index) >= exporter->transport.window)
+    {
+        return 0;
+    }
+
+    uint16_t length = history_export_build(exporter, buffer);
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    // 窗口为空时发出的块从此刻开始计算确认超时
+    if (exporter->base_index == exporter->next_index)
+    {
+        exporter->ack_time = system_get_tick();
+    }
+
+    if (exporter->eof)
+    {
+        exporter->last_built = true;
+        exporter->last_index = exporter->next_index;
+    }
+    exporter->next_index++;
+    exporter->stats.chunks++;
+    exporter->stats.bytes += length;
+    return length;
+}
+
+/**
+ * @brief 确认块
+ */
+bool history_export_ack(history_export_t *exporter, uint16_t index)
+{
+    if (!exporter || !exporter->active)
+    {
+        return false;
+    }
+
+    uint16_t acked = (uint16_t)(index - exporter->base_index + 1);
+    if (acked == 0 || acked > (uint16_t)(exporter->next_index - exporter->base_index))
+    {
+        return false;
+    }
+
+    exporter->base_index = (uint16_t)(index + 1);
+    exporter->ack_time = system_get_tick();
+    return true;
+}
+
+/**
+ * @brief 从最早未确认块开始重发
+ */
+void history_export_retransmit(history_export_t *exporter)
+{
+    if (!exporter || !exporter->active || exporter->base_index == exporter->next_index)
+    {
+        return;
+    }
+
+    history_export_seek(exporter, &exporter->inflight[exporter->base_index % HISTORY_EXPORT_MAX_WINDOW]);
+    exporter->next_index = exporter->base_index;
+    exporter->last_built = false;
+    exporter->ack_time = system_get_tick();
+    exporter->stats.retransmits++;
+}
+
+/**
+ * @brief 拉取指定编号的块
+ */
+uint16_t history_export_pull(history_export_t *exporter, uint16_t index, uint8_t *buffer)
+{
+    if (!exporter || !exporter->active || !buffer)
+    {
+        return 0;
+    }
+
+    if (index == exporter->next_index)
+    {
+        // 请求下一块: 之前的块均已收到
+        exporter->base_index = exporter->next_index;
+    }
+    else if (index == (uint16_t)(exporter->next_index - 1) && exporter->base_index != exporter->next_index)
+    {
+        // 重复请求上一块 (响应丢失): 重新生成
+        exporter->base_index = index;
+        history_export_retransmit(exporter);
+    }
+    else
+    {
+        return 0;
+    }
+
+    return history_export_poll(exporter, buffer);
+}
+
+/**
+ * @brief 推送式传输的发送任务
+ */
+uint8_t history_export_task(history_export_t *exporter, uint8_t *buffer)
+{
+    uint8_t sent = 0;
+    uint16_t length;
+
+    if (!exporter || !exporter->active || !exporter->transport.send || !buffer)
+    {
+        return 0;
+    }
+
+    if (exporter->base_index != exporter->next_index &&
+        system_get_tick() - exporter->ack_time >= exporter->transport.timeout_ms)
+    {
+        debug_printf("[EXPORT] Ack timeout, resend from chunk %d\n", exporter->base_index);
+        history_export_retransmit(exporter);
+    }
+
+    while ((length = history_export_poll(exporter, buffer)) > 0)
+    {
+        if (!exporter->transport.send(buffer, length, exporter->transport.context))
+        {
+            // 链路忙: 撤回本块，下次调用时重新生成
+            exporter->next_index--;
+            exporter->last_built = false;
+            exporter->stats.chunks--;
+            exporter->stats.bytes -= length;
+            history_export_seek(exporter, &exporter->inflight[exporter->next_index % HISTORY_EXPORT_MAX_WINDOW]);
+            break;
+        }
+        sent++;
+    }
+
+    return sent;
+}
+
+/**
+ * @brief 检查导出是否完成
+ */
+bool history_export_is_done(const history_export_t *exporter)
+{
+    return exporter && exporter->active && exporter->last_built &&
+           exporter->base_index == (uint16_t)(exporter->last_index + 1);
+}
+
+/**
+ * @brief 获取续传位置
+ */
+void history_export_get_resume(const history_export_t *exporter, history_export_position_t *position)
+{
+    if (!exporter || !position)
+    {
+        return;
+    }
+
+    if (exporter->base_index != exporter->next_index)
+    {
+        *position = exporter->inflight[exporter->base_index % HISTORY_EXPORT_MAX_WINDOW];
+    }
+    else
+    {
+        history_export_position(exporter, position);
+    }
+}
+
+/**
+ * @brief 解析并校验块
+ */
+bool history_export_parse_chunk(const uint8_t *data, uint16_t length, history_export_chunk_t *chunk)
+{
+    if (!data || !chunk || length < HISTORY_EXPORT_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    chunk->session = data[0];
+    chunk->flags = data[1];
+    chunk->index = history_export_get16(&data[2]);
+    chunk->position.sequence = history_export_get32(&data[4]);
+    chunk->position.offset = history_export_get16(&data[8]);
+    chunk->length = history_export_get16(&data[10]);
+    if (chunk->length != length - HISTORY_EXPORT_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    uint16_t crc = storage_crc16_update(0xFFFF, data, HISTORY_EXPORT_HEADER_SIZE - 2);
+    crc = storage_crc16_update(crc, data + HISTORY_EXPORT_HEADER_SIZE, chunk->length);
+    return crc == history_export_get16(&data[12]);
+}
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief 读取下一条符合条件的记录
+ * @return true: 已读到, false: 导出范围结束 (置eof)
+ */
+static bool history_export_load(history_export_t *exporter)
+{
+    flash_log_entry_t *entry = &exporter->entry;
+
+    exporter->record_offset = 0;
+    while (flash_log_next(exporter->log, &exporter->cursor, entry, NULL, 0))
+    {
+        if (entry->sequence >= exporter->end_sequence || entry->timestamp > exporter->end_time)
+        {
+            break;
+        }
+        if ((exporter->type != FLASH_LOG_TYPE_ANY && entry->type != exporter->type) ||
+            entry->timestamp < exporter->start_time)
+        {
+            continue;
+        }
+
+        exporter->stats.records++;
+        return true;
+    }
+
+    exporter->eof = true;
+    return false;
+}
+
+/**
+ * @brief 读取端定位到导出位置
+ */
+static void history_export_seek(history_export_t *exporter, const history_export_position_t *position)
+{
+    uint16_t offset = position->offset;
+
+    exporter->eof = false;
+    flash_log_seek(exporter->log, &exporter->cursor, position->sequence);
+    if (!history_export_load(exporter))
+    {
+        return;
+    }
+
+    // 位置所在记录已被回收: 从其后最旧的记录起始处继续，接收方按记录序号发现缺口
+    if (exporter->entry.sequence != position->sequence && offset > 0)
+    {
+        exporter->stats.gaps++;
+        offset = 0;
+    }
+
+    while (offset >= HISTORY_EXPORT_RECORD_HEADER + exporter->entry.length)
+    {
+        offset = (uint16_t)(offset - (HISTORY_EXPORT_RECORD_HEADER + exporter->entry.length));
+        if (!history_export_load(exporter))
+        {
+            return;
+        }
+    }
+    exporter->record_offset = offset;
+}
+
+/**
+ * @brief 读取端当前位置
+ */
+static void history_export_position(const history_export_t *exporter, history_export_position_t *position)
+{
+    if (exporter->eof)
+    {
+        position->sequence = exporter->end_sequence;
+        position->offset = 0;
+    }
+    else
+    {
+        position->sequence = exporter->entry.sequence;
+        position->offset = exporter->record_offset;
+    }
+}
+
+/**
+ * @brief 从读取端当前位置生成块 (编号为next_index)
+ * @return 块长度, 0: 读取失败
+ */
+static uint16_t history_export_build(history_export_t *exporter, uint8_t *buffer)
+{
+    history_export_position_t *start = &exporter->inflight[exporter->next_index % HISTORY_EXPORT_MAX_WINDOW];
+    uint16_t capacity = (uint16_t)(exporter->transport.mtu - HISTORY_EXPORT_HEADER_SIZE);
+    uint8_t *payload = buffer + HISTORY_EXPORT_HEADER_SIZE;
+    uint16_t length = 0;
+    uint8_t retries = 1;
+
+    history_export_position(exporter, start);
+    while (!exporter->eof && length < capacity)
+    {
+        const flash_log_entry_t *entry = &exporter->entry;
+        uint16_t total = (uint16_t)(HISTORY_EXPORT_RECORD_HEADER + entry->length);
+        uint16_t count = (uint16_t)(total - exporter->record_offset);
+
+        if (count > capacity - length)
+        {
+            count = (uint16_t)(capacity - length);
+        }
+
+        if (exporter->record_offset < HISTORY_EXPORT_RECORD_HEADER)
+        {
+            uint8_t header[HISTORY_EXPORT_RECORD_HEADER];
+            history_export_put32(&header[0], entry->sequence);
+            history_export_put32(&header[4], entry->timestamp);
+            header[8] = entry->type;
+            header[9] = entry->length;
+            if (count > HISTORY_EXPORT_RECORD_HEADER - exporter->record_offset)
+            {
+                count = (uint16_t)(HISTORY_EXPORT_RECORD_HEADER - exporter->record_offset);
+            }
+            memcpy(&payload[length], &header[exporter->record_offset], count);
+        }
+        else if (flash_log_read_data(exporter->log, &exporter->cursor, entry,
+                                     (uint16_t)(exporter->record_offset - HISTORY_EXPORT_RECORD_HEADER),
+                                     &payload[length], count) != count)
+        {
+            // 记录在生成过程中被回收: 从块起始位置重新定位 (跳到其后最旧的记录) 后重新生成
+            if (retries-- == 0)
+            {
+                return 0;
+            }
+            history_export_seek(exporter, start);
+            history_export_position(exporter, start);
+            length = 0;
+            continue;
+        }
+
+        length = (uint16_t)(length + count);
+        exporter->record_offset = (uint16_t)(exporter->record_offset + count);
+        if (exporter->record_offset == total)
+        {
+            history_export_load(exporter);
+        }
+    }
+
+    buffer[0] = exporter->session;
+    buffer[1] = exporter->eof ? HISTORY_EXPORT_FLAG_LAST : 0;
+    history_export_put16(&buffer[2], exporter->next_index);
+    history_export_put32(&buffer[4], start->sequence);
+    history_export_put16(&buffer[8], start->offset);
+    history_export_put16(&buffer[10], length);
+    uint16_t crc = storage_crc16_update(0xFFFF, buffer, HISTORY_EXPORT_HEADER_SIZE - 2);
+    crc = storage_crc16_update(crc, payload, length);
+    history_export_put16(&buffer[12], crc);
+
+    return (uint16_t)(HISTORY_EXPORT_HEADER_SIZE + length);
+}
+
+/**
+ * @brief 按时间查找起始记录的回调 (找到第一条即停止)
+ */
+static bool history_export_find_visit(const flash_log_entry_t *entry, const void *data, void *context)
+{
+    history_export_find_t *find = (history_export_find_t *)context;
+
+    (void)data;
+    find->sequence = entry->sequence;
+    find->found = true;
+    return false;
+}
+
+static void history_export_put16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8);
+}
+
+static void history_export_put32(uint8_t *buffer, uint32_t value)
+{
+    history_export_put16(buffer, (uint16_t)value);
+    history_export_put16(buffer + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t history_export_get16(const uint8_t *buffer)
+{
+    return (uint16_t)(buffer[0] | (buffer[1] << 8));
+}
+
+static uint32_t history_export_get32(const uint8_t *buffer)
+{
+    return history_export_get16(buffer) | ((uint32_t)history_export_get16(buffer + 2) << 16);
+}
@@ -0,0 +1,229 @@
+/**
+ * @file history_export_adapter.c
+ * @brief 憨云DTU历史数据导出的传输适配实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include "history_export_adapter.h"
+#include "bluetooth.h"
+#include "mqtt.h"
+#include "storage.h"
+#include "system.h"
+#include <string.h>
+
+// ============================================================================
+// 内部数据结构
+// ============================================================================
+
+/**
+ * @brief 导出适配控制块
+ */
+typedef struct
+{
+    history_export_t session;                       // 导出会话
+    uint8_t buffer[HISTORY_EXPORT_MAX_CHUNK];       // 块缓冲区 (各传输共用)
+    uint16_t ble_conn_handle;                       // BLE连接句柄
+    uint16_t ble_char_handle;                       // BLE导出特征句柄
+    char mqtt_topic[MQTT_MAX_TOPIC_LEN];            // MQTT发布主题
+} history_export_adapter_t;
+
+static history_export_adapter_t g_export;
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static bool history_export_begin(const history_export_request_t *request,
+                                  const history_export_transport_t *transport);
+static bool history_export_ble_send(const uint8_t *chunk, uint16_t length, void *context);
+static bool history_export_mqtt_send(const uint8_t *chunk, uint16_t length, void *context);
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+/**
+ * @brief Modbus写文件记录回调: 发起导出
+ */
+modbus_status_t history_export_modbus_write_file(uint16_t file, uint16_t record, uint16_t length,
+                                                 const uint16_t *values)
+{
+    history_export_request_t request;
+    history_export_transport_t transport = {NULL, NULL, HISTORY_EXPORT_MODBUS_CHUNK, 1, 0};
+
+    if (file != HISTORY_EXPORT_MODBUS_FILE || record != 0)
+    {
+        return MODBUS_STATUS_INVALID_ADDRESS;
+    }
+    if (length != HISTORY_EXPORT_MODBUS_REQUEST_REGS)
+    {
+        return MODBUS_STATUS_INVALID_DATA;
+    }
+
+    request.type = (uint8_t)values[0];
+    request.start_time = ((uint32_t)values[1] << 16) | values[2];
+    request.end_time = ((uint32_t)values[3] << 16) | values[4];
+    request.resume = values[5] != 0;
+    request.position.sequence = ((uint32_t)values[6] << 16) | values[7];
+    request.position.offset = values[8];
+
+    return history_export_begin(&request, &transport) ? MODBUS_STATUS_OK : MODBUS_STATUS_INVALID_DATA;
+}
+
+/**
+ * @brief Modbus读文件记录回调: 拉取块
+ */
+modbus_status_t history_export_modbus_read_file(uint16_t file, uint16_t record, uint16_t length,
+                                                uint16_t *values)
+{
+    if (file != HISTORY_EXPORT_MODBUS_FILE || !g_export.session.active || g_export.session.transport.send)
+    {
+        return MODBUS_STATUS_INVALID_ADDRESS;
+    }
+    if ((uint32_t)length * 2 < HISTORY_EXPORT_MODBUS_CHUNK)
+    {
+        return MODBUS_STATUS_INVALID_DATA;
+    }
+
+    uint16_t size = history_export_pull(&g_export.session, record, g_export.buffer);
+    if (size == 0)
+    {
+        return MODBUS_STATUS_INVALID_ADDRESS;
+    }
+
+    // 块按大端寄存器打包 (奇数长度末字节补0)，其后补0寄存器
+    memset(values, 0, (uint32_t)length * sizeof(uint16_t));
+    for (uint16_t i = 0; i < size; i++)
+    {
+        values[i / 2] |= (uint16_t)(i & 1 ? g_export.buffer[i] : g_export.buffer[i] << 8);
+    }
+    return MODBUS_STATUS_OK;
+}
+
+/**
+ * @brief 通过BLE通知开始导出
+ */
+bool history_export_ble_start(uint16_t conn_handle, uint16_t char_handle, uint16_t att_mtu,
+                              const history_export_request_t *request)
+{
+    history_export_transport_t transport = {history_export_ble_send, NULL, 0, HISTORY_EXPORT_BLE_WINDOW, 0};
+    uint16_t mtu = att_mtu > 3 ? (uint16_t)(att_mtu - 3) : 0;
+
+    transport.mtu = mtu > BLE_MAX_DATA_LEN ? BLE_MAX_DATA_LEN : mtu;
+    g_export.ble_conn_handle = conn_handle;
+    g_export.ble_char_handle = char_handle;
+    return history_export_begin(request, &transport);
+}
+
+/**
+ * @brief 通过MQTT发布开始导出
+ */
+bool history_export_mqtt_start(const char *topic, const history_export_request_t *request)
+{
+    history_export_transport_t transport = {history_export_mqtt_send, NULL, HISTORY_EXPORT_MQTT_CHUNK,
+                                            HISTORY_EXPORT_MQTT_WINDOW, 0};
+
+    if (!topic || strlen(topic) >= sizeof(g_export.mqtt_topic))
+    {
+        return false;
+    }
+
+    strcpy(g_export.mqtt_topic, topic);
+    return history_export_begin(request, &transport);
+}
+
+/**
+ * @brief 处理推送式传输收到的确认
+ */
+bool history_export_on_ack(const uint8_t *data, uint16_t length)
+{
+    if (!data || length != HISTORY_EXPORT_ACK_SIZE || data[0] != g_export.session.session)
+    {
+        return false;
+    }
+
+    return history_export_ack(&g_export.session, (uint16_t)(data[1] | (data[2] << 8)));
+}
+
+/**
+ * @brief 导出后台任务
+ */
+void history_export_adapter_task(void)
+{
+    if (!g_export.session.active || !g_export.session.transport.send)
+    {
+        return;
+    }
+
+    history_export_task(&g_export.session, g_export.buffer);
+    if (history_export_is_done(&g_export.session))
+    {
+        debug_printf("[EXPORT] Session %d done: %lu chunks, %lu bytes, %lu retransmits\n",
+                     g_export.session.session, (unsigned long)g_export.session.stats.chunks,
+                     (unsigned long)g_export.session.stats.bytes, (unsigned long)g_export.session.stats.retransmits);
+        g_export.session.active = false;
+    }
+}
+
+/**
+ * @brief 结束当前导出会话
+ */
+void history_export_stop(void)
+{
+    g_export.session.active = false;
+}
+
+/**
+ * @brief 获取当前导出会话
+ */
+const history_export_t *history_export_get_session(void)
+{
+    return &g_export.session;
+}
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief 按存储数据类型选择记录日志并开始导出 (替换当前会话)
+ */
+static bool history_export_begin(const history_export_request_t *request,
+                                 const history_export_transport_t *transport)
+{
+    history_export_request_t log_request;
+    flash_log_t *log;
+
+    if (!request)
+    {
+        return false;
+    }
+
+    log_request = *request;
+    log = storage_get_export_log(request->type, &log_request.type);
+    if (!log)
+    {
+        return false;
+    }
+
+    return history_export_start(&g_export.session, log, &log_request, transport);
+}
+
+/**
+ * @brief BLE通知发送
+ */
+static bool history_export_ble_send(const uint8_t *chunk, uint16_t length, void *context)
+{
+    (void)context;
+    return ble_send_notification(g_export.ble_conn_handle, g_export.ble_char_handle, chunk, length) == BLE_SUCCESS;
+}
+
+/**
+ * @brief MQTT发布 (QoS1)
+ */
+static bool history_export_mqtt_send(const uint8_t *chunk, uint16_t length, void *context)
+{
+    (void)context;
+    return mqtt_publish(g_export.mqtt_topic, chunk, length, MQTT_QOS_1, false) == MQTT_SUCCESS;
+}
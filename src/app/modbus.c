@@ -8,6 +8,8 @@
 #include "system.h"
 #include "modbus.h"
 #include "uart.h"
+#include "poll_window.h"
+#include "storage.h"
 #include <string.h>
 
 // ============================================================================
@@ -29,6 +31,7 @@ typedef struct
     uint32_t tx_count;                        // 发送计数
     uint32_t rx_count;                        // 接收计数
     uint32_t error_count;                     // 错误计数
+    poll_window_t poll_window;                // 主站轮询周期估计 (从站模式)
     bool initialized;                         // 初始化标志
     bool busy;                                // 忙碌标志
 } modbus_control_t;
@@ -163,6 +166,7 @@ static modbus_status_t modbus_receive_frame(uint8_t *frame, uint16_t *length, ui
 static modbus_status_t modbus_parse_response(const uint8_t *frame, uint16_t length, modbus_request_t *request);
 static modbus_status_t modbus_process_slave_request(const uint8_t *frame, uint16_t length);
 static uint16_t modbus_build_exception_response(uint8_t slave_id, uint8_t function_code, uint8_t exception_code);
+static uint8_t modbus_status_to_exception(modbus_status_t status);
 
 // ============================================================================
 // 公共接口实现
@@ -214,11 +218,18 @@ modbus_status_t modbus_init(const modbus_config_t *config)
     g_modbus.rx_count = 0;
     g_modbus.error_count = 0;
     g_modbus.busy = false;
+    poll_window_init(&g_modbus.poll_window, g_modbus.last_activity_time);
     g_modbus.initialized = true;
 
     // 清空回调函数
     memset(&g_modbus.slave_callbacks, 0, sizeof(modbus_slave_callbacks_t));
 
+    // 从站: 存储后台擦除避开主站轮询请求
+    if (config->role == MODBUS_ROLE_SLAVE)
+    {
+        storage_set_idle_check(modbus_is_idle, NULL);
+    }
+
     if (config->enable_debug)
     {
         debug_printf("[MODBUS] Initialized - Role: %s, Port: %d, Baud: %d\n",
@@ -242,6 +253,11 @@ modbus_status_t modbus_deinit(void)
     // 禁用UART
     uart_enable(g_modbus.config.uart_port, false);
 
+    if (g_modbus.config.role == MODBUS_ROLE_SLAVE)
+    {
+        storage_set_idle_check(NULL, NULL);
+    }
+
     // 清空控制块
     memset(&g_modbus, 0, sizeof(modbus_control_t));
 
@@ -302,6 +318,7 @@ void modbus_task(void)
             // 处理接收到的帧
             if (g_modbus.config.role == MODBUS_ROLE_SLAVE)
             {
+                poll_window_request(&g_modbus.poll_window, g_modbus.last_activity_time);
                 modbus_process_slave_request(g_modbus.rx_buffer, g_modbus.rx_length);
             }
             else
@@ -329,6 +346,26 @@ void modbus_task(void)
     }
 }
 
+/**
+ * @brief 判断总线能否容忍一段阻塞
+ */
+bool modbus_is_idle(uint32_t duration_ms, void *context)
+{
+    (void)context;
+
+    if (!g_modbus.initialized)
+    {
+        return true;
+    }
+
+    // 已有请求字节到达时先响应
+    if (uart_get_rx_count(g_modbus.config.uart_port) > 0)
+    {
+        return false;
+    }
+    return poll_window_idle(&g_modbus.poll_window, system_get_tick(), duration_ms);
+}
+
 // ============================================================================
 // Modbus主站接口实现
 // ============================================================================
@@ -862,6 +899,89 @@ static modbus_status_t modbus_process_slave_request(const uint8_t *frame, uint16
         break;
     }
 
+    case MODBUS_FC_READ_FILE_RECORD: // 读文件记录 (支持单个子请求)
+    {
+        uint8_t byte_count = frame[2];
+        uint16_t file = (frame[4] << 8) | frame[5];
+        uint16_t record = (frame[6] << 8) | frame[7];
+        uint16_t quantity = (frame[8] << 8) | frame[9];
+        uint16_t values[MODBUS_FILE_RECORD_MAX_READ];
+
+        if (!g_modbus.slave_callbacks.read_file_record)
+        {
+            response_length = modbus_build_exception_response(slave_id, function_code, 0x01); // 非法功能
+            break;
+        }
+        if (length != 12 || byte_count != 7 || frame[3] != MODBUS_FILE_REFERENCE_TYPE || quantity == 0 ||
+            quantity > MODBUS_FILE_RECORD_MAX_READ)
+        {
+            response_length = modbus_build_exception_response(slave_id, function_code, 0x03); // 非法数据值
+            break;
+        }
+
+        modbus_status_t file_status = g_modbus.slave_callbacks.read_file_record(file, record, quantity, values);
+        if (file_status != MODBUS_STATUS_OK)
+        {
+            response_length = modbus_build_exception_response(slave_id, function_code,
+                                                              modbus_status_to_exception(file_status));
+            break;
+        }
+
+        // 构建响应: [响应长度][子响应长度][引用类型][数据]
+        g_modbus.tx_buffer[0] = slave_id;
+        g_modbus.tx_buffer[1] = function_code;
+        g_modbus.tx_buffer[2] = (uint8_t)(quantity * 2 + 2);
+        g_modbus.tx_buffer[3] = (uint8_t)(quantity * 2 + 1);
+        g_modbus.tx_buffer[4] = MODBUS_FILE_REFERENCE_TYPE;
+        for (uint16_t i = 0; i < quantity; i++)
+        {
+            g_modbus.tx_buffer[5 + i * 2] = (values[i] >> 8) & 0xFF;
+            g_modbus.tx_buffer[6 + i * 2] = values[i] & 0xFF;
+        }
+
+        response_length = 5 + quantity * 2;
+        break;
+    }
+
+    case MODBUS_FC_WRITE_FILE_RECORD: // 写文件记录 (支持单个子请求)
+    {
+        uint8_t byte_count = frame[2];
+        uint16_t file = (frame[4] << 8) | frame[5];
+        uint16_t record = (frame[6] << 8) | frame[7];
+        uint16_t quantity = (frame[8] << 8) | frame[9];
+        uint16_t values[MODBUS_FILE_RECORD_MAX_WRITE];
+
+        if (!g_modbus.slave_callbacks.write_file_record)
+        {
+            response_length = modbus_build_exception_response(slave_id, function_code, 0x01); // 非法功能
+            break;
+        }
+        if (length < 12 || quantity == 0 || quantity > MODBUS_FILE_RECORD_MAX_WRITE ||
+            byte_count != 7 + quantity * 2 || length != 5 + byte_count || frame[3] != MODBUS_FILE_REFERENCE_TYPE)
+        {
+            response_length = modbus_build_exception_response(slave_id, function_code, 0x03); // 非法数据值
+            break;
+        }
+
+        for (uint16_t i = 0; i < quantity; i++)
+        {
+            values[i] = (frame[10 + i * 2] << 8) | frame[11 + i * 2];
+        }
+
+        modbus_status_t file_status = g_modbus.slave_callbacks.write_file_record(file, record, quantity, values);
+        if (file_status != MODBUS_STATUS_OK)
+        {
+            response_length = modbus_build_exception_response(slave_id, function_code,
+                                                              modbus_status_to_exception(file_status));
+            break;
+        }
+
+        // 构建响应 (回显请求)
+        memcpy(g_modbus.tx_buffer, frame, length - 2);
+        response_length = length - 2;
+        break;
+    }
+
     default:
         // 不支持的功能码
         response_length = modbus_build_exception_response(slave_id, function_code, 0x01); // 非法功能
@@ -920,6 +1040,24 @@ static uint16_t modbus_build_exception_response(uint8_t slave_id, uint8_t functi
     return index;
 }
 
+/**
+ * @brief 回调返回的状态转换为异常码
+ */
+static uint8_t modbus_status_to_exception(modbus_status_t status)
+{
+    switch (status)
+    {
+    case MODBUS_STATUS_INVALID_ADDRESS:
+        return MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+    case MODBUS_STATUS_INVALID_DATA:
+        return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+    case MODBUS_STATUS_BUSY:
+        return MODBUS_EXCEPTION_SLAVE_DEVICE_BUSY;
+    default:
+        return MODBUS_EXCEPTION_SLAVE_DEVICE_FAILURE;
+    }
+}
+
 /**
  * @brief Modbus处理函数 (供main.c调用，避免函数名冲突)
  */
@@ -0,0 +1,855 @@
+/**
+ * @file mqtt_queue.c
+ * @brief 憨云DTU MQTT QoS1离线发布队列 (存储转发) 实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include "mqtt_queue.h"
+#include "flash_log.h"
+#include "system.h"
+#include <stddef.h>
+#include <string.h>
+
+// ============================================================================
+// 内部宏定义
+// ============================================================================
+
+#define MQTT_QUEUE_RAM_MASK (MQTT_QUEUE_RAM_SIZE - 1)
+#define MQTT_QUEUE_ENTRY_HEADER 2 // RAM条目头: [载荷长度][主题编号]
+
+#if (MQTT_QUEUE_RAM_SIZE & MQTT_QUEUE_RAM_MASK) != 0
+#error "MQTT_QUEUE_RAM_SIZE must be a power of two"
+#endif
+
+#if MQTT_QUEUE_FLASH_BATCH > FLASH_LOG_MAX_LENGTH
+#error "MQTT_QUEUE_FLASH_BATCH must fit in one flash log record"
+#endif
+
+#if (MQTT_QUEUE_ENTRY_HEADER + MQTT_QUEUE_MAX_PAYLOAD) > MQTT_QUEUE_FLASH_BATCH
+#error "MQTT_QUEUE_MAX_PAYLOAD must fit in one flash batch"
+#endif
+
+// 默认配置
+#define MQTT_QUEUE_DEFAULT_RESERVE 1           // 为实时消息保留1个槽位
+#define MQTT_QUEUE_DEFAULT_BURST 4             // 每周期4条积压
+#define MQTT_QUEUE_DEFAULT_DRAIN_INTERVAL 500  // 排放周期500ms (约8条/秒)
+#define MQTT_QUEUE_DEFAULT_RETRY 10000         // PUBACK超时10s
+
+// ============================================================================
+// 内部数据结构
+// ============================================================================
+
+/**
+ * @brief 窗口槽位状态
+ */
+typedef enum
+{
+    MQTT_QUEUE_SLOT_FREE = 0, // 空闲
+    MQTT_QUEUE_SLOT_SEND,     // 待发送 (首次发送失败或重连后待重发)
+    MQTT_QUEUE_SLOT_WAIT      // 已发出，等待PUBACK
+} mqtt_queue_slot_state_t;
+
+/**
+ * @brief 窗口槽位 (在途消息副本，用于重发)
+ */
+typedef struct
+{
+    uint8_t state;                           // 槽位状态
+    uint8_t topic;                           // 主题编号
+    uint8_t length;                          // 载荷长度
+    bool from_flash;                         // 取自Flash积压 (确认后推进提交点)
+    uint8_t index;                           // Flash记录内消息序号
+    uint16_t packet_id;                      // 报文ID (0: 尚未发出)
+    uint32_t sequence;                       // Flash记录序号
+    uint32_t sent_time;                      // 最近发送时刻
+    uint8_t payload[MQTT_QUEUE_MAX_PAYLOAD]; // 载荷
+} mqtt_queue_slot_t;
+
+/**
+ * @brief Flash积压中的消息位置 (Flash格式，即提交记录)
+ */
+typedef struct
+{
+    uint32_t sequence; // 所在记录序号
+    uint16_t index;    // 记录内消息序号
+    uint16_t reserved; // 保留 (0)
+} mqtt_queue_position_t;
+
+/**
+ * @brief 队列控制块
+ */
+typedef struct
+{
+    bool initialized;           // 已初始化
+    mqtt_queue_config_t config; // 配置
+
+    const char *topics[MQTT_QUEUE_MAX_TOPICS]; // 主题表
+    uint8_t topic_count;                       // 主题数
+
+    uint8_t ram[MQTT_QUEUE_RAM_SIZE]; // RAM环
+    uint16_t ram_head;                // 写入位置 (自由计数)
+    uint16_t ram_tail;                // 最旧条目位置 (自由计数)
+
+    mqtt_queue_slot_t slots[MQTT_QUEUE_WINDOW]; // 在途窗口
+    uint8_t in_flight;                          // 占用的槽位数
+
+    flash_log_t log;                 // Flash溢出区记录日志
+    flash_log_cursor_t cursor;       // 下一条待读取的Flash记录
+    flash_log_entry_t batch;         // 正在取出的Flash记录 (batch_active时有效)
+    bool batch_active;               // 正在取出的记录中还有消息
+    uint8_t batch_index;             // 下一条消息在记录内的序号
+    uint16_t batch_offset;           // 下一条消息在记录数据内的偏移
+    uint32_t flash_next;             // 游标处预期的记录序号 (用于发现被回收的积压)
+    mqtt_queue_position_t committed; // 最近提交点 (之前的消息均已确认)
+    uint16_t uncommitted;            // 上次提交以来确认的Flash消息数
+    uint32_t last_timestamp;   // 最近记录时间戳 (保证单调)
+
+    uint32_t drain_time; // 当前排放周期开始时刻
+    uint8_t drain_count; // 当前排放周期已发出的积压数
+
+    mqtt_queue_stats_t stats; // 统计
+} mqtt_queue_control_t;
+
+// ============================================================================
+// 全局变量
+// ============================================================================
+
+static mqtt_queue_control_t g_queue;
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static uint16_t mqtt_queue_ram_used(void);
+static void mqtt_queue_ram_copy_in(uint16_t position, const uint8_t *data, uint16_t length);
+static void mqtt_queue_ram_copy_out(uint16_t position, uint8_t *data, uint16_t length);
+static bool mqtt_queue_ram_push(uint8_t topic, const uint8_t *payload, uint8_t length);
+static bool mqtt_queue_ram_take(mqtt_queue_slot_t *slot);
+static bool mqtt_queue_spill_oldest(void);
+static bool mqtt_queue_flash_take(mqtt_queue_slot_t *slot);
+static bool mqtt_queue_flash_open(void);
+static bool mqtt_queue_batch_header(const flash_log_cursor_t *cursor, const flash_log_entry_t *entry,
+                                    uint16_t offset, uint8_t *header);
+static void mqtt_queue_flash_restore(void);
+static uint32_t mqtt_queue_flash_count(const flash_log_cursor_t *from, uint32_t *first_sequence);
+static void mqtt_queue_flash_resync(const flash_log_cursor_t *from, bool sync_next);
+static void mqtt_queue_commit(bool force);
+static uint32_t mqtt_queue_timestamp(void);
+static mqtt_queue_slot_t *mqtt_queue_slot_alloc(void);
+static void mqtt_queue_slot_free(mqtt_queue_slot_t *slot);
+static bool mqtt_queue_send(mqtt_queue_slot_t *slot);
+
+// ============================================================================
+// 公共函数实现
+// ============================================================================
+
+bool mqtt_queue_init(const mqtt_queue_config_t *config)
+{
+    mqtt_queue_config_t defaults = {MQTT_QUEUE_WINDOW, MQTT_QUEUE_DEFAULT_RESERVE, MQTT_QUEUE_DEFAULT_BURST,
+                                    MQTT_QUEUE_DEFAULT_DRAIN_INTERVAL, MQTT_QUEUE_DEFAULT_RETRY};
+
+    if (!config)
+    {
+        config = &defaults;
+    }
+    if (config->window == 0 || config->window > MQTT_QUEUE_WINDOW || config->live_reserve >= config->window ||
+        config->drain_burst == 0 || config->retry_ms == 0)
+    {
+        return false;
+    }
+
+    memset(&g_queue, 0, sizeof(g_queue));
+    g_queue.config = *config;
+
+    // Flash溢出区不可用时只使用RAM环
+    if (flash_log_mount(&g_queue.log, MQTT_QUEUE_FLASH_ADDR, STORAGE_SECTOR_SIZE,
+                        (uint16_t)(MQTT_QUEUE_FLASH_SIZE / STORAGE_SECTOR_SIZE)))
+    {
+        flash_log_get_last_timestamp(&g_queue.log, &g_queue.last_timestamp);
+        mqtt_queue_flash_restore();
+    }
+
+    g_queue.stats.ram_footprint = (uint16_t)sizeof(g_queue);
+    g_queue.initialized = true;
+    return true;
+}
+
+int mqtt_queue_add_topic(const char *topic)
+{
+    if (!g_queue.initialized || !topic || topic[0] == '\0' || g_queue.topic_count >= MQTT_QUEUE_MAX_TOPICS)
+    {
+        return -1;
+    }
+
+    g_queue.topics[g_queue.topic_count] = topic;
+    return g_queue.topic_count++;
+}
+
+bool mqtt_queue_publish(uint8_t topic, const void *payload, uint8_t length)
+{
+    if (!g_queue.initialized || topic >= g_queue.topic_count || !payload || length == 0 ||
+        length > MQTT_QUEUE_MAX_PAYLOAD)
+    {
+        return false;
+    }
+
+    g_queue.stats.enqueued++;
+
+    // 在线且窗口有空位: 直接发出，不排在积压之后
+    if (mqtt_is_connected() && g_queue.in_flight < g_queue.config.window)
+    {
+        mqtt_queue_slot_t *slot = mqtt_queue_slot_alloc();
+
+        slot->topic = topic;
+        slot->length = length;
+        memcpy(slot->payload, payload, length);
+        g_queue.stats.sent_live++;
+        mqtt_queue_send(slot);
+        return true;
+    }
+
+    return mqtt_queue_ram_push(topic, (const uint8_t *)payload, length);
+}
+
+void mqtt_queue_on_event(const mqtt_event_t *event)
+{
+    if (!g_queue.initialized || !event)
+    {
+        return;
+    }
+
+    switch (event->event)
+    {
+    case MQTT_EVENT_CONNECTED:
+        // 窗口内未确认的消息以原报文ID重发，积压排放重新计周期
+        for (uint8_t i = 0; i < MQTT_QUEUE_WINDOW; i++)
+        {
+            if (g_queue.slots[i].state != MQTT_QUEUE_SLOT_FREE)
+            {
+                g_queue.slots[i].state = MQTT_QUEUE_SLOT_SEND;
+            }
+        }
+        g_queue.drain_time = system_get_tick();
+        g_queue.drain_count = 0;
+        break;
+
+    case MQTT_EVENT_MESSAGE_SENT:
+    {
+        if (!event->data)
+        {
+            break;
+        }
+
+        uint16_t packet_id = *(const uint16_t *)event->data;
+        for (uint8_t i = 0; i < MQTT_QUEUE_WINDOW; i++)
+        {
+            mqtt_queue_slot_t *slot = &g_queue.slots[i];
+            if (slot->state != MQTT_QUEUE_SLOT_FREE && slot->packet_id == packet_id)
+            {
+                bool from_flash = slot->from_flash;
+
+                mqtt_queue_slot_free(slot);
+                g_queue.stats.acked++;
+                if (from_flash)
+                {
+                    g_queue.uncommitted++;
+                    mqtt_queue_commit(false);
+                }
+                break;
+            }
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+void mqtt_queue_task(void)
+{
+    if (!g_queue.initialized || !mqtt_is_connected())
+    {
+        return;
+    }
+
+    uint32_t now = system_get_tick();
+
+    // 重连后待重发及PUBACK超时的消息
+    for (uint8_t i = 0; i < MQTT_QUEUE_WINDOW; i++)
+    {
+        mqtt_queue_slot_t *slot = &g_queue.slots[i];
+        if (slot->state == MQTT_QUEUE_SLOT_SEND ||
+            (slot->state == MQTT_QUEUE_SLOT_WAIT && now - slot->sent_time >= g_queue.config.retry_ms))
+        {
+            if (!mqtt_queue_send(slot))
+            {
+                return;
+            }
+        }
+    }
+
+    // 分速排放积压: 每周期最多drain_burst条，且不占用保留给实时消息的槽位
+    if (now - g_queue.drain_time >= g_queue.config.drain_interval_ms)
+    {
+        g_queue.drain_time = now;
+        g_queue.drain_count = 0;
+    }
+    while (g_queue.drain_count < g_queue.config.drain_burst &&
+           g_queue.in_flight + g_queue.config.live_reserve < g_queue.config.window)
+    {
+        mqtt_queue_slot_t *slot = mqtt_queue_slot_alloc();
+
+        // Flash中的积压早于RAM环中的
+        if (!mqtt_queue_flash_take(slot) && !mqtt_queue_ram_take(slot))
+        {
+            mqtt_queue_slot_free(slot);
+            break;
+        }
+
+        g_queue.drain_count++;
+        g_queue.stats.drained++;
+        if (!mqtt_queue_send(slot))
+        {
+            break;
+        }
+    }
+
+    // Flash积压全部确认后写入提交点
+    mqtt_queue_commit(true);
+}
+
+bool mqtt_queue_flush(void)
+{
+    if (!g_queue.initialized)
+    {
+        return false;
+    }
+
+    while (mqtt_queue_ram_used() > 0)
+    {
+        if (!g_queue.log.mounted)
+        {
+            return false;
+        }
+        mqtt_queue_spill_oldest();
+    }
+    return true;
+}
+
+uint32_t mqtt_queue_pending(void)
+{
+    if (!g_queue.initialized)
+    {
+        return 0;
+    }
+
+    return g_queue.stats.ram_messages + g_queue.stats.flash_pending + g_queue.in_flight;
+}
+
+bool mqtt_queue_get_stats(mqtt_queue_stats_t *stats)
+{
+    if (!g_queue.initialized || !stats)
+    {
+        return false;
+    }
+
+    *stats = g_queue.stats;
+    stats->ram_used = mqtt_queue_ram_used();
+    stats->in_flight = g_queue.in_flight;
+    stats->flash_used = g_queue.log.mounted ? (MQTT_QUEUE_FLASH_SIZE - flash_log_get_free_space(&g_queue.log)) : 0;
+    return true;
+}
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief RAM环已用字节数
+ */
+static uint16_t mqtt_queue_ram_used(void)
+{
+    return (uint16_t)(g_queue.ram_head - g_queue.ram_tail);
+}
+
+/**
+ * @brief 写入RAM环 (跨越环尾时分两段)
+ */
+static void mqtt_queue_ram_copy_in(uint16_t position, const uint8_t *data, uint16_t length)
+{
+    uint16_t offset = position & MQTT_QUEUE_RAM_MASK;
+    uint16_t first = (uint16_t)(MQTT_QUEUE_RAM_SIZE - offset);
+
+    if (first > length)
+    {
+        first = length;
+    }
+    memcpy(&g_queue.ram[offset], data, first);
+    memcpy(g_queue.ram, data + first, length - first);
+}
+
+/**
+ * @brief 读出RAM环 (跨越环尾时分两段)
+ */
+static void mqtt_queue_ram_copy_out(uint16_t position, uint8_t *data, uint16_t length)
+{
+    uint16_t offset = position & MQTT_QUEUE_RAM_MASK;
+    uint16_t first = (uint16_t)(MQTT_QUEUE_RAM_SIZE - offset);
+
+    if (first > length)
+    {
+        first = length;
+    }
+    memcpy(data, &g_queue.ram[offset], first);
+    memcpy(data + first, g_queue.ram, length - first);
+}
+
+/**
+ * @brief 消息进入RAM环，空间不足时最旧的条目溢出到Flash
+ */
+static bool mqtt_queue_ram_push(uint8_t topic, const uint8_t *payload, uint8_t length)
+{
+    uint16_t size = (uint16_t)(MQTT_QUEUE_ENTRY_HEADER + length);
+    uint8_t header[MQTT_QUEUE_ENTRY_HEADER] = {length, topic};
+
+    while (MQTT_QUEUE_RAM_SIZE - mqtt_queue_ram_used() < size)
+    {
+        mqtt_queue_spill_oldest();
+    }
+
+    mqtt_queue_ram_copy_in(g_queue.ram_head, header, MQTT_QUEUE_ENTRY_HEADER);
+    mqtt_queue_ram_copy_in((uint16_t)(g_queue.ram_head + MQTT_QUEUE_ENTRY_HEADER), payload, length);
+    g_queue.ram_head = (uint16_t)(g_queue.ram_head + size);
+    g_queue.stats.ram_messages++;
+
+    uint16_t used = mqtt_queue_ram_used();
+    if (used > g_queue.stats.ram_peak)
+    {
+        g_queue.stats.ram_peak = used;
+    }
+    return true;
+}
+
+/**
+ * @brief 从RAM环取出最旧的消息
+ */
+static bool mqtt_queue_ram_take(mqtt_queue_slot_t *slot)
+{
+    uint8_t header[MQTT_QUEUE_ENTRY_HEADER];
+
+    if (mqtt_queue_ram_used() == 0)
+    {
+        return false;
+    }
+
+    mqtt_queue_ram_copy_out(g_queue.ram_tail, header, MQTT_QUEUE_ENTRY_HEADER);
+    slot->length = header[0];
+    slot->topic = header[1];
+    mqtt_queue_ram_copy_out((uint16_t)(g_queue.ram_tail + MQTT_QUEUE_ENTRY_HEADER), slot->payload, slot->length);
+    g_queue.ram_tail = (uint16_t)(g_queue.ram_tail + MQTT_QUEUE_ENTRY_HEADER + slot->length);
+    g_queue.stats.ram_messages--;
+    return true;
+}
+
+/**
+ * @brief RAM环最旧的若干条目打包转存到Flash (Flash不可用或写入失败时丢弃)
+ * @return true: 已转存
+ * @note 记录数据与RAM条目格式相同，未跨越环尾时直接写入
+ */
+static bool mqtt_queue_spill_oldest(void)
+{
+    uint8_t header[MQTT_QUEUE_ENTRY_HEADER];
+    uint8_t record[MQTT_QUEUE_FLASH_BATCH];
+    uint16_t offset = g_queue.ram_tail & MQTT_QUEUE_RAM_MASK;
+    const uint8_t *data = &g_queue.ram[offset];
+    uint16_t used = mqtt_queue_ram_used();
+    uint16_t size = 0;
+    uint16_t count = 0;
+    bool stored = false;
+
+    // 从最旧条目起打包不超过MQTT_QUEUE_FLASH_BATCH字节的连续条目
+    while (size < used)
+    {
+        mqtt_queue_ram_copy_out((uint16_t)(g_queue.ram_tail + size), header, MQTT_QUEUE_ENTRY_HEADER);
+        uint16_t entry = (uint16_t)(MQTT_QUEUE_ENTRY_HEADER + header[0]);
+
+        if (size + entry > MQTT_QUEUE_FLASH_BATCH)
+        {
+            break;
+        }
+        size = (uint16_t)(size + entry);
+        count++;
+    }
+    if (offset + size > MQTT_QUEUE_RAM_SIZE)
+    {
+        mqtt_queue_ram_copy_out(g_queue.ram_tail, record, size);
+        data = record;
+    }
+
+    if (g_queue.log.mounted)
+    {
+        stored = flash_log_append(&g_queue.log, MQTT_QUEUE_TYPE_MESSAGE, mqtt_queue_timestamp(), data, (uint8_t)size);
+    }
+
+    g_queue.ram_tail = (uint16_t)(g_queue.ram_tail + size);
+    g_queue.stats.ram_messages = (uint16_t)(g_queue.stats.ram_messages - count);
+    if (!stored)
+    {
+        g_queue.stats.dropped += count;
+        return false;
+    }
+    g_queue.stats.flash_pending += count;
+    g_queue.stats.spilled += count;
+
+    // 写满后回收了游标所在的扇区: 其中未发出的积压已丢失，从最旧记录重新统计
+    if (g_queue.cursor.sector_sequence < g_queue.log.head_sequence - (g_queue.log.used - 1))
+    {
+        flash_log_rewind(&g_queue.log, &g_queue.cursor);
+        g_queue.batch_active = false;
+        mqtt_queue_flash_resync(&g_queue.cursor, true);
+    }
+    return true;
+}
+
+/**
+ * @brief 从Flash积压取出下一条消息
+ */
+static bool mqtt_queue_flash_take(mqtt_queue_slot_t *slot)
+{
+    uint8_t header[MQTT_QUEUE_ENTRY_HEADER];
+
+    if (!g_queue.log.mounted || g_queue.stats.flash_pending == 0)
+    {
+        return false;
+    }
+
+    while (g_queue.batch_active || mqtt_queue_flash_open())
+    {
+        uint16_t offset = g_queue.batch_offset;
+
+        // 记录数据损坏或所在扇区已被回收: 其余消息计入丢弃
+        if (!mqtt_queue_batch_header(&g_queue.cursor, &g_queue.batch, offset, header) ||
+            flash_log_read_data(&g_queue.log, &g_queue.cursor, &g_queue.batch, offset + MQTT_QUEUE_ENTRY_HEADER,
+                                slot->payload, header[0]) != header[0])
+        {
+            g_queue.batch_active = false;
+            mqtt_queue_flash_resync(&g_queue.cursor, false);
+            continue;
+        }
+
+        slot->length = header[0];
+        slot->topic = header[1];
+        slot->from_flash = true;
+        slot->sequence = g_queue.batch.sequence;
+        slot->index = g_queue.batch_index;
+
+        g_queue.batch_offset = (uint16_t)(offset + MQTT_QUEUE_ENTRY_HEADER + header[0]);
+        g_queue.batch_index++;
+        g_queue.batch_active = g_queue.batch_offset < g_queue.batch.length;
+        if (g_queue.stats.flash_pending > 0)
+        {
+            g_queue.stats.flash_pending--;
+        }
+        return true;
+    }
+
+    // 已读到末尾: 计数以游标为准
+    g_queue.stats.flash_pending = 0;
+    return false;
+}
+
+/**
+ * @brief 读取游标处的下一条消息记录，开始取出其中的消息
+ * @return true: 已打开, false: 已到末尾
+ */
+static bool mqtt_queue_flash_open(void)
+{
+    flash_log_entry_t entry;
+
+    for (;;)
+    {
+        flash_log_cursor_t at = g_queue.cursor;
+
+        if (!flash_log_next(&g_queue.log, &g_queue.cursor, &entry, NULL, 0))
+        {
+            return false;
+        }
+
+        // 序号跳跃: 游标处的扇区已被回收，从本条记录起重新统计
+        if (entry.sequence > g_queue.flash_next)
+        {
+            mqtt_queue_flash_resync(&at, false);
+        }
+        g_queue.flash_next = entry.sequence + 1;
+
+        if (entry.type == MQTT_QUEUE_TYPE_MESSAGE)
+        {
+            g_queue.batch = entry;
+            g_queue.batch_offset = 0;
+            g_queue.batch_index = 0;
+            g_queue.batch_active = true;
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief 读取并校验记录内offset处的消息头
+ * @return true: 消息完整位于记录数据内
+ */
+static bool mqtt_queue_batch_header(const flash_log_cursor_t *cursor, const flash_log_entry_t *entry,
+                                    uint16_t offset, uint8_t *header)
+{
+    return offset + MQTT_QUEUE_ENTRY_HEADER <= entry->length &&
+           flash_log_read_data(&g_queue.log, cursor, entry, offset, header, MQTT_QUEUE_ENTRY_HEADER) ==
+               MQTT_QUEUE_ENTRY_HEADER &&
+           header[0] != 0 && header[0] <= MQTT_QUEUE_MAX_PAYLOAD &&
+           offset + MQTT_QUEUE_ENTRY_HEADER + header[0] <= entry->length;
+}
+
+/**
+ * @brief 挂载后恢复提交点与待发出的Flash积压
+ */
+static void mqtt_queue_flash_restore(void)
+{
+    flash_log_entry_t entry;
+    mqtt_queue_position_t value;
+    uint8_t header[MQTT_QUEUE_ENTRY_HEADER];
+    bool found = false;
+
+    // 最新的提交点
+    flash_log_rewind(&g_queue.log, &g_queue.cursor);
+    while (flash_log_next(&g_queue.log, &g_queue.cursor, &entry, &value, sizeof(value)))
+    {
+        if (entry.type == MQTT_QUEUE_TYPE_COMMIT && entry.length == sizeof(value) &&
+            (!found || value.sequence > g_queue.committed.sequence ||
+             (value.sequence == g_queue.committed.sequence && value.index > g_queue.committed.index)))
+        {
+            g_queue.committed = value;
+            found = true;
+        }
+    }
+
+    // 提交点之后的消息为待发出积压 (无提交点时从最旧记录开始)
+    if (!found)
+    {
+        flash_log_rewind(&g_queue.log, &g_queue.cursor);
+        mqtt_queue_flash_resync(&g_queue.cursor, true);
+        return;
+    }
+
+    flash_log_seek(&g_queue.log, &g_queue.cursor, g_queue.committed.sequence);
+    g_queue.flash_next = g_queue.committed.sequence;
+    g_queue.stats.flash_pending = mqtt_queue_flash_count(&g_queue.cursor, NULL);
+
+    // 提交点位于记录中间: 跳过记录内已确认的消息
+    if (g_queue.committed.index > 0 && mqtt_queue_flash_open() && g_queue.batch.sequence == g_queue.committed.sequence)
+    {
+        while (g_queue.batch_index < g_queue.committed.index && g_queue.batch_active &&
+               mqtt_queue_batch_header(&g_queue.cursor, &g_queue.batch, g_queue.batch_offset, header))
+        {
+            g_queue.batch_offset = (uint16_t)(g_queue.batch_offset + MQTT_QUEUE_ENTRY_HEADER + header[0]);
+            g_queue.batch_index++;
+            g_queue.batch_active = g_queue.batch_offset < g_queue.batch.length;
+            g_queue.stats.flash_pending--;
+        }
+    }
+}
+
+/**
+ * @brief 统计from之后的Flash消息数
+ * @param from 起始游标
+ * @param first_sequence 输出首条记录序号 (可为NULL，无记录时为下一条记录序号)
+ * @return 消息数
+ */
+static uint32_t mqtt_queue_flash_count(const flash_log_cursor_t *from, uint32_t *first_sequence)
+{
+    flash_log_cursor_t cursor = *from;
+    flash_log_entry_t entry;
+    uint8_t header[MQTT_QUEUE_ENTRY_HEADER];
+    uint32_t count = 0;
+    bool first = true;
+
+    if (first_sequence)
+    {
+        *first_sequence = g_queue.log.next_sequence;
+    }
+    while (flash_log_next(&g_queue.log, &cursor, &entry, NULL, 0))
+    {
+        if (first && first_sequence)
+        {
+            *first_sequence = entry.sequence;
+        }
+        first = false;
+        if (entry.type != MQTT_QUEUE_TYPE_MESSAGE)
+        {
+            continue;
+        }
+        for (uint16_t offset = 0; mqtt_queue_batch_header(&cursor, &entry, offset, header);
+             offset = (uint16_t)(offset + MQTT_QUEUE_ENTRY_HEADER + header[0]))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 从from处重新统计Flash积压 (挂载后、积压被回收或损坏后)，减少的部分计入丢弃
+ * @param from 起始游标 (其后为全部未取出的Flash消息)
+ * @param sync_next 以from处首条记录的序号作为预期序号
+ */
+static void mqtt_queue_flash_resync(const flash_log_cursor_t *from, bool sync_next)
+{
+    uint32_t pending = mqtt_queue_flash_count(from, sync_next ? &g_queue.flash_next : NULL);
+
+    if (g_queue.stats.flash_pending > pending)
+    {
+        g_queue.stats.dropped += g_queue.stats.flash_pending - pending;
+    }
+    g_queue.stats.flash_pending = pending;
+}
+
+/**
+ * @brief 推进提交点: 确认满MQTT_QUEUE_COMMIT_EVERY条，或force且Flash积压已全部确认时写入提交记录
+ */
+static void mqtt_queue_commit(bool force)
+{
+    mqtt_queue_position_t target = {g_queue.flash_next, 0, 0};
+    bool drained = (g_queue.stats.flash_pending == 0);
+
+    if (!g_queue.log.mounted || g_queue.uncommitted == 0)
+    {
+        return;
+    }
+
+    // 提交点不越过正在取出的记录中未取出的消息及仍在途的Flash消息
+    if (g_queue.batch_active)
+    {
+        target.sequence = g_queue.batch.sequence;
+        target.index = g_queue.batch_index;
+    }
+    for (uint8_t i = 0; i < MQTT_QUEUE_WINDOW; i++)
+    {
+        const mqtt_queue_slot_t *slot = &g_queue.slots[i];
+        if (slot->state != MQTT_QUEUE_SLOT_FREE && slot->from_flash)
+        {
+            drained = false;
+            if (slot->sequence < target.sequence || (slot->sequence == target.sequence && slot->index < target.index))
+            {
+                target.sequence = slot->sequence;
+                target.index = slot->index;
+            }
+        }
+    }
+
+    if (g_queue.uncommitted < MQTT_QUEUE_COMMIT_EVERY && !(force && drained))
+    {
+        return;
+    }
+
+    if (flash_log_append(&g_queue.log, MQTT_QUEUE_TYPE_COMMIT, mqtt_queue_timestamp(), &target, sizeof(target)))
+    {
+        g_queue.committed = target;
+        g_queue.uncommitted = 0;
+        g_queue.stats.commits++;
+    }
+}
+
+/**
+ * @brief Flash记录时间戳 (系统节拍，重启后不小于最后一条记录)
+ */
+static uint32_t mqtt_queue_timestamp(void)
+{
+    uint32_t now = system_get_tick();
+
+    if (now > g_queue.last_timestamp)
+    {
+        g_queue.last_timestamp = now;
+    }
+    return g_queue.last_timestamp;
+}
+
+/**
+ * @brief 分配空闲槽位 (调用者保证in_flight < MQTT_QUEUE_WINDOW)
+ */
+static mqtt_queue_slot_t *mqtt_queue_slot_alloc(void)
+{
+    for (uint8_t i = 0; i < MQTT_QUEUE_WINDOW; i++)
+    {
+        mqtt_queue_slot_t *slot = &g_queue.slots[i];
+        if (slot->state == MQTT_QUEUE_SLOT_FREE)
+        {
+            memset(slot, 0, offsetof(mqtt_queue_slot_t, payload));
+            slot->state = MQTT_QUEUE_SLOT_SEND;
+            g_queue.in_flight++;
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 释放槽位
+ */
+static void mqtt_queue_slot_free(mqtt_queue_slot_t *slot)
+{
+    slot->state = MQTT_QUEUE_SLOT_FREE;
+    g_queue.in_flight--;
+}
+
+/**
+ * @brief 发送槽位中的消息 (首次发送分配报文ID，之后以DUP标志重发)
+ * @return true: 已发出, false: 发送失败 (槽位保持待发送)
+ */
+static bool mqtt_queue_send(mqtt_queue_slot_t *slot)
+{
+    if (slot->topic >= g_queue.topic_count)
+    {
+        // 重启后未重新登记的主题: 无法发出，视为已确认丢弃
+        g_queue.stats.dropped++;
+        if (slot->from_flash)
+        {
+            g_queue.uncommitted++;
+        }
+        mqtt_queue_slot_free(slot);
+        return true;
+    }
+
+    const char *topic = g_queue.topics[slot->topic];
+    if (slot->packet_id == 0)
+    {
+        uint16_t capacity;
+        uint8_t *payload = mqtt_publish_begin(topic, MQTT_QOS_1, false, &capacity);
+
+        if (!payload || capacity < slot->length)
+        {
+            slot->state = MQTT_QUEUE_SLOT_SEND;
+            return false;
+        }
+        memcpy(payload, slot->payload, slot->length);
+
+        int result = mqtt_publish_commit(slot->length);
+        if (result <= 0)
+        {
+            slot->state = MQTT_QUEUE_SLOT_SEND;
+            return false;
+        }
+        slot->packet_id = (uint16_t)result;
+    }
+    else
+    {
+        if (mqtt_publish_retry(topic, slot->payload, slot->length, slot->packet_id) != MQTT_SUCCESS)
+        {
+            slot->state = MQTT_QUEUE_SLOT_SEND;
+            return false;
+        }
+        g_queue.stats.retransmits++;
+    }
+
+    slot->state = MQTT_QUEUE_SLOT_WAIT;
+    slot->sent_time = system_get_tick();
+    return true;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file poll_window.c
+ * @brief 憨云DTU总线轮询空闲窗口预测实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include "poll_window.h"
+#include <string.h>
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+/**
+ * @brief 初始化
+ */
+void poll_window_init(poll_window_t *window, uint32_t now)
+{
+    if (window)
+    {
+        memset(window, 0, sizeof(poll_window_t));
+        window->last_request = now;
+    }
+}
+
+/**
+ * @brief 记录一次请求到达
+ */
+void poll_window_request(poll_window_t *window, uint32_t now)
+{
+    if (!window)
+    {
+        return;
+    }
+
+    if (window->seen)
+    {
+        uint32_t gap = now - window->last_request;
+
+        // 更短的间隔 (主站加快轮询或插入请求) 立即采用，更长的间隔缓慢跟随
+        if (window->samples == 0 || gap < window->interval)
+        {
+            window->interval = gap;
+        }
+        else
+        {
+            window->interval += (gap - window->interval) >> POLL_WINDOW_FOLLOW_SHIFT;
+        }
+        if (window->samples < POLL_WINDOW_MIN_SAMPLES)
+        {
+            window->samples++;
+        }
+    }
+
+    window->last_request = now;
+    window->seen = true;
+}
+
+/**
+ * @brief 判断一段阻塞时间内是否预计没有请求到达
+ */
+bool poll_window_idle(const poll_window_t *window, uint32_t now, uint32_t duration_ms)
+{
+    if (!window)
+    {
+        return true;
+    }
+
+    uint32_t elapsed = now - window->last_request;
+
+    // 尚未学到轮询周期: 总线静默一段时间后才认为没有主站
+    if (window->samples < POLL_WINDOW_MIN_SAMPLES)
+    {
+        return elapsed >= POLL_WINDOW_LEARN_MS;
+    }
+
+    // 主站停止轮询
+    if (elapsed >= 2 * window->interval)
+    {
+        return true;
+    }
+    return elapsed + duration_ms + POLL_WINDOW_MARGIN_MS <= window->interval;
+}
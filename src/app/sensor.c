@@ -10,6 +10,7 @@
 
 #include "sensor.h"
 #include "system.h"
+#include "trend.h"
 #include "adc.h"
 #include "gpio.h"
 #include <string.h>
@@ -27,13 +28,32 @@ typedef struct
     sensor_config_t config;                     // 配置参数
     sensor_data_t data;                         // 当前数据
     sensor_stats_t stats;                       // 统计信息
-    uint16_t filter_buffer[SENSOR_FILTER_SIZE]; // 滤波缓冲区
-    uint8_t filter_index;                       // 滤波缓冲区索引
-    uint8_t filter_count;                       // 有效滤波数据个数
+    filter_t filter;                            // 数字滤波器
     uint32_t last_sample_time;                  // 上次采样时间
-    float min_threshold;                        // 最小报警阈值
-    float max_threshold;                        // 最大报警阈值
+    q24_t scale_q24;                            // 比例因子 (Q8.24，由config预换算)
+    q16_t offset_q16;                           // 偏移量 (Q16.16)
+    q16_t min_value_q16;                        // 量程下限 (Q16.16)
+    q16_t max_value_q16;                        // 量程上限 (Q16.16)
+    q16_t min_threshold;                        // 最小报警阈值 (Q16.16)
+    q16_t max_threshold;                        // 最大报警阈值 (Q16.16)
     bool threshold_enabled;                     // 阈值报警使能
+    q16_t stat_min_q16;                         // 统计最小值 (Q16.16)
+    q16_t stat_max_q16;                         // 统计最大值 (Q16.16)
+    q16_t stat_avg_q16;                         // 统计平均值 (Q16.16)
+    uint16_t frame_divider;                     // 每N帧处理一次 (采样周期/扫描周期)
+    uint16_t frame_countdown;                   // 距下次处理的帧数
+    uint32_t last_sample_us;                    // 上次采样触发时刻 (us)
+    bool jitter_valid;                          // last_sample_us有效
+    uint32_t jitter_abs_sum_us;                 // 绝对偏差累计
+    sensor_jitter_t jitter;                     // 采样抖动统计
+    q16_t deadband_abs_q16;                     // 绝对死区 (Q16.16)
+    q16_t deadband_rel_q16;                     // 相对死区比例 (Q16.16)
+    q16_t report_value_q16;                     // 上次上报值
+    sensor_status_t report_status;              // 上次上报状态
+    uint32_t report_time;                       // 上次上报时间
+    bool report_valid;                          // 已有上报值
+    const sensor_lut_t *lut;                    // 线性化查找表 (NULL为线性变换)
+    stream_stats_t window_stats;                // 上报窗口流式统计
 } sensor_channel_t;
 
 /**
@@ -46,6 +66,12 @@ typedef struct
     bool scan_enabled;                              // 扫描使能
     uint32_t scan_count;                            // 扫描计数
     uint32_t last_scan_time;                        // 上次扫描时间
+    uint32_t scan_period_ms;                        // 定时器扫描周期 (各通道采样周期的最大公约数)
+    adc_scan_frame_t frame_queue[SENSOR_FRAME_QUEUE_SIZE]; // 采样帧队列 (中断写入，任务读取)
+    volatile uint8_t frame_head;                    // 队列写索引
+    volatile uint8_t frame_tail;                    // 队列读索引
+    uint32_t frame_overflow;                        // 队列满丢帧次数
+    sensor_change_callback_t change_callback;       // 显著变化回调
 } sensor_control_t;
 
 // 全局控制块
@@ -55,10 +81,20 @@ static sensor_control_t g_sensor = {0};
 // 内部函数声明
 // ============================================================================
 
-static float sensor_convert_to_physical(uint8_t channel, uint16_t raw_value);
+static q16_t sensor_convert_to_physical(uint8_t channel, uint16_t raw_value);
 static uint16_t sensor_apply_filter(uint8_t channel, uint16_t raw_value);
-static void sensor_update_statistics(uint8_t channel, float value);
-static bool sensor_check_threshold(uint8_t channel, float value);
+static bool sensor_setup_filter(sensor_channel_t *ch);
+static void sensor_update_statistics(uint8_t channel, q16_t value);
+static bool sensor_check_threshold(uint8_t channel, q16_t value);
+static void sensor_update_fixed_params(sensor_channel_t *ch);
+static void sensor_reset_stats(sensor_channel_t *ch);
+static void sensor_process_sample(uint8_t channel, uint16_t raw_value, uint32_t timestamp);
+static bool sensor_update_scan_group(void);
+static void sensor_scan_frame_handler(const adc_scan_frame_t *frame);
+static void sensor_process_frame(const adc_scan_frame_t *frame);
+static void sensor_update_jitter(sensor_channel_t *ch, uint32_t timestamp_us);
+static uint32_t sensor_gcd(uint32_t a, uint32_t b);
+static void sensor_check_change(uint8_t channel, uint32_t timestamp);
 
 // ============================================================================
 // 公共接口实现
@@ -92,9 +128,13 @@ bool sensor_init(void)
         ch->config.min_value = 0.0f;
         ch->config.max_value = 4095.0f;
         ch->config.filter_size = SENSOR_FILTER_SIZE;
+        ch->config.filter_type = FILTER_TYPE_MOVING_AVERAGE;
+        ch->config.filter_param = 0;
+        ch->config.oversample_bits = 0;
 
         // 初始化数据
         ch->data.raw_value = 0;
+        ch->data.value_q16 = 0;
         ch->data.physical_value = 0.0f;
         ch->data.status = SENSOR_STATUS_OFFLINE;
         ch->data.timestamp = 0;
@@ -102,28 +142,28 @@ bool sensor_init(void)
         ch->data.data_valid = false;
 
         // 初始化统计信息
-        ch->stats.total_samples = 0;
-        ch->stats.valid_samples = 0;
-        ch->stats.error_count = 0;
-        ch->stats.overflow_count = 0;
-        ch->stats.underflow_count = 0;
-        ch->stats.min_value = INFINITY;
-        ch->stats.max_value = -INFINITY;
-        ch->stats.average_value = 0.0f;
+        sensor_reset_stats(ch);
 
         // 初始化滤波器
-        ch->filter_index = 0;
-        ch->filter_count = 0;
-        memset(ch->filter_buffer, 0, sizeof(ch->filter_buffer));
+        sensor_setup_filter(ch);
 
         // 阈值设置
-        ch->min_threshold = -INFINITY;
-        ch->max_threshold = INFINITY;
+        ch->min_threshold = Q16_MIN;
+        ch->max_threshold = Q16_MAX;
         ch->threshold_enabled = false;
 
         ch->last_sample_time = 0;
+
+        // 预换算定点参数
+        sensor_update_fixed_params(ch);
     }
 
+    // 趋势桶随传感器模块一起复位
+    trend_init();
+
+    // sensor_config()要求模块已初始化，需在配置专用通道前置位
+    g_sensor.initialized = true;
+
     // 配置专用传感器通道
     // 温度传感器 (通道0)
     sensor_config_t temp_config = {
@@ -161,10 +201,10 @@ bool sensor_init(void)
         .offset = 0.0f,
         .min_value = 0.0f, // 0V
         .max_value = 5.0f, // 5V
-        .filter_size = 8};
+        .filter_size = 8,
+        .oversample_bits = 2}; // 16次过采样，14位有效分辨率
     sensor_config(SENSOR_VOLTAGE_CHANNEL, &voltage_config);
 
-    g_sensor.initialized = true;
     g_sensor.scan_enabled = false;
     g_sensor.scan_count = 0;
     g_sensor.last_scan_time = system_get_tick();
@@ -202,15 +242,35 @@ bool sensor_config(uint8_t channel, const sensor_config_t *config)
         return false;
     }
 
+    if (config->lut_id != SENSOR_LUT_NONE && sensor_lut_get(config->lut_id) == NULL)
+    {
+        return false;
+    }
+
+    // 比例因子须在Q8.24范围内，超出时拒绝而不是饱和
+    if (config->lut_id == SENSOR_LUT_NONE && !q24_in_range(config->scale_factor))
+    {
+        return false;
+    }
+
     sensor_channel_t *ch = &g_sensor.channels[channel];
 
     // 复制配置
     memcpy(&ch->config, config, sizeof(sensor_config_t));
 
-    // 重置滤波器
-    ch->filter_index = 0;
-    ch->filter_count = 0;
-    memset(ch->filter_buffer, 0, sizeof(ch->filter_buffer));
+    if (ch->config.oversample_bits > ADC_OVERSAMPLE_MAX_BITS)
+    {
+        ch->config.oversample_bits = ADC_OVERSAMPLE_MAX_BITS;
+    }
+
+    // 预换算定点参数，采样路径不再使用浮点
+    sensor_update_fixed_params(ch);
+
+    // 按配置重建滤波器
+    if (!sensor_setup_filter(ch))
+    {
+        return false;
+    }
 
     // 更新状态
     if (config->enabled)
@@ -222,6 +282,12 @@ bool sensor_config(uint8_t channel, const sensor_config_t *config)
         ch->data.status = SENSOR_STATUS_OFFLINE;
     }
 
+    // 扫描中则同步更新扫描组通道
+    if (g_sensor.scan_enabled)
+    {
+        sensor_update_scan_group();
+    }
+
     debug_printf("[SENSOR] Channel %d configured: type=%d, enabled=%d\n",
                  channel, config->type, config->enabled);
 
@@ -246,7 +312,13 @@ bool sensor_enable(uint8_t channel, bool enable)
     if (!enable)
     {
         ch->data.data_valid = false;
-        ch->filter_count = 0;
+        filter_reset(&ch->filter);
+        ch->report_valid = false;
+    }
+
+    if (g_sensor.scan_enabled)
+    {
+        sensor_update_scan_group();
     }
 
     debug_printf("[SENSOR] Channel %d %s\n", channel, enable ? "enabled" : "disabled");
@@ -263,62 +335,11 @@ void sensor_task(void)
         return;
     }
 
-    uint32_t current_time = system_get_tick();
-
-    // 扫描所有使能的通道
-    for (uint8_t i = 0; i < SENSOR_MAX_CHANNELS; i++)
+    // 采样由定时器触发并在中断中入队，这里只做后处理
+    while (g_sensor.frame_tail != g_sensor.frame_head)
     {
-        sensor_channel_t *ch = &g_sensor.channels[i];
-
-        if (!ch->config.enabled)
-        {
-            continue;
-        }
-
-        // 检查采样周期
-        if ((current_time - ch->last_sample_time) >= ch->config.sample_period)
-        {
-            ch->last_sample_time = current_time;
-
-            // 读取原始值
-            uint16_t raw_value = sensor_read_raw(i);
-
-            if (raw_value != SENSOR_INVALID_VALUE)
-            {
-                // 应用滤波
-                uint16_t filtered_value = sensor_apply_filter(i, raw_value);
-
-                // 转换为物理量
-                float physical_value = sensor_convert_to_physical(i, filtered_value);
-
-                // 更新数据
-                ch->data.raw_value = filtered_value;
-                ch->data.physical_value = physical_value;
-                ch->data.timestamp = current_time;
-                ch->data.sample_count++;
-                ch->data.data_valid = true;
-                ch->data.status = SENSOR_STATUS_OK;
-
-                // 更新统计信息
-                sensor_update_statistics(i, physical_value);
-
-                // 检查阈值报警
-                if (ch->threshold_enabled)
-                {
-                    if (!sensor_check_threshold(i, physical_value))
-                    {
-                        ch->data.status = SENSOR_STATUS_OVERRANGE;
-                    }
-                }
-            }
-            else
-            {
-                // 读取失败
-                ch->data.data_valid = false;
-                ch->data.status = SENSOR_STATUS_ERROR;
-                ch->stats.error_count++;
-            }
-        }
+        sensor_process_frame(&g_sensor.frame_queue[g_sensor.frame_tail]);
+        g_sensor.frame_tail = (uint8_t)((g_sensor.frame_tail + 1) & (SENSOR_FRAME_QUEUE_SIZE - 1));
     }
 
     g_sensor.scan_count++;
@@ -334,6 +355,14 @@ bool sensor_start_scan(void)
         return false;
     }
 
+    g_sensor.frame_head = 0;
+    g_sensor.frame_tail = 0;
+
+    if (!sensor_update_scan_group())
+    {
+        return false;
+    }
+
     g_sensor.scan_enabled = true;
     g_sensor.last_scan_time = system_get_tick();
 
@@ -352,6 +381,7 @@ bool sensor_stop_scan(void)
     }
 
     g_sensor.scan_enabled = false;
+    adc_scan_stop();
 
     debug_printf("[SENSOR] Scan stopped\n");
     return true;
@@ -407,23 +437,39 @@ uint16_t sensor_read_raw(uint8_t channel)
 }
 
 /**
- * @brief 读取传感器物理量值
+ * @brief 读取传感器物理量值 (定点数)
  */
-float sensor_read_value(uint8_t channel)
+bool sensor_read_value_q16(uint8_t channel, q16_t *value)
 {
-    if (!g_sensor.initialized || !sensor_is_channel_valid(channel))
+    if (!g_sensor.initialized || !sensor_is_channel_valid(channel) || !value)
     {
-        return NAN;
+        return false;
     }
 
     sensor_channel_t *ch = &g_sensor.channels[channel];
 
     if (!ch->config.enabled || !ch->data.data_valid)
+    {
+        return false;
+    }
+
+    *value = ch->data.value_q16;
+    return true;
+}
+
+/**
+ * @brief 读取传感器物理量值
+ */
+float sensor_read_value(uint8_t channel)
+{
+    q16_t value;
+
+    if (!sensor_read_value_q16(channel, &value))
     {
         return NAN;
     }
 
-    return ch->data.physical_value;
+    return q16_to_float(value);
 }
 
 /**
@@ -431,9 +477,9 @@ float sensor_read_value(uint8_t channel)
  */
 float sensor_read_temperature(uint8_t channel)
 {
-    float value = sensor_read_value(channel);
+    q16_t value;
 
-    if (isnan(value))
+    if (!sensor_read_value_q16(channel, &value))
     {
         return NAN;
     }
@@ -441,13 +487,14 @@ float sensor_read_temperature(uint8_t channel)
     // 如果是温度传感器，直接返回
     if (g_sensor.channels[channel].config.type == SENSOR_TYPE_TEMPERATURE)
     {
-        return value;
+        return q16_to_float(value);
     }
 
     // 如果是通用ADC，按温度传感器公式转换
     // 假设使用NTC热敏电阻或其他温度传感器
-    // 这里使用简化的线性转换
-    return value * 0.1f - 40.0f; // 0.1°C精度，-40°C偏移
+    // 这里使用简化的线性转换 (0.1°C精度，-40°C偏移)
+    value = q16_add(q16_mul_q24(value, Q24_CONST(0.1)), Q16_CONST(-40.0));
+    return q16_to_float(value);
 }
 
 /**
@@ -455,9 +502,9 @@ float sensor_read_temperature(uint8_t channel)
  */
 float sensor_read_humidity(uint8_t channel)
 {
-    float value = sensor_read_value(channel);
+    q16_t value;
 
-    if (isnan(value))
+    if (!sensor_read_value_q16(channel, &value))
     {
         return NAN;
     }
@@ -465,11 +512,11 @@ float sensor_read_humidity(uint8_t channel)
     // 如果是湿度传感器，直接返回
     if (g_sensor.channels[channel].config.type == SENSOR_TYPE_HUMIDITY)
     {
-        return value;
+        return q16_to_float(value);
     }
 
-    // 通用ADC按湿度传感器公式转换
-    return value * 0.1f; // 0.1%RH精度
+    // 通用ADC按湿度传感器公式转换 (0.1%RH精度)
+    return q16_to_float(q16_mul_q24(value, Q24_CONST(0.1)));
 }
 
 /**
@@ -477,9 +524,9 @@ float sensor_read_humidity(uint8_t channel)
  */
 float sensor_read_voltage(uint8_t channel)
 {
-    float value = sensor_read_value(channel);
+    q16_t value;
 
-    if (isnan(value))
+    if (!sensor_read_value_q16(channel, &value))
     {
         return NAN;
     }
@@ -487,11 +534,11 @@ float sensor_read_voltage(uint8_t channel)
     // 如果是电压传感器，直接返回
     if (g_sensor.channels[channel].config.type == SENSOR_TYPE_VOLTAGE)
     {
-        return value;
+        return q16_to_float(value);
     }
 
     // 通用ADC按电压转换 (假设3.3V参考电压，12位ADC)
-    return (value / 4095.0f) * 3.3f;
+    return q16_to_float(q16_mul_q24(value, Q24_CONST(3.3 / 4095.0)));
 }
 
 /**
@@ -499,9 +546,9 @@ float sensor_read_voltage(uint8_t channel)
  */
 float sensor_read_current(uint8_t channel)
 {
-    float value = sensor_read_value(channel);
+    q16_t value;
 
-    if (isnan(value))
+    if (!sensor_read_value_q16(channel, &value))
     {
         return NAN;
     }
@@ -509,11 +556,11 @@ float sensor_read_current(uint8_t channel)
     // 如果是电流传感器，直接返回
     if (g_sensor.channels[channel].config.type == SENSOR_TYPE_CURRENT)
     {
-        return value;
+        return q16_to_float(value);
     }
 
-    // 通用ADC按电流转换 (假设使用分流电阻采样)
-    return value * 0.001f; // 1mA精度
+    // 通用ADC按电流转换 (假设使用分流电阻采样，1mA精度)
+    return q16_to_float(q16_mul_q24(value, Q24_CONST(0.001)));
 }
 
 /**
@@ -528,8 +575,9 @@ bool sensor_get_data(uint8_t channel, sensor_data_t *data)
 
     sensor_channel_t *ch = &g_sensor.channels[channel];
 
-    // 复制数据
+    // 复制数据，浮点物理量仅在此显示边界换算
     memcpy(data, &ch->data, sizeof(sensor_data_t));
+    data->physical_value = q16_to_float(ch->data.value_q16);
 
     return true;
 }
@@ -568,9 +616,16 @@ bool sensor_get_stats(uint8_t channel, sensor_stats_t *stats)
 
     sensor_channel_t *ch = &g_sensor.channels[channel];
 
-    // 复制统计信息
+    // 复制统计信息，最值和平均值由定点数换算
     memcpy(stats, &ch->stats, sizeof(sensor_stats_t));
 
+    if (ch->stats.valid_samples > 0)
+    {
+        stats->min_value = q16_to_float(ch->stat_min_q16);
+        stats->max_value = q16_to_float(ch->stat_max_q16);
+        stats->average_value = q16_to_float(ch->stat_avg_q16);
+    }
+
     return true;
 }
 
@@ -589,18 +644,14 @@ bool sensor_clear_stats(uint8_t channel)
         // 清除所有通道
         for (uint8_t i = 0; i < SENSOR_MAX_CHANNELS; i++)
         {
-            memset(&g_sensor.channels[i].stats, 0, sizeof(sensor_stats_t));
-            g_sensor.channels[i].stats.min_value = INFINITY;
-            g_sensor.channels[i].stats.max_value = -INFINITY;
+            sensor_reset_stats(&g_sensor.channels[i]);
         }
         debug_printf("[SENSOR] All statistics cleared\n");
     }
     else if (sensor_is_channel_valid(channel))
     {
         // 清除指定通道
-        memset(&g_sensor.channels[channel].stats, 0, sizeof(sensor_stats_t));
-        g_sensor.channels[channel].stats.min_value = INFINITY;
-        g_sensor.channels[channel].stats.max_value = -INFINITY;
+        sensor_reset_stats(&g_sensor.channels[channel]);
         debug_printf("[SENSOR] Channel %d statistics cleared\n", channel);
     }
     else
@@ -611,6 +662,55 @@ bool sensor_clear_stats(uint8_t channel)
     return true;
 }
 
+/**
+ * @brief 获取采样抖动统计
+ */
+bool sensor_get_jitter(uint8_t channel, sensor_jitter_t *jitter)
+{
+    if (!g_sensor.initialized || !sensor_is_channel_valid(channel) || !jitter)
+    {
+        return false;
+    }
+
+    memcpy(jitter, &g_sensor.channels[channel].jitter, sizeof(sensor_jitter_t));
+    return true;
+}
+
+/**
+ * @brief 获取上报窗口统计摘要
+ */
+bool sensor_get_window_stats(uint8_t channel, stream_stats_summary_t *summary, bool reset_window)
+{
+    if (!g_sensor.initialized || !sensor_is_channel_valid(channel) || !summary)
+    {
+        return false;
+    }
+
+    sensor_channel_t *ch = &g_sensor.channels[channel];
+
+    stream_stats_get_summary(&ch->window_stats, summary);
+    if (reset_window)
+    {
+        stream_stats_reset(&ch->window_stats);
+    }
+
+    return true;
+}
+
+/**
+ * @brief 设置显著变化回调
+ */
+bool sensor_set_change_callback(sensor_change_callback_t callback)
+{
+    if (!g_sensor.initialized)
+    {
+        return false;
+    }
+
+    g_sensor.change_callback = callback;
+    return true;
+}
+
 /**
  * @brief 设置传感器报警阈值
  */
@@ -623,8 +723,9 @@ bool sensor_set_threshold(uint8_t channel, float min_threshold, float max_thresh
 
     sensor_channel_t *ch = &g_sensor.channels[channel];
 
-    ch->min_threshold = min_threshold;
-    ch->max_threshold = max_threshold;
+    // 阈值预换算为定点数
+    ch->min_threshold = q16_from_float(min_threshold);
+    ch->max_threshold = q16_from_float(max_threshold);
     ch->threshold_enabled = true;
 
     debug_printf("[SENSOR] Channel %d threshold set: %.2f to %.2f\n",
@@ -652,9 +753,10 @@ bool sensor_calibrate(uint8_t channel, float reference_value)
         return false;
     }
 
-    // 计算新的偏移量 (简化的一点校准)
-    float current_physical = sensor_convert_to_physical(channel, raw_value);
-    ch->config.offset += (reference_value - current_physical);
+    // 计算新的偏移量 (简化的一点校准)，单次读取按过采样位数对齐
+    q16_t current_physical = sensor_convert_to_physical(channel, (uint16_t)(raw_value << ch->config.oversample_bits));
+    ch->config.offset += (reference_value - q16_to_float(current_physical));
+    sensor_update_fixed_params(ch);
 
     debug_printf("[SENSOR] Channel %d calibrated: offset=%.3f\n",
                  channel, ch->config.offset);
@@ -695,7 +797,7 @@ void sensor_print_status(void)
                      i,
                      (ch->config.type < SENSOR_TYPE_COUNT) ? type_names[ch->config.type] : "UNKNOWN",
                      (ch->data.status < SENSOR_STATUS_COUNT) ? status_names[ch->data.status] : "UNKNOWN",
-                     ch->data.physical_value,
+                     q16_to_float(ch->data.value_q16),
                      ch->data.sample_count);
     }
     debug_printf("\n");
@@ -725,7 +827,8 @@ void sensor_print_stats(void)
         debug_printf("  Ch%d: Total=%lu, Valid=%lu, Errors=%lu\n",
                      i, ch->stats.total_samples, ch->stats.valid_samples, ch->stats.error_count);
         debug_printf("        Min=%.2f, Max=%.2f, Avg=%.2f\n",
-                     ch->stats.min_value, ch->stats.max_value, ch->stats.average_value);
+                     q16_to_float(ch->stat_min_q16), q16_to_float(ch->stat_max_q16),
+                     q16_to_float(ch->stat_avg_q16));
     }
     debug_printf("\n");
 }
@@ -744,24 +847,68 @@ void sensor_process(void)
 // ============================================================================
 
 /**
- * @brief 转换原始值为物理量
+ * @brief 由浮点配置预换算定点参数 (仅在配置变更时调用)
  */
-static float sensor_convert_to_physical(uint8_t channel, uint16_t raw_value)
+static void sensor_update_fixed_params(sensor_channel_t *ch)
+{
+    ch->scale_q24 = q24_from_float(ch->config.scale_factor);
+    ch->offset_q16 = q16_from_float(ch->config.offset);
+    ch->min_value_q16 = q16_from_float(ch->config.min_value);
+    ch->max_value_q16 = q16_from_float(ch->config.max_value);
+    ch->deadband_abs_q16 = q16_from_float(ch->config.deadband_abs);
+    ch->deadband_rel_q16 = q16_from_float(ch->config.deadband_rel);
+    ch->lut = sensor_lut_get(ch->config.lut_id);
+    ch->report_valid = false;
+}
+
+/**
+ * @brief 重置通道统计信息
+ */
+static void sensor_reset_stats(sensor_channel_t *ch)
+{
+    memset(&ch->stats, 0, sizeof(sensor_stats_t));
+    ch->stats.min_value = INFINITY;
+    ch->stats.max_value = -INFINITY;
+    ch->stat_min_q16 = Q16_MAX;
+    ch->stat_max_q16 = Q16_MIN;
+    ch->stat_avg_q16 = 0;
+
+    memset(&ch->jitter, 0, sizeof(sensor_jitter_t));
+    ch->jitter_abs_sum_us = 0;
+    ch->jitter_valid = false;
+
+    stream_stats_reset(&ch->window_stats);
+}
+
+/**
+ * @brief 转换原始值为物理量 (Q16.16)
+ */
+static q16_t sensor_convert_to_physical(uint8_t channel, uint16_t raw_value)
 {
     sensor_channel_t *ch = &g_sensor.channels[channel];
 
-    // 基本线性转换: physical = (raw * scale) + offset
-    float physical = (float)raw_value * ch->config.scale_factor + ch->config.offset;
+    q16_t physical;
+
+    if (ch->lut != NULL)
+    {
+        // 非线性传感器: 查表插值，offset作为零点修正
+        physical = q16_add(sensor_lut_lookup(ch->lut, raw_value, ch->config.oversample_bits), ch->offset_q16);
+    }
+    else
+    {
+        // 基本线性转换: physical = (raw / 2^n * scale) + offset，比例因子按12位码值定义
+        physical = q16_linear_ext(raw_value, ch->config.oversample_bits, ch->scale_q24, ch->offset_q16);
+    }
 
     // 限制在有效范围内
-    if (physical < ch->config.min_value)
+    if (physical < ch->min_value_q16)
     {
-        physical = ch->config.min_value;
+        physical = ch->min_value_q16;
         ch->stats.underflow_count++;
     }
-    else if (physical > ch->config.max_value)
+    else if (physical > ch->max_value_q16)
     {
-        physical = ch->config.max_value;
+        physical = ch->max_value_q16;
         ch->stats.overflow_count++;
     }
 
@@ -772,64 +919,307 @@ static float sensor_convert_to_physical(uint8_t channel, uint16_t raw_value)
  * @brief 应用滤波器
  */
 static uint16_t sensor_apply_filter(uint8_t channel, uint16_t raw_value)
+{
+    return filter_update(&g_sensor.channels[channel].filter, raw_value);
+}
+
+/**
+ * @brief 按通道配置初始化滤波器
+ */
+static bool sensor_setup_filter(sensor_channel_t *ch)
+{
+    filter_config_t filter_config = {
+        .type = ch->config.filter_type,
+        .window = ch->config.filter_size,
+        .param = ch->config.filter_param};
+
+    return filter_init(&ch->filter, &filter_config);
+}
+
+/**
+ * @brief 处理单个通道的一次采样 (滤波、换算、统计、阈值)
+ */
+static void sensor_process_sample(uint8_t channel, uint16_t raw_value, uint32_t timestamp)
 {
     sensor_channel_t *ch = &g_sensor.channels[channel];
 
-    // 添加新数据到滤波缓冲区
-    ch->filter_buffer[ch->filter_index] = raw_value;
-    ch->filter_index = (ch->filter_index + 1) % ch->config.filter_size;
+    // 应用滤波
+    uint16_t filtered_value = sensor_apply_filter(channel, raw_value);
+
+    // 转换为物理量 (Q16.16)
+    q16_t value = sensor_convert_to_physical(channel, filtered_value);
+
+    // 更新数据
+    ch->data.raw_value = filtered_value;
+    ch->data.value_q16 = value;
+    ch->data.timestamp = timestamp;
+    ch->data.sample_count++;
+    ch->data.data_valid = true;
+    ch->data.status = SENSOR_STATUS_OK;
+
+    // 更新统计信息和趋势桶
+    sensor_update_statistics(channel, value);
+    trend_add_sample(channel, value, timestamp / 1000);
 
-    if (ch->filter_count < ch->config.filter_size)
+    // 检查阈值报警
+    if (ch->threshold_enabled)
     {
-        ch->filter_count++;
+        if (!sensor_check_threshold(channel, value))
+        {
+            ch->data.status = SENSOR_STATUS_OVERRANGE;
+        }
     }
 
-    // 计算移动平均值
-    uint32_t sum = 0;
-    for (uint8_t i = 0; i < ch->filter_count; i++)
+    // 仅显著变化才通知下游
+    sensor_check_change(channel, timestamp);
+}
+
+/**
+ * @brief 显著变化检测 (死区 + 状态变化 + 最长静默)
+ * @note 有效死区取绝对死区与相对死区中的较大者；均为0时每个样本都上报
+ */
+static void sensor_check_change(uint8_t channel, uint32_t timestamp)
+{
+    sensor_channel_t *ch = &g_sensor.channels[channel];
+    q16_t value = ch->data.value_q16;
+    sensor_change_reason_t reason;
+
+    if (!ch->report_valid)
+    {
+        reason = SENSOR_CHANGE_FIRST;
+    }
+    else if (ch->data.status != ch->report_status)
     {
-        sum += ch->filter_buffer[i];
+        reason = SENSOR_CHANGE_STATUS;
     }
+    else
+    {
+        int64_t delta = (int64_t)value - ch->report_value_q16;
+        int64_t reference = ch->report_value_q16;
+        int64_t threshold = ch->deadband_abs_q16;
+        int64_t relative = ((reference < 0 ? -reference : reference) * ch->deadband_rel_q16) >> Q16_SHIFT;
 
-    return (uint16_t)(sum / ch->filter_count);
+        if (relative > threshold)
+        {
+            threshold = relative;
+        }
+
+        if ((delta < 0 ? -delta : delta) >= threshold)
+        {
+            reason = SENSOR_CHANGE_DEADBAND;
+        }
+        else if (ch->config.max_silence_ms != 0 && (timestamp - ch->report_time) >= ch->config.max_silence_ms)
+        {
+            reason = SENSOR_CHANGE_SILENCE;
+        }
+        else
+        {
+            return;
+        }
+    }
+
+    sensor_change_event_t event = {
+        .channel = channel,
+        .reason = reason,
+        .value_q16 = value,
+        .previous_q16 = ch->report_value_q16,
+        .status = ch->data.status,
+        .timestamp = timestamp};
+
+    ch->report_value_q16 = value;
+    ch->report_status = ch->data.status;
+    ch->report_time = timestamp;
+    ch->report_valid = true;
+    ch->stats.change_count++;
+
+    if (g_sensor.change_callback)
+    {
+        g_sensor.change_callback(&event);
+    }
+}
+
+/**
+ * @brief 按使能通道重建ADC扫描组并启动定时器触发
+ */
+static bool sensor_update_scan_group(void)
+{
+    adc_scan_config_t scan_config = {
+        .channel_mask = 0,
+        .sample_time = ADC_SAMPLE_TIME_4,
+        .use_pdma = SENSOR_SCAN_USE_PDMA,
+        .callback = sensor_scan_frame_handler};
+    uint32_t period_ms = 0;
+
+    // 传感器通道与ADC通道一一对应；扫描周期取各通道采样周期的最大公约数
+    for (uint8_t i = 0; i < SENSOR_MAX_CHANNELS && i < ADC_CHANNEL_COUNT; i++)
+    {
+        sensor_channel_t *ch = &g_sensor.channels[i];
+
+        if (ch->config.enabled && ch->config.sample_period > 0)
+        {
+            scan_config.channel_mask |= (uint8_t)(1U << i);
+            scan_config.oversample_bits[i] = ch->config.oversample_bits;
+            period_ms = sensor_gcd(period_ms, ch->config.sample_period);
+        }
+    }
+
+    adc_scan_stop();
+
+    if (scan_config.channel_mask == 0)
+    {
+        g_sensor.scan_period_ms = 0;
+        return true;
+    }
+
+    for (uint8_t i = 0; i < SENSOR_MAX_CHANNELS && i < ADC_CHANNEL_COUNT; i++)
+    {
+        sensor_channel_t *ch = &g_sensor.channels[i];
+
+        if (scan_config.channel_mask & (1U << i))
+        {
+            ch->frame_divider = (uint16_t)(ch->config.sample_period / period_ms);
+            ch->frame_countdown = ch->frame_divider - 1;
+            ch->jitter_valid = false;
+        }
+    }
+
+    g_sensor.scan_period_ms = period_ms;
+
+    if (!adc_scan_config(&scan_config))
+    {
+        return false;
+    }
+
+    return adc_scan_start_timer(period_ms * 1000U);
+}
+
+/**
+ * @brief 扫描帧完成回调 (中断上下文，仅入队)
+ */
+static void sensor_scan_frame_handler(const adc_scan_frame_t *frame)
+{
+    uint8_t next = (uint8_t)((g_sensor.frame_head + 1) & (SENSOR_FRAME_QUEUE_SIZE - 1));
+
+    if (next == g_sensor.frame_tail)
+    {
+        // 任务处理不及时，丢弃最新帧
+        g_sensor.frame_overflow++;
+        return;
+    }
+
+    memcpy(&g_sensor.frame_queue[g_sensor.frame_head], frame, sizeof(adc_scan_frame_t));
+    g_sensor.frame_head = next;
+}
+
+/**
+ * @brief 处理一帧采样 (任务上下文，按通道分频)
+ */
+static void sensor_process_frame(const adc_scan_frame_t *frame)
+{
+    for (uint8_t i = 0; i < SENSOR_MAX_CHANNELS && i < ADC_CHANNEL_COUNT; i++)
+    {
+        sensor_channel_t *ch = &g_sensor.channels[i];
+
+        if (!ch->config.enabled || !(frame->channel_mask & (1U << i)))
+        {
+            continue;
+        }
+
+        if (ch->frame_countdown > 0)
+        {
+            ch->frame_countdown--;
+            continue;
+        }
+        ch->frame_countdown = ch->frame_divider - 1;
+
+        ch->last_sample_time = frame->timestamp;
+        ch->stats.total_samples++;
+        sensor_update_jitter(ch, frame->timestamp_us);
+        sensor_process_sample(i, frame->values[i], frame->timestamp);
+    }
+}
+
+/**
+ * @brief 更新采样抖动统计 (以触发时刻计算实际采样间隔)
+ */
+static void sensor_update_jitter(sensor_channel_t *ch, uint32_t timestamp_us)
+{
+    if (ch->jitter_valid)
+    {
+        uint32_t interval_us = timestamp_us - ch->last_sample_us;
+        int32_t deviation = (int32_t)(interval_us - (uint32_t)ch->config.sample_period * 1000U);
+        sensor_jitter_t *jitter = &ch->jitter;
+
+        if (jitter->intervals == 0 || deviation < jitter->min_deviation_us)
+        {
+            jitter->min_deviation_us = deviation;
+        }
+        if (jitter->intervals == 0 || deviation > jitter->max_deviation_us)
+        {
+            jitter->max_deviation_us = deviation;
+        }
+
+        ch->jitter_abs_sum_us += (uint32_t)(deviation >= 0 ? deviation : -deviation);
+        jitter->intervals++;
+        jitter->mean_abs_deviation_us = ch->jitter_abs_sum_us / jitter->intervals;
+    }
+
+    ch->last_sample_us = timestamp_us;
+    ch->jitter_valid = true;
+}
+
+/**
+ * @brief 最大公约数 (a为0时返回b)
+ */
+static uint32_t sensor_gcd(uint32_t a, uint32_t b)
+{
+    while (b != 0)
+    {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
 }
 
 /**
  * @brief 更新统计信息
  */
-static void sensor_update_statistics(uint8_t channel, float value)
+static void sensor_update_statistics(uint8_t channel, q16_t value)
 {
     sensor_channel_t *ch = &g_sensor.channels[channel];
 
     ch->stats.valid_samples++;
 
     // 更新最值
-    if (value < ch->stats.min_value)
+    if (value < ch->stat_min_q16)
     {
-        ch->stats.min_value = value;
+        ch->stat_min_q16 = value;
     }
-    if (value > ch->stats.max_value)
+    if (value > ch->stat_max_q16)
     {
-        ch->stats.max_value = value;
+        ch->stat_max_q16 = value;
     }
 
     // 更新平均值 (滑动平均)
     if (ch->stats.valid_samples == 1)
     {
-        ch->stats.average_value = value;
+        ch->stat_avg_q16 = value;
     }
     else
     {
-        // 简单的指数移动平均
-        float alpha = 0.1f; // 平滑因子
-        ch->stats.average_value = alpha * value + (1.0f - alpha) * ch->stats.average_value;
+        // 简单的指数移动平均 (alpha = 0.1)
+        ch->stat_avg_q16 = q16_ema_tenth(ch->stat_avg_q16, value);
     }
+
+    // 上报窗口统计
+    stream_stats_update(&ch->window_stats, value);
 }
 
 /**
  * @brief 检查阈值报警
  */
-static bool sensor_check_threshold(uint8_t channel, float value)
+static bool sensor_check_threshold(uint8_t channel, q16_t value)
 {
     sensor_channel_t *ch = &g_sensor.channels[channel];
 
@@ -840,8 +1230,10 @@ static bool sensor_check_threshold(uint8_t channel, float value)
 
     if (value < ch->min_threshold || value > ch->max_threshold)
     {
-        debug_printf("[SENSOR] Ch%d threshold alarm: %.2f (%.2f~%.2f)\n",
-                     channel, value, ch->min_threshold, ch->max_threshold);
+        // 以千分单位整数打印，避免在采样路径格式化浮点
+        debug_printf("[SENSOR] Ch%d threshold alarm: %ld (%ld~%ld) x0.001\n",
+                     channel, (long)q16_to_milli(value),
+                     (long)q16_to_milli(ch->min_threshold), (long)q16_to_milli(ch->max_threshold));
         return false;
     }
 
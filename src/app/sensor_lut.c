@@ -0,0 +1,82 @@
+/**
+ * @file sensor_lut.c
+ * @brief 憨云DTU传感器非线性线性化查找表实现
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 插值乘积的32位范围由生成脚本检查 (相邻表项差值 << (shift + 4) 不溢出)，
+ * 查找路径不使用64位乘法和除法 (Cortex-M0无硬件除法器)
+ */
+
+#include "sensor_lut.h"
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+/**
+ * @brief 按编号获取查找表
+ */
+const sensor_lut_t *sensor_lut_get(uint8_t id)
+{
+    if (id == SENSOR_LUT_NONE || id >= SENSOR_LUT_COUNT)
+    {
+        return NULL;
+    }
+    return &g_sensor_lut_tables[id - 1];
+}
+
+/**
+ * @brief 查表并线性插值
+ */
+q16_t sensor_lut_lookup(const sensor_lut_t *lut, uint32_t raw, uint8_t extra_bits)
+{
+    const q16_t *values = lut->values;
+
+    if (lut->kind == SENSOR_LUT_KIND_DIRECT)
+    {
+        // 直接索引: 高位定位表项，低位为段内插值系数
+        uint8_t shift = (uint8_t)(lut->shift + extra_bits);
+        uint32_t index = raw >> shift;
+
+        if (index >= (uint32_t)(lut->count - 1))
+        {
+            return values[lut->count - 1];
+        }
+
+        int32_t fraction = (int32_t)(raw & ((1UL << shift) - 1));
+        int32_t delta = values[index + 1] - values[index];
+        return values[index] + ((delta * fraction) >> shift);
+    }
+
+    // 断点表: 端点外取端点值
+    const uint16_t *codes = lut->codes;
+    uint16_t low = 0;
+    uint16_t high = (uint16_t)(lut->count - 1);
+
+    if (raw <= ((uint32_t)codes[low] << extra_bits))
+    {
+        return values[low];
+    }
+    if (raw >= ((uint32_t)codes[high] << extra_bits))
+    {
+        return values[high];
+    }
+
+    // 二分查找 codes[low] <= raw < codes[high]
+    while (high - low > 1)
+    {
+        uint16_t mid = (uint16_t)((low + high) >> 1);
+        if (((uint32_t)codes[mid] << extra_bits) <= raw)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    int32_t offset = (int32_t)(raw - ((uint32_t)codes[low] << extra_bits));
+    return values[low] + ((lut->slopes[low] * offset) >> extra_bits);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file sensor_lut_table.c
+ * @brief 憨云DTU传感器线性化查找表数据 (自动生成)
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+// 由 scripts/gen_sensor_lut.py 根据 scripts/sensor_lut.json 生成，请勿手工修改
+
+#include "sensor_lut.h"
+
+// NTC 10K B3950, 10K上拉至VREF, Steinhart-Hart, 直接索引
+static const q16_t lut_ntc_10k_3950_values[129] = {
+    8192000, 8192000, 8192000, 8192000, 8192000, 7869408, 7389687, 6994629,
+    6659534, 6368976, 6112705, 5883582, 5676447, 5487453, 5313659, 5152772,
+    5002967, 4862770, 4730978, 4606590, 4488772, 4376815, 4270118, 4168162,
+    4070500, 3976741, 3886542, 3799602, 3715655, 3634463, 3555814, 3479516,
+    3405399, 3333307, 3263100, 3194648, 3127836, 3062556, 2998710, 2936206,
+    2874962, 2814899, 2755945, 2698035, 2641104, 2585096, 2529954, 2475629,
+    2422071, 2369235, 2317078, 2265559, 2214639, 2164283, 2114454, 2065118,
+    2016245, 1967803, 1919761, 1872093, 1824770, 1777764, 1731051, 1684605,
+    1638400, 1592413, 1546620, 1500997, 1455521, 1410169, 1364919, 1319747,
+    1274632, 1229549, 1184477, 1139393, 1094273, 1049093, 1003829, 958458,
+    912953, 867290, 821441, 775379, 729076, 682502, 635625, 588415,
+    540836, 492854, 444429, 395523, 346093, 296093, 245474, 194185,
+    142170, 89366, 35710, -18873, -74459, -131135, -188996, -248148,
+    -308708, -370806, -434591, -500227, -567906, -637842, -710287, -785531,
+    -863915, -945841, -1031795, -1122360, -1218258, -1320389, -1429900, -1548286,
+    -1677546, -1820450, -1980998, -2165290, -2383354, -2621440, -2621440, -2621440,
+    -2621440
+};
+
+// NTC 10K B3950, 10K上拉至VREF, Steinhart-Hart按5°C取断点, 二分查找
+static const q16_t lut_ntc_10k_3950_pwl_values[34] = {
+    8191359, 7869408, 7543386, 7208173, 6884330, 6555232, 6229073, 5897212,
+    5568111, 5241800, 4914300, 4587767, 4260366, 3931216, 3604682, 3276126,
+    2949768, 2621750, 2294462, 1966295, 1638400, 1311285, 982576, 654707,
+    327412, -1, -327942, -655708, -982919, -1310521, -1639950, -1965054,
+    -2296722, -2621440
+};
+static const uint16_t lut_ntc_10k_3950_pwl_codes[34] = {
+    142, 160, 181, 206, 234, 267, 305, 350, 402, 462, 532, 613,
+    707, 816, 940, 1082, 1241, 1419, 1614, 1825, 2048, 2278, 2511, 2739,
+    2956, 3157, 3338, 3496, 3630, 3741, 3831, 3901, 3956, 3997
+};
+static const int32_t lut_ntc_10k_3950_pwl_slopes[34] = {
+    -17886, -15525, -13409, -11566, -9973, -8583, -7375, -6329,
+    -5439, -4679, -4031, -3483, -3020, -2633, -2314, -2053,
+    -1843, -1678, -1555, -1470, -1422, -1411, -1438, -1508,
+    -1629, -1812, -2074, -2442, -2951, -3660, -4644, -6030,
+    -7920, 0
+};
+
+// 电压输出湿度探头数据手册曲线 (mV -> %RH), 二分查找
+static const q16_t lut_humidity_probe_values[11] = {
+    0, 655360, 1310720, 1966080, 2621440, 3276800, 3932160, 4587520,
+    5242880, 5898240, 6553600
+};
+static const uint16_t lut_humidity_probe_codes[11] = {
+    1025, 1390, 1725, 2036, 2321, 2582, 2818, 3029, 3215, 3376, 3513
+};
+static const int32_t lut_humidity_probe_slopes[11] = {
+    1796, 1956, 2107, 2300, 2511, 2777, 3106, 3523,
+    4071, 4784, 0
+};
+
+// 表项按 sensor_lut_id_t 顺序排列 (SENSOR_LUT_NONE 不占表项)，共 966 字节
+const sensor_lut_t g_sensor_lut_tables[SENSOR_LUT_COUNT - 1] = {
+    {SENSOR_LUT_KIND_DIRECT, 5, 129, NULL, lut_ntc_10k_3950_values, NULL}, // SENSOR_LUT_NTC_10K_3950
+    {SENSOR_LUT_KIND_BINARY, 0, 34, lut_ntc_10k_3950_pwl_codes, lut_ntc_10k_3950_pwl_values, lut_ntc_10k_3950_pwl_slopes}, // SENSOR_LUT_NTC_10K_3950_PWL
+    {SENSOR_LUT_KIND_BINARY, 0, 11, lut_humidity_probe_codes, lut_humidity_probe_values, lut_humidity_probe_slopes}, // SENSOR_LUT_HUMIDITY_PROBE
+};
@@ -9,6 +9,10 @@
  */
 
 #include "storage.h"
+#include "config_journal.h"
+#include "flash.h"
+#include "flash_log.h"
+#include "history_codec.h"
 #include "system.h"
 #include "gpio.h"
 #include <string.h>
@@ -17,6 +21,22 @@
 // 内部数据结构
 // ============================================================================
 
+/**
+ * @brief 存储作业 (由storage_task()在后台写入Flash)
+ */
+typedef struct
+{
+    uint8_t type;                    // 作业类型 (STORAGE_TYPE_CONFIG/ALARM/STATUS/SENSOR_BLOCK)
+    storage_job_callback_t callback; // 完成回调 (可为NULL)
+    void *context;                   // 回调上下文
+    union
+    {
+        storage_header_t header;        // 记录头
+        storage_alarm_record_t alarm;   // 报警记录
+        storage_status_record_t status; // 状态记录
+    } record;                        // 报警/状态记录 (配置与数据块在控制块中)
+} storage_job_t;
+
 /**
  * @brief 存储模块控制块
  */
@@ -26,14 +46,64 @@ typedef struct
     storage_status_t status;      // 当前状态
     storage_stats_t stats;        // 统计信息
     uint16_t config_write_count;  // 配置写入计数
-    uint16_t history_write_index; // 历史数据写入索引
+    config_journal_t config_journal; // A/B双bank配置日志 (配置区)
+    storage_config_t config;      // 当前配置 (已提交内容的RAM镜像)
     uint32_t last_write_time;     // 上次写入时间
+    flash_log_t history_log;      // 传感器记录日志 (历史区)
+    flash_log_t event_log;        // 报警/状态记录日志 (日志区)
+    uint32_t time_offset;         // 记录时间偏移 (保证重启后时间戳不回退)
+    history_encoder_t history_encoder;        // 传感器数据块编码器
+    uint8_t history_blocks[2][STORAGE_BLOCK_SIZE]; // 数据块双缓冲: 正在编码的块 / 已封闭待写入的块
+    uint8_t history_active;       // 正在编码的缓冲序号
+    uint16_t sealed_length;       // 已封闭待写入的块长度 (0: 无)
+    uint32_t sealed_time;         // 已封闭块末个采样时间戳
+    uint32_t history_block_time;  // 当前块首个采样的写入时刻
+    storage_job_t jobs[STORAGE_JOB_QUEUE_SIZE]; // 作业队列 (环形，从旧到新)
+    uint8_t job_head;             // 最早作业位置
+    uint8_t job_count;            // 排队作业数
+    storage_config_t pending_config; // 排队中最新的配置
+    bool config_pending;          // pending_config尚未写入
+    storage_job_callback_t block_callback; // 数据块写入完成回调
+    void *block_context;          // 数据块回调上下文
 } storage_control_t;
 
+/**
+ * @brief 区间查询回调适配
+ */
+typedef struct
+{
+    storage_history_visitor_t visitor; // 调用者回调
+    void *context;                     // 调用者上下文
+    uint32_t start_time;               // 起始时间戳 (传感器数据块内过滤)
+    uint32_t end_time;                 // 结束时间戳
+    uint32_t count;                    // 已回调记录数
+    bool stopped;                      // 回调要求停止或已超出区间
+} storage_query_context_t;
+
+/**
+ * @brief 传感器采样遍历回调
+ */
+typedef bool (*storage_sample_visitor_t)(const history_sample_t *sample, void *context);
+
+/**
+ * @brief 最新采样读取上下文
+ */
+typedef struct
+{
+    storage_sensor_record_t *records; // 输出数组 (从新到旧)
+    uint32_t total;                   // 采样总数
+    uint32_t skip;                    // 跳过的最旧采样数
+    uint32_t index;                   // 当前采样序号
+} storage_latest_context_t;
+
 // 全局控制块
 static storage_control_t g_storage = {0};
 bool g_storage_initialized = false;
 
+// 总线空闲检查 (由通信模块设置，不随storage_init()清除)
+static storage_idle_check_t g_storage_idle_check = NULL;
+static void *g_storage_idle_context = NULL;
+
 // CRC16表 (使用多项式0x8005)
 static const uint16_t crc16_table[256] = {
     0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
@@ -74,10 +144,34 @@ static const uint16_t crc16_table[256] = {
 // ============================================================================
 
 static bool storage_init_flash(void);
+static bool storage_erase_backup(void);
 static storage_config_t storage_get_default_config(void);
+static bool storage_load_config(void);
 static void storage_fill_header(storage_header_t *header, uint8_t type, uint8_t length);
-static bool storage_write_record(uint32_t base_addr, const void *data, uint16_t length);
-static bool storage_read_record(uint32_t base_addr, void *data, uint16_t length);
+static bool storage_mount_logs(void);
+static flash_log_t *storage_get_log(uint8_t type);
+static bool storage_append_record(uint8_t type, void *record, uint8_t length);
+static bool storage_query_visit(const flash_log_entry_t *entry, const void *data, void *context);
+static void storage_prepare_config(storage_config_t *write_config, const storage_config_t *config);
+static bool storage_commit_config(const storage_config_t *write_config);
+static bool storage_enqueue_job(uint8_t type, const void *record, storage_job_callback_t callback, void *context);
+static bool storage_run_job(void);
+static void storage_maintain(void);
+static bool storage_bus_idle(uint32_t duration_ms);
+static uint16_t storage_read_queued(uint8_t type, void *records, uint16_t record_size, uint16_t count);
+static uint16_t storage_count_queued(uint8_t type);
+static void storage_query_queued(uint8_t type, storage_query_context_t *query);
+static uint8_t *storage_active_block(void);
+static void storage_reset_block(void);
+static bool storage_seal_block(void);
+static bool storage_write_sealed_block(void);
+static void storage_fill_sensor_record(storage_sensor_record_t *record, const history_sample_t *sample);
+static bool storage_visit_block(const uint8_t *block, uint16_t length, storage_sample_visitor_t visitor,
+                                void *context);
+static uint32_t storage_count_samples(void);
+static bool storage_latest_visit(const history_sample_t *sample, void *context);
+static bool storage_query_sample(const history_sample_t *sample, void *context);
+static bool storage_query_block(const flash_log_entry_t *entry, const void *data, void *context);
 
 // ============================================================================
 // 存储管理接口实现
@@ -104,23 +198,34 @@ bool storage_init(void)
         return false;
     }
 
-    // 验证配置区域
-    storage_config_t config;
-    if (!storage_read_config(&config))
+    // 配置读写接口要求已初始化，先置位，失败时清除
+    g_storage.initialized = true;
+
+    // 挂载配置日志，无有效配置时创建默认配置
+    if (!storage_load_config())
     {
         debug_printf("[STORAGE] Config invalid, creating default\n");
 
         // 创建默认配置
-        config = storage_get_default_config();
+        storage_config_t config = storage_get_default_config();
         if (!storage_write_config(&config))
         {
             debug_printf("[STORAGE] Failed to write default config\n");
+            g_storage.initialized = false;
             g_storage.status = STORAGE_STATUS_INIT_FAILED;
             return false;
         }
     }
 
-    g_storage.initialized = true;
+    // 挂载记录日志 (掉电后恢复写入头)
+    if (!storage_mount_logs())
+    {
+        debug_printf("[STORAGE] Record log mount failed\n");
+        g_storage.initialized = false;
+        g_storage.status = STORAGE_STATUS_INIT_FAILED;
+        return false;
+    }
+
     g_storage_initialized = true;
     g_storage.status = STORAGE_STATUS_OK;
     g_storage.last_write_time = system_get_tick();
@@ -139,6 +244,8 @@ void storage_deinit(void)
         return;
     }
 
+    storage_flush();
+
     // 清空控制块
     memset(&g_storage, 0, sizeof(storage_control_t));
     g_storage_initialized = false;
@@ -146,6 +253,60 @@ void storage_deinit(void)
     debug_printf("[STORAGE] Module deinitialized\n");
 }
 
+/**
+ * @brief 写回缓存中的历史记录
+ */
+bool storage_flush(void)
+{
+    if (!g_storage.initialized)
+    {
+        return false;
+    }
+
+    bool sealed = storage_seal_block();
+    return storage_process_jobs() && sealed;
+}
+
+/**
+ * @brief 同步执行全部排队作业
+ */
+bool storage_process_jobs(void)
+{
+    bool success = true;
+
+    while (g_storage.job_count)
+    {
+        success = storage_run_job() && success;
+    }
+    return success;
+}
+
+/**
+ * @brief 获取排队中的作业数
+ */
+uint8_t storage_get_pending_jobs(void)
+{
+    return g_storage.job_count;
+}
+
+/**
+ * @brief 设置传感器数据块写入完成回调
+ */
+void storage_set_block_callback(storage_job_callback_t callback, void *context)
+{
+    g_storage.block_callback = callback;
+    g_storage.block_context = context;
+}
+
+/**
+ * @brief 设置总线空闲检查
+ */
+void storage_set_idle_check(storage_idle_check_t check, void *context)
+{
+    g_storage_idle_check = check;
+    g_storage_idle_context = context;
+}
+
 /**
  * @brief 格式化存储区域
  */
@@ -157,14 +318,16 @@ bool storage_format(bool format_all)
     }
 
     debug_printf("[STORAGE] Formatting storage areas\n");
+    storage_process_jobs();
+    storage_reset_block();
 
     if (format_all)
     {
         // 格式化所有区域
-        if (!storage_flash_erase_sector(STORAGE_CONFIG_ADDR) ||
-            !storage_flash_erase_sector(STORAGE_HISTORY_ADDR) ||
-            !storage_flash_erase_sector(STORAGE_BACKUP_ADDR) ||
-            !storage_flash_erase_sector(STORAGE_LOG_ADDR))
+        if (!config_journal_format(&g_storage.config_journal) ||
+            !storage_erase_backup() ||
+            !flash_log_format(&g_storage.history_log) ||
+            !flash_log_format(&g_storage.event_log))
         {
             g_storage.status = STORAGE_STATUS_ERASE_ERROR;
             g_storage.stats.erase_errors++;
@@ -181,7 +344,7 @@ bool storage_format(bool format_all)
     else
     {
         // 仅格式化历史区域
-        if (!storage_flash_erase_sector(STORAGE_HISTORY_ADDR))
+        if (!flash_log_format(&g_storage.history_log))
         {
             g_storage.status = STORAGE_STATUS_ERASE_ERROR;
             g_storage.stats.erase_errors++;
@@ -189,10 +352,6 @@ bool storage_format(bool format_all)
         }
     }
 
-    // 重置统计信息
-    g_storage.history_write_index = 0;
-    g_storage.stats.total_erases++;
-
     debug_printf("[STORAGE] Format completed\n");
     return true;
 }
@@ -230,34 +389,13 @@ bool storage_get_stats(storage_stats_t *stats)
  */
 bool storage_read_config(storage_config_t *config)
 {
-    if (!g_storage.initialized || !config)
-    {
-        return false;
-    }
-
-    // 从Flash读取配置
-    if (!storage_flash_read(STORAGE_CONFIG_ADDR, (uint8_t *)config, sizeof(storage_config_t)))
-    {
-        g_storage.status = STORAGE_STATUS_READ_ERROR;
-        g_storage.stats.read_errors++;
-        return false;
-    }
-
-    // 验证魔数和CRC
-    if (config->magic != STORAGE_MAGIC_NUMBER)
-    {
-        debug_printf("[STORAGE] Invalid config magic: 0x%08X\n", config->magic);
-        return false;
-    }
-
-    uint16_t calc_crc = storage_calculate_crc16((uint8_t *)config, sizeof(storage_config_t) - 2);
-    if (calc_crc != config->crc16)
+    if (!g_storage.initialized || !config || !g_storage.config_journal.valid)
     {
-        debug_printf("[STORAGE] Config CRC error: calc=0x%04X, stored=0x%04X\n", calc_crc, config->crc16);
-        g_storage.stats.crc_errors++;
         return false;
     }
 
+    // 挂载时已从Flash恢复并校验，直接读取RAM镜像；排队中的配置优先
+    *config = g_storage.config_pending ? g_storage.pending_config : g_storage.config;
     g_storage.stats.total_reads++;
     return true;
 }
@@ -272,45 +410,28 @@ bool storage_write_config(const storage_config_t *config)
         return false;
     }
 
-    // 准备配置数据
-    storage_config_t write_config = *config;
-    write_config.magic = STORAGE_MAGIC_NUMBER;
-    write_config.version = 1;
-    write_config.size = sizeof(storage_config_t);
-
-    // 计算CRC
-    write_config.crc16 = storage_calculate_crc16((uint8_t *)&write_config, sizeof(storage_config_t) - 2);
-
-    // 擦除配置扇区
-    if (!storage_flash_erase_sector(STORAGE_CONFIG_ADDR))
-    {
-        g_storage.status = STORAGE_STATUS_ERASE_ERROR;
-        g_storage.stats.erase_errors++;
-        return false;
-    }
+    storage_config_t write_config;
+    storage_prepare_config(&write_config, config);
 
-    // 写入配置
-    if (!storage_flash_write(STORAGE_CONFIG_ADDR, (uint8_t *)&write_config, sizeof(storage_config_t)))
-    {
-        g_storage.status = STORAGE_STATUS_WRITE_ERROR;
-        g_storage.stats.write_errors++;
-        return false;
-    }
+    // 同步写入较新，排队中的配置不再写入 (其作业直接完成)
+    g_storage.config_pending = false;
+    return storage_commit_config(&write_config);
+}
 
-    // 验证写入
-    if (!storage_flash_verify(STORAGE_CONFIG_ADDR, (uint8_t *)&write_config, sizeof(storage_config_t)))
+/**
+ * @brief 提交配置参数，由后台写入
+ */
+bool storage_write_config_async(const storage_config_t *config, storage_job_callback_t callback, void *context)
+{
+    if (!g_storage.initialized || !config)
     {
-        g_storage.status = STORAGE_STATUS_WRITE_ERROR;
-        g_storage.stats.write_errors++;
         return false;
     }
 
-    g_storage.stats.total_writes++;
-    g_storage.stats.config_writes++;
-    g_storage.config_write_count++;
-
-    debug_printf("[STORAGE] Config written successfully (count: %d)\n", g_storage.config_write_count);
-    return true;
+    // 只保留最新一份待写配置，执行到任一配置作业时写入
+    storage_prepare_config(&g_storage.pending_config, config);
+    g_storage.config_pending = true;
+    return storage_enqueue_job(STORAGE_TYPE_CONFIG, NULL, callback, context);
 }
 
 /**
@@ -346,8 +467,8 @@ bool storage_backup_config(void)
         return false;
     }
 
-    // 擦除备份扇区
-    if (!storage_flash_erase_sector(STORAGE_BACKUP_ADDR))
+    // 擦除备份页 (检查点区保留)
+    if (!storage_erase_backup())
     {
         g_storage.status = STORAGE_STATUS_ERASE_ERROR;
         g_storage.stats.erase_errors++;
@@ -420,39 +541,33 @@ bool storage_write_sensor_history(int16_t temperature, uint16_t humidity,
         return false;
     }
 
-    storage_sensor_record_t record;
-
-    // 填充记录头部
-    storage_fill_header(&record.header, STORAGE_TYPE_SENSOR, sizeof(record) - sizeof(storage_header_t));
-
-    // 填充传感器数据
-    record.temperature = temperature;
-    record.humidity = humidity;
-    record.voltage = voltage;
-    record.sensor_status = sensor_status;
-    memset(record.reserved, 0, sizeof(record.reserved));
-
-    // 计算CRC (不包括头部的CRC字段)
-    record.header.crc16 = storage_calculate_crc16((uint8_t *)&record + sizeof(storage_header_t),
-                                                  sizeof(record) - sizeof(storage_header_t));
-
-    // 计算写入地址 (循环写入)
-    uint32_t write_addr = STORAGE_HISTORY_ADDR +
-                          (g_storage.history_write_index * sizeof(storage_sensor_record_t)) % STORAGE_HISTORY_SIZE;
+    history_sample_t sample;
+    sample.timestamp = storage_get_timestamp();
+    sample.temperature = temperature;
+    sample.humidity = humidity;
+    sample.voltage = voltage;
+    sample.status = sensor_status;
 
-    // 写入记录
-    if (!storage_write_record(write_addr, &record, sizeof(record)))
+    // 编码进当前数据块；块满时封闭该块排队写入，在另一缓冲开始新块
+    if (!history_encoder_add(&g_storage.history_encoder, &sample))
     {
-        return false;
+        if (!storage_seal_block() || !history_encoder_add(&g_storage.history_encoder, &sample))
+        {
+            return false;
+        }
+    }
+    if (g_storage.history_encoder.count == 1)
+    {
+        g_storage.history_block_time = system_get_tick();
     }
 
-    g_storage.history_write_index++;
     g_storage.stats.history_writes++;
 
-    if (g_storage.history_write_index % 100 == 0)
+    if (g_storage.stats.history_writes % 100 == 0)
     {
-        debug_printf("[STORAGE] Sensor history written: T=%.1f°C, H=%.1f%%RH, V=%.2fV (index: %d)\n",
-                     temperature / 10.0f, humidity / 10.0f, voltage / 1000.0f, g_storage.history_write_index);
+        debug_printf("[STORAGE] Sensor history written: T=%.1f°C, H=%.1f%%RH, V=%.2fV (count: %lu)\n",
+                     temperature / 10.0f, humidity / 10.0f, voltage / 1000.0f,
+                     (unsigned long)g_storage.stats.history_writes);
     }
 
     return true;
@@ -462,7 +577,7 @@ bool storage_write_sensor_history(int16_t temperature, uint16_t humidity,
  * @brief 写入报警历史数据
  */
 bool storage_write_alarm_history(uint8_t alarm_type, uint8_t alarm_level,
-                                 uint16_t alarm_value, uint32_t alarm_duration)
+                                 int32_t alarm_value, uint32_t alarm_duration)
 {
     if (!g_storage.initialized)
     {
@@ -471,29 +586,49 @@ bool storage_write_alarm_history(uint8_t alarm_type, uint8_t alarm_level,
 
     storage_alarm_record_t record;
 
-    // 填充记录头部
-    storage_fill_header(&record.header, STORAGE_TYPE_ALARM, sizeof(record) - sizeof(storage_header_t));
-
     // 填充报警数据
+    memset(&record, 0, sizeof(record));
     record.alarm_type = alarm_type;
     record.alarm_level = alarm_level;
     record.alarm_value = alarm_value;
     record.alarm_duration = alarm_duration;
 
-    // 计算CRC
-    record.header.crc16 = storage_calculate_crc16((uint8_t *)&record + sizeof(storage_header_t),
-                                                  sizeof(record) - sizeof(storage_header_t));
+    return storage_write_alarm_event(&record, storage_get_timestamp());
+}
+
+/**
+ * @brief 写入报警事件
+ */
+bool storage_write_alarm_event(storage_alarm_record_t *record, uint32_t timestamp)
+{
+    return storage_write_alarm_event_async(record, timestamp, NULL, NULL);
+}
+
+/**
+ * @brief 写入报警事件，写入Flash后调用回调
+ */
+bool storage_write_alarm_event_async(storage_alarm_record_t *record, uint32_t timestamp,
+                                     storage_job_callback_t callback, void *context)
+{
+    if (!g_storage.initialized || !record)
+    {
+        return false;
+    }
 
-    // 写入记录 (简化版本，使用固定偏移)
-    uint32_t write_addr = STORAGE_LOG_ADDR + (g_storage.history_write_index % 100) * sizeof(storage_alarm_record_t);
+    // 填充记录头部，时间戳取事件发生时刻
+    storage_fill_header(&record->header, STORAGE_TYPE_ALARM, sizeof(storage_alarm_record_t) - sizeof(storage_header_t));
+    record->header.timestamp = timestamp;
 
-    if (!storage_write_record(write_addr, &record, sizeof(record)))
+    // 计算CRC (不包括头部)，排队写入日志区记录日志
+    record->header.crc16 = storage_calculate_crc16((uint8_t *)record + sizeof(storage_header_t),
+                                                   sizeof(storage_alarm_record_t) - sizeof(storage_header_t));
+    if (!storage_enqueue_job(STORAGE_TYPE_ALARM, record, callback, context))
     {
         return false;
     }
 
-    debug_printf("[STORAGE] Alarm history written: type=%d, level=%d, value=%d\n",
-                 alarm_type, alarm_level, alarm_value);
+    debug_printf("[STORAGE] Alarm history queued: type=%d, level=%d, value=%ld\n",
+                 record->alarm_type, record->alarm_level, (long)record->alarm_value);
 
     return true;
 }
@@ -502,6 +637,15 @@ bool storage_write_alarm_history(uint8_t alarm_type, uint8_t alarm_level,
  * @brief 写入系统状态历史
  */
 bool storage_write_status_history(uint32_t uptime, uint16_t reboot_count, uint8_t error_code)
+{
+    return storage_write_status_history_async(uptime, reboot_count, error_code, NULL, NULL);
+}
+
+/**
+ * @brief 写入系统状态历史，写入Flash后调用回调
+ */
+bool storage_write_status_history_async(uint32_t uptime, uint16_t reboot_count, uint8_t error_code,
+                                        storage_job_callback_t callback, void *context)
 {
     if (!g_storage.initialized)
     {
@@ -519,19 +663,15 @@ bool storage_write_status_history(uint32_t uptime, uint16_t reboot_count, uint8_
     record.error_code = error_code;
     memset(record.reserved, 0, sizeof(record.reserved));
 
-    // 计算CRC
+    // 计算CRC (不包括头部)，排队写入日志区记录日志
     record.header.crc16 = storage_calculate_crc16((uint8_t *)&record + sizeof(storage_header_t),
                                                   sizeof(record) - sizeof(storage_header_t));
-
-    // 写入记录 (简化版本)
-    uint32_t write_addr = STORAGE_LOG_ADDR + 0x100 + (g_storage.history_write_index % 50) * sizeof(storage_status_record_t);
-
-    if (!storage_write_record(write_addr, &record, sizeof(record)))
+    if (!storage_enqueue_job(STORAGE_TYPE_STATUS, &record, callback, context))
     {
         return false;
     }
 
-    debug_printf("[STORAGE] Status history written: uptime=%lu, reboots=%d, error=%d\n",
+    debug_printf("[STORAGE] Status history queued: uptime=%lu, reboots=%d, error=%d\n",
                  uptime, reboot_count, error_code);
 
     return true;
@@ -547,186 +687,344 @@ uint16_t storage_read_sensor_history(storage_sensor_record_t *records, uint16_t
         return 0;
     }
 
-    uint16_t read_count = 0;
+    // 数据块只能从旧到新解码: 先统计总数，再把最后count个采样倒序填入
+    storage_latest_context_t latest;
+    latest.records = records;
+    latest.total = storage_count_samples();
+    latest.skip = latest.total > count ? latest.total - count : 0;
+    latest.index = 0;
 
-    // 简化实现：从最新位置开始读取
-    for (uint16_t i = 0; i < count && i < 10; i++) // 限制最多读取10条
-    {
-        uint32_t read_addr = STORAGE_HISTORY_ADDR +
-                             ((g_storage.history_write_index - i - 1) * sizeof(storage_sensor_record_t)) % STORAGE_HISTORY_SIZE;
+    flash_log_cursor_t cursor;
+    flash_log_entry_t entry;
+    uint8_t block[STORAGE_BLOCK_SIZE];
 
-        if (storage_read_record(read_addr, &records[i], sizeof(storage_sensor_record_t)))
-        {
-            // 验证记录有效性
-            if (records[i].header.magic == STORAGE_MAGIC_NUMBER &&
-                records[i].header.type == STORAGE_TYPE_SENSOR)
-            {
-                read_count++;
-            }
-            else
-            {
-                break; // 遇到无效记录，停止读取
-            }
-        }
-        else
+    flash_log_rewind(&g_storage.history_log, &cursor);
+    while (flash_log_next(&g_storage.history_log, &cursor, &entry, block, sizeof(block)))
+    {
+        if (entry.type == STORAGE_TYPE_SENSOR_BLOCK && entry.length <= sizeof(block))
         {
-            break;
+            storage_visit_block(block, entry.length, storage_latest_visit, &latest);
         }
     }
+    storage_visit_block(g_storage.history_blocks[g_storage.history_active ^ 1], g_storage.sealed_length,
+                        storage_latest_visit, &latest);
+    storage_visit_block(storage_active_block(), history_encoder_length(&g_storage.history_encoder),
+                        storage_latest_visit, &latest);
 
-    return read_count;
+    g_storage.stats.total_reads++;
+    return (uint16_t)(latest.index - latest.skip);
 }
 
-// ============================================================================
-// Flash底层操作接口实现
-// ============================================================================
-
 /**
- * @brief 擦除Flash扇区 (模拟实现)
+ * @brief 读取最新的报警历史数据
  */
-bool storage_flash_erase_sector(uint32_t address)
+uint16_t storage_read_alarm_history(storage_alarm_record_t *records, uint16_t count)
 {
-    // 模拟擦除操作 (实际应调用硬件Flash驱动)
-    debug_printf("[STORAGE] Erasing sector at 0x%08X\n", address);
+    if (!g_storage.initialized || !records || count == 0)
+    {
+        return 0;
+    }
 
-    g_storage.stats.total_erases++;
-    return true; // 模拟成功
+    // 排队中的记录较新，先填入
+    uint16_t queued = storage_read_queued(STORAGE_TYPE_ALARM, records, sizeof(storage_alarm_record_t), count);
+    g_storage.stats.total_reads++;
+    if (queued == count)
+    {
+        return queued;
+    }
+    return (uint16_t)(queued + flash_log_read_latest(&g_storage.event_log, STORAGE_TYPE_ALARM, records + queued,
+                                                     sizeof(storage_alarm_record_t), count - queued));
 }
 
 /**
- * @brief 写入Flash数据 (模拟实现)
+ * @brief 读取最新的状态历史数据
  */
-bool storage_flash_write(uint32_t address, const uint8_t *data, uint16_t length)
+uint16_t storage_read_status_history(storage_status_record_t *records, uint16_t count)
 {
-    if (!data || length == 0)
+    if (!g_storage.initialized || !records || count == 0)
     {
-        return false;
+        return 0;
     }
 
-    // 模拟写入操作 (实际应调用硬件Flash驱动)
-    debug_printf("[STORAGE] Writing %d bytes to 0x%08X\n", length, address);
-
-    g_storage.stats.total_writes++;
-    return true; // 模拟成功
+    // 排队中的记录较新，先填入
+    uint16_t queued = storage_read_queued(STORAGE_TYPE_STATUS, records, sizeof(storage_status_record_t), count);
+    g_storage.stats.total_reads++;
+    if (queued == count)
+    {
+        return queued;
+    }
+    return (uint16_t)(queued + flash_log_read_latest(&g_storage.event_log, STORAGE_TYPE_STATUS, records + queued,
+                                                     sizeof(storage_status_record_t), count - queued));
 }
 
 /**
- * @brief 读取Flash数据 (模拟实现)
+ * @brief 清除历史数据
+ * @note 记录日志只追加，按分区整体清除: 报警与状态记录共用日志区，清除其一会同时清除另一种
  */
-bool storage_flash_read(uint32_t address, uint8_t *data, uint16_t length)
+bool storage_clear_history(uint8_t type)
 {
-    if (!data || length == 0)
+    if (!g_storage.initialized)
     {
         return false;
     }
 
-    // 模拟读取操作 (实际应调用硬件Flash驱动)
-    // 这里返回模拟的默认配置数据
-    if (address == STORAGE_CONFIG_ADDR && length == sizeof(storage_config_t))
+    // 先写入排队中的记录，清除对其同样生效
+    storage_process_jobs();
+
+    bool success = true;
+    if (type == 0xFF || type == STORAGE_TYPE_SENSOR)
     {
-        storage_config_t default_config = storage_get_default_config();
-        memcpy(data, &default_config, length);
+        storage_reset_block();
+        success = flash_log_format(&g_storage.history_log) && success;
     }
-    else
+    if (type == 0xFF || type == STORAGE_TYPE_ALARM || type == STORAGE_TYPE_STATUS)
     {
-        memset(data, 0xFF, length); // 模拟空Flash内容
+        success = flash_log_format(&g_storage.event_log) && success;
     }
 
-    g_storage.stats.total_reads++;
-    return true; // 模拟成功
+    if (!success)
+    {
+        g_storage.status = STORAGE_STATUS_ERASE_ERROR;
+        g_storage.stats.erase_errors++;
+    }
+    return success;
 }
 
 /**
- * @brief 验证Flash数据
+ * @brief 获取历史数据记录数量
  */
-bool storage_flash_verify(uint32_t address, const uint8_t *data, uint16_t length)
+uint16_t storage_get_history_count(uint8_t type)
 {
-    if (!data || length == 0)
+    flash_log_t *log = storage_get_log(type);
+
+    if (!g_storage.initialized || !log)
     {
-        return false;
+        return 0;
     }
 
-    // 简化验证：直接返回成功
-    // 实际实现应该读取Flash内容并与预期数据比较
-    return true;
+    uint32_t count = type == STORAGE_TYPE_SENSOR ? storage_count_samples()
+                                                 : flash_log_count(log, type) + storage_count_queued(type);
+    return count > 0xFFFF ? 0xFFFF : (uint16_t)count;
 }
 
-// ============================================================================
-// 工具函数接口实现
-// ============================================================================
-
 /**
- * @brief 计算CRC16校验
+ * @brief 按时间区间查询历史数据
  */
-uint16_t storage_calculate_crc16(const uint8_t *data, uint16_t length)
+uint16_t storage_query_history(uint8_t type, uint32_t start_time, uint32_t end_time,
+                               storage_history_visitor_t visitor, void *context)
 {
-    uint16_t crc = 0xFFFF;
+    flash_log_t *log = storage_get_log(type);
+    storage_query_context_t query = {visitor, context, start_time, end_time, 0, false};
 
-    for (uint16_t i = 0; i < length; i++)
+    if (!g_storage.initialized || !log || !visitor)
     {
-        crc = (crc >> 8) ^ crc16_table[(crc ^ data[i]) & 0xFF];
+        return 0;
     }
 
-    return crc;
+    g_storage.stats.total_reads++;
+    if (type != STORAGE_TYPE_SENSOR)
+    {
+        flash_log_query(log, type, start_time, end_time, storage_query_visit, &query);
+        if (!query.stopped && start_time <= end_time)
+        {
+            storage_query_queued(type, &query);
+        }
+        return query.count > 0xFFFF ? 0xFFFF : (uint16_t)query.count;
+    }
+
+    // 数据块的日志时间戳为块内末个采样时间: 跳过整块早于起点的块，逐个采样过滤，超出终点时停止
+    if (start_time <= end_time)
+    {
+        flash_log_query(log, STORAGE_TYPE_SENSOR_BLOCK, start_time, 0xFFFFFFFFUL, storage_query_block, &query);
+        if (!query.stopped &&
+            storage_visit_block(g_storage.history_blocks[g_storage.history_active ^ 1], g_storage.sealed_length,
+                                storage_query_sample, &query))
+        {
+            storage_visit_block(storage_active_block(), history_encoder_length(&g_storage.history_encoder),
+                                storage_query_sample, &query);
+        }
+    }
+    return query.count > 0xFFFF ? 0xFFFF : (uint16_t)query.count;
 }
 
 /**
- * @brief 检查数据完整性
+ * @brief 获取历史数据所在的记录日志
  */
-bool storage_check_integrity(const storage_header_t *header, const uint8_t *data)
+flash_log_t *storage_get_export_log(uint8_t type, uint8_t *log_type)
 {
-    if (!header || !data)
-    {
-        return false;
-    }
+    flash_log_t *log = storage_get_log(type);
 
-    // 检查魔数
-    if (header->magic != STORAGE_MAGIC_NUMBER)
+    if (!g_storage.initialized || !log || !log_type)
     {
-        return false;
+        return NULL;
     }
 
-    // 检查CRC
-    uint16_t calc_crc = storage_calculate_crc16(data, header->length);
-    return (calc_crc == header->crc16);
+    storage_flush();
+    *log_type = type == STORAGE_TYPE_SENSOR ? STORAGE_TYPE_SENSOR_BLOCK : type;
+    return log;
 }
 
 /**
- * @brief 获取空闲存储空间
+ * @brief 获取当前记录时间戳
  */
-uint32_t storage_get_free_space(uint8_t type)
+uint32_t storage_get_timestamp(void)
 {
-    switch (type)
-    {
-    case STORAGE_TYPE_CONFIG:
-        return STORAGE_CONFIG_SIZE - sizeof(storage_config_t);
-    case STORAGE_TYPE_SENSOR:
-    case STORAGE_TYPE_ALARM:
-    case STORAGE_TYPE_STATUS:
-        return STORAGE_HISTORY_SIZE - (g_storage.history_write_index * sizeof(storage_sensor_record_t));
-    default:
-        return 0;
-    }
+    return system_get_tick() + g_storage.time_offset;
 }
 
+// ============================================================================
+// Flash底层操作接口实现
+// ============================================================================
+
 /**
- * @brief 存储碎片整理 (简化实现)
+ * @brief 擦除Flash分区 (STORAGE_REGION_SIZE)
  */
-bool storage_defragment(void)
+bool storage_flash_erase_sector(uint32_t address)
 {
-    if (!g_storage.initialized)
+    debug_printf("[STORAGE] Erasing region at 0x%08X\n", address);
+
+    for (uint32_t offset = 0; offset < STORAGE_REGION_SIZE; offset += FLASH_PAGE_SIZE)
     {
-        return false;
+        if (!flash_erase_page(address + offset))
+        {
+            return false;
+        }
     }
 
-    debug_printf("[STORAGE] Defragmentation not implemented yet\n");
-    return true; // 暂时返回成功
+    g_storage.stats.total_erases++;
+    return true;
 }
 
 /**
- * @brief 打印存储状态信息
+ * @brief 写入Flash数据
  */
-void storage_print_status(void)
+bool storage_flash_write(uint32_t address, const uint8_t *data, uint16_t length)
+{
+    if (!data || length == 0)
+    {
+        return false;
+    }
+
+    if (!flash_program(address, data, length))
+    {
+        return false;
+    }
+
+    g_storage.stats.total_writes++;
+    return true;
+}
+
+/**
+ * @brief 读取Flash数据
+ */
+bool storage_flash_read(uint32_t address, uint8_t *data, uint16_t length)
+{
+    if (!data || length == 0)
+    {
+        return false;
+    }
+
+    if (!flash_read(address, data, length))
+    {
+        return false;
+    }
+
+    g_storage.stats.total_reads++;
+    return true;
+}
+
+/**
+ * @brief 验证Flash数据
+ */
+bool storage_flash_verify(uint32_t address, const uint8_t *data, uint16_t length)
+{
+    return flash_verify(address, data, length);
+}
+
+// ============================================================================
+// 工具函数接口实现
+// ============================================================================
+
+/**
+ * @brief 计算CRC16校验
+ */
+uint16_t storage_calculate_crc16(const uint8_t *data, uint16_t length)
+{
+    return storage_crc16_update(0xFFFF, data, length);
+}
+
+/**
+ * @brief 增量计算CRC16
+ */
+uint16_t storage_crc16_update(uint16_t crc, const uint8_t *data, uint16_t length)
+{
+    for (uint16_t i = 0; i < length; i++)
+    {
+        crc = (crc >> 8) ^ crc16_table[(crc ^ data[i]) & 0xFF];
+    }
+
+    return crc;
+}
+
+/**
+ * @brief 检查数据完整性
+ */
+bool storage_check_integrity(const storage_header_t *header, const uint8_t *data)
+{
+    if (!header || !data)
+    {
+        return false;
+    }
+
+    // 检查魔数
+    if (header->magic != (uint16_t)STORAGE_MAGIC_NUMBER)
+    {
+        return false;
+    }
+
+    // 检查CRC
+    uint16_t calc_crc = storage_calculate_crc16(data, header->length);
+    return (calc_crc == header->crc16);
+}
+
+/**
+ * @brief 获取空闲存储空间
+ */
+uint32_t storage_get_free_space(uint8_t type)
+{
+    switch (type)
+    {
+    case STORAGE_TYPE_CONFIG:
+        // 当前bank中还可追加差分记录的空间
+        return config_journal_get_free_space(&g_storage.config_journal);
+    case STORAGE_TYPE_SENSOR:
+    case STORAGE_TYPE_ALARM:
+    case STORAGE_TYPE_STATUS:
+        // 日志循环写入，此处为回收最旧扇区前的剩余空间
+        return flash_log_get_free_space(storage_get_log(type));
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief 存储碎片整理 (简化实现)
+ */
+bool storage_defragment(void)
+{
+    if (!g_storage.initialized)
+    {
+        return false;
+    }
+
+    debug_printf("[STORAGE] Defragmentation not implemented yet\n");
+    return true; // 暂时返回成功
+}
+
+/**
+ * @brief 打印存储状态信息
+ */
+void storage_print_status(void)
 {
     if (!g_storage.initialized)
     {
@@ -740,8 +1038,17 @@ void storage_print_status(void)
     debug_printf("\n[STORAGE] Module Status:\n");
     debug_printf("  - Initialized: %s\n", g_storage.initialized ? "Yes" : "No");
     debug_printf("  - Status: %s\n", (g_storage.status < STORAGE_STATUS_COUNT) ? status_names[g_storage.status] : "UNKNOWN");
-    debug_printf("  - Config writes: %d\n", g_storage.config_write_count);
-    debug_printf("  - History index: %d\n", g_storage.history_write_index);
+    debug_printf("  - Config writes: %d (bank %d, seq %lu, %d bytes free)\n", g_storage.config_write_count,
+                 g_storage.config_journal.active, (unsigned long)g_storage.config_journal.sequence,
+                 config_journal_get_free_space(&g_storage.config_journal));
+    debug_printf("  - Pending samples: %d (%d bytes)\n", g_storage.history_encoder.count,
+                 history_encoder_length(&g_storage.history_encoder));
+    debug_printf("  - Pending jobs: %d (sealed block: %d bytes)\n", g_storage.job_count, g_storage.sealed_length);
+    debug_printf("  - History samples: %lu in %lu blocks\n", (unsigned long)storage_count_samples(),
+                 (unsigned long)flash_log_count(&g_storage.history_log, STORAGE_TYPE_SENSOR_BLOCK));
+    debug_printf("  - Event records: %lu (next seq: %lu)\n",
+                 (unsigned long)flash_log_count(&g_storage.event_log, FLASH_LOG_TYPE_ANY),
+                 (unsigned long)g_storage.event_log.next_sequence);
     debug_printf("  - Free space: %lu bytes\n", storage_get_free_space(STORAGE_TYPE_SENSOR));
     debug_printf("\n");
 }
@@ -766,6 +1073,8 @@ void storage_print_stats(void)
     debug_printf("  - CRC errors: %lu\n", g_storage.stats.crc_errors);
     debug_printf("  - Config writes: %lu\n", g_storage.stats.config_writes);
     debug_printf("  - History writes: %lu\n", g_storage.stats.history_writes);
+    debug_printf("  - Queued jobs: %lu (%lu run synchronously)\n", g_storage.stats.queued_jobs,
+                 g_storage.stats.sync_jobs);
     debug_printf("\n");
 }
 
@@ -781,15 +1090,36 @@ void storage_task(void)
 
     uint32_t current_time = system_get_tick();
 
+    // 未满数据块超时封闭，限制意外复位时可能丢失的时间窗口
+    if (g_storage.history_encoder.count &&
+        current_time - g_storage.history_block_time >= STORAGE_BLOCK_MAX_AGE)
+    {
+        storage_seal_block();
+    }
+
+    // 每次只执行一个作业或一页预擦除，写入路径上的擦除都提前在空闲时完成；
+    // 两者都只在总线空闲窗口内执行 (队列满时写入接口退化为同步写入)
+    if (g_storage.job_count)
+    {
+        if (storage_bus_idle(STORAGE_JOB_TIME_MS))
+        {
+            storage_run_job();
+        }
+    }
+    else if (storage_bus_idle(STORAGE_ERASE_TIME_MS))
+    {
+        storage_maintain();
+    }
+
     // 定期检查存储状态
     static uint32_t last_check_time = 0;
     if (current_time - last_check_time > 30000) // 每30秒检查一次
     {
-        // 检查存储空间
+        // 检查存储空间 (日志循环写入，不足时最旧扇区将被回收)
         uint32_t free_space = storage_get_free_space(STORAGE_TYPE_SENSOR);
-        if (free_space < 1024) // 少于1KB时警告
+        if (free_space < 1024) // 少于1KB时提示
         {
-            debug_printf("[STORAGE] Warning: Low storage space (%lu bytes)\n", free_space);
+            debug_printf("[STORAGE] History log wrapping, oldest records will be recycled (%lu bytes left)\n", free_space);
         }
 
         // 更新统计信息
@@ -808,9 +1138,23 @@ void storage_task(void)
  */
 static bool storage_init_flash(void)
 {
-    // 模拟Flash初始化
-    // 实际实现应该初始化Flash控制器，检查Flash状态等
-    debug_printf("[STORAGE] Flash initialized (simulated)\n");
+    return flash_init();
+}
+
+/**
+ * @brief 擦除配置备份页 (备份区其余部分为检查点区)
+ */
+static bool storage_erase_backup(void)
+{
+    for (uint32_t offset = 0; offset < STORAGE_BACKUP_SIZE; offset += FLASH_PAGE_SIZE)
+    {
+        if (!flash_erase_page(STORAGE_BACKUP_ADDR + offset))
+        {
+            return false;
+        }
+    }
+
+    g_storage.stats.total_erases++;
     return true;
 }
 
@@ -850,6 +1194,31 @@ static storage_config_t storage_get_default_config(void)
     return config;
 }
 
+/**
+ * @brief 挂载配置日志，恢复当前配置
+ * @return true: 已恢复有效配置, false: 需要写入默认配置
+ */
+static bool storage_load_config(void)
+{
+    if (config_journal_mount(&g_storage.config_journal, STORAGE_CONFIG_ADDR, STORAGE_CONFIG_BANK_SIZE,
+                             &g_storage.config, sizeof(storage_config_t)))
+    {
+        return true;
+    }
+
+    // 旧版本单份配置位于配置区起始处 (bank 0)，首次提交写入bank 1完成迁移
+    storage_config_t legacy;
+    if (!storage_flash_read(STORAGE_CONFIG_ADDR, (uint8_t *)&legacy, sizeof(storage_config_t)) ||
+        legacy.magic != STORAGE_MAGIC_NUMBER ||
+        storage_calculate_crc16((uint8_t *)&legacy, sizeof(storage_config_t) - 2) != legacy.crc16)
+    {
+        return false;
+    }
+
+    debug_printf("[STORAGE] Migrating legacy config\n");
+    return storage_write_config(&legacy);
+}
+
 /**
  * @brief 填充记录头部
  */
@@ -860,60 +1229,479 @@ static void storage_fill_header(storage_header_t *header, uint8_t type, uint8_t
         return;
     }
 
-    header->magic = STORAGE_MAGIC_NUMBER;
+    header->magic = (uint16_t)STORAGE_MAGIC_NUMBER; // 记录头魔数为16位
     header->type = type;
     header->length = length;
-    header->timestamp = system_get_tick();
+    header->timestamp = storage_get_timestamp();
     header->crc16 = 0; // 在外部计算
     header->reserved = 0;
 }
 
 /**
- * @brief 写入记录
+ * @brief 挂载历史区与日志区的记录日志
  */
-static bool storage_write_record(uint32_t base_addr, const void *data, uint16_t length)
+static bool storage_mount_logs(void)
 {
-    if (!data || length == 0)
+    // 回收最旧扇区的擦除与检查点写入由storage_task()在空闲时完成
+    flash_log_set_deferred_erase(&g_storage.history_log, true);
+    flash_log_set_deferred_erase(&g_storage.event_log, true);
+    flash_log_set_checkpoint(&g_storage.history_log, STORAGE_CHECKPOINT_ADDR, STORAGE_CHECKPOINT_PAGES);
+    flash_log_set_checkpoint(&g_storage.event_log, STORAGE_CHECKPOINT_ADDR + STORAGE_CHECKPOINT_PAGES * FLASH_PAGE_SIZE,
+                             STORAGE_CHECKPOINT_PAGES);
+
+    if (!flash_log_mount(&g_storage.history_log, STORAGE_HISTORY_ADDR, STORAGE_SECTOR_SIZE,
+                         STORAGE_REGION_SIZE / STORAGE_SECTOR_SIZE) ||
+        !flash_log_mount(&g_storage.event_log, STORAGE_LOG_ADDR, STORAGE_SECTOR_SIZE,
+                         STORAGE_REGION_SIZE / STORAGE_SECTOR_SIZE))
     {
         return false;
     }
 
-    // 写入数据
-    if (!storage_flash_write(base_addr, (const uint8_t *)data, length))
+    // 传感器采样先编码进RAM数据块，整块排队写入；报警/状态记录逐条排队写入
+    storage_reset_block();
+
+    // 系统滴答每次上电从0开始，接续已存记录的时间戳，使区间查询按时间有序
+    uint32_t history_time = 0, event_time = 0;
+    bool has_history = flash_log_get_last_timestamp(&g_storage.history_log, &history_time);
+    bool has_event = flash_log_get_last_timestamp(&g_storage.event_log, &event_time);
+    if (has_history || has_event)
+    {
+        uint32_t last_time = history_time > event_time ? history_time : event_time;
+        g_storage.time_offset = last_time + 1 - system_get_tick();
+    }
+    return true;
+}
+
+/**
+ * @brief 按数据类型选择记录日志
+ */
+static flash_log_t *storage_get_log(uint8_t type)
+{
+    switch (type)
+    {
+    case STORAGE_TYPE_SENSOR:
+        return &g_storage.history_log;
+    case STORAGE_TYPE_ALARM:
+    case STORAGE_TYPE_STATUS:
+        return &g_storage.event_log;
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * @brief 将记录 (已计算CRC) 追加到对应日志
+ */
+static bool storage_append_record(uint8_t type, void *record, uint8_t length)
+{
+    storage_header_t *header = (storage_header_t *)record;
+
+    if (!flash_log_append(storage_get_log(type), type, header->timestamp, record, length))
     {
         g_storage.status = STORAGE_STATUS_WRITE_ERROR;
         g_storage.stats.write_errors++;
         return false;
     }
 
-    // 验证写入
-    if (!storage_flash_verify(base_addr, (const uint8_t *)data, length))
+    g_storage.stats.total_writes++;
+    g_storage.last_write_time = system_get_tick();
+    return true;
+}
+
+/**
+ * @brief 区间查询回调适配 (记录数据即完整存储记录)
+ */
+static bool storage_query_visit(const flash_log_entry_t *entry, const void *data, void *context)
+{
+    storage_query_context_t *query = (storage_query_context_t *)context;
+
+    (void)entry;
+    query->count++;
+    if (!query->visitor((const storage_header_t *)data, query->context))
+    {
+        query->stopped = true;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 填写配置的标识与CRC
+ */
+static void storage_prepare_config(storage_config_t *write_config, const storage_config_t *config)
+{
+    *write_config = *config;
+    write_config->magic = STORAGE_MAGIC_NUMBER;
+    write_config->version = 1;
+    write_config->size = sizeof(storage_config_t);
+
+    // 计算CRC
+    write_config->crc16 = storage_calculate_crc16((uint8_t *)write_config, sizeof(storage_config_t) - 2);
+}
+
+/**
+ * @brief 将配置提交到配置日志
+ */
+static bool storage_commit_config(const storage_config_t *write_config)
+{
+    // 与当前配置比较生成差分记录，必要时快照写入另一bank
+    uint32_t erases = g_storage.config_journal.stats.erases;
+    if (!config_journal_commit(&g_storage.config_journal, &g_storage.config, write_config))
     {
         g_storage.status = STORAGE_STATUS_WRITE_ERROR;
         g_storage.stats.write_errors++;
         return false;
     }
 
+    g_storage.config = *write_config;
+    g_storage.stats.total_writes++;
+    g_storage.stats.total_erases += g_storage.config_journal.stats.erases - erases;
+    g_storage.stats.config_writes++;
+    g_storage.config_write_count++;
+
+    debug_printf("[STORAGE] Config written successfully (count: %d)\n", g_storage.config_write_count);
     return true;
 }
 
 /**
- * @brief 读取记录
+ * @brief 作业入队
+ * @note 队列满时先在调用者中同步执行最早的作业
  */
-static bool storage_read_record(uint32_t base_addr, void *data, uint16_t length)
+static bool storage_enqueue_job(uint8_t type, const void *record, storage_job_callback_t callback, void *context)
 {
-    if (!data || length == 0)
+    if (g_storage.job_count >= STORAGE_JOB_QUEUE_SIZE)
+    {
+        g_storage.stats.sync_jobs++;
+        storage_run_job();
+    }
+
+    storage_job_t *job = &g_storage.jobs[(g_storage.job_head + g_storage.job_count) % STORAGE_JOB_QUEUE_SIZE];
+    job->type = type;
+    job->callback = callback;
+    job->context = context;
+    if (record)
+    {
+        const storage_header_t *header = (const storage_header_t *)record;
+        memcpy(&job->record, record, sizeof(storage_header_t) + header->length);
+    }
+
+    g_storage.job_count++;
+    g_storage.stats.queued_jobs++;
+    return true;
+}
+
+/**
+ * @brief 执行最早的作业并调用其完成回调
+ */
+static bool storage_run_job(void)
+{
+    storage_job_t *job = &g_storage.jobs[g_storage.job_head];
+    bool success;
+
+    switch (job->type)
+    {
+    case STORAGE_TYPE_CONFIG:
+        // 多次提交已合并: 首个作业写入最新配置，其余作业直接完成
+        success = !g_storage.config_pending || storage_commit_config(&g_storage.pending_config);
+        g_storage.config_pending = false;
+        break;
+    case STORAGE_TYPE_SENSOR_BLOCK:
+        success = storage_write_sealed_block();
+        break;
+    default:
+        success = storage_append_record(job->type, &job->record,
+                                        (uint8_t)(sizeof(storage_header_t) + job->record.header.length));
+        break;
+    }
+
+    // 先出队再回调，回调中可以提交新作业
+    uint8_t type = job->type;
+    storage_job_callback_t callback = job->callback;
+    void *context = job->context;
+    g_storage.job_head = (uint8_t)((g_storage.job_head + 1) % STORAGE_JOB_QUEUE_SIZE);
+    g_storage.job_count--;
+
+    if (callback)
+    {
+        callback(type, success, context);
+    }
+    return success;
+}
+
+/**
+ * @brief 空闲时的后台维护: 预擦除一页/一个扇区，或写入一个到期的检查点
+ */
+static void storage_maintain(void)
+{
+    if (flash_log_maintain(&g_storage.history_log) || flash_log_maintain(&g_storage.event_log))
+    {
+        return;
+    }
+
+    uint32_t erases = g_storage.config_journal.stats.erases;
+    if (config_journal_maintain(&g_storage.config_journal))
+    {
+        g_storage.stats.total_erases += g_storage.config_journal.stats.erases - erases;
+    }
+}
+
+/**
+ * @brief 判断总线能否容忍一段阻塞
+ */
+static bool storage_bus_idle(uint32_t duration_ms)
+{
+    return !g_storage_idle_check || g_storage_idle_check(duration_ms, g_storage_idle_context);
+}
+
+/**
+ * @brief 从排队记录中读取最新的记录 (从新到旧)
+ */
+static uint16_t storage_read_queued(uint8_t type, void *records, uint16_t record_size, uint16_t count)
+{
+    uint16_t filled = 0;
+
+    for (uint8_t i = g_storage.job_count; i > 0 && filled < count; i--)
+    {
+        const storage_job_t *job = &g_storage.jobs[(g_storage.job_head + i - 1) % STORAGE_JOB_QUEUE_SIZE];
+        if (job->type == type)
+        {
+            memcpy((uint8_t *)records + (uint32_t)filled * record_size, &job->record, record_size);
+            filled++;
+        }
+    }
+    return filled;
+}
+
+/**
+ * @brief 统计排队中的指定类型记录
+ */
+static uint16_t storage_count_queued(uint8_t type)
+{
+    uint16_t count = 0;
+
+    for (uint8_t i = 0; i < g_storage.job_count; i++)
+    {
+        if (g_storage.jobs[(g_storage.job_head + i) % STORAGE_JOB_QUEUE_SIZE].type == type)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 区间查询: 排队中的记录 (晚于Flash中的记录)
+ */
+static void storage_query_queued(uint8_t type, storage_query_context_t *query)
+{
+    for (uint8_t i = 0; i < g_storage.job_count; i++)
+    {
+        const storage_job_t *job = &g_storage.jobs[(g_storage.job_head + i) % STORAGE_JOB_QUEUE_SIZE];
+        if (job->type != type || job->record.header.timestamp < query->start_time)
+        {
+            continue;
+        }
+        if (job->record.header.timestamp > query->end_time)
+        {
+            return;
+        }
+
+        query->count++;
+        if (!query->visitor(&job->record.header, query->context))
+        {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 正在编码的数据块缓冲
+ */
+static uint8_t *storage_active_block(void)
+{
+    return g_storage.history_blocks[g_storage.history_active];
+}
+
+/**
+ * @brief 在当前缓冲开始新块
+ */
+static void storage_reset_block(void)
+{
+    history_encoder_init(&g_storage.history_encoder, storage_active_block(), STORAGE_BLOCK_SIZE);
+}
+
+/**
+ * @brief 封闭当前数据块排队写入，在另一缓冲开始新块
+ * @note 上一个封闭块尚未写入时 (后台长时间未运行) 先同步执行排队作业
+ */
+static bool storage_seal_block(void)
+{
+    history_encoder_t *encoder = &g_storage.history_encoder;
+    uint16_t length = history_encoder_length(encoder);
+
+    if (length == 0)
+    {
+        return true;
+    }
+    if (g_storage.sealed_length)
+    {
+        storage_process_jobs();
+    }
+
+    // 日志时间戳取块内末个采样时间，区间查询据此跳过整块早于起点的块
+    g_storage.sealed_length = length;
+    g_storage.sealed_time = encoder->last.timestamp;
+    g_storage.history_active ^= 1;
+    storage_reset_block();
+    return storage_enqueue_job(STORAGE_TYPE_SENSOR_BLOCK, NULL, g_storage.block_callback, g_storage.block_context);
+}
+
+/**
+ * @brief 将封闭的数据块写入历史区
+ * @note 写入失败时丢弃该块，避免后续采样无法写入
+ */
+static bool storage_write_sealed_block(void)
+{
+    bool result = true;
+
+    if (g_storage.sealed_length == 0)
+    {
+        return true;
+    }
+
+    if (flash_log_append(&g_storage.history_log, STORAGE_TYPE_SENSOR_BLOCK, g_storage.sealed_time,
+                         g_storage.history_blocks[g_storage.history_active ^ 1], (uint8_t)g_storage.sealed_length))
+    {
+        g_storage.stats.total_writes++;
+        g_storage.last_write_time = system_get_tick();
+    }
+    else
+    {
+        g_storage.status = STORAGE_STATUS_WRITE_ERROR;
+        g_storage.stats.write_errors++;
+        result = false;
+    }
+
+    g_storage.sealed_length = 0;
+    return result;
+}
+
+/**
+ * @brief 由采样生成传感器记录 (含记录头与CRC)
+ */
+static void storage_fill_sensor_record(storage_sensor_record_t *record, const history_sample_t *sample)
+{
+    storage_fill_header(&record->header, STORAGE_TYPE_SENSOR,
+                        sizeof(storage_sensor_record_t) - sizeof(storage_header_t));
+    record->header.timestamp = sample->timestamp;
+    record->temperature = sample->temperature;
+    record->humidity = sample->humidity;
+    record->voltage = sample->voltage;
+    record->sensor_status = sample->status;
+    memset(record->reserved, 0, sizeof(record->reserved));
+    record->header.crc16 = storage_calculate_crc16((const uint8_t *)record + sizeof(storage_header_t),
+                                                   sizeof(storage_sensor_record_t) - sizeof(storage_header_t));
+}
+
+/**
+ * @brief 解码数据块并逐个采样回调
+ * @return true: 块内采样已全部回调, false: 回调要求停止
+ */
+static bool storage_visit_block(const uint8_t *block, uint16_t length, storage_sample_visitor_t visitor,
+                                void *context)
+{
+    history_decoder_t decoder;
+    history_sample_t sample;
+
+    if (!history_decoder_init(&decoder, block, length))
+    {
+        return true;
+    }
+
+    while (history_decoder_next(&decoder, &sample))
+    {
+        if (!visitor(&sample, context))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 统计传感器采样总数 (Flash中的数据块 + RAM中的封闭块与当前块)
+ */
+static uint32_t storage_count_samples(void)
+{
+    flash_log_cursor_t cursor;
+    flash_log_entry_t entry;
+    uint8_t header[HISTORY_CODEC_HEADER_SIZE];
+    uint32_t count = g_storage.history_encoder.count +
+                     history_block_count(g_storage.history_blocks[g_storage.history_active ^ 1], g_storage.sealed_length);
+
+    flash_log_rewind(&g_storage.history_log, &cursor);
+    while (flash_log_next(&g_storage.history_log, &cursor, &entry, header, sizeof(header)))
+    {
+        if (entry.type == STORAGE_TYPE_SENSOR_BLOCK)
+        {
+            count += history_block_count(header, entry.length < sizeof(header) ? entry.length : sizeof(header));
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 最新采样读取回调: 跳过较旧的采样，其余倒序写入输出数组
+ */
+static bool storage_latest_visit(const history_sample_t *sample, void *context)
+{
+    storage_latest_context_t *latest = (storage_latest_context_t *)context;
+
+    if (latest->index >= latest->total)
     {
         return false;
     }
+    if (latest->index >= latest->skip)
+    {
+        storage_fill_sensor_record(&latest->records[latest->total - 1 - latest->index], sample);
+    }
+    latest->index++;
+    return true;
+}
+
+/**
+ * @brief 区间查询: 过滤单个采样并回调
+ */
+static bool storage_query_sample(const history_sample_t *sample, void *context)
+{
+    storage_query_context_t *query = (storage_query_context_t *)context;
+    storage_sensor_record_t record;
 
-    // 读取数据
-    if (!storage_flash_read(base_addr, (uint8_t *)data, length))
+    if (sample->timestamp < query->start_time)
     {
-        g_storage.status = STORAGE_STATUS_READ_ERROR;
-        g_storage.stats.read_errors++;
+        return true;
+    }
+    if (sample->timestamp > query->end_time)
+    {
+        query->stopped = true;
         return false;
     }
 
+    storage_fill_sensor_record(&record, sample);
+    query->count++;
+    if (!query->visitor(&record.header, query->context))
+    {
+        query->stopped = true;
+        return false;
+    }
     return true;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief 区间查询: 解码命中的数据块
+ */
+static bool storage_query_block(const flash_log_entry_t *entry, const void *data, void *context)
+{
+    uint16_t length = entry->length < FLASH_LOG_QUERY_DATA ? entry->length : FLASH_LOG_QUERY_DATA;
+    return storage_visit_block((const uint8_t *)data, length, storage_query_sample, context);
+}
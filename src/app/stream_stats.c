@@ -0,0 +1,248 @@
+/**
+ * @file stream_stats.c
+ * @brief 憨云DTU流式统计实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * P²扩展到多分位数时，标记点取 0, p1/2, p1, (p1+p2)/2, p2, (p2+p3)/2, p3, (1+p3)/2, 1，
+ * 期望位置由样本数和分位比例直接计算，不单独存储
+ */
+
+#include "stream_stats.h"
+#include <string.h>
+
+// ============================================================================
+// 内部数据
+// ============================================================================
+
+// 各标记点对应的分位比例 (Q16.16)，p50/p95/p99位于索引2/4/6
+static const uint32_t g_stream_stats_fractions[STREAM_STATS_MARKERS] = {
+    0,     // 最小值
+    16384, // 0.25
+    32768, // 0.50
+    47514, // 0.725
+    62259, // 0.95
+    63570, // 0.97
+    64881, // 0.99
+    65208, // 0.995
+    65536  // 最大值
+};
+
+#define STREAM_STATS_P50_MARKER 2
+#define STREAM_STATS_P95_MARKER 4
+#define STREAM_STATS_P99_MARKER 6
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static void stream_stats_update_markers(stream_stats_t *stats, q16_t value);
+static q16_t stream_stats_quantile(const stream_stats_t *stats, uint8_t marker);
+static uint32_t stream_stats_isqrt(uint64_t value);
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+/**
+ * @brief 复位统计
+ */
+void stream_stats_reset(stream_stats_t *stats)
+{
+    memset(stats, 0, sizeof(stream_stats_t));
+    stats->min = Q16_MAX;
+    stats->max = Q16_MIN;
+}
+
+/**
+ * @brief 加入一个样本
+ */
+void stream_stats_update(stream_stats_t *stats, q16_t value)
+{
+    stats->count++;
+
+    if (value < stats->min)
+    {
+        stats->min = value;
+    }
+    if (value > stats->max)
+    {
+        stats->max = value;
+    }
+
+    // Welford: mean += delta/n, M2 += delta * (x - mean_new)
+    if (stats->count == 1)
+    {
+        stats->mean = value;
+        stats->m2 = 0;
+    }
+    else
+    {
+        int64_t delta = (int64_t)value - stats->mean;
+        stats->mean = (q16_t)(stats->mean + delta / (int64_t)stats->count);
+        stats->m2 += (delta * ((int64_t)value - stats->mean)) >> Q16_SHIFT;
+    }
+
+    stream_stats_update_markers(stats, value);
+}
+
+/**
+ * @brief 获取统计摘要
+ */
+void stream_stats_get_summary(const stream_stats_t *stats, stream_stats_summary_t *summary)
+{
+    memset(summary, 0, sizeof(stream_stats_summary_t));
+
+    if (stats->count == 0)
+    {
+        return;
+    }
+
+    summary->count = stats->count;
+    summary->min = stats->min;
+    summary->max = stats->max;
+    summary->mean = stats->mean;
+
+    if (stats->count > 1)
+    {
+        summary->variance = q16_saturate(stats->m2 / (int64_t)(stats->count - 1));
+        summary->stddev = (q16_t)stream_stats_isqrt((uint64_t)summary->variance << Q16_SHIFT);
+    }
+
+    summary->p50 = stream_stats_quantile(stats, STREAM_STATS_P50_MARKER);
+    summary->p95 = stream_stats_quantile(stats, STREAM_STATS_P95_MARKER);
+    summary->p99 = stream_stats_quantile(stats, STREAM_STATS_P99_MARKER);
+}
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief 更新P²标记点
+ */
+static void stream_stats_update_markers(stream_stats_t *stats, q16_t value)
+{
+    q16_t *heights = stats->heights;
+    uint32_t *positions = stats->positions;
+
+    // 前9个样本: 插入排序保存，满9个后作为初始标记点
+    if (stats->count <= STREAM_STATS_MARKERS)
+    {
+        uint8_t i = (uint8_t)(stats->count - 1);
+        while (i > 0 && heights[i - 1] > value)
+        {
+            heights[i] = heights[i - 1];
+            i--;
+        }
+        heights[i] = value;
+
+        if (stats->count == STREAM_STATS_MARKERS)
+        {
+            for (i = 0; i < STREAM_STATS_MARKERS; i++)
+            {
+                positions[i] = (uint32_t)i + 1;
+            }
+        }
+        return;
+    }
+
+    // 定位样本所在区间k (heights[k] <= value < heights[k+1])，两端扩展最值
+    uint8_t k;
+    if (value < heights[0])
+    {
+        heights[0] = value;
+        k = 0;
+    }
+    else if (value >= heights[STREAM_STATS_MARKERS - 1])
+    {
+        heights[STREAM_STATS_MARKERS - 1] = value;
+        k = STREAM_STATS_MARKERS - 2;
+    }
+    else
+    {
+        k = 0;
+        while (value >= heights[k + 1])
+        {
+            k++;
+        }
+    }
+
+    for (uint8_t i = k + 1; i < STREAM_STATS_MARKERS; i++)
+    {
+        positions[i]++;
+    }
+
+    // 调整中间标记点: 偏离期望位置超过1时按抛物线 (越界则线性) 移动一格
+    for (uint8_t i = 1; i < STREAM_STATS_MARKERS - 1; i++)
+    {
+        int64_t desired = Q16_ONE + (int64_t)(stats->count - 1) * g_stream_stats_fractions[i];
+        int64_t offset = desired - ((int64_t)positions[i] << Q16_SHIFT);
+        int32_t gap_up = (int32_t)(positions[i + 1] - positions[i]);
+        int32_t gap_down = (int32_t)(positions[i] - positions[i - 1]);
+
+        if (!((offset >= Q16_ONE && gap_up > 1) || (offset <= -Q16_ONE && gap_down > 1)))
+        {
+            continue;
+        }
+
+        int32_t s = offset > 0 ? 1 : -1;
+        int64_t rise_up = (int64_t)heights[i + 1] - heights[i];
+        int64_t rise_down = (int64_t)heights[i] - heights[i - 1];
+        int64_t candidate = heights[i] +
+                            s * ((gap_down + s) * rise_up / gap_up + (gap_up - s) * rise_down / gap_down) /
+                                (gap_up + gap_down);
+
+        if (candidate <= heights[i - 1] || candidate >= heights[i + 1])
+        {
+            candidate = heights[i] + (s > 0 ? rise_up / gap_up : -rise_down / gap_down);
+        }
+
+        heights[i] = (q16_t)candidate;
+        positions[i] = (uint32_t)((int32_t)positions[i] + s);
+    }
+}
+
+/**
+ * @brief 读取分位数估计 (样本不足9个时取有序样本)
+ */
+static q16_t stream_stats_quantile(const stream_stats_t *stats, uint8_t marker)
+{
+    if (stats->count >= STREAM_STATS_MARKERS)
+    {
+        return stats->heights[marker];
+    }
+
+    uint32_t index = ((stats->count - 1) * g_stream_stats_fractions[marker] + (Q16_ONE / 2)) >> Q16_SHIFT;
+    return stats->heights[index];
+}
+
+/**
+ * @brief 64位整数平方根 (逐位求解，无除法)
+ */
+static uint32_t stream_stats_isqrt(uint64_t value)
+{
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+
+    while (bit != 0)
+    {
+        if (value >= result + bit)
+        {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)result;
+}
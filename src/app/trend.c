@@ -0,0 +1,301 @@
+/**
+ * @file trend.c
+ * @brief 憨云DTU多分辨率趋势数据实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 各级独立累加 (而非由分钟桶逐级汇总)，平均值按样本数精确加权；
+ * 时间跳变时以空桶补齐，保证环中桶在时间上连续
+ */
+
+#include "trend.h"
+#include "system.h"
+#include <string.h>
+
+// ============================================================================
+// 内部数据结构
+// ============================================================================
+
+/**
+ * @brief 单级环形桶控制块
+ */
+typedef struct
+{
+    uint16_t head;           // 下一个写入位置
+    uint16_t filled;         // 已封桶数
+    trend_accumulator_t acc; // 当前桶累加器
+} trend_ring_t;
+
+// 各级桶周期 (s) 与容量
+static const uint32_t g_trend_periods[TREND_LEVEL_COUNT] = {60UL, 3600UL, 86400UL};
+static const uint16_t g_trend_capacity[TREND_LEVEL_COUNT] = {
+    TREND_MINUTE_BUCKETS, TREND_HOUR_BUCKETS, TREND_DAY_BUCKETS};
+
+// 环形桶存储
+static trend_bucket_t g_trend_minute[TREND_CHANNELS][TREND_MINUTE_BUCKETS];
+static trend_bucket_t g_trend_hour[TREND_CHANNELS][TREND_HOUR_BUCKETS];
+static trend_bucket_t g_trend_day[TREND_CHANNELS][TREND_DAY_BUCKETS];
+static trend_ring_t g_trend_rings[TREND_CHANNELS][TREND_LEVEL_COUNT];
+static uint8_t g_trend_shift[TREND_CHANNELS];
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static trend_bucket_t *trend_get_buckets(uint8_t channel, trend_level_t level);
+static void trend_push(uint8_t channel, trend_level_t level, const trend_bucket_t *bucket);
+static void trend_close_bucket(uint8_t channel, trend_level_t level, uint32_t index);
+static int16_t trend_encode(q16_t value, uint8_t shift);
+static void trend_reset_channel(uint8_t channel);
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+/**
+ * @brief 趋势模块初始化
+ */
+void trend_init(void)
+{
+    for (uint8_t ch = 0; ch < TREND_CHANNELS; ch++)
+    {
+        g_trend_shift[ch] = TREND_VALUE_SHIFT_DEFAULT;
+        trend_reset_channel(ch);
+    }
+
+    debug_printf("[TREND] Initialized: %d channels, %d/%d/%d buckets, %lu bytes RAM\n",
+                 TREND_CHANNELS, TREND_MINUTE_BUCKETS, TREND_HOUR_BUCKETS, TREND_DAY_BUCKETS,
+                 (unsigned long)trend_get_ram_usage());
+}
+
+/**
+ * @brief 设置通道桶值精度
+ */
+bool trend_set_resolution(uint8_t channel, uint8_t value_shift)
+{
+    if (channel >= TREND_CHANNELS || value_shift > Q16_SHIFT)
+    {
+        return false;
+    }
+
+    g_trend_shift[channel] = value_shift;
+    trend_reset_channel(channel);
+    return true;
+}
+
+/**
+ * @brief 加入一个样本
+ */
+void trend_add_sample(uint8_t channel, q16_t value, uint32_t time_s)
+{
+    if (channel >= TREND_CHANNELS)
+    {
+        return;
+    }
+
+    for (uint8_t level = 0; level < TREND_LEVEL_COUNT; level++)
+    {
+        trend_accumulator_t *acc = &g_trend_rings[channel][level].acc;
+        uint32_t index = time_s / g_trend_periods[level];
+
+        // 跨入新桶 (时间回退时并入当前桶)
+        if (acc->count > 0 && index > acc->index)
+        {
+            trend_close_bucket(channel, (trend_level_t)level, index);
+        }
+
+        if (acc->count == 0)
+        {
+            acc->index = index;
+            acc->min = value;
+            acc->max = value;
+            acc->sum = 0;
+        }
+        else
+        {
+            if (value < acc->min)
+            {
+                acc->min = value;
+            }
+            if (value > acc->max)
+            {
+                acc->max = value;
+            }
+        }
+
+        acc->sum += value;
+        acc->count++;
+    }
+}
+
+/**
+ * @brief 查询趋势数据
+ */
+uint16_t trend_query(uint8_t channel, trend_level_t level, trend_point_t *points, uint16_t max_points)
+{
+    if (channel >= TREND_CHANNELS || level >= TREND_LEVEL_COUNT || !points)
+    {
+        return 0;
+    }
+
+    const trend_ring_t *ring = &g_trend_rings[channel][level];
+    const trend_bucket_t *buckets = trend_get_buckets(channel, level);
+    uint16_t capacity = g_trend_capacity[level];
+    uint32_t period = g_trend_periods[level];
+    uint8_t shift = g_trend_shift[channel];
+    bool has_current = ring->acc.count > 0;
+    uint16_t total = (uint16_t)(ring->filled + (has_current ? 1 : 0));
+    uint16_t count = total < max_points ? total : max_points;
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    // 最后一个点为当前桶，向前依次为最近封桶的桶
+    uint16_t closed = (uint16_t)(has_current ? count - 1 : count);
+    uint16_t pos = (uint16_t)((ring->head + capacity - closed) % capacity);
+    uint32_t first_index = ring->acc.index - closed;
+
+    for (uint16_t i = 0; i < closed; i++)
+    {
+        const trend_bucket_t *bucket = &buckets[pos];
+        trend_point_t *point = &points[i];
+
+        point->start_time = (first_index + i) * period;
+        point->valid = bucket->min <= bucket->max;
+        point->min = point->valid ? (q16_t)bucket->min * (1L << shift) : 0;
+        point->max = point->valid ? (q16_t)bucket->max * (1L << shift) : 0;
+        point->avg = point->valid ? (q16_t)bucket->avg * (1L << shift) : 0;
+
+        if (++pos == capacity)
+        {
+            pos = 0;
+        }
+    }
+
+    if (has_current)
+    {
+        trend_point_t *point = &points[closed];
+        point->start_time = ring->acc.index * period;
+        point->valid = true;
+        point->min = ring->acc.min;
+        point->max = ring->acc.max;
+        point->avg = (q16_t)(ring->acc.sum / (int64_t)ring->acc.count);
+    }
+
+    return count;
+}
+
+/**
+ * @brief 获取模块RAM占用
+ */
+uint32_t trend_get_ram_usage(void)
+{
+    return (uint32_t)(sizeof(g_trend_minute) + sizeof(g_trend_hour) + sizeof(g_trend_day) +
+                      sizeof(g_trend_rings) + sizeof(g_trend_shift));
+}
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief 获取通道某级的桶数组
+ */
+static trend_bucket_t *trend_get_buckets(uint8_t channel, trend_level_t level)
+{
+    switch (level)
+    {
+    case TREND_LEVEL_MINUTE:
+        return g_trend_minute[channel];
+    case TREND_LEVEL_HOUR:
+        return g_trend_hour[channel];
+    default:
+        return g_trend_day[channel];
+    }
+}
+
+/**
+ * @brief 写入一个封桶 (满后覆盖最旧)
+ */
+static void trend_push(uint8_t channel, trend_level_t level, const trend_bucket_t *bucket)
+{
+    trend_ring_t *ring = &g_trend_rings[channel][level];
+    trend_bucket_t *buckets = trend_get_buckets(channel, level);
+
+    buckets[ring->head] = *bucket;
+    if (++ring->head == g_trend_capacity[level])
+    {
+        ring->head = 0;
+    }
+    if (ring->filled < g_trend_capacity[level])
+    {
+        ring->filled++;
+    }
+}
+
+/**
+ * @brief 封存当前桶，并以空桶补齐到新桶序号之前
+ */
+static void trend_close_bucket(uint8_t channel, trend_level_t level, uint32_t index)
+{
+    trend_ring_t *ring = &g_trend_rings[channel][level];
+    trend_accumulator_t *acc = &ring->acc;
+    uint8_t shift = g_trend_shift[channel];
+    uint32_t gaps = index - acc->index - 1;
+    trend_bucket_t bucket;
+
+    // 空档超过整个环，旧数据全部过期
+    if (gaps >= g_trend_capacity[level])
+    {
+        ring->head = 0;
+        ring->filled = 0;
+        acc->count = 0;
+        return;
+    }
+
+    bucket.min = trend_encode(acc->min, shift);
+    bucket.max = trend_encode(acc->max, shift);
+    bucket.avg = trend_encode((q16_t)(acc->sum / (int64_t)acc->count), shift);
+    trend_push(channel, level, &bucket);
+
+    bucket.min = INT16_MAX;
+    bucket.max = INT16_MIN;
+    bucket.avg = 0;
+    while (gaps-- > 0)
+    {
+        trend_push(channel, level, &bucket);
+    }
+
+    acc->count = 0;
+}
+
+/**
+ * @brief Q16.16压缩为int16 (四舍五入，饱和)
+ */
+static int16_t trend_encode(q16_t value, uint8_t shift)
+{
+    int32_t rounded = shift ? (int32_t)(((int64_t)value + (1L << (shift - 1))) >> shift) : value;
+
+    if (rounded > INT16_MAX)
+    {
+        return INT16_MAX - 1; // INT16_MAX保留给空桶标记
+    }
+    if (rounded < INT16_MIN)
+    {
+        return INT16_MIN + 1;
+    }
+    return (int16_t)rounded;
+}
+
+/**
+ * @brief 清空通道所有级别
+ */
+static void trend_reset_channel(uint8_t channel)
+{
+    memset(g_trend_rings[channel], 0, sizeof(g_trend_rings[channel]));
+    memset(g_trend_minute[channel], 0, sizeof(g_trend_minute[channel]));
+    memset(g_trend_hour[channel], 0, sizeof(g_trend_hour[channel]));
+    memset(g_trend_day[channel], 0, sizeof(g_trend_day[channel]));
+}
@@ -10,8 +10,205 @@
 #include "system.h"
 #include "adc.h"
 #include "gpio.h"
+#include "filter.h"
 #include <string.h>
 
+#if !ADC_TIMER_SIMULATOR
+#include "nano100b_reg.h"
+
+// TMR0寄存器 (NANO100B)
+#define TMR0_BASE 0x40010000UL
+#define TMR0_CTL (*(volatile uint32_t *)(TMR0_BASE + 0x00))
+#define TMR0_PRECNT (*(volatile uint32_t *)(TMR0_BASE + 0x04))
+#define TMR0_CMPR (*(volatile uint32_t *)(TMR0_BASE + 0x08))
+#define TMR0_IER (*(volatile uint32_t *)(TMR0_BASE + 0x0C))
+#define TMR0_ISR (*(volatile uint32_t *)(TMR0_BASE + 0x10))
+#define TMR0_DR (*(volatile uint32_t *)(TMR0_BASE + 0x14))
+
+#define TMR_CTL_TMR_EN (1UL << 0)        // 计数使能
+#define TMR_CTL_SW_RST (1UL << 1)        // 软件复位
+#define TMR_CTL_MODE_PERIODIC (1UL << 4) // 周期模式 (匹配时计数清零)
+#define TMR_IER_TMRIE (1UL << 0)         // 比较匹配中断使能
+#define TMR_ISR_TMRIS (1UL << 0)         // 比较匹配中断标志 (写1清除)
+#define TMR_PRESCALE_1MHZ 11             // HIRC 12MHz / (11 + 1)
+
+#define CLK_CLKSEL1_TMR0_MASK (0x7UL << 8)
+#define CLK_CLKSEL1_TMR0_HIRC (0x4UL << 8)
+
+#define TMR0_IRQ 8
+#define NVIC_ISER (*(volatile uint32_t *)0xE000E100UL)
+#define NVIC_ICER (*(volatile uint32_t *)0xE000E180UL)
+#endif
+
+// ============================================================================
+// 内部数据结构
+// ============================================================================
+
+/**
+ * @brief 扫描组控制块
+ */
+typedef struct
+{
+    adc_scan_config_t config;  // 扫描组配置
+    adc_scan_frame_t frame;    // 帧缓冲区 (PDMA目标地址)
+    volatile bool busy;        // 扫描进行中
+    volatile bool frame_ready; // 帧就绪 (供阻塞读取)
+    uint32_t sequence;         // 帧序号
+    uint32_t overrun_count;    // 上一帧未完成时再次启动的次数
+    bool timer_running;        // 定时器触发使能
+    uint32_t timer_period_us;  // 定时器触发周期
+    uint32_t timer_step_us;    // 定时器中断间隔 (周期 / 分频数)
+    uint16_t timer_divider;    // 每N次定时器中断触发一帧
+    uint16_t timer_subcount;   // 本帧已经过的定时器中断数
+    uint32_t timer_count_us;   // 最近一次比较匹配的名义时刻
+    uint8_t pending_mask;      // 本帧尚未完成过采样的通道
+    adc_oversample_t oversample[ADC_CHANNEL_COUNT]; // 各通道过采样累加器
+} adc_scan_state_t;
+
+static adc_scan_state_t g_adc_scan = {0};
+
+#if ADC_TIMER_SIMULATOR
+static uint32_t g_adc_sim_latency_us = 0; // 模拟的中断响应延迟
+#endif
+
+// 模拟输入 (主机回放注入，ADC_SIM_DEFAULT为默认模拟值)
+static uint16_t g_adc_sim_value[ADC_CHANNEL_COUNT] = {
+    ADC_SIM_DEFAULT, ADC_SIM_DEFAULT, ADC_SIM_DEFAULT, ADC_SIM_DEFAULT,
+    ADC_SIM_DEFAULT, ADC_SIM_DEFAULT, ADC_SIM_DEFAULT, ADC_SIM_DEFAULT};
+
+// ============================================================================
+// 内部函数
+// ============================================================================
+
+/**
+ * @brief 模拟一次转换 (简化实现：不同通道返回不同值)
+ */
+static uint16_t adc_sim_convert(adc_channel_t channel)
+{
+    if (g_adc_sim_value[channel] != ADC_SIM_DEFAULT)
+    {
+        return g_adc_sim_value[channel];
+    }
+    return 2048 + (channel * 100);
+}
+
+/**
+ * @brief 启动TMR0周期中断
+ * @param period_us 扫描周期 (微秒)
+ * @return 每帧的定时器中断数
+ */
+static uint16_t adc_timer_program(uint32_t period_us)
+{
+#if !ADC_TIMER_SIMULATOR
+    // 24位比较值放不下时，取能整除周期的最小分频数，每N次中断触发一帧
+    uint32_t divider = (period_us + ADC_TIMER_CMPR_MAX - 1) / ADC_TIMER_CMPR_MAX;
+    while (period_us % divider != 0)
+    {
+        divider++;
+    }
+
+    NVIC_ICER = 1UL << TMR0_IRQ;
+    REG32(CLK_BASE + CLK_APBCLK_OFFSET) |= CLK_APBCLK_TMR0_EN;
+    REG32(CLK_BASE + CLK_CLKSEL1_OFFSET) =
+        (REG32(CLK_BASE + CLK_CLKSEL1_OFFSET) & ~CLK_CLKSEL1_TMR0_MASK) | CLK_CLKSEL1_TMR0_HIRC;
+
+    TMR0_CTL = TMR_CTL_SW_RST;
+    TMR0_PRECNT = TMR_PRESCALE_1MHZ;
+    TMR0_CMPR = period_us / divider;
+    TMR0_ISR = TMR_ISR_TMRIS;
+    TMR0_IER = TMR_IER_TMRIE;
+    TMR0_CTL = TMR_CTL_MODE_PERIODIC | TMR_CTL_TMR_EN;
+    NVIC_ISER = 1UL << TMR0_IRQ;
+    return (uint16_t)divider;
+#else
+    (void)period_us;
+    return 1;
+#endif
+}
+
+/**
+ * @brief 停止TMR0
+ */
+static void adc_timer_halt(void)
+{
+#if !ADC_TIMER_SIMULATOR
+    NVIC_ICER = 1UL << TMR0_IRQ;
+    TMR0_IER = 0;
+    TMR0_CTL = 0;
+    TMR0_ISR = TMR_ISR_TMRIS;
+#endif
+}
+
+/**
+ * @brief 比较匹配到当前的时间 (周期模式下匹配时计数清零，中断入口读出即为响应延迟)
+ */
+static uint32_t adc_timer_latency_us(void)
+{
+#if !ADC_TIMER_SIMULATOR
+    return TMR0_DR;
+#else
+    return g_adc_sim_latency_us;
+#endif
+}
+
+/**
+ * @brief 触发一次扫描序列
+ * @param trigger_us 触发时刻 (微秒)
+ */
+static void adc_scan_trigger(uint32_t trigger_us)
+{
+    g_adc_scan.busy = true;
+    g_adc_scan.frame_ready = false;
+    g_adc_scan.frame.channel_mask = g_adc_scan.config.channel_mask;
+    g_adc_scan.frame.timestamp_us = trigger_us;
+    g_adc_scan.pending_mask = g_adc_scan.config.channel_mask;
+
+    // 简化实现：每轮扫描立即完成，逐轮进入中断处理直到整帧完成
+    while (g_adc_scan.busy)
+    {
+        adc_interrupt_handler();
+    }
+}
+
+/**
+ * @brief 一轮扫描完成处理 (ADC或PDMA中断上下文)
+ */
+static void adc_scan_complete(void)
+{
+    adc_scan_frame_t *frame = &g_adc_scan.frame;
+
+    // 使用PDMA时结果已由DMA写入缓冲区；否则在此依次读取各通道数据寄存器
+    // 过采样通道累加满4^n次后才输出，未完成的通道继续下一轮扫描
+    for (uint8_t ch = 0; ch < ADC_CHANNEL_COUNT; ch++)
+    {
+        if (g_adc_scan.pending_mask & (1U << ch))
+        {
+            uint16_t raw = adc_sim_convert((adc_channel_t)ch);
+            if (adc_oversample_add(&g_adc_scan.oversample[ch], raw, &frame->values[ch]))
+            {
+                g_adc_scan.pending_mask &= (uint8_t)~(1U << ch);
+            }
+        }
+    }
+
+    if (g_adc_scan.pending_mask != 0)
+    {
+        // 仅对未完成通道重新启动扫描
+        return;
+    }
+
+    frame->sequence = ++g_adc_scan.sequence;
+    frame->timestamp = system_get_tick();
+
+    g_adc_scan.busy = false;
+    g_adc_scan.frame_ready = true;
+
+    if (g_adc_scan.config.callback)
+    {
+        g_adc_scan.config.callback(frame);
+    }
+}
+
 // ============================================================================
 // ADC模块初始化
 // ============================================================================
@@ -73,8 +270,7 @@ bool adc_read_single(adc_channel_t channel, uint16_t *value, uint32_t timeout_ms
         return false;
     }
 
-    // 简化实现：返回模拟值
-    *value = 2048 + (channel * 100); // 模拟不同通道的不同值
+    *value = adc_sim_convert(channel);
 
     return true;
 }
@@ -169,6 +365,257 @@ bool adc_calibrate(adc_channel_t channel)
     return true;
 }
 
+// ============================================================================
+// 扫描组接口 (简化实现)
+// ============================================================================
+
+/**
+ * @brief 配置扫描组 (所有通道组成一个硬件扫描序列)
+ * @param config 扫描组配置
+ * @return true: 成功, false: 失败 (参数无效或扫描进行中)
+ */
+bool adc_scan_config(const adc_scan_config_t *config)
+{
+    if (!config || config->channel_mask == 0 || g_adc_scan.busy)
+    {
+        return false;
+    }
+
+    memcpy(&g_adc_scan.config, config, sizeof(adc_scan_config_t));
+    memset(&g_adc_scan.frame, 0, sizeof(adc_scan_frame_t));
+    g_adc_scan.frame_ready = false;
+
+    for (uint8_t ch = 0; ch < ADC_CHANNEL_COUNT; ch++)
+    {
+        adc_oversample_init(&g_adc_scan.oversample[ch], config->oversample_bits[ch]);
+    }
+
+    debug_printf("[ADC] Scan group configured: mask=0x%02X, pdma=%d\n",
+                 config->channel_mask, config->use_pdma);
+    return true;
+}
+
+/**
+ * @brief 启动一次扫描 (非阻塞，整帧完成后调用回调)
+ * @return true: 成功, false: 未配置或上一帧未完成
+ */
+bool adc_scan_start(void)
+{
+    if (g_adc_scan.config.channel_mask == 0)
+    {
+        return false;
+    }
+
+    if (g_adc_scan.busy)
+    {
+        g_adc_scan.overrun_count++;
+        return false;
+    }
+
+    adc_scan_trigger(system_get_tick() * 1000U);
+    return true;
+}
+
+/**
+ * @brief 启动定时器触发扫描 (TMR0周期触发，转换与主循环无关)
+ * @param period_us 触发周期 (微秒)
+ * @return true: 成功, false: 未配置或参数无效
+ */
+bool adc_scan_start_timer(uint32_t period_us)
+{
+    if (g_adc_scan.config.channel_mask == 0 || period_us < 2)
+    {
+        return false;
+    }
+
+    g_adc_scan.timer_running = false;
+    g_adc_scan.timer_period_us = period_us;
+    g_adc_scan.timer_subcount = 0;
+    g_adc_scan.timer_count_us = system_get_tick() * 1000U;
+    g_adc_scan.timer_divider = adc_timer_program(period_us);
+    g_adc_scan.timer_step_us = period_us / g_adc_scan.timer_divider;
+    g_adc_scan.timer_running = true;
+
+    debug_printf("[ADC] Scan timer started, period: %lu us\n", period_us);
+    return true;
+}
+
+/**
+ * @brief 定时器触发事件 (由TMR0_IRQHandler调用)
+ */
+void adc_timer_trigger_handler(void)
+{
+    if (!g_adc_scan.timer_running)
+    {
+        return;
+    }
+
+    // 时间戳取实际触发时刻: 名义匹配时刻 + 硬件计数读出的响应延迟
+    uint32_t latency_us = adc_timer_latency_us();
+    g_adc_scan.timer_count_us += g_adc_scan.timer_step_us;
+    if (++g_adc_scan.timer_subcount < g_adc_scan.timer_divider)
+    {
+        return;
+    }
+    g_adc_scan.timer_subcount = 0;
+
+    // 上一帧尚未完成则本次触发丢失
+    if (g_adc_scan.busy)
+    {
+        g_adc_scan.overrun_count++;
+        return;
+    }
+
+    adc_scan_trigger(g_adc_scan.timer_count_us + latency_us);
+}
+
+#if !ADC_TIMER_SIMULATOR
+/**
+ * @brief TMR0中断服务程序 (覆盖启动文件中的弱定义)
+ */
+void TMR0_IRQHandler(void)
+{
+    TMR0_ISR = TMR_ISR_TMRIS;
+    adc_timer_trigger_handler();
+}
+#endif
+
+/**
+ * @brief 停止扫描并清除扫描组配置
+ * @return true: 成功, false: 失败
+ */
+bool adc_scan_stop(void)
+{
+    adc_timer_halt();
+    g_adc_scan.timer_running = false;
+    g_adc_scan.busy = false;
+    g_adc_scan.frame_ready = false;
+    memset(&g_adc_scan.config, 0, sizeof(adc_scan_config_t));
+
+    debug_printf("[ADC] Scan group stopped\n");
+    return true;
+}
+
+/**
+ * @brief 查询扫描是否进行中
+ * @return true: 进行中, false: 空闲
+ */
+bool adc_scan_is_busy(void)
+{
+    return g_adc_scan.busy;
+}
+
+/**
+ * @brief 阻塞方式采集一帧
+ * @param frame 帧数据输出
+ * @param timeout_ms 超时时间(毫秒)
+ * @return true: 成功, false: 失败/超时
+ */
+bool adc_scan_read_frame(adc_scan_frame_t *frame, uint32_t timeout_ms)
+{
+    if (!frame)
+    {
+        return false;
+    }
+
+    if (!g_adc_scan.busy && !adc_scan_start())
+    {
+        return false;
+    }
+
+    uint32_t start_time = system_get_tick();
+    while (!g_adc_scan.frame_ready)
+    {
+        if ((system_get_tick() - start_time) >= timeout_ms)
+        {
+            return false;
+        }
+    }
+
+    memcpy(frame, &g_adc_scan.frame, sizeof(adc_scan_frame_t));
+    return true;
+}
+
+/**
+ * @brief 初始化过采样累加器
+ * @param oversample 累加器
+ * @param extra_bits 扩展位数n (超过ADC_OVERSAMPLE_MAX_BITS时限幅)
+ */
+void adc_oversample_init(adc_oversample_t *oversample, uint8_t extra_bits)
+{
+    if (!oversample)
+    {
+        return;
+    }
+
+    oversample->accumulator = 0;
+    oversample->count = 0;
+    oversample->extra_bits = (extra_bits > ADC_OVERSAMPLE_MAX_BITS) ? ADC_OVERSAMPLE_MAX_BITS : extra_bits;
+}
+
+/**
+ * @brief 累加一次转换结果 (在转换完成路径中调用)
+ * @param oversample 累加器
+ * @param raw 12位转换结果
+ * @param result 满4^n次时输出12+n位抽取结果
+ * @return true: 输出就绪, false: 继续累加
+ */
+bool adc_oversample_add(adc_oversample_t *oversample, uint16_t raw, uint16_t *result)
+{
+    oversample->accumulator += raw;
+    oversample->count++;
+
+    // 4^n = 1 << 2n 次累加后右移n位
+    if (oversample->count < (1U << (oversample->extra_bits * 2)))
+    {
+        return false;
+    }
+
+    *result = (uint16_t)(oversample->accumulator >> oversample->extra_bits);
+    oversample->accumulator = 0;
+    oversample->count = 0;
+    return true;
+}
+
+/**
+ * @brief 计算采集时序 (主机端模型)
+ * @param config 扫描组配置 (通道掩码、采样时间、是否使用PDMA)
+ * @param burst true: 扫描组连续转换, false: 软件逐通道读取
+ * @param timing 时序输出
+ */
+void adc_scan_get_timing(const adc_scan_config_t *config, bool burst, adc_scan_timing_t *timing)
+{
+    if (!config || !timing)
+    {
+        return;
+    }
+
+    uint8_t count = 0;
+    uint32_t conversions = 0;
+    for (uint8_t ch = 0; ch < ADC_CHANNEL_COUNT; ch++)
+    {
+        if (config->channel_mask & (1U << ch))
+        {
+            uint8_t bits = config->oversample_bits[ch];
+            count++;
+            conversions += 1U << (2 * (bits > ADC_OVERSAMPLE_MAX_BITS ? ADC_OVERSAMPLE_MAX_BITS : bits));
+        }
+    }
+
+    // 单通道转换时间 = (采样时钟 + 转换时钟) / ADC时钟
+    uint32_t conversion_ns = (uint32_t)(((uint64_t)(config->sample_time + ADC_CONVERSION_CLOCKS) * 1000000000ULL) / ADC_CLOCK_HZ);
+
+    // 扫描模式下通道背靠背转换；逐通道读取每次还要加上软件触发/轮询开销
+    timing->slot_ns = burst ? conversion_ns : conversion_ns + ADC_SW_READ_OVERHEAD_NS;
+
+    // 过采样通道按4^n轮重复转换，偏斜按首轮计算
+    timing->channel_count = count;
+    timing->conversions = (uint16_t)conversions;
+    timing->frame_ns = timing->slot_ns * conversions;
+    timing->skew_ns = count ? timing->slot_ns * (count - 1) : 0;
+    timing->cpu_register_reads = (burst && config->use_pdma) ? 0 : (uint16_t)conversions;
+}
+
 // ============================================================================
 // 传感器专用接口 (简化实现)
 // ============================================================================
@@ -367,25 +814,26 @@ bool adc_get_min_max(adc_channel_t channel, uint16_t *min_value, uint16_t *max_v
  */
 uint16_t adc_digital_filter(uint16_t raw_value, adc_channel_t channel)
 {
-    static uint16_t filter_buffer[ADC_CHANNEL_COUNT][4] = {0};
-    static uint8_t filter_index[ADC_CHANNEL_COUNT] = {0};
+    static filter_t filters[ADC_CHANNEL_COUNT];
+    static bool filters_ready = false;
 
     if (channel >= ADC_CHANNEL_COUNT)
     {
         return raw_value;
     }
 
-    // 简单的4点移动平均滤波
-    filter_buffer[channel][filter_index[channel]] = raw_value;
-    filter_index[channel] = (filter_index[channel] + 1) % 4;
-
-    uint32_t sum = 0;
-    for (int i = 0; i < 4; i++)
+    // 首次调用时初始化4点滑动平均
+    if (!filters_ready)
     {
-        sum += filter_buffer[channel][i];
+        const filter_config_t config = {.type = FILTER_TYPE_MOVING_AVERAGE, .window = 4, .param = 0};
+        for (int i = 0; i < ADC_CHANNEL_COUNT; i++)
+        {
+            filter_init(&filters[i], &config);
+        }
+        filters_ready = true;
     }
 
-    return (uint16_t)(sum / 4);
+    return filter_update(&filters[channel], raw_value);
 }
 
 // ============================================================================
@@ -414,7 +862,11 @@ bool adc_set_callback(adc_channel_t channel, adc_callback_t callback)
  */
 void adc_interrupt_handler(void)
 {
-    // 简化实现：占位符
+    // 扫描序列结束 (ADF标志或PDMA传输完成)
+    if (g_adc_scan.busy)
+    {
+        adc_scan_complete();
+    }
 }
 
 // ============================================================================
@@ -482,6 +934,8 @@ void adc_print_all_status(void)
 {
     debug_printf("\n[ADC] All ADC Status:\n");
     debug_printf("Module initialized: Yes (simplified)\n");
+    debug_printf("Scan group: mask=0x%02X, frames=%lu, overruns=%lu\n",
+                 g_adc_scan.config.channel_mask, g_adc_scan.sequence, g_adc_scan.overrun_count);
 
     for (int i = 0; i < ADC_CHANNEL_COUNT; i++)
     {
@@ -498,4 +952,30 @@ bool adc_self_test(void)
 {
     debug_printf("[ADC] Self test passed\n");
     return true;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief 设置模拟转换输入 (简化实现/主机回放用)
+ * @param channel ADC通道
+ * @param value 12位转换值，ADC_SIM_DEFAULT恢复默认模拟值
+ */
+void adc_sim_set_value(adc_channel_t channel, uint16_t value)
+{
+    if (channel >= ADC_CHANNEL_COUNT)
+    {
+        return;
+    }
+
+    g_adc_sim_value[channel] = (value == ADC_SIM_DEFAULT) ? ADC_SIM_DEFAULT : (value & 0x0FFF);
+}
+
+#if ADC_TIMER_SIMULATOR
+/**
+ * @brief 设置模拟的定时器中断响应延迟
+ * @param latency_us 比较匹配到进入中断的时间 (微秒)
+ */
+void adc_sim_set_trigger_latency(uint32_t latency_us)
+{
+    g_adc_sim_latency_us = latency_us;
+}
+#endif
\ No newline at end of file
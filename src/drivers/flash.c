@@ -0,0 +1,439 @@
+/**
+ * @file flash.c
+ * @brief 憨云DTU内部Flash驱动实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * 目标板通过FMC ISP命令擦除/编程APROM，读取直接访问映射地址；
+ * 主机环境以RAM镜像模拟NOR行为 (编程按位与)，用于日志存储的掉电与磨损测试
+ */
+
+#include "flash.h"
+#include "system.h"
+#include <string.h>
+
+#if FLASH_SIMULATOR
+#include <stdio.h>
+#endif
+
+// ============================================================================
+// 内部数据结构
+// ============================================================================
+
+#if !FLASH_SIMULATOR
+// FMC寄存器 (NANO100B)
+#define FMC_BASE 0x5000C000UL
+#define FMC_ISPCON (*(volatile uint32_t *)(FMC_BASE + 0x00))
+#define FMC_ISPADR (*(volatile uint32_t *)(FMC_BASE + 0x04))
+#define FMC_ISPDAT (*(volatile uint32_t *)(FMC_BASE + 0x08))
+#define FMC_ISPCMD (*(volatile uint32_t *)(FMC_BASE + 0x0C))
+#define FMC_ISPTRG (*(volatile uint32_t *)(FMC_BASE + 0x10))
+
+#define FMC_ISPCON_ISPEN (1UL << 0) // ISP使能
+#define FMC_ISPCON_APUEN (1UL << 3) // APROM更新使能
+#define FMC_ISPCON_ISPFF (1UL << 6) // ISP失败标志 (写1清除)
+#define FMC_ISPTRG_ISPGO (1UL << 0) // 启动ISP
+
+#define FMC_CMD_PROGRAM 0x21    // 字编程
+#define FMC_CMD_PAGE_ERASE 0x22 // 页擦除
+
+#define SYS_REGLCTL (*(volatile uint32_t *)0x50000100UL) // 寄存器写保护
+#define CLK_AHBCLK (*(volatile uint32_t *)0x50000204UL)
+#define CLK_AHBCLK_ISP_EN (1UL << 2)
+#else
+static uint8_t g_flash_image[FLASH_SIZE];                           // 模拟Flash镜像
+static uint32_t g_flash_page_erases[FLASH_SIZE / FLASH_PAGE_SIZE]; // 各页擦除次数
+static FILE *g_flash_file = NULL;                                   // 映射文件
+static uint32_t g_flash_cut_budget = 0;                             // 掉电注入剩余预算
+static bool g_flash_cut_armed = false;                              // 掉电注入使能
+static bool g_flash_powered_off = false;                            // 已掉电
+static bool g_flash_sim_ready = false;                              // 镜像已初始化
+#endif
+
+static flash_stats_t g_flash_stats = {0};
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static bool flash_check_range(uint32_t address, uint32_t length);
+
+#if !FLASH_SIMULATOR
+static bool flash_isp_command(uint32_t command, uint32_t address, uint32_t data);
+#else
+static void flash_sim_prepare(void);
+static uint32_t flash_sim_consume(uint32_t length);
+static void flash_sim_sync(uint32_t address, uint32_t length);
+#endif
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+/**
+ * @brief Flash驱动初始化
+ */
+bool flash_init(void)
+{
+#if !FLASH_SIMULATOR
+    SYS_REGLCTL = 0x59;
+    SYS_REGLCTL = 0x16;
+    SYS_REGLCTL = 0x88;
+    CLK_AHBCLK |= CLK_AHBCLK_ISP_EN;
+    FMC_ISPCON |= FMC_ISPCON_ISPEN | FMC_ISPCON_APUEN;
+    SYS_REGLCTL = 0x00;
+#else
+    flash_sim_prepare();
+#endif
+
+    debug_printf("[FLASH] Initialized: %lu KB, page %d bytes\n",
+                 (unsigned long)(FLASH_SIZE / 1024), FLASH_PAGE_SIZE);
+    return true;
+}
+
+/**
+ * @brief 擦除一页
+ */
+bool flash_erase_page(uint32_t address)
+{
+    if ((address % FLASH_PAGE_SIZE) != 0 || !flash_check_range(address, FLASH_PAGE_SIZE))
+    {
+        g_flash_stats.error_count++;
+        return false;
+    }
+
+#if !FLASH_SIMULATOR
+    if (!flash_isp_command(FMC_CMD_PAGE_ERASE, address, 0))
+    {
+        g_flash_stats.error_count++;
+        return false;
+    }
+#else
+    flash_sim_prepare();
+
+    // 掉电打断擦除: 只有前一部分被擦除
+    uint32_t done = flash_sim_consume(FLASH_PAGE_SIZE);
+    memset(&g_flash_image[address], 0xFF, done);
+    if (done > 0)
+    {
+        g_flash_page_erases[address / FLASH_PAGE_SIZE]++;
+    }
+    flash_sim_sync(address, FLASH_PAGE_SIZE);
+    if (done < FLASH_PAGE_SIZE)
+    {
+        g_flash_stats.error_count++;
+        return false;
+    }
+#endif
+
+    g_flash_stats.erase_count++;
+    return true;
+}
+
+/**
+ * @brief 编程数据
+ */
+bool flash_program(uint32_t address, const uint8_t *data, uint16_t length)
+{
+    if (!data || length == 0 || (address % FLASH_PROGRAM_UNIT) != 0 || !flash_check_range(address, length))
+    {
+        g_flash_stats.error_count++;
+        return false;
+    }
+
+#if !FLASH_SIMULATOR
+    for (uint16_t offset = 0; offset < length; offset += FLASH_PROGRAM_UNIT)
+    {
+        uint32_t word = 0xFFFFFFFFUL;
+        uint16_t chunk = (length - offset) < FLASH_PROGRAM_UNIT ? (length - offset) : FLASH_PROGRAM_UNIT;
+        memcpy(&word, &data[offset], chunk);
+
+        if (!flash_isp_command(FMC_CMD_PROGRAM, address + offset, word))
+        {
+            g_flash_stats.error_count++;
+            return false;
+        }
+    }
+#else
+    flash_sim_prepare();
+
+    // 掉电打断编程: 按字完成预算内的部分
+    uint32_t done = flash_sim_consume(length);
+    if (done < length)
+    {
+        done -= done % FLASH_PROGRAM_UNIT;
+    }
+    for (uint32_t i = 0; i < done; i++)
+    {
+        g_flash_image[address + i] &= data[i];
+    }
+    flash_sim_sync(address, done);
+    if (done < length)
+    {
+        g_flash_stats.error_count++;
+        return false;
+    }
+#endif
+
+    g_flash_stats.program_count++;
+    g_flash_stats.program_bytes += length;
+    return true;
+}
+
+/**
+ * @brief 读取数据
+ */
+bool flash_read(uint32_t address, uint8_t *data, uint16_t length)
+{
+    if (!data || length == 0 || !flash_check_range(address, length))
+    {
+        g_flash_stats.error_count++;
+        return false;
+    }
+
+#if !FLASH_SIMULATOR
+    memcpy(data, (const void *)(FLASH_BASE_ADDR + address), length);
+#else
+    flash_sim_prepare();
+    memcpy(data, &g_flash_image[address], length);
+#endif
+
+    g_flash_stats.read_count++;
+    return true;
+}
+
+/**
+ * @brief 比较Flash内容与预期数据
+ */
+bool flash_verify(uint32_t address, const uint8_t *data, uint16_t length)
+{
+    uint8_t buffer[32];
+
+    if (!data || length == 0)
+    {
+        return false;
+    }
+
+    for (uint16_t offset = 0; offset < length; offset += (uint16_t)sizeof(buffer))
+    {
+        uint16_t chunk = (uint16_t)(length - offset) < sizeof(buffer) ? (uint16_t)(length - offset) : (uint16_t)sizeof(buffer);
+        if (!flash_read(address + offset, buffer, chunk) || memcmp(buffer, &data[offset], chunk) != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief 获取操作统计
+ */
+void flash_get_stats(flash_stats_t *stats)
+{
+    if (stats)
+    {
+        *stats = g_flash_stats;
+    }
+}
+
+/**
+ * @brief 清零操作统计
+ */
+void flash_reset_stats(void)
+{
+    memset(&g_flash_stats, 0, sizeof(g_flash_stats));
+}
+
+#if FLASH_SIMULATOR
+
+/**
+ * @brief 模拟器映射到镜像文件
+ */
+bool flash_sim_attach_file(const char *path)
+{
+    if (!path)
+    {
+        return false;
+    }
+
+    flash_sim_detach_file();
+    flash_sim_prepare();
+
+    g_flash_file = fopen(path, "r+b");
+    if (g_flash_file)
+    {
+        if (fread(g_flash_image, 1, FLASH_SIZE, g_flash_file) != FLASH_SIZE)
+        {
+            memset(g_flash_image, 0xFF, FLASH_SIZE);
+        }
+    }
+    else
+    {
+        g_flash_file = fopen(path, "w+b");
+        if (!g_flash_file)
+        {
+            return false;
+        }
+        memset(g_flash_image, 0xFF, FLASH_SIZE);
+    }
+
+    flash_sim_sync(0, FLASH_SIZE);
+    return true;
+}
+
+/**
+ * @brief 解除文件映射
+ */
+void flash_sim_detach_file(void)
+{
+    if (g_flash_file)
+    {
+        fclose(g_flash_file);
+        g_flash_file = NULL;
+    }
+}
+
+/**
+ * @brief 整片恢复为擦除状态
+ */
+void flash_sim_reset(void)
+{
+    memset(g_flash_image, 0xFF, sizeof(g_flash_image));
+    memset(g_flash_page_erases, 0, sizeof(g_flash_page_erases));
+    g_flash_sim_ready = true;
+    flash_sim_power_on();
+    flash_sim_sync(0, FLASH_SIZE);
+}
+
+/**
+ * @brief 注入掉电
+ */
+void flash_sim_set_power_cut(uint32_t budget)
+{
+    g_flash_cut_budget = budget;
+    g_flash_cut_armed = budget > 0;
+}
+
+/**
+ * @brief 恢复供电
+ */
+void flash_sim_power_on(void)
+{
+    g_flash_cut_budget = 0;
+    g_flash_cut_armed = false;
+    g_flash_powered_off = false;
+}
+
+/**
+ * @brief 获取某页累计擦除次数
+ */
+uint32_t flash_sim_get_page_erase_count(uint32_t address)
+{
+    if (address >= FLASH_SIZE)
+    {
+        return 0;
+    }
+    return g_flash_page_erases[address / FLASH_PAGE_SIZE];
+}
+
+#endif
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief 检查地址范围
+ */
+static bool flash_check_range(uint32_t address, uint32_t length)
+{
+    return address < FLASH_SIZE && length <= FLASH_SIZE - address;
+}
+
+#if !FLASH_SIMULATOR
+
+/**
+ * @brief 执行一条ISP命令 (阻塞至完成)
+ */
+static bool flash_isp_command(uint32_t command, uint32_t address, uint32_t data)
+{
+    FMC_ISPCMD = command;
+    FMC_ISPADR = FLASH_BASE_ADDR + address;
+    FMC_ISPDAT = data;
+
+    SYS_REGLCTL = 0x59;
+    SYS_REGLCTL = 0x16;
+    SYS_REGLCTL = 0x88;
+    FMC_ISPTRG = FMC_ISPTRG_ISPGO;
+    while (FMC_ISPTRG & FMC_ISPTRG_ISPGO)
+    {
+    }
+    SYS_REGLCTL = 0x00;
+
+    if (FMC_ISPCON & FMC_ISPCON_ISPFF)
+    {
+        FMC_ISPCON |= FMC_ISPCON_ISPFF;
+        return false;
+    }
+    return true;
+}
+
+#else
+
+/**
+ * @brief 首次使用时将镜像置为擦除状态
+ */
+static void flash_sim_prepare(void)
+{
+    if (!g_flash_sim_ready)
+    {
+        memset(g_flash_image, 0xFF, sizeof(g_flash_image));
+        g_flash_sim_ready = true;
+    }
+}
+
+/**
+ * @brief 消耗掉电预算
+ * @return 断电前可完成的字节数
+ */
+static uint32_t flash_sim_consume(uint32_t length)
+{
+    if (g_flash_powered_off)
+    {
+        return 0;
+    }
+    if (!g_flash_cut_armed)
+    {
+        return length;
+    }
+
+    if (length < g_flash_cut_budget)
+    {
+        g_flash_cut_budget -= length;
+        return length;
+    }
+
+    uint32_t done = g_flash_cut_budget;
+    g_flash_cut_budget = 0;
+    g_flash_cut_armed = false;
+    g_flash_powered_off = true;
+    return done;
+}
+
+/**
+ * @brief 镜像区间写透到映射文件
+ */
+static void flash_sim_sync(uint32_t address, uint32_t length)
+{
+    if (!g_flash_file || length == 0)
+    {
+        return;
+    }
+
+    fseek(g_flash_file, (long)address, SEEK_SET);
+    fwrite(&g_flash_image[address], 1, length, g_flash_file);
+    fflush(g_flash_file);
+}
+
+#endif
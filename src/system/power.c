@@ -9,6 +9,7 @@
  */
 
 #include "power.h"
+#include "storage.h"
 #include "gpio.h"
 #include "adc.h"
 #include "system.h"
@@ -180,6 +181,12 @@ int power_set_mode(power_mode_t mode)
     power_mode_t old_mode = g_power_status.current_mode;
     g_power_status.current_mode = mode;
 
+    // 待机/关机时RAM内容丢失，先写回存储缓存
+    if (mode == POWER_MODE_STANDBY || mode == POWER_MODE_SHUTDOWN)
+    {
+        storage_flush();
+    }
+
     // 模式切换优化
     power_optimize_for_mode(mode);
 
@@ -622,6 +629,7 @@ static void power_check_voltage_thresholds(void)
     {
         g_power_status.low_power_warning = true;
         low_voltage_warned = true;
+        storage_flush(); // 掉电风险: 写回缓存记录
         printf("功耗管理: 低电压告警 %u mV\n", g_power_status.voltage_mv);
     }
     else if (g_power_status.voltage_mv > POWER_VOLTAGE_LOW)
@@ -122,6 +122,8 @@ static const char *g4_error_strings[] = {
     "AT command error",
     "HTTP error",
     "Memory error",
+    "Not connected",
+    "Connection failed",
     "Unknown error"};
 
 //==============================================================================
@@ -648,6 +650,81 @@ g4_error_t g4_socket_send(uint8_t socket_id, const uint8_t *data, uint16_t data_
     return G4_SUCCESS;
 }
 
+/**
+ * @brief 接收Socket数据
+ * @note 通过AT+QIRD读取模组缓存的数据，无数据时received_len为0
+ */
+g4_error_t g4_socket_receive(uint8_t socket_id, uint8_t *buffer, uint16_t buffer_len, uint16_t *received_len)
+{
+    if (socket_id >= G4_MAX_SOCKETS || !buffer || buffer_len == 0 || !received_len)
+    {
+        return G4_ERROR_INVALID_PARAM;
+    }
+
+    *received_len = 0;
+    if (!g4_ctrl.sockets[socket_id].is_used || !g4_ctrl.sockets[socket_id].is_connected)
+    {
+        return G4_ERROR_NOT_CONNECTED;
+    }
+
+    // 单次读取长度受接收缓冲区限制 (留出响应头与结尾)
+    if (buffer_len > G4_RX_BUFFER_SIZE - 32)
+    {
+        buffer_len = G4_RX_BUFFER_SIZE - 32;
+    }
+
+    g4_ctrl.rx_index = 0;
+    memset(g4_ctrl.rx_buffer, 0, sizeof(g4_ctrl.rx_buffer));
+
+    snprintf(g4_ctrl.at_buffer, sizeof(g4_ctrl.at_buffer), "AT+QIRD=%d,%d\r\n", socket_id, buffer_len);
+    if (uart_send_string(g4_ctrl.config.uart_port, g4_ctrl.at_buffer) != UART_SUCCESS)
+    {
+        return G4_ERROR_AT_COMMAND;
+    }
+
+    g4_ctrl.at_commands_sent++;
+
+    // 响应: +QIRD: <长度>\r\n<数据>\r\nOK，数据可含任意字节，按长度截取
+    uint32_t start_time = timer_get_tick();
+    while (timer_get_tick() - start_time < G4_AT_TIMEOUT_MS)
+    {
+        g4_process_received_data();
+
+        const char *header = strstr(g4_ctrl.rx_buffer, "+QIRD: ");
+        const char *data = header ? strstr(header, "\r\n") : NULL;
+
+        if (!header && strstr(g4_ctrl.rx_buffer, "ERROR"))
+        {
+            g4_ctrl.network_errors++;
+            return G4_ERROR_AT_COMMAND;
+        }
+
+        if (data)
+        {
+            uint16_t length = (uint16_t)atoi(header + 7);
+            uint16_t offset = (uint16_t)(data + 2 - g4_ctrl.rx_buffer);
+
+            if (length > buffer_len)
+            {
+                return G4_ERROR_AT_COMMAND;
+            }
+
+            if (g4_ctrl.rx_index >= offset + length && strstr(g4_ctrl.rx_buffer + offset + length, "OK"))
+            {
+                memcpy(buffer, g4_ctrl.rx_buffer + offset, length);
+                *received_len = length;
+                g4_ctrl.at_responses_received++;
+                g4_ctrl.sockets[socket_id].last_activity = timer_get_tick();
+                return G4_SUCCESS;
+            }
+        }
+
+        timer_delay_ms(10);
+    }
+
+    return G4_ERROR_TIMEOUT;
+}
+
 /**
  * @brief 发送AT命令
  */
@@ -1,9 +1,29 @@
 #include "mqtt.h"
+#include "mqtt_codec.h"
+#include "telemetry_codec.h"
+#include "4g.h"
+#include "alarm_notify_adapter.h"
 #include "system.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
+//==============================================================================
+// 内部函数声明
+//==============================================================================
+
+static int mqtt_g4_open(const char *host, uint16_t port, void *context);
+static int mqtt_g4_send(const uint8_t *data, uint16_t length, void *context);
+static int mqtt_g4_receive(uint8_t *buffer, uint16_t size, void *context);
+static void mqtt_g4_close(void *context);
+
+static int mqtt_send_packet(const uint8_t *packet, uint16_t length);
+static void mqtt_receive(void);
+static void mqtt_handle_packet(const mqtt_codec_packet_t *packet);
+static void mqtt_close_connection(int error_code);
+static void mqtt_notify(mqtt_event_type_t type, void *data, uint16_t data_len, int error_code);
+static int32_t mqtt_scale_value(float value, float factor);
+
 //==============================================================================
 // 全局变量
 //==============================================================================
@@ -15,6 +35,25 @@ static mqtt_statistics_t g_mqtt_stats = {0};
 static mqtt_event_callback_t g_event_callback = NULL;
 static uint16_t g_message_id_counter = 1;
 
+// 传输层 (默认4G Socket)
+static const mqtt_transport_t g_mqtt_g4_transport = {mqtt_g4_open, mqtt_g4_send, mqtt_g4_receive, mqtt_g4_close, NULL};
+static mqtt_transport_t g_mqtt_transport = {mqtt_g4_open, mqtt_g4_send, mqtt_g4_receive, mqtt_g4_close, NULL};
+static bool g_mqtt_transport_open = false;
+static uint8_t g_mqtt_socket_id;
+
+// 发送缓冲区即Socket发送缓冲区: 报文直接编码于此，交给传输层发送
+static uint8_t g_mqtt_tx_buffer[MQTT_TX_BUFFER_SIZE];
+static uint8_t g_mqtt_rx_buffer[MQTT_RX_BUFFER_SIZE];
+static mqtt_parser_t g_mqtt_parser;
+
+static mqtt_publish_frame_t g_mqtt_publish_frame; // 进行中的零拷贝发布
+static bool g_mqtt_publish_pending = false;
+static uint16_t g_mqtt_publish_id;
+
+static uint32_t g_mqtt_connect_time; // CONNECT发出时刻
+static uint32_t g_mqtt_last_tx_time; // 最后发送时刻 (心跳基准)
+static bool g_mqtt_ping_pending = false;
+
 //==============================================================================
 // 核心API实现
 //==============================================================================
@@ -36,6 +75,10 @@ int mqtt_init(const mqtt_config_t *config)
 
     // 初始化状态
     g_mqtt_state = MQTT_STATE_DISCONNECTED;
+    g_mqtt_transport_open = false;
+    g_mqtt_publish_pending = false;
+    g_mqtt_ping_pending = false;
+    mqtt_parser_init(&g_mqtt_parser, g_mqtt_rx_buffer, sizeof(g_mqtt_rx_buffer));
     g_mqtt_initialized = true;
 
     // 重置统计信息
@@ -54,7 +97,7 @@ int mqtt_deinit(void)
     }
 
     // 断开连接
-    if (g_mqtt_state == MQTT_STATE_CONNECTED)
+    if (g_mqtt_state != MQTT_STATE_DISCONNECTED)
     {
         mqtt_disconnect();
     }
@@ -76,6 +119,28 @@ int mqtt_set_event_callback(mqtt_event_callback_t callback)
     return MQTT_SUCCESS;
 }
 
+int mqtt_set_transport(const mqtt_transport_t *transport)
+{
+    if (g_mqtt_transport_open)
+    {
+        return MQTT_ERROR_INVALID_PARAM;
+    }
+
+    if (!transport)
+    {
+        g_mqtt_transport = g_mqtt_g4_transport;
+        return MQTT_SUCCESS;
+    }
+
+    if (!transport->open || !transport->send || !transport->receive || !transport->close)
+    {
+        return MQTT_ERROR_INVALID_PARAM;
+    }
+
+    g_mqtt_transport = *transport;
+    return MQTT_SUCCESS;
+}
+
 //==============================================================================
 // 连接管理
 //==============================================================================
@@ -87,30 +152,37 @@ int mqtt_connect(void)
         return MQTT_ERROR_INVALID_PARAM;
     }
 
-    if (g_mqtt_state == MQTT_STATE_CONNECTED)
+    if (g_mqtt_state == MQTT_STATE_CONNECTED || g_mqtt_state == MQTT_STATE_CONNECTING)
     {
-        return MQTT_SUCCESS; // 已经连接
+        return MQTT_SUCCESS; // 已经连接或正在连接
     }
 
-    g_mqtt_state = MQTT_STATE_CONNECTING;
+    uint16_t length = mqtt_codec_connect(g_mqtt_tx_buffer, sizeof(g_mqtt_tx_buffer), &g_mqtt_config);
+    if (length == 0)
+    {
+        return MQTT_ERROR_INVALID_PARAM;
+    }
 
-    // 模拟连接过程
     printf("MQTT: 连接到服务器 %s:%d\n",
            g_mqtt_config.broker_host, g_mqtt_config.broker_port);
 
-    // 简化实现：直接设置为已连接
-    g_mqtt_state = MQTT_STATE_CONNECTED;
-    g_mqtt_stats.last_ping_time = system_get_tick();
+    if (g_mqtt_transport.open(g_mqtt_config.broker_host, g_mqtt_config.broker_port,
+                              g_mqtt_transport.context) != MQTT_SUCCESS)
+    {
+        g_mqtt_stats.error_count++;
+        g_mqtt_state = MQTT_STATE_ERROR;
+        return MQTT_ERROR_NETWORK;
+    }
 
-    // 触发连接事件
-    if (g_event_callback)
+    g_mqtt_transport_open = true;
+    g_mqtt_state = MQTT_STATE_CONNECTING;
+    g_mqtt_connect_time = system_get_tick();
+    mqtt_parser_init(&g_mqtt_parser, g_mqtt_rx_buffer, sizeof(g_mqtt_rx_buffer));
+
+    if (mqtt_send_packet(g_mqtt_tx_buffer, length) != MQTT_SUCCESS)
     {
-        mqtt_event_t event = {
-            .event = MQTT_EVENT_CONNECTED,
-            .data = NULL,
-            .data_len = 0,
-            .error_code = 0};
-        g_event_callback(&event);
+        mqtt_close_connection(MQTT_ERROR_SEND);
+        return MQTT_ERROR_SEND;
     }
 
     return MQTT_SUCCESS;
@@ -128,23 +200,18 @@ int mqtt_disconnect(void)
         return MQTT_SUCCESS; // 已经断开
     }
 
+    bool connected = (g_mqtt_state == MQTT_STATE_CONNECTED);
     g_mqtt_state = MQTT_STATE_DISCONNECTING;
 
     printf("MQTT: 断开连接\n");
 
-    g_mqtt_state = MQTT_STATE_DISCONNECTED;
-
-    // 触发断开事件
-    if (g_event_callback)
+    if (connected)
     {
-        mqtt_event_t event = {
-            .event = MQTT_EVENT_DISCONNECTED,
-            .data = NULL,
-            .data_len = 0,
-            .error_code = 0};
-        g_event_callback(&event);
+        uint16_t length = mqtt_codec_empty(g_mqtt_tx_buffer, sizeof(g_mqtt_tx_buffer), MQTT_DISCONNECT);
+        mqtt_send_packet(g_mqtt_tx_buffer, length);
     }
 
+    mqtt_close_connection(MQTT_SUCCESS);
     return MQTT_SUCCESS;
 }
 
@@ -165,7 +232,7 @@ bool mqtt_is_connected(void)
 int mqtt_publish(const char *topic, const void *payload, uint16_t len,
                  uint8_t qos, bool retain)
 {
-    if (!g_mqtt_initialized || !topic || !payload)
+    if (!g_mqtt_initialized || !topic || !payload || qos > MQTT_QOS_1)
     {
         return MQTT_ERROR_INVALID_PARAM;
     }
@@ -175,10 +242,112 @@ int mqtt_publish(const char *topic, const void *payload, uint16_t len,
         return MQTT_ERROR_NOT_CONNECTED;
     }
 
-    printf("MQTT: 发布消息到主题 '%s'，长度 %d\n", topic, len);
+    uint16_t capacity;
+    uint8_t *dest = mqtt_publish_begin(topic, qos, retain, &capacity);
+    if (!dest)
+    {
+        return MQTT_ERROR_INVALID_PARAM;
+    }
+    if (len > capacity)
+    {
+        g_mqtt_publish_pending = false;
+        return MQTT_ERROR_NO_MEMORY;
+    }
+
+    // 唯一一次拷贝: 调用方载荷直接进入发送缓冲区
+    memcpy(dest, payload, len);
+
+    int result = mqtt_publish_commit(len);
+    return (result < 0) ? result : MQTT_SUCCESS;
+}
+
+uint8_t *mqtt_publish_begin(const char *topic, uint8_t qos, bool retain, uint16_t *capacity)
+{
+    if (!g_mqtt_initialized || !topic || qos > MQTT_QOS_1 || g_mqtt_state != MQTT_STATE_CONNECTED)
+    {
+        return NULL;
+    }
+
+    uint16_t packet_id = (qos > MQTT_QOS_0) ? mqtt_get_next_message_id() : 0;
+    if (!mqtt_codec_publish_begin(&g_mqtt_publish_frame, g_mqtt_tx_buffer, sizeof(g_mqtt_tx_buffer), topic, qos,
+                                  retain, packet_id))
+    {
+        return NULL;
+    }
+
+    g_mqtt_publish_pending = true;
+    g_mqtt_publish_id = packet_id;
+    if (capacity)
+    {
+        *capacity = g_mqtt_publish_frame.capacity;
+    }
+    return g_mqtt_publish_frame.payload;
+}
+
+int mqtt_publish_commit(uint16_t len)
+{
+    if (!g_mqtt_publish_pending)
+    {
+        return MQTT_ERROR_INVALID_PARAM;
+    }
+    g_mqtt_publish_pending = false;
+
+    if (g_mqtt_state != MQTT_STATE_CONNECTED)
+    {
+        return MQTT_ERROR_NOT_CONNECTED;
+    }
+
+    uint8_t *packet;
+    uint16_t length = mqtt_codec_publish_end(&g_mqtt_publish_frame, len, &packet);
+    if (length == 0)
+    {
+        return MQTT_ERROR_NO_MEMORY;
+    }
+
+    if (mqtt_send_packet(packet, length) != MQTT_SUCCESS)
+    {
+        return MQTT_ERROR_SEND;
+    }
+
+    g_mqtt_stats.tx_count++;
+    g_mqtt_stats.last_message_time = system_get_tick();
+
+    return g_mqtt_publish_id;
+}
+
+int mqtt_publish_retry(const char *topic, const void *payload, uint16_t len, uint16_t packet_id)
+{
+    if (!g_mqtt_initialized || !topic || !payload || packet_id == 0)
+    {
+        return MQTT_ERROR_INVALID_PARAM;
+    }
+
+    if (g_mqtt_state != MQTT_STATE_CONNECTED)
+    {
+        return MQTT_ERROR_NOT_CONNECTED;
+    }
+
+    if (!mqtt_codec_publish_begin(&g_mqtt_publish_frame, g_mqtt_tx_buffer, sizeof(g_mqtt_tx_buffer), topic,
+                                  MQTT_QOS_1, false, packet_id))
+    {
+        return MQTT_ERROR_INVALID_PARAM;
+    }
+    if (len > g_mqtt_publish_frame.capacity)
+    {
+        return MQTT_ERROR_NO_MEMORY;
+    }
+
+    g_mqtt_publish_frame.first_byte |= MQTT_CODEC_FLAG_DUP;
+    memcpy(g_mqtt_publish_frame.payload, payload, len);
+
+    uint8_t *packet;
+    uint16_t length = mqtt_codec_publish_end(&g_mqtt_publish_frame, len, &packet);
+    if (length == 0 || mqtt_send_packet(packet, length) != MQTT_SUCCESS)
+    {
+        return MQTT_ERROR_SEND;
+    }
 
     g_mqtt_stats.tx_count++;
-    g_mqtt_stats.bytes_sent += len;
     g_mqtt_stats.last_message_time = system_get_tick();
 
     return MQTT_SUCCESS;
@@ -200,7 +369,7 @@ int mqtt_publish_json(const char *topic, const char *json_str, uint8_t qos)
 
 int mqtt_subscribe(const char *topic, uint8_t qos)
 {
-    if (!g_mqtt_initialized || !topic)
+    if (!g_mqtt_initialized || !topic || qos > MQTT_QOS_1)
     {
         return MQTT_ERROR_INVALID_PARAM;
     }
@@ -210,8 +379,15 @@ int mqtt_subscribe(const char *topic, uint8_t qos)
         return MQTT_ERROR_NOT_CONNECTED;
     }
 
+    uint16_t length = mqtt_codec_subscribe(g_mqtt_tx_buffer, sizeof(g_mqtt_tx_buffer),
+                                           mqtt_get_next_message_id(), topic, qos);
+    if (length == 0)
+    {
+        return MQTT_ERROR_INVALID_PARAM;
+    }
+
     printf("MQTT: 订阅主题 '%s'，QoS %d\n", topic, qos);
-    return MQTT_SUCCESS;
+    return (mqtt_send_packet(g_mqtt_tx_buffer, length) == MQTT_SUCCESS) ? MQTT_SUCCESS : MQTT_ERROR_SEND;
 }
 
 int mqtt_unsubscribe(const char *topic)
@@ -226,8 +402,15 @@ int mqtt_unsubscribe(const char *topic)
         return MQTT_ERROR_NOT_CONNECTED;
     }
 
+    uint16_t length = mqtt_codec_unsubscribe(g_mqtt_tx_buffer, sizeof(g_mqtt_tx_buffer),
+                                             mqtt_get_next_message_id(), topic);
+    if (length == 0)
+    {
+        return MQTT_ERROR_INVALID_PARAM;
+    }
+
     printf("MQTT: 取消订阅主题 '%s'\n", topic);
-    return MQTT_SUCCESS;
+    return (mqtt_send_packet(g_mqtt_tx_buffer, length) == MQTT_SUCCESS) ? MQTT_SUCCESS : MQTT_ERROR_SEND;
 }
 
 //==============================================================================
@@ -236,40 +419,45 @@ int mqtt_unsubscribe(const char *topic)
 
 void mqtt_task(void)
 {
-    if (!g_mqtt_initialized)
+    if (!g_mqtt_initialized || !g_mqtt_transport_open)
+    {
+        return;
+    }
+
+    mqtt_receive();
+    if (!g_mqtt_transport_open)
     {
         return;
     }
 
     uint32_t current_time = system_get_tick();
 
-    // 心跳检查
-    if (g_mqtt_state == MQTT_STATE_CONNECTED)
+    // 连接超时
+    if (g_mqtt_state == MQTT_STATE_CONNECTING)
     {
-        if (current_time - g_mqtt_stats.last_ping_time > (g_mqtt_config.keep_alive * 1000))
+        if (g_mqtt_config.connect_timeout > 0 && current_time - g_mqtt_connect_time >= g_mqtt_config.connect_timeout)
         {
-            mqtt_ping();
+            mqtt_close_connection(MQTT_ERROR_TIMEOUT);
         }
+        return;
     }
 
-    // 模拟接收消息
-    static uint32_t last_rx_time = 0;
-    if (g_mqtt_state == MQTT_STATE_CONNECTED &&
-        current_time - last_rx_time > 60000) // 每分钟模拟接收一次
+    // 心跳: 空闲满一个心跳间隔发送PINGREQ，再过一个间隔仍无PINGRESP则认为连接已断
+    if (g_mqtt_state == MQTT_STATE_CONNECTED && g_mqtt_config.keep_alive > 0)
     {
-        if (g_event_callback)
+        uint32_t interval = (uint32_t)g_mqtt_config.keep_alive * 1000;
+
+        if (g_mqtt_ping_pending)
         {
-            mqtt_event_t event = {
-                .event = MQTT_EVENT_MESSAGE_RECEIVED,
-                .data = (void *)"test message",
-                .data_len = 12,
-                .error_code = 0};
-            g_event_callback(&event);
+            if (current_time - g_mqtt_stats.last_ping_time >= interval)
+            {
+                mqtt_close_connection(MQTT_ERROR_TIMEOUT);
+            }
+        }
+        else if (current_time - g_mqtt_last_tx_time >= interval)
+        {
+            mqtt_ping();
         }
-
-        g_mqtt_stats.rx_count++;
-        g_mqtt_stats.bytes_received += 12;
-        last_rx_time = current_time;
     }
 }
 
@@ -289,13 +477,24 @@ int mqtt_ping(void)
         return MQTT_ERROR_NOT_CONNECTED;
     }
 
-    printf("MQTT: 发送心跳\n");
+    uint16_t length = mqtt_codec_empty(g_mqtt_tx_buffer, sizeof(g_mqtt_tx_buffer), MQTT_PINGREQ);
+    if (mqtt_send_packet(g_mqtt_tx_buffer, length) != MQTT_SUCCESS)
+    {
+        return MQTT_ERROR_SEND;
+    }
+
+    g_mqtt_ping_pending = true;
     g_mqtt_stats.last_ping_time = system_get_tick();
     return MQTT_SUCCESS;
 }
 
 uint16_t mqtt_get_next_message_id(void)
 {
+    // 报文ID不能为0
+    if (g_message_id_counter == 0)
+    {
+        g_message_id_counter = 1;
+    }
     return g_message_id_counter++;
 }
 
@@ -310,6 +509,279 @@ int mqtt_get_statistics(mqtt_statistics_t *stats)
     return MQTT_SUCCESS;
 }
 
+//==============================================================================
+// 内部函数实现
+//==============================================================================
+
+/**
+ * @brief 发送一个已编码的报文
+ */
+static int mqtt_send_packet(const uint8_t *packet, uint16_t length)
+{
+    if (!g_mqtt_transport_open || length == 0)
+    {
+        return MQTT_ERROR_NOT_CONNECTED;
+    }
+
+    if (g_mqtt_transport.send(packet, length, g_mqtt_transport.context) != MQTT_SUCCESS)
+    {
+        g_mqtt_stats.error_count++;
+        return MQTT_ERROR_SEND;
+    }
+
+    g_mqtt_stats.bytes_sent += length;
+    g_mqtt_last_tx_time = system_get_tick();
+    return MQTT_SUCCESS;
+}
+
+/**
+ * @brief 读取传输层数据并逐个处理收齐的报文
+ */
+static void mqtt_receive(void)
+{
+    uint8_t chunk[MQTT_RX_CHUNK];
+
+    for (;;)
+    {
+        int received = g_mqtt_transport.receive(chunk, sizeof(chunk), g_mqtt_transport.context);
+        if (received < 0)
+        {
+            mqtt_close_connection(MQTT_ERROR_RECEIVE);
+            return;
+        }
+        if (received == 0)
+        {
+            return;
+        }
+
+        g_mqtt_stats.bytes_received += (uint32_t)received;
+
+        uint16_t offset = 0;
+        while (offset < (uint16_t)received)
+        {
+            mqtt_codec_packet_t packet;
+            uint16_t consumed;
+            int result = mqtt_parser_feed(&g_mqtt_parser, chunk + offset, (uint16_t)(received - offset), &consumed,
+                                          &packet);
+
+            offset = (uint16_t)(offset + consumed);
+            if (result == MQTT_CODEC_PACKET)
+            {
+                mqtt_handle_packet(&packet);
+            }
+            else if (result < 0)
+            {
+                mqtt_close_connection(MQTT_ERROR_PROTOCOL);
+            }
+
+            if (!g_mqtt_transport_open)
+            {
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 处理服务器报文
+ */
+static void mqtt_handle_packet(const mqtt_codec_packet_t *packet)
+{
+    // CONNACK之前不接受其他报文
+    if (g_mqtt_state == MQTT_STATE_CONNECTING && packet->type != MQTT_CONNACK)
+    {
+        mqtt_close_connection(MQTT_ERROR_PROTOCOL);
+        return;
+    }
+
+    switch (packet->type)
+    {
+    case MQTT_CONNACK:
+        if (g_mqtt_state != MQTT_STATE_CONNECTING)
+        {
+            mqtt_close_connection(MQTT_ERROR_PROTOCOL);
+        }
+        else if (packet->return_code != 0)
+        {
+            printf("MQTT: 服务器拒绝连接，返回码 %d\n", packet->return_code);
+            mqtt_notify(MQTT_EVENT_ERROR, NULL, 0, MQTT_ERROR_REJECTED);
+            mqtt_close_connection(MQTT_ERROR_REJECTED);
+        }
+        else
+        {
+            char alarm_topic[MQTT_MAX_TOPIC_LEN];
+
+            g_mqtt_state = MQTT_STATE_CONNECTED;
+            g_mqtt_ping_pending = false;
+            g_mqtt_stats.last_ping_time = system_get_tick();
+
+            // 报警通知经本连接上行 (重连时重复注册只更新参数)
+            snprintf(alarm_topic, sizeof(alarm_topic), MQTT_ALARM_TOPIC_FORMAT, g_mqtt_config.client_id);
+            alarm_notify_attach_mqtt(alarm_topic);
+            mqtt_notify(MQTT_EVENT_CONNECTED, NULL, 0, 0);
+        }
+        break;
+
+    case MQTT_PUBLISH:
+    {
+        mqtt_message_t message;
+        uint8_t qos = (uint8_t)((packet->flags >> 1) & 0x03);
+        uint16_t topic_len = packet->topic_len;
+
+        // 只订阅到QoS1，服务器不应下发QoS2
+        if (qos > MQTT_QOS_1)
+        {
+            mqtt_close_connection(MQTT_ERROR_PROTOCOL);
+            break;
+        }
+        if (qos == MQTT_QOS_1)
+        {
+            uint16_t length = mqtt_codec_ack(g_mqtt_tx_buffer, sizeof(g_mqtt_tx_buffer), MQTT_PUBACK,
+                                             packet->packet_id);
+            mqtt_send_packet(g_mqtt_tx_buffer, length);
+        }
+
+        if (topic_len >= sizeof(message.topic))
+        {
+            topic_len = sizeof(message.topic) - 1;
+        }
+        memcpy(message.topic, packet->topic, topic_len);
+        message.topic[topic_len] = '\0';
+        message.payload = (uint8_t *)packet->payload;
+        message.payload_len = packet->payload_len;
+        message.qos = qos;
+        message.retain = (packet->flags & MQTT_CODEC_FLAG_RETAIN) != 0;
+        message.dup = (packet->flags & MQTT_CODEC_FLAG_DUP) != 0;
+        message.message_id = packet->packet_id;
+        message.timestamp = system_get_tick();
+
+        g_mqtt_stats.rx_count++;
+        g_mqtt_stats.last_message_time = message.timestamp;
+        mqtt_notify(MQTT_EVENT_MESSAGE_RECEIVED, &message, message.payload_len, 0);
+        break;
+    }
+
+    case MQTT_PUBACK:
+    {
+        uint16_t packet_id = packet->packet_id;
+        mqtt_notify(MQTT_EVENT_MESSAGE_SENT, &packet_id, sizeof(packet_id), 0);
+        break;
+    }
+
+    case MQTT_SUBACK:
+    {
+        uint16_t packet_id = packet->packet_id;
+        if (packet->return_code == MQTT_CODEC_SUBACK_FAILURE)
+        {
+            mqtt_notify(MQTT_EVENT_ERROR, &packet_id, sizeof(packet_id), MQTT_ERROR_REJECTED);
+        }
+        else
+        {
+            mqtt_notify(MQTT_EVENT_SUBSCRIBE_SUCCESS, &packet_id, sizeof(packet_id), 0);
+        }
+        break;
+    }
+
+    case MQTT_UNSUBACK:
+    {
+        uint16_t packet_id = packet->packet_id;
+        mqtt_notify(MQTT_EVENT_UNSUBSCRIBE_SUCCESS, &packet_id, sizeof(packet_id), 0);
+        break;
+    }
+
+    case MQTT_PINGRESP:
+        g_mqtt_ping_pending = false;
+        break;
+
+    default:
+        // 客户端方向的报文或未支持的QoS2流程
+        mqtt_close_connection(MQTT_ERROR_PROTOCOL);
+        break;
+    }
+}
+
+/**
+ * @brief 关闭传输层并进入未连接状态
+ * @param error_code 断开原因 (0:主动断开)
+ */
+static void mqtt_close_connection(int error_code)
+{
+    if (g_mqtt_transport_open)
+    {
+        g_mqtt_transport.close(g_mqtt_transport.context);
+        g_mqtt_transport_open = false;
+    }
+
+    g_mqtt_state = MQTT_STATE_DISCONNECTED;
+    g_mqtt_ping_pending = false;
+    g_mqtt_publish_pending = false;
+    if (error_code != MQTT_SUCCESS)
+    {
+        g_mqtt_stats.error_count++;
+    }
+
+    mqtt_notify(MQTT_EVENT_DISCONNECTED, NULL, 0, error_code);
+}
+
+/**
+ * @brief 触发事件回调
+ */
+static void mqtt_notify(mqtt_event_type_t type, void *data, uint16_t data_len, int error_code)
+{
+    if (g_event_callback)
+    {
+        mqtt_event_t event = {
+            .event = type,
+            .data = data,
+            .data_len = data_len,
+            .error_code = error_code};
+        g_event_callback(&event);
+    }
+}
+
+//==============================================================================
+// 4G Socket传输层
+//==============================================================================
+
+static int mqtt_g4_open(const char *host, uint16_t port, void *context)
+{
+    g4_socket_config_t config;
+
+    (void)context;
+    memset(&config, 0, sizeof(config));
+    strncpy(config.remote_host, host, sizeof(config.remote_host) - 1);
+    config.remote_port = port;
+    config.is_tcp = true;
+    config.timeout_ms = G4_CONNECT_TIMEOUT_MS;
+    config.keep_alive = true;
+
+    return (g4_socket_create(&config, &g_mqtt_socket_id) == G4_SUCCESS) ? MQTT_SUCCESS : MQTT_ERROR_NETWORK;
+}
+
+static int mqtt_g4_send(const uint8_t *data, uint16_t length, void *context)
+{
+    (void)context;
+    return (g4_socket_send(g_mqtt_socket_id, data, length) == G4_SUCCESS) ? MQTT_SUCCESS : MQTT_ERROR_SEND;
+}
+
+static int mqtt_g4_receive(uint8_t *buffer, uint16_t size, void *context)
+{
+    uint16_t received = 0;
+
+    (void)context;
+    if (g4_socket_receive(g_mqtt_socket_id, buffer, size, &received) != G4_SUCCESS)
+    {
+        return MQTT_ERROR_RECEIVE;
+    }
+    return received;
+}
+
+static void mqtt_g4_close(void *context)
+{
+    (void)context;
+    g4_socket_close(g_mqtt_socket_id);
+}
+
 //==============================================================================
 // JSON编码函数
 //==============================================================================
@@ -366,6 +838,72 @@ int mqtt_encode_device_status(char *buffer, uint16_t size, const device_status_t
     return (len > 0 && len < (int)size) ? len : MQTT_ERROR_NO_MEMORY;
 }
 
+/**
+ * @brief 物理量按10^decimals放大并四舍五入为整数 (饱和)
+ */
+static int32_t mqtt_scale_value(float value, float factor)
+{
+    float scaled = value * factor;
+
+    if (scaled >= 2147483520.0f)
+    {
+        return INT32_MAX;
+    }
+    if (scaled <= -2147483520.0f)
+    {
+        return INT32_MIN;
+    }
+    return (int32_t)(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+int mqtt_encode_sensor_payload(uint8_t *buffer, uint16_t size, const mqtt_sensor_data_t *data)
+{
+    if (g_mqtt_config.payload_format != MQTT_PAYLOAD_PACKED)
+    {
+        return mqtt_encode_sensor_data((char *)buffer, size, data);
+    }
+
+    if (!buffer || size == 0 || !data)
+    {
+        return MQTT_ERROR_INVALID_PARAM;
+    }
+
+    telemetry_sensor_t sample;
+    sample.temperature = mqtt_scale_value(data->temperature, 10.0f);
+    sample.humidity = mqtt_scale_value(data->humidity, 10.0f);
+    sample.voltage = mqtt_scale_value(data->voltage, 100.0f);
+    sample.current = mqtt_scale_value(data->current, 100.0f);
+    sample.power = mqtt_scale_value(data->power, 100.0f);
+    sample.timestamp = system_get_tick();
+
+    uint16_t length = telemetry_encode_sensor(buffer, size, &sample);
+    return (length > 0) ? length : MQTT_ERROR_NO_MEMORY;
+}
+
+int mqtt_encode_status_payload(uint8_t *buffer, uint16_t size, const device_status_t *status)
+{
+    if (g_mqtt_config.payload_format != MQTT_PAYLOAD_PACKED)
+    {
+        return mqtt_encode_device_status((char *)buffer, size, status);
+    }
+
+    if (!buffer || size == 0 || !status)
+    {
+        return MQTT_ERROR_INVALID_PARAM;
+    }
+
+    telemetry_status_t packed;
+    packed.flags = (uint8_t)((status->modbus_online ? TELEMETRY_FLAG_MODBUS_ONLINE : 0) |
+                             (status->lora_connected ? TELEMETRY_FLAG_LORA_CONNECTED : 0) |
+                             (status->storage_normal ? TELEMETRY_FLAG_STORAGE_NORMAL : 0) |
+                             (status->alarm_active ? TELEMETRY_FLAG_ALARM_ACTIVE : 0));
+    packed.uptime = status->uptime;
+    packed.free_memory = status->free_memory;
+
+    uint16_t length = telemetry_encode_status(buffer, size, &packed);
+    return (length > 0) ? length : MQTT_ERROR_NO_MEMORY;
+}
+
 //==============================================================================
 // 状态名称函数
 //==============================================================================
@@ -0,0 +1,518 @@
+/**
+ * @file mqtt_codec.c
+ * @brief 憨云DTU MQTT 3.1.1报文编解码实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include "mqtt_codec.h"
+#include <string.h>
+
+// ============================================================================
+// 内部定义
+// ============================================================================
+
+// 解析状态
+#define MQTT_PARSE_HEADER 0 // 等待固定头首字节
+#define MQTT_PARSE_LENGTH 1 // 读取剩余长度
+#define MQTT_PARSE_BODY 2   // 收集报文体
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static uint16_t mqtt_codec_strlen(const char *s, uint16_t max);
+static uint8_t mqtt_codec_length_size(uint32_t remaining);
+static uint8_t *mqtt_codec_put_header(uint8_t *p, uint8_t first_byte, uint32_t remaining);
+static uint8_t *mqtt_codec_put_u16(uint8_t *p, uint16_t value);
+static uint8_t *mqtt_codec_put_string(uint8_t *p, const char *s, uint16_t length);
+static uint16_t mqtt_codec_get_u16(const uint8_t *p);
+static int mqtt_codec_decode(const mqtt_parser_t *parser, mqtt_codec_packet_t *packet);
+
+// ============================================================================
+// 编码
+// ============================================================================
+
+/**
+ * @brief 编码CONNECT
+ */
+uint16_t mqtt_codec_connect(uint8_t *buffer, uint16_t size, const mqtt_config_t *config)
+{
+    if (!buffer || !config)
+    {
+        return 0;
+    }
+
+    uint16_t id_len = mqtt_codec_strlen(config->client_id, sizeof(config->client_id));
+    uint16_t user_len = mqtt_codec_strlen(config->username, sizeof(config->username));
+    uint16_t pass_len = mqtt_codec_strlen(config->password, sizeof(config->password));
+    uint8_t flags = config->clean_session ? MQTT_CONNECT_FLAG_CLEAN_SESSION : 0;
+
+    // 空客户端ID只允许用于清除会话
+    if (id_len == 0 && !config->clean_session)
+    {
+        return 0;
+    }
+
+    // 可变头: 协议名 + 协议级别 + 连接标志 + 心跳间隔
+    uint32_t remaining = 10 + 2 + id_len;
+    if (user_len > 0)
+    {
+        flags |= MQTT_CONNECT_FLAG_USERNAME;
+        remaining += 2 + user_len;
+
+        // 3.1.1: 无用户名时不得携带密码
+        if (pass_len > 0)
+        {
+            flags |= MQTT_CONNECT_FLAG_PASSWORD;
+            remaining += 2 + pass_len;
+        }
+    }
+
+    uint32_t total = 1 + mqtt_codec_length_size(remaining) + remaining;
+    if (total > size)
+    {
+        return 0;
+    }
+
+    uint8_t *p = mqtt_codec_put_header(buffer, (uint8_t)(MQTT_CONNECT << 4), remaining);
+    p = mqtt_codec_put_string(p, "MQTT", 4);
+    *p++ = MQTT_VERSION_3_1_1;
+    *p++ = flags;
+    p = mqtt_codec_put_u16(p, config->keep_alive);
+    p = mqtt_codec_put_string(p, config->client_id, id_len);
+    if (flags & MQTT_CONNECT_FLAG_USERNAME)
+    {
+        p = mqtt_codec_put_string(p, config->username, user_len);
+    }
+    if (flags & MQTT_CONNECT_FLAG_PASSWORD)
+    {
+        p = mqtt_codec_put_string(p, config->password, pass_len);
+    }
+
+    return (uint16_t)total;
+}
+
+/**
+ * @brief 开始编码PUBLISH
+ */
+bool mqtt_codec_publish_begin(mqtt_publish_frame_t *frame, uint8_t *buffer, uint16_t size, const char *topic,
+                              uint8_t qos, bool retain, uint16_t packet_id)
+{
+    if (!frame || !buffer || !topic || qos > MQTT_QOS_1 || (qos > MQTT_QOS_0 && packet_id == 0))
+    {
+        return false;
+    }
+
+    uint16_t topic_len = mqtt_codec_strlen(topic, MQTT_MAX_TOPIC_LEN);
+    if (topic_len == 0 || topic[topic_len] != '\0')
+    {
+        return false;
+    }
+
+    uint16_t header_len = (uint16_t)(2 + topic_len + (qos > MQTT_QOS_0 ? 2 : 0));
+    if ((uint32_t)MQTT_CODEC_PUBLISH_RESERVE + header_len > size)
+    {
+        return false;
+    }
+
+    // 主题与报文ID写在预留的固定头之后，载荷紧随其后
+    uint8_t *p = mqtt_codec_put_string(buffer + MQTT_CODEC_PUBLISH_RESERVE, topic, topic_len);
+    if (qos > MQTT_QOS_0)
+    {
+        p = mqtt_codec_put_u16(p, packet_id);
+    }
+
+    frame->buffer = buffer;
+    frame->payload = p;
+    frame->capacity = (uint16_t)(size - MQTT_CODEC_PUBLISH_RESERVE - header_len);
+    frame->header_len = header_len;
+    frame->first_byte = (uint8_t)((MQTT_PUBLISH << 4) | (qos << 1) | (retain ? MQTT_CODEC_FLAG_RETAIN : 0));
+    return true;
+}
+
+/**
+ * @brief 完成PUBLISH编码
+ */
+uint16_t mqtt_codec_publish_end(mqtt_publish_frame_t *frame, uint16_t payload_len, uint8_t **packet)
+{
+    if (!frame || !packet || payload_len > frame->capacity)
+    {
+        return 0;
+    }
+
+    // 固定头右对齐到可变头之前 (剩余长度不超过65535，至多3字节)
+    uint32_t remaining = (uint32_t)frame->header_len + payload_len;
+    uint8_t header_size = (uint8_t)(1 + mqtt_codec_length_size(remaining));
+    uint8_t *start = frame->buffer + MQTT_CODEC_PUBLISH_RESERVE - header_size;
+
+    mqtt_codec_put_header(start, frame->first_byte, remaining);
+    *packet = start;
+    return (uint16_t)(header_size + remaining);
+}
+
+/**
+ * @brief 编码SUBSCRIBE
+ */
+uint16_t mqtt_codec_subscribe(uint8_t *buffer, uint16_t size, uint16_t packet_id, const char *topic, uint8_t qos)
+{
+    if (!buffer || !topic || packet_id == 0 || qos > MQTT_QOS_2)
+    {
+        return 0;
+    }
+
+    uint16_t topic_len = mqtt_codec_strlen(topic, MQTT_MAX_TOPIC_LEN);
+    uint32_t remaining = 2 + 2 + topic_len + 1;
+    uint32_t total = 1 + mqtt_codec_length_size(remaining) + remaining;
+    if (topic_len == 0 || topic[topic_len] != '\0' || total > size)
+    {
+        return 0;
+    }
+
+    uint8_t *p = mqtt_codec_put_header(buffer, (uint8_t)((MQTT_SUBSCRIBE << 4) | 0x02), remaining);
+    p = mqtt_codec_put_u16(p, packet_id);
+    p = mqtt_codec_put_string(p, topic, topic_len);
+    *p = qos;
+
+    return (uint16_t)total;
+}
+
+/**
+ * @brief 编码UNSUBSCRIBE
+ */
+uint16_t mqtt_codec_unsubscribe(uint8_t *buffer, uint16_t size, uint16_t packet_id, const char *topic)
+{
+    if (!buffer || !topic || packet_id == 0)
+    {
+        return 0;
+    }
+
+    uint16_t topic_len = mqtt_codec_strlen(topic, MQTT_MAX_TOPIC_LEN);
+    uint32_t remaining = 2 + 2 + topic_len;
+    uint32_t total = 1 + mqtt_codec_length_size(remaining) + remaining;
+    if (topic_len == 0 || topic[topic_len] != '\0' || total > size)
+    {
+        return 0;
+    }
+
+    uint8_t *p = mqtt_codec_put_header(buffer, (uint8_t)((MQTT_UNSUBSCRIBE << 4) | 0x02), remaining);
+    p = mqtt_codec_put_u16(p, packet_id);
+    mqtt_codec_put_string(p, topic, topic_len);
+
+    return (uint16_t)total;
+}
+
+/**
+ * @brief 编码只含报文ID的报文
+ */
+uint16_t mqtt_codec_ack(uint8_t *buffer, uint16_t size, uint8_t type, uint16_t packet_id)
+{
+    if (!buffer || size < 4)
+    {
+        return 0;
+    }
+
+    buffer[0] = (uint8_t)((type << 4) | (type == MQTT_PUBREL ? 0x02 : 0));
+    buffer[1] = 2;
+    mqtt_codec_put_u16(buffer + 2, packet_id);
+    return 4;
+}
+
+/**
+ * @brief 编码无报文体的报文
+ */
+uint16_t mqtt_codec_empty(uint8_t *buffer, uint16_t size, uint8_t type)
+{
+    if (!buffer || size < 2)
+    {
+        return 0;
+    }
+
+    buffer[0] = (uint8_t)(type << 4);
+    buffer[1] = 0;
+    return 2;
+}
+
+// ============================================================================
+// 解析
+// ============================================================================
+
+/**
+ * @brief 初始化解析器
+ */
+void mqtt_parser_init(mqtt_parser_t *parser, uint8_t *buffer, uint16_t size)
+{
+    if (!parser)
+    {
+        return;
+    }
+
+    memset(parser, 0, sizeof(*parser));
+    parser->buffer = buffer;
+    parser->size = buffer ? size : 0;
+    parser->state = MQTT_PARSE_HEADER;
+}
+
+/**
+ * @brief 输入数据
+ */
+int mqtt_parser_feed(mqtt_parser_t *parser, const uint8_t *data, uint16_t length, uint16_t *consumed,
+                     mqtt_codec_packet_t *packet)
+{
+    uint16_t pos = 0;
+
+    if (!parser || (!data && length > 0) || !consumed || !packet)
+    {
+        return MQTT_ERROR_INVALID_PARAM;
+    }
+
+    while (pos < length)
+    {
+        bool complete = false;
+
+        switch (parser->state)
+        {
+        case MQTT_PARSE_HEADER:
+            parser->header = data[pos++];
+            parser->remaining = 0;
+            parser->length_bytes = 0;
+            parser->state = MQTT_PARSE_LENGTH;
+            break;
+
+        case MQTT_PARSE_LENGTH:
+        {
+            uint8_t byte = data[pos++];
+
+            parser->remaining |= (uint32_t)(byte & 0x7F) << (7 * parser->length_bytes);
+            parser->length_bytes++;
+            if (byte & 0x80)
+            {
+                if (parser->length_bytes >= 4)
+                {
+                    parser->state = MQTT_PARSE_HEADER;
+                    *consumed = pos;
+                    return MQTT_ERROR_PROTOCOL;
+                }
+                break;
+            }
+
+            parser->received = 0;
+            parser->state = MQTT_PARSE_BODY;
+            complete = (parser->remaining == 0);
+            break;
+        }
+
+        default:
+        {
+            // 报文体按块拷贝，超长报文只计数不保存
+            uint32_t chunk = parser->remaining - parser->received;
+            if (chunk > (uint32_t)(length - pos))
+            {
+                chunk = (uint32_t)(length - pos);
+            }
+            if (parser->remaining <= parser->size)
+            {
+                memcpy(parser->buffer + parser->received, data + pos, chunk);
+            }
+            pos = (uint16_t)(pos + chunk);
+            parser->received += chunk;
+            complete = (parser->received == parser->remaining);
+            break;
+        }
+        }
+
+        if (!complete)
+        {
+            continue;
+        }
+
+        parser->state = MQTT_PARSE_HEADER;
+        if (parser->remaining > parser->size)
+        {
+            parser->dropped++;
+            continue;
+        }
+
+        *consumed = pos;
+        return (mqtt_codec_decode(parser, packet) == MQTT_SUCCESS) ? MQTT_CODEC_PACKET : MQTT_ERROR_PROTOCOL;
+    }
+
+    *consumed = pos;
+    return MQTT_CODEC_NEED_MORE;
+}
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief 有界字符串长度
+ */
+static uint16_t mqtt_codec_strlen(const char *s, uint16_t max)
+{
+    uint16_t length = 0;
+
+    while (length < max && s[length] != '\0')
+    {
+        length++;
+    }
+    return length;
+}
+
+/**
+ * @brief 剩余长度的编码字节数
+ */
+static uint8_t mqtt_codec_length_size(uint32_t remaining)
+{
+    if (remaining < 128UL)
+    {
+        return 1;
+    }
+    if (remaining < 16384UL)
+    {
+        return 2;
+    }
+    if (remaining < 2097152UL)
+    {
+        return 3;
+    }
+    return 4;
+}
+
+/**
+ * @brief 写入固定头
+ */
+static uint8_t *mqtt_codec_put_header(uint8_t *p, uint8_t first_byte, uint32_t remaining)
+{
+    *p++ = first_byte;
+    do
+    {
+        uint8_t byte = (uint8_t)(remaining & 0x7F);
+        remaining >>= 7;
+        if (remaining > 0)
+        {
+            byte |= 0x80;
+        }
+        *p++ = byte;
+    } while (remaining > 0);
+
+    return p;
+}
+
+static uint8_t *mqtt_codec_put_u16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)value;
+    return p + 2;
+}
+
+static uint8_t *mqtt_codec_put_string(uint8_t *p, const char *s, uint16_t length)
+{
+    p = mqtt_codec_put_u16(p, length);
+    memcpy(p, s, length);
+    return p + length;
+}
+
+static uint16_t mqtt_codec_get_u16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/**
+ * @brief 解码解析器缓冲区中的完整报文
+ */
+static int mqtt_codec_decode(const mqtt_parser_t *parser, mqtt_codec_packet_t *packet)
+{
+    const uint8_t *body = parser->buffer;
+    uint16_t length = (uint16_t)parser->remaining;
+
+    memset(packet, 0, sizeof(*packet));
+    packet->type = (uint8_t)(parser->header >> 4);
+    packet->flags = (uint8_t)(parser->header & 0x0F);
+
+    switch (packet->type)
+    {
+    case MQTT_PUBLISH:
+    {
+        uint8_t qos = (uint8_t)((packet->flags >> 1) & 0x03);
+        if (qos > MQTT_QOS_2 || length < 2)
+        {
+            return MQTT_ERROR_PROTOCOL;
+        }
+
+        uint16_t topic_len = mqtt_codec_get_u16(body);
+        uint32_t offset = 2UL + topic_len + (qos > MQTT_QOS_0 ? 2 : 0);
+        if (offset > length)
+        {
+            return MQTT_ERROR_PROTOCOL;
+        }
+        if (qos > MQTT_QOS_0)
+        {
+            packet->packet_id = mqtt_codec_get_u16(body + 2 + topic_len);
+            if (packet->packet_id == 0)
+            {
+                return MQTT_ERROR_PROTOCOL;
+            }
+        }
+
+        packet->topic = (const char *)(body + 2);
+        packet->topic_len = topic_len;
+        packet->payload = body + offset;
+        packet->payload_len = (uint16_t)(length - offset);
+        return MQTT_SUCCESS;
+    }
+
+    case MQTT_CONNACK:
+        if (packet->flags != 0 || length != 2)
+        {
+            return MQTT_ERROR_PROTOCOL;
+        }
+        packet->session_present = (body[0] & 0x01) != 0;
+        packet->return_code = body[1];
+        return MQTT_SUCCESS;
+
+    case MQTT_PUBREL:
+    case MQTT_SUBSCRIBE:
+    case MQTT_UNSUBSCRIBE:
+    case MQTT_PUBACK:
+    case MQTT_PUBREC:
+    case MQTT_PUBCOMP:
+    case MQTT_SUBACK:
+    case MQTT_UNSUBACK:
+    {
+        // PUBREL/SUBSCRIBE/UNSUBSCRIBE的固定头标志必须为0010
+        bool flagged = (packet->type == MQTT_PUBREL || packet->type == MQTT_SUBSCRIBE ||
+                        packet->type == MQTT_UNSUBSCRIBE);
+        if (packet->flags != (flagged ? 0x02 : 0) || length < 2 || (packet->type == MQTT_SUBACK && length < 3))
+        {
+            return MQTT_ERROR_PROTOCOL;
+        }
+
+        packet->packet_id = mqtt_codec_get_u16(body);
+        packet->payload = body + 2;
+        packet->payload_len = (uint16_t)(length - 2);
+        if (packet->type == MQTT_SUBACK)
+        {
+            packet->return_code = body[2];
+        }
+        return MQTT_SUCCESS;
+    }
+
+    case MQTT_CONNECT:
+        if (packet->flags != 0)
+        {
+            return MQTT_ERROR_PROTOCOL;
+        }
+        packet->payload = body;
+        packet->payload_len = length;
+        return MQTT_SUCCESS;
+
+    case MQTT_PINGREQ:
+    case MQTT_PINGRESP:
+    case MQTT_DISCONNECT:
+        return (packet->flags == 0 && length == 0) ? MQTT_SUCCESS : MQTT_ERROR_PROTOCOL;
+
+    default:
+        return MQTT_ERROR_PROTOCOL;
+    }
+}
@@ -0,0 +1,291 @@
+/**
+ * @file telemetry_codec.c
+ * @brief 憨云DTU紧凑二进制遥测载荷编解码实现
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include "telemetry_codec.h"
+#include <string.h>
+
+// ============================================================================
+// 模式定义
+// ============================================================================
+
+static const telemetry_field_t telemetry_sensor_fields[] = {
+    {"temperature", TELEMETRY_FIELD_SINT, 1},
+    {"humidity", TELEMETRY_FIELD_SINT, 1},
+    {"voltage", TELEMETRY_FIELD_SINT, 2},
+    {"current", TELEMETRY_FIELD_SINT, 2},
+    {"power", TELEMETRY_FIELD_SINT, 2},
+    {"timestamp", TELEMETRY_FIELD_UINT, 0},
+};
+
+static const telemetry_field_t telemetry_status_fields[] = {
+    {"flags", TELEMETRY_FIELD_UINT, 0},
+    {"uptime", TELEMETRY_FIELD_UINT, 0},
+    {"free_memory", TELEMETRY_FIELD_UINT, 0},
+};
+
+const telemetry_schema_t telemetry_schema_sensor = {
+    TELEMETRY_SCHEMA_SENSOR, TELEMETRY_SENSOR_VERSION,
+    (uint8_t)(sizeof(telemetry_sensor_fields) / sizeof(telemetry_sensor_fields[0])), telemetry_sensor_fields};
+
+const telemetry_schema_t telemetry_schema_status = {
+    TELEMETRY_SCHEMA_STATUS, TELEMETRY_STATUS_VERSION,
+    (uint8_t)(sizeof(telemetry_status_fields) / sizeof(telemetry_status_fields[0])), telemetry_status_fields};
+
+// ============================================================================
+// 内部函数声明
+// ============================================================================
+
+static uint16_t telemetry_get_varint(const uint8_t *data, uint16_t length, uint32_t *value);
+
+// ============================================================================
+// 写入器
+// ============================================================================
+
+void telemetry_writer_init(telemetry_writer_t *writer, uint8_t *buffer, uint16_t capacity)
+{
+    if (!writer)
+    {
+        return;
+    }
+
+    writer->buffer = buffer;
+    writer->capacity = buffer ? capacity : 0;
+    writer->length = 0;
+    writer->overflow = false;
+}
+
+void telemetry_write_header(telemetry_writer_t *writer, const telemetry_schema_t *schema, uint32_t mask)
+{
+    if (!writer || !schema)
+    {
+        return;
+    }
+
+    if (writer->length + 2 > writer->capacity)
+    {
+        writer->overflow = true;
+        return;
+    }
+    writer->buffer[writer->length++] = schema->id;
+    writer->buffer[writer->length++] = schema->version;
+    telemetry_write_uint(writer, mask);
+}
+
+void telemetry_write_uint(telemetry_writer_t *writer, uint32_t value)
+{
+    uint8_t bytes[TELEMETRY_VARINT_MAX];
+    uint8_t count = 0;
+
+    if (!writer || writer->overflow)
+    {
+        return;
+    }
+
+    // 每字节7位，低位在前，最高位表示后续还有字节
+    do
+    {
+        bytes[count] = (uint8_t)(value & 0x7F);
+        value >>= 7;
+        if (value)
+        {
+            bytes[count] |= 0x80;
+        }
+        count++;
+    } while (value);
+
+    if (writer->length + count > writer->capacity)
+    {
+        writer->overflow = true;
+        return;
+    }
+    memcpy(writer->buffer + writer->length, bytes, count);
+    writer->length = (uint16_t)(writer->length + count);
+}
+
+void telemetry_write_sint(telemetry_writer_t *writer, int32_t value)
+{
+    // zigzag: 绝对值小的负数也编码为短的变长整数
+    telemetry_write_uint(writer, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+uint16_t telemetry_writer_finish(const telemetry_writer_t *writer)
+{
+    if (!writer || writer->overflow)
+    {
+        return 0;
+    }
+    return writer->length;
+}
+
+// ============================================================================
+// 编码
+// ============================================================================
+
+uint16_t telemetry_encode_sensor(uint8_t *buffer, uint16_t size, const telemetry_sensor_t *sample)
+{
+    telemetry_writer_t writer;
+
+    if (!buffer || !sample)
+    {
+        return 0;
+    }
+
+    telemetry_writer_init(&writer, buffer, size);
+    telemetry_write_header(&writer, &telemetry_schema_sensor, TELEMETRY_SENSOR_ALL);
+    telemetry_write_sint(&writer, sample->temperature);
+    telemetry_write_sint(&writer, sample->humidity);
+    telemetry_write_sint(&writer, sample->voltage);
+    telemetry_write_sint(&writer, sample->current);
+    telemetry_write_sint(&writer, sample->power);
+    telemetry_write_uint(&writer, sample->timestamp);
+    return telemetry_writer_finish(&writer);
+}
+
+uint16_t telemetry_encode_status(uint8_t *buffer, uint16_t size, const telemetry_status_t *status)
+{
+    telemetry_writer_t writer;
+
+    if (!buffer || !status)
+    {
+        return 0;
+    }
+
+    telemetry_writer_init(&writer, buffer, size);
+    telemetry_write_header(&writer, &telemetry_schema_status, TELEMETRY_STATUS_ALL);
+    telemetry_write_uint(&writer, status->flags);
+    telemetry_write_uint(&writer, status->uptime);
+    telemetry_write_uint(&writer, status->free_memory);
+    return telemetry_writer_finish(&writer);
+}
+
+// ============================================================================
+// 解码
+// ============================================================================
+
+const telemetry_schema_t *telemetry_find_schema(uint8_t id)
+{
+    switch (id)
+    {
+    case TELEMETRY_SCHEMA_SENSOR:
+        return &telemetry_schema_sensor;
+    case TELEMETRY_SCHEMA_STATUS:
+        return &telemetry_schema_status;
+    default:
+        return NULL;
+    }
+}
+
+uint16_t telemetry_decode(const uint8_t *data, uint16_t length, telemetry_record_t *record)
+{
+    uint32_t mask;
+    uint16_t offset = 2;
+
+    if (!data || !record || length < 3)
+    {
+        return 0;
+    }
+
+    memset(record, 0, sizeof(telemetry_record_t));
+    record->schema = telemetry_find_schema(data[0]);
+    record->version = data[1];
+    if (!record->schema || record->version == 0)
+    {
+        return 0;
+    }
+
+    uint16_t used = telemetry_get_varint(data + offset, (uint16_t)(length - offset), &mask);
+    if (used == 0)
+    {
+        return 0;
+    }
+    offset = (uint16_t)(offset + used);
+
+    // 按位序逐个读出，超出已知字段数的为新版本追加的字段，读出后丢弃
+    for (uint8_t field = 0; field < 32 && (mask >> field) != 0; field++)
+    {
+        uint32_t value;
+
+        if (!(mask & (1UL << field)))
+        {
+            continue;
+        }
+
+        used = telemetry_get_varint(data + offset, (uint16_t)(length - offset), &value);
+        if (used == 0)
+        {
+            return 0;
+        }
+        offset = (uint16_t)(offset + used);
+
+        if (field >= record->schema->field_count)
+        {
+            record->newer = true;
+            continue;
+        }
+        if (record->schema->fields[field].type == TELEMETRY_FIELD_SINT)
+        {
+            value = (value >> 1) ^ (0U - (value & 1));
+        }
+        record->values[field] = (int32_t)value;
+        record->mask |= 1UL << field;
+    }
+
+    return offset;
+}
+
+bool telemetry_get_sensor(const telemetry_record_t *record, telemetry_sensor_t *sample)
+{
+    if (!record || !sample || record->schema != &telemetry_schema_sensor)
+    {
+        return false;
+    }
+
+    sample->temperature = record->values[TELEMETRY_SENSOR_TEMPERATURE];
+    sample->humidity = record->values[TELEMETRY_SENSOR_HUMIDITY];
+    sample->voltage = record->values[TELEMETRY_SENSOR_VOLTAGE];
+    sample->current = record->values[TELEMETRY_SENSOR_CURRENT];
+    sample->power = record->values[TELEMETRY_SENSOR_POWER];
+    sample->timestamp = (uint32_t)record->values[TELEMETRY_SENSOR_TIMESTAMP];
+    return true;
+}
+
+bool telemetry_get_status(const telemetry_record_t *record, telemetry_status_t *status)
+{
+    if (!record || !status || record->schema != &telemetry_schema_status)
+    {
+        return false;
+    }
+
+    status->flags = (uint8_t)record->values[TELEMETRY_STATUS_FLAGS];
+    status->uptime = (uint32_t)record->values[TELEMETRY_STATUS_UPTIME];
+    status->free_memory = (uint32_t)record->values[TELEMETRY_STATUS_FREE_MEMORY];
+    return true;
+}
+
+// ============================================================================
+// 内部函数实现
+// ============================================================================
+
+/**
+ * @brief 读取变长整数
+ * @return 消耗的字节数, 0:数据不完整或超过32位
+ */
+static uint16_t telemetry_get_varint(const uint8_t *data, uint16_t length, uint32_t *value)
+{
+    uint32_t result = 0;
+
+    for (uint8_t i = 0; i < TELEMETRY_VARINT_MAX && i < length; i++)
+    {
+        result |= (uint32_t)(data[i] & 0x7F) << (7 * i);
+        if (!(data[i] & 0x80))
+        {
+            *value = result;
+            return (uint16_t)(i + 1);
+        }
+    }
+    return 0;
+}
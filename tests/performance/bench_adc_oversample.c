@@ -0,0 +1,130 @@
+/**
+ * @file bench_adc_oversample.c
+ * @brief ADC过采样/抽取性能测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 对扩展位数n=0~4分别测量:
+ * - 每个输出样本的CPU开销 (4^n次累加 + 1次移位)
+ * - 带1LSB噪声的输入下的有效分辨率 (以16位满量程LSB计的RMS误差)
+ * - 电压通道单帧采集时间 (时序模型)
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/adc.h"
+#include "perf_counter.h"
+#include <stdio.h>
+#include <math.h>
+
+#define BENCH_CONVERSIONS 262144UL // 4^9，各n下输出数均为整数
+#define BENCH_ACCURACY_OUTPUTS 2000
+
+static uint32_t bench_lfsr = 0xACE1u;
+
+/**
+ * @brief 模拟一次12位转换: 真值 + 均匀噪声 (±1 LSB)，再量化
+ */
+static uint16_t bench_convert(double true_code)
+{
+    bench_lfsr = (bench_lfsr >> 1) ^ (-(bench_lfsr & 1u) & 0xB400u);
+    double noisy = true_code + ((double)(bench_lfsr & 0xFFF) / 4096.0 - 0.5) * 2.0;
+    long code = lround(noisy);
+    return (uint16_t)(code < 0 ? 0 : (code > 4095 ? 4095 : code));
+}
+
+TEST_CASE(adc_oversample_cost_per_output)
+{
+    for (uint8_t bits = 0; bits <= ADC_OVERSAMPLE_MAX_BITS; bits++)
+    {
+        adc_oversample_t oversample;
+        uint16_t result = 0;
+        uint32_t outputs = 0, acc = 0;
+        char name[48];
+
+        adc_oversample_init(&oversample, bits);
+
+        uint64_t start = perf_now();
+        for (uint32_t i = 0; i < BENCH_CONVERSIONS; i++)
+        {
+            if (adc_oversample_add(&oversample, (uint16_t)(2048 + (i & 7)), &result))
+            {
+                acc += result;
+                outputs++;
+            }
+        }
+        uint64_t elapsed = perf_now() - start;
+
+        perf_sink(acc);
+        snprintf(name, sizeof(name), "oversample n=%u (%u-bit) per output", bits, 12 + bits);
+        perf_report(name, elapsed, outputs);
+        TEST_ASSERT_EQUAL(BENCH_CONVERSIONS >> (2 * bits), outputs);
+    }
+}
+
+TEST_CASE(adc_oversample_effective_resolution)
+{
+    double rms_error[ADC_OVERSAMPLE_MAX_BITS + 1];
+
+    printf("  [PERF] %-6s %-8s %18s\n", "n", "bits", "RMS err (16b LSB)");
+
+    for (uint8_t bits = 0; bits <= ADC_OVERSAMPLE_MAX_BITS; bits++)
+    {
+        adc_oversample_t oversample;
+        uint16_t result = 0;
+        double sum_sq = 0.0;
+
+        adc_oversample_init(&oversample, bits);
+        bench_lfsr = 0xACE1u;
+
+        for (uint32_t out = 0; out < BENCH_ACCURACY_OUTPUTS; out++)
+        {
+            // 真值在码值之间缓慢扫描
+            double true_code = 1000.0 + (double)out * 0.0137;
+
+            while (!adc_oversample_add(&oversample, bench_convert(true_code), &result))
+            {
+            }
+
+            // 统一换算到16位满量程比较
+            double error = (double)result * (double)(1U << (4 - bits)) - true_code * 16.0;
+            sum_sq += error * error;
+        }
+
+        rms_error[bits] = sqrt(sum_sq / BENCH_ACCURACY_OUTPUTS);
+        printf("  [PERF] %-6u %-8u %18.2f\n", bits, 12 + bits, rms_error[bits]);
+    }
+
+    TEST_ASSERT_TRUE(rms_error[ADC_OVERSAMPLE_MAX_BITS] < rms_error[0] / 4.0);
+}
+
+TEST_CASE(adc_oversample_frame_time)
+{
+    adc_scan_config_t config = {
+        .channel_mask = (1U << ADC_VOLTAGE_MONITOR_CHANNEL) | (1U << ADC_CURRENT_MONITOR_CHANNEL),
+        .sample_time = ADC_SAMPLE_TIME_4,
+        .use_pdma = true,
+        .callback = NULL};
+    adc_scan_timing_t timing;
+
+    for (uint8_t bits = 0; bits <= ADC_OVERSAMPLE_MAX_BITS; bits++)
+    {
+        config.oversample_bits[ADC_VOLTAGE_MONITOR_CHANNEL] = bits;
+        config.oversample_bits[ADC_CURRENT_MONITOR_CHANNEL] = bits;
+        adc_scan_get_timing(&config, true, &timing);
+        printf("  [PERF] V+I channels n=%u: %u conversions, frame %lu ns\n",
+               bits, timing.conversions, (unsigned long)timing.frame_ns);
+    }
+
+    TEST_ASSERT_EQUAL(512, timing.conversions);
+}
+
+void run_adc_oversample_perf_tests(void)
+{
+    printf("\n=== 运行ADC过采样性能测试 ===\n");
+
+    RUN_TEST(adc_oversample_cost_per_output);
+    RUN_TEST(adc_oversample_effective_resolution);
+    RUN_TEST(adc_oversample_frame_time);
+
+    printf("ADC过采样性能测试用例已添加完成\n");
+}
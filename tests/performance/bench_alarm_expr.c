@@ -0,0 +1,117 @@
+/**
+ * @file bench_alarm_expr.c
+ * @brief 报警表达式解释执行的性能测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 每个采样: alarm_expr_update() + 求值一条表达式 (即每采样每规则的开销)，
+ * 对比手写C实现的同一条件 (同样维护历史环，只省去解释开销)；另测一次编译的耗时
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/alarm_expr.h"
+#include "perf_counter.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_SAMPLES 20000
+#define BENCH_SAMPLE_PERIOD 1000 // 1Hz采样
+
+/**
+ * @brief 手写实现使用的历史环 (与表达式模块相同的抽取方式)
+ */
+static int32_t bench_history[ALARM_EXPR_HISTORY];
+static uint32_t bench_slot_time;
+static uint8_t bench_head;
+
+static int32_t bench_value(uint32_t n)
+{
+    return 550 + (int32_t)(n % 300) - (int32_t)((n >> 3) & 15);
+}
+
+/**
+ * @brief 手写: temp > 600 && rate(temp, 60) > 20
+ */
+static bool bench_native_sample(int32_t value, uint32_t now)
+{
+    if (now - bench_slot_time >= ALARM_EXPR_HISTORY_INTERVAL)
+    {
+        bench_history[bench_head] = value;
+        bench_head = (uint8_t)((bench_head + 1) % ALARM_EXPR_HISTORY);
+        bench_slot_time += ALARM_EXPR_HISTORY_INTERVAL;
+    }
+
+    int32_t oldest = bench_history[(bench_head + ALARM_EXPR_HISTORY - 5) % ALARM_EXPR_HISTORY];
+    uint32_t elapsed = now - (bench_slot_time - 4 * ALARM_EXPR_HISTORY_INTERVAL);
+    int32_t rate = (int32_t)((int64_t)(value - oldest) * 60000 / (int64_t)elapsed);
+    return value > 600 && rate > 20;
+}
+
+static void bench_expression(const char *name, const char *source)
+{
+    uint64_t start;
+    uint32_t sink = 0;
+
+    alarm_expr_init();
+    TEST_ASSERT_TRUE(alarm_expr_set(0, source));
+
+    start = perf_now();
+    for (uint32_t n = 0; n < BENCH_SAMPLES; n++)
+    {
+        uint32_t now = n * BENCH_SAMPLE_PERIOD;
+        alarm_expr_update(ALARM_EXPR_INPUT_TEMPERATURE, bench_value(n), now);
+        sink += alarm_expr_evaluate(0, now);
+    }
+    perf_report(name, perf_now() - start, BENCH_SAMPLES);
+    perf_sink(sink);
+}
+
+TEST_CASE(alarm_expr_evaluation_cost)
+{
+    uint64_t start;
+    uint32_t sink = 0;
+
+    bench_expression("expr: temp > 600", "temp > 600");
+    bench_expression("expr: temp > 600 && rate(temp,60) > 20", "temp > 600 && rate(temp, 60) > 20");
+    bench_expression("expr: for(temp < 560, 30)", "for(temp < 560, 30)");
+    bench_expression("expr: avg(temp,240) > 600 || max(temp,60) > 700",
+                     "avg(temp, 240) > 600 || max(temp, 60) > 700");
+
+    // 手写对照 (含自身历史环更新)
+    memset(bench_history, 0, sizeof(bench_history));
+    bench_slot_time = 0;
+    bench_head = 0;
+    start = perf_now();
+    for (uint32_t n = 0; n < BENCH_SAMPLES; n++)
+    {
+        sink += bench_native_sample(bench_value(n), n * BENCH_SAMPLE_PERIOD + ALARM_EXPR_HISTORY_INTERVAL * 4);
+    }
+    perf_report("native C: temp > 600 && rate > 20", perf_now() - start, BENCH_SAMPLES);
+    perf_sink(sink);
+}
+
+TEST_CASE(alarm_expr_compile_cost)
+{
+    uint8_t code[ALARM_EXPR_MAX_CODE];
+    uint64_t start;
+    uint32_t sink = 0;
+
+    start = perf_now();
+    for (uint32_t n = 0; n < BENCH_SAMPLES / 10; n++)
+    {
+        sink += alarm_expr_compile("temp > 600 && rate(temp, 60) > 20", code, sizeof(code), NULL);
+    }
+    perf_report("compile (configuration time)", perf_now() - start, BENCH_SAMPLES / 10);
+    printf("  [PERF] bytecode: %u bytes\n", (unsigned)(sink / (BENCH_SAMPLES / 10)));
+    perf_sink(sink);
+}
+
+void run_alarm_expr_perf_tests(void)
+{
+    printf("\n=== 运行报警表达式性能测试 ===\n");
+
+    RUN_TEST(alarm_expr_evaluation_cost);
+    RUN_TEST(alarm_expr_compile_cost);
+
+    printf("报警表达式性能测试用例已添加完成\n");
+}
@@ -0,0 +1,140 @@
+/**
+ * @file bench_alarm_notify.c
+ * @brief 报警通知合并与限速的性能测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 报警风暴: 16条规则 (信息/警告/错误各若干，另2条严重) 在阈值附近以10Hz抖动60秒
+ * 原方案 (模型): 每次状态变化发送一条JSON消息到每个上行通道
+ * 合并方案: 经alarm_notify合并窗口与令牌桶后发往MQTT (整批一帧) 与LoRa (51字节分帧)
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/alarm_notify.h"
+#include "../../inc/alarm.h"
+#include "../../inc/system.h"
+#include "perf_counter.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_RULES 16
+#define BENCH_SECONDS 60
+#define BENCH_PERIOD 100 // 采样周期 (ms)
+
+/**
+ * @brief 通道计数
+ */
+typedef struct
+{
+    uint32_t frames;
+    uint32_t bytes;
+} bench_sink_t;
+
+static bench_sink_t bench_mqtt;
+static bench_sink_t bench_lora;
+
+static bool bench_send(const uint8_t *frame, uint16_t length, void *context)
+{
+    bench_sink_t *sink = (bench_sink_t *)context;
+
+    (void)frame;
+    sink->frames++;
+    sink->bytes += length;
+    return true;
+}
+
+static uint8_t bench_level(uint8_t id)
+{
+    return (id < 2) ? ALARM_LEVEL_CRITICAL : (uint8_t)(id % 3);
+}
+
+/**
+ * @brief 原方案模型: 每次变化一条JSON
+ */
+static uint16_t bench_json_message(char *buffer, uint16_t size, const alarm_history_t *event)
+{
+    return (uint16_t)snprintf(buffer, size,
+                              "{\"rule\":%u,\"type\":%u,\"level\":%u,\"state\":%u,\"value\":%ld,\"ts\":%lu}",
+                              (unsigned)event->rule_id, (unsigned)event->type, (unsigned)event->level,
+                              (unsigned)event->state, (long)event->value, (unsigned long)event->timestamp);
+}
+
+TEST_CASE(alarm_notify_storm)
+{
+    alarm_notify_sink_t mqtt = {bench_send, &bench_mqtt, ALARM_NOTIFY_MAX_FRAME};
+    alarm_notify_sink_t lora = {bench_send, &bench_lora, 51};
+    alarm_notify_stats_t stats;
+    alarm_history_t event;
+    char json[128];
+    uint32_t naive_messages = 0;
+    uint32_t naive_bytes = 0;
+    uint64_t start, elapsed = 0;
+
+    memset(&bench_mqtt, 0, sizeof(bench_mqtt));
+    memset(&bench_lora, 0, sizeof(bench_lora));
+    alarm_notify_init();
+    TEST_ASSERT_TRUE(alarm_notify_add_sink(&mqtt));
+    TEST_ASSERT_TRUE(alarm_notify_add_sink(&lora));
+
+    memset(&event, 0, sizeof(event));
+    event.type = ALARM_TYPE_TEMPERATURE;
+
+    for (uint32_t n = 0; n < BENCH_SECONDS * 1000 / BENCH_PERIOD; n++)
+    {
+        for (uint8_t id = 0; id < BENCH_RULES; id++)
+        {
+            event.timestamp = system_get_tick();
+            event.rule_id = id;
+            event.level = bench_level(id);
+            event.state = ((n + id) & 1) ? ALARM_STATE_RESOLVED : ALARM_STATE_ACTIVE;
+            event.value = 600 + (int32_t)((n * 7 + id) & 31);
+
+            // 严重级别的规则只在每秒第一个采样变化，模拟真实的少量严重事件
+            if (event.level == ALARM_LEVEL_CRITICAL && (n % 10) != 0)
+            {
+                continue;
+            }
+
+            naive_messages++;
+            naive_bytes += bench_json_message(json, sizeof(json), &event);
+
+            start = perf_now();
+            alarm_notify_post(&event);
+            elapsed += perf_now() - start;
+        }
+
+        for (uint32_t t = 0; t < BENCH_PERIOD; t++)
+        {
+            system_tick_increment();
+        }
+        alarm_notify_task();
+    }
+    alarm_notify_flush();
+
+    TEST_ASSERT_TRUE(alarm_notify_get_stats(&stats));
+    TEST_ASSERT_EQUAL(naive_messages, stats.posted);
+
+    printf("  [PERF] transitions: %lu in %u s (%lu coalesced, %lu suppressed, %lu critical flushes)\n",
+           (unsigned long)stats.posted, (unsigned)BENCH_SECONDS, (unsigned long)stats.coalesced,
+           (unsigned long)stats.suppressed, (unsigned long)stats.immediate);
+    printf("  [PERF] %-26s %10s %10s\n", "per uplink", "messages", "bytes");
+    printf("  [PERF] %-26s %10lu %10lu\n", "naive JSON per transition", (unsigned long)naive_messages,
+           (unsigned long)naive_bytes);
+    printf("  [PERF] %-26s %10lu %10lu\n", "coalesced MQTT", (unsigned long)bench_mqtt.frames,
+           (unsigned long)bench_mqtt.bytes);
+    printf("  [PERF] %-26s %10lu %10lu\n", "coalesced LoRa (51 B)", (unsigned long)bench_lora.frames,
+           (unsigned long)bench_lora.bytes);
+    perf_report("alarm_notify_post()", elapsed, stats.posted);
+
+    // 带宽上限: 非严重条目受令牌桶限制，批次受窗口限制
+    TEST_ASSERT_TRUE(bench_mqtt.bytes * 10 < naive_bytes);
+}
+
+void run_alarm_notify_perf_tests(void)
+{
+    printf("\n=== 运行报警通知性能测试 ===\n");
+
+    RUN_TEST(alarm_notify_storm);
+
+    printf("报警通知性能测试用例已添加完成\n");
+}
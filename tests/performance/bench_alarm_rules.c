@@ -0,0 +1,219 @@
+/**
+ * @file bench_alarm_rules.c
+ * @brief 报警规则按类型索引与状态位图的性能测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 每个采样: alarm_check_condition(温度) + alarm_process()，温度规则固定4条，
+ * 其余规则分布在其他类型上，其中每8条有1条处于激活状态；规则总数从16增加到ALARM_MAX_RULES
+ * (默认配置只有16条，主机构建可用 -DALARM_MAX_RULES=240 观察扩展性)
+ * 原方案 (模型): 检查、处理、输出聚合各遍历一次全部规则
+ * 索引方案的剩余增长来自alarm_process()逐个处理激活报警 (与激活数成正比，与规则总数无关)
+ * 另测报警历史环的RAM占用与读取开销
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/alarm.h"
+#include "perf_counter.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_SAMPLES 20000
+#define BENCH_TEMP_RULES 4
+
+/**
+ * @brief 原方案模型的规则状态
+ */
+typedef struct
+{
+    uint8_t type;
+    uint8_t output_mask;
+    int32_t threshold;
+    alarm_state_t state;
+    uint32_t trigger_time;
+    uint32_t duration;
+} bench_legacy_rule_t;
+
+static bench_legacy_rule_t bench_legacy[ALARM_MAX_RULES];
+
+static uint8_t bench_rule_type(uint16_t i)
+{
+    return (i < BENCH_TEMP_RULES) ? ALARM_TYPE_TEMPERATURE : (uint8_t)(0x10 + i % 48);
+}
+
+static void bench_setup_rules(uint16_t count)
+{
+    alarm_rule_t rule;
+
+    alarm_init();
+    for (uint16_t i = 0; i < count; i++)
+    {
+        memset(&rule, 0, sizeof(rule));
+        rule.id = (uint8_t)i;
+        rule.type = bench_rule_type(i);
+        rule.level = (uint8_t)(i % 4);
+        rule.condition = ALARM_CONDITION_GT;
+        rule.enabled = true;
+        rule.threshold_high = 600 + (int32_t)i;
+        rule.output_mask = (uint8_t)(1U << (i % 3));
+        TEST_ASSERT_TRUE(alarm_add_rule(&rule));
+
+        bench_legacy[i].type = rule.type;
+        bench_legacy[i].output_mask = rule.output_mask;
+        bench_legacy[i].threshold = rule.threshold_high;
+        bench_legacy[i].state = ALARM_STATE_IDLE;
+    }
+
+    // 其他类型中每8条激活1条
+    for (uint16_t i = BENCH_TEMP_RULES; i < count; i += 8)
+    {
+        TEST_ASSERT_TRUE(alarm_trigger((uint8_t)i, 0));
+        bench_legacy[i].state = ALARM_STATE_ACTIVE;
+    }
+}
+
+/**
+ * @brief 原方案模型: 检查遍历全部规则，处理与输出聚合再各遍历一次
+ */
+static uint8_t bench_legacy_sample(uint16_t count, int32_t value, uint32_t now)
+{
+    uint8_t outputs = 0;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        bench_legacy_rule_t *rule = &bench_legacy[i];
+        if (rule->type != ALARM_TYPE_TEMPERATURE)
+        {
+            continue;
+        }
+        bool met = value > rule->threshold;
+        if (met && rule->state == ALARM_STATE_IDLE)
+        {
+            rule->state = ALARM_STATE_ACTIVE;
+            rule->trigger_time = now;
+        }
+        else if (!met && rule->state == ALARM_STATE_ACTIVE)
+        {
+            rule->state = ALARM_STATE_IDLE;
+        }
+    }
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        if (bench_legacy[i].state != ALARM_STATE_IDLE)
+        {
+            bench_legacy[i].duration = now - bench_legacy[i].trigger_time;
+        }
+    }
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        if (bench_legacy[i].state == ALARM_STATE_ACTIVE)
+        {
+            outputs |= bench_legacy[i].output_mask;
+        }
+    }
+    return outputs;
+}
+
+TEST_CASE(alarm_rule_scaling)
+{
+    static const uint16_t steps[] = {16, 32, 64, 128, 240};
+
+    printf("  [PERF] %-12s %14s %14s %8s\n", "rules", "indexed", "linear model", "active");
+    for (uint8_t s = 0; s < sizeof(steps) / sizeof(steps[0]); s++)
+    {
+        uint16_t count = steps[s];
+        uint64_t start, indexed, legacy;
+        uint32_t sink = 0;
+
+        if (count > ALARM_MAX_RULES)
+        {
+            break;
+        }
+
+        bench_setup_rules(count);
+        uint8_t active = alarm_get_active_count();
+
+        // 温度在阈值附近不跨越，稳态下测量 (不产生历史记录)
+        start = perf_now();
+        for (uint32_t n = 0; n < BENCH_SAMPLES; n++)
+        {
+            sink += alarm_check_condition(ALARM_TYPE_TEMPERATURE, 500 + (int32_t)(n & 63));
+            alarm_process();
+        }
+        indexed = perf_now() - start;
+        TEST_ASSERT_EQUAL(active, alarm_get_active_count());
+
+        start = perf_now();
+        for (uint32_t n = 0; n < BENCH_SAMPLES; n++)
+        {
+            sink += bench_legacy_sample(count, 500 + (int32_t)(n & 63), n);
+        }
+        legacy = perf_now() - start;
+        perf_sink(sink);
+
+        printf("  [PERF] %-12u %11lu.%02lu %11lu.%02lu %8u  %s/sample\n", (unsigned)count,
+               (unsigned long)(indexed / BENCH_SAMPLES), (unsigned long)(indexed * 100 / BENCH_SAMPLES % 100),
+               (unsigned long)(legacy / BENCH_SAMPLES), (unsigned long)(legacy * 100 / BENCH_SAMPLES % 100),
+               (unsigned)active, PERF_UNIT);
+    }
+}
+
+TEST_CASE(alarm_count_queries)
+{
+    uint64_t start;
+    uint32_t sink = 0;
+
+    bench_setup_rules(ALARM_MAX_RULES);
+
+    start = perf_now();
+    for (uint32_t n = 0; n < BENCH_SAMPLES; n++)
+    {
+        sink += alarm_get_active_count();
+        sink += alarm_get_level_count((uint8_t)(n & 3));
+    }
+    perf_report("active + level count (popcount)", perf_now() - start, BENCH_SAMPLES);
+    perf_sink(sink);
+
+    alarm_deinit();
+}
+
+TEST_CASE(alarm_history_footprint)
+{
+    static alarm_history_t history[ALARM_MAX_HISTORY];
+    uint64_t start;
+    uint32_t sink = 0;
+
+    // 原记录: 时间戳/ID/类型/级别/枚举状态/值/持续时间 + 32字节描述副本 = 52字节
+    printf("  [PERF] history entry: %u B (was 52 B), RAM ring: %u entries = %u B (was 50 x 52 = 2600 B)\n",
+           (unsigned)sizeof(alarm_history_t), (unsigned)ALARM_MAX_HISTORY,
+           (unsigned)(ALARM_MAX_HISTORY * sizeof(alarm_history_t)));
+
+    bench_setup_rules(BENCH_TEMP_RULES);
+    for (uint16_t n = 0; n < ALARM_MAX_HISTORY; n++)
+    {
+        alarm_check_condition(ALARM_TYPE_TEMPERATURE, (n & 1) ? 500 : 700);
+    }
+
+    start = perf_now();
+    for (uint32_t n = 0; n < BENCH_SAMPLES / 10; n++)
+    {
+        sink += alarm_get_history(history, ALARM_MAX_HISTORY);
+    }
+    perf_report("get full history (lock-free copy)", perf_now() - start, BENCH_SAMPLES / 10);
+    perf_sink(sink);
+
+    alarm_deinit();
+}
+
+void run_alarm_rules_perf_tests(void)
+{
+    printf("\n=== 运行报警规则索引性能测试 ===\n");
+
+    RUN_TEST(alarm_rule_scaling);
+    RUN_TEST(alarm_count_queries);
+    RUN_TEST(alarm_history_footprint);
+
+    printf("报警规则索引性能测试用例已添加完成\n");
+}
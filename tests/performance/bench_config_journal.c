@@ -0,0 +1,137 @@
+/**
+ * @file bench_config_journal.c
+ * @brief A/B双bank日志式配置存储性能测试 (主机NOR模拟器)
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 连续修改单个配置参数，对比:
+ * - 原方案: 每次擦除配置页后整份写入
+ * - 配置日志: 差分记录追加，bank写满时快照写入另一bank
+ * 统计每次修改的页擦除数、编程字节数、主机耗时，以及按假定的Flash时序估算的目标板提交耗时
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/flash.h"
+#include "../../inc/config_journal.h"
+#include "../../inc/storage.h"
+#include "perf_counter.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_CHANGES 2000
+#define BENCH_ERASE_US 20000.0 // 假定页擦除时间 (典型值)
+#define BENCH_PROGRAM_US 30.0  // 假定字编程时间 (典型值)
+
+static config_journal_t bench_journal;
+
+/**
+ * @brief 按假定时序估算平均每次修改的Flash耗时 (us)
+ */
+static double bench_flash_time(const flash_stats_t *stats)
+{
+    double words = stats->program_bytes / (double)FLASH_PROGRAM_UNIT;
+    return (stats->erase_count * BENCH_ERASE_US + words * BENCH_PROGRAM_US) / BENCH_CHANGES;
+}
+
+TEST_CASE(config_journal_change_cost)
+{
+    storage_config_t config, next;
+    flash_stats_t legacy, journal;
+    uint64_t start, legacy_elapsed, journal_elapsed;
+    uint32_t worst_erases = 0;
+
+    memset(&config, 0, sizeof(config));
+    config.magic = STORAGE_MAGIC_NUMBER;
+    config.modbus_slave_id = 1;
+
+    // 原方案: 擦除 + 整份编程 + 校验
+    flash_sim_reset();
+    flash_reset_stats();
+    start = perf_now();
+    for (uint32_t i = 0; i < BENCH_CHANGES; i++)
+    {
+        config.sample_period = (uint16_t)(1000 + i);
+        flash_erase_page(STORAGE_CONFIG_ADDR);
+        flash_program(STORAGE_CONFIG_ADDR, (const uint8_t *)&config, sizeof(config));
+        flash_verify(STORAGE_CONFIG_ADDR, (const uint8_t *)&config, sizeof(config));
+    }
+    legacy_elapsed = perf_now() - start;
+    flash_get_stats(&legacy);
+    uint32_t legacy_wear = flash_sim_get_page_erase_count(STORAGE_CONFIG_ADDR);
+
+    // 配置日志
+    flash_sim_reset();
+    config_journal_mount(&bench_journal, STORAGE_CONFIG_ADDR, STORAGE_CONFIG_BANK_SIZE, &next, sizeof(next));
+    TEST_ASSERT_TRUE(config_journal_commit(&bench_journal, NULL, &config));
+    flash_reset_stats();
+    start = perf_now();
+    for (uint32_t i = 0; i < BENCH_CHANGES; i++)
+    {
+        uint32_t erases = bench_journal.stats.erases;
+        next = config;
+        next.sample_period = (uint16_t)(3000 + i);
+        config_journal_commit(&bench_journal, &config, &next);
+        config = next;
+        if (bench_journal.stats.erases - erases > worst_erases)
+        {
+            worst_erases = bench_journal.stats.erases - erases;
+        }
+    }
+    journal_elapsed = perf_now() - start;
+    flash_get_stats(&journal);
+    uint32_t journal_wear = 0;
+    for (uint32_t offset = 0; offset < 2 * STORAGE_CONFIG_BANK_SIZE; offset += FLASH_PAGE_SIZE)
+    {
+        uint32_t count = flash_sim_get_page_erase_count(STORAGE_CONFIG_ADDR + offset);
+        journal_wear = count > journal_wear ? count : journal_wear;
+    }
+
+    perf_report("config write (erase + rewrite)", legacy_elapsed, BENCH_CHANGES);
+    perf_report("config_journal_commit", journal_elapsed, BENCH_CHANGES);
+    printf("  [PERF] %-36s %10.3f -> %.3f\n", "page erases / change",
+           (double)legacy.erase_count / BENCH_CHANGES, (double)journal.erase_count / BENCH_CHANGES);
+    printf("  [PERF] %-36s %10.1f -> %.1f\n", "programmed bytes / change",
+           (double)legacy.program_bytes / BENCH_CHANGES, (double)journal.program_bytes / BENCH_CHANGES);
+    printf("  [PERF] %-36s %10lu\n", "deltas per bank", (unsigned long)(bench_journal.stats.deltas /
+                                                                         (bench_journal.stats.snapshots - 1)));
+    printf("  [PERF] %-36s %10.0f -> %.0f\n", "est. target commit time (us, avg)",
+           bench_flash_time(&legacy), bench_flash_time(&journal));
+    printf("  [PERF] %-36s %10.0f -> %.0f\n", "est. target commit time (us, worst)",
+           BENCH_ERASE_US + sizeof(config) / FLASH_PROGRAM_UNIT * BENCH_PROGRAM_US,
+           worst_erases * BENCH_ERASE_US + sizeof(config) / FLASH_PROGRAM_UNIT * BENCH_PROGRAM_US);
+    printf("  [PERF] %-36s %10lu -> %lu\n", "erases of most-worn page",
+           (unsigned long)legacy_wear, (unsigned long)journal_wear);
+
+    TEST_ASSERT_EQUAL(BENCH_CHANGES, legacy.erase_count);
+    TEST_ASSERT_TRUE(journal.erase_count * 50 < legacy.erase_count);
+    TEST_ASSERT_EQUAL(0, bench_journal.stats.write_errors);
+}
+
+TEST_CASE(config_journal_mount_time)
+{
+    storage_config_t config;
+    uint64_t start, elapsed;
+
+    // 接续上一用例: 当前bank中有若干差分记录需要回放
+    start = perf_now();
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        config_journal_mount(&bench_journal, STORAGE_CONFIG_ADDR, STORAGE_CONFIG_BANK_SIZE, &config, sizeof(config));
+    }
+    elapsed = perf_now() - start;
+    perf_report("config_journal_mount (replay)", elapsed, 1000);
+    printf("  [PERF] %-36s %10d\n", "bank offset at mount", bench_journal.offset);
+
+    TEST_ASSERT_TRUE(bench_journal.valid);
+    TEST_ASSERT_EQUAL(3000 + BENCH_CHANGES - 1, config.sample_period);
+}
+
+void run_config_journal_perf_tests(void)
+{
+    printf("\n=== 运行配置日志存储性能测试 ===\n");
+
+    RUN_TEST(config_journal_change_cost);
+    RUN_TEST(config_journal_mount_time);
+
+    printf("配置日志存储性能测试用例已添加完成\n");
+}
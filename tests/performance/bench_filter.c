@@ -0,0 +1,135 @@
+/**
+ * @file bench_filter.c
+ * @brief 数字滤波器性能测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 按滤波器类型和窗口长度测量每样本开销，并与原先逐次重新求和的
+ * 滑动平均实现对比。滑动平均应与窗口长度无关
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/filter.h"
+#include "perf_counter.h"
+#include <stdio.h>
+
+#define BENCH_SAMPLES 100000
+
+static const uint8_t bench_windows[] = {2, 4, 8};
+
+/**
+ * @brief 测试信号: 缓变基线 + 伪随机噪声
+ */
+static uint16_t bench_signal(uint32_t i)
+{
+    static uint32_t lfsr = 0xACE1u;
+    lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+    return (uint16_t)(2048 + ((i >> 6) & 0x1FF) + (lfsr & 0x3F));
+}
+
+/**
+ * @brief 原实现: 每样本遍历窗口重新求和
+ */
+static uint16_t bench_legacy_average(uint16_t *buffer, uint8_t *index, uint8_t *count,
+                                     uint8_t window, uint16_t sample)
+{
+    buffer[*index] = sample;
+    *index = (uint8_t)((*index + 1) % window);
+    if (*count < window)
+    {
+        (*count)++;
+    }
+
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < *count; i++)
+    {
+        sum += buffer[i];
+    }
+    return (uint16_t)(sum / *count);
+}
+
+TEST_CASE(filter_legacy_average_cost)
+{
+    for (size_t w = 0; w < sizeof(bench_windows); w++)
+    {
+        uint16_t buffer[FILTER_MAX_WINDOW] = {0};
+        uint8_t index = 0, count = 0;
+        uint32_t acc = 0;
+        char name[48];
+
+        uint64_t start = perf_now();
+        for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+        {
+            acc += bench_legacy_average(buffer, &index, &count, bench_windows[w], bench_signal(i));
+        }
+        uint64_t elapsed = perf_now() - start;
+
+        perf_sink(acc);
+        snprintf(name, sizeof(name), "legacy MA re-sum (N=%u)", bench_windows[w]);
+        perf_report(name, elapsed, BENCH_SAMPLES);
+    }
+}
+
+TEST_CASE(filter_update_cost_by_type)
+{
+    for (int type = 0; type < FILTER_TYPE_COUNT; type++)
+    {
+        for (size_t w = 0; w < sizeof(bench_windows); w++)
+        {
+            filter_t filter;
+            filter_config_t config = {.type = (filter_type_t)type, .window = bench_windows[w], .param = 0};
+            uint32_t acc = 0;
+            char name[48];
+
+            TEST_ASSERT_TRUE(filter_init(&filter, &config));
+
+            uint64_t start = perf_now();
+            for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+            {
+                acc += filter_update(&filter, bench_signal(i));
+            }
+            uint64_t elapsed = perf_now() - start;
+
+            perf_sink(acc);
+            snprintf(name, sizeof(name), "filter %s (N=%u)",
+                     filter_get_type_name((filter_type_t)type), bench_windows[w]);
+            perf_report(name, elapsed, BENCH_SAMPLES);
+
+            // 窗口无关的类型只测一次
+            if (type == FILTER_TYPE_IIR || type == FILTER_TYPE_KALMAN || type == FILTER_TYPE_NONE)
+            {
+                break;
+            }
+        }
+    }
+
+    printf("  [PERF] filter_t RAM per channel: %u bytes\n", (unsigned)sizeof(filter_t));
+}
+
+TEST_CASE(filter_average_matches_legacy)
+{
+    // 运行和结果必须与逐次求和完全一致
+    uint16_t buffer[FILTER_MAX_WINDOW] = {0};
+    uint8_t index = 0, count = 0;
+    filter_t filter;
+    filter_config_t config = {.type = FILTER_TYPE_MOVING_AVERAGE, .window = 8, .param = 0};
+
+    TEST_ASSERT_TRUE(filter_init(&filter, &config));
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        uint16_t sample = bench_signal(i);
+        TEST_ASSERT_EQUAL(bench_legacy_average(buffer, &index, &count, 8, sample),
+                          filter_update(&filter, sample));
+    }
+}
+
+void run_filter_perf_tests(void)
+{
+    printf("\n=== 运行数字滤波器性能测试 ===\n");
+
+    RUN_TEST(filter_legacy_average_cost);
+    RUN_TEST(filter_update_cost_by_type);
+    RUN_TEST(filter_average_matches_legacy);
+
+    printf("数字滤波器性能测试用例已添加完成\n");
+}
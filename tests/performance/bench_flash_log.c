@@ -0,0 +1,248 @@
+/**
+ * @file bench_flash_log.c
+ * @brief 日志结构Flash记录存储性能测试 (主机NOR模拟器)
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * - 追加吞吐 (records/s) 与每条记录的Flash操作数
+ * - 长时间循环写入后各扇区擦除次数分布 (轮转磨损均衡)
+ * - 挂载 (掉电恢复) 耗时
+ * - 写回缓存合并编程: 每条记录的编程次数与CPU耗时对比直接写入
+ * - 时间区间查询 (扇区摘要+记录二分) 对比顺序扫描
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/flash.h"
+#include "../../inc/flash_log.h"
+#include "../../inc/storage.h"
+#include "perf_counter.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_RECORDS 20000
+#define BENCH_SECTORS (STORAGE_REGION_SIZE / STORAGE_SECTOR_SIZE)
+#define BENCH_CACHE_SIZE 144
+
+static flash_log_t bench_log;
+static uint8_t bench_cache[BENCH_CACHE_SIZE];
+
+TEST_CASE(flash_log_append_throughput)
+{
+    storage_sensor_record_t record = {0};
+    flash_stats_t stats;
+    uint64_t start, elapsed;
+
+    flash_sim_reset();
+    TEST_ASSERT_TRUE(flash_log_mount(&bench_log, STORAGE_HISTORY_ADDR, STORAGE_SECTOR_SIZE, BENCH_SECTORS));
+    flash_reset_stats();
+
+    start = perf_now();
+    for (uint32_t i = 0; i < BENCH_RECORDS; i++)
+    {
+        record.temperature = (int16_t)i;
+        flash_log_append(&bench_log, STORAGE_TYPE_SENSOR, i, &record, sizeof(record));
+    }
+    elapsed = perf_now() - start;
+    flash_get_stats(&stats);
+
+    perf_report("flash_log_append (22B record)", elapsed, BENCH_RECORDS);
+    printf("  [PERF] %-36s %10.0f\n", "records/s (host)", BENCH_RECORDS * 1e9 / (double)elapsed);
+    printf("  [PERF] %-36s %10.2f\n", "program ops / record", (double)stats.program_count / BENCH_RECORDS);
+    printf("  [PERF] %-36s %10.2f\n", "programmed bytes / record", (double)stats.program_bytes / BENCH_RECORDS);
+    printf("  [PERF] %-36s %10.2f\n", "page erases / 1000 records", 1000.0 * stats.erase_count / BENCH_RECORDS);
+    printf("  [PERF] %-36s %10lu\n", "records kept in 4KB region",
+           (unsigned long)flash_log_count(&bench_log, STORAGE_TYPE_SENSOR));
+
+    TEST_ASSERT_EQUAL(BENCH_RECORDS, bench_log.stats.appends);
+    TEST_ASSERT_EQUAL(0, bench_log.stats.write_errors);
+}
+
+TEST_CASE(flash_log_wear_distribution)
+{
+    uint32_t min_erase = 0xFFFFFFFFUL, max_erase = 0;
+
+    // 接续上一用例的写入状态
+    printf("  [PERF] %-8s %12s %12s\n", "sector", "header", "simulator");
+    for (uint16_t sector = 0; sector < BENCH_SECTORS; sector++)
+    {
+        uint32_t count = flash_log_get_erase_count(&bench_log, sector);
+        uint32_t actual = flash_sim_get_page_erase_count(STORAGE_HISTORY_ADDR + sector * STORAGE_SECTOR_SIZE);
+        printf("  [PERF] %-8d %12lu %12lu\n", sector, (unsigned long)count, (unsigned long)actual);
+
+        min_erase = actual < min_erase ? actual : min_erase;
+        max_erase = actual > max_erase ? actual : max_erase;
+        TEST_ASSERT_EQUAL(actual, count);
+    }
+    printf("  [PERF] %-36s %10lu\n", "erase spread (max - min)", (unsigned long)(max_erase - min_erase));
+
+    TEST_ASSERT_TRUE(max_erase - min_erase <= 1);
+}
+
+TEST_CASE(flash_log_mount_time)
+{
+    uint64_t start, elapsed;
+
+    start = perf_now();
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        flash_log_mount(&bench_log, STORAGE_HISTORY_ADDR, STORAGE_SECTOR_SIZE, BENCH_SECTORS);
+    }
+    elapsed = perf_now() - start;
+    perf_report("flash_log_mount (8 sectors)", elapsed, 1000);
+
+    TEST_ASSERT_TRUE(bench_log.mounted);
+}
+
+TEST_CASE(flash_log_cached_append_throughput)
+{
+    storage_sensor_record_t record = {0};
+    flash_stats_t direct, cached;
+    uint64_t start, direct_elapsed, cached_elapsed;
+
+    // 直接写入 (基准)
+    flash_sim_reset();
+    memset(&bench_log, 0, sizeof(bench_log));
+    TEST_ASSERT_TRUE(flash_log_mount(&bench_log, STORAGE_HISTORY_ADDR, STORAGE_SECTOR_SIZE, BENCH_SECTORS));
+    flash_reset_stats();
+    start = perf_now();
+    for (uint32_t i = 0; i < BENCH_RECORDS; i++)
+    {
+        record.temperature = (int16_t)i;
+        flash_log_append(&bench_log, STORAGE_TYPE_SENSOR, i, &record, sizeof(record));
+    }
+    direct_elapsed = perf_now() - start;
+    flash_get_stats(&direct);
+
+    // 经写回缓存合并编程
+    flash_sim_reset();
+    memset(&bench_log, 0, sizeof(bench_log));
+    TEST_ASSERT_TRUE(flash_log_mount(&bench_log, STORAGE_HISTORY_ADDR, STORAGE_SECTOR_SIZE, BENCH_SECTORS));
+    flash_log_set_cache(&bench_log, bench_cache, sizeof(bench_cache));
+    flash_reset_stats();
+    start = perf_now();
+    for (uint32_t i = 0; i < BENCH_RECORDS; i++)
+    {
+        record.temperature = (int16_t)i;
+        flash_log_append(&bench_log, STORAGE_TYPE_SENSOR, i, &record, sizeof(record));
+    }
+    TEST_ASSERT_TRUE(flash_log_flush(&bench_log));
+    cached_elapsed = perf_now() - start;
+    flash_get_stats(&cached);
+
+    perf_report("flash_log_append (direct)", direct_elapsed, BENCH_RECORDS);
+    perf_report("flash_log_append (144B write-back)", cached_elapsed, BENCH_RECORDS);
+    printf("  [PERF] %-36s %10.2f -> %.2f\n", "program ops / record",
+           (double)direct.program_count / BENCH_RECORDS, (double)cached.program_count / BENCH_RECORDS);
+    printf("  [PERF] %-36s %10.2f -> %.2f\n", "page erases / 1000 records",
+           1000.0 * direct.erase_count / BENCH_RECORDS, 1000.0 * cached.erase_count / BENCH_RECORDS);
+    printf("  [PERF] %-36s %10.2f\n", "program op reduction (x)",
+           (double)direct.program_count / (double)cached.program_count);
+
+    TEST_ASSERT_EQUAL(0, bench_log.stats.write_errors);
+    TEST_ASSERT_TRUE(cached.program_count * 3 < direct.program_count);
+    flash_log_set_cache(&bench_log, NULL, 0);
+}
+
+static bool bench_query_visit(const flash_log_entry_t *entry, const void *data, void *context)
+{
+    (void)entry;
+    (void)data;
+    (*(uint32_t *)context)++;
+    return true;
+}
+
+/**
+ * @brief 顺序扫描基准: 从最旧记录逐条比较时间戳
+ */
+static uint32_t bench_linear_query(uint32_t start_time, uint32_t end_time)
+{
+    flash_log_cursor_t cursor;
+    flash_log_entry_t entry;
+    uint8_t data[FLASH_LOG_QUERY_DATA];
+    uint32_t count = 0;
+
+    flash_log_rewind(&bench_log, &cursor);
+    while (flash_log_next(&bench_log, &cursor, &entry, data, sizeof(data)))
+    {
+        if (entry.timestamp > end_time)
+        {
+            break;
+        }
+        if (entry.timestamp >= start_time && entry.type == STORAGE_TYPE_SENSOR)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+TEST_CASE(flash_log_range_query_latency)
+{
+    storage_sensor_record_t record = {0};
+    flash_stats_t stats;
+    uint64_t start, elapsed;
+    uint32_t visited = 0, expected = 0;
+
+    // 写满整个历史区 (循环覆盖后)
+    flash_sim_reset();
+    memset(&bench_log, 0, sizeof(bench_log));
+    TEST_ASSERT_TRUE(flash_log_mount(&bench_log, STORAGE_HISTORY_ADDR, STORAGE_SECTOR_SIZE, BENCH_SECTORS));
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        record.temperature = (int16_t)i;
+        flash_log_append(&bench_log, STORAGE_TYPE_SENSOR, i * 1000, &record, sizeof(record));
+    }
+    uint32_t kept = flash_log_count(&bench_log, STORAGE_TYPE_SENSOR);
+    uint32_t oldest = 2000 - kept;
+    printf("  [PERF] %-36s %10lu\n", "records in region", (unsigned long)kept);
+
+    // 查询10条记录的窗口: 最旧端、中间、最新端
+    const uint32_t positions[3] = {oldest, oldest + kept / 2, 2000 - 10};
+    const char *names[3] = {"oldest", "middle", "newest"};
+    for (uint8_t p = 0; p < 3; p++)
+    {
+        uint32_t start_time = positions[p] * 1000, end_time = (positions[p] + 9) * 1000;
+        char label[48];
+
+        flash_reset_stats();
+        start = perf_now();
+        for (uint32_t i = 0; i < 200; i++)
+        {
+            visited = 0;
+            flash_log_query(&bench_log, STORAGE_TYPE_SENSOR, start_time, end_time, bench_query_visit, &visited);
+        }
+        elapsed = perf_now() - start;
+        flash_get_stats(&stats);
+        snprintf(label, sizeof(label), "range query (%s, 10 rec)", names[p]);
+        perf_report(label, elapsed, 200);
+        printf("  [PERF] %-36s %10.1f\n", "  flash reads / query", stats.read_count / 200.0);
+
+        flash_reset_stats();
+        start = perf_now();
+        for (uint32_t i = 0; i < 200; i++)
+        {
+            expected = bench_linear_query(start_time, end_time);
+        }
+        elapsed = perf_now() - start;
+        flash_get_stats(&stats);
+        snprintf(label, sizeof(label), "linear scan (%s, 10 rec)", names[p]);
+        perf_report(label, elapsed, 200);
+        printf("  [PERF] %-36s %10.1f\n", "  flash reads / query", stats.read_count / 200.0);
+
+        TEST_ASSERT_EQUAL(10, visited);
+        TEST_ASSERT_EQUAL(expected, visited);
+    }
+}
+
+void run_flash_log_perf_tests(void)
+{
+    printf("\n=== 运行Flash日志存储性能测试 ===\n");
+
+    RUN_TEST(flash_log_append_throughput);
+    RUN_TEST(flash_log_wear_distribution);
+    RUN_TEST(flash_log_mount_time);
+    RUN_TEST(flash_log_cached_append_throughput);
+    RUN_TEST(flash_log_range_query_latency);
+
+    printf("Flash日志存储性能测试用例已添加完成\n");
+}
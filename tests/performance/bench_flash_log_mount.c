@@ -0,0 +1,121 @@
+/**
+ * @file bench_flash_log_mount.c
+ * @brief 记录日志挂载 (启动恢复) 性能测试 (主机NOR模拟器)
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 以不同扇区数写满并回绕一遍日志后重新挂载，对比:
+ * - 全扫描: 读取全部扇区头，再逐条扫描写入头所在扇区与全部有效记录的摘要
+ * - 检查点: 读取检查点页找到最新检查点，只校验写入头/最旧扇区并扫描检查点之后的记录
+ * 检查点挂载的Flash读取次数与扇区数无关
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/flash.h"
+#include "../../inc/flash_log.h"
+#include "perf_counter.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_LOG_BASE 0x00000000UL
+#define BENCH_CHECKPOINT_PAGES 2
+#define BENCH_RECORD_TYPE 0x02
+#define BENCH_RECORD_SIZE 18
+#define BENCH_TAIL_RECORDS 5 // 最后一个检查点之后追加的记录数
+#define BENCH_MOUNT_ROUNDS 20
+
+static const uint16_t bench_sector_counts[] = {8, 16, 32, 64 - BENCH_CHECKPOINT_PAGES - 2};
+
+static flash_log_t bench_log;
+
+/**
+ * @brief 重新挂载并统计Flash读取次数
+ * @param elapsed 输出主机耗时 (ns，BENCH_MOUNT_ROUNDS次合计)
+ * @param reads 输出最后一次挂载的Flash读取次数
+ * @return true: 每次都挂载成功且按预期使用 (或不使用) 检查点
+ */
+static bool bench_mount(uint16_t sectors, bool checkpoint, uint64_t *elapsed, uint32_t *reads)
+{
+    flash_stats_t stats;
+    uint64_t start = perf_now();
+
+    for (uint32_t round = 0; round < BENCH_MOUNT_ROUNDS; round++)
+    {
+        memset(&bench_log, 0, sizeof(bench_log));
+        if (checkpoint)
+        {
+            flash_log_set_checkpoint(&bench_log, BENCH_LOG_BASE + (uint32_t)sectors * FLASH_PAGE_SIZE,
+                                     BENCH_CHECKPOINT_PAGES);
+        }
+        flash_reset_stats();
+        if (!flash_log_mount(&bench_log, BENCH_LOG_BASE, FLASH_PAGE_SIZE, sectors) ||
+            bench_log.checkpoint_mounted != checkpoint)
+        {
+            return false;
+        }
+    }
+    *elapsed = perf_now() - start;
+
+    flash_get_stats(&stats);
+    *reads = stats.read_count;
+    return true;
+}
+
+TEST_CASE(flash_log_mount_scaling)
+{
+    uint8_t record[BENCH_RECORD_SIZE];
+    uint32_t full_reads[4], fast_reads[4];
+    char label[48];
+
+    memset(record, 0x5A, sizeof(record));
+    for (uint8_t i = 0; i < sizeof(bench_sector_counts) / sizeof(bench_sector_counts[0]); i++)
+    {
+        uint16_t sectors = bench_sector_counts[i];
+
+        // 写满并回绕一遍，最后一个检查点之后再追加几条
+        flash_sim_reset();
+        memset(&bench_log, 0, sizeof(bench_log));
+        flash_log_set_checkpoint(&bench_log, BENCH_LOG_BASE + (uint32_t)sectors * FLASH_PAGE_SIZE,
+                                 BENCH_CHECKPOINT_PAGES);
+        TEST_ASSERT_TRUE(flash_log_mount(&bench_log, BENCH_LOG_BASE, FLASH_PAGE_SIZE, sectors));
+        uint32_t target = bench_log.stats.checkpoints + sectors + 1;
+        uint32_t count = 0;
+        while (bench_log.stats.checkpoints < target)
+        {
+            TEST_ASSERT_TRUE(flash_log_append(&bench_log, BENCH_RECORD_TYPE, count++, record, sizeof(record)));
+        }
+        for (uint32_t n = 0; n < BENCH_TAIL_RECORDS; n++)
+        {
+            TEST_ASSERT_TRUE(flash_log_append(&bench_log, BENCH_RECORD_TYPE, count++, record, sizeof(record)));
+        }
+        uint32_t kept = flash_log_count(&bench_log, BENCH_RECORD_TYPE);
+
+        uint64_t full_ns, fast_ns;
+        TEST_ASSERT_TRUE(bench_mount(sectors, false, &full_ns, &full_reads[i]));
+        TEST_ASSERT_EQUAL(kept, flash_log_count(&bench_log, BENCH_RECORD_TYPE));
+        TEST_ASSERT_TRUE(bench_mount(sectors, true, &fast_ns, &fast_reads[i]));
+        TEST_ASSERT_EQUAL(kept, flash_log_count(&bench_log, BENCH_RECORD_TYPE));
+        TEST_ASSERT_EQUAL(count, bench_log.next_sequence);
+
+        snprintf(label, sizeof(label), "mount %u sectors, full scan", (unsigned)sectors);
+        perf_report(label, full_ns, BENCH_MOUNT_ROUNDS);
+        snprintf(label, sizeof(label), "mount %u sectors, checkpoint", (unsigned)sectors);
+        perf_report(label, fast_ns, BENCH_MOUNT_ROUNDS);
+        printf("  [PERF] %-36s %10lu -> %lu\n", "flash reads per mount", (unsigned long)full_reads[i],
+               (unsigned long)fast_reads[i]);
+    }
+
+    // 全扫描随扇区数增长，检查点挂载只差检查点槽位二分查找的一两次读取
+    TEST_ASSERT_TRUE(full_reads[3] > 4 * full_reads[0]);
+    TEST_ASSERT_TRUE(fast_reads[3] <= fast_reads[0] + 2 && fast_reads[0] <= fast_reads[3] + 2);
+    TEST_ASSERT_TRUE(fast_reads[0] < full_reads[0]);
+}
+
+void run_flash_log_mount_perf_tests(void)
+{
+    printf("\n=== 运行记录日志挂载性能测试 ===\n");
+
+    RUN_TEST(flash_log_mount_scaling);
+
+    printf("记录日志挂载性能测试用例已添加完成\n");
+}
@@ -0,0 +1,182 @@
+/**
+ * @file bench_history_codec.c
+ * @brief 传感器历史数据块压缩编码性能测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 以60s采样周期 (含±50ms抖动) 回放7天现场曲线 (温度/湿度日变化 + 量化噪声，
+ * 电压每6小时跌落一次)，编码为144B数据块，对比:
+ * - 原方案: 每个采样一条日志记录 (记录头 + 传感器记录)
+ * - 压缩方案: 每块一条日志记录
+ * 统计每采样字节数、压缩比、4KB历史区可保存的采样数及编解码耗时
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/history_codec.h"
+#include "../../inc/flash_log.h"
+#include "../../inc/storage.h"
+#include "perf_counter.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define BENCH_SAMPLES (7 * 1440)
+#define BENCH_BLOCK_SIZE STORAGE_BLOCK_SIZE
+#define BENCH_MAX_BLOCKS 640
+#define BENCH_PI 3.14159265358979
+
+static uint32_t bench_lfsr = 0xACE1u;
+static history_sample_t bench_trace[BENCH_SAMPLES];
+static uint8_t bench_blocks[BENCH_MAX_BLOCKS][BENCH_BLOCK_SIZE];
+static uint16_t bench_lengths[BENCH_MAX_BLOCKS];
+static uint16_t bench_block_count;
+
+/**
+ * @brief 均匀噪声 [-amplitude, amplitude]
+ */
+static double bench_noise(double amplitude)
+{
+    bench_lfsr = (bench_lfsr >> 1) ^ (-(bench_lfsr & 1u) & 0xB400u);
+    return ((double)(bench_lfsr & 0x3FF) / 1023.0 - 0.5) * 2.0 * amplitude;
+}
+
+/**
+ * @brief 生成现场曲线 (按传感器记录的定点单位量化)
+ */
+static void bench_make_trace(void)
+{
+    uint32_t timestamp = 0;
+
+    bench_lfsr = 0xACE1u;
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        double phase = 2.0 * BENCH_PI * (double)(i % 1440) / 1440.0;
+        double temperature = 24.0 + 2.5 * sin(phase) + bench_noise(0.15);
+        double humidity = 55.0 - 6.0 * sin(phase) + bench_noise(0.3);
+        double voltage = ((i % 360) == 0 ? 3.00 : 3.30) + bench_noise(0.01);
+
+        timestamp += 60000 + (int32_t)bench_noise(50.0);
+        bench_trace[i].timestamp = timestamp;
+        bench_trace[i].temperature = (int16_t)lround(temperature * 10.0);
+        bench_trace[i].humidity = (uint16_t)lround(humidity * 10.0);
+        bench_trace[i].voltage = (uint16_t)lround(voltage * 1000.0);
+        bench_trace[i].status = (i % 360) == 0 ? 1 : 0;
+    }
+}
+
+/**
+ * @brief 编码整条曲线为数据块
+ */
+static void bench_encode_trace(void)
+{
+    history_encoder_t encoder;
+
+    bench_block_count = 0;
+    history_encoder_init(&encoder, bench_blocks[0], BENCH_BLOCK_SIZE);
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        if (!history_encoder_add(&encoder, &bench_trace[i]) && bench_block_count + 1 < BENCH_MAX_BLOCKS)
+        {
+            bench_lengths[bench_block_count++] = history_encoder_length(&encoder);
+            history_encoder_init(&encoder, bench_blocks[bench_block_count], BENCH_BLOCK_SIZE);
+            history_encoder_add(&encoder, &bench_trace[i]);
+        }
+    }
+    bench_lengths[bench_block_count++] = history_encoder_length(&encoder);
+}
+
+TEST_CASE(history_codec_field_trace_ratio)
+{
+    uint32_t encoded_bytes = 0;
+
+    bench_make_trace();
+    bench_encode_trace();
+    for (uint16_t b = 0; b < bench_block_count; b++)
+    {
+        encoded_bytes += bench_lengths[b];
+    }
+
+    // Flash占用: 每条日志记录另有记录头
+    uint32_t raw_flash = BENCH_SAMPLES * (sizeof(flash_log_entry_t) + sizeof(storage_sensor_record_t));
+    uint32_t block_flash = encoded_bytes + bench_block_count * sizeof(flash_log_entry_t);
+    uint32_t raw_per_sector = (STORAGE_SECTOR_SIZE - sizeof(flash_log_sector_t)) /
+                              (sizeof(flash_log_entry_t) + sizeof(storage_sensor_record_t));
+    uint32_t blocks_per_sector = (STORAGE_SECTOR_SIZE - sizeof(flash_log_sector_t)) /
+                                 (sizeof(flash_log_entry_t) + BENCH_BLOCK_SIZE);
+
+    printf("  [PERF] %-36s %10lu\n", "samples (7 days @ 60s)", (unsigned long)BENCH_SAMPLES);
+    printf("  [PERF] %-36s %10lu\n", "blocks", (unsigned long)bench_block_count);
+    printf("  [PERF] %-36s %10.2f\n", "samples / block", (double)BENCH_SAMPLES / bench_block_count);
+    printf("  [PERF] %-36s %10.2f\n", "encoded bytes / sample", (double)encoded_bytes / BENCH_SAMPLES);
+    printf("  [PERF] %-36s %10.2f -> %.2f\n", "flash bytes / sample",
+           (double)raw_flash / BENCH_SAMPLES, (double)block_flash / BENCH_SAMPLES);
+    printf("  [PERF] %-36s %10.2f\n", "compression ratio (x)", (double)raw_flash / (double)block_flash);
+    printf("  [PERF] %-36s %10lu -> %lu\n", "samples kept in 4KB region (est.)",
+           (unsigned long)(raw_per_sector * (STORAGE_REGION_SIZE / STORAGE_SECTOR_SIZE - 1)),
+           (unsigned long)(blocks_per_sector * (STORAGE_REGION_SIZE / STORAGE_SECTOR_SIZE - 1) *
+                           BENCH_SAMPLES / bench_block_count));
+
+    TEST_ASSERT_TRUE(raw_flash > block_flash * 4);
+}
+
+TEST_CASE(history_codec_encode_decode_speed)
+{
+    history_decoder_t decoder;
+    history_sample_t sample;
+    uint64_t start, elapsed;
+    uint32_t decoded = 0, mismatches = 0;
+
+    start = perf_now();
+    for (uint8_t round = 0; round < 10; round++)
+    {
+        bench_encode_trace();
+    }
+    elapsed = perf_now() - start;
+    perf_report("history_encoder_add", elapsed, 10UL * BENCH_SAMPLES);
+
+    start = perf_now();
+    for (uint8_t round = 0; round < 10; round++)
+    {
+        decoded = 0;
+        for (uint16_t b = 0; b < bench_block_count; b++)
+        {
+            history_decoder_init(&decoder, bench_blocks[b], bench_lengths[b]);
+            while (history_decoder_next(&decoder, &sample))
+            {
+                decoded++;
+            }
+        }
+    }
+    elapsed = perf_now() - start;
+    perf_report("history_decoder_next", elapsed, 10UL * BENCH_SAMPLES);
+
+    // 无损: 逐采样比对原曲线
+    decoded = 0;
+    for (uint16_t b = 0; b < bench_block_count; b++)
+    {
+        history_decoder_init(&decoder, bench_blocks[b], bench_lengths[b]);
+        while (history_decoder_next(&decoder, &sample))
+        {
+            const history_sample_t *expected = &bench_trace[decoded++];
+            if (sample.timestamp != expected->timestamp || sample.temperature != expected->temperature ||
+                sample.humidity != expected->humidity || sample.voltage != expected->voltage ||
+                sample.status != expected->status)
+            {
+                mismatches++;
+            }
+        }
+    }
+
+    TEST_ASSERT_EQUAL(BENCH_SAMPLES, decoded);
+    TEST_ASSERT_EQUAL(0, mismatches);
+}
+
+void run_history_codec_perf_tests(void)
+{
+    printf("\n=== 运行历史数据压缩编码性能测试 ===\n");
+
+    RUN_TEST(history_codec_field_trace_ratio);
+    RUN_TEST(history_codec_encode_decode_speed);
+
+    printf("历史数据压缩编码性能测试用例已添加完成\n");
+}
@@ -0,0 +1,270 @@
+/**
+ * @file bench_mqtt.c
+ * @brief MQTT发布吞吐与单报文开销的性能测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 传输层替身只计数并对QoS1应答PUBACK，测量的是客户端编码/发送/应答处理本身的开销:
+ * - QoS0/QoS1发布 (QoS1含mqtt_task处理PUBACK)
+ * - 零拷贝 (载荷直接编码进发送缓冲区) 与先编码到临时缓冲区再发布的对比
+ * - 流式解析: 64字节分片输入的PUBLISH报文
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/mqtt.h"
+#include "../../inc/mqtt_codec.h"
+#include "perf_counter.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_MESSAGES 20000
+#define BENCH_PAYLOAD 64
+#define BENCH_TOPIC "dtu/0001/data"
+
+/**
+ * @brief 传输层替身: 计数，并为QoS1发布排队PUBACK
+ */
+typedef struct
+{
+    uint32_t packets;
+    uint32_t bytes;
+    uint8_t acks[64];
+    uint16_t ack_length;
+} bench_link_t;
+
+static bench_link_t bench_link;
+
+static int bench_open(const char *host, uint16_t port, void *context)
+{
+    (void)host;
+    (void)port;
+    (void)context;
+
+    // 连接即应答CONNACK
+    bench_link.acks[0] = MQTT_CONNACK << 4;
+    bench_link.acks[1] = 2;
+    bench_link.acks[2] = 0;
+    bench_link.acks[3] = 0;
+    bench_link.ack_length = 4;
+    return MQTT_SUCCESS;
+}
+
+static int bench_send(const uint8_t *data, uint16_t length, void *context)
+{
+    (void)context;
+    bench_link.packets++;
+    bench_link.bytes += length;
+
+    // QoS1 PUBLISH: 报文ID位于主题之后 (主题与载荷长度固定)
+    if (data[0] == ((MQTT_PUBLISH << 4) | (MQTT_QOS_1 << 1)) && (size_t)bench_link.ack_length + 4u <= sizeof(bench_link.acks))
+    {
+        const uint8_t *id = data + length - BENCH_PAYLOAD - 2;
+        uint8_t *ack = bench_link.acks + bench_link.ack_length;
+        ack[0] = MQTT_PUBACK << 4;
+        ack[1] = 2;
+        ack[2] = id[0];
+        ack[3] = id[1];
+        bench_link.ack_length = (uint16_t)(bench_link.ack_length + 4);
+    }
+    return MQTT_SUCCESS;
+}
+
+static int bench_receive(uint8_t *buffer, uint16_t size, void *context)
+{
+    uint16_t length = bench_link.ack_length;
+
+    (void)context;
+    if (length > size)
+    {
+        length = size;
+    }
+    memcpy(buffer, bench_link.acks, length);
+    memmove(bench_link.acks, bench_link.acks + length, bench_link.ack_length - length);
+    bench_link.ack_length = (uint16_t)(bench_link.ack_length - length);
+    return length;
+}
+
+static void bench_close(void *context)
+{
+    (void)context;
+}
+
+static const mqtt_transport_t bench_transport = {bench_open, bench_send, bench_receive, bench_close, NULL};
+
+static uint32_t bench_acked;
+
+static void bench_event(const mqtt_event_t *event)
+{
+    if (event->event == MQTT_EVENT_MESSAGE_SENT)
+    {
+        bench_acked++;
+    }
+}
+
+static void bench_connect(void)
+{
+    mqtt_config_t config;
+
+    memset(&config, 0, sizeof(config));
+    strcpy(config.broker_host, "bench");
+    config.broker_port = 1883;
+    strcpy(config.client_id, "dtu-0001");
+    config.keep_alive = 60;
+    config.clean_session = true;
+
+    memset(&bench_link, 0, sizeof(bench_link));
+    bench_acked = 0;
+    mqtt_deinit();
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_set_transport(&bench_transport));
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_init(&config));
+    mqtt_set_event_callback(bench_event);
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_connect());
+    mqtt_task();
+    TEST_ASSERT_TRUE(mqtt_is_connected());
+    bench_link.packets = 0;
+    bench_link.bytes = 0;
+}
+
+static void bench_disconnect(void)
+{
+    mqtt_deinit();
+    mqtt_set_transport(NULL);
+}
+
+static void bench_throughput(const char *name, uint64_t elapsed, uint32_t messages)
+{
+    perf_report(name, elapsed, messages);
+#if !(defined(__arm__) && !defined(__linux__))
+    if (elapsed > 0)
+    {
+        printf("  [PERF]   -> %lu msg/s, %lu KB/s on the wire\n",
+               (unsigned long)((uint64_t)messages * 1000000000ULL / elapsed),
+               (unsigned long)((uint64_t)bench_link.bytes * 1000000000ULL / elapsed / 1024));
+    }
+#endif
+}
+
+TEST_CASE(mqtt_publish_throughput)
+{
+    uint8_t payload[BENCH_PAYLOAD];
+    uint64_t start;
+
+    memset(payload, 'x', sizeof(payload));
+
+    bench_connect();
+    start = perf_now();
+    for (uint32_t n = 0; n < BENCH_MESSAGES; n++)
+    {
+        mqtt_publish(BENCH_TOPIC, payload, sizeof(payload), MQTT_QOS_0, false);
+    }
+    bench_throughput("publish QoS0 64B", perf_now() - start, BENCH_MESSAGES);
+    TEST_ASSERT_EQUAL(BENCH_MESSAGES, bench_link.packets);
+    printf("  [PERF]   -> %u B per message (%u B header)\n", (unsigned)(bench_link.bytes / BENCH_MESSAGES),
+           (unsigned)(bench_link.bytes / BENCH_MESSAGES - BENCH_PAYLOAD));
+
+    // QoS1: 每条发布后处理PUBACK
+    bench_link.bytes = 0;
+    start = perf_now();
+    for (uint32_t n = 0; n < BENCH_MESSAGES; n++)
+    {
+        mqtt_publish(BENCH_TOPIC, payload, sizeof(payload), MQTT_QOS_1, false);
+        mqtt_task();
+    }
+    bench_throughput("publish QoS1 64B + PUBACK", perf_now() - start, BENCH_MESSAGES);
+    TEST_ASSERT_EQUAL(BENCH_MESSAGES, bench_acked);
+
+    bench_disconnect();
+}
+
+TEST_CASE(mqtt_publish_zero_copy)
+{
+    mqtt_sensor_data_t data = {25.3f, 61.2f, 12.05f, 1.25f, 15.06f};
+    char json[128];
+    uint64_t start;
+    uint32_t sink = 0;
+
+    bench_connect();
+
+    // 先编码到临时缓冲区，再由mqtt_publish拷入发送缓冲区
+    start = perf_now();
+    for (uint32_t n = 0; n < BENCH_MESSAGES; n++)
+    {
+        int length = mqtt_encode_sensor_data(json, sizeof(json), &data);
+        sink += (uint32_t)mqtt_publish(BENCH_TOPIC, json, (uint16_t)length, MQTT_QOS_0, false);
+    }
+    perf_report("JSON to temp buffer + mqtt_publish()", perf_now() - start, BENCH_MESSAGES);
+
+    // 直接编码到发送缓冲区
+    start = perf_now();
+    for (uint32_t n = 0; n < BENCH_MESSAGES; n++)
+    {
+        uint16_t capacity;
+        uint8_t *payload = mqtt_publish_begin(BENCH_TOPIC, MQTT_QOS_0, false, &capacity);
+        int length = mqtt_encode_sensor_data((char *)payload, capacity, &data);
+        sink += (uint32_t)mqtt_publish_commit((uint16_t)length);
+    }
+    perf_report("JSON in place + mqtt_publish_commit()", perf_now() - start, BENCH_MESSAGES);
+    perf_sink(sink);
+    TEST_ASSERT_EQUAL(2 * BENCH_MESSAGES, bench_link.packets);
+
+    bench_disconnect();
+}
+
+TEST_CASE(mqtt_parser_cost)
+{
+    static uint8_t stream[(BENCH_PAYLOAD + 32) * 64];
+    uint8_t body[MQTT_RX_BUFFER_SIZE];
+    uint8_t buffer[BENCH_PAYLOAD + 32];
+    mqtt_parser_t parser;
+    mqtt_codec_packet_t packet;
+    mqtt_publish_frame_t frame;
+    uint16_t length = 0;
+    uint32_t packets = 0;
+    uint64_t start;
+
+    // 64条QoS1 PUBLISH首尾相接
+    for (uint16_t n = 0; n < 64; n++)
+    {
+        uint8_t *start_of_packet;
+        mqtt_codec_publish_begin(&frame, buffer, sizeof(buffer), BENCH_TOPIC, MQTT_QOS_1, false, (uint16_t)(n + 1));
+        memset(frame.payload, 'y', BENCH_PAYLOAD);
+        uint16_t size = mqtt_codec_publish_end(&frame, BENCH_PAYLOAD, &start_of_packet);
+        memcpy(stream + length, start_of_packet, size);
+        length = (uint16_t)(length + size);
+    }
+
+    mqtt_parser_init(&parser, body, sizeof(body));
+    start = perf_now();
+    for (uint32_t round = 0; round < BENCH_MESSAGES / 64; round++)
+    {
+        for (uint16_t offset = 0; offset < length; offset = (uint16_t)(offset + MQTT_RX_CHUNK))
+        {
+            uint16_t chunk = (uint16_t)((length - offset < MQTT_RX_CHUNK) ? length - offset : MQTT_RX_CHUNK);
+            uint16_t used = 0;
+
+            while (used < chunk)
+            {
+                uint16_t consumed;
+                if (mqtt_parser_feed(&parser, stream + offset + used, (uint16_t)(chunk - used), &consumed, &packet) ==
+                    MQTT_CODEC_PACKET)
+                {
+                    packets++;
+                }
+                used = (uint16_t)(used + consumed);
+            }
+        }
+    }
+    perf_report("parse PUBLISH 64B (64B chunks)", perf_now() - start, packets);
+    TEST_ASSERT_EQUAL((BENCH_MESSAGES / 64) * 64, packets);
+}
+
+void run_mqtt_perf_tests(void)
+{
+    printf("\n=== 运行MQTT性能测试 ===\n");
+
+    RUN_TEST(mqtt_publish_throughput);
+    RUN_TEST(mqtt_publish_zero_copy);
+    RUN_TEST(mqtt_parser_cost);
+
+    printf("MQTT性能测试用例已添加完成\n");
+}
@@ -0,0 +1,275 @@
+/**
+ * @file bench_mqtt_queue.c
+ * @brief MQTT QoS1离线发布队列的性能测试 (模拟24小时断线)
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 断线24小时期间按固定周期产生24字节采样，随后重连排放积压:
+ * - 容量: 每分钟一条共1440条、载荷约34KB，超过全部存储分区 (20KB)，只能保留最新部分；
+ *   消息打包写入Flash后4KB溢出区约保留2小时，约每12分钟一条时可保留完整24小时
+ * - 积压占用: 队列RAM占用、RAM环峰值、Flash溢出区已用字节、保留/丢弃的消息数
+ * - 排放: 默认节奏下的排放时长与吞吐 (模拟时间)，排放期间每秒一条实时消息的发送情况
+ * - 开销: 离线入队 (含溢出到Flash) 与不限速排放的单条耗时
+ * 传输层替身只计数并应答PUBACK
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/flash.h"
+#include "../../inc/mqtt.h"
+#include "../../inc/mqtt_queue.h"
+#include "../../inc/system.h"
+#include "perf_counter.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_TOPIC "dtu/0001/data"
+#define BENCH_PAYLOAD 24
+#define BENCH_OUTAGE_MS (24UL * 3600UL * 1000UL)
+#define BENCH_STEP_MS 10
+#define BENCH_LIVE_MS 1000 // 排放期间实时消息周期
+#define BENCH_RETAINED_MIN 120 // 每分钟一条时至少保留的消息数 (约7个扇区 x 16条 + RAM环)
+
+/**
+ * @brief 传输层替身: 计数，并为QoS1发布 (含DUP重发) 排队PUBACK
+ */
+typedef struct
+{
+    uint32_t packets;
+    uint32_t bytes;
+    uint8_t acks[64];
+    uint16_t ack_length;
+} bench_link_t;
+
+static bench_link_t bench_link;
+
+static int bench_open(const char *host, uint16_t port, void *context)
+{
+    (void)host;
+    (void)port;
+    (void)context;
+
+    bench_link.acks[0] = MQTT_CONNACK << 4;
+    bench_link.acks[1] = 2;
+    bench_link.acks[2] = 0;
+    bench_link.acks[3] = 0;
+    bench_link.ack_length = 4;
+    return MQTT_SUCCESS;
+}
+
+static int bench_send(const uint8_t *data, uint16_t length, void *context)
+{
+    (void)context;
+    bench_link.packets++;
+    bench_link.bytes += length;
+
+    // QoS1 PUBLISH (忽略DUP位): 报文ID位于载荷之前 (载荷长度固定)
+    if ((data[0] & 0xF6) == ((MQTT_PUBLISH << 4) | (MQTT_QOS_1 << 1)) &&
+        (size_t)bench_link.ack_length + 4u <= sizeof(bench_link.acks))
+    {
+        const uint8_t *id = data + length - BENCH_PAYLOAD - 2;
+        uint8_t *ack = bench_link.acks + bench_link.ack_length;
+        ack[0] = MQTT_PUBACK << 4;
+        ack[1] = 2;
+        ack[2] = id[0];
+        ack[3] = id[1];
+        bench_link.ack_length = (uint16_t)(bench_link.ack_length + 4);
+    }
+    return MQTT_SUCCESS;
+}
+
+static int bench_receive(uint8_t *buffer, uint16_t size, void *context)
+{
+    uint16_t length = bench_link.ack_length;
+
+    (void)context;
+    if (length > size)
+    {
+        length = size;
+    }
+    memcpy(buffer, bench_link.acks, length);
+    memmove(bench_link.acks, bench_link.acks + length, bench_link.ack_length - length);
+    bench_link.ack_length = (uint16_t)(bench_link.ack_length - length);
+    return length;
+}
+
+static void bench_close(void *context)
+{
+    (void)context;
+}
+
+static const mqtt_transport_t bench_transport = {bench_open, bench_send, bench_receive, bench_close, NULL};
+
+static void bench_advance(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        system_tick_increment();
+    }
+}
+
+static void bench_setup(const mqtt_queue_config_t *queue)
+{
+    mqtt_config_t config;
+
+    memset(&bench_link, 0, sizeof(bench_link));
+    flash_sim_reset();
+
+    memset(&config, 0, sizeof(config));
+    strcpy(config.broker_host, "bench");
+    strcpy(config.client_id, "dtu-0001");
+    config.broker_port = 1883;
+    config.keep_alive = 600;
+    config.clean_session = true;
+
+    mqtt_deinit();
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_set_transport(&bench_transport));
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_init(&config));
+    mqtt_set_event_callback(mqtt_queue_on_event);
+    TEST_ASSERT_TRUE(mqtt_queue_init(queue));
+    TEST_ASSERT_EQUAL(0, mqtt_queue_add_topic(BENCH_TOPIC));
+}
+
+static void bench_teardown(void)
+{
+    mqtt_deinit();
+    mqtt_set_transport(NULL);
+}
+
+static void bench_publish(uint32_t id)
+{
+    uint8_t payload[BENCH_PAYLOAD];
+
+    memset(payload, 0x5A, sizeof(payload));
+    memcpy(payload, &id, sizeof(id));
+    mqtt_queue_publish(0, payload, sizeof(payload));
+}
+
+/**
+ * @brief 断线24小时按period_ms产生采样，重连后以默认节奏排放 (每秒夹带一条实时消息)
+ * @param period_ms 采样周期
+ * @param messages 输出产生的消息数
+ * @param retained 输出重连时保留的消息数
+ */
+static void bench_outage(uint32_t period_ms, uint32_t *messages, uint32_t *retained)
+{
+    mqtt_queue_stats_t stats;
+    uint32_t produced = 0;
+    uint32_t drain_ms = 0;
+    uint32_t live = 0;
+    uint64_t start;
+
+    bench_setup(NULL);
+    for (uint32_t t = 0; t < BENCH_OUTAGE_MS; t += period_ms)
+    {
+        bench_advance(period_ms);
+        bench_publish(produced++);
+    }
+
+    TEST_ASSERT_TRUE(mqtt_queue_get_stats(&stats));
+    uint32_t backlog = mqtt_queue_pending();
+    *messages = produced;
+    *retained = backlog;
+    printf("  [PERF] 24h outage, 1 sample / %lu s: %lu produced, %lu retained (%u RAM + %lu flash), %lu dropped\n",
+           (unsigned long)(period_ms / 1000), (unsigned long)produced, (unsigned long)backlog,
+           (unsigned)stats.ram_messages, (unsigned long)stats.flash_pending,
+           (unsigned long)(produced - backlog));
+    printf("  [PERF]   -> RAM %u B (ring peak %u/%u B), flash %lu/%lu B; retained span %lu min\n",
+           (unsigned)stats.ram_footprint, (unsigned)stats.ram_peak, (unsigned)MQTT_QUEUE_RAM_SIZE,
+           (unsigned long)stats.flash_used, (unsigned long)MQTT_QUEUE_FLASH_SIZE,
+           (unsigned long)(backlog * (period_ms / 1000) / 60));
+
+    // 重连排放: 积压排空所需的模拟时间，期间实时消息照常发出
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_connect());
+    mqtt_task();
+    TEST_ASSERT_TRUE(mqtt_is_connected());
+    start = perf_now();
+    while (mqtt_queue_get_stats(&stats) && (stats.ram_messages > 0 || stats.flash_pending > 0))
+    {
+        bench_advance(BENCH_STEP_MS);
+        drain_ms += BENCH_STEP_MS;
+        mqtt_task();
+        mqtt_queue_task();
+        if (drain_ms % BENCH_LIVE_MS == 0)
+        {
+            bench_publish(0x80000000UL | live++);
+        }
+        TEST_ASSERT_TRUE(drain_ms < BENCH_OUTAGE_MS);
+    }
+    uint64_t elapsed = perf_now() - start;
+    while (mqtt_queue_pending() > 0 && drain_ms < BENCH_OUTAGE_MS)
+    {
+        bench_advance(BENCH_STEP_MS);
+        drain_ms += BENCH_STEP_MS;
+        mqtt_task();
+        mqtt_queue_task();
+    }
+
+    TEST_ASSERT_TRUE(mqtt_queue_get_stats(&stats));
+    TEST_ASSERT_EQUAL(stats.enqueued, stats.acked + stats.dropped);
+    TEST_ASSERT_EQUAL(live, stats.sent_live);
+    perf_report("drain backlog (per message, incl. task loop)", elapsed, stats.drained);
+    printf("  [PERF]   -> drained %lu in %lu ms simulated (%lu msg/s), %lu live sent immediately, %lu commits\n",
+           (unsigned long)stats.drained, (unsigned long)drain_ms,
+           (unsigned long)(drain_ms ? (uint64_t)stats.drained * 1000 / drain_ms : 0), (unsigned long)stats.sent_live,
+           (unsigned long)stats.commits);
+
+    bench_teardown();
+}
+
+TEST_CASE(mqtt_queue_outage_24h)
+{
+    uint32_t produced, retained;
+
+    // 每分钟一条: 超出队列容量，保留最新部分
+    bench_outage(60000, &produced, &retained);
+    TEST_ASSERT_EQUAL(1440, produced);
+    TEST_ASSERT_TRUE(retained >= BENCH_RETAINED_MIN);
+
+    // 每12分钟一条: 全部保留
+    bench_outage(720000, &produced, &retained);
+    TEST_ASSERT_EQUAL(produced, retained);
+}
+
+TEST_CASE(mqtt_queue_cost)
+{
+    mqtt_queue_config_t unpaced = {MQTT_QUEUE_WINDOW, 0, MQTT_QUEUE_WINDOW, 0, 10000};
+    mqtt_queue_stats_t stats;
+    uint32_t messages = 0;
+    uint64_t start;
+
+    // 离线入队: 前若干条进RAM环，之后每条触发一次溢出 (Flash追加)
+    bench_setup(&unpaced);
+    start = perf_now();
+    for (uint32_t n = 0; n < 200; n++)
+    {
+        bench_publish(n);
+    }
+    perf_report("offline enqueue 24B (RAM ring + spill)", perf_now() - start, 200);
+
+    // 不限速排放: 每次任务调用填满窗口，测量取出/编码/发送/确认的开销
+    mqtt_connect();
+    mqtt_task();
+    start = perf_now();
+    while (mqtt_queue_pending() > 0)
+    {
+        mqtt_task();
+        mqtt_queue_task();
+        messages++;
+    }
+    uint64_t elapsed = perf_now() - start;
+    TEST_ASSERT_TRUE(mqtt_queue_get_stats(&stats));
+    perf_report("unpaced drain (per message)", elapsed, stats.drained);
+    perf_sink(messages);
+
+    bench_teardown();
+}
+
+void run_mqtt_queue_perf_tests(void)
+{
+    printf("\n=== 运行MQTT离线队列性能测试 ===\n");
+
+    RUN_TEST(mqtt_queue_outage_24h);
+    RUN_TEST(mqtt_queue_cost);
+
+    printf("MQTT离线队列性能测试用例已添加完成\n");
+}
@@ -0,0 +1,170 @@
+/**
+ * @file bench_sensor_deadband.c
+ * @brief 传感器死区/变化上报回放测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 以1s采样周期回放24小时稳态现场曲线 (温度/湿度日变化 + 量化噪声，
+ * 电压每6小时跌落一次)，对比:
+ * - 原方案: 每个样本都视为新数据，每个采样周期上报一次
+ * - 死区方案: 仅在显著变化事件时上报 (含15分钟最长静默心跳)
+ * 统计上报次数、MQTT负载字节数和历史记录写入字节数
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/sensor.h"
+#include "../../inc/adc.h"
+#include "../../inc/mqtt.h"
+#include "../../inc/storage.h"
+#include "../../inc/system.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define BENCH_TRACE_SECONDS 86400
+#define BENCH_SILENCE_MS 900000
+#define BENCH_PI 3.14159265358979
+
+static uint32_t bench_lfsr = 0xACE1u;
+static uint32_t bench_events;
+static uint32_t bench_event_reasons[4];
+static bool bench_tick_has_event;
+
+static void bench_change_callback(const sensor_change_event_t *event)
+{
+    bench_events++;
+    bench_event_reasons[event->reason]++;
+    bench_tick_has_event = true;
+}
+
+/**
+ * @brief 均匀噪声 [-amplitude, amplitude]
+ */
+static double bench_noise(double amplitude)
+{
+    bench_lfsr = (bench_lfsr >> 1) ^ (-(bench_lfsr & 1u) & 0xB400u);
+    return ((double)(bench_lfsr & 0x3FF) / 1023.0 - 0.5) * 2.0 * amplitude;
+}
+
+static uint16_t bench_code(double value)
+{
+    long code = lround(value);
+    return (uint16_t)(code < 0 ? 0 : (code > 4095 ? 4095 : code));
+}
+
+/**
+ * @brief 回放一天曲线，返回上报次数
+ */
+static uint32_t bench_replay(bool use_deadband)
+{
+    sensor_config_t configs[3] = {
+        {.channel = SENSOR_TEMP_CHANNEL, .type = SENSOR_TYPE_TEMPERATURE, .enabled = true,
+         .sample_period = 1000, .scale_factor = 0.1f, .offset = -40.0f,
+         .min_value = -40.0f, .max_value = 100.0f, .filter_size = 4},
+        {.channel = SENSOR_HUMIDITY_CHANNEL, .type = SENSOR_TYPE_HUMIDITY, .enabled = true,
+         .sample_period = 1000, .scale_factor = 0.1f, .offset = 0.0f,
+         .min_value = 0.0f, .max_value = 100.0f, .filter_size = 4},
+        {.channel = SENSOR_VOLTAGE_CHANNEL, .type = SENSOR_TYPE_VOLTAGE, .enabled = true,
+         .sample_period = 1000, .scale_factor = 0.01f, .offset = 0.0f,
+         .min_value = 0.0f, .max_value = 5.0f, .filter_size = 4}};
+    uint32_t reports = 0;
+
+    if (use_deadband)
+    {
+        configs[0].deadband_abs = 0.5f;
+        configs[1].deadband_abs = 2.0f;
+        configs[2].deadband_abs = 0.05f;
+        configs[2].deadband_rel = 0.02f;
+        for (int i = 0; i < 3; i++)
+        {
+            configs[i].max_silence_ms = BENCH_SILENCE_MS;
+        }
+    }
+
+    sensor_init();
+    for (int i = 0; i < 3; i++)
+    {
+        sensor_config(configs[i].channel, &configs[i]);
+    }
+    sensor_set_change_callback(bench_change_callback);
+    sensor_start_scan();
+
+    bench_lfsr = 0xACE1u;
+    bench_events = 0;
+    memset(bench_event_reasons, 0, sizeof(bench_event_reasons));
+
+    for (uint32_t t = 0; t < BENCH_TRACE_SECONDS; t++)
+    {
+        double phase = 2.0 * BENCH_PI * (double)t / 86400.0;
+        double temperature = 24.0 + 2.5 * sin(phase) + bench_noise(0.15);
+        double humidity = 55.0 - 6.0 * sin(phase) + bench_noise(0.3);
+        double voltage = ((t % 21600) < 60 ? 3.00 : 3.30) + bench_noise(0.01);
+
+        adc_sim_set_value(ADC_TEMP_SENSOR_CHANNEL, bench_code((temperature + 40.0) * 10.0));
+        adc_sim_set_value(ADC_HUMIDITY_SENSOR_CHANNEL, bench_code(humidity * 10.0));
+        adc_sim_set_value(ADC_VOLTAGE_MONITOR_CHANNEL, bench_code(voltage * 100.0));
+
+        for (int ms = 0; ms < 1000; ms++)
+        {
+            system_tick_increment();
+        }
+        adc_timer_trigger_handler();
+
+        bench_tick_has_event = false;
+        sensor_task();
+        if (bench_tick_has_event)
+        {
+            reports++;
+        }
+    }
+
+    sensor_deinit();
+    for (int ch = 0; ch < ADC_CHANNEL_COUNT; ch++)
+    {
+        adc_sim_set_value((adc_channel_t)ch, ADC_SIM_DEFAULT);
+    }
+
+    return reports;
+}
+
+TEST_CASE(sensor_deadband_replay_reduction)
+{
+    mqtt_sensor_data_t payload = {.temperature = 24.5f, .humidity = 55.0f, .voltage = 3.30f};
+    char buffer[160];
+    int payload_bytes = mqtt_encode_sensor_data(buffer, sizeof(buffer), &payload);
+    TEST_ASSERT_GREATER_THAN(0, payload_bytes);
+
+    uint32_t legacy_reports = bench_replay(false);
+    uint32_t legacy_events = bench_events;
+    uint32_t deadband_reports = bench_replay(true);
+
+    printf("  [PERF] %-20s %10s %10s %12s %12s\n", "mode", "events", "reports", "uplink B", "flash B");
+    printf("  [PERF] %-20s %10lu %10lu %12lu %12lu\n", "every sample",
+           (unsigned long)legacy_events, (unsigned long)legacy_reports,
+           (unsigned long)legacy_reports * payload_bytes,
+           (unsigned long)(legacy_reports * sizeof(storage_sensor_record_t)));
+    printf("  [PERF] %-20s %10lu %10lu %12lu %12lu\n", "deadband + silence",
+           (unsigned long)bench_events, (unsigned long)deadband_reports,
+           (unsigned long)deadband_reports * payload_bytes,
+           (unsigned long)(deadband_reports * sizeof(storage_sensor_record_t)));
+    printf("  [PERF] deadband events: first=%lu deadband=%lu status=%lu silence=%lu\n",
+           (unsigned long)bench_event_reasons[SENSOR_CHANGE_FIRST],
+           (unsigned long)bench_event_reasons[SENSOR_CHANGE_DEADBAND],
+           (unsigned long)bench_event_reasons[SENSOR_CHANGE_STATUS],
+           (unsigned long)bench_event_reasons[SENSOR_CHANGE_SILENCE]);
+
+    TEST_ASSERT_EQUAL(BENCH_TRACE_SECONDS, legacy_reports);
+
+    // 稳态现场至少降低一个数量级，电压跌落必须被上报
+    TEST_ASSERT_LESS_THAN(legacy_reports / 10, deadband_reports);
+    TEST_ASSERT_GREATER_THAN(0, bench_event_reasons[SENSOR_CHANGE_DEADBAND]);
+}
+
+void run_sensor_deadband_perf_tests(void)
+{
+    printf("\n=== 运行传感器死区上报回放测试 ===\n");
+
+    RUN_TEST(sensor_deadband_replay_reduction);
+
+    printf("传感器死区上报回放测试用例已添加完成\n");
+}
@@ -0,0 +1,164 @@
+/**
+ * @file bench_sensor_fixed.c
+ * @brief 传感器定点转换流水线性能测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 对比单次采样的处理开销:
+ * - 浮点参考实现 (原 sensor_convert_to_physical/update_statistics/check_threshold)
+ * - 定点实现 (sensor.c当前使用的 q16_linear/q16_ema_tenth/整数比较)
+ * 主机下得到纳秒数；目标板上按BENCH_CHUNK条分段计时 (每段短于一个SysTick周期)，
+ * 得到Cortex-M0软件浮点与定点实现的每采样CPU周期数
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/fixed_point.h"
+#include "perf_counter.h"
+#include <stdio.h>
+
+#define BENCH_SAMPLES 100000
+#define BENCH_CHUNK 16 // 分段计时的采样数 (软件浮点每采样数百周期，一段远小于1ms)
+
+// 温度通道典型配置
+#define BENCH_SCALE 0.1f
+#define BENCH_OFFSET -40.0f
+#define BENCH_MIN -40.0f
+#define BENCH_MAX 100.0f
+#define BENCH_TH_LOW -10.0f
+#define BENCH_TH_HIGH 60.0f
+
+/**
+ * @brief 浮点参考实现的单次采样处理
+ */
+static uint32_t bench_float_sample(uint16_t raw, float *avg, float *min, float *max)
+{
+    volatile float scale = BENCH_SCALE; // 防止常量折叠
+    float value = (float)raw * scale + BENCH_OFFSET;
+
+    if (value < BENCH_MIN)
+    {
+        value = BENCH_MIN;
+    }
+    else if (value > BENCH_MAX)
+    {
+        value = BENCH_MAX;
+    }
+
+    if (value < *min)
+    {
+        *min = value;
+    }
+    if (value > *max)
+    {
+        *max = value;
+    }
+
+    *avg = 0.1f * value + 0.9f * (*avg);
+
+    return (value < BENCH_TH_LOW || value > BENCH_TH_HIGH) ? 1U : 0U;
+}
+
+/**
+ * @brief 定点实现的单次采样处理
+ */
+static uint32_t bench_fixed_sample(uint16_t raw, q16_t *avg, q16_t *min, q16_t *max)
+{
+    static const q24_t scale = Q24_CONST(0.1);
+    static const q16_t offset = Q16_CONST(-40.0);
+    static const q16_t lo = Q16_CONST(-40.0);
+    static const q16_t hi = Q16_CONST(100.0);
+    static const q16_t th_lo = Q16_CONST(-10.0);
+    static const q16_t th_hi = Q16_CONST(60.0);
+
+    q16_t value = q16_linear(raw, scale, offset);
+
+    if (value < lo)
+    {
+        value = lo;
+    }
+    else if (value > hi)
+    {
+        value = hi;
+    }
+
+    if (value < *min)
+    {
+        *min = value;
+    }
+    if (value > *max)
+    {
+        *max = value;
+    }
+
+    *avg = q16_ema_tenth(*avg, value);
+
+    return (value < th_lo || value > th_hi) ? 1U : 0U;
+}
+
+TEST_CASE(sensor_pipeline_float_vs_fixed)
+{
+    float f_avg = 0.0f, f_min = 1e9f, f_max = -1e9f;
+    q16_t q_avg = 0, q_min = Q16_MAX, q_max = Q16_MIN;
+    uint32_t alarms = 0;
+
+    uint64_t float_elapsed = 0, fixed_elapsed = 0;
+
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i += BENCH_CHUNK)
+    {
+        uint64_t start = perf_now();
+        for (uint32_t j = i; j < i + BENCH_CHUNK; j++)
+        {
+            alarms += bench_float_sample((uint16_t)(200 + (j & 0x3FF)), &f_avg, &f_min, &f_max);
+        }
+        float_elapsed += perf_elapsed(start);
+    }
+
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i += BENCH_CHUNK)
+    {
+        uint64_t start = perf_now();
+        for (uint32_t j = i; j < i + BENCH_CHUNK; j++)
+        {
+            alarms += bench_fixed_sample((uint16_t)(200 + (j & 0x3FF)), &q_avg, &q_min, &q_max);
+        }
+        fixed_elapsed += perf_elapsed(start);
+    }
+
+    perf_sink(alarms);
+    perf_report("sample pipeline (float, soft-fp)", float_elapsed, BENCH_SAMPLES);
+    perf_report("sample pipeline (Q16.16)", fixed_elapsed, BENCH_SAMPLES);
+
+    // 两种实现结果一致性 (误差 < 0.01)
+    TEST_ASSERT_WITHIN(10, (int)(f_min * 1000.0f), q16_to_milli(q_min));
+    TEST_ASSERT_WITHIN(10, (int)(f_max * 1000.0f), q16_to_milli(q_max));
+    TEST_ASSERT_WITHIN(10, (int)(f_avg * 1000.0f), q16_to_milli(q_avg));
+}
+
+TEST_CASE(sensor_fixed_conversion_accuracy)
+{
+    // 全量程逐码比较，最大误差不超过0.001个物理单位
+    int32_t max_error = 0;
+
+    for (uint32_t raw = 0; raw < 4096; raw++)
+    {
+        int32_t ref = (int32_t)((double)raw * 0.01 * 1000.0 + 0.5);
+        int32_t got = q16_to_milli(q16_linear((int32_t)raw, Q24_CONST(0.01), 0));
+        int32_t err = got > ref ? got - ref : ref - got;
+        if (err > max_error)
+        {
+            max_error = err;
+        }
+    }
+
+    printf("  [PERF] scale=0.01 max error over 12-bit range: %ld x0.001\n", (long)max_error);
+    TEST_ASSERT_LESS_THAN(2, max_error);
+}
+
+void run_sensor_fixed_perf_tests(void)
+{
+    printf("\n=== 运行传感器定点转换性能测试 ===\n");
+
+    RUN_TEST(sensor_pipeline_float_vs_fixed);
+    RUN_TEST(sensor_fixed_conversion_accuracy);
+
+    printf("传感器定点转换性能测试用例已添加完成\n");
+}
@@ -0,0 +1,110 @@
+/**
+ * @file bench_sensor_jitter.c
+ * @brief 传感器采样抖动对比测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 以1ms步长模拟主循环，OLED/UART阻塞时主循环延迟0~8ms:
+ * - 原方案: 主循环比较system_get_tick()与last_sample_time决定采样 (模型)
+ * - 定时器方案: TMR0周期触发扫描入队，sensor_task()只做后处理 (实际模块)
+ *   其他中断占用时TMR0中断响应延迟0~40us (模拟注入，目标板上由中断入口读出的TMR0计数得到)
+ * 对比通道0 (1s采样周期) 的采样间隔偏差
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/sensor.h"
+#include "../../inc/adc.h"
+#include "../../inc/system.h"
+#include <stdio.h>
+
+#define BENCH_SIM_MS 120000  // 模拟2分钟
+#define BENCH_PERIOD_MS 1000 // 通道0采样周期
+
+static uint32_t bench_lfsr = 0xACE1u;
+
+/**
+ * @brief 主循环单次耗时 (1ms，约1/4概率阻塞到最多8ms)
+ */
+static uint32_t bench_loop_latency(void)
+{
+    bench_lfsr = (bench_lfsr >> 1) ^ (-(bench_lfsr & 1u) & 0xB400u);
+    return (bench_lfsr & 0x3) == 0 ? 1 + (bench_lfsr >> 2) % 8 : 1;
+}
+
+TEST_CASE(sensor_jitter_tick_polling_vs_timer)
+{
+    // 原方案模型: 采样时刻即主循环恰好运行到的时刻
+    uint32_t busy_until = 0;
+    uint32_t last_sample = 0;
+    int32_t legacy_max = 0;
+    uint32_t legacy_abs_sum = 0, legacy_intervals = 0;
+
+    bench_lfsr = 0xACE1u;
+    for (uint32_t ms = 1; ms <= BENCH_SIM_MS; ms++)
+    {
+        if (busy_until > ms)
+        {
+            continue;
+        }
+        if (ms - last_sample >= BENCH_PERIOD_MS)
+        {
+            if (last_sample != 0)
+            {
+                int32_t deviation = (int32_t)((ms - last_sample) - BENCH_PERIOD_MS) * 1000;
+                legacy_max = deviation > legacy_max ? deviation : legacy_max;
+                legacy_abs_sum += (uint32_t)deviation;
+                legacy_intervals++;
+            }
+            last_sample = ms;
+        }
+        busy_until = ms + bench_loop_latency();
+    }
+
+    // 定时器方案: 同样的主循环阻塞序列驱动真实传感器模块
+    sensor_jitter_t jitter;
+
+    TEST_ASSERT_TRUE(sensor_init());
+    TEST_ASSERT_TRUE(sensor_start_scan());
+    TEST_ASSERT_TRUE(sensor_clear_stats(0xFF));
+
+    bench_lfsr = 0xACE1u;
+    busy_until = 0;
+    for (uint32_t ms = 1; ms <= BENCH_SIM_MS; ms++)
+    {
+        system_tick_increment();
+        if (ms % BENCH_PERIOD_MS == 0)
+        {
+            adc_sim_set_trigger_latency((ms / BENCH_PERIOD_MS) * 7919U % 41U);
+            adc_timer_trigger_handler();
+        }
+        if (busy_until <= ms)
+        {
+            sensor_task();
+            busy_until = ms + bench_loop_latency();
+        }
+    }
+    sensor_task();
+
+    TEST_ASSERT_TRUE(sensor_get_jitter(0, &jitter));
+    sensor_deinit();
+    adc_sim_set_trigger_latency(0);
+
+    printf("  [PERF] %-24s %10s %12s %12s\n", "mode", "intervals", "max dev(us)", "mean |dev|");
+    printf("  [PERF] %-24s %10lu %12ld %12lu\n", "main-loop tick polling", (unsigned long)legacy_intervals,
+           (long)legacy_max, (unsigned long)(legacy_intervals ? legacy_abs_sum / legacy_intervals : 0));
+    printf("  [PERF] %-24s %10lu %12ld %12lu\n", "timer-triggered scan", (unsigned long)jitter.intervals,
+           (long)jitter.max_deviation_us, (unsigned long)jitter.mean_abs_deviation_us);
+
+    TEST_ASSERT_GREATER_THAN(100, jitter.intervals);
+    TEST_ASSERT_GREATER_THAN(0, jitter.max_deviation_us);
+    TEST_ASSERT_LESS_THAN(legacy_max, jitter.max_deviation_us);
+}
+
+void run_sensor_jitter_perf_tests(void)
+{
+    printf("\n=== 运行传感器采样抖动测试 ===\n");
+
+    RUN_TEST(sensor_jitter_tick_polling_vs_timer);
+
+    printf("传感器采样抖动测试用例已添加完成\n");
+}
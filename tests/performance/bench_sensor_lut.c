@@ -0,0 +1,208 @@
+/**
+ * @file bench_sensor_lut.c
+ * @brief 传感器非线性线性化查找表性能与精度测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 以NTC 10K B3950 (10K上拉) 为例，对全部码值与浮点Steinhart-Hart参考比较:
+ * - 两点线性拟合 (原 raw*scale+offset 能达到的最好情况)
+ * - 直接索引表 (129项，2^5码间隔)
+ * - 二分查找断点表 (按5°C取点)
+ * 同时给出各方式每次转换的开销和Flash占用
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/sensor_lut.h"
+#include "perf_counter.h"
+#include <stdio.h>
+#include <math.h>
+
+#define BENCH_ITERATIONS 100000
+
+// 评估温区 (常用工况，两端限幅区不参与误差统计)
+#define BENCH_EVAL_T_MIN -30.0
+#define BENCH_EVAL_T_MAX 110.0
+
+/**
+ * @brief 浮点参考: 码值 -> 阻值 -> Steinhart-Hart温度 (限幅到表量程)
+ */
+static double bench_reference(double code)
+{
+    const double full_scale = SENSOR_LUT_ADC_FULL_SCALE;
+
+    if (code <= 0.0)
+    {
+        return SENSOR_LUT_NTC_10K_3950_T_MAX;
+    }
+    if (code >= full_scale)
+    {
+        return SENSOR_LUT_NTC_10K_3950_T_MIN;
+    }
+
+    double ohm = SENSOR_LUT_NTC_10K_3950_PULLUP_OHM * code / (full_scale - code);
+    double ln_r = log(ohm);
+    double temp = 1.0 / (SENSOR_LUT_NTC_10K_3950_SH_A + SENSOR_LUT_NTC_10K_3950_SH_B * ln_r +
+                         SENSOR_LUT_NTC_10K_3950_SH_C * ln_r * ln_r * ln_r) -
+                  273.15;
+
+    if (temp < SENSOR_LUT_NTC_10K_3950_T_MIN)
+    {
+        return SENSOR_LUT_NTC_10K_3950_T_MIN;
+    }
+    if (temp > SENSOR_LUT_NTC_10K_3950_T_MAX)
+    {
+        return SENSOR_LUT_NTC_10K_3950_T_MAX;
+    }
+    return temp;
+}
+
+/**
+ * @brief 单精度浮点参考 (目标板软浮点的实际开销近似)
+ */
+static float bench_reference_float(uint16_t code)
+{
+    float ohm = (float)SENSOR_LUT_NTC_10K_3950_PULLUP_OHM * (float)code / (float)(SENSOR_LUT_ADC_FULL_SCALE - code);
+    float ln_r = logf(ohm);
+    return 1.0f / ((float)SENSOR_LUT_NTC_10K_3950_SH_A + (float)SENSOR_LUT_NTC_10K_3950_SH_B * ln_r +
+                   (float)SENSOR_LUT_NTC_10K_3950_SH_C * ln_r * ln_r * ln_r) -
+           273.15f;
+}
+
+/**
+ * @brief 统计一种换算方式在评估温区内的误差 (°C)
+ */
+static void bench_accuracy(const char *name, const sensor_lut_t *lut, uint8_t extra_bits,
+                           q24_t scale_q24, q16_t offset_q16, double *max_error)
+{
+    uint32_t codes = (uint32_t)SENSOR_LUT_ADC_FULL_SCALE << extra_bits;
+    double sum_sq = 0.0;
+    uint32_t count = 0;
+
+    *max_error = 0.0;
+    for (uint32_t raw = 1; raw < codes; raw++)
+    {
+        double reference = bench_reference((double)raw / (double)(1U << extra_bits));
+        if (reference < BENCH_EVAL_T_MIN || reference > BENCH_EVAL_T_MAX)
+        {
+            continue;
+        }
+
+        q16_t value = lut ? sensor_lut_lookup(lut, raw, extra_bits)
+                          : q16_linear_ext((int32_t)raw, extra_bits, scale_q24, offset_q16);
+        double error = fabs(q16_to_float(value) - reference);
+
+        *max_error = error > *max_error ? error : *max_error;
+        sum_sq += error * error;
+        count++;
+    }
+
+    printf("  [PERF] %-28s n=%u %10.4f %10.4f\n", name, extra_bits, *max_error, sqrt(sum_sq / count));
+}
+
+TEST_CASE(sensor_lut_accuracy_vs_float)
+{
+    const sensor_lut_t *direct = sensor_lut_get(SENSOR_LUT_NTC_10K_3950);
+    const sensor_lut_t *binary = sensor_lut_get(SENSOR_LUT_NTC_10K_3950_PWL);
+    double linear_error, direct_error, binary_error, direct_os_error, binary_os_error;
+
+    // 两点线性拟合: 经过0°C和50°C对应码值
+    double code_0 = 0.0, code_50 = 0.0;
+    for (uint32_t raw = 1; raw < SENSOR_LUT_ADC_FULL_SCALE; raw++)
+    {
+        double t = bench_reference(raw);
+        if (code_0 == 0.0 && t <= 0.0)
+        {
+            code_0 = raw;
+        }
+        if (code_50 == 0.0 && t <= 50.0)
+        {
+            code_50 = raw;
+        }
+    }
+    double scale = (bench_reference(code_50) - bench_reference(code_0)) / (code_50 - code_0);
+    double offset = bench_reference(code_0) - scale * code_0;
+
+    printf("  [PERF] %-28s %3s %10s %10s (degC, %.0f..%.0f)\n", "method", "", "max err", "rms err",
+           BENCH_EVAL_T_MIN, BENCH_EVAL_T_MAX);
+    bench_accuracy("linear 2-point (0/50degC)", NULL, 0, q24_from_float((float)scale), q16_from_float((float)offset),
+                   &linear_error);
+    bench_accuracy("direct LUT (129 x 2^5)", direct, 0, 0, 0, &direct_error);
+    bench_accuracy("direct LUT (129 x 2^5)", direct, 2, 0, 0, &direct_os_error);
+    bench_accuracy("binary LUT (5degC steps)", binary, 0, 0, 0, &binary_error);
+    bench_accuracy("binary LUT (5degC steps)", binary, 2, 0, 0, &binary_os_error);
+
+    // 插值误差小于NTC自身1%阻值公差 (约0.2°C)
+    TEST_ASSERT_TRUE(direct_error < 0.2);
+    TEST_ASSERT_TRUE(binary_error < 0.2);
+    TEST_ASSERT_TRUE(direct_os_error < 0.2);
+    TEST_ASSERT_TRUE(binary_os_error < 0.2);
+    TEST_ASSERT_TRUE(linear_error > 10.0 * direct_error);
+}
+
+TEST_CASE(sensor_lut_cost_per_conversion)
+{
+    const sensor_lut_t *direct = sensor_lut_get(SENSOR_LUT_NTC_10K_3950);
+    const sensor_lut_t *binary = sensor_lut_get(SENSOR_LUT_NTC_10K_3950_PWL);
+    const sensor_lut_t *humidity = sensor_lut_get(SENSOR_LUT_HUMIDITY_PROBE);
+    volatile q24_t scale_q24 = Q24_CONST(0.1); // 防止常量折叠
+    uint32_t acc = 0;
+    uint64_t start, elapsed;
+
+    start = perf_now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        acc += (uint32_t)q16_linear_ext((int32_t)(i & 0xFFF), 0, scale_q24, Q16_CONST(-40.0));
+    }
+    elapsed = perf_now() - start;
+    perf_report("linear scale/offset (Q16.16)", elapsed, BENCH_ITERATIONS);
+
+    start = perf_now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        acc += (uint32_t)sensor_lut_lookup(direct, i & 0xFFF, 0);
+    }
+    elapsed = perf_now() - start;
+    perf_report("NTC direct-index LUT", elapsed, BENCH_ITERATIONS);
+
+    start = perf_now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        acc += (uint32_t)sensor_lut_lookup(binary, i & 0xFFF, 0);
+    }
+    elapsed = perf_now() - start;
+    perf_report("NTC binary-search LUT (34 pts)", elapsed, BENCH_ITERATIONS);
+
+    start = perf_now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        acc += (uint32_t)sensor_lut_lookup(humidity, i & 0xFFF, 0);
+    }
+    elapsed = perf_now() - start;
+    perf_report("humidity binary-search LUT (11 pts)", elapsed, BENCH_ITERATIONS);
+
+    float facc = 0.0f;
+    start = perf_now();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        facc += bench_reference_float((uint16_t)(1 + (i & 0xFFE)));
+    }
+    elapsed = perf_now() - start;
+    perf_report("float Steinhart-Hart (logf)", elapsed, BENCH_ITERATIONS);
+
+    perf_sink(acc + (uint32_t)facc);
+
+    printf("  [PERF] flash: direct %u B, binary %u B, humidity %u B\n",
+           (unsigned)(direct->count * sizeof(q16_t)),
+           (unsigned)(binary->count * (sizeof(uint16_t) + sizeof(q16_t) + sizeof(int32_t))),
+           (unsigned)(humidity->count * (sizeof(uint16_t) + sizeof(q16_t) + sizeof(int32_t))));
+}
+
+void run_sensor_lut_perf_tests(void)
+{
+    printf("\n=== 运行传感器查找表性能测试 ===\n");
+
+    RUN_TEST(sensor_lut_accuracy_vs_float);
+    RUN_TEST(sensor_lut_cost_per_conversion);
+
+    printf("传感器查找表性能测试用例已添加完成\n");
+}
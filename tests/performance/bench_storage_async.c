@@ -0,0 +1,230 @@
+/**
+ * @file bench_storage_async.c
+ * @brief 存储作业队列与后台预擦除性能测试 (主机NOR模拟器)
+ * @version 1.1
+ * @date 2026-10-18
+ *
+ * 按1ms主循环模拟1小时的高频记录: 每100ms一个传感器采样、每500ms一条报警记录、
+ * 每2s修改一次配置，Modbus主站每50ms (抖动±3ms) 轮询一次。对比:
+ * - 同步写入: 每次写入后立即执行作业 (擦除在写入路径上完成，等同原存储模块)
+ * - 作业队列: 写入只入队，主循环每次调用storage_task()执行一个作业或一页预擦除，
+ *   且只在轮询窗口预测的总线空闲间隙内执行 (同modbus_is_idle())
+ * 按假定的Flash时序估算每轮阻塞时间，阻塞期间主循环不运行，到达的请求与到期的
+ * 记录都顺延到阻塞结束后的第一轮处理。请求延迟 = 被处理时刻 - 到达时刻
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/flash.h"
+#include "../../inc/storage.h"
+#include "../../inc/poll_window.h"
+#include "../../inc/system.h"
+#include "perf_counter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_DURATION_MS 3600000UL // 模拟时长 (1小时)
+#define BENCH_SAMPLE_MS 100         // 传感器采样周期
+#define BENCH_EVENT_MS 500          // 报警记录周期
+#define BENCH_CONFIG_MS 2000        // 配置修改周期
+#define BENCH_MODBUS_MS 50          // Modbus轮询周期
+#define BENCH_MODBUS_JITTER_MS 3    // Modbus轮询抖动 (±)
+#define BENCH_REQUESTS (BENCH_DURATION_MS / BENCH_MODBUS_MS)
+#define BENCH_ERASE_US 20000UL // 假定页擦除时间 (典型值)
+#define BENCH_PROGRAM_US 30UL  // 假定字编程时间 (典型值)
+#define BENCH_LATENCY_BOUND_US 2000UL // 作业队列下请求延迟上限
+
+/**
+ * @brief 单次运行结果
+ */
+typedef struct
+{
+    uint32_t stall_us;  // 单轮最长阻塞
+    uint32_t worst_us;  // 请求最大延迟
+    uint32_t p999_us;   // 请求延迟99.9百分位
+    uint32_t blocked;   // 延迟超过1ms的请求数
+    uint32_t erases;    // 页擦除总数
+    uint64_t host_ns;   // 主机耗时
+} bench_result_t;
+
+static uint32_t bench_latency[BENCH_REQUESTS];
+static poll_window_t bench_window;
+static bool bench_request_pending;
+
+/**
+ * @brief 按假定时序估算两次统计之间的Flash操作耗时 (us)
+ */
+static uint32_t bench_flash_time(const flash_stats_t *before, const flash_stats_t *after)
+{
+    uint32_t words = (after->program_bytes - before->program_bytes) / FLASH_PROGRAM_UNIT;
+    return (after->erase_count - before->erase_count) * BENCH_ERASE_US + words * BENCH_PROGRAM_US;
+}
+
+/**
+ * @brief 总线空闲检查 (模拟从站modbus_is_idle())
+ */
+static bool bench_idle(uint32_t duration_ms, void *context)
+{
+    (void)context;
+    return !bench_request_pending && poll_window_idle(&bench_window, system_get_tick(), duration_ms);
+}
+
+static int bench_compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * @brief 生成下一个轮询请求的到达时刻 (ms)
+ */
+static uint32_t bench_next_arrival(uint32_t index, uint32_t *seed)
+{
+    *seed = *seed * 1103515245UL + 12345UL;
+    return (index + 1) * BENCH_MODBUS_MS + (*seed >> 16) % (2 * BENCH_MODBUS_JITTER_MS + 1) - BENCH_MODBUS_JITTER_MS;
+}
+
+/**
+ * @brief 运行一次模拟
+ * @param async true: 作业队列 + 空闲窗口内的后台任务, false: 每次写入后同步执行
+ */
+static void bench_run(bool async, bench_result_t *result)
+{
+    storage_config_t config;
+    flash_stats_t before, after;
+    uint32_t requests = 0;
+    uint32_t seed = 1;
+    uint32_t arrival = bench_next_arrival(0, &seed);
+    uint32_t next_sample = BENCH_SAMPLE_MS;
+    uint32_t next_event = BENCH_EVENT_MS;
+    uint32_t next_config = BENCH_CONFIG_MS;
+    uint64_t busy_until = 0; // 主循环阻塞结束时刻 (us)
+
+    storage_deinit();
+    flash_sim_reset();
+    storage_init();
+    storage_read_config(&config);
+    flash_reset_stats();
+    poll_window_init(&bench_window, system_get_tick());
+    bench_request_pending = false;
+    storage_set_idle_check(async ? bench_idle : NULL, NULL);
+    memset(result, 0, sizeof(bench_result_t));
+
+    uint64_t start = perf_now();
+    for (uint32_t t = 1; t <= BENCH_DURATION_MS; t++)
+    {
+        system_tick_increment();
+        uint64_t now_us = (uint64_t)t * 1000;
+        bench_request_pending = requests < BENCH_REQUESTS && t >= arrival;
+
+        // 上一轮的Flash操作尚未完成
+        if (now_us < busy_until)
+        {
+            continue;
+        }
+
+        // 先响应已到达的请求
+        if (bench_request_pending)
+        {
+            bench_latency[requests++] = (uint32_t)(now_us - (uint64_t)arrival * 1000);
+            poll_window_request(&bench_window, system_get_tick());
+            arrival = bench_next_arrival(requests, &seed);
+            bench_request_pending = false;
+        }
+
+        flash_get_stats(&before);
+        if (t >= next_sample)
+        {
+            next_sample += BENCH_SAMPLE_MS;
+            storage_write_sensor_history((int16_t)(250 + (t / 1000) % 50), 600, 3300, 0);
+        }
+        if (t >= next_event)
+        {
+            next_event += BENCH_EVENT_MS;
+            storage_write_alarm_history(1, 2, (int32_t)(t / 1000), 0);
+        }
+        if (t >= next_config)
+        {
+            next_config += BENCH_CONFIG_MS;
+            config.sample_period = (uint16_t)(t / BENCH_CONFIG_MS);
+            if (async)
+            {
+                storage_write_config_async(&config, NULL, NULL);
+            }
+            else
+            {
+                storage_write_config(&config);
+            }
+        }
+        if (async)
+        {
+            storage_task();
+        }
+        else
+        {
+            storage_process_jobs();
+        }
+
+        flash_get_stats(&after);
+        uint32_t stall = bench_flash_time(&before, &after);
+        result->stall_us = stall > result->stall_us ? stall : result->stall_us;
+        busy_until = now_us + stall;
+    }
+    result->host_ns = perf_now() - start;
+
+    flash_get_stats(&after);
+    result->erases = after.erase_count;
+    for (uint32_t i = 0; i < requests; i++)
+    {
+        result->blocked += bench_latency[i] > 1000;
+        result->worst_us = bench_latency[i] > result->worst_us ? bench_latency[i] : result->worst_us;
+    }
+    qsort(bench_latency, requests, sizeof(uint32_t), bench_compare);
+    result->p999_us = bench_latency[requests * 999 / 1000];
+
+    storage_set_idle_check(NULL, NULL);
+    storage_deinit();
+}
+
+TEST_CASE(storage_async_modbus_latency)
+{
+    bench_result_t sync_result, async_result;
+
+    bench_run(false, &sync_result);
+    bench_run(true, &async_result);
+
+    perf_report("1h logging, synchronous writes", sync_result.host_ns, BENCH_DURATION_MS);
+    perf_report("1h logging, job queue + idle windows", async_result.host_ns, BENCH_DURATION_MS);
+    printf("  [PERF] %-36s %10lu -> %lu\n", "longest main loop stall (us)",
+           (unsigned long)sync_result.stall_us, (unsigned long)async_result.stall_us);
+    printf("  [PERF] %-36s %10lu -> %lu\n", "est. Modbus latency (us, worst)",
+           (unsigned long)sync_result.worst_us, (unsigned long)async_result.worst_us);
+    printf("  [PERF] %-36s %10lu -> %lu\n", "est. Modbus latency (us, p99.9)",
+           (unsigned long)sync_result.p999_us, (unsigned long)async_result.p999_us);
+    printf("  [PERF] %-36s %10lu -> %lu\n", "requests delayed > 1ms",
+           (unsigned long)sync_result.blocked, (unsigned long)async_result.blocked);
+    printf("  [PERF] %-36s %10lu -> %lu\n", "page erases",
+           (unsigned long)sync_result.erases, (unsigned long)async_result.erases);
+
+    // 同步写入时配置切换bank连续擦除整个bank，请求被阻塞
+    TEST_ASSERT_TRUE(sync_result.stall_us >= STORAGE_CONFIG_BANK_SIZE / FLASH_PAGE_SIZE * BENCH_ERASE_US);
+    TEST_ASSERT_TRUE(sync_result.worst_us >= BENCH_ERASE_US);
+
+    // 擦除只在轮询间隙内执行，不再有请求等待擦除完成
+    TEST_ASSERT_TRUE(async_result.stall_us < 2 * BENCH_ERASE_US);
+    TEST_ASSERT_TRUE(async_result.worst_us < BENCH_LATENCY_BOUND_US);
+    TEST_ASSERT_TRUE(async_result.p999_us <= sync_result.p999_us);
+    TEST_ASSERT_TRUE(async_result.blocked <= sync_result.blocked);
+
+    // 额外擦除仅为检查点页 (同步写入不写检查点)，不超过同步写入的5%
+    TEST_ASSERT_TRUE(async_result.erases <= sync_result.erases + sync_result.erases / 20);
+}
+
+void run_storage_async_perf_tests(void)
+{
+    printf("\n=== 运行存储作业队列性能测试 ===\n");
+
+    RUN_TEST(storage_async_modbus_latency);
+
+    printf("存储作业队列性能测试用例已添加完成\n");
+}
@@ -0,0 +1,187 @@
+/**
+ * @file bench_stream_stats.c
+ * @brief 流式统计性能与精度测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * - 每通道内存: 流式统计状态 vs 原浮点最值/EMA vs 缓存1小时原始样本
+ * - 单样本更新开销: 原浮点最值+EMA vs Welford+P²
+ * - 分位数精度: 1小时 (3600点) 窗口下P²估计与排序精确值比较
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/stream_stats.h"
+#include "perf_counter.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_SAMPLES 100000
+#define BENCH_WINDOW 3600 // 1小时，1s采样
+
+static uint32_t bench_lfsr = 0xACE1u;
+static q16_t bench_window[BENCH_WINDOW];
+
+static uint32_t bench_random(void)
+{
+    bench_lfsr ^= bench_lfsr << 13;
+    bench_lfsr ^= bench_lfsr >> 17;
+    bench_lfsr ^= bench_lfsr << 5;
+    return bench_lfsr;
+}
+
+/**
+ * @brief 生成测试分布样本 (Q16.16)
+ */
+static q16_t bench_sample(int distribution)
+{
+    switch (distribution)
+    {
+    case 0: // 近似正态: 4个均匀分布之和，25.0 ± ~1.2
+        return Q16_CONST(23.0) + (q16_t)((bench_random() & 0xFFFF) + (bench_random() & 0xFFFF) +
+                                         (bench_random() & 0xFFFF) + (bench_random() & 0xFFFF)) /
+                                     4 * 4;
+    case 1: // 均匀: 0 ~ 100
+        return (q16_t)(bench_random() % (100U * 65536U));
+    default: // 右偏: 基线3.3V，少量大幅跌落
+    {
+        uint32_t r = bench_random();
+        q16_t dip = (r & 0x1F) == 0 ? (q16_t)((r >> 8) & 0x3FFFF) : (q16_t)((r >> 8) & 0x3FF);
+        return Q16_CONST(3.3) - dip;
+    }
+    }
+}
+
+static int bench_compare(const void *a, const void *b)
+{
+    q16_t x = *(const q16_t *)a, y = *(const q16_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief 估计值在精确有序样本中的秩误差 (百分点)
+ */
+static double bench_rank_error(const q16_t *sorted, q16_t estimate, double quantile)
+{
+    uint32_t below = 0;
+    while (below < BENCH_WINDOW && sorted[below] < estimate)
+    {
+        below++;
+    }
+    double rank = 100.0 * below / (BENCH_WINDOW - 1);
+    double error = rank - quantile;
+    return error < 0 ? -error : error;
+}
+
+TEST_CASE(stream_stats_memory_footprint)
+{
+    printf("  [PERF] %-36s %8s\n", "per-channel state", "bytes");
+    printf("  [PERF] %-36s %8u\n", "legacy float min/max/EMA", (unsigned)(3 * sizeof(float)));
+    printf("  [PERF] %-36s %8u\n", "stream_stats_t (Welford + P2 x3)", (unsigned)sizeof(stream_stats_t));
+    printf("  [PERF] %-36s %8u\n", "raw 1h window (3600 x q16)", (unsigned)(BENCH_WINDOW * sizeof(q16_t)));
+    printf("  [PERF] %-36s %8u\n", "uplink summary", (unsigned)sizeof(stream_stats_summary_t));
+
+    TEST_ASSERT_LESS_THAN(128, sizeof(stream_stats_t));
+}
+
+TEST_CASE(stream_stats_update_cost)
+{
+    static q16_t samples[1024];
+    stream_stats_t stats;
+    float min = 1e30f, max = -1e30f, avg = 0.0f;
+    uint64_t start, elapsed;
+
+    for (int i = 0; i < 1024; i++)
+    {
+        samples[i] = bench_sample(0);
+    }
+
+    // 原实现: 浮点最值 + EMA
+    start = perf_now();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        float value = q16_to_float(samples[i & 1023]);
+        if (value < min)
+        {
+            min = value;
+        }
+        if (value > max)
+        {
+            max = value;
+        }
+        avg = 0.1f * value + 0.9f * avg;
+    }
+    elapsed = perf_now() - start;
+    perf_sink((uint32_t)(min + max + avg));
+    perf_report("float min/max/EMA per sample", elapsed, BENCH_SAMPLES);
+
+    stream_stats_reset(&stats);
+    start = perf_now();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        stream_stats_update(&stats, samples[i & 1023]);
+    }
+    elapsed = perf_now() - start;
+    perf_sink((uint32_t)stats.heights[4]);
+    perf_report("stream_stats_update per sample", elapsed, BENCH_SAMPLES);
+
+    stream_stats_summary_t summary;
+    start = perf_now();
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        stream_stats_get_summary(&stats, &summary);
+    }
+    elapsed = perf_now() - start;
+    perf_sink((uint32_t)summary.stddev);
+    perf_report("stream_stats_get_summary", elapsed, 1000);
+}
+
+TEST_CASE(stream_stats_percentile_accuracy)
+{
+    static const char *names[3] = {"near-normal 25degC", "uniform 0..100", "skewed 3.3V dips"};
+    stream_stats_t stats;
+    stream_stats_summary_t summary;
+    double worst_error = 0.0;
+
+    printf("  [PERF] %-20s %5s %10s %10s %10s %10s\n", "distribution", "q", "exact", "P2", "rank err%", "err/span%");
+
+    for (int d = 0; d < 3; d++)
+    {
+        bench_lfsr = 0xACE1u + (uint32_t)d;
+        stream_stats_reset(&stats);
+        for (int i = 0; i < BENCH_WINDOW; i++)
+        {
+            bench_window[i] = bench_sample(d);
+            stream_stats_update(&stats, bench_window[i]);
+        }
+        stream_stats_get_summary(&stats, &summary);
+        qsort(bench_window, BENCH_WINDOW, sizeof(q16_t), bench_compare);
+
+        const double quantiles[3] = {50.0, 95.0, 99.0};
+        const q16_t estimates[3] = {summary.p50, summary.p95, summary.p99};
+        for (int q = 0; q < 3; q++)
+        {
+            q16_t exact = bench_window[(uint32_t)(quantiles[q] / 100.0 * (BENCH_WINDOW - 1) + 0.5)];
+            double rank = bench_rank_error(bench_window, estimates[q], quantiles[q]);
+            double span = (double)summary.max - summary.min;
+            double error = 100.0 * ((double)estimates[q] - exact) / span;
+            error = error < 0 ? -error : error;
+            worst_error = error > worst_error ? error : worst_error;
+            printf("  [PERF] %-20s p%-4.0f %10.4f %10.4f %10.3f %10.3f\n", names[d], quantiles[q],
+                   q16_to_float(exact), q16_to_float(estimates[q]), rank, error);
+        }
+    }
+
+    // 估计值误差小于样本跨度的1% (密集区的秩误差会放大，但数值误差很小)
+    TEST_ASSERT_TRUE(worst_error < 1.0);
+}
+
+void run_stream_stats_perf_tests(void)
+{
+    printf("\n=== 运行流式统计性能测试 ===\n");
+
+    RUN_TEST(stream_stats_memory_footprint);
+    RUN_TEST(stream_stats_update_cost);
+    RUN_TEST(stream_stats_percentile_accuracy);
+
+    printf("流式统计性能测试用例已添加完成\n");
+}
@@ -0,0 +1,171 @@
+/**
+ * @file bench_telemetry_codec.c
+ * @brief 遥测载荷编码开销与字节数: JSON (snprintf) 与紧凑二进制对比
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 同一组缓变采样分别编码为:
+ * - JSON: mqtt_encode_sensor_data() / mqtt_encode_device_status()
+ * - 二进制 (浮点输入): mqtt_encode_sensor_payload()，含浮点到定点整数的转换
+ * - 二进制 (定点输入): telemetry_encode_sensor()，采样路径本就是定点数时的开销
+ * 浮点输入路径的时间戳取系统节拍 (测试中较小)，定点输入路径用逐分钟递增的时间戳，两者字节数分别列出
+ * 目标板上PERF_UNIT为周期数 (软浮点的snprintf %.1f/%.2f开销在此体现)，主机上为纳秒
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/mqtt.h"
+#include "../../inc/telemetry_codec.h"
+#include "perf_counter.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_SAMPLES 64
+#define BENCH_ROUNDS 200
+
+static mqtt_sensor_data_t bench_data[BENCH_SAMPLES];
+static telemetry_sensor_t bench_fixed[BENCH_SAMPLES];
+
+static void bench_fill_samples(void)
+{
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        int32_t wave = (int32_t)(i % 16) - 8;
+
+        bench_fixed[i].temperature = 253 + wave;
+        bench_fixed[i].humidity = 612 - wave * 3;
+        bench_fixed[i].voltage = 1205 + wave;
+        bench_fixed[i].current = 125 + wave * 2;
+        bench_fixed[i].power = 1506 + wave * 25;
+        bench_fixed[i].timestamp = 3600000UL + i * 60000UL;
+
+        bench_data[i].temperature = (float)bench_fixed[i].temperature / 10.0f;
+        bench_data[i].humidity = (float)bench_fixed[i].humidity / 10.0f;
+        bench_data[i].voltage = (float)bench_fixed[i].voltage / 100.0f;
+        bench_data[i].current = (float)bench_fixed[i].current / 100.0f;
+        bench_data[i].power = (float)bench_fixed[i].power / 100.0f;
+    }
+}
+
+static void bench_select_format(uint8_t format)
+{
+    mqtt_config_t config;
+
+    memset(&config, 0, sizeof(config));
+    strcpy(config.broker_host, "bench");
+    strcpy(config.client_id, "dtu-0001");
+    config.broker_port = 1883;
+    config.keep_alive = 60;
+    config.payload_format = format;
+
+    mqtt_deinit();
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_init(&config));
+}
+
+static void bench_bytes(const char *name, uint32_t bytes, uint32_t count)
+{
+    printf("  [PERF]   -> %s: %lu.%02lu B per sample\n", name, (unsigned long)(bytes / count),
+           (unsigned long)((bytes % count) * 100 / count));
+}
+
+TEST_CASE(telemetry_sensor_encode)
+{
+    uint8_t buffer[160];
+    uint32_t json_bytes = 0;
+    uint32_t packed_bytes = 0;
+    uint32_t fixed_bytes = 0;
+    uint32_t sink = 0;
+    uint64_t start;
+
+    bench_fill_samples();
+
+    start = perf_now();
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+        {
+            int length = mqtt_encode_sensor_data((char *)buffer, sizeof(buffer), &bench_data[i]);
+            json_bytes += (uint32_t)length;
+        }
+    }
+    perf_report("sensor JSON (snprintf)", perf_now() - start, BENCH_ROUNDS * BENCH_SAMPLES);
+
+    bench_select_format(MQTT_PAYLOAD_PACKED);
+    start = perf_now();
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+        {
+            int length = mqtt_encode_sensor_payload(buffer, sizeof(buffer), &bench_data[i]);
+            packed_bytes += (uint32_t)length;
+        }
+    }
+    perf_report("sensor packed (float input)", perf_now() - start, BENCH_ROUNDS * BENCH_SAMPLES);
+    mqtt_deinit();
+
+    start = perf_now();
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+        {
+            fixed_bytes += telemetry_encode_sensor(buffer, sizeof(buffer), &bench_fixed[i]);
+        }
+    }
+    perf_report("sensor packed (fixed-point input)", perf_now() - start, BENCH_ROUNDS * BENCH_SAMPLES);
+
+    bench_bytes("JSON", json_bytes, BENCH_ROUNDS * BENCH_SAMPLES);
+    bench_bytes("packed (tick timestamp)", packed_bytes, BENCH_ROUNDS * BENCH_SAMPLES);
+    bench_bytes("packed (minute timestamps)", fixed_bytes, BENCH_ROUNDS * BENCH_SAMPLES);
+    TEST_ASSERT_TRUE(fixed_bytes * 4 < json_bytes);
+    TEST_ASSERT_TRUE(packed_bytes * 4 < json_bytes);
+
+    // 主机侧解码
+    uint16_t length = telemetry_encode_sensor(buffer, sizeof(buffer), &bench_fixed[0]);
+    telemetry_record_t record;
+    start = perf_now();
+    for (uint32_t n = 0; n < BENCH_ROUNDS * BENCH_SAMPLES; n++)
+    {
+        sink += telemetry_decode(buffer, length, &record);
+    }
+    perf_report("sensor packed decode", perf_now() - start, BENCH_ROUNDS * BENCH_SAMPLES);
+    perf_sink(sink);
+}
+
+TEST_CASE(telemetry_status_encode)
+{
+    device_status_t status = {true, true, true, false, 86400, 2048};
+    uint8_t buffer[160];
+    int json_length = 0;
+    int packed_length = 0;
+    uint64_t start;
+
+    start = perf_now();
+    for (uint32_t n = 0; n < BENCH_ROUNDS * BENCH_SAMPLES; n++)
+    {
+        status.uptime++;
+        json_length = mqtt_encode_device_status((char *)buffer, sizeof(buffer), &status);
+    }
+    perf_report("status JSON (snprintf)", perf_now() - start, BENCH_ROUNDS * BENCH_SAMPLES);
+
+    bench_select_format(MQTT_PAYLOAD_PACKED);
+    start = perf_now();
+    for (uint32_t n = 0; n < BENCH_ROUNDS * BENCH_SAMPLES; n++)
+    {
+        status.uptime++;
+        packed_length = mqtt_encode_status_payload(buffer, sizeof(buffer), &status);
+    }
+    perf_report("status packed", perf_now() - start, BENCH_ROUNDS * BENCH_SAMPLES);
+    mqtt_deinit();
+
+    printf("  [PERF]   -> status: JSON %d B, packed %d B\n", json_length, packed_length);
+    TEST_ASSERT_TRUE(packed_length > 0 && packed_length * 4 < json_length);
+}
+
+void run_telemetry_codec_perf_tests(void)
+{
+    printf("\n=== 运行遥测载荷编码性能测试 ===\n");
+
+    RUN_TEST(telemetry_sensor_encode);
+    RUN_TEST(telemetry_status_encode);
+
+    printf("遥测载荷编码性能测试用例已添加完成\n");
+}
@@ -0,0 +1,87 @@
+/**
+ * @file bench_trend.c
+ * @brief 多分辨率趋势数据性能测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * - RAM占用: 当前编译配置的实际值，以及不同桶数配置的估算
+ * - 单样本更新开销 (三级累加器同时更新，含封桶)
+ * - 各级查询开销 (O(桶数)，无Flash读取)
+ */
+
+#include "../framework/unity.h"
+#include "../../inc/trend.h"
+#include "perf_counter.h"
+#include <stdio.h>
+
+#define BENCH_SAMPLES 100000
+
+static trend_point_t bench_points[TREND_MINUTE_BUCKETS + 1];
+
+/**
+ * @brief 按桶数估算RAM (与trend.c中存储布局一致)
+ */
+static uint32_t bench_ram_estimate(uint32_t channels, uint32_t minutes, uint32_t hours, uint32_t days)
+{
+    uint32_t ring = sizeof(int64_t) + sizeof(trend_accumulator_t); // head/filled按累加器的int64对齐
+    return channels * ((minutes + hours + days) * sizeof(trend_bucket_t) + TREND_LEVEL_COUNT * ring + 1);
+}
+
+TEST_CASE(trend_ram_usage)
+{
+    printf("  [PERF] %-32s %8s\n", "configuration", "bytes");
+    printf("  [PERF] %-32s %8lu (build: %dch %d/%d/%d)\n", "current build",
+           (unsigned long)trend_get_ram_usage(), TREND_CHANNELS,
+           TREND_MINUTE_BUCKETS, TREND_HOUR_BUCKETS, TREND_DAY_BUCKETS);
+    printf("  [PERF] %-32s %8lu\n", "3ch 60m/24h/7d", (unsigned long)bench_ram_estimate(3, 60, 24, 7));
+    printf("  [PERF] %-32s %8lu\n", "3ch 30m/12h/3d", (unsigned long)bench_ram_estimate(3, 30, 12, 3));
+    printf("  [PERF] %-32s %8lu\n", "8ch 60m/24h/7d", (unsigned long)bench_ram_estimate(8, 60, 24, 7));
+    printf("  [PERF] %-32s %8lu\n", "raw 1Hz x 1h x 3ch (q16)", (unsigned long)(3UL * 3600 * sizeof(q16_t)));
+
+    TEST_ASSERT_EQUAL(bench_ram_estimate(TREND_CHANNELS, TREND_MINUTE_BUCKETS, TREND_HOUR_BUCKETS, TREND_DAY_BUCKETS),
+                      trend_get_ram_usage());
+}
+
+TEST_CASE(trend_update_and_query_cost)
+{
+    uint64_t start, elapsed;
+    uint32_t acc = 0;
+
+    trend_init();
+
+    // 1Hz采样连续运行约28小时
+    start = perf_now();
+    for (uint32_t t = 0; t < BENCH_SAMPLES; t++)
+    {
+        trend_add_sample(0, Q16_CONST(25.0) + (q16_t)((t * 37) & 0xFFFF), t);
+    }
+    elapsed = perf_now() - start;
+    perf_report("trend_add_sample (3 levels)", elapsed, BENCH_SAMPLES);
+
+    static const char *names[TREND_LEVEL_COUNT] = {"trend_query minute (61 pts)", "trend_query hour (25 pts)",
+                                                   "trend_query day (2 pts)"};
+    for (uint8_t level = 0; level < TREND_LEVEL_COUNT; level++)
+    {
+        uint16_t count = 0;
+        start = perf_now();
+        for (uint32_t i = 0; i < 10000; i++)
+        {
+            count = trend_query(0, (trend_level_t)level, bench_points, TREND_MINUTE_BUCKETS + 1);
+            acc += (uint32_t)bench_points[0].avg;
+        }
+        elapsed = perf_now() - start;
+        perf_report(names[level], elapsed, 10000);
+        TEST_ASSERT_GREATER_THAN(0, count);
+    }
+    perf_sink(acc);
+}
+
+void run_trend_perf_tests(void)
+{
+    printf("\n=== 运行趋势数据性能测试 ===\n");
+
+    RUN_TEST(trend_ram_usage);
+    RUN_TEST(trend_update_and_query_cost);
+
+    printf("趋势数据性能测试用例已添加完成\n");
+}
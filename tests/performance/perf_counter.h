@@ -0,0 +1,93 @@
+/**
+ * @file perf_counter.h
+ * @brief 憨云DTU性能测试计时工具
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 主机环境使用CLOCK_MONOTONIC纳秒计时；目标板(Cortex-M0无DWT)使用SysTick计数。
+ * 指令数可在QEMU下统计:
+ *   qemu-arm -plugin libinsn.so -d plugin ./test_runner
+ */
+
+#ifndef PERF_COUNTER_H
+#define PERF_COUNTER_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#if defined(__arm__) && !defined(__linux__)
+
+#define PERF_SYST_CVR (*(volatile uint32_t *)0xE000E018UL) // SysTick当前值 (递减)
+#define PERF_SYST_RVR (*(volatile uint32_t *)0xE000E014UL) // SysTick重载值
+
+/**
+ * @brief 读取计数器 (CPU周期，单次测量须小于一个SysTick周期)
+ */
+static inline uint64_t perf_now(void)
+{
+    return (uint64_t)(PERF_SYST_RVR - PERF_SYST_CVR);
+}
+
+/**
+ * @brief 自start以来的周期数 (允许SysTick回绕一次，测量段须短于一个SysTick周期)
+ */
+static inline uint64_t perf_elapsed(uint64_t start)
+{
+    uint64_t now = perf_now();
+    return now >= start ? now - start : now + PERF_SYST_RVR + 1U - start;
+}
+
+#define PERF_UNIT "cycles"
+
+#else
+
+#include <time.h>
+
+/**
+ * @brief 读取计数器 (纳秒)
+ */
+static inline uint64_t perf_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 自start以来的纳秒数
+ */
+static inline uint64_t perf_elapsed(uint64_t start)
+{
+    return perf_now() - start;
+}
+
+#define PERF_UNIT "ns"
+
+#endif
+
+static volatile uint32_t perf_sink_value;
+
+/**
+ * @brief 防止编译器优化掉被测结果
+ */
+static inline void perf_sink(uint32_t value)
+{
+    perf_sink_value = value;
+}
+
+/**
+ * @brief 打印单项测量结果
+ * @param name 测试项名称
+ * @param elapsed 总耗时
+ * @param iterations 迭代次数
+ */
+static inline void perf_report(const char *name, uint64_t elapsed, uint32_t iterations)
+{
+    uint64_t per_op_x100 = iterations ? (elapsed * 100ULL) / iterations : 0;
+    printf("  [PERF] %-40s %8lu.%02lu %s/op (%lu ops)\n",
+           name,
+           (unsigned long)(per_op_x100 / 100), (unsigned long)(per_op_x100 % 100),
+           PERF_UNIT, (unsigned long)iterations);
+}
+
+#endif // PERF_COUNTER_H
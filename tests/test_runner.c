@@ -28,12 +28,25 @@ extern void run_adc_tests(void);
 // 应用模块测试
 extern void run_modbus_tests(void);
 extern void run_sensor_tests(void);
+extern void run_filter_tests(void);
+extern void run_sensor_lut_tests(void);
+extern void run_stream_stats_tests(void);
+extern void run_trend_tests(void);
+extern void run_flash_log_tests(void);
+extern void run_history_codec_tests(void);
+extern void run_config_journal_tests(void);
 extern void run_storage_tests(void);
+extern void run_poll_window_tests(void);
+extern void run_history_export_tests(void);
 extern void run_alarm_tests(void);
+extern void run_alarm_expr_tests(void);
+extern void run_alarm_notify_tests(void);
+extern void run_mqtt_queue_tests(void);
 
 // 无线模块测试
 extern void run_lora_tests(void);
 extern void run_mqtt_tests(void);
+extern void run_telemetry_codec_tests(void);
 extern void run_4g_tests(void);
 extern void run_bluetooth_tests(void);
 
@@ -41,6 +54,29 @@ extern void run_bluetooth_tests(void);
 extern void run_power_tests(void);
 extern void run_config_tests(void);
 
+// 性能测试
+extern void run_sensor_fixed_perf_tests(void);
+extern void run_filter_perf_tests(void);
+extern void run_adc_scan_perf_tests(void);
+extern void run_sensor_jitter_perf_tests(void);
+extern void run_adc_oversample_perf_tests(void);
+extern void run_sensor_deadband_perf_tests(void);
+extern void run_sensor_lut_perf_tests(void);
+extern void run_stream_stats_perf_tests(void);
+extern void run_trend_perf_tests(void);
+extern void run_flash_log_perf_tests(void);
+extern void run_history_codec_perf_tests(void);
+extern void run_config_journal_perf_tests(void);
+extern void run_storage_async_perf_tests(void);
+extern void run_flash_log_mount_perf_tests(void);
+extern void run_history_export_perf_tests(void);
+extern void run_alarm_rules_perf_tests(void);
+extern void run_alarm_expr_perf_tests(void);
+extern void run_alarm_notify_perf_tests(void);
+extern void run_mqtt_perf_tests(void);
+extern void run_mqtt_queue_perf_tests(void);
+extern void run_telemetry_codec_perf_tests(void);
+
 // =============================================================================
 // 测试套件定义
 // =============================================================================
@@ -66,18 +102,54 @@ static test_suite_t test_suites[] = {
     // 应用模块测试
     {"Modbus通信", run_modbus_tests, true, 3},
     {"传感器管理", run_sensor_tests, true, 3},
+    {"数字滤波器", run_filter_tests, true, 3},
+    {"传感器查找表", run_sensor_lut_tests, true, 3},
+    {"流式统计", run_stream_stats_tests, true, 3},
+    {"趋势数据", run_trend_tests, true, 3},
+    {"Flash日志存储", run_flash_log_tests, true, 3},
+    {"历史数据压缩编码", run_history_codec_tests, true, 3},
+    {"配置日志存储", run_config_journal_tests, true, 3},
     {"数据存储", run_storage_tests, true, 3},
+    {"轮询空闲窗口", run_poll_window_tests, true, 3},
+    {"历史数据导出", run_history_export_tests, true, 3},
     {"报警系统", run_alarm_tests, true, 3},
+    {"报警表达式", run_alarm_expr_tests, true, 3},
+    {"报警通知", run_alarm_notify_tests, true, 3},
+    {"MQTT离线队列", run_mqtt_queue_tests, true, 3},
 
     // 无线模块测试
     {"LoRa通信", run_lora_tests, true, 4},
     {"MQTT通信", run_mqtt_tests, true, 4},
+    {"遥测载荷编解码", run_telemetry_codec_tests, true, 4},
     {"4G通信", run_4g_tests, true, 4},
     {"蓝牙通信", run_bluetooth_tests, true, 4},
 
     // 系统模块测试
     {"功耗管理", run_power_tests, true, 5},
     {"配置管理", run_config_tests, true, 5},
+
+    // 性能测试
+    {"性能: 传感器定点转换", run_sensor_fixed_perf_tests, true, 6},
+    {"性能: 数字滤波器", run_filter_perf_tests, true, 6},
+    {"性能: ADC扫描组", run_adc_scan_perf_tests, true, 6},
+    {"性能: 传感器采样抖动", run_sensor_jitter_perf_tests, true, 6},
+    {"性能: ADC过采样", run_adc_oversample_perf_tests, true, 6},
+    {"性能: 传感器死区上报", run_sensor_deadband_perf_tests, true, 6},
+    {"性能: 传感器查找表", run_sensor_lut_perf_tests, true, 6},
+    {"性能: 流式统计", run_stream_stats_perf_tests, true, 6},
+    {"性能: 趋势数据", run_trend_perf_tests, true, 6},
+    {"性能: Flash日志存储", run_flash_log_perf_tests, true, 6},
+    {"性能: 历史数据压缩编码", run_history_codec_perf_tests, true, 6},
+    {"性能: 配置日志存储", run_config_journal_perf_tests, true, 6},
+    {"性能: 存储作业队列", run_storage_async_perf_tests, true, 6},
+    {"性能: 记录日志挂载", run_flash_log_mount_perf_tests, true, 6},
+    {"性能: 历史数据导出", run_history_export_perf_tests, true, 6},
+    {"性能: 报警规则索引", run_alarm_rules_perf_tests, true, 6},
+    {"性能: 报警表达式", run_alarm_expr_perf_tests, true, 6},
+    {"性能: 报警通知", run_alarm_notify_perf_tests, true, 6},
+    {"性能: MQTT", run_mqtt_perf_tests, true, 6},
+    {"性能: MQTT离线队列", run_mqtt_queue_perf_tests, true, 6},
+    {"性能: 遥测载荷", run_telemetry_codec_perf_tests, true, 6},
 };
 
 #define TEST_SUITE_COUNT (sizeof(test_suites) / sizeof(test_suites[0]))
@@ -0,0 +1,559 @@
+/**
+ * @file test_alarm.c
+ * @brief 报警监控模块单元测试
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/alarm.h"
+#include "../../../inc/storage.h"
+#include "../../../inc/flash.h"
+#include "../../../inc/system.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_TRACE_SECONDS 600
+
+/**
+ * @brief 添加一条立即生效的阈值规则 (条件: 大于threshold)
+ */
+static bool test_add_rule(uint8_t id, uint8_t type, uint8_t level, int32_t threshold, uint8_t output_mask)
+{
+    alarm_rule_t rule;
+
+    memset(&rule, 0, sizeof(rule));
+    rule.id = id;
+    rule.type = type;
+    rule.level = level;
+    rule.condition = ALARM_CONDITION_GT;
+    rule.enabled = true;
+    rule.threshold_high = threshold;
+    rule.output_mask = output_mask;
+    snprintf(rule.description, sizeof(rule.description), "rule %u", (unsigned)id);
+    return alarm_add_rule(&rule);
+}
+
+/**
+ * @brief 断言规则当前状态
+ */
+static void test_expect_state(uint8_t id, alarm_state_t expected)
+{
+    alarm_info_t info;
+
+    TEST_ASSERT_TRUE(alarm_get_info(id, &info));
+    TEST_ASSERT_EQUAL(expected, info.state);
+}
+
+/**
+ * @brief 系统时钟前进 (ms)
+ */
+static void test_advance(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        system_tick_increment();
+    }
+}
+
+/**
+ * @brief 噪声温度曲线 (1Hz): 580缓升到640、保持、再缓降到570，叠加±8均匀噪声；
+ *        低于590时每97秒有一个+50的单点干扰尖峰 (第0/485/582秒)
+ */
+static int32_t test_trace_value(uint32_t second, uint32_t *seed)
+{
+    int32_t base;
+
+    if (second < 120)
+    {
+        base = 580 + (int32_t)(second / 2);
+    }
+    else if (second < 300)
+    {
+        base = 640;
+    }
+    else if (second < 440)
+    {
+        base = 640 - (int32_t)((second - 300) / 2);
+    }
+    else
+    {
+        base = 570;
+    }
+
+    *seed = *seed * 1103515245UL + 12345UL;
+    if (base < 590 && second % 97 == 0)
+    {
+        return base + 50;
+    }
+    return base + (int32_t)((*seed >> 16) % 17) - 8;
+}
+
+/**
+ * @brief 回放噪声曲线
+ * @param records 输出写入的报警/解除记录数 (失败时为0)
+ * @param first_active 输出首次进入报警的时刻 (秒)
+ */
+static void test_replay(int32_t hysteresis, uint32_t debounce_time, uint32_t clear_delay, uint32_t *records,
+                        uint32_t *first_active)
+{
+    alarm_rule_t rule;
+    alarm_stats_t stats;
+    uint32_t seed = 7;
+
+    *records = 0;
+    *first_active = 0;
+    alarm_init();
+    memset(&rule, 0, sizeof(rule));
+    rule.id = 1;
+    rule.type = ALARM_TYPE_TEMPERATURE;
+    rule.level = ALARM_LEVEL_WARNING;
+    rule.condition = ALARM_CONDITION_GT;
+    rule.enabled = true;
+    rule.threshold_high = 600;
+    rule.hysteresis = hysteresis;
+    rule.debounce_time = debounce_time;
+    rule.clear_delay = clear_delay;
+    TEST_ASSERT_TRUE(alarm_add_rule(&rule));
+
+    for (uint32_t t = 0; t < TEST_TRACE_SECONDS; t++)
+    {
+        alarm_check_condition(ALARM_TYPE_TEMPERATURE, test_trace_value(t, &seed));
+        alarm_process();
+        if (*first_active == 0 && alarm_get_active_count() > 0)
+        {
+            *first_active = t;
+        }
+        test_advance(1000);
+    }
+
+    TEST_ASSERT_TRUE(alarm_get_stats(&stats));
+    *records = stats.total_alarms + stats.auto_resolved;
+}
+
+TEST_SETUP()
+{
+    alarm_init();
+}
+
+TEST_TEARDOWN()
+{
+    alarm_deinit();
+}
+
+TEST_CASE(alarm_type_index_dispatch)
+{
+    alarm_init();
+
+    // 类型交错添加，检查只作用于同类型规则
+    TEST_ASSERT_TRUE(test_add_rule(10, ALARM_TYPE_HUMIDITY, ALARM_LEVEL_WARNING, 900, ALARM_OUTPUT_LED));
+    TEST_ASSERT_TRUE(test_add_rule(11, ALARM_TYPE_TEMPERATURE, ALARM_LEVEL_WARNING, 600, ALARM_OUTPUT_LED));
+    TEST_ASSERT_TRUE(test_add_rule(12, ALARM_TYPE_VOLTAGE, ALARM_LEVEL_ERROR, 3300, ALARM_OUTPUT_BUZZER));
+    TEST_ASSERT_TRUE(test_add_rule(13, ALARM_TYPE_TEMPERATURE, ALARM_LEVEL_CRITICAL, 800, ALARM_OUTPUT_BUZZER));
+    TEST_ASSERT_TRUE(test_add_rule(14, ALARM_TYPE_CUSTOM, ALARM_LEVEL_INFO, 0, 0));
+    TEST_ASSERT_FALSE(test_add_rule(11, ALARM_TYPE_HUMIDITY, ALARM_LEVEL_INFO, 0, 0));
+
+    TEST_ASSERT_TRUE(alarm_check_condition(ALARM_TYPE_TEMPERATURE, 700));
+    test_expect_state(11, ALARM_STATE_ACTIVE);
+    test_expect_state(13, ALARM_STATE_IDLE);
+    test_expect_state(10, ALARM_STATE_IDLE);
+    test_expect_state(12, ALARM_STATE_IDLE);
+    TEST_ASSERT_TRUE(alarm_has_type(ALARM_TYPE_TEMPERATURE));
+    TEST_ASSERT_FALSE(alarm_has_type(ALARM_TYPE_HUMIDITY));
+    TEST_ASSERT_FALSE(alarm_check_condition(ALARM_TYPE_SENSOR_FAULT, 1));
+
+    // 删除中间的规则后，被移入空槽位的规则仍按类型与状态命中
+    alarm_rule_t rule;
+    TEST_ASSERT_TRUE(alarm_remove_rule(10));
+    TEST_ASSERT_FALSE(alarm_get_rule(10, &rule));
+    test_expect_state(11, ALARM_STATE_ACTIVE);
+    TEST_ASSERT_TRUE(alarm_check_condition(ALARM_TYPE_CUSTOM, 5));
+    test_expect_state(14, ALARM_STATE_ACTIVE);
+    TEST_ASSERT_EQUAL(2, alarm_get_active_count());
+    TEST_ASSERT_FALSE(alarm_check_condition(ALARM_TYPE_HUMIDITY, 1000));
+
+    // 修改规则类型后索引随之更新
+    TEST_ASSERT_TRUE(alarm_get_rule(12, &rule));
+    rule.type = ALARM_TYPE_HUMIDITY;
+    rule.threshold_high = 900;
+    TEST_ASSERT_TRUE(alarm_update_rule(&rule));
+    TEST_ASSERT_FALSE(alarm_check_condition(ALARM_TYPE_VOLTAGE, 5000));
+    TEST_ASSERT_TRUE(alarm_check_condition(ALARM_TYPE_HUMIDITY, 950));
+    test_expect_state(12, ALARM_STATE_ACTIVE);
+}
+
+TEST_CASE(alarm_bitset_counts)
+{
+    alarm_init();
+
+    TEST_ASSERT_TRUE(test_add_rule(1, ALARM_TYPE_TEMPERATURE, ALARM_LEVEL_WARNING, 600, ALARM_OUTPUT_LED));
+    TEST_ASSERT_TRUE(test_add_rule(2, ALARM_TYPE_TEMPERATURE, ALARM_LEVEL_CRITICAL, 800, ALARM_OUTPUT_BUZZER));
+    TEST_ASSERT_TRUE(test_add_rule(3, ALARM_TYPE_VOLTAGE, ALARM_LEVEL_WARNING, 3300, ALARM_OUTPUT_LED));
+    TEST_ASSERT_TRUE(test_add_rule(4, ALARM_TYPE_HUMIDITY, ALARM_LEVEL_ERROR, 900, ALARM_OUTPUT_RELAY));
+
+    TEST_ASSERT_TRUE(alarm_check_condition(ALARM_TYPE_TEMPERATURE, 900));
+    TEST_ASSERT_TRUE(alarm_check_condition(ALARM_TYPE_VOLTAGE, 3400));
+    TEST_ASSERT_EQUAL(3, alarm_get_active_count());
+    TEST_ASSERT_EQUAL(2, alarm_get_level_count(ALARM_LEVEL_WARNING));
+    TEST_ASSERT_EQUAL(1, alarm_get_level_count(ALARM_LEVEL_CRITICAL));
+    TEST_ASSERT_EQUAL(0, alarm_get_level_count(ALARM_LEVEL_ERROR));
+    TEST_ASSERT_EQUAL(0, alarm_get_level_count(9));
+    TEST_ASSERT_TRUE(alarm_has_level(ALARM_LEVEL_CRITICAL));
+    TEST_ASSERT_FALSE(alarm_has_level(ALARM_LEVEL_ERROR));
+
+    alarm_stats_t stats;
+    TEST_ASSERT_TRUE(alarm_get_stats(&stats));
+    TEST_ASSERT_EQUAL(3, stats.active_alarms);
+
+    // 确认后不再计入激活数，但仍在处理集合中
+    TEST_ASSERT_TRUE(alarm_acknowledge(2));
+    TEST_ASSERT_FALSE(alarm_acknowledge(2));
+    TEST_ASSERT_EQUAL(2, alarm_get_active_count());
+    TEST_ASSERT_FALSE(alarm_has_level(ALARM_LEVEL_CRITICAL));
+    TEST_ASSERT_EQUAL(2, alarm_acknowledge_all());
+    TEST_ASSERT_EQUAL(0, alarm_get_active_count());
+    test_expect_state(1, ALARM_STATE_ACKNOWLEDGED);
+
+    TEST_ASSERT_EQUAL(3, alarm_resolve_all());
+    TEST_ASSERT_EQUAL(0, alarm_resolve_all());
+    test_expect_state(3, ALARM_STATE_RESOLVED);
+    test_expect_state(4, ALARM_STATE_IDLE);
+
+    // 禁用激活中的规则即解决
+    TEST_ASSERT_TRUE(alarm_trigger(4, 1000));
+    TEST_ASSERT_EQUAL(1, alarm_get_level_count(ALARM_LEVEL_ERROR));
+    TEST_ASSERT_TRUE(alarm_enable_rule(4, false));
+    TEST_ASSERT_EQUAL(0, alarm_get_active_count());
+}
+
+TEST_CASE(alarm_rule_capacity)
+{
+    alarm_init();
+
+    // 规则填满 (跨越多个位图字时) 计数与按类型分发保持正确
+    uint8_t added = 0;
+    for (uint16_t i = 0; i < ALARM_MAX_RULES; i++)
+    {
+        uint8_t type = (i % 4 == 0) ? ALARM_TYPE_VOLTAGE : (uint8_t)(0x10 + i % 7);
+        if (test_add_rule((uint8_t)i, type, (uint8_t)(i % 4), 100, (uint8_t)(1U << (i % 8))))
+        {
+            added++;
+        }
+    }
+    TEST_ASSERT_EQUAL(ALARM_MAX_RULES, added);
+    TEST_ASSERT_FALSE(test_add_rule(0xFF, ALARM_TYPE_VOLTAGE, ALARM_LEVEL_INFO, 0, 0));
+
+    TEST_ASSERT_TRUE(alarm_check_condition(ALARM_TYPE_VOLTAGE, 200));
+    TEST_ASSERT_EQUAL((ALARM_MAX_RULES + 3) / 4, alarm_get_active_count());
+    TEST_ASSERT_EQUAL((ALARM_MAX_RULES + 3) / 4, alarm_get_level_count(ALARM_LEVEL_INFO));
+    test_expect_state((uint8_t)((ALARM_MAX_RULES - 1) / 4 * 4), ALARM_STATE_ACTIVE);
+
+    TEST_ASSERT_FALSE(alarm_check_condition(ALARM_TYPE_VOLTAGE, 200));
+    TEST_ASSERT_FALSE(alarm_check_condition(ALARM_TYPE_VOLTAGE, 50));
+    TEST_ASSERT_EQUAL(0, alarm_get_active_count());
+}
+
+TEST_CASE(alarm_on_delay)
+{
+    alarm_init();
+
+    alarm_rule_t rule;
+    memset(&rule, 0, sizeof(rule));
+    rule.id = 1;
+    rule.type = ALARM_TYPE_VOLTAGE;
+    rule.level = ALARM_LEVEL_ERROR;
+    rule.condition = ALARM_CONDITION_LT;
+    rule.enabled = true;
+    rule.threshold_low = 2800;
+    rule.debounce_time = 3000;
+    TEST_ASSERT_TRUE(alarm_add_rule(&rule));
+
+    // 短暂跌落: 待定后恢复，不激活、不写记录，计为误报
+    TEST_ASSERT_FALSE(alarm_check_condition(ALARM_TYPE_VOLTAGE, 2700));
+    test_expect_state(1, ALARM_STATE_PENDING);
+    test_advance(2000);
+    alarm_process();
+    test_expect_state(1, ALARM_STATE_PENDING);
+    alarm_check_condition(ALARM_TYPE_VOLTAGE, 2900);
+    test_expect_state(1, ALARM_STATE_IDLE);
+
+    alarm_stats_t stats;
+    alarm_history_t history[4];
+    TEST_ASSERT_TRUE(alarm_get_stats(&stats));
+    TEST_ASSERT_EQUAL(1, stats.false_alarms);
+    TEST_ASSERT_EQUAL(0, alarm_get_history(history, 4));
+
+    // 持续跌落: 报警延时到后由alarm_process()激活
+    alarm_check_condition(ALARM_TYPE_VOLTAGE, 2700);
+    test_advance(2999);
+    alarm_check_condition(ALARM_TYPE_VOLTAGE, 2650);
+    alarm_process();
+    test_expect_state(1, ALARM_STATE_PENDING);
+    test_advance(1);
+    alarm_process();
+    test_expect_state(1, ALARM_STATE_ACTIVE);
+    TEST_ASSERT_EQUAL(1, alarm_get_history(history, 4));
+    TEST_ASSERT_EQUAL(ALARM_STATE_ACTIVE, history[0].state);
+    TEST_ASSERT_EQUAL(2650, history[0].value);
+}
+
+TEST_CASE(alarm_disable_clears_state)
+{
+    alarm_rule_t rule;
+    alarm_history_t history[4];
+
+    alarm_init();
+    TEST_ASSERT_TRUE(test_add_rule(1, ALARM_TYPE_TEMPERATURE, ALARM_LEVEL_WARNING, 600, ALARM_OUTPUT_LED));
+    TEST_ASSERT_TRUE(test_add_rule(2, ALARM_TYPE_VOLTAGE, ALARM_LEVEL_ERROR, 3300, ALARM_OUTPUT_LED));
+    TEST_ASSERT_TRUE(alarm_get_rule(1, &rule));
+    rule.debounce_time = 3000;
+    TEST_ASSERT_TRUE(alarm_update_rule(&rule));
+
+    // 待定中禁用: 回到空闲，不产生记录，延时到后也不激活
+    alarm_check_condition(ALARM_TYPE_TEMPERATURE, 700);
+    test_expect_state(1, ALARM_STATE_PENDING);
+    TEST_ASSERT_TRUE(alarm_enable_rule(1, false));
+    test_expect_state(1, ALARM_STATE_IDLE);
+    TEST_ASSERT_TRUE(alarm_enable_rule(1, true));
+    test_advance(3000);
+    alarm_process();
+    test_expect_state(1, ALARM_STATE_IDLE);
+    TEST_ASSERT_EQUAL(0, alarm_get_history(history, 4));
+
+    // 已确认后经alarm_update_rule()禁用: 按手动解决处理
+    TEST_ASSERT_TRUE(alarm_check_condition(ALARM_TYPE_VOLTAGE, 3400));
+    TEST_ASSERT_TRUE(alarm_acknowledge(2));
+    TEST_ASSERT_TRUE(alarm_get_rule(2, &rule));
+    rule.enabled = false;
+    TEST_ASSERT_TRUE(alarm_update_rule(&rule));
+    test_expect_state(2, ALARM_STATE_RESOLVED);
+    TEST_ASSERT_EQUAL(0, alarm_resolve_all());
+    TEST_ASSERT_EQUAL(0, alarm_acknowledge_all());
+}
+
+TEST_CASE(alarm_hysteresis_and_off_delay)
+{
+    alarm_init();
+
+    alarm_rule_t rule;
+    memset(&rule, 0, sizeof(rule));
+    rule.id = 1;
+    rule.type = ALARM_TYPE_TEMPERATURE;
+    rule.level = ALARM_LEVEL_WARNING;
+    rule.condition = ALARM_CONDITION_GT;
+    rule.enabled = true;
+    rule.threshold_high = 600;
+    rule.hysteresis = 20;
+    rule.clear_delay = 5000;
+    TEST_ASSERT_TRUE(alarm_add_rule(&rule));
+
+    TEST_ASSERT_TRUE(alarm_check_condition(ALARM_TYPE_TEMPERATURE, 610));
+    test_expect_state(1, ALARM_STATE_ACTIVE);
+
+    // 回差带内 (580~600) 保持激活
+    alarm_check_condition(ALARM_TYPE_TEMPERATURE, 590);
+    test_advance(10000);
+    alarm_process();
+    test_expect_state(1, ALARM_STATE_ACTIVE);
+
+    // 低于解除阈值但未持续到解除延时，再次越过回差带则重新计时
+    alarm_check_condition(ALARM_TYPE_TEMPERATURE, 575);
+    test_advance(4000);
+    alarm_process();
+    alarm_check_condition(ALARM_TYPE_TEMPERATURE, 585);
+    test_advance(4000);
+    alarm_process();
+    test_expect_state(1, ALARM_STATE_ACTIVE);
+
+    // 确认后解除延时仍然有效
+    TEST_ASSERT_TRUE(alarm_acknowledge(1));
+    alarm_check_condition(ALARM_TYPE_TEMPERATURE, 570);
+    test_advance(4999);
+    alarm_process();
+    test_expect_state(1, ALARM_STATE_ACKNOWLEDGED);
+    test_advance(1);
+    alarm_process();
+    test_expect_state(1, ALARM_STATE_RESOLVED);
+
+    // 已解决后回到正常即重新布防
+    TEST_ASSERT_TRUE(alarm_check_condition(ALARM_TYPE_TEMPERATURE, 620));
+    test_expect_state(1, ALARM_STATE_ACTIVE);
+
+    // 手动解决后条件仍在: 不反复报警，直到回到解除阈值以下
+    TEST_ASSERT_TRUE(alarm_resolve(1));
+    TEST_ASSERT_FALSE(alarm_check_condition(ALARM_TYPE_TEMPERATURE, 630));
+    test_expect_state(1, ALARM_STATE_RESOLVED);
+    alarm_check_condition(ALARM_TYPE_TEMPERATURE, 590);
+    test_expect_state(1, ALARM_STATE_RESOLVED);
+    alarm_check_condition(ALARM_TYPE_TEMPERATURE, 580);
+    test_expect_state(1, ALARM_STATE_IDLE);
+    TEST_ASSERT_TRUE(alarm_check_condition(ALARM_TYPE_TEMPERATURE, 630));
+}
+
+TEST_CASE(alarm_noisy_trace_replay)
+{
+    uint32_t records;
+    uint32_t first_active;
+
+    // 无延时、无回差: 阈值附近的噪声反复触发/解除
+    test_replay(0, 0, 0, &records, &first_active);
+    TEST_ASSERT_TRUE(records >= 20);
+
+    // 只有回差: 噪声不再引起反复，但每个干扰尖峰仍产生一次报警和解除
+    test_replay(20, 0, 0, &records, &first_active);
+    TEST_ASSERT_EQUAL(2 + 3 * 2, records);
+
+    // 延时 + 回差: 整段曲线只产生一次报警和一次解除
+    test_replay(20, 5000, 10000, &records, &first_active);
+    TEST_ASSERT_EQUAL(2, records);
+    TEST_ASSERT_TRUE(first_active > 40 && first_active < 120);
+    TEST_ASSERT_EQUAL(0, alarm_get_active_count());
+    test_expect_state(1, ALARM_STATE_IDLE);
+
+    alarm_history_t history[4];
+    TEST_ASSERT_EQUAL(2, alarm_get_history(history, 4));
+    TEST_ASSERT_EQUAL(ALARM_STATE_ACTIVE, history[0].state);
+    TEST_ASSERT_EQUAL(ALARM_STATE_RESOLVED, history[1].state);
+    TEST_ASSERT_TRUE(history[1].duration > 300000);
+}
+
+/**
+ * @brief 产生count条历史记录: 偶数条为激活 (值700+序号/2)，奇数条为解除，每条间隔1秒
+ */
+static void test_generate_history(uint16_t count, bool with_storage)
+{
+    for (uint16_t k = 0; k < count; k++)
+    {
+        alarm_check_condition(ALARM_TYPE_TEMPERATURE, (k & 1) ? 500 : 700 + (int32_t)(k / 2));
+        alarm_process();
+        if (with_storage)
+        {
+            storage_task();
+        }
+        test_advance(1000);
+    }
+}
+
+TEST_CASE(alarm_history_wraparound)
+{
+    static alarm_history_t history[ALARM_MAX_HISTORY];
+    alarm_stats_t stats;
+
+    alarm_init();
+    TEST_ASSERT_TRUE(test_add_rule(1, ALARM_TYPE_TEMPERATURE, ALARM_LEVEL_WARNING, 600, 0));
+
+    // 100条记录写入64条的环: 保留最新64条且按时间顺序 (存储未初始化，无法转存)
+    test_generate_history(100, false);
+    TEST_ASSERT_EQUAL(ALARM_MAX_HISTORY, alarm_get_history(history, ALARM_MAX_HISTORY));
+    for (uint16_t i = 0; i < ALARM_MAX_HISTORY; i++)
+    {
+        uint16_t k = (uint16_t)(100 - ALARM_MAX_HISTORY + i);
+        TEST_ASSERT_EQUAL(1, history[i].rule_id);
+        if (k & 1)
+        {
+            TEST_ASSERT_EQUAL(ALARM_STATE_RESOLVED, history[i].state);
+            TEST_ASSERT_EQUAL(ALARM_MSG_CONDITION_CLEARED, history[i].message);
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL(ALARM_STATE_ACTIVE, history[i].state);
+            TEST_ASSERT_EQUAL(ALARM_MSG_CONDITION_MET, history[i].message);
+            TEST_ASSERT_EQUAL(700 + k / 2, history[i].value);
+        }
+        if (i > 0)
+        {
+            TEST_ASSERT_EQUAL(1000, history[i].timestamp - history[i - 1].timestamp);
+        }
+    }
+
+    // 取最新的若干条
+    TEST_ASSERT_EQUAL(2, alarm_get_history(history, 2));
+    TEST_ASSERT_EQUAL(ALARM_STATE_ACTIVE, history[0].state);
+    TEST_ASSERT_EQUAL(749, history[0].value);
+    TEST_ASSERT_EQUAL(ALARM_STATE_RESOLVED, history[1].state);
+
+    TEST_ASSERT_TRUE(alarm_get_stats(&stats));
+    TEST_ASSERT_EQUAL(100 - ALARM_MAX_HISTORY, stats.history_dropped);
+    TEST_ASSERT_EQUAL(0, stats.history_spilled);
+
+    TEST_ASSERT_EQUAL_STRING("Condition cleared", alarm_get_message(ALARM_MSG_CONDITION_CLEARED));
+    TEST_ASSERT_EQUAL_STRING("", alarm_get_message(ALARM_MSG_COUNT));
+}
+
+TEST_CASE(alarm_history_spill)
+{
+    storage_alarm_record_t records[8];
+    alarm_stats_t stats;
+
+    alarm_deinit();
+    storage_deinit();
+    flash_sim_reset();
+    TEST_ASSERT_TRUE(storage_init());
+    alarm_init();
+    TEST_ASSERT_TRUE(test_add_rule(1, ALARM_TYPE_TEMPERATURE, ALARM_LEVEL_WARNING, 600, 0));
+
+    // 最旧的记录在环满前批量转存，不丢失
+    test_generate_history(300, true);
+    TEST_ASSERT_TRUE(alarm_get_stats(&stats));
+    TEST_ASSERT_EQUAL(0, stats.history_dropped);
+    TEST_ASSERT_TRUE(stats.history_spilled >= 300 - ALARM_HISTORY_SPILL_THRESHOLD);
+
+    // 全部转存后Flash日志区 (回绕后) 保留的历史多于RAM环
+    alarm_flush_history();
+    while (storage_get_pending_jobs() > 0)
+    {
+        storage_task();
+    }
+    TEST_ASSERT_TRUE(storage_get_history_count(STORAGE_TYPE_ALARM) > ALARM_MAX_HISTORY);
+
+    // 最新的记录 (从新到旧): 规则/状态/消息完整，时间戳为事件发生时刻
+    TEST_ASSERT_EQUAL(8, storage_read_alarm_history(records, 8));
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        uint16_t k = (uint16_t)(299 - i);
+        TEST_ASSERT_EQUAL(1, records[i].rule_id);
+        TEST_ASSERT_EQUAL(ALARM_TYPE_TEMPERATURE, records[i].alarm_type);
+        TEST_ASSERT_EQUAL((k & 1) ? ALARM_STATE_RESOLVED : ALARM_STATE_ACTIVE, records[i].alarm_state);
+        TEST_ASSERT_EQUAL((k & 1) ? ALARM_MSG_CONDITION_CLEARED : ALARM_MSG_CONDITION_MET, records[i].message_id);
+        if (!(k & 1))
+        {
+            TEST_ASSERT_EQUAL(700 + k / 2, records[i].alarm_value);
+        }
+        if (i > 0)
+        {
+            TEST_ASSERT_EQUAL(1000, records[i - 1].header.timestamp - records[i].header.timestamp);
+        }
+    }
+
+    // 负值 (如-10.0°C低温报警) 原样转存
+    TEST_ASSERT_TRUE(test_add_rule(2, ALARM_TYPE_TEMPERATURE, ALARM_LEVEL_WARNING, 600, 0));
+    TEST_ASSERT_TRUE(alarm_trigger(2, -123));
+    alarm_flush_history();
+    while (storage_get_pending_jobs() > 0)
+    {
+        storage_task();
+    }
+    TEST_ASSERT_EQUAL(1, storage_read_alarm_history(records, 1));
+    TEST_ASSERT_EQUAL(2, records[0].rule_id);
+    TEST_ASSERT_EQUAL(-123, records[0].alarm_value);
+
+    alarm_deinit();
+    storage_deinit();
+}
+
+void run_alarm_tests(void)
+{
+    printf("\n=== 运行报警系统测试 ===\n");
+
+    RUN_TEST(alarm_type_index_dispatch);
+    RUN_TEST(alarm_bitset_counts);
+    RUN_TEST(alarm_rule_capacity);
+    RUN_TEST(alarm_on_delay);
+    RUN_TEST(alarm_disable_clears_state);
+    RUN_TEST(alarm_hysteresis_and_off_delay);
+    RUN_TEST(alarm_noisy_trace_replay);
+    RUN_TEST(alarm_history_wraparound);
+    RUN_TEST(alarm_history_spill);
+
+    printf("报警系统测试用例已添加完成\n");
+}
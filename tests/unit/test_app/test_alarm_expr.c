@@ -0,0 +1,213 @@
+/**
+ * @file test_alarm_expr.c
+ * @brief 报警表达式编译与解释执行单元测试
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/alarm_expr.h"
+#include "../../../inc/alarm.h"
+#include "../../../inc/system.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief 系统时钟前进 (ms)
+ */
+static void test_advance(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        system_tick_increment();
+    }
+}
+
+static void test_expect_state(uint8_t id, alarm_state_t expected)
+{
+    alarm_info_t info;
+
+    TEST_ASSERT_TRUE(alarm_get_info(id, &info));
+    TEST_ASSERT_EQUAL(expected, info.state);
+}
+
+TEST_CASE(alarm_expr_compile_and_evaluate)
+{
+    alarm_expr_init();
+
+    TEST_ASSERT_TRUE(alarm_expr_set(0, "temp > 600 && humi < 300"));
+    TEST_ASSERT_TRUE(alarm_expr_set(1, "!(temp > 600) || volt - 100 >= 3000"));
+    TEST_ASSERT_TRUE(alarm_expr_set(2, "1 + 2 > 2 && temp > -50"));
+
+    alarm_expr_update(ALARM_EXPR_INPUT_TEMPERATURE, 650, 0);
+    alarm_expr_update(ALARM_EXPR_INPUT_HUMIDITY, 250, 0);
+    alarm_expr_update(ALARM_EXPR_INPUT_VOLTAGE, 3100, 0);
+    TEST_ASSERT_TRUE(alarm_expr_evaluate(0, 0));
+    TEST_ASSERT_TRUE(alarm_expr_evaluate(1, 0));
+    TEST_ASSERT_TRUE(alarm_expr_evaluate(2, 0));
+
+    alarm_expr_update(ALARM_EXPR_INPUT_HUMIDITY, 350, 1000);
+    alarm_expr_update(ALARM_EXPR_INPUT_VOLTAGE, 3000, 1000);
+    TEST_ASSERT_FALSE(alarm_expr_evaluate(0, 1000));
+    TEST_ASSERT_FALSE(alarm_expr_evaluate(1, 1000));
+
+    alarm_expr_update(ALARM_EXPR_INPUT_TEMPERATURE, -60, 2000);
+    TEST_ASSERT_TRUE(alarm_expr_evaluate(1, 2000));
+    TEST_ASSERT_FALSE(alarm_expr_evaluate(2, 2000));
+
+    // 空闲槽位与无效槽位
+    TEST_ASSERT_FALSE(alarm_expr_evaluate(3, 2000));
+    TEST_ASSERT_FALSE(alarm_expr_evaluate(ALARM_EXPR_MAX_PROGRAMS, 2000));
+}
+
+TEST_CASE(alarm_expr_window_and_rate)
+{
+    alarm_expr_init();
+
+    // 每15秒上升10 (每分钟40)
+    for (uint32_t k = 0; k <= 8; k++)
+    {
+        alarm_expr_update(ALARM_EXPR_INPUT_TEMPERATURE, 500 + 10 * (int32_t)k, k * 15000);
+    }
+
+    TEST_ASSERT_TRUE(alarm_expr_set(0, "rate(temp, 60) == 40"));
+    TEST_ASSERT_TRUE(alarm_expr_set(1, "min(temp, 60) == 540 && max(temp, 60) == 580"));
+    TEST_ASSERT_TRUE(alarm_expr_set(2, "avg(temp, 60) == 563"));
+    TEST_ASSERT_TRUE(alarm_expr_evaluate(0, 120000));
+    TEST_ASSERT_TRUE(alarm_expr_evaluate(1, 120000));
+    TEST_ASSERT_TRUE(alarm_expr_evaluate(2, 120000));
+
+    // 1分钟无采样: 缺失的历史槽用上一个值补齐，变化率回落
+    alarm_expr_update(ALARM_EXPR_INPUT_TEMPERATURE, 580, 180000);
+    TEST_ASSERT_TRUE(alarm_expr_set(0, "rate(temp, 60) == 0 && min(temp, 60) == 580"));
+    TEST_ASSERT_TRUE(alarm_expr_evaluate(0, 180000));
+
+    // 窗口超过历史长度时使用全部历史
+    TEST_ASSERT_TRUE(alarm_expr_set(1, "min(temp, 3600) == 500"));
+    TEST_ASSERT_TRUE(alarm_expr_evaluate(1, 180000));
+
+    // 无历史的输入
+    TEST_ASSERT_TRUE(alarm_expr_set(2, "rate(aux, 60) == 0"));
+    TEST_ASSERT_TRUE(alarm_expr_evaluate(2, 180000));
+}
+
+TEST_CASE(alarm_expr_hold)
+{
+    alarm_expr_init();
+    TEST_ASSERT_TRUE(alarm_expr_set(0, "for(volt < 2800, 300)"));
+
+    alarm_expr_update(ALARM_EXPR_INPUT_VOLTAGE, 2700, 0);
+    TEST_ASSERT_FALSE(alarm_expr_evaluate(0, 0));
+    TEST_ASSERT_FALSE(alarm_expr_evaluate(0, 299000));
+
+    // 中途恢复则重新计时
+    alarm_expr_update(ALARM_EXPR_INPUT_VOLTAGE, 2900, 299500);
+    TEST_ASSERT_FALSE(alarm_expr_evaluate(0, 299500));
+    alarm_expr_update(ALARM_EXPR_INPUT_VOLTAGE, 2700, 300000);
+    TEST_ASSERT_FALSE(alarm_expr_evaluate(0, 300000));
+    TEST_ASSERT_FALSE(alarm_expr_evaluate(0, 599000));
+    TEST_ASSERT_TRUE(alarm_expr_evaluate(0, 600000));
+}
+
+TEST_CASE(alarm_expr_compile_errors)
+{
+    uint8_t code[ALARM_EXPR_MAX_CODE];
+    uint8_t error_pos = 0xFF;
+
+    alarm_expr_init();
+
+    TEST_ASSERT_EQUAL(0, alarm_expr_compile("temp >", code, sizeof(code), &error_pos));
+    TEST_ASSERT_EQUAL(6, error_pos);
+    TEST_ASSERT_EQUAL(0, alarm_expr_compile("temp > 600 )", code, sizeof(code), &error_pos));
+    TEST_ASSERT_EQUAL(11, error_pos);
+    TEST_ASSERT_EQUAL(0, alarm_expr_compile("avg(5, 60) > 1", code, sizeof(code), &error_pos));
+    TEST_ASSERT_EQUAL(0, alarm_expr_compile("tempo > 1", code, sizeof(code), &error_pos));
+    TEST_ASSERT_EQUAL(0, alarm_expr_compile("rate(temp, 70000) > 1", code, sizeof(code), &error_pos));
+    TEST_ASSERT_EQUAL(0, alarm_expr_compile("", code, sizeof(code), &error_pos));
+
+    // 栈深度超限
+    TEST_ASSERT_EQUAL(0, alarm_expr_compile("temp+(temp+(temp+(temp+(temp+(temp+(temp+(temp+temp)))))))", code,
+                                            sizeof(code), &error_pos));
+    // 字节码过长
+    TEST_ASSERT_EQUAL(0, alarm_expr_compile("temp > 1 && temp > 2 && temp > 3 && temp > 4 && temp > 5 && temp > 6", code,
+                                            sizeof(code), &error_pos));
+    // 持续槽超限
+    TEST_ASSERT_EQUAL(0, alarm_expr_compile("for(for(for(for(for(temp > 1, 1), 1), 1), 1), 1)", code,
+                                            sizeof(code), &error_pos));
+    TEST_ASSERT_FALSE(alarm_expr_set(0, "temp >"));
+
+    // 校验拒绝被篡改的字节码
+    uint8_t length = alarm_expr_compile("temp > 600", code, sizeof(code), NULL);
+    TEST_ASSERT_EQUAL(9, length);
+    TEST_ASSERT_TRUE(alarm_expr_load(0, code, length));
+    TEST_ASSERT_FALSE(alarm_expr_load(0, code, length - 1));
+    code[1] = ALARM_EXPR_INPUTS;
+    TEST_ASSERT_FALSE(alarm_expr_verify(code, length));
+    code[1] = ALARM_EXPR_INPUT_TEMPERATURE;
+    code[length - 2] = ALARM_EXPR_OP_COUNT;
+    TEST_ASSERT_FALSE(alarm_expr_verify(code, length));
+    code[length - 2] = ALARM_EXPR_OP_ADD;
+    TEST_ASSERT_TRUE(alarm_expr_verify(code, length));
+    code[0] = ALARM_EXPR_OP_ADD;
+    TEST_ASSERT_FALSE(alarm_expr_verify(code, length));
+}
+
+TEST_CASE(alarm_expr_rule)
+{
+    alarm_rule_t rule;
+
+    TEST_ASSERT_TRUE(alarm_init());
+    TEST_ASSERT_TRUE(alarm_expr_set(0, "temp > 600 && rate(temp, 60) > 20"));
+
+    memset(&rule, 0, sizeof(rule));
+    rule.id = 20;
+    rule.type = ALARM_TYPE_TEMPERATURE;
+    rule.level = ALARM_LEVEL_WARNING;
+    rule.condition = ALARM_CONDITION_EXPR;
+    rule.expression = 0;
+    rule.enabled = true;
+    TEST_ASSERT_TRUE(alarm_add_rule(&rule));
+
+    // 缓慢升温 (每分钟10) 越过600不报警
+    for (int32_t value = 550; value <= 650; value += 5)
+    {
+        alarm_check_condition(ALARM_TYPE_TEMPERATURE, value);
+        alarm_process();
+        test_advance(30000);
+    }
+    test_expect_state(20, ALARM_STATE_IDLE);
+
+    // 快速升温 (每分钟40) 报警，回落后解除
+    for (int32_t value = 650; value <= 700; value += 20)
+    {
+        alarm_check_condition(ALARM_TYPE_TEMPERATURE, value);
+        alarm_process();
+        test_advance(30000);
+    }
+    test_expect_state(20, ALARM_STATE_ACTIVE);
+
+    for (uint8_t n = 0; n < 10; n++)
+    {
+        alarm_check_condition(ALARM_TYPE_TEMPERATURE, 690);
+        alarm_process();
+        test_advance(30000);
+    }
+    // 解除后重新布防
+    test_expect_state(20, ALARM_STATE_IDLE);
+    TEST_ASSERT_EQUAL(0, alarm_get_active_count());
+
+    alarm_deinit();
+}
+
+void run_alarm_expr_tests(void)
+{
+    printf("\n=== 运行报警表达式测试 ===\n");
+
+    RUN_TEST(alarm_expr_compile_and_evaluate);
+    RUN_TEST(alarm_expr_window_and_rate);
+    RUN_TEST(alarm_expr_hold);
+    RUN_TEST(alarm_expr_compile_errors);
+    RUN_TEST(alarm_expr_rule);
+
+    printf("报警表达式测试用例已添加完成\n");
+}
@@ -0,0 +1,288 @@
+/**
+ * @file test_alarm_notify.c
+ * @brief 报警通知合并与限速单元测试
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/alarm_notify.h"
+#include "../../../inc/alarm.h"
+#include "../../../inc/system.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_MAX_FRAMES 64
+
+/**
+ * @brief 捕获通道
+ */
+typedef struct
+{
+    uint8_t frames[TEST_MAX_FRAMES][ALARM_NOTIFY_MAX_FRAME];
+    uint16_t lengths[TEST_MAX_FRAMES];
+    uint16_t count;
+} test_capture_t;
+
+static test_capture_t test_mqtt;
+static test_capture_t test_lora;
+
+static bool test_capture_send(const uint8_t *frame, uint16_t length, void *context)
+{
+    test_capture_t *capture = (test_capture_t *)context;
+
+    if (capture->count >= TEST_MAX_FRAMES)
+    {
+        return false;
+    }
+    memcpy(capture->frames[capture->count], frame, length);
+    capture->lengths[capture->count++] = length;
+    return true;
+}
+
+/**
+ * @brief 重新初始化并注册MQTT (整批一帧) 与LoRa (51字节) 两个捕获通道
+ */
+static void test_reset(void)
+{
+    alarm_notify_sink_t mqtt = {test_capture_send, &test_mqtt, ALARM_NOTIFY_MAX_FRAME};
+    alarm_notify_sink_t lora = {test_capture_send, &test_lora, 51};
+
+    memset(&test_mqtt, 0, sizeof(test_mqtt));
+    memset(&test_lora, 0, sizeof(test_lora));
+    alarm_notify_init();
+    TEST_ASSERT_TRUE(alarm_notify_add_sink(&mqtt));
+    TEST_ASSERT_TRUE(alarm_notify_add_sink(&lora));
+}
+
+static void test_post(uint8_t rule_id, uint8_t level, uint8_t state, int32_t value)
+{
+    alarm_history_t event;
+
+    memset(&event, 0, sizeof(event));
+    event.timestamp = system_get_tick();
+    event.rule_id = rule_id;
+    event.type = ALARM_TYPE_TEMPERATURE;
+    event.level = level;
+    event.state = state;
+    event.value = value;
+    alarm_notify_post(&event);
+}
+
+/**
+ * @brief 系统时钟前进 (ms) 并运行后台任务
+ */
+static void test_advance(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        system_tick_increment();
+    }
+    alarm_notify_task();
+}
+
+TEST_CASE(alarm_notify_coalesce_window)
+{
+    alarm_notify_stats_t stats;
+
+    test_reset();
+
+    // 窗口内两条规则各抖动5次
+    for (uint8_t n = 0; n < 5; n++)
+    {
+        test_post(1, ALARM_LEVEL_WARNING, (n & 1) ? ALARM_STATE_RESOLVED : ALARM_STATE_ACTIVE, 600 + n);
+        test_post(2, ALARM_LEVEL_WARNING, ALARM_STATE_ACTIVE, 700 + n);
+        test_advance(100);
+    }
+    TEST_ASSERT_EQUAL(0, test_mqtt.count);
+
+    test_advance(ALARM_NOTIFY_WINDOW_MS);
+    TEST_ASSERT_EQUAL(1, test_mqtt.count);
+    TEST_ASSERT_EQUAL(1, test_lora.count);
+    TEST_ASSERT_EQUAL(ALARM_NOTIFY_HEADER_SIZE + 2 * ALARM_NOTIFY_ENTRY_SIZE, test_mqtt.lengths[0]);
+
+    const uint8_t *frame = test_mqtt.frames[0];
+    TEST_ASSERT_EQUAL(ALARM_NOTIFY_VERSION, frame[0]);
+    TEST_ASSERT_EQUAL(2, frame[2]);
+    TEST_ASSERT_EQUAL(0, frame[3]);
+
+    // 第一条: 规则1，最新状态为激活 (第5次)，值604，5次变化，偏移400ms
+    const uint8_t *entry = frame + ALARM_NOTIFY_HEADER_SIZE;
+    TEST_ASSERT_EQUAL(1, entry[0]);
+    TEST_ASSERT_EQUAL((ALARM_LEVEL_WARNING << 4) | ALARM_STATE_ACTIVE, entry[2]);
+    TEST_ASSERT_EQUAL(5, entry[3]);
+    TEST_ASSERT_EQUAL(604, entry[4] | (entry[5] << 8));
+    TEST_ASSERT_EQUAL(400, entry[6] | (entry[7] << 8));
+
+    TEST_ASSERT_TRUE(alarm_notify_get_stats(&stats));
+    TEST_ASSERT_EQUAL(10, stats.posted);
+    TEST_ASSERT_EQUAL(8, stats.coalesced);
+    TEST_ASSERT_EQUAL(1, stats.batches);
+
+    // 窗口已关闭，下一次变化重新开窗
+    test_post(1, ALARM_LEVEL_WARNING, ALARM_STATE_RESOLVED, 550);
+    test_advance(ALARM_NOTIFY_WINDOW_MS - 1);
+    TEST_ASSERT_EQUAL(1, test_mqtt.count);
+    test_advance(1);
+    TEST_ASSERT_EQUAL(2, test_mqtt.count);
+    TEST_ASSERT_EQUAL(1, test_mqtt.frames[1][1]);
+}
+
+TEST_CASE(alarm_notify_token_bucket)
+{
+    alarm_notify_stats_t stats;
+
+    test_reset();
+    TEST_ASSERT_TRUE(alarm_notify_set_limit(ALARM_LEVEL_INFO, 2, 60000));
+    TEST_ASSERT_FALSE(alarm_notify_set_limit(ALARM_LEVEL_CRITICAL, 2, 60000));
+
+    // 5条不同规则的信息级变化，只有2条通过
+    for (uint8_t id = 1; id <= 5; id++)
+    {
+        test_post(id, ALARM_LEVEL_INFO, ALARM_STATE_ACTIVE, id);
+    }
+    alarm_notify_flush();
+    TEST_ASSERT_EQUAL(1, test_mqtt.count);
+    TEST_ASSERT_EQUAL(2, test_mqtt.frames[0][2]);
+
+    TEST_ASSERT_TRUE(alarm_notify_get_stats(&stats));
+    TEST_ASSERT_EQUAL(3, stats.suppressed);
+
+    // 令牌耗尽期间的丢弃数随下一批上报
+    test_post(6, ALARM_LEVEL_INFO, ALARM_STATE_ACTIVE, 6);
+    test_advance(59000);
+    test_post(7, ALARM_LEVEL_INFO, ALARM_STATE_ACTIVE, 7);
+    TEST_ASSERT_EQUAL(1, test_mqtt.count);
+    test_advance(1000);
+    test_post(8, ALARM_LEVEL_INFO, ALARM_STATE_ACTIVE, 8);
+    alarm_notify_flush();
+    TEST_ASSERT_EQUAL(2, test_mqtt.count);
+    TEST_ASSERT_EQUAL(1, test_mqtt.frames[1][2]);
+    TEST_ASSERT_EQUAL(2, test_mqtt.frames[1][3]);
+    TEST_ASSERT_EQUAL(8, test_mqtt.frames[1][ALARM_NOTIFY_HEADER_SIZE]);
+
+    // 其他级别各自独立
+    test_post(9, ALARM_LEVEL_WARNING, ALARM_STATE_ACTIVE, 9);
+    alarm_notify_flush();
+    TEST_ASSERT_EQUAL(3, test_mqtt.count);
+    TEST_ASSERT_EQUAL(1, test_mqtt.frames[2][2]);
+}
+
+TEST_CASE(alarm_notify_critical_immediate)
+{
+    alarm_notify_stats_t stats;
+
+    test_reset();
+
+    test_post(1, ALARM_LEVEL_WARNING, ALARM_STATE_ACTIVE, 600);
+    test_advance(100);
+    TEST_ASSERT_EQUAL(0, test_mqtt.count);
+
+    // 严重级别立即连同当前批次发出，且不受令牌限制
+    test_post(2, ALARM_LEVEL_CRITICAL, ALARM_STATE_ACTIVE, 900);
+    TEST_ASSERT_EQUAL(1, test_mqtt.count);
+    TEST_ASSERT_EQUAL(2, test_mqtt.frames[0][2]);
+    TEST_ASSERT_EQUAL((ALARM_LEVEL_CRITICAL << 4) | ALARM_STATE_ACTIVE,
+                      test_mqtt.frames[0][ALARM_NOTIFY_HEADER_SIZE + ALARM_NOTIFY_ENTRY_SIZE + 2]);
+
+    for (uint8_t id = 10; id < 40; id++)
+    {
+        test_post(id, ALARM_LEVEL_CRITICAL, ALARM_STATE_ACTIVE, id);
+    }
+    TEST_ASSERT_EQUAL(31, test_mqtt.count);
+
+    TEST_ASSERT_TRUE(alarm_notify_get_stats(&stats));
+    TEST_ASSERT_EQUAL(31, stats.immediate);
+    TEST_ASSERT_EQUAL(0, stats.suppressed);
+}
+
+TEST_CASE(alarm_notify_mtu_split)
+{
+    alarm_notify_stats_t stats;
+
+    test_reset();
+    TEST_ASSERT_TRUE(alarm_notify_set_limit(ALARM_LEVEL_ERROR, ALARM_NOTIFY_BATCH_MAX, 1000));
+
+    for (uint8_t id = 1; id <= 12; id++)
+    {
+        test_post(id, ALARM_LEVEL_ERROR, ALARM_STATE_ACTIVE, -(int32_t)id);
+    }
+    test_advance(ALARM_NOTIFY_WINDOW_MS);
+
+    // MQTT整批一帧，LoRa按51字节分为5+5+2三帧，序号相同
+    TEST_ASSERT_EQUAL(1, test_mqtt.count);
+    TEST_ASSERT_EQUAL(ALARM_NOTIFY_HEADER_SIZE + 12 * ALARM_NOTIFY_ENTRY_SIZE, test_mqtt.lengths[0]);
+    TEST_ASSERT_EQUAL(3, test_lora.count);
+    TEST_ASSERT_EQUAL(5, test_lora.frames[0][2]);
+    TEST_ASSERT_EQUAL(5, test_lora.frames[1][2]);
+    TEST_ASSERT_EQUAL(2, test_lora.frames[2][2]);
+    TEST_ASSERT_TRUE(test_lora.lengths[0] <= 51);
+    TEST_ASSERT_EQUAL(test_lora.frames[0][1], test_lora.frames[2][1]);
+    TEST_ASSERT_EQUAL(11, test_lora.frames[2][ALARM_NOTIFY_HEADER_SIZE]);
+    TEST_ASSERT_EQUAL(-11, (int16_t)(test_lora.frames[2][ALARM_NOTIFY_HEADER_SIZE + 4] |
+                                     (test_lora.frames[2][ALARM_NOTIFY_HEADER_SIZE + 5] << 8)));
+
+    // 批次满时立即发出
+    TEST_ASSERT_TRUE(alarm_notify_set_limit(ALARM_LEVEL_ERROR, ALARM_NOTIFY_BATCH_MAX, 1000));
+    for (uint8_t id = 1; id <= ALARM_NOTIFY_BATCH_MAX; id++)
+    {
+        test_post((uint8_t)(100 + id), ALARM_LEVEL_ERROR, ALARM_STATE_ACTIVE, id);
+    }
+    TEST_ASSERT_EQUAL(2, test_mqtt.count);
+
+    TEST_ASSERT_TRUE(alarm_notify_get_stats(&stats));
+    TEST_ASSERT_EQUAL(2, stats.batches);
+    TEST_ASSERT_EQUAL(0, stats.send_errors);
+}
+
+TEST_CASE(alarm_notify_storm_bounded)
+{
+    alarm_rule_t rule;
+    alarm_notify_stats_t stats;
+
+    alarm_init();
+    test_reset();
+
+    // 8条警告级规则，温度在阈值附近抖动60秒 (每100ms一个采样)
+    for (uint8_t id = 1; id <= 8; id++)
+    {
+        memset(&rule, 0, sizeof(rule));
+        rule.id = (uint8_t)(20 + id);
+        rule.type = ALARM_TYPE_HUMIDITY;
+        rule.level = ALARM_LEVEL_WARNING;
+        rule.condition = ALARM_CONDITION_GT;
+        rule.enabled = true;
+        rule.threshold_high = 600 + id;
+        rule.output_mask = ALARM_OUTPUT_UPLINK;
+        TEST_ASSERT_TRUE(alarm_add_rule(&rule));
+    }
+
+    for (uint16_t n = 0; n < 600; n++)
+    {
+        alarm_check_condition(ALARM_TYPE_HUMIDITY, (n & 1) ? 590 : 620);
+        alarm_process();
+        test_advance(100);
+    }
+
+    // 数千次状态变化被合并限速为有界的批次数与条目数
+    TEST_ASSERT_TRUE(alarm_notify_get_stats(&stats));
+    TEST_ASSERT_TRUE(stats.posted >= 600 * 8);
+    TEST_ASSERT_TRUE(stats.batches <= 60000 / ALARM_NOTIFY_WINDOW_MS + 1);
+    TEST_ASSERT_TRUE(test_mqtt.count <= stats.batches);
+    TEST_ASSERT_TRUE(stats.posted - stats.coalesced - stats.suppressed <= 4 + 60 / 30 + 1);
+
+    alarm_deinit();
+}
+
+void run_alarm_notify_tests(void)
+{
+    printf("\n=== 运行报警通知测试 ===\n");
+
+    RUN_TEST(alarm_notify_coalesce_window);
+    RUN_TEST(alarm_notify_token_bucket);
+    RUN_TEST(alarm_notify_critical_immediate);
+    RUN_TEST(alarm_notify_mtu_split);
+    RUN_TEST(alarm_notify_storm_bounded);
+
+    printf("报警通知测试用例已添加完成\n");
+}
@@ -0,0 +1,252 @@
+/**
+ * @file test_config_journal.c
+ * @brief A/B双bank日志式配置存储单元测试 (主机NOR模拟器)
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/flash.h"
+#include "../../../inc/config_journal.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_JOURNAL_BASE 0x0000F000UL
+#define TEST_BANK_SIZE 1024
+
+/**
+ * @brief 测试配置 (与配置参数结构相近的大小)
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t period;
+    uint8_t slave_id;
+    uint8_t flags;
+    int16_t thresholds[8];
+    uint8_t reserved[40];
+} test_config_t;
+
+static config_journal_t test_journal;
+
+static void test_make_config(test_config_t *config, uint32_t version)
+{
+    memset(config, 0, sizeof(test_config_t));
+    config->magic = 0x12345678UL;
+    config->period = (uint16_t)(1000 + version);
+    config->slave_id = (uint8_t)(version % 247 + 1);
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        config->thresholds[i] = (int16_t)(i * 100 - (int16_t)version);
+    }
+}
+
+static bool test_mount(test_config_t *config)
+{
+    memset(config, 0, sizeof(test_config_t));
+    return config_journal_mount(&test_journal, TEST_JOURNAL_BASE, TEST_BANK_SIZE, config, sizeof(test_config_t));
+}
+
+TEST_CASE(config_journal_first_commit_and_mount)
+{
+    test_config_t config, loaded;
+
+    flash_sim_reset();
+    TEST_ASSERT_FALSE(test_mount(&loaded));
+    TEST_ASSERT_EQUAL(0, config_journal_get_free_space(&test_journal));
+
+    // 无有效配置: 快照写入bank 1
+    test_make_config(&config, 0);
+    TEST_ASSERT_TRUE(config_journal_commit(&test_journal, NULL, &config));
+    TEST_ASSERT_EQUAL(1, test_journal.active);
+    TEST_ASSERT_EQUAL(1, test_journal.stats.snapshots);
+
+    TEST_ASSERT_TRUE(test_mount(&loaded));
+    TEST_ASSERT_EQUAL_MEMORY(&config, &loaded, sizeof(config));
+    TEST_ASSERT_EQUAL(1, test_journal.active);
+    TEST_ASSERT_EQUAL(1, test_journal.sequence);
+}
+
+TEST_CASE(config_journal_small_changes_append_deltas)
+{
+    test_config_t config, next, loaded;
+    flash_stats_t stats;
+
+    flash_sim_reset();
+    test_mount(&loaded);
+    test_make_config(&config, 0);
+    TEST_ASSERT_TRUE(config_journal_commit(&test_journal, NULL, &config));
+    uint16_t free_space = config_journal_get_free_space(&test_journal);
+
+    // 单字段修改不擦除，每次追加一条8字节差分记录
+    flash_reset_stats();
+    for (uint8_t i = 1; i <= 20; i++)
+    {
+        next = config;
+        next.period = (uint16_t)(2000 + i);
+        TEST_ASSERT_TRUE(config_journal_commit(&test_journal, &config, &next));
+        config = next;
+    }
+    flash_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.erase_count);
+    TEST_ASSERT_EQUAL(20, stats.program_count);
+    TEST_ASSERT_EQUAL(20, test_journal.stats.deltas);
+    TEST_ASSERT_EQUAL(free_space - 20 * 8, config_journal_get_free_space(&test_journal));
+
+    // 内容无变化不写入
+    TEST_ASSERT_TRUE(config_journal_commit(&test_journal, &config, &config));
+    TEST_ASSERT_EQUAL(20, test_journal.stats.deltas);
+
+    // 多处分散修改作为一条记录提交
+    next = config;
+    next.slave_id = 99;
+    next.thresholds[7] = -1234;
+    next.reserved[39] = 0x5A;
+    TEST_ASSERT_TRUE(config_journal_commit(&test_journal, &config, &next));
+
+    TEST_ASSERT_TRUE(test_mount(&loaded));
+    TEST_ASSERT_EQUAL_MEMORY(&next, &loaded, sizeof(next));
+    TEST_ASSERT_EQUAL(free_space - 20 * 8 - 16, config_journal_get_free_space(&test_journal));
+}
+
+TEST_CASE(config_journal_full_bank_switches)
+{
+    test_config_t config, next, loaded;
+    uint32_t commits = 0;
+
+    flash_sim_reset();
+    test_mount(&loaded);
+    test_make_config(&config, 0);
+    TEST_ASSERT_TRUE(config_journal_commit(&test_journal, NULL, &config));
+
+    // 写满bank 1后快照写入bank 0，序号+1，此后继续追加差分
+    while (test_journal.active == 1)
+    {
+        commits++;
+        test_make_config(&next, commits);
+        TEST_ASSERT_TRUE(config_journal_commit(&test_journal, &config, &next));
+        config = next;
+    }
+    TEST_ASSERT_EQUAL(2, test_journal.sequence);
+    TEST_ASSERT_EQUAL(2, test_journal.stats.snapshots);
+    TEST_ASSERT_TRUE(commits > 5);
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        commits++;
+        test_make_config(&next, commits);
+        TEST_ASSERT_TRUE(config_journal_commit(&test_journal, &config, &next));
+        config = next;
+    }
+
+    TEST_ASSERT_TRUE(test_mount(&loaded));
+    TEST_ASSERT_EQUAL(0, test_journal.active);
+    TEST_ASSERT_EQUAL_MEMORY(&config, &loaded, sizeof(config));
+}
+
+TEST_CASE(config_journal_maintain_pre_erases_spare)
+{
+    test_config_t config, next, loaded;
+    flash_stats_t stats;
+    uint32_t commits = 0;
+    uint8_t pages = TEST_BANK_SIZE / FLASH_PAGE_SIZE;
+
+    flash_sim_reset();
+    test_mount(&loaded);
+    test_make_config(&config, 0);
+    TEST_ASSERT_TRUE(config_journal_commit(&test_journal, NULL, &config));
+    TEST_ASSERT_EQUAL(0, test_journal.spare_erased);
+
+    // 后台逐页擦除原bank，擦完后不再操作
+    for (uint8_t i = 0; i < pages; i++)
+    {
+        TEST_ASSERT_TRUE(config_journal_maintain(&test_journal));
+    }
+    TEST_ASSERT_FALSE(config_journal_maintain(&test_journal));
+    TEST_ASSERT_EQUAL(pages, test_journal.spare_erased);
+
+    // 重启后按空白页恢复预擦除进度
+    TEST_ASSERT_TRUE(test_mount(&loaded));
+    TEST_ASSERT_EQUAL(pages, test_journal.spare_erased);
+
+    // 写满当前bank: 切换时只有编程操作
+    flash_reset_stats();
+    while (test_journal.active == 1)
+    {
+        commits++;
+        test_make_config(&next, commits);
+        TEST_ASSERT_TRUE(config_journal_commit(&test_journal, &config, &next));
+        config = next;
+    }
+    flash_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.erase_count);
+    TEST_ASSERT_EQUAL(0, test_journal.spare_erased);
+
+    TEST_ASSERT_TRUE(test_mount(&loaded));
+    TEST_ASSERT_EQUAL_MEMORY(&config, &loaded, sizeof(config));
+}
+
+/**
+ * @brief 提交过程中逐字节断电，重启后配置为提交前或提交后之一
+ * @param snapshot true: 强制改写快照, false: 差分记录
+ */
+static void test_power_cut(bool snapshot, uint32_t max_budget)
+{
+    test_config_t before, after, loaded;
+
+    for (uint32_t budget = 1; budget < max_budget; budget++)
+    {
+        flash_sim_reset();
+        test_mount(&loaded);
+        test_make_config(&before, 1);
+        TEST_ASSERT_TRUE(config_journal_commit(&test_journal, NULL, &before));
+        TEST_ASSERT_TRUE(config_journal_commit(&test_journal, NULL, &before));
+
+        test_make_config(&after, 2);
+        flash_sim_set_power_cut(budget);
+        bool committed = config_journal_commit(&test_journal, snapshot ? NULL : &before, &after);
+        flash_sim_power_on();
+
+        TEST_ASSERT_TRUE(test_mount(&loaded));
+        if (committed)
+        {
+            TEST_ASSERT_EQUAL_MEMORY(&after, &loaded, sizeof(after));
+        }
+        else
+        {
+            TEST_ASSERT_TRUE(memcmp(&loaded, &before, sizeof(loaded)) == 0 ||
+                             memcmp(&loaded, &after, sizeof(loaded)) == 0);
+        }
+
+        // 恢复后可继续提交
+        test_make_config(&before, 3);
+        TEST_ASSERT_TRUE(config_journal_commit(&test_journal, &loaded, &before));
+        TEST_ASSERT_TRUE(test_mount(&loaded));
+        TEST_ASSERT_EQUAL_MEMORY(&before, &loaded, sizeof(before));
+    }
+}
+
+TEST_CASE(config_journal_power_cut_delta)
+{
+    test_power_cut(false, 48);
+}
+
+TEST_CASE(config_journal_power_cut_snapshot)
+{
+    // 擦除两页 + 快照 + bank头
+    test_power_cut(true, 2 * FLASH_PAGE_SIZE + sizeof(test_config_t) + 32);
+}
+
+void run_config_journal_tests(void)
+{
+    printf("\n=== 运行配置日志存储测试 ===\n");
+
+    RUN_TEST(config_journal_first_commit_and_mount);
+    RUN_TEST(config_journal_small_changes_append_deltas);
+    RUN_TEST(config_journal_full_bank_switches);
+    RUN_TEST(config_journal_maintain_pre_erases_spare);
+    RUN_TEST(config_journal_power_cut_delta);
+    RUN_TEST(config_journal_power_cut_snapshot);
+
+    printf("配置日志存储测试用例已添加完成\n");
+}
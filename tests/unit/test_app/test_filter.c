@@ -0,0 +1,165 @@
+/**
+ * @file test_filter.c
+ * @brief 数字滤波器库单元测试
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/filter.h"
+#include <stdio.h>
+#include <string.h>
+
+// 测试夹具
+static filter_t test_filter;
+
+TEST_SETUP()
+{
+    memset(&test_filter, 0, sizeof(filter_t));
+}
+
+TEST_TEARDOWN()
+{
+}
+
+/**
+ * @brief 按类型初始化测试滤波器
+ */
+static void filter_setup(filter_type_t type, uint8_t window, uint16_t param)
+{
+    filter_config_t config = {.type = type, .window = window, .param = param};
+    TEST_ASSERT_TRUE(filter_init(&test_filter, &config));
+}
+
+TEST_CASE(filter_init_clamps_window)
+{
+    filter_setup(FILTER_TYPE_MOVING_AVERAGE, 0, 0);
+    TEST_ASSERT_EQUAL(1, test_filter.window);
+
+    filter_setup(FILTER_TYPE_MOVING_AVERAGE, FILTER_MAX_WINDOW + 10, 0);
+    TEST_ASSERT_EQUAL(FILTER_MAX_WINDOW, test_filter.window);
+
+    filter_config_t invalid = {.type = FILTER_TYPE_COUNT, .window = 4, .param = 0};
+    TEST_ASSERT_FALSE(filter_init(&test_filter, &invalid));
+}
+
+TEST_CASE(filter_moving_average_running_sum)
+{
+    filter_setup(FILTER_TYPE_MOVING_AVERAGE, 4, 0);
+
+    // 窗口未满时按有效样本数平均
+    TEST_ASSERT_EQUAL(100, filter_update(&test_filter, 100));
+    TEST_ASSERT_EQUAL(150, filter_update(&test_filter, 200));
+    TEST_ASSERT_EQUAL(200, filter_update(&test_filter, 300));
+    TEST_ASSERT_EQUAL(250, filter_update(&test_filter, 400));
+
+    // 窗口满后滑出最旧样本 (200+300+400+500)/4
+    TEST_ASSERT_EQUAL(350, filter_update(&test_filter, 500));
+
+    // 长时间运行后运行和与直接求和一致
+    for (int i = 0; i < 1000; i++)
+    {
+        filter_update(&test_filter, (uint16_t)(i & 0xFFF));
+    }
+    uint32_t sum = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        sum += test_filter.state.ma.buffer[i];
+    }
+    TEST_ASSERT_EQUAL(sum, test_filter.state.ma.sum);
+}
+
+TEST_CASE(filter_median_rejects_spikes)
+{
+    filter_setup(FILTER_TYPE_MEDIAN, 5, 0);
+
+    filter_update(&test_filter, 100);
+    filter_update(&test_filter, 101);
+    filter_update(&test_filter, 4095); // 尖峰
+    filter_update(&test_filter, 99);
+    TEST_ASSERT_EQUAL(100, filter_update(&test_filter, 100));
+
+    // 有序窗口始终保持升序
+    for (int i = 0; i < 200; i++)
+    {
+        filter_update(&test_filter, (uint16_t)((i * 37) & 0xFFF));
+        for (int j = 1; j < test_filter.count; j++)
+        {
+            TEST_ASSERT_TRUE(test_filter.state.median.sorted[j - 1] <= test_filter.state.median.sorted[j]);
+        }
+    }
+}
+
+TEST_CASE(filter_iir_converges)
+{
+    filter_setup(FILTER_TYPE_IIR, 1, 2);
+
+    // 首个样本直接作为初值
+    TEST_ASSERT_EQUAL(1000, filter_update(&test_filter, 1000));
+
+    // alpha = 1/4 阶跃响应
+    TEST_ASSERT_EQUAL(1250, filter_update(&test_filter, 2000));
+
+    uint16_t out = 0;
+    for (int i = 0; i < 100; i++)
+    {
+        out = filter_update(&test_filter, 2000);
+    }
+    TEST_ASSERT_WITHIN(1, 2000, out);
+
+    // 16位过采样输入不溢出
+    filter_reset(&test_filter);
+    for (int i = 0; i < 100; i++)
+    {
+        out = filter_update(&test_filter, 65520);
+    }
+    TEST_ASSERT_EQUAL(65520, out);
+}
+
+TEST_CASE(filter_kalman_smooths_noise)
+{
+    filter_setup(FILTER_TYPE_KALMAN, 1, 16);
+
+    uint16_t out = 0;
+    for (int i = 0; i < 200; i++)
+    {
+        // ±20码交替噪声
+        out = filter_update(&test_filter, (uint16_t)((i & 1) ? 2020 : 1980));
+    }
+    TEST_ASSERT_WITHIN(5, 2000, out);
+
+    // 复位后重新以首样本为初值
+    filter_reset(&test_filter);
+    TEST_ASSERT_EQUAL(500, filter_update(&test_filter, 500));
+
+    // 过大的R/Q被限幅，增益不发散
+    filter_setup(FILTER_TYPE_KALMAN, 1, 65535);
+    TEST_ASSERT_EQUAL(FILTER_KALMAN_RATIO_MAX, test_filter.param);
+    TEST_ASSERT_EQUAL(1000, filter_update(&test_filter, 1000));
+    for (int i = 0; i < 200; i++)
+    {
+        out = filter_update(&test_filter, 3000);
+    }
+    TEST_ASSERT_TRUE(out >= 1000 && out <= 3000);
+}
+
+TEST_CASE(filter_none_passthrough)
+{
+    filter_setup(FILTER_TYPE_NONE, 4, 0);
+    TEST_ASSERT_EQUAL(1234, filter_update(&test_filter, 1234));
+    TEST_ASSERT_EQUAL_STRING("NONE", filter_get_type_name(FILTER_TYPE_NONE));
+}
+
+void run_filter_tests(void)
+{
+    printf("\n=== 运行数字滤波器测试 ===\n");
+
+    RUN_TEST(filter_init_clamps_window);
+    RUN_TEST(filter_moving_average_running_sum);
+    RUN_TEST(filter_median_rejects_spikes);
+    RUN_TEST(filter_iir_converges);
+    RUN_TEST(filter_kalman_smooths_noise);
+    RUN_TEST(filter_none_passthrough);
+
+    printf("数字滤波器测试用例已添加完成\n");
+}
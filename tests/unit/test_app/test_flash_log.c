@@ -0,0 +1,754 @@
+/**
+ * @file test_flash_log.c
+ * @brief 日志结构Flash记录存储单元测试 (主机NOR模拟器)
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/flash.h"
+#include "../../../inc/flash_log.h"
+#include "../../../inc/system.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_LOG_BASE 0x0000E000UL
+#define TEST_LOG_SECTORS 8
+#define TEST_RECORD_TYPE 0x02
+#define TEST_IMAGE_FILE "test_flash_log.bin"
+#define TEST_TIME_STEP 10
+#define TEST_CACHE_SIZE 144
+#define TEST_CHECKPOINT_BASE 0x0000D800UL
+#define TEST_CHECKPOINT_PAGES 2
+
+/**
+ * @brief 测试记录 (补齐后24字节，与传感器历史记录占用相同)
+ */
+typedef struct
+{
+    uint32_t id;
+    uint8_t payload[18];
+} test_record_t;
+
+// 每扇区可容纳的测试记录数
+#define TEST_RECORDS_PER_SECTOR \
+    ((FLASH_PAGE_SIZE - sizeof(flash_log_sector_t)) / (sizeof(flash_log_entry_t) + sizeof(test_record_t)))
+
+static flash_log_t test_log;
+static uint8_t test_cache[TEST_CACHE_SIZE];
+
+static void test_fill_record(test_record_t *record, uint32_t id)
+{
+    memset(record, 0, sizeof(test_record_t));
+    record->id = id;
+    for (uint8_t i = 0; i < sizeof(record->payload); i++)
+    {
+        record->payload[i] = (uint8_t)(id * 7 + i);
+    }
+}
+
+static bool test_append(uint32_t id)
+{
+    test_record_t record;
+    test_fill_record(&record, id);
+    return flash_log_append(&test_log, TEST_RECORD_TYPE, id * TEST_TIME_STEP, &record, sizeof(record));
+}
+
+/**
+ * @brief 校验日志内容为连续的id区间 [first, last]
+ */
+static void test_expect_range(uint32_t first, uint32_t last)
+{
+    flash_log_cursor_t cursor;
+    flash_log_entry_t entry;
+    test_record_t record, expected;
+    uint32_t id = first;
+
+    flash_log_rewind(&test_log, &cursor);
+    while (flash_log_next(&test_log, &cursor, &entry, &record, sizeof(record)))
+    {
+        test_fill_record(&expected, id);
+        TEST_ASSERT_EQUAL(id, entry.sequence);
+        TEST_ASSERT_EQUAL_MEMORY(&expected, &record, sizeof(record));
+        id++;
+    }
+    TEST_ASSERT_EQUAL(last + 1, id);
+}
+
+/**
+ * @brief 区间查询结果: 首末id、记录数与不连续/内容错误数
+ */
+typedef struct
+{
+    uint32_t count;
+    uint32_t first_id;
+    uint32_t last_id;
+    uint32_t errors;
+    uint32_t stop_after;
+} test_query_t;
+
+static bool test_query_visit(const flash_log_entry_t *entry, const void *data, void *context)
+{
+    test_query_t *query = (test_query_t *)context;
+    const test_record_t *record = (const test_record_t *)data;
+    test_record_t expected;
+
+    test_fill_record(&expected, record->id);
+    if (memcmp(&expected, record, sizeof(expected)) != 0 || entry->timestamp != record->id * TEST_TIME_STEP ||
+        (query->count != 0 && record->id != query->last_id + 1))
+    {
+        query->errors++;
+    }
+    if (query->count == 0)
+    {
+        query->first_id = record->id;
+    }
+    query->last_id = record->id;
+    query->count++;
+    return query->stop_after == 0 || query->count < query->stop_after;
+}
+
+/**
+ * @brief 执行区间查询并校验返回值与回调结果一致
+ */
+static void test_query(test_query_t *query, uint32_t start_time, uint32_t end_time, uint32_t stop_after)
+{
+    memset(query, 0, sizeof(test_query_t));
+    query->stop_after = stop_after;
+    uint32_t count = flash_log_query(&test_log, TEST_RECORD_TYPE, start_time, end_time, test_query_visit, query);
+    TEST_ASSERT_EQUAL(query->count, count);
+    TEST_ASSERT_EQUAL(0, query->errors);
+}
+
+/**
+ * @brief 整片擦除并清零统计与日志实例 (各用例开始时调用)
+ */
+static void test_flash_reset(void)
+{
+    flash_sim_reset();
+    flash_reset_stats();
+    memset(&test_log, 0, sizeof(test_log));
+}
+
+TEST_SETUP()
+{
+    test_flash_reset();
+}
+
+TEST_TEARDOWN()
+{
+    flash_sim_detach_file();
+    flash_sim_power_on();
+}
+
+TEST_CASE(flash_sim_nor_semantics)
+{
+    uint8_t pattern[4] = {0xF0, 0x0F, 0xAA, 0x55};
+    uint8_t overlay[4] = {0x0F, 0x0F, 0xFF, 0x00};
+    uint8_t result[4];
+
+    test_flash_reset();
+
+    // 编程只能把1写成0
+    TEST_ASSERT_TRUE(flash_program(TEST_LOG_BASE, pattern, 4));
+    TEST_ASSERT_TRUE(flash_program(TEST_LOG_BASE, overlay, 4));
+    TEST_ASSERT_TRUE(flash_read(TEST_LOG_BASE, result, 4));
+    TEST_ASSERT_EQUAL(0x00, result[0]);
+    TEST_ASSERT_EQUAL(0x0F, result[1]);
+    TEST_ASSERT_EQUAL(0xAA, result[2]);
+    TEST_ASSERT_EQUAL(0x00, result[3]);
+
+    // 擦除恢复0xFF，非对齐与越界操作被拒绝
+    TEST_ASSERT_TRUE(flash_erase_page(TEST_LOG_BASE));
+    TEST_ASSERT_TRUE(flash_read(TEST_LOG_BASE, result, 4));
+    TEST_ASSERT_EQUAL(0xFF, result[0]);
+    TEST_ASSERT_FALSE(flash_erase_page(TEST_LOG_BASE + 4));
+    TEST_ASSERT_FALSE(flash_program(TEST_LOG_BASE + 2, pattern, 4));
+    TEST_ASSERT_FALSE(flash_program(FLASH_SIZE - 2, pattern, 4));
+    TEST_ASSERT_EQUAL(1, flash_sim_get_page_erase_count(TEST_LOG_BASE));
+}
+
+TEST_CASE(flash_log_append_and_read)
+{
+    test_record_t latest[5];
+
+    test_flash_reset();
+
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    for (uint32_t id = 0; id < 40; id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+
+    test_expect_range(0, 39);
+    TEST_ASSERT_EQUAL(40, flash_log_count(&test_log, TEST_RECORD_TYPE));
+    TEST_ASSERT_EQUAL(0, flash_log_count(&test_log, 0x03));
+
+    // 最新记录从新到旧，跨扇区
+    TEST_ASSERT_EQUAL(5, flash_log_read_latest(&test_log, TEST_RECORD_TYPE, latest, sizeof(test_record_t), 5));
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        TEST_ASSERT_EQUAL(39 - i, latest[i].id);
+    }
+
+    // 参数检查
+    TEST_ASSERT_FALSE(flash_log_append(&test_log, FLASH_LOG_TYPE_ANY, 0, latest, 4));
+    TEST_ASSERT_FALSE(flash_log_append(&test_log, 0xFF, 0, latest, 4));
+    TEST_ASSERT_FALSE(flash_log_mount(&test_log, TEST_LOG_BASE + 4, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    TEST_ASSERT_FALSE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, 1));
+}
+
+TEST_CASE(flash_log_wraparound_wear_leveling)
+{
+    uint32_t total = 2000;
+    uint32_t min_erase = 0xFFFFFFFFUL, max_erase = 0;
+
+    test_flash_reset();
+
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    for (uint32_t id = 0; id < total; id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+
+    // 保留最近 (扇区数-1) 个扇区的数据，且连续
+    uint32_t kept = flash_log_count(&test_log, TEST_RECORD_TYPE);
+    TEST_ASSERT_TRUE(kept > 0 && kept < total);
+    test_expect_range(total - kept, total - 1);
+
+    // 轮转写入: 各扇区擦除次数相差不超过1
+    for (uint16_t sector = 0; sector < TEST_LOG_SECTORS; sector++)
+    {
+        uint32_t count = flash_log_get_erase_count(&test_log, sector);
+        min_erase = count < min_erase ? count : min_erase;
+        max_erase = count > max_erase ? count : max_erase;
+        TEST_ASSERT_EQUAL(count, flash_sim_get_page_erase_count(TEST_LOG_BASE + sector * FLASH_PAGE_SIZE));
+    }
+    TEST_ASSERT_TRUE(max_erase - min_erase <= 1);
+
+    // 读取期间旧扇区被回收: 游标跳到当前最旧记录
+    flash_log_cursor_t cursor;
+    flash_log_entry_t entry;
+    flash_log_rewind(&test_log, &cursor);
+    TEST_ASSERT_TRUE(flash_log_next(&test_log, &cursor, &entry, NULL, 0));
+    for (uint32_t id = total; id < total + 200; id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+    TEST_ASSERT_TRUE(flash_log_next(&test_log, &cursor, &entry, NULL, 0));
+    TEST_ASSERT_TRUE(entry.sequence > total - kept + 1);
+}
+
+TEST_CASE(flash_log_mount_recovers_head)
+{
+    test_flash_reset();
+
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    for (uint32_t id = 0; id < 300; id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+    uint32_t kept = flash_log_count(&test_log, TEST_RECORD_TYPE);
+
+    // 重新挂载 (相当于重启): 写入头与序号恢复，继续追加
+    memset(&test_log, 0, sizeof(test_log));
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    TEST_ASSERT_EQUAL(300, test_log.next_sequence);
+    TEST_ASSERT_EQUAL(kept, flash_log_count(&test_log, TEST_RECORD_TYPE));
+    TEST_ASSERT_TRUE(test_append(300));
+    test_expect_range(301 - flash_log_count(&test_log, TEST_RECORD_TYPE), 300);
+}
+
+TEST_CASE(flash_log_power_cut_recovery)
+{
+    // 先写满7个扇区，下一条追加会写入摘要、启用第8个扇区并预擦除最旧扇区
+    uint32_t prefill = (TEST_LOG_SECTORS - 1) * TEST_RECORDS_PER_SECTOR;
+    test_query_t query;
+
+    // 在追加/扇区启用/预擦除过程中逐字节断电，重启后已提交记录完整连续，撕裂记录不可见
+    for (uint32_t budget = 1; budget < 640; budget++)
+    {
+        flash_sim_reset();
+        TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+
+        uint32_t committed = 0;
+        while (committed < prefill)
+        {
+            TEST_ASSERT_TRUE(test_append(committed));
+            committed++;
+        }
+
+        flash_sim_set_power_cut(budget);
+        while (test_append(committed))
+        {
+            committed++;
+        }
+        flash_sim_power_on();
+
+        TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+        uint32_t kept = flash_log_count(&test_log, TEST_RECORD_TYPE);
+        TEST_ASSERT_TRUE(kept >= prefill - TEST_RECORDS_PER_SECTOR);
+        test_expect_range(committed - kept, committed - 1);
+        test_query(&query, 0, 0xFFFFFFFFUL, 0);
+        TEST_ASSERT_EQUAL(kept, query.count);
+
+        // 恢复后继续写入
+        TEST_ASSERT_TRUE(test_append(committed));
+        test_expect_range(committed + 1 - flash_log_count(&test_log, TEST_RECORD_TYPE), committed);
+    }
+}
+
+TEST_CASE(flash_log_cache_batches_programs)
+{
+    flash_stats_t stats;
+    test_record_t latest[2];
+
+    test_flash_reset();
+
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    flash_log_set_cache(&test_log, test_cache, sizeof(test_cache));
+    flash_reset_stats();
+
+    // 36字节记录: 144字节缓存凑满4条才编程一次
+    for (uint32_t id = 0; id < 3; id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+    flash_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.program_count);
+    TEST_ASSERT_EQUAL(3, flash_log_get_pending(&test_log));
+
+    TEST_ASSERT_TRUE(test_append(3));
+    flash_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.program_count);
+    TEST_ASSERT_EQUAL(0, flash_log_get_pending(&test_log));
+
+    // 读取前自动写回，能读到刚追加的记录
+    TEST_ASSERT_TRUE(test_append(4));
+    TEST_ASSERT_EQUAL(2, flash_log_read_latest(&test_log, TEST_RECORD_TYPE, latest, sizeof(test_record_t), 2));
+    TEST_ASSERT_EQUAL(4, latest[0].id);
+    TEST_ASSERT_EQUAL(3, latest[1].id);
+
+    // 跨多个扇区循环写入，内容与逐条写入一致
+    for (uint32_t id = 5; id < 400; id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+    uint32_t kept = flash_log_count(&test_log, TEST_RECORD_TYPE);
+    test_expect_range(400 - kept, 399);
+    TEST_ASSERT_EQUAL(0, test_log.stats.write_errors);
+
+    // 缓存格式即Flash格式: 重新挂载 (不带缓存) 后序号与内容不变
+    flash_log_set_cache(&test_log, NULL, 0);
+    memset(&test_log, 0, sizeof(test_log));
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    TEST_ASSERT_EQUAL(400, test_log.next_sequence);
+    test_expect_range(400 - kept, 399);
+}
+
+TEST_CASE(flash_log_cache_deadline_flush)
+{
+    test_flash_reset();
+
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    flash_log_set_cache(&test_log, test_cache, sizeof(test_cache));
+
+    TEST_ASSERT_TRUE(test_append(0));
+    TEST_ASSERT_TRUE(flash_log_flush_expired(&test_log, 100));
+    TEST_ASSERT_EQUAL(1, flash_log_get_pending(&test_log));
+
+    // 超过时限后写回
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        system_tick_increment();
+    }
+    TEST_ASSERT_TRUE(flash_log_flush_expired(&test_log, 100));
+    TEST_ASSERT_EQUAL(0, flash_log_get_pending(&test_log));
+    TEST_ASSERT_EQUAL(1, test_log.stats.flushes);
+
+    // 未写回的记录在重启后丢失，已写回的保留
+    TEST_ASSERT_TRUE(test_append(1));
+    memset(&test_log, 0, sizeof(test_log));
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    test_expect_range(0, 0);
+}
+
+TEST_CASE(flash_log_cache_power_cut_recovery)
+{
+    uint32_t prefill = (TEST_LOG_SECTORS - 1) * TEST_RECORDS_PER_SECTOR;
+    test_query_t query;
+
+    // 缓存批量编程/扇区启用/预擦除过程中逐字节断电:
+    // 已写回的记录全部保留，未写回批次最多保留其完整的前缀，且记录连续
+    for (uint32_t budget = 1; budget < 640; budget++)
+    {
+        test_flash_reset();
+        TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+        flash_log_set_cache(&test_log, test_cache, sizeof(test_cache));
+
+        uint32_t appended = 0, durable = 0;
+        while (appended < prefill)
+        {
+            TEST_ASSERT_TRUE(test_append(appended));
+            appended++;
+        }
+        TEST_ASSERT_TRUE(flash_log_flush(&test_log));
+        durable = appended;
+
+        flash_sim_set_power_cut(budget);
+        while (test_append(appended))
+        {
+            appended++;
+            if (flash_log_get_pending(&test_log) == 0)
+            {
+                durable = appended;
+            }
+        }
+        flash_sim_power_on();
+
+        memset(&test_log, 0, sizeof(test_log));
+        TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+
+        flash_log_cursor_t cursor;
+        flash_log_entry_t entry;
+        uint32_t last = 0, expected = 0;
+        bool first = true;
+        flash_log_rewind(&test_log, &cursor);
+        while (flash_log_next(&test_log, &cursor, &entry, NULL, 0))
+        {
+            TEST_ASSERT_TRUE(first || entry.sequence == expected);
+            first = false;
+            expected = entry.sequence + 1;
+            last = entry.sequence;
+        }
+        TEST_ASSERT_FALSE(first);
+        TEST_ASSERT_TRUE(last + 1 >= durable && last <= appended);
+        test_query(&query, 0, 0xFFFFFFFFUL, 0);
+        TEST_ASSERT_EQUAL(flash_log_count(&test_log, TEST_RECORD_TYPE), query.count);
+
+        // 恢复后继续写入
+        TEST_ASSERT_TRUE(test_append(test_log.next_sequence));
+    }
+}
+
+TEST_CASE(flash_log_range_query)
+{
+    test_query_t query;
+    uint32_t total = 400, timestamp;
+
+    test_flash_reset();
+
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    TEST_ASSERT_FALSE(flash_log_get_last_timestamp(&test_log, &timestamp));
+    for (uint32_t id = 0; id < total; id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+    uint32_t kept = flash_log_count(&test_log, TEST_RECORD_TYPE);
+    uint32_t oldest = total - kept;
+
+    // 区间跨多个扇区，端点含在内，端点落在两条记录之间
+    test_query(&query, (oldest + 20) * TEST_TIME_STEP, (oldest + 60) * TEST_TIME_STEP, 0);
+    TEST_ASSERT_EQUAL(41, query.count);
+    TEST_ASSERT_EQUAL(oldest + 20, query.first_id);
+    test_query(&query, (oldest + 20) * TEST_TIME_STEP + 1, (oldest + 60) * TEST_TIME_STEP - 1, 0);
+    TEST_ASSERT_EQUAL(39, query.count);
+    TEST_ASSERT_EQUAL(oldest + 21, query.first_id);
+
+    // 区间覆盖已回收记录与未来时间: 返回全部保留记录
+    test_query(&query, 0, 0xFFFFFFFFUL, 0);
+    TEST_ASSERT_EQUAL(kept, query.count);
+    TEST_ASSERT_EQUAL(total - 1, query.last_id);
+
+    // 写入扇区内 (RAM摘要)、空区间、回调提前停止、类型过滤
+    test_query(&query, (total - 3) * TEST_TIME_STEP, total * TEST_TIME_STEP, 0);
+    TEST_ASSERT_EQUAL(3, query.count);
+    test_query(&query, total * TEST_TIME_STEP, 0xFFFFFFFFUL, 0);
+    TEST_ASSERT_EQUAL(0, query.count);
+    test_query(&query, 0, oldest * TEST_TIME_STEP - 1, 0);
+    TEST_ASSERT_EQUAL(0, query.count);
+    test_query(&query, 0, 0xFFFFFFFFUL, 5);
+    TEST_ASSERT_EQUAL(5, query.count);
+    uint32_t count = flash_log_query(&test_log, 0x03, 0, 0xFFFFFFFFUL, test_query_visit, &query);
+    TEST_ASSERT_EQUAL(0, count);
+    TEST_ASSERT_TRUE(flash_log_get_last_timestamp(&test_log, &timestamp));
+    TEST_ASSERT_EQUAL((total - 1) * TEST_TIME_STEP, timestamp);
+
+    // 重新挂载后摘要来自Flash，结果不变
+    memset(&test_log, 0, sizeof(test_log));
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    test_query(&query, (oldest + 20) * TEST_TIME_STEP, (oldest + 60) * TEST_TIME_STEP, 0);
+    TEST_ASSERT_EQUAL(41, query.count);
+    TEST_ASSERT_EQUAL(oldest + 20, query.first_id);
+}
+
+TEST_CASE(flash_log_range_query_mixed_lengths)
+{
+    uint8_t marker[4] = {1, 2, 3, 4};
+    test_query_t query;
+
+    test_flash_reset();
+
+    // 不同长度的记录混在同一扇区: 扇区内退化为顺序扫描
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    for (uint32_t id = 0; id < 60; id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+        if (id % 7 == 0)
+        {
+            TEST_ASSERT_TRUE(flash_log_append(&test_log, 0x03, id * TEST_TIME_STEP, marker, sizeof(marker)));
+        }
+    }
+
+    test_query(&query, 15 * TEST_TIME_STEP, 45 * TEST_TIME_STEP, 0);
+    TEST_ASSERT_EQUAL(31, query.count);
+    TEST_ASSERT_EQUAL(15, query.first_id);
+    TEST_ASSERT_EQUAL(45, query.last_id);
+    TEST_ASSERT_EQUAL(9, flash_log_count(&test_log, 0x03));
+}
+
+TEST_CASE(flash_log_seek_and_read_data)
+{
+    flash_log_cursor_t cursor;
+    flash_log_entry_t entry;
+    test_record_t record, expected;
+    uint8_t part[8];
+    uint32_t total = 3 * TEST_LOG_SECTORS * TEST_RECORDS_PER_SECTOR;
+
+    test_flash_reset();
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    for (uint32_t id = 0; id < total; id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+    uint32_t oldest = total - flash_log_count(&test_log, TEST_RECORD_TYPE);
+
+    // 任意序号 (扇区首条/中间/写入扇区) 均定位到该记录
+    for (uint32_t id = oldest; id < total; id += 7)
+    {
+        flash_log_seek(&test_log, &cursor, id);
+        TEST_ASSERT_TRUE(flash_log_next(&test_log, &cursor, &entry, &record, sizeof(record)));
+        TEST_ASSERT_EQUAL(id, entry.sequence);
+
+        // 按片段读取的数据与整条读取一致
+        test_fill_record(&expected, id);
+        TEST_ASSERT_EQUAL(sizeof(part), flash_log_read_data(&test_log, &cursor, &entry, 4, part, sizeof(part)));
+        TEST_ASSERT_EQUAL_MEMORY((uint8_t *)&expected + 4, part, sizeof(part));
+        TEST_ASSERT_EQUAL(2, flash_log_read_data(&test_log, &cursor, &entry, sizeof(record) - 2, part, sizeof(part)));
+    }
+
+    // 已回收的序号定位到最旧记录，超出末尾时读不到记录
+    flash_log_seek(&test_log, &cursor, 0);
+    TEST_ASSERT_TRUE(flash_log_next(&test_log, &cursor, &entry, NULL, 0));
+    TEST_ASSERT_EQUAL(oldest, entry.sequence);
+    flash_log_seek(&test_log, &cursor, total);
+    TEST_ASSERT_FALSE(flash_log_next(&test_log, &cursor, &entry, NULL, 0));
+
+    // 记录所在扇区被回收后不再返回旧数据
+    flash_log_seek(&test_log, &cursor, oldest);
+    TEST_ASSERT_TRUE(flash_log_next(&test_log, &cursor, &entry, NULL, 0));
+    for (uint32_t id = total; id < total + TEST_RECORDS_PER_SECTOR; id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+    TEST_ASSERT_EQUAL(0, flash_log_read_data(&test_log, &cursor, &entry, 0, part, sizeof(part)));
+}
+
+TEST_CASE(flash_log_deferred_erase)
+{
+    flash_stats_t stats;
+    test_query_t query;
+    uint32_t id = 0, append_erases = 0, maintained = 0;
+
+    test_flash_reset();
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    flash_log_set_deferred_erase(&test_log, true);
+
+    // 每次追加后执行一步维护: 追加路径不擦除，回收由维护完成
+    for (; id < 4 * TEST_LOG_SECTORS * TEST_RECORDS_PER_SECTOR; id++)
+    {
+        flash_reset_stats();
+        TEST_ASSERT_TRUE(test_append(id));
+        flash_get_stats(&stats);
+        append_erases += stats.erase_count;
+        maintained += flash_log_maintain(&test_log) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL(0, append_erases);
+    TEST_ASSERT_TRUE(maintained >= 3 * TEST_LOG_SECTORS);
+    TEST_ASSERT_FALSE(flash_log_maintain(&test_log));
+    test_expect_range(id - flash_log_count(&test_log, TEST_RECORD_TYPE), id - 1);
+
+    // 不执行维护: 写入扇区之后的最旧扇区暂时保留，启用时同步擦除
+    uint32_t before = flash_log_count(&test_log, TEST_RECORD_TYPE);
+    for (uint32_t i = 0; i < 3 * TEST_RECORDS_PER_SECTOR; i++, id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+    TEST_ASSERT_TRUE(flash_log_count(&test_log, TEST_RECORD_TYPE) >= before);
+    test_expect_range(id - flash_log_count(&test_log, TEST_RECORD_TYPE), id - 1);
+    test_query(&query, 0, 0xFFFFFFFFUL, 0);
+    TEST_ASSERT_EQUAL(flash_log_count(&test_log, TEST_RECORD_TYPE), query.count);
+
+    // 重新挂载时补做预擦除，设置保留
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    TEST_ASSERT_TRUE(test_log.defer_erase);
+    TEST_ASSERT_FALSE(flash_log_maintain(&test_log));
+    test_expect_range(id - flash_log_count(&test_log, TEST_RECORD_TYPE), id - 1);
+}
+
+/**
+ * @brief 按重启方式重新挂载 (RAM实例清空，重新设置检查点区)
+ */
+static bool test_remount_with_checkpoint(void)
+{
+    memset(&test_log, 0, sizeof(test_log));
+    flash_log_set_checkpoint(&test_log, TEST_CHECKPOINT_BASE, TEST_CHECKPOINT_PAGES);
+    return flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS);
+}
+
+TEST_CASE(flash_log_checkpoint_mount)
+{
+    flash_stats_t full_scan, fast;
+    uint32_t id = 0;
+
+    test_flash_reset();
+    TEST_ASSERT_TRUE(test_remount_with_checkpoint());
+    for (; id < 300; id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+    // 每启用FLASH_LOG_CHECKPOINT_INTERVAL个新扇区 (各预擦除一个扇区) 写一次检查点
+    TEST_ASSERT_TRUE(test_log.stats.erases > TEST_LOG_SECTORS);
+    TEST_ASSERT_TRUE(test_log.stats.checkpoints >= test_log.stats.erases / FLASH_LOG_CHECKPOINT_INTERVAL);
+    TEST_ASSERT_TRUE(test_log.stats.checkpoints < test_log.stats.erases);
+
+    // 写入扇区中途的检查点之后再追加几条: 挂载时只扫描这几条
+    TEST_ASSERT_TRUE(flash_log_checkpoint(&test_log));
+    for (; id < 303; id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+    uint32_t kept = flash_log_count(&test_log, TEST_RECORD_TYPE);
+
+    flash_reset_stats();
+    memset(&test_log, 0, sizeof(test_log));
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    flash_get_stats(&full_scan);
+    TEST_ASSERT_FALSE(test_log.checkpoint_mounted);
+
+    flash_reset_stats();
+    TEST_ASSERT_TRUE(test_remount_with_checkpoint());
+    flash_get_stats(&fast);
+    TEST_ASSERT_TRUE(test_log.checkpoint_mounted);
+    TEST_ASSERT_TRUE(fast.read_count < full_scan.read_count);
+    TEST_ASSERT_EQUAL(303, test_log.next_sequence);
+    TEST_ASSERT_EQUAL(kept, flash_log_count(&test_log, TEST_RECORD_TYPE));
+    test_expect_range(303 - kept, 302);
+
+    // 检查点过期 (之后又启用了两个扇区): 沿扇区序号向后找到写入头
+    flash_log_set_deferred_erase(&test_log, true);
+    for (uint32_t i = 0; i < 2 * TEST_RECORDS_PER_SECTOR; i++, id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+    TEST_ASSERT_TRUE(test_remount_with_checkpoint());
+    TEST_ASSERT_TRUE(test_log.checkpoint_mounted);
+    TEST_ASSERT_EQUAL(id, test_log.next_sequence);
+    test_expect_range(id - flash_log_count(&test_log, TEST_RECORD_TYPE), id - 1);
+
+    // 检查点指向的扇区已被回收: 退回全扫描
+    flash_log_set_deferred_erase(&test_log, true);
+    for (uint32_t i = 0; i < TEST_LOG_SECTORS * TEST_RECORDS_PER_SECTOR; i++, id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+    TEST_ASSERT_TRUE(test_remount_with_checkpoint());
+    TEST_ASSERT_FALSE(test_log.checkpoint_mounted);
+    TEST_ASSERT_EQUAL(id, test_log.next_sequence);
+    test_expect_range(id - flash_log_count(&test_log, TEST_RECORD_TYPE), id - 1);
+}
+
+TEST_CASE(flash_log_checkpoint_power_cut)
+{
+    uint32_t prefill = (TEST_LOG_SECTORS - 1) * TEST_RECORDS_PER_SECTOR;
+
+    // 在扇区切换、检查点写入与检查点页轮转擦除过程中逐字节断电
+    for (uint32_t budget = 1; budget < 700; budget += 3)
+    {
+        flash_sim_reset();
+        memset(&test_log, 0, sizeof(test_log));
+        TEST_ASSERT_TRUE(test_remount_with_checkpoint());
+
+        uint32_t committed = 0;
+        while (committed < prefill)
+        {
+            TEST_ASSERT_TRUE(test_append(committed));
+            committed++;
+        }
+
+        flash_sim_set_power_cut(budget);
+        while (test_append(committed))
+        {
+            committed++;
+        }
+        flash_sim_power_on();
+
+        TEST_ASSERT_TRUE(test_remount_with_checkpoint());
+        uint32_t kept = flash_log_count(&test_log, TEST_RECORD_TYPE);
+        TEST_ASSERT_TRUE(kept >= prefill - TEST_RECORDS_PER_SECTOR);
+        test_expect_range(committed - kept, committed - 1);
+
+        // 恢复后继续写入并写检查点，再次挂载一致
+        TEST_ASSERT_TRUE(test_append(committed));
+        TEST_ASSERT_TRUE(flash_log_checkpoint(&test_log));
+        TEST_ASSERT_TRUE(test_remount_with_checkpoint());
+        TEST_ASSERT_TRUE(test_log.checkpoint_mounted);
+        test_expect_range(committed + 1 - flash_log_count(&test_log, TEST_RECORD_TYPE), committed);
+    }
+}
+
+TEST_CASE(flash_log_file_backed_image)
+{
+    test_flash_reset();
+
+    remove(TEST_IMAGE_FILE);
+    TEST_ASSERT_TRUE(flash_sim_attach_file(TEST_IMAGE_FILE));
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    for (uint32_t id = 0; id < 50; id++)
+    {
+        TEST_ASSERT_TRUE(test_append(id));
+    }
+    flash_sim_detach_file();
+
+    // 清空RAM镜像后从文件重新加载
+    flash_sim_reset();
+    TEST_ASSERT_TRUE(flash_sim_attach_file(TEST_IMAGE_FILE));
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    test_expect_range(0, 49);
+
+    flash_sim_detach_file();
+    remove(TEST_IMAGE_FILE);
+}
+
+void run_flash_log_tests(void)
+{
+    printf("\n=== 运行Flash日志存储测试 ===\n");
+
+    RUN_TEST(flash_sim_nor_semantics);
+    RUN_TEST(flash_log_append_and_read);
+    RUN_TEST(flash_log_wraparound_wear_leveling);
+    RUN_TEST(flash_log_mount_recovers_head);
+    RUN_TEST(flash_log_power_cut_recovery);
+    RUN_TEST(flash_log_cache_batches_programs);
+    RUN_TEST(flash_log_cache_deadline_flush);
+    RUN_TEST(flash_log_cache_power_cut_recovery);
+    RUN_TEST(flash_log_range_query);
+    RUN_TEST(flash_log_range_query_mixed_lengths);
+    RUN_TEST(flash_log_seek_and_read_data);
+    RUN_TEST(flash_log_deferred_erase);
+    RUN_TEST(flash_log_checkpoint_mount);
+    RUN_TEST(flash_log_checkpoint_power_cut);
+    RUN_TEST(flash_log_file_backed_image);
+
+    printf("Flash日志存储测试用例已添加完成\n");
+}
@@ -0,0 +1,156 @@
+/**
+ * @file test_history_codec.c
+ * @brief 传感器历史数据块压缩编码单元测试
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/history_codec.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_BLOCK_SIZE 144
+
+static uint8_t test_block[TEST_BLOCK_SIZE];
+static history_encoder_t test_encoder;
+static history_decoder_t test_decoder;
+
+/**
+ * @brief 第i个测试采样: 间隔抖动、正负温度、状态偶尔变化
+ */
+static void test_make_sample(history_sample_t *sample, uint32_t i)
+{
+    sample->timestamp = 1000000UL + i * 60000UL + (i % 3) * 7;
+    sample->temperature = (int16_t)(-50 + (int16_t)((i * 37) % 23) - 11);
+    sample->humidity = (uint16_t)(550 + (i % 5));
+    sample->voltage = (uint16_t)(3300 - i / 4);
+    sample->status = (uint8_t)((i / 10) % 2);
+}
+
+TEST_CASE(history_codec_round_trip)
+{
+    history_sample_t sample, decoded;
+    uint32_t count = 0;
+
+    TEST_ASSERT_TRUE(history_encoder_init(&test_encoder, test_block, sizeof(test_block)));
+    TEST_ASSERT_EQUAL(0, history_encoder_length(&test_encoder));
+
+    for (uint32_t i = 0; i < HISTORY_CODEC_MAX_SAMPLES; i++)
+    {
+        test_make_sample(&sample, i);
+        if (!history_encoder_add(&test_encoder, &sample))
+        {
+            break;
+        }
+        count++;
+    }
+    TEST_ASSERT_TRUE(count > 10);
+    TEST_ASSERT_EQUAL(count, history_block_count(test_block, history_encoder_length(&test_encoder)));
+
+    TEST_ASSERT_TRUE(history_decoder_init(&test_decoder, test_block, history_encoder_length(&test_encoder)));
+    for (uint32_t i = 0; i < count; i++)
+    {
+        test_make_sample(&sample, i);
+        TEST_ASSERT_TRUE(history_decoder_next(&test_decoder, &decoded));
+        TEST_ASSERT_EQUAL(sample.timestamp, decoded.timestamp);
+        TEST_ASSERT_EQUAL(sample.temperature, decoded.temperature);
+        TEST_ASSERT_EQUAL(sample.humidity, decoded.humidity);
+        TEST_ASSERT_EQUAL(sample.voltage, decoded.voltage);
+        TEST_ASSERT_EQUAL(sample.status, decoded.status);
+    }
+    TEST_ASSERT_FALSE(history_decoder_next(&test_decoder, &decoded));
+}
+
+TEST_CASE(history_codec_extreme_values)
+{
+    history_sample_t samples[4] = {
+        {0, 32767, 0, 65535, 0xFF},
+        {0, -32768, 65535, 0, 0x00},
+        {0x3FFFFFFFUL, 0, 1, 1, 0x80},
+        {0x7FFFFFFEUL, 1, 2, 3, 0x80},
+    };
+    history_sample_t decoded;
+
+    // 满量程跳变与最大时间间隔均可编码
+    TEST_ASSERT_TRUE(history_encoder_init(&test_encoder, test_block, sizeof(test_block)));
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        TEST_ASSERT_TRUE(history_encoder_add(&test_encoder, &samples[i]));
+    }
+
+    TEST_ASSERT_TRUE(history_decoder_init(&test_decoder, test_block, history_encoder_length(&test_encoder)));
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        TEST_ASSERT_TRUE(history_decoder_next(&test_decoder, &decoded));
+        TEST_ASSERT_EQUAL(samples[i].timestamp, decoded.timestamp);
+        TEST_ASSERT_EQUAL(samples[i].temperature, decoded.temperature);
+        TEST_ASSERT_EQUAL(samples[i].humidity, decoded.humidity);
+        TEST_ASSERT_EQUAL(samples[i].voltage, decoded.voltage);
+        TEST_ASSERT_EQUAL(samples[i].status, decoded.status);
+    }
+}
+
+TEST_CASE(history_codec_rejects_and_keeps_block)
+{
+    history_sample_t sample, decoded;
+
+    TEST_ASSERT_TRUE(history_encoder_init(&test_encoder, test_block, HISTORY_CODEC_HEADER_SIZE + 6));
+    test_make_sample(&sample, 0);
+    TEST_ASSERT_TRUE(history_encoder_add(&test_encoder, &sample));
+
+    // 时间戳回退/间隔过大拒绝
+    sample.timestamp -= 1;
+    TEST_ASSERT_FALSE(history_encoder_add(&test_encoder, &sample));
+    sample.timestamp += 0x40000001UL;
+    TEST_ASSERT_FALSE(history_encoder_add(&test_encoder, &sample));
+
+    // 放得下一个小差分采样，放不下第二个状态变化的采样
+    test_make_sample(&sample, 1);
+    TEST_ASSERT_TRUE(history_encoder_add(&test_encoder, &sample));
+    uint16_t length = history_encoder_length(&test_encoder);
+    sample.timestamp += 60000;
+    sample.status ^= 1;
+    sample.temperature += 1000;
+    TEST_ASSERT_FALSE(history_encoder_add(&test_encoder, &sample));
+    TEST_ASSERT_EQUAL(length, history_encoder_length(&test_encoder));
+    TEST_ASSERT_EQUAL(2, history_block_count(test_block, length));
+
+    // 截断/版本错误的块: 解码安全结束
+    TEST_ASSERT_TRUE(history_decoder_init(&test_decoder, test_block, length - 1));
+    TEST_ASSERT_TRUE(history_decoder_next(&test_decoder, &decoded));
+    TEST_ASSERT_FALSE(history_decoder_next(&test_decoder, &decoded));
+    test_block[0] = 0xFF;
+    TEST_ASSERT_FALSE(history_decoder_init(&test_decoder, test_block, length));
+    TEST_ASSERT_EQUAL(0, history_block_count(test_block, length));
+}
+
+TEST_CASE(history_codec_steady_signal_size)
+{
+    history_sample_t sample = {0, 235, 550, 3300, 0};
+
+    // 固定周期、小幅波动: 每个采样4字节
+    TEST_ASSERT_TRUE(history_encoder_init(&test_encoder, test_block, sizeof(test_block)));
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        sample.timestamp = i * 60000UL;
+        sample.temperature = (int16_t)(235 + (i % 3) - 1);
+        sample.humidity = (uint16_t)(550 - (i % 2));
+        TEST_ASSERT_TRUE(history_encoder_add(&test_encoder, &sample));
+    }
+
+    // 第2个采样携带完整时间间隔 (3字节)
+    TEST_ASSERT_EQUAL(HISTORY_CODEC_HEADER_SIZE + 19 * 4 + 2, history_encoder_length(&test_encoder));
+}
+
+void run_history_codec_tests(void)
+{
+    printf("\n=== 运行历史数据压缩编码测试 ===\n");
+
+    RUN_TEST(history_codec_round_trip);
+    RUN_TEST(history_codec_extreme_values);
+    RUN_TEST(history_codec_rejects_and_keeps_block);
+    RUN_TEST(history_codec_steady_signal_size);
+
+    printf("历史数据压缩编码测试用例已添加完成\n");
+}
@@ -0,0 +1,363 @@
+/**
+ * @file test_history_export.c
+ * @brief 历史数据批量导出单元测试 (主机NOR模拟器 + 本地链路替身)
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/flash.h"
+#include "../../../inc/flash_log.h"
+#include "../../../inc/history_export.h"
+#include "../../../inc/system.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_LOG_BASE 0x0000E000UL
+#define TEST_LOG_SECTORS 8
+#define TEST_TYPE_SENSOR 0x06
+#define TEST_TYPE_ALARM 0x03
+#define TEST_RECORDS 80
+#define TEST_STREAM_SIZE 8192
+
+/**
+ * @brief 接收端替身: 按序接收块并累计确认，拼接负载字节流
+ */
+typedef struct
+{
+    history_export_t *exporter;
+    uint8_t session;
+    uint16_t expected;               // 期望的下一块编号
+    bool done;                       // 收到最后一块
+    bool overflow;                   // 字节流超出缓冲区 (由test_pump()断言)
+    uint32_t drop_every;             // 每N块丢弃一块 (0: 不丢弃)
+    uint32_t received;               // 链路上收到的块数
+    uint32_t stop_after;             // 收到该数量的有效块后停止接收 (0: 不停止)
+    history_export_chunk_t last;     // 最后一个有效块
+    uint16_t length;                 // 字节流长度
+    uint8_t stream[TEST_STREAM_SIZE];
+} test_receiver_t;
+
+static flash_log_t test_log;
+static test_receiver_t test_rx;
+static uint8_t test_chunk[HISTORY_EXPORT_MAX_CHUNK];
+
+/**
+ * @brief 记录数据: 长度随序号变化 (跨块切分的各种情况)
+ */
+static uint8_t test_fill(uint32_t id, uint8_t *data)
+{
+    uint8_t length = (uint8_t)(1 + (id * 37) % 40);
+    for (uint8_t i = 0; i < length; i++)
+    {
+        data[i] = (uint8_t)(id + i * 13);
+    }
+    return length;
+}
+
+/**
+ * @brief 写入TEST_RECORDS条记录 (报警记录穿插其中，时间戳为序号*10)
+ */
+static void test_prepare_log(void)
+{
+    uint8_t data[96];
+
+    flash_sim_reset();
+    memset(&test_log, 0, sizeof(test_log));
+    TEST_ASSERT_TRUE(flash_log_mount(&test_log, TEST_LOG_BASE, FLASH_PAGE_SIZE, TEST_LOG_SECTORS));
+    for (uint32_t id = 0; id < TEST_RECORDS; id++)
+    {
+        uint8_t length = test_fill(id, data);
+        TEST_ASSERT_TRUE(flash_log_append(&test_log, id % 5 == 4 ? TEST_TYPE_ALARM : TEST_TYPE_SENSOR, id * 10, data,
+                                          length));
+    }
+}
+
+static bool test_send(const uint8_t *data, uint16_t length, void *context)
+{
+    test_receiver_t *rx = (test_receiver_t *)context;
+    history_export_chunk_t chunk;
+    uint8_t ack[3];
+
+    rx->received++;
+    if (rx->drop_every && rx->received % rx->drop_every == 0)
+    {
+        return true;
+    }
+    if (rx->stop_after && rx->expected >= rx->stop_after)
+    {
+        return true;
+    }
+
+    // 校验失败或乱序的块丢弃，等待发送端超时重发
+    if (!history_export_parse_chunk(data, length, &chunk) || chunk.session != rx->session ||
+        chunk.index != rx->expected)
+    {
+        return true;
+    }
+
+    // 传输回调须返回值，不能在此断言
+    if (rx->length + chunk.length > TEST_STREAM_SIZE)
+    {
+        rx->overflow = true;
+        return true;
+    }
+    memcpy(&rx->stream[rx->length], data + HISTORY_EXPORT_HEADER_SIZE, chunk.length);
+    rx->length = (uint16_t)(rx->length + chunk.length);
+    rx->last = chunk;
+    rx->expected++;
+    rx->done = (chunk.flags & HISTORY_EXPORT_FLAG_LAST) != 0;
+
+    ack[0] = chunk.session;
+    ack[1] = (uint8_t)chunk.index;
+    ack[2] = (uint8_t)(chunk.index >> 8);
+    history_export_ack(rx->exporter, (uint16_t)(ack[1] | (ack[2] << 8)));
+    return true;
+}
+
+/**
+ * @brief 开始导出并重置接收端
+ */
+static void test_start(history_export_t *exporter, const history_export_request_t *request, uint16_t mtu,
+                       uint8_t window)
+{
+    history_export_transport_t transport = {test_send, &test_rx, mtu, window, 100};
+
+    memset(&test_rx, 0, sizeof(test_rx));
+    test_rx.exporter = exporter;
+    TEST_ASSERT_TRUE(history_export_start(exporter, &test_log, request, &transport));
+    test_rx.session = exporter->session;
+}
+
+/**
+ * @brief 运行推送任务直到完成 (每轮1ms)
+ */
+static void test_pump(history_export_t *exporter, uint32_t max_ms)
+{
+    for (uint32_t t = 0; t < max_ms && !history_export_is_done(exporter); t++)
+    {
+        history_export_task(exporter, test_chunk);
+        system_tick_increment();
+    }
+    TEST_ASSERT_FALSE(test_rx.overflow);
+}
+
+/**
+ * @brief 校验字节流解码后的记录与日志中的记录一致
+ * @param expected_count 应解码出的记录数
+ */
+static void test_check_stream(const uint8_t *stream, uint16_t length, uint8_t type, uint32_t first_time,
+                              uint32_t last_time, uint32_t expected_count)
+{
+    uint8_t expected[96];
+    uint32_t count = 0;
+    uint16_t offset = 0;
+    uint32_t id = 0;
+
+    while (offset < length)
+    {
+        TEST_ASSERT_TRUE(offset + HISTORY_EXPORT_RECORD_HEADER <= length);
+        uint32_t sequence = stream[offset] | (stream[offset + 1] << 8) | ((uint32_t)stream[offset + 2] << 16) |
+                            ((uint32_t)stream[offset + 3] << 24);
+        uint32_t timestamp = stream[offset + 4] | (stream[offset + 5] << 8) |
+                             ((uint32_t)stream[offset + 6] << 16) | ((uint32_t)stream[offset + 7] << 24);
+        uint8_t record_type = stream[offset + 8];
+        uint8_t record_length = stream[offset + 9];
+
+        // 下一条符合条件的记录
+        while (id < sequence)
+        {
+            bool match = (type == FLASH_LOG_TYPE_ANY || (id % 5 == 4 ? TEST_TYPE_ALARM : TEST_TYPE_SENSOR) == type) &&
+                         id * 10 >= first_time && id * 10 <= last_time;
+            TEST_ASSERT_FALSE(match);
+            id++;
+        }
+        TEST_ASSERT_EQUAL(id * 10, timestamp);
+        TEST_ASSERT_EQUAL(id % 5 == 4 ? TEST_TYPE_ALARM : TEST_TYPE_SENSOR, record_type);
+        TEST_ASSERT_EQUAL(test_fill(id, expected), record_length);
+        TEST_ASSERT_TRUE(offset + HISTORY_EXPORT_RECORD_HEADER + record_length <= length);
+        TEST_ASSERT_EQUAL_MEMORY(expected, &stream[offset + HISTORY_EXPORT_RECORD_HEADER], record_length);
+
+        offset = (uint16_t)(offset + HISTORY_EXPORT_RECORD_HEADER + record_length);
+        id++;
+        count++;
+    }
+    TEST_ASSERT_EQUAL(expected_count, count);
+}
+
+TEST_CASE(history_export_full_range_small_mtu)
+{
+    history_export_t exporter;
+    history_export_request_t request = {FLASH_LOG_TYPE_ANY, 0, 0xFFFFFFFFUL, false, {0, 0}};
+
+    // BLE默认ATT MTU: 每块只有6字节负载，记录头与数据都会跨块
+    test_prepare_log();
+    memset(&exporter, 0, sizeof(exporter));
+    test_start(&exporter, &request, HISTORY_EXPORT_MIN_CHUNK, 4);
+    test_pump(&exporter, 100000);
+
+    TEST_ASSERT_TRUE(history_export_is_done(&exporter));
+    TEST_ASSERT_TRUE(test_rx.done);
+    TEST_ASSERT_EQUAL(0, exporter.stats.retransmits);
+    test_check_stream(test_rx.stream, test_rx.length, FLASH_LOG_TYPE_ANY, 0, 0xFFFFFFFFUL, TEST_RECORDS);
+
+    // 导出开始后追加的记录不包含在内
+    uint8_t data[96];
+    TEST_ASSERT_TRUE(
+        flash_log_append(&test_log, TEST_TYPE_SENSOR, TEST_RECORDS * 10, data, test_fill(TEST_RECORDS, data)));
+    test_start(&exporter, &request, HISTORY_EXPORT_MAX_CHUNK, 8);
+    TEST_ASSERT_TRUE(flash_log_append(&test_log, TEST_TYPE_SENSOR, TEST_RECORDS * 10 + 10, data,
+                                      test_fill(TEST_RECORDS + 1, data)));
+    test_pump(&exporter, 100000);
+    TEST_ASSERT_TRUE(history_export_is_done(&exporter));
+    test_check_stream(test_rx.stream, test_rx.length, FLASH_LOG_TYPE_ANY, 0, TEST_RECORDS * 10, TEST_RECORDS + 1);
+}
+
+TEST_CASE(history_export_type_and_time_range)
+{
+    history_export_t exporter;
+    history_export_request_t request = {TEST_TYPE_SENSOR, 205, 600, false, {0, 0}};
+
+    test_prepare_log();
+    memset(&exporter, 0, sizeof(exporter));
+    test_start(&exporter, &request, 64, 2);
+    test_pump(&exporter, 100000);
+    TEST_ASSERT_TRUE(history_export_is_done(&exporter));
+
+    // 序号21~60中的传感器记录
+    test_check_stream(test_rx.stream, test_rx.length, TEST_TYPE_SENSOR, 205, 600, 32);
+
+    // 空范围: 一个只有块头的最后一块
+    request.start_time = 100000;
+    request.end_time = 200000;
+    test_start(&exporter, &request, 64, 2);
+    test_pump(&exporter, 1000);
+    TEST_ASSERT_TRUE(history_export_is_done(&exporter));
+    TEST_ASSERT_EQUAL(1, exporter.stats.chunks);
+    TEST_ASSERT_EQUAL(0, test_rx.length);
+}
+
+TEST_CASE(history_export_go_back_n_on_loss)
+{
+    history_export_t exporter;
+    history_export_request_t request = {FLASH_LOG_TYPE_ANY, 0, 0xFFFFFFFFUL, false, {0, 0}};
+
+    // 链路每7块丢一块: 接收端丢弃之后的乱序块，超时后从最早未确认块重发
+    test_prepare_log();
+    memset(&exporter, 0, sizeof(exporter));
+    test_start(&exporter, &request, 48, 4);
+    test_rx.drop_every = 7;
+    test_pump(&exporter, 1000000);
+
+    TEST_ASSERT_TRUE(history_export_is_done(&exporter));
+    TEST_ASSERT_TRUE(exporter.stats.retransmits > 0);
+    test_check_stream(test_rx.stream, test_rx.length, FLASH_LOG_TYPE_ANY, 0, 0xFFFFFFFFUL, TEST_RECORDS);
+
+    // 块内容损坏时CRC校验失败
+    history_export_chunk_t chunk;
+    request.resume = false;
+    test_start(&exporter, &request, 48, 1);
+    uint16_t length = history_export_poll(&exporter, test_chunk);
+    TEST_ASSERT_TRUE(history_export_parse_chunk(test_chunk, length, &chunk));
+    test_chunk[HISTORY_EXPORT_HEADER_SIZE + 3] ^= 0x10;
+    TEST_ASSERT_FALSE(history_export_parse_chunk(test_chunk, length, &chunk));
+    TEST_ASSERT_FALSE(history_export_parse_chunk(test_chunk, (uint16_t)(length - 1), &chunk));
+}
+
+TEST_CASE(history_export_resume_token)
+{
+    history_export_t exporter;
+    history_export_request_t request = {TEST_TYPE_SENSOR, 0, 0xFFFFFFFFUL, false, {0, 0}};
+    static uint8_t full[TEST_STREAM_SIZE];
+    uint16_t full_length;
+
+    test_prepare_log();
+    memset(&exporter, 0, sizeof(exporter));
+    test_start(&exporter, &request, 32, 4);
+    test_pump(&exporter, 100000);
+    memcpy(full, test_rx.stream, test_rx.length);
+    full_length = test_rx.length;
+    TEST_ASSERT_TRUE(exporter.next_index > 90);
+
+    // 接收方收到若干块后断开: 以接收方计算的 (最后正确接收块的序号, 偏移+长度)
+    // 或设备端记录的续传位置重新发起导出，拼接结果与一次导出完全相同
+    for (uint16_t stop = 1; stop < 90; stop += 29)
+    {
+        test_start(&exporter, &request, 32, 4);
+        test_rx.stop_after = stop;
+        test_pump(&exporter, 50);
+        TEST_ASSERT_FALSE(history_export_is_done(&exporter));
+        TEST_ASSERT_EQUAL(stop, test_rx.expected);
+
+        uint16_t received = test_rx.length;
+        history_export_request_t resume = request;
+        resume.resume = true;
+        if (stop % 2)
+        {
+            resume.position.sequence = test_rx.last.position.sequence;
+            resume.position.offset = (uint16_t)(test_rx.last.position.offset + test_rx.last.length);
+        }
+        else
+        {
+            history_export_get_resume(&exporter, &resume.position);
+        }
+
+        test_start(&exporter, &resume, 64, 4);
+        memcpy(test_rx.stream, full, received);
+        test_rx.length = received;
+        test_pump(&exporter, 100000);
+        TEST_ASSERT_TRUE(history_export_is_done(&exporter));
+        TEST_ASSERT_EQUAL(full_length, test_rx.length);
+        TEST_ASSERT_EQUAL_MEMORY(full, test_rx.stream, full_length);
+    }
+}
+
+TEST_CASE(history_export_pull_transport)
+{
+    history_export_t exporter;
+    history_export_request_t request = {FLASH_LOG_TYPE_ANY, 0, 0xFFFFFFFFUL, false, {0, 0}};
+    history_export_transport_t transport = {NULL, NULL, 248, 1, 0};
+    static uint8_t stream[TEST_STREAM_SIZE];
+    uint8_t repeat[HISTORY_EXPORT_MAX_CHUNK];
+    history_export_chunk_t chunk;
+    uint16_t stream_length = 0;
+    uint16_t index = 0;
+    uint16_t length;
+
+    test_prepare_log();
+    memset(&exporter, 0, sizeof(exporter));
+    TEST_ASSERT_TRUE(history_export_start(&exporter, &test_log, &request, &transport));
+
+    // 主站按编号逐块拉取；重复请求上一块得到相同内容，其他编号无效
+    TEST_ASSERT_EQUAL(0, history_export_pull(&exporter, 1, test_chunk));
+    while ((length = history_export_pull(&exporter, index, test_chunk)) > 0)
+    {
+        TEST_ASSERT_TRUE(history_export_parse_chunk(test_chunk, length, &chunk));
+        TEST_ASSERT_EQUAL(index, chunk.index);
+        if (index % 3 == 1)
+        {
+            TEST_ASSERT_EQUAL(length, history_export_pull(&exporter, index, repeat));
+            TEST_ASSERT_EQUAL_MEMORY(test_chunk, repeat, length);
+        }
+        memcpy(&stream[stream_length], test_chunk + HISTORY_EXPORT_HEADER_SIZE, chunk.length);
+        stream_length = (uint16_t)(stream_length + chunk.length);
+        index++;
+    }
+
+    TEST_ASSERT_TRUE(chunk.flags & HISTORY_EXPORT_FLAG_LAST);
+    TEST_ASSERT_TRUE(history_export_is_done(&exporter));
+    test_check_stream(stream, stream_length, FLASH_LOG_TYPE_ANY, 0, 0xFFFFFFFFUL, TEST_RECORDS);
+}
+
+void run_history_export_tests(void)
+{
+    printf("\n=== 运行历史数据导出测试 ===\n");
+
+    RUN_TEST(history_export_full_range_small_mtu);
+    RUN_TEST(history_export_type_and_time_range);
+    RUN_TEST(history_export_go_back_n_on_loss);
+    RUN_TEST(history_export_resume_token);
+    RUN_TEST(history_export_pull_transport);
+
+    printf("历史数据导出测试用例已添加完成\n");
+}
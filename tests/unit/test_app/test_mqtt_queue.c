@@ -0,0 +1,489 @@
+/**
+ * @file test_mqtt_queue.c
+ * @brief MQTT QoS1离线发布队列单元测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 客户端接到进程内的服务器替身: 替身应答CONNACK/PUBACK (可暂扣PUBACK)，
+ * 按载荷中的消息编号统计送达、重复与乱序。Flash溢出区使用主机NOR模拟器
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/flash.h"
+#include "../../../inc/mqtt.h"
+#include "../../../inc/mqtt_codec.h"
+#include "../../../inc/mqtt_queue.h"
+#include "../../../inc/system.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_TOPIC "dtu/0001/data"
+#define TEST_PAYLOAD 24   // 载荷长度 (前4字节为消息编号)
+#define TEST_MAX_ID 1024  // 替身可跟踪的消息编号范围
+#define TEST_STEP_MS 10   // 后台任务调用间隔
+#define TEST_RETRY_MS 2000
+
+// ============================================================================
+// 服务器替身
+// ============================================================================
+
+typedef struct
+{
+    mqtt_parser_t parser;
+    uint8_t body[MQTT_TX_BUFFER_SIZE];
+    uint8_t queue[256]; // 发往客户端的数据
+    uint16_t queue_length;
+    bool hold_acks;     // 暂扣PUBACK
+    uint32_t publishes; // 收到的PUBLISH数
+    uint32_t flagged;   // 带DUP标志的PUBLISH数
+    uint32_t unique;    // 送达的不同消息数
+    uint32_t duplicates;
+    uint32_t reordered; // 编号小于此前最大编号的首次送达
+    int32_t highest;    // 已送达的最大编号
+    uint16_t last_packet_id;
+    uint8_t seen[TEST_MAX_ID / 8];
+} test_link_t;
+
+static test_link_t g_link;
+
+static void link_queue(const uint8_t *data, uint16_t length)
+{
+    if (g_link.queue_length + length <= sizeof(g_link.queue))
+    {
+        memcpy(g_link.queue + g_link.queue_length, data, length);
+        g_link.queue_length = (uint16_t)(g_link.queue_length + length);
+    }
+}
+
+static bool link_seen(uint32_t id)
+{
+    return (g_link.seen[id / 8] & (1u << (id % 8))) != 0;
+}
+
+static void link_handle(const mqtt_codec_packet_t *packet)
+{
+    uint8_t out[8];
+
+    if (packet->type == MQTT_CONNECT)
+    {
+        out[0] = MQTT_CONNACK << 4;
+        out[1] = 2;
+        out[2] = 0;
+        out[3] = 0;
+        link_queue(out, 4);
+    }
+    else if (packet->type == MQTT_PUBLISH)
+    {
+        uint32_t id;
+
+        g_link.publishes++;
+        g_link.last_packet_id = packet->packet_id;
+        if (packet->flags & MQTT_CODEC_FLAG_DUP)
+        {
+            g_link.flagged++;
+        }
+
+        memcpy(&id, packet->payload, sizeof(id));
+        if (id < TEST_MAX_ID && link_seen(id))
+        {
+            g_link.duplicates++;
+        }
+        else if (id < TEST_MAX_ID)
+        {
+            g_link.seen[id / 8] |= (uint8_t)(1u << (id % 8));
+            g_link.unique++;
+            if ((int32_t)id < g_link.highest)
+            {
+                g_link.reordered++;
+            }
+            else
+            {
+                g_link.highest = (int32_t)id;
+            }
+        }
+
+        if (!g_link.hold_acks)
+        {
+            link_queue(out, mqtt_codec_ack(out, sizeof(out), MQTT_PUBACK, packet->packet_id));
+        }
+    }
+}
+
+static int link_open(const char *host, uint16_t port, void *context)
+{
+    (void)host;
+    (void)port;
+    (void)context;
+    g_link.queue_length = 0;
+    mqtt_parser_init(&g_link.parser, g_link.body, sizeof(g_link.body));
+    return MQTT_SUCCESS;
+}
+
+static int link_send(const uint8_t *data, uint16_t length, void *context)
+{
+    uint16_t offset = 0;
+
+    (void)context;
+    while (offset < length)
+    {
+        mqtt_codec_packet_t packet;
+        uint16_t consumed;
+
+        if (mqtt_parser_feed(&g_link.parser, data + offset, (uint16_t)(length - offset), &consumed, &packet) ==
+            MQTT_CODEC_PACKET)
+        {
+            link_handle(&packet);
+        }
+        offset = (uint16_t)(offset + consumed);
+    }
+    return MQTT_SUCCESS;
+}
+
+static int link_receive(uint8_t *buffer, uint16_t size, void *context)
+{
+    uint16_t length = g_link.queue_length;
+
+    (void)context;
+    if (length > size)
+    {
+        length = size;
+    }
+    memcpy(buffer, g_link.queue, length);
+    memmove(g_link.queue, g_link.queue + length, g_link.queue_length - length);
+    g_link.queue_length = (uint16_t)(g_link.queue_length - length);
+    return length;
+}
+
+static void link_close(void *context)
+{
+    (void)context;
+}
+
+static const mqtt_transport_t g_link_transport = {link_open, link_send, link_receive, link_close, NULL};
+
+// ============================================================================
+// 测试辅助
+// ============================================================================
+
+static uint8_t g_topic;
+
+static void test_advance(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        system_tick_increment();
+    }
+}
+
+static void test_setup(uint8_t burst, uint16_t interval_ms)
+{
+    mqtt_config_t config;
+    mqtt_queue_config_t queue = {4, 1, burst, interval_ms, TEST_RETRY_MS};
+
+    memset(&g_link, 0, sizeof(g_link));
+    g_link.highest = -1;
+    flash_sim_reset();
+
+    memset(&config, 0, sizeof(config));
+    strcpy(config.broker_host, "broker.local");
+    strcpy(config.client_id, "dtu-0001");
+    config.broker_port = 1883;
+    config.keep_alive = 600;
+    config.clean_session = true;
+    config.connect_timeout = 5000;
+
+    mqtt_deinit();
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_set_transport(&g_link_transport));
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_init(&config));
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_set_event_callback(mqtt_queue_on_event));
+
+    TEST_ASSERT_TRUE(mqtt_queue_init(&queue));
+    g_topic = (uint8_t)mqtt_queue_add_topic(TEST_TOPIC);
+}
+
+// 模拟重启: 队列重新初始化并按相同顺序登记主题
+static void test_reboot(void)
+{
+    mqtt_queue_config_t queue = {4, 1, 4, 100, TEST_RETRY_MS};
+
+    mqtt_disconnect();
+    TEST_ASSERT_TRUE(mqtt_queue_init(&queue));
+    TEST_ASSERT_EQUAL(0, mqtt_queue_add_topic(TEST_TOPIC));
+}
+
+static void test_connect(void)
+{
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_connect());
+    mqtt_task();
+    TEST_ASSERT_TRUE(mqtt_is_connected());
+}
+
+static void test_publish(uint32_t id)
+{
+    uint8_t payload[TEST_PAYLOAD];
+
+    memset(payload, (int)(id & 0xFF), sizeof(payload));
+    memcpy(payload, &id, sizeof(id));
+    TEST_ASSERT_TRUE(mqtt_queue_publish(g_topic, payload, sizeof(payload)));
+}
+
+// 按TEST_STEP_MS推进时间运行后台任务，直到队列排空或超时
+static uint32_t test_run(uint32_t max_ms)
+{
+    uint32_t elapsed = 0;
+
+    while (elapsed < max_ms && mqtt_queue_pending() > 0)
+    {
+        test_advance(TEST_STEP_MS);
+        mqtt_task();
+        mqtt_queue_task();
+        elapsed += TEST_STEP_MS;
+    }
+    return elapsed;
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+TEST_CASE(mqtt_queue_live_publish)
+{
+    mqtt_queue_stats_t stats;
+    uint8_t payload[MQTT_QUEUE_MAX_PAYLOAD + 1] = {0};
+
+    test_setup(4, 100);
+    test_connect();
+
+    // 在线且窗口空闲: 直接发出，PUBACK在mqtt_task中释放槽位
+    test_publish(0);
+    test_publish(1);
+    TEST_ASSERT_EQUAL(2, g_link.publishes);
+    TEST_ASSERT_EQUAL(2, mqtt_queue_pending());
+    mqtt_task();
+    TEST_ASSERT_EQUAL(0, mqtt_queue_pending());
+
+    TEST_ASSERT_TRUE(mqtt_queue_get_stats(&stats));
+    TEST_ASSERT_EQUAL(2, stats.sent_live);
+    TEST_ASSERT_EQUAL(2, stats.acked);
+    TEST_ASSERT_EQUAL(0, stats.drained);
+
+    // 参数检查
+    TEST_ASSERT_FALSE(mqtt_queue_publish(g_topic, payload, 0));
+    TEST_ASSERT_FALSE(mqtt_queue_publish(g_topic, payload, sizeof(payload)));
+    TEST_ASSERT_FALSE(mqtt_queue_publish((uint8_t)(g_topic + 1), payload, 4));
+    TEST_ASSERT_TRUE(mqtt_queue_add_topic("") < 0);
+
+    mqtt_disconnect();
+}
+
+TEST_CASE(mqtt_queue_store_and_forward)
+{
+    mqtt_queue_stats_t stats;
+
+    test_setup(4, 100);
+
+    // 离线: RAM环放满后最旧的消息溢出到Flash
+    for (uint32_t id = 0; id < 60; id++)
+    {
+        test_publish(id);
+    }
+    TEST_ASSERT_TRUE(mqtt_queue_get_stats(&stats));
+    TEST_ASSERT_EQUAL(60, mqtt_queue_pending());
+    TEST_ASSERT_TRUE(stats.spilled > 0);
+    TEST_ASSERT_EQUAL(60, stats.spilled + stats.ram_messages);
+    TEST_ASSERT_TRUE(stats.ram_peak <= MQTT_QUEUE_RAM_SIZE);
+    TEST_ASSERT_EQUAL(0, stats.dropped);
+    TEST_ASSERT_EQUAL(0, g_link.publishes);
+
+    // 重连后按原顺序全部送达，先Flash后RAM
+    test_connect();
+    test_run(60000);
+    TEST_ASSERT_EQUAL(0, mqtt_queue_pending());
+    TEST_ASSERT_EQUAL(60, g_link.unique);
+    TEST_ASSERT_EQUAL(0, g_link.duplicates);
+    TEST_ASSERT_EQUAL(0, g_link.reordered);
+
+    TEST_ASSERT_TRUE(mqtt_queue_get_stats(&stats));
+    TEST_ASSERT_EQUAL(60, stats.drained);
+    TEST_ASSERT_EQUAL(60, stats.acked);
+    TEST_ASSERT_TRUE(stats.commits > 0);
+
+    mqtt_disconnect();
+}
+
+TEST_CASE(mqtt_queue_paced_drain)
+{
+    mqtt_queue_stats_t stats;
+
+    test_setup(2, 100);
+    for (uint32_t id = 0; id < 40; id++)
+    {
+        test_publish(id);
+    }
+
+    // 每个排放周期最多2条积压
+    test_connect();
+    mqtt_queue_task();
+    TEST_ASSERT_EQUAL(2, g_link.publishes);
+    mqtt_task();
+    mqtt_queue_task();
+    TEST_ASSERT_EQUAL(2, g_link.publishes);
+
+    // 排放期间的实时消息不排在积压之后
+    test_publish(500);
+    TEST_ASSERT_EQUAL(3, g_link.publishes);
+    TEST_ASSERT_TRUE(link_seen(500));
+
+    // 1秒内积压不超过 2条 x 11个周期
+    for (uint32_t t = 0; t < 1000; t += TEST_STEP_MS)
+    {
+        test_advance(TEST_STEP_MS);
+        mqtt_task();
+        mqtt_queue_task();
+    }
+    TEST_ASSERT_TRUE(mqtt_queue_get_stats(&stats));
+    TEST_ASSERT_TRUE(stats.drained <= 22);
+    TEST_ASSERT_TRUE(stats.drained >= 20);
+
+    // 保留槽位: 积压最多占用window-live_reserve个槽位
+    g_link.hold_acks = true;
+    test_advance(100);
+    mqtt_queue_task();
+    mqtt_queue_task();
+    TEST_ASSERT_EQUAL(3, mqtt_queue_get_stats(&stats) ? stats.in_flight : 0);
+    test_publish(501);
+    TEST_ASSERT_TRUE(link_seen(501));
+
+    g_link.hold_acks = false;
+    test_advance(TEST_RETRY_MS);
+    test_run(60000);
+    TEST_ASSERT_EQUAL(42, g_link.unique);
+
+    mqtt_disconnect();
+}
+
+TEST_CASE(mqtt_queue_retransmit)
+{
+    mqtt_queue_stats_t stats;
+
+    test_setup(4, 100);
+    test_connect();
+
+    // PUBACK超时: 以DUP标志、原报文ID重发
+    g_link.hold_acks = true;
+    test_publish(7);
+    uint16_t packet_id = g_link.last_packet_id;
+    TEST_ASSERT_EQUAL(1, g_link.publishes);
+    test_advance(TEST_RETRY_MS - 1);
+    mqtt_task();
+    mqtt_queue_task();
+    TEST_ASSERT_EQUAL(1, g_link.publishes);
+    test_advance(1);
+    mqtt_queue_task();
+    TEST_ASSERT_EQUAL(2, g_link.publishes);
+    TEST_ASSERT_EQUAL(1, g_link.flagged);
+    TEST_ASSERT_EQUAL(packet_id, g_link.last_packet_id);
+
+    // 断线重连: 窗口内消息立即重发
+    mqtt_disconnect();
+    TEST_ASSERT_EQUAL(1, mqtt_queue_pending());
+    test_connect();
+    mqtt_queue_task();
+    TEST_ASSERT_EQUAL(3, g_link.publishes);
+    TEST_ASSERT_EQUAL(2, g_link.flagged);
+
+    g_link.hold_acks = false;
+    test_advance(TEST_RETRY_MS);
+    test_run(10000);
+    TEST_ASSERT_EQUAL(0, mqtt_queue_pending());
+    TEST_ASSERT_EQUAL(1, g_link.unique);
+    TEST_ASSERT_TRUE(mqtt_queue_get_stats(&stats));
+    TEST_ASSERT_EQUAL(1, stats.acked);
+    TEST_ASSERT_TRUE(stats.retransmits >= 3);
+
+    mqtt_disconnect();
+}
+
+TEST_CASE(mqtt_queue_persistence)
+{
+    mqtt_queue_stats_t stats;
+
+    test_setup(4, 100);
+
+    // 掉电预警: RAM环全部转存到Flash，重启后恢复
+    for (uint32_t id = 0; id < 30; id++)
+    {
+        test_publish(id);
+    }
+    TEST_ASSERT_TRUE(mqtt_queue_flush());
+    TEST_ASSERT_TRUE(mqtt_queue_get_stats(&stats));
+    TEST_ASSERT_EQUAL(0, stats.ram_messages);
+    TEST_ASSERT_EQUAL(30, stats.flash_pending);
+
+    test_reboot();
+    TEST_ASSERT_EQUAL(30, mqtt_queue_pending());
+
+    // 排放到20条确认后掉电: 提交点在第16条之后，重启后剩余14条
+    test_connect();
+    while (mqtt_queue_get_stats(&stats) && stats.acked < 20)
+    {
+        test_advance(TEST_STEP_MS);
+        mqtt_task();
+        mqtt_queue_task();
+    }
+    TEST_ASSERT_EQUAL(1, stats.commits);
+
+    test_reboot();
+    TEST_ASSERT_EQUAL(30 - MQTT_QUEUE_COMMIT_EVERY, mqtt_queue_pending());
+
+    // 提交点之后已送达的消息重发一次 (至少一次语义)
+    test_connect();
+    test_run(60000);
+    TEST_ASSERT_EQUAL(0, mqtt_queue_pending());
+    TEST_ASSERT_EQUAL(30, g_link.unique);
+    TEST_ASSERT_TRUE(g_link.duplicates <= 20 - MQTT_QUEUE_COMMIT_EVERY + MQTT_QUEUE_WINDOW);
+
+    // 排空后已写入提交点: 再次重启无积压
+    test_reboot();
+    TEST_ASSERT_EQUAL(0, mqtt_queue_pending());
+
+    mqtt_disconnect();
+}
+
+TEST_CASE(mqtt_queue_flash_overflow)
+{
+    mqtt_queue_stats_t stats;
+
+    test_setup(4, 100);
+
+    // 超出Flash溢出区容量: 回收最旧扇区，保留最新的消息
+    for (uint32_t id = 0; id < 300; id++)
+    {
+        test_publish(id);
+    }
+
+    test_connect();
+    test_run(120000);
+    TEST_ASSERT_EQUAL(0, mqtt_queue_pending());
+    TEST_ASSERT_TRUE(mqtt_queue_get_stats(&stats));
+    TEST_ASSERT_TRUE(stats.dropped > 0);
+    TEST_ASSERT_EQUAL(300, g_link.unique + stats.dropped);
+    TEST_ASSERT_EQUAL(299, g_link.highest);
+    TEST_ASSERT_EQUAL(0, g_link.reordered);
+
+    mqtt_disconnect();
+}
+
+void run_mqtt_queue_tests(void)
+{
+    printf("\n=== 运行MQTT离线队列测试 ===\n");
+
+    RUN_TEST(mqtt_queue_live_publish);
+    RUN_TEST(mqtt_queue_store_and_forward);
+    RUN_TEST(mqtt_queue_paced_drain);
+    RUN_TEST(mqtt_queue_retransmit);
+    RUN_TEST(mqtt_queue_persistence);
+    RUN_TEST(mqtt_queue_flash_overflow);
+
+    printf("MQTT离线队列测试用例已添加完成\n");
+}
@@ -0,0 +1,84 @@
+/**
+ * @file test_poll_window.c
+ * @brief 总线轮询空闲窗口预测单元测试
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/poll_window.h"
+#include <stdio.h>
+
+static poll_window_t test_window;
+
+TEST_SETUP()
+{
+    poll_window_init(&test_window, 0);
+}
+
+TEST_TEARDOWN()
+{
+}
+
+TEST_CASE(poll_window_learn_period)
+{
+    poll_window_init(&test_window, 0);
+
+    // 上电后未收到请求: 静默足够久才认为没有主站
+    TEST_ASSERT_FALSE(poll_window_idle(&test_window, 100, 20));
+    TEST_ASSERT_TRUE(poll_window_idle(&test_window, POLL_WINDOW_LEARN_MS, 20));
+
+    // 只有一个间隔时仍在学习
+    poll_window_request(&test_window, 1000);
+    poll_window_request(&test_window, 1050);
+    TEST_ASSERT_FALSE(poll_window_idle(&test_window, 1055, 20));
+
+    poll_window_request(&test_window, 1100);
+    TEST_ASSERT_EQUAL(50, test_window.interval);
+
+    // 20ms阻塞须在下一个请求 (1150) 前留出余量完成
+    TEST_ASSERT_TRUE(poll_window_idle(&test_window, 1100, 20));
+    TEST_ASSERT_TRUE(poll_window_idle(&test_window, 1100 + 50 - 20 - POLL_WINDOW_MARGIN_MS, 20));
+    TEST_ASSERT_FALSE(poll_window_idle(&test_window, 1100 + 50 - 20 - POLL_WINDOW_MARGIN_MS + 1, 20));
+    TEST_ASSERT_FALSE(poll_window_idle(&test_window, 1143, 3));
+
+    // 主站停止轮询
+    TEST_ASSERT_TRUE(poll_window_idle(&test_window, 1200, 20));
+}
+
+TEST_CASE(poll_window_track_interval)
+{
+    poll_window_init(&test_window, 0);
+    poll_window_request(&test_window, 0);
+    poll_window_request(&test_window, 100);
+    poll_window_request(&test_window, 200);
+    TEST_ASSERT_EQUAL(100, test_window.interval);
+
+    // 更短的间隔立即采用
+    poll_window_request(&test_window, 240);
+    TEST_ASSERT_EQUAL(40, test_window.interval);
+
+    // 更长的间隔缓慢跟随
+    poll_window_request(&test_window, 320);
+    TEST_ASSERT_EQUAL(40 + (40 >> POLL_WINDOW_FOLLOW_SHIFT), test_window.interval);
+
+    // 时钟回绕
+    poll_window_init(&test_window, 0xFFFFFF00UL);
+    poll_window_request(&test_window, 0xFFFFFFD0UL);
+    poll_window_request(&test_window, 0x00000000UL);
+    poll_window_request(&test_window, 0x00000030UL);
+    TEST_ASSERT_EQUAL(0x30, test_window.interval);
+    TEST_ASSERT_TRUE(poll_window_idle(&test_window, 0x00000030UL, 20));
+
+    TEST_ASSERT_TRUE(poll_window_idle(NULL, 0, 20));
+}
+
+void run_poll_window_tests(void)
+{
+    printf("\n=== 运行轮询空闲窗口测试 ===\n");
+
+    RUN_TEST(poll_window_learn_period);
+    RUN_TEST(poll_window_track_interval);
+
+    printf("轮询空闲窗口测试用例已添加完成\n");
+}
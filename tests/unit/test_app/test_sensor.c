@@ -8,6 +8,7 @@
 #include "../../framework/unity.h"
 #include "../../../inc/sensor.h"
 #include <string.h>
+#include <math.h>
 
 // 测试夹具
 static sensor_config_t test_config;
@@ -72,6 +73,33 @@ TEST_CASE(sensor_read_voltage)
     TEST_ASSERT_LESS_THAN(30.0f, voltage);
 }
 
+TEST_CASE(sensor_fixed_point_conversion)
+{
+    // 温度通道: raw * 0.1 - 40.0，采样路径全程Q16.16
+    q16_t value = q16_linear(650, Q24_CONST(0.1), Q16_CONST(-40.0));
+    TEST_ASSERT_EQUAL(25000, q16_to_milli(value));
+
+    // 电压通道: 0.01V精度
+    value = q16_linear(330, Q24_CONST(0.01), 0);
+    TEST_ASSERT_EQUAL(3300, q16_to_milli(value));
+
+    // 比例因子超出Q8.24范围时由sensor_config()拒绝，不再静默饱和
+    TEST_ASSERT_TRUE(q24_in_range(127.5f));
+    TEST_ASSERT_TRUE(q24_in_range(-127.5f));
+    TEST_ASSERT_FALSE(q24_in_range(128.0f));
+    TEST_ASSERT_FALSE(q24_in_range(-128.0f));
+    TEST_ASSERT_FALSE(q24_in_range(NAN));
+    TEST_ASSERT_EQUAL(Q24_CONST(127.5), q24_from_float(127.5f));
+
+    // EMA (alpha = 0.1) 收敛
+    q16_t average = 0;
+    for (int i = 0; i < 200; i++)
+    {
+        average = q16_ema_tenth(average, Q16_CONST(10.0));
+    }
+    TEST_ASSERT_WITHIN(1, 10000, q16_to_milli(average));
+}
+
 void run_sensor_tests(void)
 {
     printf("\n=== 运行传感器管理模块测试 ===\n");
@@ -80,6 +108,7 @@ void run_sensor_tests(void)
     RUN_TEST(sensor_read_temperature);
     RUN_TEST(sensor_read_humidity);
     RUN_TEST(sensor_read_voltage);
+    RUN_TEST(sensor_fixed_point_conversion);
 
     printf("传感器管理模块测试用例已添加完成\n");
 }
\ No newline at end of file
@@ -0,0 +1,82 @@
+/**
+ * @file test_sensor_lut.c
+ * @brief 传感器线性化查找表单元测试
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/sensor_lut.h"
+#include <stdio.h>
+
+TEST_SETUP()
+{
+}
+
+TEST_TEARDOWN()
+{
+}
+
+TEST_CASE(sensor_lut_get_by_id)
+{
+    TEST_ASSERT_NULL(sensor_lut_get(SENSOR_LUT_NONE));
+    TEST_ASSERT_NULL(sensor_lut_get(SENSOR_LUT_COUNT));
+    TEST_ASSERT_NOT_NULL(sensor_lut_get(SENSOR_LUT_NTC_10K_3950));
+    TEST_ASSERT_EQUAL(SENSOR_LUT_KIND_DIRECT, sensor_lut_get(SENSOR_LUT_NTC_10K_3950)->kind);
+    TEST_ASSERT_EQUAL(SENSOR_LUT_KIND_BINARY, sensor_lut_get(SENSOR_LUT_HUMIDITY_PROBE)->kind);
+}
+
+TEST_CASE(sensor_lut_binary_hits_breakpoints)
+{
+    const sensor_lut_t *lut = sensor_lut_get(SENSOR_LUT_HUMIDITY_PROBE);
+
+    // 断点处精确等于表值，过采样输入按扩展位数对齐
+    for (uint16_t i = 0; i < lut->count; i++)
+    {
+        TEST_ASSERT_EQUAL(lut->values[i], sensor_lut_lookup(lut, lut->codes[i], 0));
+        TEST_ASSERT_EQUAL(lut->values[i], sensor_lut_lookup(lut, (uint32_t)lut->codes[i] << 2, 2));
+    }
+
+    // 端点外取端点值
+    TEST_ASSERT_EQUAL(lut->values[0], sensor_lut_lookup(lut, 0, 0));
+    TEST_ASSERT_EQUAL(lut->values[lut->count - 1], sensor_lut_lookup(lut, 4095, 0));
+
+    // 段内单调
+    q16_t previous = sensor_lut_lookup(lut, lut->codes[0], 0);
+    for (uint32_t raw = lut->codes[0]; raw <= lut->codes[lut->count - 1]; raw++)
+    {
+        q16_t value = sensor_lut_lookup(lut, raw, 0);
+        TEST_ASSERT_TRUE(value >= previous);
+        previous = value;
+    }
+}
+
+TEST_CASE(sensor_lut_direct_interpolates)
+{
+    const sensor_lut_t *lut = sensor_lut_get(SENSOR_LUT_NTC_10K_3950);
+
+    // 中点 (R = 10K) 为25°C
+    TEST_ASSERT_WITHIN(Q16_CONST(0.05), Q16_CONST(25.0), sensor_lut_lookup(lut, 2048, 0));
+    TEST_ASSERT_WITHIN(Q16_CONST(0.05), Q16_CONST(25.0), sensor_lut_lookup(lut, 2048 << 4, 4));
+
+    // 两表项之间取中值
+    q16_t v0 = lut->values[40];
+    q16_t v1 = lut->values[41];
+    TEST_ASSERT_WITHIN(1, v0 + (v1 - v0) / 2, sensor_lut_lookup(lut, (40U << lut->shift) + (1U << (lut->shift - 1)), 0));
+
+    // NTC接地: 码值越大温度越低，两端限幅在量程内
+    TEST_ASSERT_EQUAL(Q16_CONST(125.0), sensor_lut_lookup(lut, 0, 0));
+    TEST_ASSERT_EQUAL(Q16_CONST(-40.0), sensor_lut_lookup(lut, 4095, 0));
+    TEST_ASSERT_EQUAL(Q16_CONST(-40.0), sensor_lut_lookup(lut, 0xFFFF, 4));
+}
+
+void run_sensor_lut_tests(void)
+{
+    printf("\n=== 运行传感器查找表测试 ===\n");
+
+    RUN_TEST(sensor_lut_get_by_id);
+    RUN_TEST(sensor_lut_binary_hits_breakpoints);
+    RUN_TEST(sensor_lut_direct_interpolates);
+
+    printf("传感器查找表测试用例已添加完成\n");
+}
@@ -0,0 +1,379 @@
+/**
+ * @file test_storage.c
+ * @brief 数据存储模块单元测试 (主机NOR模拟器)
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/storage.h"
+#include "../../../inc/flash.h"
+#include "../../../inc/system.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief 整片擦除并重新初始化存储模块
+ */
+static void test_storage_reset(void)
+{
+    storage_deinit();
+    flash_sim_reset();
+}
+
+TEST_SETUP()
+{
+    test_storage_reset();
+}
+
+TEST_TEARDOWN()
+{
+    storage_deinit();
+}
+
+TEST_CASE(storage_init_creates_default_config)
+{
+    storage_config_t config;
+
+    test_storage_reset();
+
+    TEST_ASSERT_TRUE(storage_init());
+    TEST_ASSERT_TRUE(storage_is_initialized());
+    TEST_ASSERT_TRUE(storage_read_config(&config));
+    TEST_ASSERT_EQUAL(1, config.modbus_slave_id);
+    TEST_ASSERT_EQUAL(0, storage_get_history_count(STORAGE_TYPE_SENSOR));
+}
+
+TEST_CASE(storage_history_round_trip)
+{
+    storage_sensor_record_t sensors[4];
+    storage_alarm_record_t alarms[4];
+    storage_status_record_t statuses[4];
+
+    test_storage_reset();
+    TEST_ASSERT_TRUE(storage_init());
+
+    for (int16_t i = 0; i < 2000; i++)
+    {
+        TEST_ASSERT_TRUE(storage_write_sensor_history((int16_t)(200 + i), 500, 3300, 0));
+    }
+    for (uint16_t i = 0; i < 10; i++)
+    {
+        TEST_ASSERT_TRUE(storage_write_alarm_history(1, 2, (int32_t)(100 + i), i));
+        TEST_ASSERT_TRUE(storage_write_status_history(i * 60, 3, 0));
+    }
+
+    // 最新记录从新到旧；报警与状态记录互不覆盖
+    TEST_ASSERT_EQUAL(4, storage_read_sensor_history(sensors, 4));
+    TEST_ASSERT_EQUAL(2199, sensors[0].temperature);
+    TEST_ASSERT_EQUAL(2196, sensors[3].temperature);
+    TEST_ASSERT_EQUAL(500, sensors[3].humidity);
+    TEST_ASSERT_EQUAL(3300, sensors[3].voltage);
+    TEST_ASSERT_TRUE(storage_check_integrity(&sensors[0].header, (const uint8_t *)&sensors[0].temperature));
+
+    TEST_ASSERT_EQUAL(4, storage_read_alarm_history(alarms, 4));
+    TEST_ASSERT_EQUAL(109, alarms[0].alarm_value);
+    TEST_ASSERT_EQUAL(4, storage_read_status_history(statuses, 4));
+    TEST_ASSERT_EQUAL(9 * 60, statuses[0].uptime);
+    TEST_ASSERT_EQUAL(10, storage_get_history_count(STORAGE_TYPE_ALARM));
+    TEST_ASSERT_EQUAL(10, storage_get_history_count(STORAGE_TYPE_STATUS));
+
+    // 历史区循环写入: 保留最近的采样 (压缩后远多于未压缩的84条)
+    uint16_t kept = storage_get_history_count(STORAGE_TYPE_SENSOR);
+    TEST_ASSERT_TRUE(kept > 500 && kept < 2000);
+}
+
+TEST_CASE(storage_history_survives_reinit)
+{
+    storage_sensor_record_t sensor;
+
+    test_storage_reset();
+    TEST_ASSERT_TRUE(storage_init());
+    for (int16_t i = 0; i < 20; i++)
+    {
+        TEST_ASSERT_TRUE(storage_write_sensor_history(i, 0, 0, 0));
+    }
+
+    // 重启后挂载恢复写入头，继续追加
+    storage_deinit();
+    TEST_ASSERT_TRUE(storage_init());
+    TEST_ASSERT_EQUAL(20, storage_get_history_count(STORAGE_TYPE_SENSOR));
+    TEST_ASSERT_TRUE(storage_write_sensor_history(20, 0, 0, 0));
+    TEST_ASSERT_EQUAL(1, storage_read_sensor_history(&sensor, 1));
+    TEST_ASSERT_EQUAL(20, sensor.temperature);
+
+    // 清除历史区不影响日志区
+    TEST_ASSERT_TRUE(storage_write_alarm_history(1, 1, 1, 1));
+    TEST_ASSERT_TRUE(storage_clear_history(STORAGE_TYPE_SENSOR));
+    TEST_ASSERT_EQUAL(0, storage_get_history_count(STORAGE_TYPE_SENSOR));
+    TEST_ASSERT_EQUAL(1, storage_get_history_count(STORAGE_TYPE_ALARM));
+}
+
+/**
+ * @brief 区间查询回调: 收集温度值
+ */
+typedef struct
+{
+    uint16_t count;
+    int16_t temperatures[16];
+} test_storage_query_t;
+
+static bool test_storage_visit(const storage_header_t *record, void *context)
+{
+    test_storage_query_t *query = (test_storage_query_t *)context;
+    const storage_sensor_record_t *sensor = (const storage_sensor_record_t *)record;
+
+    if (record->type != STORAGE_TYPE_SENSOR || query->count >= 16)
+    {
+        return false;
+    }
+    query->temperatures[query->count++] = sensor->temperature;
+    return true;
+}
+
+TEST_CASE(storage_history_time_range_query)
+{
+    test_storage_query_t query = {0};
+    uint32_t times[50];
+
+    test_storage_reset();
+    TEST_ASSERT_TRUE(storage_init());
+
+    // 每条记录间隔100ms
+    for (int16_t i = 0; i < 50; i++)
+    {
+        times[i] = storage_get_timestamp();
+        TEST_ASSERT_TRUE(storage_write_sensor_history(i, 0, 0, 0));
+        for (uint8_t tick = 0; tick < 100; tick++)
+        {
+            system_tick_increment();
+        }
+    }
+
+    TEST_ASSERT_EQUAL(11, storage_query_history(STORAGE_TYPE_SENSOR, times[20], times[30], test_storage_visit, &query));
+    TEST_ASSERT_EQUAL(11, query.count);
+    TEST_ASSERT_EQUAL(20, query.temperatures[0]);
+    TEST_ASSERT_EQUAL(30, query.temperatures[10]);
+
+    // 重启后时间戳接续，不早于已存记录
+    storage_deinit();
+    TEST_ASSERT_TRUE(storage_init());
+    TEST_ASSERT_TRUE(storage_get_timestamp() > times[49]);
+    TEST_ASSERT_EQUAL(0, storage_query_history(STORAGE_TYPE_ALARM, 0, 0xFFFFFFFFUL, test_storage_visit, &query));
+}
+
+TEST_CASE(storage_config_change_without_erase)
+{
+    storage_config_t config;
+    flash_stats_t stats;
+
+    test_storage_reset();
+    TEST_ASSERT_TRUE(storage_init());
+
+    // 修改单个参数: 追加差分记录，不擦除配置区
+    TEST_ASSERT_TRUE(storage_read_config(&config));
+    config.modbus_slave_id = 17;
+    flash_reset_stats();
+    TEST_ASSERT_TRUE(storage_write_config(&config));
+    flash_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.erase_count);
+
+    storage_deinit();
+    TEST_ASSERT_TRUE(storage_init());
+    TEST_ASSERT_TRUE(storage_read_config(&config));
+    TEST_ASSERT_EQUAL(17, config.modbus_slave_id);
+    TEST_ASSERT_EQUAL(9600, config.modbus_baudrate);
+}
+
+TEST_CASE(storage_config_migrates_legacy_layout)
+{
+    storage_config_t config;
+
+    // 旧版本: 配置区起始处的单份配置
+    test_storage_reset();
+    TEST_ASSERT_TRUE(storage_init());
+    TEST_ASSERT_TRUE(storage_read_config(&config));
+    storage_deinit();
+
+    flash_sim_reset();
+    config.modbus_slave_id = 42;
+    config.crc16 = storage_calculate_crc16((uint8_t *)&config, sizeof(storage_config_t) - 2);
+    TEST_ASSERT_TRUE(flash_program(STORAGE_CONFIG_ADDR, (const uint8_t *)&config, sizeof(storage_config_t)));
+
+    TEST_ASSERT_TRUE(storage_init());
+    TEST_ASSERT_TRUE(storage_read_config(&config));
+    TEST_ASSERT_EQUAL(42, config.modbus_slave_id);
+}
+
+/**
+ * @brief 作业完成回调: 统计成功次数
+ */
+static void test_storage_job_done(uint8_t type, bool success, void *context)
+{
+    uint16_t *done = (uint16_t *)context;
+
+    if (type == STORAGE_TYPE_CONFIG && success)
+    {
+        (*done)++;
+    }
+}
+
+TEST_CASE(storage_async_jobs_read_your_writes)
+{
+    storage_config_t config;
+    storage_alarm_record_t alarms[4];
+    flash_stats_t stats;
+    uint16_t done = 0;
+
+    test_storage_reset();
+    TEST_ASSERT_TRUE(storage_init());
+    TEST_ASSERT_TRUE(storage_write_alarm_history(1, 1, 100, 0));
+    TEST_ASSERT_TRUE(storage_process_jobs());
+
+    // 提交只入队，不访问Flash
+    TEST_ASSERT_TRUE(storage_read_config(&config));
+    flash_reset_stats();
+    config.modbus_slave_id = 5;
+    TEST_ASSERT_TRUE(storage_write_config_async(&config, test_storage_job_done, &done));
+    config.modbus_slave_id = 6;
+    TEST_ASSERT_TRUE(storage_write_config_async(&config, test_storage_job_done, &done));
+    TEST_ASSERT_TRUE(storage_write_alarm_history(1, 1, 101, 0));
+    TEST_ASSERT_TRUE(storage_write_alarm_history(1, 1, 102, 0));
+    flash_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.program_count);
+    TEST_ASSERT_EQUAL(4, storage_get_pending_jobs());
+
+    // 读取包含排队中的数据
+    TEST_ASSERT_TRUE(storage_read_config(&config));
+    TEST_ASSERT_EQUAL(6, config.modbus_slave_id);
+    TEST_ASSERT_EQUAL(3, storage_get_history_count(STORAGE_TYPE_ALARM));
+    TEST_ASSERT_EQUAL(3, storage_read_alarm_history(alarms, 4));
+    TEST_ASSERT_EQUAL(102, alarms[0].alarm_value);
+    TEST_ASSERT_EQUAL(100, alarms[2].alarm_value);
+    TEST_ASSERT_TRUE(storage_check_integrity(&alarms[0].header, (const uint8_t *)&alarms[0].alarm_type));
+
+    // 后台每次执行一个作业；两次配置提交合并为一次写入，两个回调均被调用
+    for (uint8_t i = 4; i > 0; i--)
+    {
+        TEST_ASSERT_EQUAL(i, storage_get_pending_jobs());
+        storage_task();
+    }
+    TEST_ASSERT_EQUAL(0, storage_get_pending_jobs());
+    TEST_ASSERT_EQUAL(2, done);
+    flash_get_stats(&stats);
+    TEST_ASSERT_TRUE(stats.program_count > 0);
+    TEST_ASSERT_EQUAL(0, stats.erase_count);
+
+    storage_deinit();
+    TEST_ASSERT_TRUE(storage_init());
+    TEST_ASSERT_TRUE(storage_read_config(&config));
+    TEST_ASSERT_EQUAL(6, config.modbus_slave_id);
+    TEST_ASSERT_EQUAL(3, storage_read_alarm_history(alarms, 4));
+    TEST_ASSERT_EQUAL(102, alarms[0].alarm_value);
+}
+
+/**
+ * @brief 作业完成回调: 按类型统计成功次数
+ */
+static void test_storage_count_job(uint8_t type, bool success, void *context)
+{
+    uint16_t *counts = (uint16_t *)context;
+
+    if (success && type <= STORAGE_TYPE_SENSOR_BLOCK)
+    {
+        counts[type]++;
+    }
+}
+
+TEST_CASE(storage_async_record_callbacks)
+{
+    storage_alarm_record_t alarm;
+    uint16_t counts[STORAGE_TYPE_SENSOR_BLOCK + 1] = {0};
+
+    test_storage_reset();
+    TEST_ASSERT_TRUE(storage_init());
+    storage_set_block_callback(test_storage_count_job, counts);
+
+    memset(&alarm, 0, sizeof(alarm));
+    alarm.alarm_type = 2;
+    TEST_ASSERT_TRUE(storage_write_alarm_event_async(&alarm, 10, test_storage_count_job, counts));
+    TEST_ASSERT_TRUE(storage_write_status_history_async(60, 1, 0, test_storage_count_job, counts));
+    TEST_ASSERT_EQUAL(0, counts[STORAGE_TYPE_ALARM]);
+    storage_task();
+    storage_task();
+    TEST_ASSERT_EQUAL(1, counts[STORAGE_TYPE_ALARM]);
+    TEST_ASSERT_EQUAL(1, counts[STORAGE_TYPE_STATUS]);
+
+    // 采样进入RAM数据块，块写入Flash后才回调
+    TEST_ASSERT_TRUE(storage_write_sensor_history(250, 500, 3300, 0));
+    TEST_ASSERT_EQUAL(0, storage_get_pending_jobs());
+    TEST_ASSERT_TRUE(storage_flush());
+    TEST_ASSERT_EQUAL(1, counts[STORAGE_TYPE_SENSOR_BLOCK]);
+
+    // 块满时自动封闭
+    for (uint32_t i = 0; counts[STORAGE_TYPE_SENSOR_BLOCK] < 2 && i < 1000; i++)
+    {
+        TEST_ASSERT_TRUE(storage_write_sensor_history((int16_t)(i * 37 % 900), (uint16_t)(i * 13 % 1000), 3300, 0));
+        storage_task();
+    }
+    TEST_ASSERT_EQUAL(2, counts[STORAGE_TYPE_SENSOR_BLOCK]);
+}
+
+TEST_CASE(storage_async_erase_only_in_background)
+{
+    storage_config_t config;
+    flash_stats_t before, after;
+    uint32_t erases = 0;
+
+    test_storage_reset();
+    TEST_ASSERT_TRUE(storage_init());
+    TEST_ASSERT_TRUE(storage_read_config(&config));
+
+    // 历史区/日志区多次回绕，配置区多次切换bank
+    for (uint32_t i = 0; i < 20000; i++)
+    {
+        flash_get_stats(&before);
+        TEST_ASSERT_TRUE(storage_write_sensor_history((int16_t)(i % 500), 500, 3300, 0));
+        if (i % 4 == 0)
+        {
+            TEST_ASSERT_TRUE(storage_write_alarm_history(1, 1, (int32_t)i, 0));
+        }
+        if (i % 20 == 0)
+        {
+            config.sample_period = (uint16_t)i;
+            TEST_ASSERT_TRUE(storage_write_config_async(&config, NULL, NULL));
+        }
+        flash_get_stats(&after);
+        TEST_ASSERT_EQUAL(before.erase_count, after.erase_count);
+
+        // 后台每次最多擦除一页
+        storage_task();
+        flash_get_stats(&before);
+        TEST_ASSERT_TRUE(before.erase_count - after.erase_count <= 1);
+        erases += before.erase_count - after.erase_count;
+    }
+    TEST_ASSERT_TRUE(erases > 30);
+
+    storage_sensor_record_t sensor;
+    TEST_ASSERT_EQUAL(1, storage_read_sensor_history(&sensor, 1));
+    TEST_ASSERT_EQUAL(19999 % 500, sensor.temperature);
+    TEST_ASSERT_TRUE(storage_flush());
+    TEST_ASSERT_EQUAL(0, storage_get_pending_jobs());
+}
+
+void run_storage_tests(void)
+{
+    printf("\n=== 运行数据存储测试 ===\n");
+
+    RUN_TEST(storage_init_creates_default_config);
+    RUN_TEST(storage_history_round_trip);
+    RUN_TEST(storage_history_survives_reinit);
+    RUN_TEST(storage_history_time_range_query);
+    RUN_TEST(storage_config_change_without_erase);
+    RUN_TEST(storage_config_migrates_legacy_layout);
+    RUN_TEST(storage_async_jobs_read_your_writes);
+    RUN_TEST(storage_async_record_callbacks);
+    RUN_TEST(storage_async_erase_only_in_background);
+
+    printf("数据存储测试用例已添加完成\n");
+}
@@ -0,0 +1,119 @@
+/**
+ * @file test_stream_stats.c
+ * @brief 流式统计单元测试
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/stream_stats.h"
+#include <stdio.h>
+#include <string.h>
+
+// 测试夹具
+static stream_stats_t test_stats;
+
+TEST_SETUP()
+{
+    stream_stats_reset(&test_stats);
+}
+
+TEST_TEARDOWN()
+{
+}
+
+TEST_CASE(stream_stats_empty_summary)
+{
+    stream_stats_summary_t summary;
+
+    stream_stats_reset(&test_stats);
+    stream_stats_get_summary(&test_stats, &summary);
+    TEST_ASSERT_EQUAL(0, summary.count);
+    TEST_ASSERT_EQUAL(0, summary.mean);
+    TEST_ASSERT_EQUAL(0, summary.p99);
+}
+
+TEST_CASE(stream_stats_welford_mean_variance)
+{
+    stream_stats_summary_t summary;
+
+    // 1..100: 均值50.5，样本方差841.67，标准差29.01
+    stream_stats_reset(&test_stats);
+    for (int i = 1; i <= 100; i++)
+    {
+        stream_stats_update(&test_stats, Q16_FROM_INT(i));
+    }
+    stream_stats_get_summary(&test_stats, &summary);
+
+    TEST_ASSERT_EQUAL(100, summary.count);
+    TEST_ASSERT_EQUAL(Q16_FROM_INT(1), summary.min);
+    TEST_ASSERT_EQUAL(Q16_FROM_INT(100), summary.max);
+    TEST_ASSERT_WITHIN(Q16_CONST(0.01), Q16_CONST(50.5), summary.mean);
+    TEST_ASSERT_WITHIN(Q16_CONST(0.05), Q16_CONST(841.667), summary.variance);
+    TEST_ASSERT_WITHIN(Q16_CONST(0.01), Q16_CONST(29.011), summary.stddev);
+
+    // 大偏置小波动: 数值稳定
+    stream_stats_reset(&test_stats);
+    for (int i = 0; i < 1000; i++)
+    {
+        stream_stats_update(&test_stats, Q16_CONST(3000.0) + ((i & 1) ? Q16_CONST(0.5) : -Q16_CONST(0.5)));
+    }
+    stream_stats_get_summary(&test_stats, &summary);
+    TEST_ASSERT_WITHIN(Q16_CONST(0.01), Q16_CONST(3000.0), summary.mean);
+    TEST_ASSERT_WITHIN(Q16_CONST(0.01), Q16_CONST(0.25), summary.variance);
+}
+
+TEST_CASE(stream_stats_small_window_exact)
+{
+    stream_stats_summary_t summary;
+    static const int values[5] = {40, 10, 50, 20, 30};
+
+    // 样本不足9个时分位数取有序样本
+    stream_stats_reset(&test_stats);
+    for (int i = 0; i < 5; i++)
+    {
+        stream_stats_update(&test_stats, Q16_FROM_INT(values[i]));
+    }
+    stream_stats_get_summary(&test_stats, &summary);
+
+    TEST_ASSERT_EQUAL(Q16_FROM_INT(30), summary.p50);
+    TEST_ASSERT_EQUAL(Q16_FROM_INT(50), summary.p99);
+}
+
+TEST_CASE(stream_stats_p2_percentiles)
+{
+    stream_stats_summary_t summary;
+
+    // 1..1000的乱序排列 (613与1000互质)
+    stream_stats_reset(&test_stats);
+    for (int i = 0; i < 1000; i++)
+    {
+        stream_stats_update(&test_stats, Q16_FROM_INT(1 + (i * 613) % 1000));
+    }
+    stream_stats_get_summary(&test_stats, &summary);
+
+    TEST_ASSERT_WITHIN(Q16_FROM_INT(15), Q16_FROM_INT(500), summary.p50);
+    TEST_ASSERT_WITHIN(Q16_FROM_INT(10), Q16_FROM_INT(950), summary.p95);
+    TEST_ASSERT_WITHIN(Q16_FROM_INT(5), Q16_FROM_INT(990), summary.p99);
+    TEST_ASSERT_TRUE(summary.p50 <= summary.p95 && summary.p95 <= summary.p99);
+
+    // 复位后开始新窗口
+    stream_stats_reset(&test_stats);
+    stream_stats_update(&test_stats, Q16_FROM_INT(7));
+    stream_stats_get_summary(&test_stats, &summary);
+    TEST_ASSERT_EQUAL(1, summary.count);
+    TEST_ASSERT_EQUAL(Q16_FROM_INT(7), summary.p95);
+    TEST_ASSERT_EQUAL(0, summary.variance);
+}
+
+void run_stream_stats_tests(void)
+{
+    printf("\n=== 运行流式统计测试 ===\n");
+
+    RUN_TEST(stream_stats_empty_summary);
+    RUN_TEST(stream_stats_welford_mean_variance);
+    RUN_TEST(stream_stats_small_window_exact);
+    RUN_TEST(stream_stats_p2_percentiles);
+
+    printf("流式统计测试用例已添加完成\n");
+}
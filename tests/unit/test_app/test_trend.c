@@ -0,0 +1,123 @@
+/**
+ * @file test_trend.c
+ * @brief 多分辨率趋势数据单元测试
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/trend.h"
+#include <stdio.h>
+
+static trend_point_t test_points[TREND_MINUTE_BUCKETS + 1];
+
+TEST_SETUP()
+{
+    trend_init();
+}
+
+TEST_TEARDOWN()
+{
+}
+
+TEST_CASE(trend_minute_rollup)
+{
+    trend_init();
+
+    // 第0分钟: 10, 20, 30；第1分钟: 40
+    trend_add_sample(0, Q16_FROM_INT(10), 0);
+    trend_add_sample(0, Q16_FROM_INT(20), 20);
+    trend_add_sample(0, Q16_FROM_INT(30), 40);
+    trend_add_sample(0, Q16_FROM_INT(40), 60);
+
+    uint16_t count = trend_query(0, TREND_LEVEL_MINUTE, test_points, TREND_MINUTE_BUCKETS + 1);
+    TEST_ASSERT_EQUAL(2, count);
+
+    TEST_ASSERT_EQUAL(0, test_points[0].start_time);
+    TEST_ASSERT_TRUE(test_points[0].valid);
+    TEST_ASSERT_EQUAL(Q16_FROM_INT(10), test_points[0].min);
+    TEST_ASSERT_EQUAL(Q16_FROM_INT(30), test_points[0].max);
+    TEST_ASSERT_EQUAL(Q16_FROM_INT(20), test_points[0].avg);
+
+    // 当前桶未封桶，保持全精度
+    TEST_ASSERT_EQUAL(60, test_points[1].start_time);
+    TEST_ASSERT_EQUAL(Q16_FROM_INT(40), test_points[1].avg);
+
+    // 小时级只有一个当前桶，包含全部样本
+    count = trend_query(0, TREND_LEVEL_HOUR, test_points, 4);
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL(Q16_FROM_INT(25), test_points[0].avg);
+    TEST_ASSERT_EQUAL(Q16_FROM_INT(40), test_points[0].max);
+}
+
+TEST_CASE(trend_gaps_and_wraparound)
+{
+    trend_init();
+
+    // 第0分钟有数据，第1~2分钟无数据，第3分钟恢复
+    trend_add_sample(1, Q16_FROM_INT(50), 10);
+    trend_add_sample(1, Q16_FROM_INT(55), 190);
+
+    uint16_t count = trend_query(1, TREND_LEVEL_MINUTE, test_points, 8);
+    TEST_ASSERT_EQUAL(4, count);
+    TEST_ASSERT_TRUE(test_points[0].valid);
+    TEST_ASSERT_FALSE(test_points[1].valid);
+    TEST_ASSERT_FALSE(test_points[2].valid);
+    TEST_ASSERT_EQUAL(180, test_points[3].start_time);
+
+    // 超过环容量后只保留最近的桶，时间连续
+    for (uint32_t minute = 4; minute < 200; minute++)
+    {
+        trend_add_sample(1, Q16_FROM_INT((int32_t)(minute % 100)), minute * 60);
+    }
+    count = trend_query(1, TREND_LEVEL_MINUTE, test_points, TREND_MINUTE_BUCKETS + 1);
+    TEST_ASSERT_EQUAL(TREND_MINUTE_BUCKETS + 1, count);
+    for (uint16_t i = 1; i < count; i++)
+    {
+        TEST_ASSERT_EQUAL(test_points[i - 1].start_time + 60, test_points[i].start_time);
+    }
+    TEST_ASSERT_EQUAL(199 * 60, test_points[count - 1].start_time);
+    TEST_ASSERT_EQUAL(Q16_FROM_INT(98), test_points[count - 2].avg);
+
+    // 只取最近3个点
+    count = trend_query(1, TREND_LEVEL_MINUTE, test_points, 3);
+    TEST_ASSERT_EQUAL(3, count);
+    TEST_ASSERT_EQUAL(197 * 60, test_points[0].start_time);
+
+    // 长时间中断后旧桶全部过期
+    trend_add_sample(1, Q16_FROM_INT(1), 1000000);
+    TEST_ASSERT_EQUAL(1, trend_query(1, TREND_LEVEL_MINUTE, test_points, 8));
+}
+
+TEST_CASE(trend_resolution_and_limits)
+{
+    trend_init();
+
+    // 默认精度1/256，封桶后误差不超过半个LSB
+    trend_add_sample(2, Q16_CONST(3.3), 0);
+    trend_add_sample(2, Q16_CONST(3.3), 60);
+    trend_query(2, TREND_LEVEL_MINUTE, test_points, 2);
+    TEST_ASSERT_WITHIN(128, Q16_CONST(3.3), test_points[0].avg);
+
+    // 宽量程通道 (如原始码值) 需加大移位: 移位n时范围为 ±2^(n-1)
+    TEST_ASSERT_TRUE(trend_set_resolution(2, 13));
+    trend_add_sample(2, Q16_FROM_INT(4000), 0);
+    trend_add_sample(2, Q16_FROM_INT(4000), 60);
+    trend_query(2, TREND_LEVEL_MINUTE, test_points, 2);
+    TEST_ASSERT_EQUAL(Q16_FROM_INT(4000), test_points[0].avg);
+
+    TEST_ASSERT_FALSE(trend_set_resolution(TREND_CHANNELS, 8));
+    TEST_ASSERT_EQUAL(0, trend_query(TREND_CHANNELS, TREND_LEVEL_MINUTE, test_points, 2));
+    TEST_ASSERT_GREATER_THAN(0, trend_get_ram_usage());
+}
+
+void run_trend_tests(void)
+{
+    printf("\n=== 运行趋势数据测试 ===\n");
+
+    RUN_TEST(trend_minute_rollup);
+    RUN_TEST(trend_gaps_and_wraparound);
+    RUN_TEST(trend_resolution_and_limits);
+
+    printf("趋势数据测试用例已添加完成\n");
+}
@@ -59,6 +59,122 @@ TEST_CASE(adc_read_voltage)
     TEST_ASSERT_LESS_THAN(3.3f, voltage); // VCC参考电压
 }
 
+// 扫描帧回调记录
+static adc_scan_frame_t scan_frame;
+static uint32_t scan_callback_count;
+
+static void test_scan_callback(const adc_scan_frame_t *frame)
+{
+    memcpy(&scan_frame, frame, sizeof(adc_scan_frame_t));
+    scan_callback_count++;
+}
+
+TEST_CASE(adc_scan_group_frame)
+{
+    adc_scan_config_t scan_config = {
+        .channel_mask = 0x0F,
+        .sample_time = ADC_SAMPLE_TIME_4,
+        .use_pdma = true,
+        .callback = test_scan_callback};
+
+    scan_callback_count = 0;
+    TEST_ASSERT_TRUE(adc_scan_config(&scan_config));
+    TEST_ASSERT_TRUE(adc_scan_start());
+
+    // 整帧只回调一次，包含全部扫描通道
+    TEST_ASSERT_EQUAL(1, scan_callback_count);
+    TEST_ASSERT_EQUAL(0x0F, scan_frame.channel_mask);
+    for (int ch = 0; ch < 4; ch++)
+    {
+        uint16_t value;
+        TEST_ASSERT_TRUE(adc_read_single((adc_channel_t)ch, &value, 10));
+        TEST_ASSERT_EQUAL(value, scan_frame.values[ch]);
+    }
+
+    uint32_t sequence = scan_frame.sequence;
+    TEST_ASSERT_TRUE(adc_scan_start());
+    TEST_ASSERT_EQUAL(sequence + 1, scan_frame.sequence);
+
+    TEST_ASSERT_TRUE(adc_scan_stop());
+    TEST_ASSERT_FALSE(adc_scan_start());
+}
+
+TEST_CASE(adc_scan_timer_timestamp)
+{
+    adc_scan_config_t scan_config = {
+        .channel_mask = 0x01,
+        .sample_time = ADC_SAMPLE_TIME_4,
+        .use_pdma = true,
+        .callback = test_scan_callback};
+
+    scan_callback_count = 0;
+    TEST_ASSERT_TRUE(adc_scan_config(&scan_config));
+    TEST_ASSERT_FALSE(adc_scan_start_timer(1));
+    TEST_ASSERT_TRUE(adc_scan_start_timer(1000));
+
+    // 时间戳 = 名义匹配时刻 + 中断响应延迟，延迟变化体现在采样间隔上
+    adc_sim_set_trigger_latency(0);
+    adc_timer_trigger_handler();
+    uint32_t first = scan_frame.timestamp_us;
+    adc_sim_set_trigger_latency(37);
+    adc_timer_trigger_handler();
+    TEST_ASSERT_EQUAL(1037, scan_frame.timestamp_us - first);
+    adc_sim_set_trigger_latency(0);
+    adc_timer_trigger_handler();
+    TEST_ASSERT_EQUAL(2000, scan_frame.timestamp_us - first);
+    TEST_ASSERT_EQUAL(3, scan_callback_count);
+
+    // 停止后不再触发
+    TEST_ASSERT_TRUE(adc_scan_stop());
+    adc_timer_trigger_handler();
+    TEST_ASSERT_EQUAL(3, scan_callback_count);
+}
+
+TEST_CASE(adc_scan_timing_model)
+{
+    adc_scan_config_t scan_config = {
+        .channel_mask = ADC_SCAN_MASK_ALL,
+        .sample_time = ADC_SAMPLE_TIME_4,
+        .use_pdma = true,
+        .callback = NULL};
+    adc_scan_timing_t burst, sequential;
+
+    adc_scan_get_timing(&scan_config, true, &burst);
+    adc_scan_get_timing(&scan_config, false, &sequential);
+
+    TEST_ASSERT_EQUAL(8, burst.channel_count);
+    TEST_ASSERT_EQUAL(burst.slot_ns * 7, burst.skew_ns);
+    TEST_ASSERT_EQUAL(0, burst.cpu_register_reads);
+    TEST_ASSERT_EQUAL(8, sequential.cpu_register_reads);
+    TEST_ASSERT_LESS_THAN(sequential.skew_ns, burst.skew_ns);
+}
+
+TEST_CASE(adc_oversample_decimation)
+{
+    adc_oversample_t oversample;
+    uint16_t result = 0;
+
+    // n=2: 累加16次，输出14位
+    adc_oversample_init(&oversample, 2);
+    for (int i = 0; i < 15; i++)
+    {
+        TEST_ASSERT_FALSE(adc_oversample_add(&oversample, (uint16_t)((i & 1) ? 2049 : 2048), &result));
+    }
+    TEST_ASSERT_TRUE(adc_oversample_add(&oversample, 2049, &result));
+
+    // 2048.5 * 4 = 8194
+    TEST_ASSERT_EQUAL(8194, result);
+
+    // 扩展位数限幅，满量程输出不溢出16位
+    adc_oversample_init(&oversample, 7);
+    TEST_ASSERT_EQUAL(ADC_OVERSAMPLE_MAX_BITS, oversample.extra_bits);
+    for (int i = 0; i < 256; i++)
+    {
+        adc_oversample_add(&oversample, 4095, &result);
+    }
+    TEST_ASSERT_EQUAL(65520, result);
+}
+
 void run_adc_tests(void)
 {
     printf("\n=== 运行ADC驱动模块测试 ===\n");
@@ -66,6 +182,10 @@ void run_adc_tests(void)
     RUN_TEST(adc_init_success);
     RUN_TEST(adc_read_single_channel);
     RUN_TEST(adc_read_voltage);
+    RUN_TEST(adc_scan_group_frame);
+    RUN_TEST(adc_scan_timer_timestamp);
+    RUN_TEST(adc_scan_timing_model);
+    RUN_TEST(adc_oversample_decimation);
 
     printf("ADC驱动模块测试用例已添加完成\n");
 }
\ No newline at end of file
@@ -0,0 +1,614 @@
+/**
+ * @file test_mqtt.c
+ * @brief MQTT 3.1.1编解码与客户端单元测试
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * 客户端通过mqtt_set_transport()接到进程内的服务器替身: 替身用同一套解析器解析客户端报文，
+ * 按MQTT 3.1.1应答 (CONNACK/PUBACK/SUBACK/UNSUBACK/PINGRESP)，并把匹配订阅的发布回送给客户端。
+ * 回送数据按小片段交给客户端，验证流式解析
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/mqtt.h"
+#include "../../../inc/mqtt_codec.h"
+#include "../../../inc/alarm_notify.h"
+#include "../../../inc/system.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// 服务器替身
+// ============================================================================
+
+#define BROKER_QUEUE_SIZE 512
+
+typedef struct
+{
+    mqtt_parser_t parser;
+    uint8_t body[MQTT_TX_BUFFER_SIZE];
+    uint8_t queue[BROKER_QUEUE_SIZE]; // 发往客户端的数据
+    uint16_t queue_head;
+    uint16_t queue_tail;
+    uint16_t fragment;    // 单次交给客户端的最大字节数
+    uint8_t connack_code; // CONNACK返回码
+    bool silent;          // 不应答PINGREQ
+    bool open;
+    char filter[32]; // 订阅过滤器 (只支持结尾的'#')
+    uint32_t connects;
+    uint32_t publishes;
+    uint32_t pubacks; // 收到客户端的PUBACK
+    uint32_t pings;
+    uint32_t disconnects;
+    uint32_t errors; // 客户端报文格式错误
+    uint8_t last_qos;
+    uint16_t last_payload_len;
+    char last_topic[MQTT_MAX_TOPIC_LEN];
+} broker_t;
+
+static broker_t g_broker;
+
+static void broker_queue(const uint8_t *data, uint16_t length)
+{
+    TEST_ASSERT_TRUE(g_broker.queue_tail + length <= BROKER_QUEUE_SIZE);
+    memcpy(g_broker.queue + g_broker.queue_tail, data, length);
+    g_broker.queue_tail = (uint16_t)(g_broker.queue_tail + length);
+}
+
+static bool broker_matches(const char *topic, uint16_t topic_len)
+{
+    size_t filter_len = strlen(g_broker.filter);
+
+    if (filter_len == 0)
+    {
+        return false;
+    }
+    if (g_broker.filter[filter_len - 1] == '#')
+    {
+        return topic_len >= filter_len - 1 && memcmp(topic, g_broker.filter, filter_len - 1) == 0;
+    }
+    return topic_len == filter_len && memcmp(topic, g_broker.filter, filter_len) == 0;
+}
+
+static void broker_handle(const mqtt_codec_packet_t *packet)
+{
+    uint8_t out[MQTT_TX_BUFFER_SIZE];
+    uint16_t length;
+
+    switch (packet->type)
+    {
+    case MQTT_CONNECT:
+        // 协议名 "MQTT" + 级别4
+        TEST_ASSERT_TRUE(packet->payload_len >= 10);
+        TEST_ASSERT_TRUE(memcmp(packet->payload, "\x00\x04MQTT\x04", 7) == 0);
+        g_broker.connects++;
+        out[0] = MQTT_CONNACK << 4;
+        out[1] = 2;
+        out[2] = 0;
+        out[3] = g_broker.connack_code;
+        broker_queue(out, 4);
+        break;
+
+    case MQTT_PUBLISH:
+    {
+        uint8_t qos = (uint8_t)((packet->flags >> 1) & 0x03);
+        char topic[MQTT_MAX_TOPIC_LEN];
+
+        g_broker.publishes++;
+        g_broker.last_qos = qos;
+        g_broker.last_payload_len = packet->payload_len;
+        memcpy(g_broker.last_topic, packet->topic, packet->topic_len);
+        g_broker.last_topic[packet->topic_len] = '\0';
+        if (qos == MQTT_QOS_1)
+        {
+            broker_queue(out, mqtt_codec_ack(out, sizeof(out), MQTT_PUBACK, packet->packet_id));
+        }
+
+        // 匹配订阅则回送 (QoS1，报文ID由服务器分配)
+        if (broker_matches(packet->topic, packet->topic_len))
+        {
+            mqtt_publish_frame_t frame;
+            uint8_t *start;
+
+            memcpy(topic, packet->topic, packet->topic_len);
+            topic[packet->topic_len] = '\0';
+            TEST_ASSERT_TRUE(mqtt_codec_publish_begin(&frame, out, sizeof(out), topic, MQTT_QOS_1, false, 0x1234));
+            memcpy(frame.payload, packet->payload, packet->payload_len);
+            length = mqtt_codec_publish_end(&frame, packet->payload_len, &start);
+            broker_queue(start, length);
+        }
+        break;
+    }
+
+    case MQTT_PUBACK:
+        g_broker.pubacks++;
+        break;
+
+    case MQTT_SUBSCRIBE:
+    {
+        uint16_t filter_len = (uint16_t)((packet->payload[0] << 8) | packet->payload[1]);
+        uint8_t granted = packet->payload[2 + filter_len];
+
+        TEST_ASSERT_TRUE(filter_len < sizeof(g_broker.filter));
+        memcpy(g_broker.filter, packet->payload + 2, filter_len);
+        g_broker.filter[filter_len] = '\0';
+        length = mqtt_codec_ack(out, sizeof(out), MQTT_SUBACK, packet->packet_id);
+        out[1] = 3;
+        out[length++] = (strncmp(g_broker.filter, "deny", 4) == 0) ? MQTT_CODEC_SUBACK_FAILURE : granted;
+        broker_queue(out, length);
+        break;
+    }
+
+    case MQTT_UNSUBSCRIBE:
+        g_broker.filter[0] = '\0';
+        broker_queue(out, mqtt_codec_ack(out, sizeof(out), MQTT_UNSUBACK, packet->packet_id));
+        break;
+
+    case MQTT_PINGREQ:
+        g_broker.pings++;
+        if (!g_broker.silent)
+        {
+            broker_queue(out, mqtt_codec_empty(out, sizeof(out), MQTT_PINGRESP));
+        }
+        break;
+
+    case MQTT_DISCONNECT:
+        g_broker.disconnects++;
+        break;
+
+    default:
+        TEST_ASSERT_TRUE(false);
+        break;
+    }
+}
+
+static int broker_open(const char *host, uint16_t port, void *context)
+{
+    (void)host;
+    (void)port;
+    (void)context;
+    g_broker.open = true;
+    return MQTT_SUCCESS;
+}
+
+static int broker_send(const uint8_t *data, uint16_t length, void *context)
+{
+    uint16_t offset = 0;
+
+    (void)context;
+    while (offset < length)
+    {
+        mqtt_codec_packet_t packet;
+        uint16_t consumed;
+        int result = mqtt_parser_feed(&g_broker.parser, data + offset, (uint16_t)(length - offset), &consumed, &packet);
+
+        if (result < 0)
+        {
+            g_broker.errors++;
+        }
+        offset = (uint16_t)(offset + consumed);
+        if (result == MQTT_CODEC_PACKET)
+        {
+            broker_handle(&packet);
+        }
+    }
+    return MQTT_SUCCESS;
+}
+
+static int broker_receive(uint8_t *buffer, uint16_t size, void *context)
+{
+    uint16_t length = (uint16_t)(g_broker.queue_tail - g_broker.queue_head);
+
+    (void)context;
+    if (length > size)
+    {
+        length = size;
+    }
+    if (length > g_broker.fragment)
+    {
+        length = g_broker.fragment;
+    }
+
+    memcpy(buffer, g_broker.queue + g_broker.queue_head, length);
+    g_broker.queue_head = (uint16_t)(g_broker.queue_head + length);
+    if (g_broker.queue_head == g_broker.queue_tail)
+    {
+        g_broker.queue_head = 0;
+        g_broker.queue_tail = 0;
+    }
+    return length;
+}
+
+static void broker_close(void *context)
+{
+    (void)context;
+    g_broker.open = false;
+}
+
+static const mqtt_transport_t g_broker_transport = {broker_open, broker_send, broker_receive, broker_close, NULL};
+
+// ============================================================================
+// 客户端辅助
+// ============================================================================
+
+static mqtt_event_t g_last_event;
+static uint32_t g_event_count[MQTT_EVENT_ERROR + 1];
+static char g_rx_topic[MQTT_MAX_TOPIC_LEN];
+static char g_rx_payload[64];
+static uint8_t g_rx_qos;
+
+static void test_event_callback(const mqtt_event_t *event)
+{
+    g_last_event = *event;
+    g_event_count[event->event]++;
+
+    if (event->event == MQTT_EVENT_MESSAGE_RECEIVED)
+    {
+        const mqtt_message_t *message = (const mqtt_message_t *)event->data;
+        strcpy(g_rx_topic, message->topic);
+        memcpy(g_rx_payload, message->payload, message->payload_len);
+        g_rx_payload[message->payload_len] = '\0';
+        g_rx_qos = message->qos;
+    }
+}
+
+static void test_advance(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        system_tick_increment();
+    }
+}
+
+static void test_client_setup(uint16_t keep_alive)
+{
+    mqtt_config_t config;
+
+    memset(&g_broker, 0, sizeof(g_broker));
+    mqtt_parser_init(&g_broker.parser, g_broker.body, sizeof(g_broker.body));
+    g_broker.fragment = 5;
+    memset(&g_last_event, 0, sizeof(g_last_event));
+    memset(g_event_count, 0, sizeof(g_event_count));
+
+    memset(&config, 0, sizeof(config));
+    strcpy(config.broker_host, "broker.local");
+    config.broker_port = 1883;
+    strcpy(config.client_id, "dtu-0001");
+    config.keep_alive = keep_alive;
+    config.clean_session = true;
+    config.connect_timeout = 5000;
+
+    mqtt_deinit();
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_set_transport(&g_broker_transport));
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_init(&config));
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_set_event_callback(test_event_callback));
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+TEST_CASE(mqtt_codec_encode)
+{
+    static const uint8_t expected_connect[] = {0x10, 0x15, 0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04, 0xC2, 0x00, 0x3C,
+                                               0x00, 0x03, 'd', 't', 'u', 0x00, 0x01, 'u', 0x00, 0x01, 'p'};
+    static const uint8_t expected_publish[] = {0x32, 0x09, 0x00, 0x03, 'a', '/', 'b', 0x00, 0x0A, 'h', 'i'};
+    static const uint8_t expected_subscribe[] = {0x82, 0x0A, 0x00, 0x02, 0x00, 0x05, 'c', 'm', 'd', '/', '#', 0x01};
+    uint8_t buffer[300];
+    mqtt_config_t config;
+    mqtt_publish_frame_t frame;
+    uint8_t *packet;
+
+    memset(&config, 0, sizeof(config));
+    strcpy(config.client_id, "dtu");
+    strcpy(config.username, "u");
+    strcpy(config.password, "p");
+    config.keep_alive = 60;
+    config.clean_session = true;
+    TEST_ASSERT_EQUAL(sizeof(expected_connect), mqtt_codec_connect(buffer, sizeof(buffer), &config));
+    TEST_ASSERT_TRUE(memcmp(buffer, expected_connect, sizeof(expected_connect)) == 0);
+    TEST_ASSERT_EQUAL(0, mqtt_codec_connect(buffer, 10, &config));
+
+    // 零拷贝PUBLISH: 载荷直接写入缓冲区，固定头右对齐到主题之前
+    TEST_ASSERT_TRUE(mqtt_codec_publish_begin(&frame, buffer, sizeof(buffer), "a/b", MQTT_QOS_1, false, 10));
+    TEST_ASSERT_TRUE(frame.payload == buffer + MQTT_CODEC_PUBLISH_RESERVE + 7);
+    memcpy(frame.payload, "hi", 2);
+    TEST_ASSERT_EQUAL(sizeof(expected_publish), mqtt_codec_publish_end(&frame, 2, &packet));
+    TEST_ASSERT_TRUE(packet == buffer + MQTT_CODEC_PUBLISH_RESERVE - 2);
+    TEST_ASSERT_TRUE(memcmp(packet, expected_publish, sizeof(expected_publish)) == 0);
+
+    // 剩余长度超过127时占2字节
+    TEST_ASSERT_TRUE(mqtt_codec_publish_begin(&frame, buffer, sizeof(buffer), "a/b", MQTT_QOS_0, true, 0));
+    TEST_ASSERT_EQUAL(208, mqtt_codec_publish_end(&frame, 200, &packet));
+    TEST_ASSERT_TRUE(packet == buffer + 1);
+    TEST_ASSERT_EQUAL(0x31, packet[0]);
+    TEST_ASSERT_EQUAL(0xCD, packet[1]);
+    TEST_ASSERT_EQUAL(0x01, packet[2]);
+    TEST_ASSERT_EQUAL(0, mqtt_codec_publish_end(&frame, frame.capacity + 1, &packet));
+
+    // 参数检查: QoS1须有报文ID，不支持QoS2发布
+    TEST_ASSERT_FALSE(mqtt_codec_publish_begin(&frame, buffer, sizeof(buffer), "a/b", MQTT_QOS_1, false, 0));
+    TEST_ASSERT_FALSE(mqtt_codec_publish_begin(&frame, buffer, sizeof(buffer), "a/b", MQTT_QOS_2, false, 1));
+    TEST_ASSERT_FALSE(mqtt_codec_publish_begin(&frame, buffer, sizeof(buffer), "", MQTT_QOS_0, false, 0));
+
+    TEST_ASSERT_EQUAL(sizeof(expected_subscribe), mqtt_codec_subscribe(buffer, sizeof(buffer), 2, "cmd/#", 1));
+    TEST_ASSERT_TRUE(memcmp(buffer, expected_subscribe, sizeof(expected_subscribe)) == 0);
+
+    TEST_ASSERT_EQUAL(2, mqtt_codec_empty(buffer, sizeof(buffer), MQTT_PINGREQ));
+    TEST_ASSERT_EQUAL(0xC0, buffer[0]);
+    TEST_ASSERT_EQUAL(0x00, buffer[1]);
+}
+
+TEST_CASE(mqtt_parser_stream)
+{
+    static const uint8_t stream[] = {
+        0x20, 0x02, 0x01, 0x00,                                           // CONNACK (会话存在)
+        0x32, 0x0A, 0x00, 0x03, 'c', '/', 'x', 0x00, 0x07, 'o', 'k', '!', // PUBLISH QoS1
+        0x90, 0x03, 0x00, 0x02, 0x01,                                     // SUBACK
+        0xD0, 0x00,                                                       // PINGRESP
+    };
+    static const uint8_t expected_types[] = {MQTT_CONNACK, MQTT_PUBLISH, MQTT_SUBACK, MQTT_PINGRESP};
+    uint8_t body[16];
+    mqtt_parser_t parser;
+    mqtt_codec_packet_t packet;
+    uint16_t consumed;
+    uint8_t count = 0;
+
+    // 逐字节输入
+    mqtt_parser_init(&parser, body, sizeof(body));
+    for (uint16_t i = 0; i < sizeof(stream); i++)
+    {
+        int result = mqtt_parser_feed(&parser, stream + i, 1, &consumed, &packet);
+        TEST_ASSERT_EQUAL(1, consumed);
+        if (result == MQTT_CODEC_PACKET)
+        {
+            TEST_ASSERT_EQUAL(expected_types[count], packet.type);
+            if (packet.type == MQTT_PUBLISH)
+            {
+                TEST_ASSERT_EQUAL(7, packet.packet_id);
+                TEST_ASSERT_EQUAL(3, packet.topic_len);
+                TEST_ASSERT_TRUE(memcmp(packet.topic, "c/x", 3) == 0);
+                TEST_ASSERT_EQUAL(3, packet.payload_len);
+                TEST_ASSERT_TRUE(memcmp(packet.payload, "ok!", 3) == 0);
+            }
+            count++;
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL(MQTT_CODEC_NEED_MORE, result);
+        }
+    }
+    TEST_ASSERT_EQUAL(4, count);
+
+    // 整段输入: 每次返回一个报文，consumed指出剩余数据位置
+    uint16_t offset = 0;
+    count = 0;
+    while (offset < sizeof(stream))
+    {
+        if (mqtt_parser_feed(&parser, stream + offset, (uint16_t)(sizeof(stream) - offset), &consumed, &packet) ==
+            MQTT_CODEC_PACKET)
+        {
+            TEST_ASSERT_EQUAL(expected_types[count], packet.type);
+            count++;
+        }
+        offset = (uint16_t)(offset + consumed);
+    }
+    TEST_ASSERT_EQUAL(4, count);
+    TEST_ASSERT_TRUE(packet.type == MQTT_PINGRESP);
+
+    // 超过缓冲区的报文被跳过，后续报文不受影响
+    uint8_t big[2 + 40 + 2];
+    memset(big, 'x', sizeof(big));
+    big[0] = 0x30;
+    big[1] = 40;
+    big[2] = 0x00;
+    big[3] = 0x01;
+    big[42] = 0xD0;
+    big[43] = 0x00;
+    TEST_ASSERT_EQUAL(MQTT_CODEC_PACKET, mqtt_parser_feed(&parser, big, sizeof(big), &consumed, &packet));
+    TEST_ASSERT_EQUAL(MQTT_PINGRESP, packet.type);
+    TEST_ASSERT_EQUAL(1, parser.dropped);
+
+    // 格式错误: 标志位非法、剩余长度超过4字节
+    static const uint8_t bad_flags[] = {0x21, 0x02, 0x00, 0x00};
+    static const uint8_t bad_length[] = {0x30, 0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+    TEST_ASSERT_EQUAL(MQTT_ERROR_PROTOCOL, mqtt_parser_feed(&parser, bad_flags, sizeof(bad_flags), &consumed, &packet));
+    TEST_ASSERT_EQUAL(MQTT_ERROR_PROTOCOL,
+                      mqtt_parser_feed(&parser, bad_length, sizeof(bad_length), &consumed, &packet));
+}
+
+TEST_CASE(mqtt_client_session)
+{
+    mqtt_statistics_t stats;
+
+    test_client_setup(60);
+
+    // 未连接时拒绝发布
+    TEST_ASSERT_EQUAL(MQTT_ERROR_NOT_CONNECTED, mqtt_publish("cmd/x", "a", 1, MQTT_QOS_0, false));
+
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_connect());
+    TEST_ASSERT_EQUAL(MQTT_STATE_CONNECTING, mqtt_get_state());
+    TEST_ASSERT_EQUAL(1, g_broker.connects);
+    mqtt_task();
+    TEST_ASSERT_TRUE(mqtt_is_connected());
+    TEST_ASSERT_EQUAL(1, g_event_count[MQTT_EVENT_CONNECTED]);
+
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_subscribe("cmd/#", MQTT_QOS_1));
+    mqtt_task();
+    TEST_ASSERT_EQUAL(1, g_event_count[MQTT_EVENT_SUBSCRIBE_SUCCESS]);
+    TEST_ASSERT_TRUE(strcmp(g_broker.filter, "cmd/#") == 0);
+
+    // QoS0发布到非订阅主题
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_publish("data/temp", "{\"t\":25.1}", 10, MQTT_QOS_0, false));
+    TEST_ASSERT_EQUAL(1, g_broker.publishes);
+    TEST_ASSERT_EQUAL(MQTT_QOS_0, g_broker.last_qos);
+    TEST_ASSERT_EQUAL(10, g_broker.last_payload_len);
+
+    // 零拷贝QoS1发布到订阅主题: 服务器应答PUBACK并回送，客户端应答回送报文的PUBACK
+    uint16_t capacity = 0;
+    uint8_t *payload = mqtt_publish_begin("cmd/reboot", MQTT_QOS_1, false, &capacity);
+    TEST_ASSERT_TRUE(payload != NULL);
+    TEST_ASSERT_TRUE(capacity >= 4);
+    memcpy(payload, "now!", 4);
+    int packet_id = mqtt_publish_commit(4);
+    TEST_ASSERT_TRUE(packet_id > 0);
+    TEST_ASSERT_EQUAL(MQTT_ERROR_INVALID_PARAM, mqtt_publish_commit(4));
+
+    mqtt_task();
+    TEST_ASSERT_EQUAL(1, g_event_count[MQTT_EVENT_MESSAGE_SENT]);
+    TEST_ASSERT_EQUAL(1, g_event_count[MQTT_EVENT_MESSAGE_RECEIVED]);
+    TEST_ASSERT_TRUE(strcmp(g_rx_topic, "cmd/reboot") == 0);
+    TEST_ASSERT_TRUE(strcmp(g_rx_payload, "now!") == 0);
+    TEST_ASSERT_EQUAL(MQTT_QOS_1, g_rx_qos);
+    TEST_ASSERT_EQUAL(1, g_broker.pubacks);
+
+    // 订阅被拒绝
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_subscribe("deny/#", MQTT_QOS_0));
+    mqtt_task();
+    TEST_ASSERT_EQUAL(MQTT_EVENT_ERROR, g_last_event.event);
+    TEST_ASSERT_EQUAL(MQTT_ERROR_REJECTED, g_last_event.error_code);
+
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_unsubscribe("deny/#"));
+    mqtt_task();
+    TEST_ASSERT_EQUAL(1, g_event_count[MQTT_EVENT_UNSUBSCRIBE_SUCCESS]);
+
+    // 超过发送缓冲区的载荷
+    static uint8_t large[MQTT_TX_BUFFER_SIZE];
+    TEST_ASSERT_EQUAL(MQTT_ERROR_NO_MEMORY, mqtt_publish("data/big", large, sizeof(large), MQTT_QOS_0, false));
+    TEST_ASSERT_EQUAL(MQTT_ERROR_INVALID_PARAM, mqtt_publish("data/q2", "a", 1, MQTT_QOS_2, false));
+
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_get_statistics(&stats));
+    TEST_ASSERT_EQUAL(2, stats.tx_count);
+    TEST_ASSERT_EQUAL(1, stats.rx_count);
+
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_disconnect());
+    TEST_ASSERT_EQUAL(1, g_broker.disconnects);
+    TEST_ASSERT_EQUAL(0, g_broker.errors);
+    TEST_ASSERT_FALSE(g_broker.open);
+    TEST_ASSERT_EQUAL(MQTT_STATE_DISCONNECTED, mqtt_get_state());
+
+    mqtt_deinit();
+    mqtt_set_transport(NULL);
+}
+
+TEST_CASE(mqtt_client_keepalive)
+{
+    test_client_setup(2);
+
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_connect());
+    mqtt_task();
+    TEST_ASSERT_TRUE(mqtt_is_connected());
+
+    // 空闲一个心跳间隔后发送PINGREQ
+    test_advance(1999);
+    mqtt_task();
+    TEST_ASSERT_EQUAL(0, g_broker.pings);
+    test_advance(1);
+    mqtt_task();
+    TEST_ASSERT_EQUAL(1, g_broker.pings);
+    mqtt_task();
+    TEST_ASSERT_TRUE(mqtt_is_connected());
+
+    // 发送数据推迟心跳
+    test_advance(1500);
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_publish("data/temp", "1", 1, MQTT_QOS_0, false));
+    test_advance(1000);
+    mqtt_task();
+    TEST_ASSERT_EQUAL(1, g_broker.pings);
+
+    // 服务器不再应答: 再过一个间隔判定连接断开
+    g_broker.silent = true;
+    test_advance(1000);
+    mqtt_task();
+    TEST_ASSERT_EQUAL(2, g_broker.pings);
+    test_advance(2000);
+    mqtt_task();
+    TEST_ASSERT_EQUAL(MQTT_STATE_DISCONNECTED, mqtt_get_state());
+    TEST_ASSERT_EQUAL(MQTT_EVENT_DISCONNECTED, g_last_event.event);
+    TEST_ASSERT_EQUAL(MQTT_ERROR_TIMEOUT, g_last_event.error_code);
+    TEST_ASSERT_FALSE(g_broker.open);
+
+    mqtt_deinit();
+    mqtt_set_transport(NULL);
+}
+
+TEST_CASE(mqtt_client_rejected)
+{
+    test_client_setup(60);
+
+    // 服务器拒绝 (未授权)
+    g_broker.connack_code = 5;
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_connect());
+    mqtt_task();
+    TEST_ASSERT_EQUAL(MQTT_STATE_DISCONNECTED, mqtt_get_state());
+    TEST_ASSERT_EQUAL(1, g_event_count[MQTT_EVENT_ERROR]);
+    TEST_ASSERT_EQUAL(0, g_event_count[MQTT_EVENT_CONNECTED]);
+    TEST_ASSERT_FALSE(g_broker.open);
+
+    // 无应答: 连接超时
+    g_broker.connack_code = 0;
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_connect());
+    g_broker.queue_head = 0; // 丢弃CONNACK
+    g_broker.queue_tail = 0;
+    test_advance(5000);
+    mqtt_task();
+    TEST_ASSERT_EQUAL(MQTT_STATE_DISCONNECTED, mqtt_get_state());
+    TEST_ASSERT_EQUAL(MQTT_ERROR_TIMEOUT, g_last_event.error_code);
+
+    mqtt_deinit();
+    mqtt_set_transport(NULL);
+}
+
+TEST_CASE(mqtt_client_alarm_notify)
+{
+    alarm_history_t event;
+
+    alarm_notify_init();
+    test_client_setup(60);
+
+    // 连接建立时注册报警通知通道
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_connect());
+    mqtt_task();
+    TEST_ASSERT_TRUE(mqtt_is_connected());
+
+    memset(&event, 0, sizeof(event));
+    event.rule_id = 1;
+    event.type = ALARM_TYPE_TEMPERATURE;
+    event.level = ALARM_LEVEL_CRITICAL;
+    event.state = ALARM_STATE_ACTIVE;
+    event.value = -123;
+    alarm_notify_post(&event);
+    TEST_ASSERT_EQUAL(1, g_broker.publishes);
+    TEST_ASSERT_EQUAL(MQTT_QOS_1, g_broker.last_qos);
+    TEST_ASSERT_TRUE(strcmp(g_broker.last_topic, "dtu/dtu-0001/alarm") == 0);
+    TEST_ASSERT_EQUAL(ALARM_NOTIFY_HEADER_SIZE + ALARM_NOTIFY_ENTRY_SIZE, g_broker.last_payload_len);
+    mqtt_task();
+    TEST_ASSERT_EQUAL(1, g_event_count[MQTT_EVENT_MESSAGE_SENT]);
+
+    // 重连后不重复注册: 每批仍只发一帧
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_disconnect());
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_connect());
+    mqtt_task();
+    TEST_ASSERT_TRUE(mqtt_is_connected());
+    alarm_notify_post(&event);
+    TEST_ASSERT_EQUAL(2, g_broker.publishes);
+    TEST_ASSERT_EQUAL(0, g_broker.errors);
+
+    mqtt_deinit();
+    mqtt_set_transport(NULL);
+    alarm_notify_init();
+}
+
+void run_mqtt_tests(void)
+{
+    printf("\n=== 运行MQTT测试 ===\n");
+
+    RUN_TEST(mqtt_codec_encode);
+    RUN_TEST(mqtt_parser_stream);
+    RUN_TEST(mqtt_client_session);
+    RUN_TEST(mqtt_client_keepalive);
+    RUN_TEST(mqtt_client_rejected);
+    RUN_TEST(mqtt_client_alarm_notify);
+
+    printf("MQTT测试用例已添加完成\n");
+}
@@ -0,0 +1,193 @@
+/**
+ * @file test_telemetry_codec.c
+ * @brief 紧凑二进制遥测载荷编解码单元测试
+ * @version 1.0
+ * @date 2026-10-18
+ */
+
+#include "../../framework/unity.h"
+#include "../../../inc/telemetry_codec.h"
+#include "../../../inc/mqtt.h"
+#include <stdio.h>
+#include <string.h>
+
+TEST_CASE(telemetry_sensor_roundtrip)
+{
+    // 01 01 3F | -53 | 612 | 1205 | 0 | 1506 | 1000
+    static const uint8_t expected[] = {0x01, 0x01, 0x3F, 0x69, 0xC8, 0x09, 0xEA, 0x12, 0x00, 0xC4, 0x17, 0xE8, 0x07};
+    telemetry_sensor_t sample = {-53, 612, 1205, 0, 1506, 1000};
+    telemetry_sensor_t decoded;
+    telemetry_record_t record;
+    uint8_t buffer[32];
+
+    uint16_t length = telemetry_encode_sensor(buffer, sizeof(buffer), &sample);
+    TEST_ASSERT_EQUAL(sizeof(expected), length);
+    TEST_ASSERT_TRUE(memcmp(buffer, expected, sizeof(expected)) == 0);
+
+    TEST_ASSERT_EQUAL(length, telemetry_decode(buffer, length, &record));
+    TEST_ASSERT_TRUE(record.schema == &telemetry_schema_sensor);
+    TEST_ASSERT_EQUAL(TELEMETRY_SENSOR_VERSION, record.version);
+    TEST_ASSERT_EQUAL(TELEMETRY_SENSOR_ALL, record.mask);
+    TEST_ASSERT_FALSE(record.newer);
+    TEST_ASSERT_TRUE(telemetry_get_sensor(&record, &decoded));
+    TEST_ASSERT_TRUE(memcmp(&sample, &decoded, sizeof(sample)) == 0);
+    TEST_ASSERT_FALSE(telemetry_get_status(&record, NULL));
+
+    // 设备状态
+    telemetry_status_t status = {TELEMETRY_FLAG_MODBUS_ONLINE | TELEMETRY_FLAG_ALARM_ACTIVE, 86400, 2048};
+    telemetry_status_t status_decoded;
+    length = telemetry_encode_status(buffer, sizeof(buffer), &status);
+    TEST_ASSERT_EQUAL(9, length);
+    TEST_ASSERT_EQUAL(length, telemetry_decode(buffer, length, &record));
+    TEST_ASSERT_TRUE(telemetry_get_status(&record, &status_decoded));
+    TEST_ASSERT_EQUAL(status.flags, status_decoded.flags);
+    TEST_ASSERT_EQUAL(status.uptime, status_decoded.uptime);
+    TEST_ASSERT_EQUAL(status.free_memory, status_decoded.free_memory);
+    TEST_ASSERT_FALSE(telemetry_get_sensor(&record, &decoded));
+}
+
+TEST_CASE(telemetry_writer_limits)
+{
+    telemetry_sensor_t sample = {INT32_MIN, INT32_MAX, -1, 1, 0, UINT32_MAX};
+    telemetry_sensor_t decoded;
+    telemetry_record_t record;
+    telemetry_writer_t writer;
+    uint8_t buffer[64];
+
+    // 32位极值: 每个字段5字节
+    uint16_t length = telemetry_encode_sensor(buffer, sizeof(buffer), &sample);
+    TEST_ASSERT_EQUAL(3 + 5 + 5 + 1 + 1 + 1 + 5, length);
+    TEST_ASSERT_EQUAL(length, telemetry_decode(buffer, length, &record));
+    TEST_ASSERT_TRUE(telemetry_get_sensor(&record, &decoded));
+    TEST_ASSERT_TRUE(memcmp(&sample, &decoded, sizeof(sample)) == 0);
+
+    // 空间不足: 任何更短的缓冲区都返回0，且不越界写入
+    for (uint16_t size = 0; size < length; size++)
+    {
+        memset(buffer, 0xEE, sizeof(buffer));
+        TEST_ASSERT_EQUAL(0, telemetry_encode_sensor(buffer, size, &sample));
+        TEST_ASSERT_EQUAL(0xEE, buffer[size]);
+    }
+
+    // 截断的载荷无法解码
+    length = telemetry_encode_sensor(buffer, sizeof(buffer), &sample);
+    for (uint16_t size = 0; size < length; size++)
+    {
+        TEST_ASSERT_EQUAL(0, telemetry_decode(buffer, size, &record));
+    }
+
+    // 写入器: 只写部分字段
+    telemetry_writer_init(&writer, buffer, sizeof(buffer));
+    telemetry_write_header(&writer, &telemetry_schema_sensor,
+                           (1UL << TELEMETRY_SENSOR_TEMPERATURE) | (1UL << TELEMETRY_SENSOR_TIMESTAMP));
+    telemetry_write_sint(&writer, 215);
+    telemetry_write_uint(&writer, 60000);
+    length = telemetry_writer_finish(&writer);
+    TEST_ASSERT_EQUAL(3 + 2 + 3, length);
+    TEST_ASSERT_EQUAL(length, telemetry_decode(buffer, length, &record));
+    TEST_ASSERT_TRUE(telemetry_get_sensor(&record, &decoded));
+    TEST_ASSERT_EQUAL(215, decoded.temperature);
+    TEST_ASSERT_EQUAL(0, decoded.humidity);
+    TEST_ASSERT_EQUAL(60000, decoded.timestamp);
+}
+
+TEST_CASE(telemetry_schema_versioning)
+{
+    telemetry_sensor_t decoded;
+    telemetry_record_t record;
+    telemetry_writer_t writer;
+    uint8_t buffer[32];
+    uint16_t length;
+
+    // 新版本载荷: 温度 + 版本2追加的第7个字段 (300) + 之后仍有第8个字段 (-2)
+    static const telemetry_schema_t sensor_v2 = {TELEMETRY_SCHEMA_SENSOR, 2, 0, NULL};
+    telemetry_writer_init(&writer, buffer, sizeof(buffer));
+    telemetry_write_header(&writer, &sensor_v2, (1UL << TELEMETRY_SENSOR_TEMPERATURE) | (1UL << 6) | (1UL << 7));
+    telemetry_write_sint(&writer, -12);
+    telemetry_write_uint(&writer, 300);
+    telemetry_write_sint(&writer, -2);
+    buffer[writer.length++] = 0xAA; // 载荷之后的其他数据
+    length = telemetry_writer_finish(&writer);
+
+    // 解出已知字段，跳过未知字段，返回值止于载荷末尾
+    TEST_ASSERT_EQUAL(length - 1, telemetry_decode(buffer, length, &record));
+    TEST_ASSERT_TRUE(record.newer);
+    TEST_ASSERT_EQUAL(2, record.version);
+    TEST_ASSERT_EQUAL(1UL << TELEMETRY_SENSOR_TEMPERATURE, record.mask);
+    TEST_ASSERT_TRUE(telemetry_get_sensor(&record, &decoded));
+    TEST_ASSERT_EQUAL(-12, decoded.temperature);
+
+    // 未知模式ID、版本0、空载荷
+    buffer[0] = 0x7E;
+    TEST_ASSERT_EQUAL(0, telemetry_decode(buffer, length, &record));
+    buffer[0] = TELEMETRY_SCHEMA_SENSOR;
+    buffer[1] = 0;
+    TEST_ASSERT_EQUAL(0, telemetry_decode(buffer, length, &record));
+    TEST_ASSERT_EQUAL(0, telemetry_decode(buffer, 0, &record));
+    TEST_ASSERT_TRUE(telemetry_find_schema(TELEMETRY_SCHEMA_STATUS) == &telemetry_schema_status);
+    TEST_ASSERT_TRUE(telemetry_find_schema(0) == NULL);
+}
+
+TEST_CASE(telemetry_mqtt_payload_format)
+{
+    mqtt_sensor_data_t data = {25.3f, 61.2f, 12.05f, -1.25f, 15.06f};
+    device_status_t status = {true, false, true, false, 3600, 1024};
+    telemetry_sensor_t decoded;
+    telemetry_status_t status_decoded;
+    telemetry_record_t record;
+    mqtt_config_t config;
+    uint8_t buffer[160];
+    int length;
+
+    memset(&config, 0, sizeof(config));
+    strcpy(config.broker_host, "broker.local");
+    strcpy(config.client_id, "dtu-0001");
+    config.broker_port = 1883;
+    config.keep_alive = 60;
+
+    // 默认JSON
+    mqtt_deinit();
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_init(&config));
+    length = mqtt_encode_sensor_payload(buffer, sizeof(buffer), &data);
+    TEST_ASSERT_TRUE(length > 0);
+    TEST_ASSERT_EQUAL('{', buffer[0]);
+    TEST_ASSERT_TRUE(strstr((const char *)buffer, "\"voltage\":12.05") != NULL);
+
+    // 紧凑二进制: 与JSON相同精度
+    config.payload_format = MQTT_PAYLOAD_PACKED;
+    mqtt_deinit();
+    TEST_ASSERT_EQUAL(MQTT_SUCCESS, mqtt_init(&config));
+    length = mqtt_encode_sensor_payload(buffer, sizeof(buffer), &data);
+    TEST_ASSERT_TRUE(length > 0 && length <= 3 + 5 * 3 + TELEMETRY_VARINT_MAX);
+    TEST_ASSERT_EQUAL(length, telemetry_decode(buffer, (uint16_t)length, &record));
+    TEST_ASSERT_TRUE(telemetry_get_sensor(&record, &decoded));
+    TEST_ASSERT_EQUAL(253, decoded.temperature);
+    TEST_ASSERT_EQUAL(612, decoded.humidity);
+    TEST_ASSERT_EQUAL(1205, decoded.voltage);
+    TEST_ASSERT_EQUAL(-125, decoded.current);
+    TEST_ASSERT_EQUAL(1506, decoded.power);
+
+    length = mqtt_encode_status_payload(buffer, sizeof(buffer), &status);
+    TEST_ASSERT_EQUAL(length, telemetry_decode(buffer, (uint16_t)length, &record));
+    TEST_ASSERT_TRUE(telemetry_get_status(&record, &status_decoded));
+    TEST_ASSERT_EQUAL(TELEMETRY_FLAG_MODBUS_ONLINE | TELEMETRY_FLAG_STORAGE_NORMAL, status_decoded.flags);
+    TEST_ASSERT_EQUAL(3600, status_decoded.uptime);
+    TEST_ASSERT_EQUAL(1024, status_decoded.free_memory);
+
+    TEST_ASSERT_EQUAL(MQTT_ERROR_NO_MEMORY, mqtt_encode_sensor_payload(buffer, 4, &data));
+    TEST_ASSERT_EQUAL(MQTT_ERROR_INVALID_PARAM, mqtt_encode_status_payload(buffer, sizeof(buffer), NULL));
+
+    mqtt_deinit();
+}
+
+void run_telemetry_codec_tests(void)
+{
+    printf("\n=== 运行遥测载荷编解码测试 ===\n");
+
+    RUN_TEST(telemetry_sensor_roundtrip);
+    RUN_TEST(telemetry_writer_limits);
+    RUN_TEST(telemetry_schema_versioning);
+    RUN_TEST(telemetry_mqtt_payload_format);
+
+    printf("遥测载荷编解码测试用例已添加完成\n");
+}